@@ -2,12 +2,15 @@ option(USE_CLANG "Use CLANG instead of gcc for faster compilation" false)
 option(USE_INTEL "Use Intel ICC compiler" false)
 option(BUILD_EXAMPLES "Compile all examples for ct" false)
 option(BUILD_HYQ_FULL "Compile all examples for HyQ (takes long, should use clang)" false)
-option(BUILD_HYQ_LINEARIZATION_TIMINGS "Build linearization timing tests for HyQ (takes long, should use clang)" false)
-option(BUILD_HYA_LINEARIZATION_TIMINGS "Build linearization timing tests for HyA (takes long, should use clang)" false)
+option(BUILD_BENCHMARKS "Build the benchmark of all models in ct_models (generates code with CPPADCG, takes long)" false)
 option(HPIPM "Build HPIPM Optimal Control solver" false)
 
 ## option to activate/deactivate explicit template prespecs
 option(USE_PRESPEC "Compile with explicit template prespec" false)
+set(CT_EXPLICIT_TEMPLATES_FILE "${CMAKE_CURRENT_LIST_DIR}/../config/explicit_templates.cfg" CACHE FILEPATH
+    "Config file listing the dimensions and scalar types of the explicit template prespecs")
+set(CT_EXPLICIT_TEMPLATES "" CACHE STRING
+    "Additional explicit template prespecs, separated by semicolons, e.g. STATE_DIM=6, CONTROL_DIM=3, SCALAR=double")
 
 
 if (USE_CLANG AND USE_INTEL)
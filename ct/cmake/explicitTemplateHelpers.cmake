@@ -43,6 +43,9 @@ function(ct_configure_explicit_templates ConfigFile ConfigDir LibPrefix)
 
   STRING(REGEX REPLACE ";" "\\\\;" contents "${contents}")
   STRING(REGEX REPLACE "\n" ";" contents "${contents}")
+
+  # additional templates given by the user, e.g. -DCT_EXPLICIT_TEMPLATES="STATE_DIM=6, CONTROL_DIM=3, SCALAR=double"
+  list(APPEND contents ${CT_EXPLICIT_TEMPLATES})
   
   #message(WARNING "file content: ${contents}")
   
@@ -69,7 +72,9 @@ function(ct_configure_explicit_templates ConfigFile ConfigDir LibPrefix)
           #message(WARNING "Nothing to configure")
       endif()
       
-      if(CURRENT_SRCS)
+      # templates may be listed both in the config file and by the user
+      list(FIND LIB_NAMES "${CURRENT_LIB_NAME}" LIB_INDEX)
+      if(CURRENT_SRCS AND LIB_INDEX EQUAL -1)
           set(${CURRENT_LIB_NAME}_SRCS ${CURRENT_SRCS} PARENT_SCOPE)
           list(APPEND LIB_NAMES "${CURRENT_LIB_NAME}")
       endif()
@@ -104,6 +109,29 @@ function(ct_configureFiles ConfigDir STATE_DIM_PRESPEC, CONTROL_DIM_PRESPEC, SCA
 endfunction()
 
 
+# generates a header with explicit instantiation declarations (extern templates) for all templates instantiated in the
+# given prespec libraries. Translation units which include this header link against the libraries instead of
+# instantiating these templates themselves.
+function(ct_generate_extern_templates OutputFile)
+    set(header "// generated by cmake from the explicit template instantiations of the prespec libraries, do not edit\n")
+    set(header "${header}\n#pragma once\n")
+    foreach(lib_name ${ARGN})
+        foreach(src ${${lib_name}_SRCS})
+            file(READ "${src}" content)
+            # turn all explicit instantiation definitions into declarations, the including header already provides
+            # all implementations
+            string(REGEX REPLACE "\n([ \t]*)template " "\n\\1extern template " content "\n${content}")
+            string(REGEX REPLACE "\n#include [^\n]*" "" content "${content}")
+            set(header "${header}\n// ${lib_name}${content}\n")
+        endforeach()
+    endforeach()
+
+    # only touch the header if it changed, to avoid needless recompilation
+    file(WRITE "${OutputFile}.tmp" "${header}")
+    configure_file("${OutputFile}.tmp" "${OutputFile}" COPYONLY)
+endfunction()
+
+
 # link external library (for example to link optcon against lapack) # todo this should go away
 function(ct_link_external_library extLibs)
 foreach(lib_name ${PRESPEC_LIB_NAMES})
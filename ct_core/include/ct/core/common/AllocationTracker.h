@@ -0,0 +1,82 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace ct {
+namespace core {
+
+//! Counts heap allocations inside marked regions of code
+/*!
+ * Real-time loops, e.g. the iterations of an MPC solver, should not allocate memory once they are warmed up. This
+ * class keeps track of the number of heap allocations (from any thread) while at least one region is active. The
+ * counting itself is done by the allocation hooks in AllocationTrackerHooks.h, which need to be included in exactly
+ * one translation unit of an executable, typically a unit test. Without the hooks, no allocations are counted.
+ *
+ * Usage:
+ * \code
+ * ct::core::AllocationTracker::Region region;
+ * solver.runIteration();
+ * ASSERT_EQ(region.count(), 0u);
+ * \endcode
+ */
+class AllocationTracker
+{
+public:
+    //! A region in which allocations are counted, active during the lifetime of the object
+    class Region
+    {
+    public:
+        Region()
+        {
+            activeRegions()++;
+            start_ = allocations().load();
+        }
+        ~Region() { activeRegions()--; }
+        Region(const Region&) = delete;
+        Region& operator=(const Region&) = delete;
+
+        //! the number of allocations since the region was entered
+        size_t count() const { return allocations().load() - start_; }
+        //! restart counting from zero
+        void reset() { start_ = allocations().load(); }
+    private:
+        size_t start_;
+    };
+
+    //! true if the allocation hooks have been compiled into the executable
+    static bool enabled() { return hooksInstalled().load(); }
+    //! called by the allocation hooks for every allocation
+    static void recordAllocation()
+    {
+        if (activeRegions().load(std::memory_order_relaxed) > 0)
+            allocations().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //! called by the allocation hooks once they are in place
+    static void setEnabled() { hooksInstalled() = true; }
+private:
+    static std::atomic<size_t>& allocations()
+    {
+        static std::atomic<size_t> allocations(0);
+        return allocations;
+    }
+    static std::atomic<int>& activeRegions()
+    {
+        static std::atomic<int> activeRegions(0);
+        return activeRegions;
+    }
+    static std::atomic<bool>& hooksInstalled()
+    {
+        static std::atomic<bool> hooksInstalled(false);
+        return hooksInstalled;
+    }
+};
+
+}  // namespace core
+}  // namespace ct
@@ -0,0 +1,101 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+/*!
+ * \file AllocationTrackerHooks.h
+ * Allocation hooks for the AllocationTracker. This file defines global allocation functions, hence it must be included
+ * in exactly one translation unit of an executable and never in a library.
+ *
+ * With glibc, malloc, calloc, realloc and the aligned allocation functions are interposed, which covers the global
+ * operator new as well as Eigen's aligned_malloc. Otherwise, only the global operator new is replaced.
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#include "AllocationTracker.h"
+
+#if defined(__GLIBC__)
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size)
+{
+    ct::core::AllocationTracker::recordAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size)
+{
+    ct::core::AllocationTracker::recordAllocation();
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    ct::core::AllocationTracker::recordAllocation();
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    ct::core::AllocationTracker::recordAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    ct::core::AllocationTracker::recordAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    ct::core::AllocationTracker::recordAllocation();
+    *ptr = __libc_memalign(alignment, size);
+    return *ptr ? 0 : ENOMEM;
+}
+}
+
+#else
+
+void* operator new(std::size_t size)
+{
+    ct::core::AllocationTracker::recordAllocation();
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+#endif
+
+namespace ct {
+namespace core {
+namespace internal {
+
+//! marks the tracker as enabled during static initialization
+struct AllocationTrackerHooksInstaller
+{
+    AllocationTrackerHooksInstaller() { AllocationTracker::setEnabled(); }
+};
+
+static AllocationTrackerHooksInstaller allocationTrackerHooksInstaller;
+
+}  // namespace internal
+}  // namespace core
+}  // namespace ct
@@ -32,6 +32,13 @@ public:
     {
     }
 
+    //! reseeds the random engine, e.g. to obtain reproducible noise sequences
+    void seed(unsigned int value)
+    {
+        eng_.seed(value);
+        distr_.reset();
+    }
+
     //! Scalar generator
     /*!
 	 *  generates a single scalar random variable
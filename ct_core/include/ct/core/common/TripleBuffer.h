@@ -0,0 +1,75 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace ct {
+namespace core {
+
+//! A wait-free triple buffer to pass the latest value of an object from one writer thread to one reader thread
+/*!
+ * The writer fills back() and calls publish(), the reader calls update() and accesses front(). Both sides own their
+ * buffer exclusively, a third buffer holds the most recently published value. Handing over a value only swaps buffer
+ * indices, hence neither side ever waits for the other, and intermediate values are skipped if the writer is faster
+ * than the reader.
+ *
+ * Since the buffers are reused, objects with dynamic memory (e.g. controllers) can be handed over without allocating
+ * memory once all three buffers have been filled.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : front_(0), middle_(1), back_(2), hasData_(false) {}
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    //! the buffer owned by the writer
+    T& back() { return buffers_[back_]; }
+    //! make the content of back() available to the reader (writer only)
+    /*!
+     * After publishing, back() refers to a different buffer with unspecified content.
+     */
+    void publish() { back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX; }
+    //! fetch the most recently published value, if there is a new one (reader only)
+    /*!
+     * @return true if front() has been updated
+     */
+    bool update()
+    {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH))
+            return false;
+
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        hasData_ = true;
+        return true;
+    }
+
+    //! true if the reader has received at least one value (reader only)
+    bool hasData() const { return hasData_; }
+    //! the buffer owned by the reader
+    T& front() { return buffers_[front_]; }
+    //! the buffer owned by the reader
+    const T& front() const { return buffers_[front_]; }
+private:
+    //! bit marking the middle buffer as not yet read
+    static const uint8_t FRESH = 4;
+    //! bits of the buffer index
+    static const uint8_t INDEX = 3;
+
+    T buffers_[3];
+
+    uint8_t front_;
+    std::atomic<uint8_t> middle_;
+    uint8_t back_;
+
+    bool hasData_;
+};
+
+}  // namespace core
+}  // namespace ct
@@ -26,6 +26,13 @@ public:
 	 * @param r the half-width of the distribution
 	 */
     UniformNoise(const double mean = 0.0, const double r = 1.0) : rd_(), eng_(rd_()), distr_(mean - r, mean + r) {}
+    //! reseeds the random engine, e.g. to obtain reproducible noise sequences
+    void seed(unsigned int value)
+    {
+        eng_.seed(value);
+        distr_.reset();
+    }
+
     //! Scalar generator
     /*!
 	 *  generates a single scalar random variable
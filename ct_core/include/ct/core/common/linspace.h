@@ -27,16 +27,33 @@ TRAJECTORY_T linspace(const typename TRAJECTORY_T::value_type& a,
     if (N < 1)
         throw std::runtime_error("ERROR in CT_LINSPACE: N<1.");
 
-    typename TRAJECTORY_T::value_type h = (b - a) / (N - 1);
     TRAJECTORY_T traj(N);
+    linspace(traj, a, b, N);
+
+    return traj;
+}
+
+//! linspace writing into an existing trajectory
+/*!
+ * Same as above, but resizes and fills the given trajectory, which does not allocate if its capacity suffices.
+ */
+template <typename TRAJECTORY_T>
+void linspace(TRAJECTORY_T& traj,
+    const typename TRAJECTORY_T::value_type& a,
+    const typename TRAJECTORY_T::value_type& b,
+    const size_t N)
+{
+    if (N < 1)
+        throw std::runtime_error("ERROR in CT_LINSPACE: N<1.");
+
+    typename TRAJECTORY_T::value_type h = (b - a) / (N - 1);
+    traj.resize(N);
 
     typename TRAJECTORY_T::iterator it;
     typename TRAJECTORY_T::value_type val;
 
     for (it = traj.begin(), val = a; it != traj.end(); ++it, val += h)
         *it = val;
-
-    return traj;
 }
 
 }  // namespace core
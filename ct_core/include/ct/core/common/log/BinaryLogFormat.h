@@ -0,0 +1,136 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <Eigen/Core>
+
+namespace ct {
+namespace core {
+
+/*!
+ * \file BinaryLogFormat.h
+ * Layout of the binary log files written by the BinaryLogWriter and read by the BinaryLogReader.
+ *
+ * A log file starts with a BinaryLogFileHeader, followed by a sequence of records. Every record consists of a
+ * BinaryLogRecordHeader and a payload holding 'count' elements of 'rows' x 'cols' scalars each, stored column-major in
+ * native byte order. The payload is padded to a multiple of 8 bytes, such that all headers are aligned. Files are
+ * grown in chunks, the record sequence ends at the first header with an invalid magic number.
+ */
+
+//! magic number identifying a binary log file ("CTBINLOG")
+static const char BINARY_LOG_FILE_MAGIC[8] = {'C', 'T', 'B', 'I', 'N', 'L', 'O', 'G'};
+//! magic number at the start of every record ("CTRC")
+static const uint32_t BINARY_LOG_RECORD_MAGIC = 0x43525443;
+//! version of the file format
+static const uint32_t BINARY_LOG_VERSION = 1;
+//! maximum length of a channel name, including the terminating zero
+static const size_t BINARY_LOG_CHANNEL_LENGTH = 24;
+
+//! the type of data stored in a record
+enum class BinaryLogRecordType : uint16_t
+{
+    SCALAR_ARRAY = 0,  //!< an array of scalars, e.g. a TimeArray
+    MATRIX_ARRAY,      //!< an array of matrices, e.g. a StateVectorArray, ControlVectorArray or FeedbackArray
+    MATRIX             //!< a single matrix or vector, e.g. a solver summary
+};
+
+//! the scalar type of the payload
+enum class BinaryLogScalarType : uint16_t
+{
+    FLOAT32 = 0,
+    FLOAT64
+};
+
+//! header at the beginning of every log file
+struct BinaryLogFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;
+};
+
+//! header at the beginning of every record
+struct BinaryLogRecordHeader
+{
+    uint32_t magic;                           //!< BINARY_LOG_RECORD_MAGIC
+    BinaryLogRecordType type;                 //!< the type of data
+    BinaryLogScalarType scalarType;           //!< the scalar type of the payload
+    uint64_t sequence;                        //!< consecutive number of the record, gaps indicate dropped records
+    double stamp;                             //!< user defined time stamp, e.g. the control time or iteration
+    uint32_t rows;                            //!< rows of each element
+    uint32_t cols;                            //!< columns of each element
+    uint32_t count;                           //!< number of elements
+    uint32_t payloadBytes;                    //!< bytes of the payload, including padding
+    char channel[BINARY_LOG_CHANNEL_LENGTH];  //!< zero terminated name of the channel
+
+    //! bytes of a single scalar of the payload
+    size_t scalarBytes() const { return scalarType == BinaryLogScalarType::FLOAT32 ? 4 : 8; }
+    //! bytes of the payload without padding
+    size_t dataBytes() const { return size_t(rows) * cols * count * scalarBytes(); }
+};
+
+static_assert(sizeof(BinaryLogFileHeader) == 16, "unexpected padding in BinaryLogFileHeader");
+static_assert(sizeof(BinaryLogRecordHeader) == 64, "unexpected padding in BinaryLogRecordHeader");
+
+namespace internal {
+
+//! maps the scalar types supported by the binary log to their type id
+template <typename SCALAR>
+struct BinaryLogScalar
+{
+    static_assert(std::is_same<SCALAR, float>::value || std::is_same<SCALAR, double>::value,
+        "The binary log only supports float and double scalars");
+    static const BinaryLogScalarType type =
+        std::is_same<SCALAR, float>::value ? BinaryLogScalarType::FLOAT32 : BinaryLogScalarType::FLOAT64;
+};
+
+//! describes an element of an array in the binary log, specialized for scalars and Eigen matrices
+template <typename T, typename ENABLE = void>
+struct BinaryLogElement
+{
+    typedef typename T::Scalar Scalar;
+    static const BinaryLogRecordType arrayType = BinaryLogRecordType::MATRIX_ARRAY;
+
+    static_assert(!T::IsRowMajor || T::IsVectorAtCompileTime, "The binary log only supports column-major matrices");
+
+    static size_t rows(const T& element) { return element.rows(); }
+    static size_t cols(const T& element) { return element.cols(); }
+    static const Scalar* data(const T& element) { return element.data(); }
+    static Scalar* data(T& element) { return element.data(); }
+    //! true if an element can hold data of the given size
+    static bool fits(size_t rows, size_t cols)
+    {
+        return (T::RowsAtCompileTime == Eigen::Dynamic || size_t(T::RowsAtCompileTime) == rows) &&
+               (T::ColsAtCompileTime == Eigen::Dynamic || size_t(T::ColsAtCompileTime) == cols);
+    }
+    static void resize(T& element, size_t rows, size_t cols) { element.resize(rows, cols); }
+};
+
+template <typename T>
+struct BinaryLogElement<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+{
+    typedef T Scalar;
+    static const BinaryLogRecordType arrayType = BinaryLogRecordType::SCALAR_ARRAY;
+
+    static size_t rows(const T&) { return 1; }
+    static size_t cols(const T&) { return 1; }
+    static const Scalar* data(const T& element) { return &element; }
+    static Scalar* data(T& element) { return &element; }
+    static bool fits(size_t rows, size_t cols) { return rows == 1 && cols == 1; }
+    static void resize(T&, size_t, size_t) {}
+};
+
+//! pads a number of bytes to a multiple of 8
+inline size_t binaryLogPadding(size_t bytes) { return (bytes + 7) & ~size_t(7); }
+
+}  // namespace internal
+}  // namespace core
+}  // namespace ct
@@ -0,0 +1,242 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ct/core/types/arrays/DiscreteArray.h>
+
+#include "BinaryLogFormat.h"
+
+namespace ct {
+namespace core {
+
+//! Reads binary log files written by the BinaryLogWriter
+/*!
+ * The file is memory-mapped and indexed on construction. Files which are still being written can be followed by
+ * calling update(), which picks up all records that have been completed in the meantime.
+ *
+ * Usage:
+ * \code
+ * ct::core::BinaryLogReader reader("mpc.ctlog");
+ * for (const auto& record : reader.records("x"))
+ * {
+ *     ct::core::StateVectorArray<STATE_DIM> x;
+ *     reader.read(record, x);
+ * }
+ * \endcode
+ */
+class BinaryLogReader
+{
+public:
+    //! a record in the log file
+    struct Record
+    {
+        BinaryLogRecordHeader header;  //!< the header of the record
+        size_t offset;                 //!< offset of the payload in the file
+
+        //! the channel of the record
+        std::string channel() const { return std::string(header.channel); }
+    };
+
+    //! constructor, maps and indexes the log file
+    explicit BinaryLogReader(const std::string& fileName)
+        : fileName_(fileName), fd_(-1), mapping_(nullptr), mappedBytes_(0), parsedBytes_(0)
+    {
+        fd_ = ::open(fileName_.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            throw std::runtime_error("BinaryLogReader: cannot open " + fileName_);
+
+        update();
+
+        BinaryLogFileHeader header;
+        if (mappedBytes_ < sizeof(header))
+        {
+            close();
+            throw std::runtime_error("BinaryLogReader: " + fileName_ + " is not a binary log file");
+        }
+        std::memcpy(&header, mapping_, sizeof(header));
+        if (std::memcmp(header.magic, BINARY_LOG_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != BINARY_LOG_VERSION || header.headerBytes != sizeof(BinaryLogRecordHeader))
+        {
+            close();
+            throw std::runtime_error("BinaryLogReader: " + fileName_ + " is not a binary log file of version " +
+                                     std::to_string(BINARY_LOG_VERSION));
+        }
+    }
+
+    //! destructor
+    ~BinaryLogReader() { close(); }
+    BinaryLogReader(const BinaryLogReader&) = delete;
+    BinaryLogReader& operator=(const BinaryLogReader&) = delete;
+
+    //! index all records which have been appended to the file since the last call
+    /*!
+     * @return the number of new records
+     */
+    size_t update()
+    {
+        struct stat fileStatus;
+        if (::fstat(fd_, &fileStatus) != 0)
+            throw std::runtime_error("BinaryLogReader: cannot access " + fileName_);
+
+        const size_t fileBytes = fileStatus.st_size;
+        if (fileBytes > mappedBytes_)
+        {
+            if (mapping_)
+                ::munmap(const_cast<char*>(mapping_), mappedBytes_);
+            void* mapping = ::mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, fd_, 0);
+            if (mapping == MAP_FAILED)
+            {
+                mapping_ = nullptr;
+                mappedBytes_ = 0;
+                throw std::runtime_error("BinaryLogReader: cannot map " + fileName_);
+            }
+            mapping_ = static_cast<const char*>(mapping);
+            mappedBytes_ = fileBytes;
+        }
+
+        if (parsedBytes_ == 0)
+            parsedBytes_ = sizeof(BinaryLogFileHeader);
+
+        const size_t nRecords = records_.size();
+        while (parsedBytes_ + sizeof(BinaryLogRecordHeader) <= mappedBytes_)
+        {
+            Record record;
+            std::memcpy(&record.header, mapping_ + parsedBytes_, sizeof(record.header));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // the remaining part of the file has not been written yet
+            if (record.header.magic != BINARY_LOG_RECORD_MAGIC ||
+                parsedBytes_ + sizeof(record.header) + record.header.payloadBytes > mappedBytes_)
+                break;
+
+            record.offset = parsedBytes_ + sizeof(record.header);
+            records_.push_back(record);
+            parsedBytes_ = record.offset + record.header.payloadBytes;
+        }
+
+        return records_.size() - nRecords;
+    }
+
+    //! all records in the order they were logged
+    const std::vector<Record>& records() const { return records_; }
+    //! all records of a channel in the order they were logged
+    std::vector<Record> records(const std::string& channel) const
+    {
+        std::vector<Record> channelRecords;
+        for (const Record& record : records_)
+            if (channel == record.header.channel)
+                channelRecords.push_back(record);
+        return channelRecords;
+    }
+
+    //! read an array of scalars or matrices
+    /*!
+     * Data logged in a different floating point precision is converted.
+     * @param record the record to read
+     * @param array the array, resized to the number of elements in the record
+     */
+    template <typename T, typename ALLOC>
+    void read(const Record& record, DiscreteArray<T, ALLOC>& array) const
+    {
+        typedef internal::BinaryLogElement<T> Element;
+
+        const BinaryLogRecordHeader& header = record.header;
+        if (header.type != Element::arrayType ||
+            (header.count > 0 && !Element::fits(header.rows, header.cols)))
+            throw std::runtime_error("BinaryLogReader: record of channel '" + record.channel() +
+                                     "' does not match the requested array type");
+
+        array.resize(header.count);
+        const size_t elementSize = size_t(header.rows) * header.cols;
+        for (size_t i = 0; i < header.count; i++)
+        {
+            Element::resize(array[i], header.rows, header.cols);
+            readScalars(record, i * elementSize, elementSize, Element::data(array[i]));
+        }
+    }
+
+    //! read a single matrix or vector
+    /*!
+     * Data logged in a different floating point precision is converted.
+     * @param record the record to read
+     * @param matrix the matrix, resized to the size of the record if it is dynamic
+     */
+    template <typename DERIVED>
+    void read(const Record& record, Eigen::PlainObjectBase<DERIVED>& matrix) const
+    {
+        typedef internal::BinaryLogElement<DERIVED> Element;
+
+        const BinaryLogRecordHeader& header = record.header;
+        if (header.type != BinaryLogRecordType::MATRIX || !Element::fits(header.rows, header.cols))
+            throw std::runtime_error("BinaryLogReader: record of channel '" + record.channel() +
+                                     "' does not match the requested matrix type");
+
+        matrix.resize(header.rows, header.cols);
+        readScalars(record, 0, matrix.size(), matrix.data());
+    }
+
+private:
+    //! copy scalars from the payload of a record, converting them if needed
+    template <typename SCALAR>
+    void readScalars(const Record& record, size_t first, size_t n, SCALAR* data) const
+    {
+        const char* source = mapping_ + record.offset;
+
+        if (record.header.scalarType == internal::BinaryLogScalar<SCALAR>::type)
+        {
+            std::memcpy(data, source + first * sizeof(SCALAR), n * sizeof(SCALAR));
+        }
+        else if (record.header.scalarType == BinaryLogScalarType::FLOAT32)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                float value;
+                std::memcpy(&value, source + (first + i) * sizeof(float), sizeof(float));
+                data[i] = static_cast<SCALAR>(value);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                double value;
+                std::memcpy(&value, source + (first + i) * sizeof(double), sizeof(double));
+                data[i] = static_cast<SCALAR>(value);
+            }
+        }
+    }
+
+    void close()
+    {
+        if (mapping_)
+            ::munmap(const_cast<char*>(mapping_), mappedBytes_);
+        mapping_ = nullptr;
+        if (fd_ >= 0)
+            ::close(fd_);
+        fd_ = -1;
+    }
+
+    std::string fileName_;
+    int fd_;
+    const char* mapping_;
+    size_t mappedBytes_;
+    size_t parsedBytes_;
+    std::vector<Record> records_;
+};
+
+}  // namespace core
+}  // namespace ct
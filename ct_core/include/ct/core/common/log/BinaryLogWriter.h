@@ -0,0 +1,330 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <ct/core/types/arrays/DiscreteArray.h>
+
+#include "BinaryLogFormat.h"
+#include "LockFreeRingBuffer.h"
+
+namespace ct {
+namespace core {
+
+//! Writes trajectories and solver statistics to a binary, memory-mapped log file
+/*!
+ * Logging is split into two stages, such that it can be left enabled in real-time loops, e.g. in MPC:
+ * - log() copies the data into a lock-free ring buffer. It neither blocks nor allocates memory. If the buffer is full,
+ *   the record is dropped and the gap shows up in the sequence numbers of the file.
+ * - a background thread periodically moves the records from the ring buffer into the memory-mapped log file, which is
+ *   grown in chunks as needed.
+ *
+ * The file format is described in BinaryLogFormat.h, use the BinaryLogReader to read the files, also while they are
+ * being written.
+ *
+ * log() supports a single producer thread, calls from different threads need to be synchronized by the user.
+ *
+ * Usage:
+ * \code
+ * ct::core::BinaryLogWriter log("mpc.ctlog");
+ * log.log("x", stateTrajectory, t);
+ * log.log("L", feedbackTrajectory, t);
+ * \endcode
+ */
+class BinaryLogWriter
+{
+public:
+    //! constructor, creates or truncates the log file and starts the background thread
+    /*!
+     * @param fileName name of the log file
+     * @param bufferBytes capacity of the ring buffer, should hold all data logged within a few flush periods
+     * @param flushPeriod period in which the ring buffer is written to the file
+     * @param fileChunkBytes the file is grown in chunks of this size
+     */
+    BinaryLogWriter(const std::string& fileName,
+        size_t bufferBytes = 1 << 22,
+        std::chrono::microseconds flushPeriod = std::chrono::microseconds(1000),
+        size_t fileChunkBytes = 1 << 24)
+        : fileName_(fileName),
+          ring_(bufferBytes),
+          flushPeriod_(flushPeriod),
+          fileChunkBytes_(internal::binaryLogPadding(std::max(fileChunkBytes, size_t(4096)))),
+          fd_(-1),
+          mapping_(nullptr),
+          mappedBytes_(0),
+          fileBytes_(0),
+          failed_(false),
+          sequence_(0),
+          committedBytes_(0),
+          writtenBytes_(0),
+          droppedRecords_(0),
+          running_(true)
+    {
+        fd_ = ::open(fileName_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0)
+            throw std::runtime_error("BinaryLogWriter: cannot open " + fileName_);
+
+        if (!map(sizeof(BinaryLogFileHeader)))
+        {
+            ::close(fd_);
+            throw std::runtime_error("BinaryLogWriter: cannot map " + fileName_);
+        }
+
+        BinaryLogFileHeader header;
+        std::memcpy(header.magic, BINARY_LOG_FILE_MAGIC, sizeof(header.magic));
+        header.version = BINARY_LOG_VERSION;
+        header.headerBytes = sizeof(BinaryLogRecordHeader);
+        std::memcpy(mapping_, &header, sizeof(header));
+        fileBytes_ = sizeof(header);
+
+        thread_ = std::thread(&BinaryLogWriter::run, this);
+    }
+
+    //! destructor, writes all pending records and closes the file
+    ~BinaryLogWriter()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        stopped_.notify_one();
+        thread_.join();
+
+        if (mapping_)
+            ::munmap(mapping_, mappedBytes_);
+        if (::ftruncate(fd_, fileBytes_) != 0)
+            std::cerr << "BinaryLogWriter: cannot truncate " << fileName_ << std::endl;
+        ::close(fd_);
+    }
+
+    BinaryLogWriter(const BinaryLogWriter&) = delete;
+    BinaryLogWriter& operator=(const BinaryLogWriter&) = delete;
+
+    //! log an array of scalars or matrices, e.g. a TimeArray, StateVectorArray, ControlVectorArray or FeedbackArray
+    /*!
+     * @param channel name of the channel, truncated to BINARY_LOG_CHANNEL_LENGTH-1 characters
+     * @param array the data
+     * @param stamp a user defined time stamp
+     * @return false if the record was dropped because the ring buffer is full
+     */
+    template <typename T, typename ALLOC>
+    bool log(const char* channel, const DiscreteArray<T, ALLOC>& array, double stamp = 0.0)
+    {
+        typedef internal::BinaryLogElement<T> Element;
+        typedef typename Element::Scalar Scalar;
+
+        size_t rows = array.size() == 0 ? 0 : Element::rows(array[0]);
+        size_t cols = array.size() == 0 ? 0 : Element::cols(array[0]);
+        for (size_t i = 0; i < array.size(); i++)
+        {
+            if (Element::rows(array[i]) != rows || Element::cols(array[i]) != cols)
+                throw std::runtime_error("BinaryLogWriter: all elements of an array need to have the same size");
+        }
+
+        BinaryLogRecordHeader header;
+        if (!beginRecord(header, Element::arrayType, internal::BinaryLogScalar<Scalar>::type, channel, stamp, rows,
+                cols, array.size()))
+            return false;
+
+        for (size_t i = 0; i < array.size(); i++)
+            ring_.write(Element::data(array[i]), rows * cols * sizeof(Scalar));
+
+        endRecord(header);
+        return true;
+    }
+
+    //! log a single matrix or vector
+    /*!
+     * @param channel name of the channel, truncated to BINARY_LOG_CHANNEL_LENGTH-1 characters
+     * @param matrix the data
+     * @param stamp a user defined time stamp
+     * @return false if the record was dropped because the ring buffer is full
+     */
+    template <typename DERIVED>
+    bool log(const char* channel, const Eigen::PlainObjectBase<DERIVED>& matrix, double stamp = 0.0)
+    {
+        typedef internal::BinaryLogElement<DERIVED> Element;
+        typedef typename Element::Scalar Scalar;
+
+        BinaryLogRecordHeader header;
+        if (!beginRecord(header, BinaryLogRecordType::MATRIX, internal::BinaryLogScalar<Scalar>::type, channel, stamp,
+                matrix.rows(), matrix.cols(), 1))
+            return false;
+
+        ring_.write(matrix.data(), matrix.size() * sizeof(Scalar));
+
+        endRecord(header);
+        return true;
+    }
+
+    //! block until all records logged so far have been written to the file
+    void flush()
+    {
+        const size_t target = committedBytes_.load();
+        while (writtenBytes_.load() < target)
+            std::this_thread::sleep_for(flushPeriod_ / 4);
+    }
+
+    //! number of records dropped because the ring buffer was full or the file could not be grown
+    size_t droppedRecords() const { return droppedRecords_.load(); }
+    //! the name of the log file
+    const std::string& fileName() const { return fileName_; }
+private:
+    //! write the record header into the ring buffer
+    bool beginRecord(BinaryLogRecordHeader& header,
+        BinaryLogRecordType type,
+        BinaryLogScalarType scalarType,
+        const char* channel,
+        double stamp,
+        size_t rows,
+        size_t cols,
+        size_t count)
+    {
+        std::memset(&header, 0, sizeof(header));
+        header.magic = BINARY_LOG_RECORD_MAGIC;
+        header.type = type;
+        header.scalarType = scalarType;
+        header.sequence = sequence_++;
+        header.stamp = stamp;
+        header.rows = rows;
+        header.cols = cols;
+        header.count = count;
+        header.payloadBytes = internal::binaryLogPadding(header.dataBytes());
+        std::strncpy(header.channel, channel, BINARY_LOG_CHANNEL_LENGTH - 1);
+
+        if (!ring_.beginWrite(sizeof(header) + header.payloadBytes))
+        {
+            droppedRecords_++;
+            return false;
+        }
+
+        ring_.write(&header, sizeof(header));
+        return true;
+    }
+
+    //! pad and commit the record
+    void endRecord(const BinaryLogRecordHeader& header)
+    {
+        ring_.writeZeros(header.payloadBytes - header.dataBytes());
+        ring_.commitWrite();
+        committedBytes_ += sizeof(header) + header.payloadBytes;
+    }
+
+    //! the background thread
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_)
+        {
+            writeAvailable();
+            stopped_.wait_for(lock, flushPeriod_);
+        }
+        writeAvailable();
+    }
+
+    //! move all committed records from the ring buffer into the file
+    void writeAvailable()
+    {
+        const size_t available = ring_.readAvailable();
+
+        size_t offset = 0;
+        while (offset < available)
+        {
+            BinaryLogRecordHeader header;
+            ring_.peek(offset, &header, sizeof(header));
+            const size_t recordBytes = sizeof(header) + header.payloadBytes;
+
+            if (!failed_ && map(fileBytes_ + recordBytes))
+            {
+                // the magic number is written last, such that readers never see incomplete records
+                char* destination = mapping_ + fileBytes_;
+                ring_.peek(offset + sizeof(header.magic), destination + sizeof(header.magic),
+                    recordBytes - sizeof(header.magic));
+                std::atomic_thread_fence(std::memory_order_release);
+                std::memcpy(destination, &header.magic, sizeof(header.magic));
+                fileBytes_ += recordBytes;
+            }
+            else
+            {
+                failed_ = true;
+                droppedRecords_++;
+            }
+
+            offset += recordBytes;
+        }
+
+        ring_.consume(available);
+        writtenBytes_ += available;
+    }
+
+    //! make sure that at least a given number of bytes of the file are mapped
+    bool map(size_t bytes)
+    {
+        if (bytes <= mappedBytes_)
+            return true;
+
+        const size_t newBytes = ((bytes + fileChunkBytes_ - 1) / fileChunkBytes_) * fileChunkBytes_;
+
+        if (mapping_)
+            ::munmap(mapping_, mappedBytes_);
+        mapping_ = nullptr;
+        mappedBytes_ = 0;
+
+        if (::ftruncate(fd_, newBytes) != 0)
+            return false;
+
+        void* mapping = ::mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED)
+            return false;
+
+        mapping_ = static_cast<char*>(mapping);
+        mappedBytes_ = newBytes;
+        return true;
+    }
+
+    std::string fileName_;
+    LockFreeRingBuffer ring_;
+    std::chrono::microseconds flushPeriod_;
+    size_t fileChunkBytes_;
+
+    //! file state, only accessed by the background thread after construction
+    int fd_;
+    char* mapping_;
+    size_t mappedBytes_;
+    size_t fileBytes_;
+    bool failed_;
+
+    //! sequence number of the next record, only accessed by the producer
+    uint64_t sequence_;
+
+    std::atomic<size_t> committedBytes_;
+    std::atomic<size_t> writtenBytes_;
+    std::atomic<size_t> droppedRecords_;
+
+    //! used to wake up the background thread on destruction, never touched by the producer
+    std::mutex mutex_;
+    std::condition_variable stopped_;
+    bool running_;
+
+    std::thread thread_;
+};
+
+}  // namespace core
+}  // namespace ct
@@ -0,0 +1,129 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace ct {
+namespace core {
+
+//! A lock-free byte ring buffer for a single producer and a single consumer
+/*!
+ * The producer writes a message in pieces between beginWrite() and commitWrite(). The consumer only sees committed
+ * messages, hence it never reads a partially written message. Neither side ever blocks or allocates memory, if there is
+ * not enough space left, beginWrite() fails and the message has to be dropped.
+ *
+ * Positions are counted in bytes since construction and only mapped into the buffer on access, therefore the capacity
+ * is rounded up to the next power of two.
+ */
+class LockFreeRingBuffer
+{
+public:
+    //! constructor
+    /*!
+     * @param capacity minimum capacity in bytes
+     */
+    explicit LockFreeRingBuffer(size_t capacity) : head_(0), tail_(0), writePosition_(0)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        buffer_.resize(size);
+        mask_ = size - 1;
+    }
+
+    LockFreeRingBuffer(const LockFreeRingBuffer&) = delete;
+    LockFreeRingBuffer& operator=(const LockFreeRingBuffer&) = delete;
+
+    //! capacity in bytes
+    size_t capacity() const { return buffer_.size(); }
+    //! start writing a message of a given size (producer only)
+    /*!
+     * @param bytes total size of the message
+     * @return true if the buffer has enough space left for the message
+     */
+    bool beginWrite(size_t bytes)
+    {
+        writePosition_ = head_.load(std::memory_order_relaxed);
+        return writePosition_ + bytes - tail_.load(std::memory_order_acquire) <= buffer_.size();
+    }
+
+    //! append data to the message started with beginWrite() (producer only)
+    void write(const void* data, size_t bytes)
+    {
+        copyIn(writePosition_, static_cast<const char*>(data), bytes);
+        writePosition_ += bytes;
+    }
+
+    //! append zeros to the message started with beginWrite() (producer only)
+    void writeZeros(size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; i++)
+            buffer_[(writePosition_ + i) & mask_] = 0;
+        writePosition_ += bytes;
+    }
+
+    //! make the message visible to the consumer (producer only)
+    void commitWrite() { head_.store(writePosition_, std::memory_order_release); }
+    //! number of committed bytes which have not been consumed yet (consumer only)
+    size_t readAvailable() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+    //! copy data without consuming it (consumer only)
+    /*!
+     * @param offset offset from the oldest unconsumed byte
+     * @param data destination
+     * @param bytes number of bytes to copy, offset + bytes must not exceed readAvailable()
+     */
+    void peek(size_t offset, void* data, size_t bytes) const
+    {
+        copyOut(tail_.load(std::memory_order_relaxed) + offset, static_cast<char*>(data), bytes);
+    }
+
+    //! release bytes to the producer (consumer only)
+    void consume(size_t bytes)
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + bytes, std::memory_order_release);
+    }
+
+private:
+    void copyIn(size_t position, const char* data, size_t bytes)
+    {
+        const size_t index = position & mask_;
+        const size_t first = std::min(bytes, buffer_.size() - index);
+        std::memcpy(&buffer_[index], data, first);
+        std::memcpy(&buffer_[0], data + first, bytes - first);
+    }
+
+    void copyOut(size_t position, char* data, size_t bytes) const
+    {
+        const size_t index = position & mask_;
+        const size_t first = std::min(bytes, buffer_.size() - index);
+        std::memcpy(data, &buffer_[index], first);
+        std::memcpy(data + first, &buffer_[0], bytes - first);
+    }
+
+    std::vector<char> buffer_;
+    size_t mask_;
+
+    //! the positions are kept on separate cache lines, such that producer and consumer do not interfere
+    char padding0_[64];
+    //! position of the next message to be committed, written by the producer
+    std::atomic<size_t> head_;
+    char padding1_[64];
+    //! position of the oldest unconsumed byte, written by the consumer
+    std::atomic<size_t> tail_;
+    char padding2_[64];
+    //! producer local write position of the current message
+    size_t writePosition_;
+};
+
+}  // namespace core
+}  // namespace ct
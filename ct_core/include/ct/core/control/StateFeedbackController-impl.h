@@ -47,20 +47,20 @@ void StateFeedbackController<STATE_DIM, CONTROL_DIM, SCALAR>::update(const Discr
     const DiscreteArray<FeedbackMatrix<STATE_DIM, CONTROL_DIM, SCALAR>>& K,
     const tpl::TimeArray<SCALAR>& t)
 {
-    tpl::TimeArray<SCALAR> tshort = t;
-    tshort.pop_back();  // todo: the copying here is not optimal
-
-    if (K.size() != tshort.size())
-        throw std::runtime_error("StateFeedbackController.h : K.size() != tshort.size()");
-    if (uff.size() != tshort.size())
-        throw std::runtime_error("StateFeedbackController.h : uff.size() != tshort.size()");
+    if (K.size() + 1 != t.size())
+        throw std::runtime_error("StateFeedbackController.h : K.size() != t.size() - 1");
+    if (uff.size() + 1 != t.size())
+        throw std::runtime_error("StateFeedbackController.h : uff.size() != t.size() - 1");
     if (x_ref.size() != t.size())
         throw std::runtime_error("StateFeedbackController.h : x_ref.size() != t.size()");
 
+    // assign and shorten in place, such that the trajectories keep their storage
     x_ref_.setData(x_ref), x_ref_.setTime(t), uff_.setData(uff);
-    uff_.setTime(tshort);
+    uff_.setTime(t);
+    uff_.getTimeArray().pop_back();
     K_.setData(K);
-    K_.setTime(tshort);
+    K_.setTime(t);
+    K_.getTimeArray().pop_back();
 }
 
 
@@ -59,6 +59,11 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include "Geometry-impl"
 #include "Simulation-impl"
 
+// explicit instantiation declarations of the prespec libraries, generated by cmake
+#ifdef CT_CORE_EXTERN_TEMPLATES
+#include <ct/core/core-extern-templates.h>
+#endif
+
 // keep standard header guard (easy debugging)
 // header guard is identical to the one in core-prespec.h
 #endif  // INCLUDE_CT_CORE_CORE_H_
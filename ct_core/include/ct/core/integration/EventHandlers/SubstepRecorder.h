@@ -57,14 +57,23 @@ public:
     }
 
     void setEnable(bool activated) { activated_ = activated; }
-    //! resets kill flag to false
+    //! reserve memory for a number of substeps, avoids growing the containers while recording
+    void reserve(size_t nSubsteps)
+    {
+        states_->reserve(nSubsteps);
+        controls_->reserve(nSubsteps);
+        times_->reserve(nSubsteps);
+    }
+    //! clears the recorded substeps
+    /*!
+     * The containers are cleared in place and keep their capacity, such that recording does not allocate memory
+     * once the recorder is warmed up. Copy the substeps before the next reset if they are needed afterwards.
+     */
     virtual void reset() override
     {
-        states_ = std::shared_ptr<ct::core::StateVectorArray<STATE_DIM, SCALAR>>(
-            new ct::core::StateVectorArray<STATE_DIM, SCALAR>);
-        controls_ = std::shared_ptr<ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>>(
-            new ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>);
-        times_ = std::shared_ptr<ct::core::tpl::TimeArray<SCALAR>>(new ct::core::tpl::TimeArray<SCALAR>);
+        states_->clear();
+        controls_->clear();
+        times_->clear();
     };
 
     const std::shared_ptr<ct::core::StateVectorArray<STATE_DIM, SCALAR>>& getSubstates() const { return states_; }
@@ -0,0 +1,118 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <ct/core/integration/EventHandler.h>
+
+namespace ct {
+namespace core {
+
+//! Event handler for events defined by the zero crossing of an event function
+/*!
+ * An event happens when the event function \f$ g(x,t) \f$ changes its sign in the specified direction, e.g. when a
+ * foot touches the ground or a guard of a switched system is crossed.
+ *
+ * Used with Integrator::integrate_events(), the zero crossing is localized within the integration step by root
+ * finding on the dense output (RK5VARIABLE) or on a Hermite interpolation of the step (all other steppers). The
+ * integration stops exactly at the event, calls handleEvent() and resetState() and restarts from there.
+ * With the other integration methods, the event is only detected at the end of the step in which it occurred.
+ *
+ * Derive from this class and implement eventFunction() and handleEvent().
+ *
+ * \note at most one zero crossing per integration step is detected, the step size needs to resolve the event function
+ *
+ * @tparam STATE_DIM size of the state vector
+ */
+template <size_t STATE_DIM, typename SCALAR = double>
+class ZeroCrossingEventHandler : public EventHandler<STATE_DIM, SCALAR>
+{
+public:
+    //! direction of the zero crossing that triggers the event
+    enum class Direction
+    {
+        RISING = 0,  //!< the event function changes from negative to non-negative
+        FALLING,     //!< the event function changes from positive to non-positive
+        BOTH
+    };
+
+    //! constructor
+    /*!
+     * @param direction direction of the zero crossing that triggers the event
+     * @param terminal if true, Integrator::integrate_events() stops the integration at the event
+     */
+    ZeroCrossingEventHandler(const Direction& direction = Direction::BOTH, bool terminal = false)
+        : direction_(direction), terminal_(terminal), initialized_(false), lastValue_(SCALAR(0.0))
+    {
+    }
+
+    //! destructor
+    virtual ~ZeroCrossingEventHandler() {}
+    //! the event function, an event happens when it crosses zero
+    /*!
+     * @param state current state of the system
+     * @param t current time
+     * @return value of the event function
+     */
+    virtual SCALAR eventFunction(const StateVector<STATE_DIM, SCALAR>& state, const SCALAR& t) = 0;
+
+    //! apply a state jump at the event, e.g. an impact map
+    /*!
+     * Called by Integrator::integrate_events() after handleEvent(). The default keeps the state.
+     * @param state the state at the event, contains the state after the jump
+     * @param t time of the event
+     */
+    virtual void resetState(StateVector<STATE_DIM, SCALAR>& state, const SCALAR& t) {}
+    virtual bool callOnSubsteps() override { return false; }
+    //! resets the event detection
+    virtual void reset() override { initialized_ = false; }
+    //! checks if the event function crossed zero since the last call
+    virtual bool checkEvent(const StateVector<STATE_DIM, SCALAR>& state, const SCALAR& t) override
+    {
+        const SCALAR value = eventFunction(state, t);
+        const bool event = initialized_ && crossesZero(lastValue_, value);
+        lastValue_ = value;
+        initialized_ = true;
+        return event;
+    }
+
+    //! restart the event detection at a given state without triggering an event, e.g. after a state jump
+    void initialize(const StateVector<STATE_DIM, SCALAR>& state, const SCALAR& t)
+    {
+        lastValue_ = eventFunction(state, t);
+        initialized_ = true;
+    }
+
+    //! true if the event function crosses zero in the direction of interest between two of its values
+    bool crossesZero(const SCALAR& before, const SCALAR& after) const
+    {
+        const bool rising = before < SCALAR(0.0) && after >= SCALAR(0.0);
+        const bool falling = before > SCALAR(0.0) && after <= SCALAR(0.0);
+        switch (direction_)
+        {
+            case Direction::RISING:
+                return rising;
+            case Direction::FALLING:
+                return falling;
+            default:
+                return rising || falling;
+        }
+    }
+
+    //! value of the event function at the last call of checkEvent() or initialize()
+    const SCALAR& lastValue() const { return lastValue_; }
+    //! true if the integration stops at the event
+    bool isTerminal() const { return terminal_; }
+    //! direction of the zero crossing that triggers the event
+    const Direction& getDirection() const { return direction_; }
+private:
+    Direction direction_;  //! direction of the zero crossing
+    bool terminal_;        //! stop the integration at the event
+    bool initialized_;     //! true once the event function has been evaluated
+    SCALAR lastValue_;     //! value of the event function at the last evaluation
+};
+
+}  // namespace core
+}  // namespace ct
@@ -13,20 +13,33 @@ template <size_t STATE_DIM, typename SCALAR>
 Integrator<STATE_DIM, SCALAR>::Integrator(const std::shared_ptr<System<STATE_DIM, SCALAR>>& system,
     const IntegrationType& intType,
     const EventHandlerPtrVector& eventHandlers)
-    : system_(system), observer_(eventHandlers)
+    : system_(system), observer_(eventHandlers), eventTimeTolerance_(SCALAR(1e-10))
 {
     changeIntegrationType(intType);
     setupSystem();
+    setupZeroCrossingEventHandlers();
 }
 
 template <size_t STATE_DIM, typename SCALAR>
 Integrator<STATE_DIM, SCALAR>::Integrator(const std::shared_ptr<System<STATE_DIM, SCALAR>>& system,
     const IntegrationType& intType,
     const EventHandlerPtr& eventHandler)
-    : system_(system), observer_(EventHandlerPtrVector(1, eventHandler))
+    : system_(system), observer_(EventHandlerPtrVector(1, eventHandler)), eventTimeTolerance_(SCALAR(1e-10))
 {
     changeIntegrationType(intType);
     setupSystem();
+    setupZeroCrossingEventHandlers();
+}
+
+template <size_t STATE_DIM, typename SCALAR>
+Integrator<STATE_DIM, SCALAR>::Integrator(const std::shared_ptr<System<STATE_DIM, SCALAR>>& system,
+    const StepperPtr& stepper,
+    const EventHandlerPtrVector& eventHandlers)
+    : system_(system), observer_(eventHandlers), eventTimeTolerance_(SCALAR(1e-10))
+{
+    changeStepper(stepper);
+    setupSystem();
+    setupZeroCrossingEventHandlers();
 }
 
 template <size_t STATE_DIM, typename SCALAR>
@@ -39,6 +52,14 @@ void Integrator<STATE_DIM, SCALAR>::changeIntegrationType(const IntegrationType&
         throw std::runtime_error("Unknown integration type");
 }
 
+template <size_t STATE_DIM, typename SCALAR>
+void Integrator<STATE_DIM, SCALAR>::changeStepper(const StepperPtr& stepper)
+{
+    if (!stepper)
+        throw std::runtime_error("Integrator: stepper is nullptr");
+    integratorStepper_ = stepper;
+}
+
 
 template <size_t STATE_DIM, typename SCALAR>
 void Integrator<STATE_DIM, SCALAR>::setApadativeErrorTolerances(const SCALAR absErrTol, const SCALAR& relErrTol)
@@ -132,6 +153,189 @@ void Integrator<STATE_DIM, SCALAR>::integrate_times(StateVector<STATE_DIM, SCALA
     retrieveStateVectorArrayFromObserver(stateTrajectory);
 }
 
+template <size_t STATE_DIM, typename SCALAR>
+SCALAR Integrator<STATE_DIM, SCALAR>::integrate_events(StateVector<STATE_DIM, SCALAR>& state,
+    const SCALAR& startTime,
+    const SCALAR& finalTime,
+    StateVectorArray<STATE_DIM, SCALAR>& stateTrajectory,
+    tpl::TimeArray<SCALAR>& timeTrajectory,
+    const SCALAR dtInitial)
+{
+    SCALAR stopTime = integrateEvents(state, startTime, finalTime, dtInitial, true);
+    retrieveTrajectoriesFromObserver(stateTrajectory, timeTrajectory);
+    return stopTime;
+}
+
+template <size_t STATE_DIM, typename SCALAR>
+SCALAR Integrator<STATE_DIM, SCALAR>::integrate_events(StateVector<STATE_DIM, SCALAR>& state,
+    const SCALAR& startTime,
+    const SCALAR& finalTime,
+    SCALAR dtInitial)
+{
+    return integrateEvents(state, startTime, finalTime, dtInitial, false);
+}
+
+template <size_t STATE_DIM, typename SCALAR>
+void Integrator<STATE_DIM, SCALAR>::setEventTimeTolerance(const SCALAR& tolerance)
+{
+    eventTimeTolerance_ = tolerance;
+}
+
+template <size_t STATE_DIM, typename SCALAR>
+SCALAR Integrator<STATE_DIM, SCALAR>::integrateEvents(StateVector<STATE_DIM, SCALAR>& state,
+    const SCALAR& startTime,
+    const SCALAR& finalTime,
+    SCALAR dt,
+    bool logTrajectory)
+{
+    reset();
+
+    const bool denseOutput = integratorStepper_->hasDenseOutput();
+    SCALAR t = startTime;
+    integratorStepper_->initialize(state, t, dt);
+
+    // observe the initial state, which also initializes the event functions
+    if (logTrajectory)
+        observer_.log(state, t);
+    observer_.observe(state, t);
+
+    StateVector<STATE_DIM, SCALAR> xEvent;
+    SCALAR tEvent;
+
+    while (t < finalTime)
+    {
+        stepStartTime_ = t;
+        stepStartState_ = state;
+        if (!denseOutput)
+        {
+            system_->computeDynamics(state, t, stepStartDerivative_);
+            dt = std::min(dt, finalTime - t);
+        }
+
+        integratorStepper_->do_event_step(systemFunction_, state, t, dt);
+
+        // the dense output stepper may step beyond the final time
+        if (denseOutput && t > finalTime)
+        {
+            t = finalTime;
+            integratorStepper_->calc_state(t, state);
+        }
+
+        stepEndTime_ = t;
+        stepEndState_ = state;
+        if (!denseOutput)
+            system_->computeDynamics(state, t, stepEndDerivative_);
+
+        // find the earliest event within the step
+        ZeroCrossingEventHandlerPtr event;
+        for (size_t i = 0; i < zeroCrossingEventHandlers_.size(); i++)
+        {
+            const SCALAR valueEnd = zeroCrossingEventHandlers_[i]->eventFunction(stepEndState_, stepEndTime_);
+            if (!zeroCrossingEventHandlers_[i]->crossesZero(zeroCrossingEventHandlers_[i]->lastValue(), valueEnd))
+                continue;
+
+            localizeEvent(*zeroCrossingEventHandlers_[i], valueEnd, tEvent, xEvent);
+            if (!event || tEvent < t)
+            {
+                event = zeroCrossingEventHandlers_[i];
+                t = tEvent;
+                state = xEvent;
+            }
+        }
+
+        if (logTrajectory)
+            observer_.log(state, t);
+        observer_.observe(state, t);
+
+        if (!event)
+            continue;
+
+        // stop at the event, apply the state jump and restart
+        xEvent = state;
+        event->resetState(state, t);
+        if (logTrajectory && state != xEvent)
+            observer_.log(state, t);
+
+        if (event->isTerminal())
+            break;
+
+        for (size_t i = 0; i < zeroCrossingEventHandlers_.size(); i++)
+            zeroCrossingEventHandlers_[i]->initialize(state, t);
+        integratorStepper_->initialize(state, t, dt);
+    }
+
+    return t;
+}
+
+template <size_t STATE_DIM, typename SCALAR>
+void Integrator<STATE_DIM, SCALAR>::localizeEvent(ZeroCrossingEventHandler<STATE_DIM, SCALAR>& eventHandler,
+    SCALAR valueEnd,
+    SCALAR& tEvent,
+    StateVector<STATE_DIM, SCALAR>& xEvent)
+{
+    const size_t maxIterations = 100;
+
+    // the zero crossing is bracketed by [ta, tb], tb always lies behind the crossing
+    SCALAR ta = stepStartTime_;
+    SCALAR tb = stepEndTime_;
+    SCALAR ga = eventHandler.lastValue();
+    SCALAR gb = valueEnd;
+    xEvent = stepEndState_;
+
+    // Illinois variant of the regula falsi, which halves the value at a bracket end that is retained twice
+    int retainedSide = 0;
+    StateVector<STATE_DIM, SCALAR> xc;
+    for (size_t i = 0; i < maxIterations && tb - ta > eventTimeTolerance_; i++)
+    {
+        SCALAR tc = tb - gb * (tb - ta) / (gb - ga);
+        if (!(tc > ta && tc < tb))
+            tc = SCALAR(0.5) * (ta + tb);
+
+        interpolateStep(tc, xc);
+        const SCALAR gc = eventHandler.eventFunction(xc, tc);
+
+        if (eventHandler.crossesZero(ga, gc))
+        {
+            tb = tc;
+            gb = gc;
+            xEvent = xc;
+            if (retainedSide == -1)
+                ga *= SCALAR(0.5);
+            retainedSide = -1;
+        }
+        else
+        {
+            ta = tc;
+            ga = gc;
+            if (retainedSide == 1)
+                gb *= SCALAR(0.5);
+            retainedSide = 1;
+        }
+    }
+
+    tEvent = tb;
+}
+
+template <size_t STATE_DIM, typename SCALAR>
+void Integrator<STATE_DIM, SCALAR>::interpolateStep(const SCALAR& t, StateVector<STATE_DIM, SCALAR>& x)
+{
+    if (integratorStepper_->hasDenseOutput())
+    {
+        integratorStepper_->calc_state(t, x);
+        return;
+    }
+
+    // cubic Hermite interpolation between the states and derivatives at the start and the end of the step
+    const SCALAR h = stepEndTime_ - stepStartTime_;
+    const SCALAR s = (t - stepStartTime_) / h;
+    const SCALAR s2 = s * s;
+    const SCALAR s3 = s2 * s;
+
+    x = (SCALAR(2.0) * s3 - SCALAR(3.0) * s2 + SCALAR(1.0)) * stepStartState_ +
+        (s3 - SCALAR(2.0) * s2 + s) * h * stepStartDerivative_ + (SCALAR(3.0) * s2 - SCALAR(2.0) * s3) * stepEndState_ +
+        (s3 - s2) * h * stepEndDerivative_;
+}
+
 
 template <size_t STATE_DIM, typename SCALAR>
 void Integrator<STATE_DIM, SCALAR>::initializeCTSteppers(const IntegrationType& intType)
@@ -180,6 +384,20 @@ void Integrator<STATE_DIM, SCALAR>::retrieveStateVectorArrayFromObserver(
 }
 
 
+template <size_t STATE_DIM, typename SCALAR>
+void Integrator<STATE_DIM, SCALAR>::setupZeroCrossingEventHandlers()
+{
+    zeroCrossingEventHandlers_.clear();
+    for (size_t i = 0; i < observer_.eventHandlers_.size(); i++)
+    {
+        ZeroCrossingEventHandlerPtr eventHandler =
+            std::dynamic_pointer_cast<ZeroCrossingEventHandler<STATE_DIM, SCALAR>>(observer_.eventHandlers_[i]);
+        if (eventHandler)
+            zeroCrossingEventHandlers_.push_back(eventHandler);
+    }
+}
+
+
 template <size_t STATE_DIM, typename SCALAR>
 void Integrator<STATE_DIM, SCALAR>::setupSystem()
 {
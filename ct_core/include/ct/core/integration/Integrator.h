@@ -10,6 +10,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include <cmath>
 
 #include "EventHandler.h"
+#include "EventHandlers/ZeroCrossingEventHandler.h"
 #include "Observer.h"
 #include "eigenIntegration.h"
 
@@ -39,9 +40,20 @@ enum IntegrationType
     EULERCT,
     RK4CT,
     EULER_SYM,
-    RK_SYM
+    RK_SYM,
+    VERLET_SYM,
+    FOREST_RUTH_SYM,
+    YOSHIDA4_SYM,
+    YOSHIDA6_SYM
 };
 
+//! true for the integration types which require a symplectic system, see IntegratorSymplectic
+inline bool isSymplecticIntegrator(const IntegrationType& type)
+{
+    return type == EULER_SYM || type == RK_SYM || type == VERLET_SYM || type == FOREST_RUTH_SYM ||
+           type == YOSHIDA4_SYM || type == YOSHIDA6_SYM;
+}
+
 
 //! Standard Integrator
 /*!
@@ -65,6 +77,7 @@ public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
     typedef std::shared_ptr<EventHandler<STATE_DIM, SCALAR>> EventHandlerPtr;
     typedef std::vector<EventHandlerPtr, Eigen::aligned_allocator<EventHandlerPtr>> EventHandlerPtrVector;
+    typedef std::shared_ptr<internal::StepperBase<Eigen::Matrix<SCALAR, STATE_DIM, 1>, SCALAR>> StepperPtr;
 
     //! constructor
     /*!
@@ -83,6 +96,18 @@ public:
         const IntegrationType& intType,
         const EventHandlerPtr& eventHandler);
 
+    //! constructor with a custom stepper
+    /*!
+	 * Creates an integrator with a stepper which is not available as IntegrationType, e.g. a stepper on a manifold
+	 *
+	 * @param system the system (ODE)
+	 * @param stepper the stepper, which must not be shared with other integrators
+	 * @param eventHandlers optional event handler
+	 */
+    Integrator(const std::shared_ptr<System<STATE_DIM, SCALAR>>& system,
+        const StepperPtr& stepper,
+        const EventHandlerPtrVector& eventHandlers = EventHandlerPtrVector(0));
+
     /**
 	 * @brief      Changes the integration type
 	 *
@@ -90,6 +115,13 @@ public:
 	 */
     void changeIntegrationType(const IntegrationType& intType);
 
+    /**
+	 * @brief      Changes the stepper to a custom stepper
+	 *
+	 * @param[in]  stepper  The new stepper, which must not be shared with other integrators
+	 */
+    void changeStepper(const StepperPtr& stepper);
+
 
     /**
 	 * @brief      Sets the adaptive error tolerances
@@ -226,7 +258,85 @@ public:
         StateVectorArray<STATE_DIM, SCALAR>& stateTrajectory,
         SCALAR dtInitial = SCALAR(0.01));
 
+    //! integrate forward from an initial to a final time, stopping exactly at the events of ZeroCrossingEventHandlers
+    /*!
+	 * Integrates forward step by step. After each step, the event functions of all ZeroCrossingEventHandlers are
+	 * checked for a zero crossing. The earliest crossing is localized by root finding (Illinois method) on the dense
+	 * output of the step for RK5VARIABLE and on a cubic Hermite interpolation of the step for all other steppers.
+	 * The integration stops at the event, calls the event handlers and ZeroCrossingEventHandler::resetState(), and
+	 * restarts the stepper from there. Adaptive steppers therefore can take large steps across switching times.
+	 *
+	 * Records state and time evolution, including the states at the events. If the state jumps at an event, both the
+	 * state before and after the jump are recorded. For a recording free version see function below.
+	 *
+	 * \note an event function may only cross zero once per step. Steppers which take very large steps on smooth
+	 * trajectories, such as BULIRSCHSTOER, may step over two crossings.
+	 *
+	 * \warning Overrides the initial state
+	 *
+	 * @param state initial state, contains the final state after integration
+	 * @param startTime start time of the integration
+	 * @param finalTime the final time of the integration
+	 * @param stateTrajectory state evolution over time
+	 * @param timeTrajectory time trajectory corresponding to state trajectory
+	 * @param dtInitial step size (initial guess, for fixed step integrators it is fixed)
+	 * @return the time at which the integration stopped, which is the final time unless a terminal event occurred
+	 */
+    SCALAR integrate_events(StateVector<STATE_DIM, SCALAR>& state,
+        const SCALAR& startTime,
+        const SCALAR& finalTime,
+        StateVectorArray<STATE_DIM, SCALAR>& stateTrajectory,
+        tpl::TimeArray<SCALAR>& timeTrajectory,
+        const SCALAR dtInitial = SCALAR(0.01));
+
+    //! integrate forward from an initial to a final time, stopping exactly at the events of ZeroCrossingEventHandlers
+    /*!
+	 * see the function above
+	 *
+	 * \warning Overrides the initial state
+	 *
+	 * @param state initial state, contains the final state after integration
+	 * @param startTime start time of the integration
+	 * @param finalTime the final time of the integration
+	 * @param dtInitial step size (initial guess, for fixed step integrators it is fixed)
+	 * @return the time at which the integration stopped, which is the final time unless a terminal event occurred
+	 */
+    SCALAR integrate_events(StateVector<STATE_DIM, SCALAR>& state,
+        const SCALAR& startTime,
+        const SCALAR& finalTime,
+        SCALAR dtInitial = SCALAR(0.01));
+
+    //! set the tolerance on the event times localized in integrate_events()
+    void setEventTimeTolerance(const SCALAR& tolerance);
+
 private:
+    typedef std::shared_ptr<ZeroCrossingEventHandler<STATE_DIM, SCALAR>> ZeroCrossingEventHandlerPtr;
+
+    //! the integration loop of integrate_events()
+    SCALAR integrateEvents(StateVector<STATE_DIM, SCALAR>& state,
+        const SCALAR& startTime,
+        const SCALAR& finalTime,
+        SCALAR dt,
+        bool logTrajectory);
+
+    //! localizes the zero crossing of an event function within the last step
+    /*!
+	 * @param eventHandler the event handler whose event function crosses zero within the last step
+	 * @param valueEnd value of the event function at the end of the step
+	 * @param tEvent the time of the event, at most eventTimeTolerance_ after the zero crossing
+	 * @param xEvent the state at the event
+	 */
+    void localizeEvent(ZeroCrossingEventHandler<STATE_DIM, SCALAR>& eventHandler,
+        SCALAR valueEnd,
+        SCALAR& tEvent,
+        StateVector<STATE_DIM, SCALAR>& xEvent);
+
+    //! evaluate the dense output or the Hermite interpolation of the last step
+    void interpolateStep(const SCALAR& t, StateVector<STATE_DIM, SCALAR>& x);
+
+    //! collect the ZeroCrossingEventHandlers among the event handlers
+    void setupZeroCrossingEventHandlers();
+
     /**
 	 * @brief      Initializes the custom ct steppers
 	 *
@@ -235,13 +345,13 @@ private:
     void initializeCTSteppers(const IntegrationType& intType);
     /**
 	 * @brief      Initializes the adaptive odeint steppers. The odeint steppers
-	 *             only work for double currently
+	 *             only work for floating point types currently
 	 *
 	 * @param[in]  intType  The integration type
 	 *
 	 */
     template <typename S = SCALAR>
-    typename std::enable_if<std::is_same<S, double>::value, void>::type initializeAdaptiveSteppers(
+    typename std::enable_if<std::is_floating_point<S>::value, void>::type initializeAdaptiveSteppers(
         const IntegrationType& intType)
     {
         switch (intType)
@@ -280,7 +390,7 @@ private:
     }
 
     template <typename S = SCALAR>
-    typename std::enable_if<!std::is_same<S, double>::value, void>::type initializeAdaptiveSteppers(
+    typename std::enable_if<!std::is_floating_point<S>::value, void>::type initializeAdaptiveSteppers(
         const IntegrationType& intType)
     {
     }
@@ -294,14 +404,14 @@ private:
 #endif
 
     /**
-	 * @brief      Initializes the ODEint fixed size steppers for double type. Does not work for
+	 * @brief      Initializes the ODEint fixed size steppers for floating point types. Does not work for
 	 *             ad types
 	 *
 	 * @param[in]  intType  The int type
 	 *
 	 */
     template <typename S = SCALAR>
-    typename std::enable_if<std::is_same<S, double>::value, void>::type initializeODEIntSteppers(
+    typename std::enable_if<std::is_floating_point<S>::value, void>::type initializeODEIntSteppers(
         const IntegrationType& intType)
     {
         switch (intType)
@@ -375,8 +485,21 @@ private:
     std::shared_ptr<System<STATE_DIM, SCALAR>> system_;  //! pointer to the system
     std::function<void(const Eigen::Matrix<SCALAR, STATE_DIM, 1>&, Eigen::Matrix<SCALAR, STATE_DIM, 1>&, SCALAR)>
         systemFunction_;  //! the system function to integrate
-    std::shared_ptr<internal::StepperBase<Eigen::Matrix<SCALAR, STATE_DIM, 1>, SCALAR>> integratorStepper_;
+    StepperPtr integratorStepper_;
     Observer<STATE_DIM, SCALAR> observer_;  //! observer
+
+    //! the event handlers which are localized in integrate_events()
+    std::vector<ZeroCrossingEventHandlerPtr, Eigen::aligned_allocator<ZeroCrossingEventHandlerPtr>>
+        zeroCrossingEventHandlers_;
+    SCALAR eventTimeTolerance_;  //! tolerance on the localized event times
+
+    // the last step of integrate_events(), used for the event localization
+    SCALAR stepStartTime_;
+    SCALAR stepEndTime_;
+    StateVector<STATE_DIM, SCALAR> stepStartState_;
+    StateVector<STATE_DIM, SCALAR> stepEndState_;
+    StateVector<STATE_DIM, SCALAR> stepStartDerivative_;
+    StateVector<STATE_DIM, SCALAR> stepEndDerivative_;
 };
 }
 }
@@ -25,6 +25,11 @@ namespace core {
  * @brief      This class wraps the symplectic integrators from boost to this
  *             toolbox.
  *
+ * Besides symplectic Euler and the symplectic RK method from boost, the splitting methods
+ * Stoermer-Verlet (2nd order), Forest-Ruth (PEFRL, 4th order), Yoshida (4th and 6th order)
+ * are available, see SymplecticCoefficients.h. The higher order methods remain energy-stable
+ * at large time steps and hence require fewer integration substeps for the same accuracy.
+ *
  * @tparam     POS_DIM      The position dimension
  * @tparam     VEL_DIM      The velocity dimension
  * @tparam     CONTROL_DIM  The control dimension
@@ -128,5 +133,33 @@ using IntegratorSymplecticEuler =
 template <size_t POS_DIM, size_t VEL_DIM, size_t CONTROL_DIM, typename SCALAR = double>
 using IntegratorSymplecticRk =
     IntegratorSymplectic<POS_DIM, VEL_DIM, CONTROL_DIM, internal::symplectic_rk_t<POS_DIM, VEL_DIM, SCALAR>, SCALAR>;
+
+template <size_t POS_DIM, size_t VEL_DIM, size_t CONTROL_DIM, typename SCALAR = double>
+using IntegratorSymplecticVerlet = IntegratorSymplectic<POS_DIM,
+    VEL_DIM,
+    CONTROL_DIM,
+    internal::symplectic_verlet_t<POS_DIM, VEL_DIM, SCALAR>,
+    SCALAR>;
+
+template <size_t POS_DIM, size_t VEL_DIM, size_t CONTROL_DIM, typename SCALAR = double>
+using IntegratorSymplecticForestRuth = IntegratorSymplectic<POS_DIM,
+    VEL_DIM,
+    CONTROL_DIM,
+    internal::symplectic_forest_ruth_t<POS_DIM, VEL_DIM, SCALAR>,
+    SCALAR>;
+
+template <size_t POS_DIM, size_t VEL_DIM, size_t CONTROL_DIM, typename SCALAR = double>
+using IntegratorSymplecticYoshida4 = IntegratorSymplectic<POS_DIM,
+    VEL_DIM,
+    CONTROL_DIM,
+    internal::symplectic_yoshida4_t<POS_DIM, VEL_DIM, SCALAR>,
+    SCALAR>;
+
+template <size_t POS_DIM, size_t VEL_DIM, size_t CONTROL_DIM, typename SCALAR = double>
+using IntegratorSymplecticYoshida6 = IntegratorSymplectic<POS_DIM,
+    VEL_DIM,
+    CONTROL_DIM,
+    internal::symplectic_yoshida6_t<POS_DIM, VEL_DIM, SCALAR>,
+    SCALAR>;
 }
 }
@@ -52,8 +52,9 @@ public:
 
 private:
     //! Lambda to pass to odeint (odeint takes copies of the observer so we can't pass the class
-    std::function<void(const StateVector<STATE_DIM, SCALAR>& x, const SCALAR& t)> observeWrap;
-    std::function<void(const StateVector<STATE_DIM, SCALAR>& x, const SCALAR& t)> observeWrapWithLogging;
+    //! \note the signature matches the one of the steppers, such that no wrapping (and allocation) is required
+    std::function<void(const Eigen::Matrix<SCALAR, STATE_DIM, 1>& x, const SCALAR& t)> observeWrap;
+    std::function<void(const Eigen::Matrix<SCALAR, STATE_DIM, 1>& x, const SCALAR& t)> observeWrapWithLogging;
 
     ct::core::StateVectorArray<STATE_DIM, SCALAR> states_;  //!< container for logging the state
     ct::core::tpl::TimeArray<SCALAR> times_;                //!< container for logging the time
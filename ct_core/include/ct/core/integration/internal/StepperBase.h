@@ -165,6 +165,43 @@ public:
         throw std::runtime_error("integrate_times not implemented for the stepper type");
     }
 
+    /**
+     * @brief         Performs a single integration step. Used by Integrator::integrate_events() to localize events.
+     *
+     * @param[in]     rhs    The ODE to be integrated
+     * @param[in,out] state  The state, contains the state at the end of the step
+     * @param[in,out] time   The start time of the step, contains the end time of the step
+     * @param[in,out] dt     The integration timestep, adaptive steppers return the proposed next timestep
+     */
+    virtual void do_event_step(const std::function<void(const MATRIX&, MATRIX&, SCALAR)>& rhs,
+        MATRIX& state,
+        SCALAR& time,
+        SCALAR& dt)
+    {
+        throw std::runtime_error("do_event_step not implemented for the stepper type");
+    }
+
+    /**
+     * @brief      (Re-)starts the single step integration at a given state, e.g. after an event
+     *
+     * @param[in]  state  The state
+     * @param[in]  time   The time
+     * @param[in]  dt     The (initial) integration timestep
+     */
+    virtual void initialize(const MATRIX& state, const SCALAR& time, const SCALAR& dt) {}
+    //! true if the stepper provides a dense output of the last step taken with do_event_step()
+    virtual bool hasDenseOutput() const { return false; }
+    /**
+     * @brief      Evaluates the dense output of the last step taken with do_event_step()
+     *
+     * @param[in]  time   The time, within the last step
+     * @param[out] state  The interpolated state
+     */
+    virtual void calc_state(const SCALAR& time, MATRIX& state)
+    {
+        throw std::runtime_error("calc_state not implemented for the stepper type");
+    }
+
     /**
      * @brief      Sets the adaptive error tolerances.
      *
@@ -56,6 +56,15 @@ public:
         }
     }
 
+    virtual void do_event_step(const std::function<void(const MATRIX&, MATRIX&, SCALAR)>& rhs,
+        MATRIX& state,
+        SCALAR& time,
+        SCALAR& dt) override
+    {
+        do_step(rhs, state, time, dt);
+        time += dt;
+    }
+
     /**
      * @brief          Implements a single step of the integration scheme
      *
@@ -12,6 +12,31 @@ namespace ct {
 namespace core {
 namespace internal {
 
+/**
+ * @brief         Repeats a step of a controlled ODEInt stepper until it gets accepted
+ *
+ * @param[in]     stepper  The controlled stepper
+ * @param[in]     rhs      The ODE to be integrated
+ * @param[in,out] state    The state, contains the state at the end of the step
+ * @param[in,out] time     The start time of the step, contains the end time of the step
+ * @param[in,out] dt       The trial timestep, contains the proposed next timestep
+ */
+template <class CONTROLLED_STEPPER, typename MATRIX, typename SCALAR>
+void tryStepUntilAccepted(CONTROLLED_STEPPER& stepper,
+    const std::function<void(const MATRIX&, MATRIX&, SCALAR)>& rhs,
+    MATRIX& state,
+    SCALAR& time,
+    SCALAR& dt)
+{
+    const size_t maxTrials = 500;  // same limit as in boost::numeric::odeint::integrate_adaptive
+    for (size_t i = 0; i < maxTrials; i++)
+    {
+        if (stepper.try_step(rhs, state, time, dt) == boost::numeric::odeint::success)
+            return;
+    }
+    throw std::runtime_error("Integration failed: step size adjustment did not converge");
+}
+
 /**
  * @brief      The interface to call the integration routines from ODEInt
  *
@@ -94,7 +119,61 @@ public:
             stepper_, rhs, state, &timeTrajectory.front(), &timeTrajectory.back() + 1, dtInitial, observer);
     }
 
+    virtual void do_event_step(const std::function<void(const MATRIX&, MATRIX&, SCALAR)>& rhs,
+        MATRIX& state,
+        SCALAR& time,
+        SCALAR& dt) override
+    {
+        doEventStep<typename STEPPER::stepper_category>(rhs, state, time, dt);
+    }
+
+    virtual void initialize(const MATRIX& state, const SCALAR& time, const SCALAR& dt) override
+    {
+        resetStepper<typename STEPPER::stepper_category>();
+    }
+
 private:
+    //! a step of a basic or error stepper
+    template <typename CATEGORY>
+    typename std::enable_if<std::is_base_of<boost::numeric::odeint::stepper_tag, CATEGORY>::value, void>::type
+    doEventStep(const std::function<void(const MATRIX&, MATRIX&, SCALAR)>& rhs,
+        MATRIX& state,
+        SCALAR& time,
+        SCALAR& dt)
+    {
+        stepper_.do_step(rhs, state, time, dt);
+        time += dt;
+    }
+
+    //! a step of a controlled stepper, e.g. Bulirsch-Stoer
+    template <typename CATEGORY>
+    typename std::enable_if<std::is_base_of<boost::numeric::odeint::controlled_stepper_tag, CATEGORY>::value>::type
+    doEventStep(const std::function<void(const MATRIX&, MATRIX&, SCALAR)>& rhs,
+        MATRIX& state,
+        SCALAR& time,
+        SCALAR& dt)
+    {
+        tryStepUntilAccepted(stepper_, rhs, state, time, dt);
+    }
+
+    //! FSAL and controlled steppers cache the derivative at the current state and need to be reset after a state jump
+    template <typename CATEGORY>
+    typename std::enable_if<std::is_same<boost::numeric::odeint::explicit_error_stepper_fsal_tag, CATEGORY>::value ||
+                                std::is_base_of<boost::numeric::odeint::controlled_stepper_tag, CATEGORY>::value,
+        void>::type
+    resetStepper()
+    {
+        stepper_.reset();
+    }
+
+    template <typename CATEGORY>
+    typename std::enable_if<!(std::is_same<boost::numeric::odeint::explicit_error_stepper_fsal_tag, CATEGORY>::value ||
+                                std::is_base_of<boost::numeric::odeint::controlled_stepper_tag, CATEGORY>::value),
+        void>::type
+    resetStepper()
+    {
+    }
+
     STEPPER stepper_;
 };
 
@@ -151,6 +230,26 @@ public:
             stepperDense_, rhs, state, &timeTrajectory.front(), &timeTrajectory.back() + 1, dtInitial, observer);
     }
 
+    virtual void do_event_step(const std::function<void(const MATRIX&, MATRIX&, SCALAR)>& rhs,
+        MATRIX& state,
+        SCALAR& time,
+        SCALAR& dt) override
+    {
+        // the dense output stepper keeps its own state, which may step beyond the final time of the integration
+        stepperDense_.do_step(rhs);
+        state = stepperDense_.current_state();
+        time = stepperDense_.current_time();
+        dt = stepperDense_.current_time_step();
+    }
+
+    virtual void initialize(const MATRIX& state, const SCALAR& time, const SCALAR& dt) override
+    {
+        stepperDense_.initialize(state, time, dt);
+    }
+
+    virtual bool hasDenseOutput() const override { return true; }
+    virtual void calc_state(const SCALAR& time, MATRIX& state) override { stepperDense_.calc_state(time, state); }
+
 private:
     STEPPER stepper_;
     StepperDense stepperDense_;
@@ -205,7 +304,36 @@ public:
             stepperControlled_, rhs, state, &timeTrajectory.front(), &timeTrajectory.back() + 1, dtInitial, observer);
     }
 
+    virtual void do_event_step(const std::function<void(const MATRIX&, MATRIX&, SCALAR)>& rhs,
+        MATRIX& state,
+        SCALAR& time,
+        SCALAR& dt) override
+    {
+        tryStepUntilAccepted(stepperControlled_, rhs, state, time, dt);
+    }
+
+    virtual void initialize(const MATRIX& state, const SCALAR& time, const SCALAR& dt) override
+    {
+        resetStepper<typename StepperControlled::stepper_category>();
+    }
+
 private:
+    //! FSAL steppers cache the derivative at the current state and need to be reset after a state jump
+    template <typename CATEGORY>
+    typename std::enable_if<
+        std::is_same<boost::numeric::odeint::explicit_controlled_stepper_fsal_tag, CATEGORY>::value, void>::type
+    resetStepper()
+    {
+        stepperControlled_.reset();
+    }
+
+    template <typename CATEGORY>
+    typename std::enable_if<
+        !std::is_same<boost::numeric::odeint::explicit_controlled_stepper_fsal_tag, CATEGORY>::value, void>::type
+    resetStepper()
+    {
+    }
+
     STEPPER stepper_;
     StepperControlled stepperControlled_;
 };
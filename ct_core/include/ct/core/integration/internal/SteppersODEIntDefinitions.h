@@ -7,6 +7,8 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 
 #include <boost/numeric/odeint.hpp>
 
+#include "SymplecticCoefficients.h"
+
 namespace ct {
 namespace core {
 namespace internal {
@@ -94,6 +96,67 @@ using symplectic_euler_t = boost::numeric::odeint::symplectic_euler<Eigen::Matri
     SCALAR,
     boost::numeric::odeint::vector_space_algebra>;
 
+//! A symplectic splitting stepper with the stage coefficients COEFFICIENTS, see SymplecticCoefficients.h
+template <class COEFFICIENTS, size_t POS_DIM, size_t VEL_DIM, typename SCALAR = double>
+class symplectic_splitting_stepper
+    : public boost::numeric::odeint::symplectic_nystroem_stepper_base<COEFFICIENTS::NUM_STAGES,
+          COEFFICIENTS::ORDER,
+          Eigen::Matrix<SCALAR, POS_DIM, 1>,
+          Eigen::Matrix<SCALAR, VEL_DIM, 1>,
+          SCALAR,
+          Eigen::Matrix<SCALAR, POS_DIM, 1>,
+          Eigen::Matrix<SCALAR, VEL_DIM, 1>,
+          SCALAR,
+          boost::numeric::odeint::vector_space_algebra,
+          typename boost::numeric::odeint::operations_dispatcher<Eigen::Matrix<SCALAR, POS_DIM, 1>>::operations_type,
+          boost::numeric::odeint::initially_resizer>
+{
+public:
+    typedef boost::numeric::odeint::symplectic_nystroem_stepper_base<COEFFICIENTS::NUM_STAGES,
+        COEFFICIENTS::ORDER,
+        Eigen::Matrix<SCALAR, POS_DIM, 1>,
+        Eigen::Matrix<SCALAR, VEL_DIM, 1>,
+        SCALAR,
+        Eigen::Matrix<SCALAR, POS_DIM, 1>,
+        Eigen::Matrix<SCALAR, VEL_DIM, 1>,
+        SCALAR,
+        boost::numeric::odeint::vector_space_algebra,
+        typename boost::numeric::odeint::operations_dispatcher<Eigen::Matrix<SCALAR, POS_DIM, 1>>::operations_type,
+        boost::numeric::odeint::initially_resizer>
+        stepper_base_type;
+    typedef typename stepper_base_type::coef_type coef_type;
+
+    symplectic_splitting_stepper() : stepper_base_type(coefficients(true), coefficients(false)) {}
+private:
+    //! the position (a) or velocity (b) coefficients
+    static coef_type coefficients(bool positionCoefficients)
+    {
+        std::array<SCALAR, COEFFICIENTS::NUM_STAGES> a, b;
+        COEFFICIENTS::get(a, b);
+
+        coef_type coef;
+        for (size_t i = 0; i < COEFFICIENTS::NUM_STAGES; i++)
+            coef[i] = positionCoefficients ? a[i] : b[i];
+        return coef;
+    }
+};
+
+//! Stoermer-Verlet stepper, second order
+template <size_t POS_DIM, size_t VEL_DIM, typename SCALAR = double>
+using symplectic_verlet_t = symplectic_splitting_stepper<VerletCoefficients<SCALAR>, POS_DIM, VEL_DIM, SCALAR>;
+
+//! Forest-Ruth like stepper (PEFRL), fourth order
+template <size_t POS_DIM, size_t VEL_DIM, typename SCALAR = double>
+using symplectic_forest_ruth_t = symplectic_splitting_stepper<ForestRuthCoefficients<SCALAR>, POS_DIM, VEL_DIM, SCALAR>;
+
+//! Yoshida stepper, fourth order
+template <size_t POS_DIM, size_t VEL_DIM, typename SCALAR = double>
+using symplectic_yoshida4_t = symplectic_splitting_stepper<Yoshida4Coefficients<SCALAR>, POS_DIM, VEL_DIM, SCALAR>;
+
+//! Yoshida stepper, sixth order
+template <size_t POS_DIM, size_t VEL_DIM, typename SCALAR = double>
+using symplectic_yoshida6_t = symplectic_splitting_stepper<Yoshida6Coefficients<SCALAR>, POS_DIM, VEL_DIM, SCALAR>;
+
 /*****************************************************************************
  * Defining the (implicit) steppers
  *****************************************************************************/
@@ -0,0 +1,114 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+
+namespace ct {
+namespace core {
+namespace internal {
+
+/*!
+ * Coefficients of symplectic splitting methods for systems of the form \f$ \dot{p} = f(x, v), \dot{v} = g(x, p) \f$.
+ * Every stage i first updates the positions and then the velocities,
+ *
+ * \f[
+ * p \leftarrow p + a_i \, dt \, f(x, v), \quad v \leftarrow v + b_i \, dt \, g(x, p) \quad i = 1, \dots, NUM\_STAGES
+ * \f]
+ *
+ * which is the convention of boost::odeint's symplectic_nystroem_stepper_base. The same coefficients are used for
+ * forward integration (IntegratorSymplectic) and for the discrete-time sensitivities (SensitivityApproximation).
+ */
+
+//! Stoermer-Verlet (leapfrog), second order. Half position step, full velocity step, half position step.
+template <typename SCALAR>
+struct VerletCoefficients
+{
+    static const size_t NUM_STAGES = 2;
+    static const unsigned short ORDER = 2;
+
+    static void get(std::array<SCALAR, NUM_STAGES>& a, std::array<SCALAR, NUM_STAGES>& b)
+    {
+        a = {{SCALAR(0.5), SCALAR(0.5)}};
+        b = {{SCALAR(1.0), SCALAR(0.0)}};
+    }
+};
+
+
+//! Yoshida's fourth order triple jump, i.e. three Stoermer-Verlet steps of length w1*dt, w0*dt and w1*dt.
+/*!
+ * The method is identical to the original fourth order scheme of Forest and Ruth.
+ */
+template <typename SCALAR>
+struct Yoshida4Coefficients
+{
+    static const size_t NUM_STAGES = 4;
+    static const unsigned short ORDER = 4;
+
+    static void get(std::array<SCALAR, NUM_STAGES>& a, std::array<SCALAR, NUM_STAGES>& b)
+    {
+        const double w1 = 1.0 / (2.0 - std::cbrt(2.0));
+        const double w0 = 1.0 - 2.0 * w1;
+        a = {{SCALAR(0.5 * w1), SCALAR(0.5 * (w0 + w1)), SCALAR(0.5 * (w0 + w1)), SCALAR(0.5 * w1)}};
+        b = {{SCALAR(w1), SCALAR(w0), SCALAR(w1), SCALAR(0.0)}};
+    }
+};
+
+
+//! Yoshida's sixth order method (solution A), composed of seven Stoermer-Verlet steps.
+template <typename SCALAR>
+struct Yoshida6Coefficients
+{
+    static const size_t NUM_STAGES = 8;
+    static const unsigned short ORDER = 6;
+
+    static void get(std::array<SCALAR, NUM_STAGES>& a, std::array<SCALAR, NUM_STAGES>& b)
+    {
+        const double w1 = -1.17767998417887;
+        const double w2 = 0.235573213359357;
+        const double w3 = 0.784513610477560;
+        const double w0 = 1.0 - 2.0 * (w1 + w2 + w3);
+
+        // the weights of the Stoermer-Verlet steps are w3, w2, w1, w0, w1, w2, w3
+        const double w[7] = {w3, w2, w1, w0, w1, w2, w3};
+        a[0] = SCALAR(0.5 * w[0]);
+        for (size_t i = 1; i < 7; i++)
+            a[i] = SCALAR(0.5 * (w[i - 1] + w[i]));
+        a[7] = SCALAR(0.5 * w[6]);
+
+        for (size_t i = 0; i < 7; i++)
+            b[i] = SCALAR(w[i]);
+        b[7] = SCALAR(0.0);
+    }
+};
+
+
+//! Position extended Forest-Ruth like method (PEFRL) of Omelyan, Mryglod and Folk, fourth order.
+/*!
+ * The original Forest-Ruth coefficients coincide with Yoshida's fourth order method (Yoshida4Coefficients). This
+ * optimized variant uses one more stage but reduces the error constant by more than an order of magnitude.
+ */
+template <typename SCALAR>
+struct ForestRuthCoefficients
+{
+    static const size_t NUM_STAGES = 5;
+    static const unsigned short ORDER = 4;
+
+    static void get(std::array<SCALAR, NUM_STAGES>& a, std::array<SCALAR, NUM_STAGES>& b)
+    {
+        const double xi = 0.1786178958448091;
+        const double lambda = -0.2123418310626054;
+        const double chi = -0.06626458266981849;
+        a = {{SCALAR(xi), SCALAR(chi), SCALAR(1.0 - 2.0 * (chi + xi)), SCALAR(chi), SCALAR(xi)}};
+        b = {{SCALAR(0.5 * (1.0 - 2.0 * lambda)), SCALAR(lambda), SCALAR(lambda), SCALAR(0.5 * (1.0 - 2.0 * lambda)),
+            SCALAR(0.0)}};
+    }
+};
+
+}  // namespace internal
+}  // namespace core
+}  // namespace ct
@@ -18,7 +18,11 @@ struct SensitivityApproximationSettings
         BACKWARD_EULER,
         SYMPLECTIC_EULER,
         TUSTIN,
-        MATRIX_EXPONENTIAL
+        MATRIX_EXPONENTIAL,
+        SYMPLECTIC_VERLET,
+        SYMPLECTIC_FOREST_RUTH,
+        SYMPLECTIC_YOSHIDA4,
+        SYMPLECTIC_YOSHIDA6
     };
 
     SensitivityApproximationSettings(double dt, APPROXIMATION approx) : dt_(dt), approximation_(approx) {}
@@ -48,6 +52,9 @@ public:
 
     virtual void setLinearSystem(const std::shared_ptr<LinearSystem<STATE_DIM, CONTROL_DIM, SCALAR>>& linearSystem) = 0;
 
+    //! set the nonlinear system underlying the linear system, only used by approximations which require it
+    virtual void setControlledSystem(const std::shared_ptr<ControlledSystem<STATE_DIM, CONTROL_DIM, SCALAR>>& system) {}
+
     //! update the time discretization
     virtual void setTimeDiscretization(const SCALAR& dt) = 0;
 
@@ -5,7 +5,9 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 
 #pragma once
 
-#include <unsupported/Eigen/MatrixFunctions>
+#include <ct/core/systems/continuous_time/SymplecticSystem.h>
+#include "../../math/MatrixExponential.h"
+#include "../internal/SymplecticCoefficients.h"
 
 #define SYMPLECTIC_ENABLED        \
     template <size_t V, size_t P> \
@@ -43,7 +45,7 @@ public:
         const std::shared_ptr<LinearSystem<STATE_DIM, CONTROL_DIM, SCALAR>>& linearSystem = nullptr,
         const SensitivityApproximationSettings::APPROXIMATION& approx =
             SensitivityApproximationSettings::APPROXIMATION::FORWARD_EULER)
-        : linearSystem_(linearSystem), settings_(dt, approx)
+        : linearSystem_(linearSystem), settings_(dt, approx), zohCacheValid_(false), zohDt_(0.0)
     {
     }
 
@@ -51,16 +53,25 @@ public:
     //! constructor
     SensitivityApproximation(const SensitivityApproximationSettings& settings,
         const std::shared_ptr<LinearSystem<STATE_DIM, CONTROL_DIM, SCALAR>>& linearSystem = nullptr)
-        : linearSystem_(linearSystem), settings_(settings)
+        : linearSystem_(linearSystem), settings_(settings), zohCacheValid_(false), zohDt_(0.0)
     {
     }
 
 
     //! copy constructor
-    SensitivityApproximation(const SensitivityApproximation& other) : settings_(other.settings_)
+    SensitivityApproximation(const SensitivityApproximation& other)
+        : settings_(other.settings_),
+          zohCacheValid_(other.zohCacheValid_),
+          zohDt_(other.zohDt_),
+          zohAc_(other.zohAc_),
+          zohBc_(other.zohBc_),
+          zohA_(other.zohA_),
+          zohB_(other.zohB_)
     {
         if (other.linearSystem_ != nullptr)
             linearSystem_ = std::shared_ptr<LinearSystem<STATE_DIM, CONTROL_DIM, SCALAR>>(other.linearSystem_->clone());
+        if (other.system_ != nullptr)
+            system_ = std::shared_ptr<ControlledSystem<STATE_DIM, CONTROL_DIM, SCALAR>>(other.system_->clone());
     }
 
 
@@ -92,6 +103,20 @@ public:
     }
 
 
+    //! set the nonlinear system which is used to propagate the stage states of the symplectic splitting methods
+    /*!
+     * @param system the (symplectic) system which is linearized by the linear system
+     */
+    virtual void setControlledSystem(
+        const std::shared_ptr<ControlledSystem<STATE_DIM, CONTROL_DIM, SCALAR>>& system) override
+    {
+        if (system != nullptr && !system->isSymplectic())
+            throw std::runtime_error("Error in SensitivityApproximation: system is not symplectic.");
+
+        system_ = system;
+    }
+
+
     //! update the time discretization
     virtual void setTimeDiscretization(const SCALAR& dt) override { settings_.dt_ = dt; }
     //! update the settings
@@ -169,6 +194,26 @@ public:
                 matrixExponential(x, u, n, A, B);
                 break;
             }
+            case SensitivityApproximationSettings::APPROXIMATION::SYMPLECTIC_VERLET:
+            {
+                symplecticSplitting<internal::VerletCoefficients<SCALAR>, V_DIM, P_DIM>(x, u, x_next, n, A, B);
+                break;
+            }
+            case SensitivityApproximationSettings::APPROXIMATION::SYMPLECTIC_FOREST_RUTH:
+            {
+                symplecticSplitting<internal::ForestRuthCoefficients<SCALAR>, V_DIM, P_DIM>(x, u, x_next, n, A, B);
+                break;
+            }
+            case SensitivityApproximationSettings::APPROXIMATION::SYMPLECTIC_YOSHIDA4:
+            {
+                symplecticSplitting<internal::Yoshida4Coefficients<SCALAR>, V_DIM, P_DIM>(x, u, x_next, n, A, B);
+                break;
+            }
+            case SensitivityApproximationSettings::APPROXIMATION::SYMPLECTIC_YOSHIDA6:
+            {
+                symplecticSplitting<internal::Yoshida6Coefficients<SCALAR>, V_DIM, P_DIM>(x, u, x_next, n, A, B);
+                break;
+            }
             default:
                 throw std::runtime_error("Unknown Approximation type in SensitivityApproximation.");
         }  // end switch
@@ -223,15 +268,26 @@ private:
         state_matrix_t& A_discr,
         state_control_matrix_t& B_discr)
     {
+        /*!
+         * the matrix exponential approximation is the exact zero-order-hold discretization of the linearization at the
+         * *start* of the ZOH interval. The result is reused as long as the linearization does not change, hence it is
+         * computed only once for LTI systems.
+         */
         state_matrix_t Ac;
         state_control_matrix_t Bc;
         linearSystem_->getDerivatives(Ac, Bc, x_n, u_n, n * settings_.dt_);
 
-        state_matrix_t Adt = settings_.dt_ * Ac;
-
-        A_discr.template topLeftCorner<STATE_DIM, STATE_DIM>() = Adt.exp();
-        B_discr.template topLeftCorner<STATE_DIM, CONTROL_DIM>() =
-            Ac.inverse() * (A_discr - state_matrix_t::Identity()) * Bc;
+        if (!zohCacheValid_ || zohDt_ != settings_.dt_ || zohAc_ != Ac || zohBc_ != Bc)
+        {
+            zeroOrderHoldDiscretization<STATE_DIM, CONTROL_DIM, SCALAR>(Ac, Bc, settings_.dt_, zohA_, zohB_);
+            zohDt_ = settings_.dt_;
+            zohAc_ = Ac;
+            zohBc_ = Bc;
+            zohCacheValid_ = true;
+        }
+
+        A_discr = zohA_;
+        B_discr = zohB_;
     }
 
 
@@ -345,6 +401,103 @@ private:
     }
 
 
+    //! get the discretized linear system Ax+Bu of a symplectic splitting method (Verlet, Forest-Ruth, Yoshida)
+    /*!
+     * The discrete-time sensitivity is the product of the linearized position and velocity updates of all stages,
+     * such that it is consistent with the forward integration in IntegratorSymplectic. If the nonlinear system is set
+     * through setControlledSystem(), the stage states are propagated with the same position and velocity updates as in
+     * the forward integration, hence the sensitivity is exact. Otherwise, the stage states are approximated by
+     * interpolating between x and x_next with the accumulated stage coefficients, which is only exact for linear
+     * systems.
+     *
+     * @param x	state at start of interval
+     * @param u control at start of interval
+     * @param x_next state at end of interval
+     * @param n time index
+     * @param A_sym resulting symplectic discrete-time A matrix
+     * @param B_sym resulting symplectic discrete-time B matrix
+     */
+    template <class COEFFICIENTS, size_t V, size_t P>
+    typename std::enable_if<(V > 0 && P > 0), void>::type symplecticSplitting(const StateVector<STATE_DIM, SCALAR>& x,
+        const ControlVector<CONTROL_DIM, SCALAR>& u,
+        const StateVector<STATE_DIM, SCALAR>& x_next,
+        const int& n,
+        state_matrix_t& A_sym,
+        state_control_matrix_t& B_sym)
+    {
+        const SCALAR& dt = settings_.dt_;
+
+        std::array<SCALAR, COEFFICIENTS::NUM_STAGES> a, b;
+        COEFFICIENTS::get(a, b);
+
+        std::shared_ptr<SymplecticSystem<P_DIM, V_DIM, CONTROL_DIM, SCALAR>> system =
+            std::static_pointer_cast<SymplecticSystem<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>(system_);
+        StateVector<P_DIM, SCALAR> pDot;
+        StateVector<V_DIM, SCALAR> vDot;
+
+        const StateVector<STATE_DIM, SCALAR> dx = x_next - x;
+        StateVector<STATE_DIM, SCALAR> x_interm = x;
+        SCALAR cp(0.0);  // accumulated position coefficients
+        SCALAR cv(0.0);  // accumulated velocity coefficients
+
+        state_matrix_t Ac;
+        state_control_matrix_t Bc;
+
+        A_sym.setIdentity();
+        B_sym.setZero();
+
+        for (size_t i = 0; i < COEFFICIENTS::NUM_STAGES; i++)
+        {
+            // position update, linearized at the current intermediate state
+            linearSystem_->getDerivatives(Ac, Bc, x_interm, u, n * dt);
+            B_sym.template topRows<P_DIM>() +=
+                a[i] * dt * (Ac.template topRows<P_DIM>() * B_sym + Bc.template topRows<P_DIM>());
+            A_sym.template topRows<P_DIM>() += a[i] * dt * Ac.template topRows<P_DIM>() * A_sym;
+
+            cp += a[i];
+            if (system)
+            {
+                system->computePdot(x_interm, x_interm.template tail<V_DIM>(), u, pDot);
+                x_interm.template head<P_DIM>() += a[i] * dt * pDot;
+            }
+            else
+                x_interm.template head<P_DIM>() = x.template head<P_DIM>() + cp * dx.template head<P_DIM>();
+
+            if (b[i] == SCALAR(0.0))
+                continue;
+
+            // velocity update, linearized at the updated intermediate state
+            linearSystem_->getDerivatives(Ac, Bc, x_interm, u, n * dt);
+            B_sym.template bottomRows<V_DIM>() +=
+                b[i] * dt * (Ac.template bottomRows<V_DIM>() * B_sym + Bc.template bottomRows<V_DIM>());
+            A_sym.template bottomRows<V_DIM>() += b[i] * dt * Ac.template bottomRows<V_DIM>() * A_sym;
+
+            cv += b[i];
+            if (system)
+            {
+                system->computeVdot(x_interm, x_interm.template head<P_DIM>(), u, vDot);
+                x_interm.template tail<V_DIM>() += b[i] * dt * vDot;
+            }
+            else
+                x_interm.template tail<V_DIM>() = x.template tail<V_DIM>() + cv * dx.template tail<V_DIM>();
+        }
+    }
+
+
+    //! gets instantiated in case the system is not symplectic
+    template <class COEFFICIENTS, size_t V, size_t P>
+    typename std::enable_if<(V <= 0 || P <= 0), void>::type symplecticSplitting(const StateVector<STATE_DIM, SCALAR>& x,
+        const ControlVector<CONTROL_DIM, SCALAR>& u,
+        const StateVector<STATE_DIM, SCALAR>& x_next,
+        const int& n,
+        state_matrix_t& A_sym,
+        state_control_matrix_t& B_sym)
+    {
+        throw std::runtime_error(
+            "SensitivityApproximation : selected symplecticSplitting but System is not symplectic.");
+    }
+
+
     //! gets instantiated in case the system is not symplectic
     SYMPLECTIC_DISABLED symplecticEuler(const StateVector<STATE_DIM, SCALAR>& x_n,
         const ControlVector<CONTROL_DIM, SCALAR>& u_n,
@@ -379,8 +532,19 @@ private:
     //! shared_ptr to a continuous time linear system (system to be discretized)
     std::shared_ptr<LinearSystem<STATE_DIM, CONTROL_DIM, SCALAR>> linearSystem_;
 
+    //! shared_ptr to the continuous time nonlinear system, optional for the symplectic splitting methods
+    std::shared_ptr<ControlledSystem<STATE_DIM, CONTROL_DIM, SCALAR>> system_;
+
     //! discretization settings
     SensitivityApproximationSettings settings_;
+
+    // cache of the matrix exponential approximation
+    bool zohCacheValid_;            //!< true if the cached discretization is valid
+    SCALAR zohDt_;                  //!< time step of the cached discretization
+    state_matrix_t zohAc_;          //!< continuous-time A matrix of the cached discretization
+    state_control_matrix_t zohBc_;  //!< continuous-time B matrix of the cached discretization
+    state_matrix_t zohA_;           //!< cached discrete-time A matrix
+    state_control_matrix_t zohB_;   //!< cached discrete-time B matrix
 };
 
 
@@ -5,6 +5,10 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 
 #pragma once
 
+#include <thread>
+#include <vector>
+
+#include "JacobianColoring.h"
 
 namespace ct {
 namespace core {
@@ -18,6 +22,10 @@ namespace core {
  * scalar functions (IN_DIM = 1, OUT_DIM = 1), fixed or variable size
  * (IN_DIM = -1, OUT_DIM = -1) functions.
  *
+ * If a sparsity pattern of the Jacobian is set or detected, structurally orthogonal columns are perturbed at once
+ * (see JacobianColoring), such that the number of function evaluations reduces to the number of colors of the
+ * pattern. The perturbations can optionally be evaluated on multiple threads, which requires a thread-safe function.
+ *
  * \note In fact, this class is called Derivatives but computes also zero order derivatives
  *
  * @tparam IN_DIM Input dimensionality of the function (use Eigen::Dynamic (-1) for dynamic size)
@@ -47,13 +55,17 @@ public:
 	 * @param doubleSidedDerivative use double sided differentiation
 	 */
     DerivativesNumDiff(Function& f, bool doubleSidedDerivative = false)
-        : f_(f), doubleSidedDerivative_(doubleSidedDerivative)
+        : f_(f), doubleSidedDerivative_(doubleSidedDerivative), nThreads_(1)
     {
         eps_ = sqrt(Eigen::NumTraits<double>::epsilon());
     }
 
     DerivativesNumDiff(const DerivativesNumDiff& arg)
-        : f_(arg.f_), doubleSidedDerivative_(arg.doubleSidedDerivative_), eps_(arg.eps_)
+        : f_(arg.f_),
+          doubleSidedDerivative_(arg.doubleSidedDerivative_),
+          eps_(arg.eps_),
+          nThreads_(arg.nThreads_),
+          coloring_(arg.coloring_)
     {
     }
 
@@ -75,46 +87,138 @@ public:
         if (!doubleSidedDerivative_)
         {
             y_ref = f_(x);
+            jac.resize(y_ref.rows(), x.rows());
         }
-
-        for (size_t i = 0; i < x.rows(); ++i)
+        else
         {
-            // inspired from http://en.wikipedia.org/wiki/Numerical_differentiation#Practical_considerations_using_floating_point_arithmetic
-            double h = eps_ * std::max(std::abs(x(i)), 1.0);
-            volatile double x_ph = x(i) + h;
-            double dxp = x_ph - x(i);
+            jac.resize(OUT_DIM == Eigen::Dynamic ? f_(x).rows() : OUT_DIM, x.rows());
+        }
 
-            IN_TYPE x_perturbed = x;
-            x_perturbed(i) = x_ph;
+        const size_t nGroups = coloring_.initialized() ? coloring_.numColors() : size_t(x.rows());
 
-            // get evaluation of f(x,u)
-            OUT_TYPE y_perturbed = f_(x_perturbed);
+        auto evaluateGroups = [&](size_t begin, size_t stride) {
+            IN_TYPE x_perturbed;
+            Eigen::VectorXd dx(x.rows());  // sum of the forward and backward step per coordinate
+            std::vector<size_t> single(1);
 
-            if (doubleSidedDerivative_)
+            for (size_t g = begin; g < nGroups; g += stride)
             {
-                volatile double x_mh = x(i) - h;
-                double dxm = x(i) - x_mh;
+                single[0] = g;
+                const std::vector<size_t>& columns = coloring_.initialized() ? coloring_.columns(g) : single;
 
+                // inspired from http://en.wikipedia.org/wiki/Numerical_differentiation#Practical_considerations_using_floating_point_arithmetic
                 x_perturbed = x;
-                x_perturbed(i) = x_mh;
-                OUT_TYPE y_perturbed_low = f_(x_perturbed);
-
-                jac.template col(i) = (y_perturbed - y_perturbed_low) / (dxp + dxm);
-            }
-            else
-            {
-                jac.template col(i) = (y_perturbed - y_ref) / dxp;
+                for (size_t i : columns)
+                {
+                    double h = eps_ * std::max(std::abs(x(i)), 1.0);
+                    volatile double x_ph = x(i) + h;
+                    dx(i) = x_ph - x(i);
+                    x_perturbed(i) = x_ph;
+                }
+
+                // get evaluation of f(x,u)
+                OUT_TYPE y_perturbed = f_(x_perturbed);
+                OUT_TYPE y_perturbed_low;
+
+                if (doubleSidedDerivative_)
+                {
+                    x_perturbed = x;
+                    for (size_t i : columns)
+                    {
+                        double h = eps_ * std::max(std::abs(x(i)), 1.0);
+                        volatile double x_mh = x(i) - h;
+                        dx(i) += x(i) - x_mh;
+                        x_perturbed(i) = x_mh;
+                    }
+                    y_perturbed_low = f_(x_perturbed);
+                }
+                else
+                {
+                    y_perturbed_low = y_ref;
+                }
+
+                // every non-zero of the difference belongs to exactly one column of the group
+                for (size_t i : columns)
+                {
+                    if (coloring_.initialized())
+                    {
+                        for (size_t row = 0; row < size_t(jac.rows()); row++)
+                            jac(row, i) =
+                                coloring_.nonZero(row, i) ? (y_perturbed(row) - y_perturbed_low(row)) / dx(i) : 0.0;
+                    }
+                    else
+                    {
+                        jac.col(i) = (y_perturbed - y_perturbed_low) / dx(i);
+                    }
+                }
             }
+        };
+
+        const size_t nThreads = std::min(nThreads_, nGroups);
+        if (nThreads > 1)
+        {
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < nThreads; i++)
+                threads.emplace_back(evaluateGroups, i, nThreads);
+            evaluateGroups(0, nThreads);
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+        else
+        {
+            evaluateGroups(0, 1);
         }
 
         return jac;
     }
 
+    //! set the sparsity pattern of the Jacobian, a "true" entry marks a (possibly) non-zero entry
+    void setSparsityPattern(const Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>& pattern)
+    {
+        coloring_.init(pattern);
+    }
+
+    //! detect the sparsity pattern of the Jacobian by probing
+    /*!
+	 * Computes the dense Jacobian at x and at random points around it. Every entry which is non-zero at any of these
+	 * points is part of the pattern. Entries which vanish at all probed points are assumed to be structurally zero.
+	 *
+	 * @param x point to probe at
+	 * @param nProbes number of additional random points
+	 * @param radius relative size of the random deviation of the additional points
+	 */
+    void detectSparsityPattern(const Eigen::VectorXd& x, size_t nProbes = 2, double radius = 0.1)
+    {
+        coloring_.clear();
+
+        Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> pattern;
+        for (size_t i = 0; i <= nProbes; i++)
+        {
+            Eigen::VectorXd x_probe = x;
+            if (i > 0)
+                x_probe += radius * x.cwiseAbs().cwiseMax(1.0).cwiseProduct(Eigen::VectorXd::Random(x.rows()));
+
+            JAC_TYPE jac = jacobian(x_probe);
+            if (i == 0)
+                pattern.setConstant(jac.rows(), jac.cols(), false);
+            pattern = pattern.array() || (jac.array() != 0.0);
+        }
+
+        setSparsityPattern(pattern);
+    }
+
+    //! remove the sparsity pattern, every column is computed separately again
+    void clearSparsityPattern() { coloring_.clear(); }
+    const JacobianColoring& getColoring() const { return coloring_; }
+    //! number of threads to evaluate the perturbations on, the function needs to be thread-safe if > 1
+    void setNumThreads(size_t nThreads) { nThreads_ = std::max<size_t>(nThreads, 1); }
 private:
     std::function<OUT_TYPE(const IN_TYPE&)> f_;  //!< the function
 
     bool doubleSidedDerivative_;  //!< if true, will use double sided differentiation
     double eps_;                  //!< the perturbation to apply for numerical differentiation
+    size_t nThreads_;             //!< number of threads to evaluate the perturbations on
+    JacobianColoring coloring_;   //!< coloring of the Jacobian
 };
 }
 }
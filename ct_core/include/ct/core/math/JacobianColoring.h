@@ -0,0 +1,115 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace ct {
+namespace core {
+
+//! Column coloring of a Jacobian sparsity pattern for compressed finite differences
+/*!
+ * Two columns of a Jacobian are structurally orthogonal if they do not have a non-zero entry in the same row. Such
+ * columns can be estimated by finite differences with a single perturbation of all their coordinates at once, since
+ * every non-zero entry of the difference quotient can be attributed to exactly one of the columns (Curtis, Powell and
+ * Reid, 1974). This class partitions the columns into groups ("colors") of structurally orthogonal columns with a
+ * greedy largest-first heuristic. The number of function evaluations per Jacobian reduces from the number of columns
+ * to the number of colors, which is bounded from below by the maximum number of non-zeros in a row.
+ *
+ * The coloring is used by DerivativesNumDiff and DynamicsLinearizerNumDiff.
+ */
+class JacobianColoring
+{
+public:
+    typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> Pattern;
+
+    //! default constructor, no coloring
+    JacobianColoring() = default;
+
+    //! constructor
+    /*!
+	 * @param pattern sparsity pattern, a "true" entry marks a (possibly) non-zero entry of the Jacobian
+	 */
+    template <int ROWS, int COLS>
+    JacobianColoring(const Eigen::Matrix<bool, ROWS, COLS>& pattern)
+    {
+        init(pattern);
+    }
+
+    //! computes the coloring of a sparsity pattern
+    /*!
+	 * @param pattern sparsity pattern, a "true" entry marks a (possibly) non-zero entry of the Jacobian
+	 */
+    template <int ROWS, int COLS>
+    void init(const Eigen::Matrix<bool, ROWS, COLS>& pattern)
+    {
+        pattern_ = pattern;
+
+        const size_t rows = pattern_.rows();
+        const size_t cols = pattern_.cols();
+
+        // largest-first ordering, the densest columns are the hardest to color
+        std::vector<size_t> order(cols);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return pattern_.col(a).count() > pattern_.col(b).count();
+        });
+
+        // occupied(i, c) is true if a column of color c has a non-zero in row i
+        Pattern occupied = Pattern::Constant(rows, cols, false);
+        colors_.assign(cols, 0);
+        groups_.clear();
+
+        for (size_t j : order)
+        {
+            size_t c = 0;
+            while (c < groups_.size() && (occupied.col(c).array() && pattern_.col(j).array()).any())
+                c++;
+
+            if (c == groups_.size())
+                groups_.push_back(std::vector<size_t>());
+
+            groups_[c].push_back(j);
+            colors_[j] = c;
+            occupied.col(c) = occupied.col(c).array() || pattern_.col(j).array();
+        }
+
+        for (std::vector<size_t>& group : groups_)
+            std::sort(group.begin(), group.end());
+    }
+
+    //! removes the coloring, such that every column is evaluated separately
+    void clear()
+    {
+        pattern_.resize(0, 0);
+        colors_.clear();
+        groups_.clear();
+    }
+
+    //! true if a sparsity pattern has been set
+    bool initialized() const { return pattern_.size() > 0; }
+    //! number of colors, i.e. function evaluations per one-sided Jacobian
+    size_t numColors() const { return groups_.size(); }
+    //! color of a column
+    size_t color(size_t col) const { return colors_[col]; }
+    //! columns that share a color
+    const std::vector<size_t>& columns(size_t color) const { return groups_[color]; }
+    //! the sparsity pattern
+    const Pattern& pattern() const { return pattern_; }
+    //! true if the entry can be non-zero
+    bool nonZero(size_t row, size_t col) const { return pattern_(row, col); }
+private:
+    Pattern pattern_;                          //!< sparsity pattern
+    std::vector<size_t> colors_;               //!< color of every column
+    std::vector<std::vector<size_t>> groups_;  //!< columns of every color
+};
+
+}  // namespace core
+}  // namespace ct
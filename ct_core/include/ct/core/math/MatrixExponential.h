@@ -0,0 +1,101 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+namespace ct {
+namespace core {
+
+//! Matrix exponential by scaling and squaring
+/*!
+ * The matrix is scaled by \f$ 2^{-s} \f$ such that its 1-norm does not exceed 1/2, the exponential of the scaled
+ * matrix is approximated by the diagonal Pade approximant of degree 6 and the result is squared s times (Moler and
+ * Van Loan, 1978). The relative error of the approximant is below \f$ 4 \cdot 10^{-16} \f$. Unlike the generic
+ * implementation of Eigen's MatrixFunctions module, all temporaries have the size of the matrix, hence no memory is
+ * allocated for fixed-size matrices.
+ *
+ * @param M the matrix
+ * @return the exponential of the matrix
+ */
+template <typename SCALAR, int N>
+Eigen::Matrix<SCALAR, N, N> matrixExponential(const Eigen::Matrix<SCALAR, N, N>& M)
+{
+    typedef Eigen::Matrix<SCALAR, N, N> matrix_t;
+
+    const int q = 6;
+
+    // scaling
+    const SCALAR norm = M.cwiseAbs().colwise().sum().maxCoeff();
+    SCALAR scale = SCALAR(1.0);
+    int s = 0;
+    while (norm * scale > SCALAR(0.5))
+    {
+        scale *= SCALAR(0.5);
+        s++;
+    }
+    const matrix_t X = scale * M;
+
+    // Pade approximant N(X) / N(-X)
+    matrix_t Xk = matrix_t::Identity(M.rows(), M.cols());
+    matrix_t numerator = Xk;
+    matrix_t denominator = Xk;
+    SCALAR c = SCALAR(1.0);
+    for (int k = 1; k <= q; k++)
+    {
+        c *= SCALAR(q - k + 1) / SCALAR(k * (2 * q - k + 1));
+        Xk = Xk * X;
+        numerator += c * Xk;
+        denominator += (k % 2 == 0 ? c : -c) * Xk;
+    }
+    matrix_t E = denominator.partialPivLu().solve(numerator);
+
+    // squaring
+    for (int i = 0; i < s; i++)
+        E = E * E;
+
+    return E;
+}
+
+//! Exact zero-order-hold discretization of a continuous-time linear system
+/*!
+ * Computes the discrete-time system \f$ x_{n+1} = A_d x_n + B_d u_n \f$ of \f$ \dot{x} = A x + B u \f$ for a
+ * piecewise constant input from the exponential of the augmented matrix
+ *
+ * \f[
+ *   \exp \left( \begin{bmatrix} A & B \\ 0 & 0 \end{bmatrix} dt \right) =
+ *   \begin{bmatrix} A_d & B_d \\ 0 & I \end{bmatrix}
+ * \f]
+ *
+ * which, unlike \f$ B_d = A^{-1} (A_d - I) B \f$, is well defined for singular A, e.g. for systems with integrators.
+ *
+ * @param A continuous-time state matrix
+ * @param B continuous-time input matrix
+ * @param dt time step
+ * @param A_discr discrete-time state matrix
+ * @param B_discr discrete-time input matrix
+ */
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR>
+void zeroOrderHoldDiscretization(const Eigen::Matrix<SCALAR, STATE_DIM, STATE_DIM>& A,
+    const Eigen::Matrix<SCALAR, STATE_DIM, CONTROL_DIM>& B,
+    const SCALAR& dt,
+    Eigen::Matrix<SCALAR, STATE_DIM, STATE_DIM>& A_discr,
+    Eigen::Matrix<SCALAR, STATE_DIM, CONTROL_DIM>& B_discr)
+{
+    typedef Eigen::Matrix<SCALAR, STATE_DIM + CONTROL_DIM, STATE_DIM + CONTROL_DIM> augmented_matrix_t;
+
+    augmented_matrix_t M = augmented_matrix_t::Zero();
+    M.template topLeftCorner<STATE_DIM, STATE_DIM>() = dt * A;
+    M.template topRightCorner<STATE_DIM, CONTROL_DIM>() = dt * B;
+
+    const augmented_matrix_t E = matrixExponential(M);
+    A_discr = E.template topLeftCorner<STATE_DIM, STATE_DIM>();
+    B_discr = E.template topRightCorner<STATE_DIM, CONTROL_DIM>();
+}
+
+}  // namespace core
+}  // namespace ct
@@ -0,0 +1,272 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <ct/core/types/arrays/TimeArray.h>
+#include <ct/core/types/StateVector.h>
+#include <ct/core/integration/Integrator.h>
+#include <ct/core/control/continuous_time/Controller.h>
+
+namespace ct {
+namespace core {
+
+//! Trajectories and statistics of an ensemble of rollouts
+template <size_t STATE_DIM, typename SCALAR = double>
+struct EnsembleResult
+{
+    typedef Eigen::Matrix<SCALAR, STATE_DIM, Eigen::Dynamic> StateMatrix;
+
+    tpl::TimeArray<SCALAR> times;           //!< time of every recorded step
+    StateMatrix finalStates;                //!< final state of every rollout, one column per rollout
+    StateMatrix mean;                       //!< mean over the finite rollouts, one column per step
+    StateMatrix standardDeviation;          //!< standard deviation over the finite rollouts, one column per step
+    std::vector<StateMatrix> trajectories;  //!< state trajectories per rollout, if recorded
+    std::vector<bool> diverged;             //!< true if the state of a rollout became non-finite
+};
+
+//! Simulates many rollouts of a controlled system in parallel, e.g. for Monte-Carlo validation of controllers
+/*!
+ * Unlike ControlSimulator, which runs a system and a controller thread paced in real-time, this simulator runs an
+ * ensemble of rollouts as fast as possible. Every worker thread owns a clone of the controlled system and its
+ * integrator. The system is integrated in lockstep with the control step: after every control step, the disturbance
+ * callback may perturb the state and the state is recorded.
+ *
+ * Every rollout draws its random numbers from its own engine, seeded from the ensemble seed and the rollout index
+ * (see rolloutEngine()). Before each rollout, the controller is cloned from the prototype system, such that a
+ * rollout does not depend on the previous rollouts of its worker. Hence, the trajectory of a rollout is reproducible
+ * independent of the number of threads. The statistics are accumulated per worker and merged in worker order; they
+ * are reproducible for a fixed number of threads.
+ *
+ * All result storage is allocated before the rollouts start, no memory is allocated per step by the simulator.
+ *
+ * The callbacks are called concurrently from all workers. They must only modify the objects passed to them and
+ * should draw random numbers from the given engine only, e.g. with a standard distribution or with a GaussianNoise or
+ * UniformNoise object reseeded from it.
+ *
+ * @tparam CONTROLLED_SYSTEM the controlled system to simulate
+ */
+template <class CONTROLLED_SYSTEM>
+class EnsembleSimulator
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    static const size_t STATE_DIM = CONTROLLED_SYSTEM::STATE_DIM;
+    static const size_t CONTROL_DIM = CONTROLLED_SYSTEM::CONTROL_DIM;
+
+    using SCALAR = typename CONTROLLED_SYSTEM::S;
+    using Result = EnsembleResult<STATE_DIM, SCALAR>;
+    using Engine = std::mt19937_64;
+
+    //! prepares a rollout, e.g. samples the initial state or perturbs the parameters of the system
+    using InitializeFunction =
+        std::function<void(size_t rollout, Engine& engine, StateVector<STATE_DIM, SCALAR>& x0, CONTROLLED_SYSTEM& sys)>;
+    //! called after every control step, e.g. to apply a disturbance to the state
+    using DisturbanceFunction = std::function<
+        void(size_t rollout, size_t step, const SCALAR& t, Engine& engine, StateVector<STATE_DIM, SCALAR>& x)>;
+
+    struct Settings
+    {
+        Settings()
+            : nThreads(0),
+              simDt(0.001),
+              controlDt(0.01),
+              duration(1.0),
+              integrationType(IntegrationType::RK4),
+              seed(0),
+              recordTrajectories(false)
+        {
+        }
+
+        size_t nThreads;                  //!< number of worker threads, 0 uses the number of hardware threads
+        SCALAR simDt;                     //!< integration step
+        SCALAR controlDt;                 //!< control step, the state is recorded and disturbed at this rate
+        SCALAR duration;                  //!< duration of every rollout
+        IntegrationType integrationType;  //!< integration scheme
+        unsigned long seed;               //!< seed of the ensemble, every rollout derives its own engine from it
+        bool recordTrajectories;          //!< record the full trajectory of every rollout
+    };
+
+    /*!
+     * @param system the prototype system including its controller, it is cloned for every worker
+     * @param settings the settings
+     */
+    EnsembleSimulator(const std::shared_ptr<CONTROLLED_SYSTEM>& system, const Settings& settings = Settings())
+        : system_(system), settings_(settings)
+    {
+        if (!system_)
+            throw std::runtime_error("EnsembleSimulator: system must not be null.");
+        if (settings_.simDt <= 0 || settings_.controlDt <= 0)
+            throw std::runtime_error("EnsembleSimulator: step sizes must be positive.");
+        if (settings_.simDt > settings_.controlDt)
+            throw std::runtime_error("EnsembleSimulator: simulation step must be smaller than the control step.");
+    }
+
+    const Settings& settings() const { return settings_; }
+    void setInitializeFunction(const InitializeFunction& initialize) { initialize_ = initialize; }
+    void setDisturbanceFunction(const DisturbanceFunction& disturbance) { disturbance_ = disturbance; }
+    //! number of control steps per rollout
+    size_t numSteps() const { return static_cast<size_t>(std::round(settings_.duration / settings_.controlDt)); }
+    //! the random engine of a rollout, it only depends on the seed of the ensemble and the rollout index
+    static Engine rolloutEngine(unsigned long seed, size_t rollout)
+    {
+        std::seed_seq sequence{static_cast<unsigned long>(seed >> 32), static_cast<unsigned long>(seed & 0xffffffff),
+            static_cast<unsigned long>(rollout >> 32), static_cast<unsigned long>(rollout & 0xffffffff)};
+        return Engine(sequence);
+    }
+
+    /*!
+     * @brief runs the rollouts
+     * @param x0 the nominal initial state, which can be modified per rollout by the initialize function
+     * @param nRollouts number of rollouts
+     * @param result the trajectories and statistics, resized if required
+     */
+    void simulate(const StateVector<STATE_DIM, SCALAR>& x0, size_t nRollouts, Result& result)
+    {
+        const size_t K = numSteps();
+        const size_t nWorkers = std::max<size_t>(
+            1, std::min<size_t>(nRollouts, settings_.nThreads > 0 ? settings_.nThreads
+                                                                  : std::max(1u, std::thread::hardware_concurrency())));
+
+        // preallocate all storage
+        result.times.resize(K + 1);
+        for (size_t k = 0; k <= K; k++)
+            result.times[k] = k * settings_.controlDt;
+        result.finalStates.resize(STATE_DIM, nRollouts);
+        result.mean.setZero(STATE_DIM, K + 1);
+        result.standardDeviation.setZero(STATE_DIM, K + 1);
+        result.diverged.assign(nRollouts, false);
+        result.trajectories.resize(settings_.recordTrajectories ? nRollouts : 0);
+        for (auto& trajectory : result.trajectories)
+            trajectory.resize(STATE_DIM, K + 1);
+
+        std::vector<Worker> workers(nWorkers);
+        for (size_t w = 0; w < nWorkers; w++)
+        {
+            workers[w].system = std::shared_ptr<CONTROLLED_SYSTEM>(system_->clone());
+            workers[w].integrator = std::shared_ptr<Integrator<STATE_DIM, SCALAR>>(
+                new Integrator<STATE_DIM, SCALAR>(workers[w].system, settings_.integrationType));
+            workers[w].mean.setZero(STATE_DIM, K + 1);
+            workers[w].m2.setZero(STATE_DIM, K + 1);
+            workers[w].delta.resize(STATE_DIM, K + 1);
+            workers[w].trajectory.resize(STATE_DIM, K + 1);
+            workers[w].count = 0;
+        }
+
+        // static assignment of contiguous rollout ranges, such that the statistics are reproducible
+        std::vector<std::thread> threads;
+        for (size_t w = 1; w < nWorkers; w++)
+            threads.emplace_back([&, w]() { runRollouts(workers[w], x0, w * nRollouts / nWorkers,
+                                                (w + 1) * nRollouts / nWorkers, result); });
+        runRollouts(workers[0], x0, 0, nRollouts / nWorkers, result);
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        // merge the statistics of the workers (Chan et al.)
+        size_t count = 0;
+        Eigen::Matrix<SCALAR, STATE_DIM, Eigen::Dynamic> m2;
+        m2.setZero(STATE_DIM, K + 1);
+        for (const Worker& worker : workers)
+        {
+            if (worker.count == 0)
+                continue;
+            const SCALAR n = count + worker.count;
+            const Eigen::Matrix<SCALAR, STATE_DIM, Eigen::Dynamic> delta = worker.mean - result.mean;
+            result.mean += delta * (worker.count / n);
+            m2 += worker.m2 + delta.cwiseProduct(delta) * (count * worker.count / n);
+            count += worker.count;
+        }
+        if (count > 1)
+            result.standardDeviation = (m2 / (count - 1)).cwiseSqrt();
+    }
+
+private:
+    struct Worker
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+        std::shared_ptr<CONTROLLED_SYSTEM> system;
+        std::shared_ptr<Integrator<STATE_DIM, SCALAR>> integrator;
+        Eigen::Matrix<SCALAR, STATE_DIM, Eigen::Dynamic> mean;  //!< running mean per step
+        Eigen::Matrix<SCALAR, STATE_DIM, Eigen::Dynamic> m2;    //!< running sum of squared deviations per step
+        Eigen::Matrix<SCALAR, STATE_DIM, Eigen::Dynamic> delta;       //!< buffer for the statistics update
+        Eigen::Matrix<SCALAR, STATE_DIM, Eigen::Dynamic> trajectory;  //!< buffer for the current rollout
+        size_t count;                                           //!< number of finite rollouts
+    };
+
+    //! runs the rollouts [begin, end) on a worker
+    void runRollouts(Worker& worker, const StateVector<STATE_DIM, SCALAR>& x0, size_t begin, size_t end, Result& result)
+    {
+        const size_t K = numSteps();
+        const int subSteps = std::max(1, static_cast<int>(std::round(settings_.controlDt / settings_.simDt)));
+        const SCALAR dt = settings_.controlDt / subSteps;
+
+        std::shared_ptr<Controller<STATE_DIM, CONTROL_DIM, SCALAR>> prototypeController;
+        system_->getController(prototypeController);
+
+        StateVector<STATE_DIM, SCALAR> x;
+        Eigen::Matrix<SCALAR, STATE_DIM, Eigen::Dynamic>& trajectory = worker.trajectory;
+
+        for (size_t r = begin; r < end; r++)
+        {
+            Engine engine = rolloutEngine(settings_.seed, r);
+
+            // every rollout starts with the initial state of the controller
+            if (prototypeController)
+                worker.system->setController(
+                    std::shared_ptr<Controller<STATE_DIM, CONTROL_DIM, SCALAR>>(prototypeController->clone()));
+
+            x = x0;
+            if (initialize_)
+                initialize_(r, engine, x, *worker.system);
+            trajectory.col(0) = x;
+
+            bool finite = x.allFinite();
+            for (size_t k = 0; k < K && finite; k++)
+            {
+                worker.integrator->integrate_n_steps(x, k * settings_.controlDt, subSteps, dt);
+                if (disturbance_)
+                    disturbance_(r, k + 1, (k + 1) * settings_.controlDt, engine, x);
+                trajectory.col(k + 1) = x;
+                finite = x.allFinite();
+            }
+
+            result.finalStates.col(r) = x;
+            if (settings_.recordTrajectories)
+                result.trajectories[r] = trajectory;
+
+            // diverged rollouts are excluded from the statistics
+            if (!finite)
+            {
+                result.diverged[r] = true;
+                continue;
+            }
+
+            // Welford's online update of mean and variance
+            worker.count++;
+            worker.delta = trajectory - worker.mean;
+            worker.mean += worker.delta / SCALAR(worker.count);
+            worker.m2 += worker.delta.cwiseProduct(trajectory - worker.mean);
+        }
+    }
+
+    std::shared_ptr<CONTROLLED_SYSTEM> system_;
+    Settings settings_;
+    InitializeFunction initialize_;
+    DisturbanceFunction disturbance_;
+};
+
+}  // namespace core
+}  // namespace ct
@@ -56,7 +56,7 @@ public:
     LTISystem<STATE_DIM, CONTROL_DIM>* clone() const override { return new LTISystem<STATE_DIM, CONTROL_DIM>(*this); }
     virtual ~LTISystem() {}
     //! get A matrix
-    virtual const Eigen::Matrix<double, STATE_DIM, STATE_DIM>& getDerivativeState(const StateVector<STATE_DIM>& x,
+    virtual const StateMatrix<STATE_DIM>& getDerivativeState(const StateVector<STATE_DIM>& x,
         const ControlVector<CONTROL_DIM>& u,
         const double t = 0.0) override
     {
@@ -64,7 +64,7 @@ public:
     }
 
     //! get B matrix
-    virtual const Eigen::Matrix<double, STATE_DIM, CONTROL_DIM>& getDerivativeControl(const StateVector<STATE_DIM>& x,
+    virtual const StateControlMatrix<STATE_DIM, CONTROL_DIM>& getDerivativeControl(const StateVector<STATE_DIM>& x,
         const ControlVector<CONTROL_DIM>& u,
         const double t = 0.0) override
     {
@@ -72,9 +72,9 @@ public:
     }
 
     //! get A matrix
-    Eigen::Matrix<double, STATE_DIM, STATE_DIM>& A() { return A_; }
+    StateMatrix<STATE_DIM>& A() { return A_; }
     //! get B matrix
-    Eigen::Matrix<double, STATE_DIM, CONTROL_DIM>& B() { return B_; }
+    StateControlMatrix<STATE_DIM, CONTROL_DIM>& B() { return B_; }
     //! get C matrix
     Eigen::Matrix<double, STATE_DIM, STATE_DIM>& C() { return C_; }
     //! get D matrix
@@ -180,8 +180,8 @@ public:
 
 
 private:
-    Eigen::Matrix<double, STATE_DIM, STATE_DIM> A_;    //!< A matrix
-    Eigen::Matrix<double, STATE_DIM, CONTROL_DIM> B_;  //!< B matrix
+    StateMatrix<STATE_DIM> A_;                      //!< A matrix
+    StateControlMatrix<STATE_DIM, CONTROL_DIM> B_;  //!< B matrix
 
     Eigen::Matrix<double, STATE_DIM, STATE_DIM> C_;    //!< C matrix
     Eigen::Matrix<double, STATE_DIM, CONTROL_DIM> D_;  //!< D matrix
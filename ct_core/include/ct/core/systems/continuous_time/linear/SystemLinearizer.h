@@ -179,6 +179,26 @@ public:
     }
 
 
+    //! set the sparsity patterns of the Jacobians to reduce the number of dynamics evaluations
+    /*!
+	 * see DynamicsLinearizerNumDiff::setSparsityPatternState()
+	 * @param patternA sparsity pattern of the state Jacobian
+	 * @param patternB sparsity pattern of the input Jacobian
+	 */
+    void setSparsityPattern(const Eigen::Matrix<bool, STATE_DIM, STATE_DIM>& patternA,
+        const Eigen::Matrix<bool, STATE_DIM, CONTROL_DIM>& patternB)
+    {
+        linearizer_.setSparsityPatternState(patternA);
+        linearizer_.setSparsityPatternControl(patternB);
+    }
+
+    //! detect the sparsity patterns of the Jacobians by probing, see DynamicsLinearizerNumDiff::detectSparsityPattern()
+    void detectSparsityPattern(const state_vector_t& x, const control_vector_t& u, const time_t t = 0.0)
+    {
+        linearizer_.detectSparsityPattern(x, u, t);
+    }
+
+
 protected:
     std::shared_ptr<system_t> nonlinearSystem_;  //!< instance of non-linear system
 
@@ -56,9 +56,14 @@ SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::~SystemDiscreti
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR>
 SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::SystemDiscretizer(const SystemDiscretizer& arg)
-    : dt_(arg.dt_), K_sim_(arg.K_sim_), dt_sim_(arg.dt_sim_), integratorType_(arg.integratorType_)
+    : Base(arg),
+      dt_(arg.dt_),
+      K_sim_(arg.K_sim_),
+      dt_sim_(arg.dt_sim_),
+      integratorType_(arg.integratorType_),
+      cont_constant_controller_(new ConstantController<STATE_DIM, CONTROL_DIM, SCALAR>())
 {
-    changeContinuousTimeSystem(ContinuousSystemPtr(cont_time_system_->clone()));
+    changeContinuousTimeSystem(arg.cont_time_system_);
 }
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR>
@@ -89,6 +94,9 @@ void SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::setParamet
     dt_ = dt;
     K_sim_ = K_sim;
     dt_sim_ = getSimulationTimestep();
+
+    if (substepRecorder_)
+        reserveSubstepRecorder();
 }
 
 
@@ -97,8 +105,17 @@ void SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::initialize
 {
     substepRecorder_ =
         SubstepRecorderPtr(new ct::core::SubstepRecorder<STATE_DIM, CONTROL_DIM, SCALAR>(cont_time_system_));
+    reserveSubstepRecorder();
 
-    if (integratorType_ != ct::core::IntegrationType::EULER_SYM && integratorType_ != ct::core::IntegrationType::RK_SYM)
+    if (stepper_)
+    {
+        integrator_ = std::shared_ptr<ct::core::Integrator<STATE_DIM, SCALAR>>(
+            new ct::core::Integrator<STATE_DIM, SCALAR>(cont_time_system_, stepper_,
+                typename ct::core::Integrator<STATE_DIM, SCALAR>::EventHandlerPtrVector(1, substepRecorder_)));
+        return;
+    }
+
+    if (!ct::core::isSymplecticIntegrator(integratorType_))
     {
         integrator_ = std::shared_ptr<ct::core::Integrator<STATE_DIM, SCALAR>>(
             new ct::core::Integrator<STATE_DIM, SCALAR>(cont_time_system_, integratorType_, substepRecorder_));
@@ -107,6 +124,39 @@ void SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::initialize
 }
 
 
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR>
+void SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::setStepper(const StepperPtr& stepper)
+{
+    stepper_ = stepper;
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR>
+void SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::reserveSubstepRecorder()
+{
+    // the recorder logs every evaluation of the dynamics. Adaptive steppers may exceed the reserved size, in which case
+    // the recorder grows once and keeps its capacity afterwards.
+    size_t evaluationsPerStep;
+    switch (integratorType_)
+    {
+        case EULER:
+        case EULERCT:
+        case EULER_SYM:
+            evaluationsPerStep = 1;
+            break;
+        case RK4:
+        case RK4CT:
+        case RK_SYM:
+            evaluationsPerStep = 4;
+            break;
+        default:
+            evaluationsPerStep = 13;  // the stages of the Runge-Kutta-Fehlberg 78 stepper
+    }
+
+    substepRecorder_->reserve(evaluationsPerStep * K_sim_ + 1);
+}
+
+
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR>
 void SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::changeContinuousTimeSystem(
     ContinuousSystemPtr dyn)
@@ -138,7 +188,7 @@ void SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR>::propagateC
     stateNext = state;
 
     // perform integration
-    if (integratorType_ == ct::core::IntegrationType::EULER_SYM || integratorType_ == ct::core::IntegrationType::RK_SYM)
+    if (!stepper_ && ct::core::isSymplecticIntegrator(integratorType_))
     {
         integrateSymplectic<V_DIM, P_DIM, STATE_DIM>(stateNext, n * dt_, K_sim_, dt_sim_);
     }
@@ -168,6 +218,18 @@ SYMPLECTIC_ENABLED SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALA
             new ct::core::IntegratorSymplecticRk<P_DIM, V_DIM, CONTROL_DIM, SCALAR>(
                 std::static_pointer_cast<ct::core::SymplecticSystem<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>(
                     cont_time_system_)));
+
+        //! initialize the symplectic splitting integrators
+        auto symplecticSystem =
+            std::static_pointer_cast<ct::core::SymplecticSystem<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>(cont_time_system_);
+        integratorVerletSymplectic_ = IntegratorSymplecticVerletPtr(
+            new ct::core::IntegratorSymplecticVerlet<P_DIM, V_DIM, CONTROL_DIM, SCALAR>(symplecticSystem));
+        integratorForestRuthSymplectic_ = IntegratorSymplecticForestRuthPtr(
+            new ct::core::IntegratorSymplecticForestRuth<P_DIM, V_DIM, CONTROL_DIM, SCALAR>(symplecticSystem));
+        integratorYoshida4Symplectic_ = IntegratorSymplecticYoshida4Ptr(
+            new ct::core::IntegratorSymplecticYoshida4<P_DIM, V_DIM, CONTROL_DIM, SCALAR>(symplecticSystem));
+        integratorYoshida6Symplectic_ = IntegratorSymplecticYoshida6Ptr(
+            new ct::core::IntegratorSymplecticYoshida6<P_DIM, V_DIM, CONTROL_DIM, SCALAR>(symplecticSystem));
     }
 }
 
@@ -187,17 +249,28 @@ SYMPLECTIC_ENABLED SystemDiscretizer<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALA
     if (!cont_time_system_->isSymplectic())
         throw std::runtime_error("Trying to integrate using symplectic integrator, but system is not symplectic.");
 
-    if (integratorType_ == ct::core::IntegrationType::EULER_SYM)
-    {
-        integratorEulerSymplectic_->integrate_n_steps(x0, t, steps, dt_sim);
-    }
-    else if (integratorType_ == ct::core::IntegrationType::RK_SYM)
-    {
-        integratorRkSymplectic_->integrate_n_steps(x0, t, steps, dt_sim);
-    }
-    else
+    switch (integratorType_)
     {
-        throw std::runtime_error("invalid symplectic integrator specified");
+        case EULER_SYM:
+            integratorEulerSymplectic_->integrate_n_steps(x0, t, steps, dt_sim);
+            break;
+        case RK_SYM:
+            integratorRkSymplectic_->integrate_n_steps(x0, t, steps, dt_sim);
+            break;
+        case VERLET_SYM:
+            integratorVerletSymplectic_->integrate_n_steps(x0, t, steps, dt_sim);
+            break;
+        case FOREST_RUTH_SYM:
+            integratorForestRuthSymplectic_->integrate_n_steps(x0, t, steps, dt_sim);
+            break;
+        case YOSHIDA4_SYM:
+            integratorYoshida4Symplectic_->integrate_n_steps(x0, t, steps, dt_sim);
+            break;
+        case YOSHIDA6_SYM:
+            integratorYoshida6Symplectic_->integrate_n_steps(x0, t, steps, dt_sim);
+            break;
+        default:
+            throw std::runtime_error("invalid symplectic integrator specified");
     }
 }
 
@@ -33,7 +33,7 @@ namespace core {
  * dt_. Furthermore, the substeps during integration are recorded during each propagate-call, and can be retrieved
  * using getSubstates() and getSubcontrols().
  *
- *  \warning no substeps can be recorded for higher order RK symplectic integrators.
+ *  \warning no substeps can be recorded for the higher order symplectic integrators.
  *
  */
 template <size_t STATE_DIM,
@@ -49,10 +49,19 @@ public:
     typedef typename Base::time_t time_t;
 
     using IntegratorPtr = std::shared_ptr<Integrator<STATE_DIM, SCALAR>>;
+    using StepperPtr = typename Integrator<STATE_DIM, SCALAR>::StepperPtr;
     using IntegratorSymplecticEulerPtr =
         std::shared_ptr<ct::core::IntegratorSymplecticEuler<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>;
     using IntegratorSymplecticRkPtr =
         std::shared_ptr<ct::core::IntegratorSymplecticRk<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>;
+    using IntegratorSymplecticVerletPtr =
+        std::shared_ptr<ct::core::IntegratorSymplecticVerlet<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>;
+    using IntegratorSymplecticForestRuthPtr =
+        std::shared_ptr<ct::core::IntegratorSymplecticForestRuth<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>;
+    using IntegratorSymplecticYoshida4Ptr =
+        std::shared_ptr<ct::core::IntegratorSymplecticYoshida4<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>;
+    using IntegratorSymplecticYoshida6Ptr =
+        std::shared_ptr<ct::core::IntegratorSymplecticYoshida6<P_DIM, V_DIM, CONTROL_DIM, SCALAR>>;
 
     using ContinuousSystemPtr = std::shared_ptr<ControlledSystem<STATE_DIM, CONTROL_DIM, SCALAR>>;
     using ContinuousConstantControllerPtr = std::shared_ptr<ConstantController<STATE_DIM, CONTROL_DIM, SCALAR>>;
@@ -132,6 +141,16 @@ public:
     const ControlVectorArrayPtr& getSubcontrols() const;
 
 protected:
+    //! reserve the substep recorder for the number of dynamics evaluations in one control step
+    void reserveSubstepRecorder();
+
+    //! integrate with a custom stepper instead of the integration type, e.g. a stepper on a manifold
+    /*!
+     * The stepper is not copied by the copy constructor, hence derived classes which set it have to create a new
+     * stepper for every copy. Takes effect with the next call to initialize().
+     */
+    void setStepper(const StepperPtr& stepper);
+
     //! initialize the symplectic integrator, if the system is symplectic
     SYMPLECTIC_ENABLED initializeSymplecticIntegrator();
 
@@ -165,6 +184,9 @@ protected:
     //! the integration type for forward integration
     ct::core::IntegrationType integratorType_;
 
+    //! a custom stepper which replaces the integration type, if set
+    StepperPtr stepper_;
+
     //! the continuous-time system to be discretized
     ContinuousSystemPtr cont_time_system_;
 
@@ -180,6 +202,12 @@ protected:
     //! an integrator for forward integrating a symplectic continuous-time system with symplectic RK methods
     IntegratorSymplecticRkPtr integratorRkSymplectic_;
 
+    //! integrators for forward integrating a symplectic continuous-time system with symplectic splitting methods
+    IntegratorSymplecticVerletPtr integratorVerletSymplectic_;
+    IntegratorSymplecticForestRuthPtr integratorForestRuthSymplectic_;
+    IntegratorSymplecticYoshida4Ptr integratorYoshida4Symplectic_;
+    IntegratorSymplecticYoshida6Ptr integratorYoshida6Symplectic_;
+
     //! substep recorder which logs all the substeps required for later computing exact sensitivities
     SubstepRecorderPtr substepRecorder_;
 };
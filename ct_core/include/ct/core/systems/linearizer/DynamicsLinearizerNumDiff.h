@@ -4,6 +4,11 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 **********************************************************************************************************************/
 #pragma once
 
+#include <thread>
+#include <vector>
+
+#include "../../math/JacobianColoring.h"
+
 namespace ct {
 namespace core {
 
@@ -22,6 +27,10 @@ namespace core {
  * \end{aligned}
  * \f]
  *
+ * By default, every column of a Jacobian is computed with a separate perturbation. If a sparsity pattern is set or
+ * detected, structurally orthogonal columns are perturbed at once (see JacobianColoring), which reduces the number of
+ * dynamics evaluations to the number of colors of the pattern. The perturbations can optionally be evaluated on
+ * multiple threads, which requires the dynamics function to be thread-safe.
  */
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename TIME>
@@ -47,7 +56,7 @@ public:
      * @param doubleSidedDerivative if true, double sided numerical differentiation is used
      */
     DynamicsLinearizerNumDiff(dynamics_fct_t dyn, bool doubleSidedDerivative = true)
-        : dynamics_fct_(dyn), doubleSidedDerivative_(doubleSidedDerivative)
+        : dynamics_fct_(dyn), doubleSidedDerivative_(doubleSidedDerivative), nThreads_(1)
     {
         dFdx_.setZero();
         dFdu_.setZero();
@@ -58,9 +67,12 @@ public:
     DynamicsLinearizerNumDiff(const DynamicsLinearizerNumDiff& rhs)
         : dynamics_fct_(rhs.dynamics_fct_),
           doubleSidedDerivative_(rhs.doubleSidedDerivative_),
+          eps_(rhs.eps_),
+          nThreads_(rhs.nThreads_),
+          coloringState_(rhs.coloringState_),
+          coloringControl_(rhs.coloringControl_),
           dFdx_(rhs.dFdx_),
-          dFdu_(rhs.dFdu_),
-          eps_(rhs.eps_)
+          dFdu_(rhs.dFdu_)
     {
     }
 
@@ -84,38 +96,9 @@ public:
         if (!doubleSidedDerivative_)
             dynamics_fct_(x, t, u, res_ref_);
 
-        for (size_t i = 0; i < STATE_DIM; i++)
-        {
-            // inspired from http://en.wikipedia.org/wiki/Numerical_differentiation#Practical_considerations_using_floating_point_arithmetic
-            SCALAR h = eps_ * std::max(std::abs<SCALAR>(x(i)), SCALAR(1.0));
-            SCALAR x_ph = x(i) + h;
-            SCALAR dxp = x_ph - x(i);
-
-            state_vector_t x_perturbed = x;
-            x_perturbed(i) = x_ph;
-
-            // evaluate dynamics at perturbed state
-            state_vector_t res_plus;
-            dynamics_fct_(x_perturbed, t, u, res_plus);
-
-            if (doubleSidedDerivative_)
-            {
-                SCALAR x_mh = x(i) - h;
-                SCALAR dxm = x(i) - x_mh;
-
-                x_perturbed = x;
-                x_perturbed(i) = x_mh;
-
-                state_vector_t res_minus;
-                dynamics_fct_(x_perturbed, t, u, res_minus);
-
-                dFdx_.col(i) = (res_plus - res_minus) / (dxp + dxm);
-            }
-            else
-            {
-                dFdx_.col(i) = (res_plus - res_ref_) / dxp;
-            }
-        }
+        computeJacobian(x, [&](const state_vector_t& x_perturbed, state_vector_t& res) {
+            dynamics_fct_(x_perturbed, t, u, res);
+        }, coloringState_, dFdx_);
 
         return dFdx_;
     }
@@ -141,50 +124,181 @@ public:
         if (!doubleSidedDerivative_)
             dynamics_fct_(x, t, u, res_ref_);
 
-        for (size_t i = 0; i < CONTROL_DIM; i++)
-        {
-            // inspired from http://en.wikipedia.org/wiki/Numerical_differentiation#Practical_considerations_using_floating_point_arithmetic
-            SCALAR h = eps_ * std::max(std::abs<SCALAR>(u(i)), SCALAR(1.0));
-            SCALAR u_ph = u(i) + h;
-            SCALAR dup = u_ph - u(i);
+        computeJacobian(u, [&](const control_vector_t& u_perturbed, state_vector_t& res) {
+            dynamics_fct_(x, t, u_perturbed, res);
+        }, coloringControl_, dFdu_);
 
-            control_vector_t u_perturbed = u;
-            u_perturbed(i) = u_ph;
+        return dFdu_;
+    }
 
-            // evaluate dynamics at perturbed state
-            state_vector_t res_plus;
-            dynamics_fct_(x, t, u_perturbed, res_plus);
+    //! set the sparsity pattern of the state Jacobian, a "true" entry marks a (possibly) non-zero entry
+    void setSparsityPatternState(const Eigen::Matrix<bool, STATE_DIM, STATE_DIM>& pattern)
+    {
+        coloringState_.init(pattern);
+    }
 
-            if (doubleSidedDerivative_)
-            {
-                SCALAR u_mh = u(i) - h;
-                SCALAR dum = u(i) - u_mh;
+    //! set the sparsity pattern of the input Jacobian, a "true" entry marks a (possibly) non-zero entry
+    void setSparsityPatternControl(const Eigen::Matrix<bool, STATE_DIM, CONTROL_DIM>& pattern)
+    {
+        coloringControl_.init(pattern);
+    }
 
-                u_perturbed = u;
-                u_perturbed(i) = u_mh;
+    //! detect the sparsity patterns of both Jacobians by probing
+    /*!
+     * Computes the dense Jacobians at the given point and at random points around it. Every entry which is non-zero
+     * at any of these points is part of the pattern. Entries which vanish at all probed points are assumed to be
+     * structurally zero, hence the probes should be representative for the range the linearizer is used in.
+     *
+     * @param x state to probe at
+     * @param u control to probe at
+     * @param t time
+     * @param nProbes number of additional random points
+     * @param radius relative size of the random deviation of the additional points
+     */
+    void detectSparsityPattern(const state_vector_t& x,
+        const control_vector_t& u,
+        const TIME t = TIME(0),
+        size_t nProbes = 2,
+        SCALAR radius = SCALAR(0.1))
+    {
+        clearSparsityPattern();
 
-                state_vector_t res_minus;
-                dynamics_fct_(x, t, u_perturbed, res_minus);
+        Eigen::Matrix<bool, STATE_DIM, STATE_DIM> patternState;
+        Eigen::Matrix<bool, STATE_DIM, CONTROL_DIM> patternControl;
+        patternState.setConstant(false);
+        patternControl.setConstant(false);
 
-                dFdu_.col(i) = (res_plus - res_minus) / (dup + dum);
-            }
-            else
+        for (size_t i = 0; i <= nProbes; i++)
+        {
+            state_vector_t x_probe = x;
+            control_vector_t u_probe = u;
+            if (i > 0)
             {
-                dFdu_.col(i) = (res_plus - res_ref_) / dup;
+                x_probe += radius * x.cwiseAbs().cwiseMax(SCALAR(1.0)).cwiseProduct(state_vector_t::Random());
+                u_probe += radius * u.cwiseAbs().cwiseMax(SCALAR(1.0)).cwiseProduct(control_vector_t::Random());
             }
+
+            patternState = patternState.array() || (getDerivativeState(x_probe, u_probe, t).array() != SCALAR(0.0));
+            patternControl =
+                patternControl.array() || (getDerivativeControl(x_probe, u_probe, t).array() != SCALAR(0.0));
         }
 
-        return dFdu_;
+        setSparsityPatternState(patternState);
+        setSparsityPatternControl(patternControl);
     }
 
+    //! remove the sparsity patterns, every column is computed separately again
+    void clearSparsityPattern()
+    {
+        coloringState_.clear();
+        coloringControl_.clear();
+    }
+
+    const JacobianColoring& getColoringState() const { return coloringState_; }
+    const JacobianColoring& getColoringControl() const { return coloringControl_; }
+    //! number of threads to evaluate the perturbations on, the dynamics function needs to be thread-safe if > 1
+    void setNumThreads(size_t nThreads) { nThreads_ = std::max<size_t>(nThreads, 1); }
     bool getDoubleSidedDerivativeFlag() const { return doubleSidedDerivative_; }
 protected:
+    //! computes a Jacobian column by column or color by color
+    /*!
+     * @param p the point to differentiate at
+     * @param f function evaluating the dynamics at a perturbed point
+     * @param coloring the coloring of the Jacobian, if not initialized, every column is perturbed separately
+     * @param jac the resulting Jacobian
+     */
+    template <int DIM, typename FUNCTION>
+    void computeJacobian(const Eigen::Matrix<SCALAR, DIM, 1>& p,
+        const FUNCTION& f,
+        const JacobianColoring& coloring,
+        Eigen::Matrix<SCALAR, STATE_DIM, DIM>& jac)
+    {
+        const size_t nGroups = coloring.initialized() ? coloring.numColors() : size_t(DIM);
+
+        auto evaluateGroups = [&](size_t begin, size_t stride) {
+            Eigen::Matrix<SCALAR, DIM, 1> p_perturbed;
+            Eigen::Matrix<SCALAR, DIM, 1> dp;  // sum of the forward and backward step per coordinate
+            state_vector_t res_plus;
+            state_vector_t res_minus;
+            std::vector<size_t> single(1);
+
+            for (size_t g = begin; g < nGroups; g += stride)
+            {
+                single[0] = g;
+                const std::vector<size_t>& columns = coloring.initialized() ? coloring.columns(g) : single;
+
+                // inspired from http://en.wikipedia.org/wiki/Numerical_differentiation#Practical_considerations_using_floating_point_arithmetic
+                p_perturbed = p;
+                for (size_t i : columns)
+                {
+                    SCALAR h = eps_ * std::max(std::abs<SCALAR>(p(i)), SCALAR(1.0));
+                    p_perturbed(i) = p(i) + h;
+                    dp(i) = p_perturbed(i) - p(i);
+                }
+
+                // evaluate dynamics at perturbed point
+                f(p_perturbed, res_plus);
+
+                if (doubleSidedDerivative_)
+                {
+                    p_perturbed = p;
+                    for (size_t i : columns)
+                    {
+                        SCALAR h = eps_ * std::max(std::abs<SCALAR>(p(i)), SCALAR(1.0));
+                        p_perturbed(i) = p(i) - h;
+                        dp(i) += p(i) - p_perturbed(i);
+                    }
+
+                    f(p_perturbed, res_minus);
+                }
+                else
+                {
+                    res_minus = res_ref_;
+                }
+
+                // every non-zero of the difference belongs to exactly one column of the group
+                for (size_t i : columns)
+                {
+                    if (coloring.initialized())
+                    {
+                        for (size_t row = 0; row < STATE_DIM; row++)
+                            jac(row, i) =
+                                coloring.nonZero(row, i) ? (res_plus(row) - res_minus(row)) / dp(i) : SCALAR(0.0);
+                    }
+                    else
+                    {
+                        jac.col(i) = (res_plus - res_minus) / dp(i);
+                    }
+                }
+            }
+        };
+
+        const size_t nThreads = std::min(nThreads_, nGroups);
+        if (nThreads > 1)
+        {
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < nThreads; i++)
+                threads.emplace_back(evaluateGroups, i, nThreads);
+            evaluateGroups(0, nThreads);
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+        else
+        {
+            evaluateGroups(0, 1);
+        }
+    }
+
     dynamics_fct_t dynamics_fct_;  //!< function handle to system dynamics
 
     bool doubleSidedDerivative_;  //!< flag if double sided numerical differentiation should be used
 
     SCALAR eps_;  //!< perturbation for numerical differentiation
 
+    size_t nThreads_;  //!< number of threads to evaluate the perturbations on
+
+    JacobianColoring coloringState_;    //!< coloring of the state Jacobian
+    JacobianColoring coloringControl_;  //!< coloring of the input Jacobian
 
     // internally used variables
     state_matrix_t dFdx_;          //!< Jacobian wrt state
@@ -0,0 +1,192 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include <ct/core/core.h>
+#include <ct/core/common/AllocationTrackerHooks.h>
+
+using namespace ct::core;
+
+const size_t STATE_DIM = 3;
+const size_t CONTROL_DIM = 2;
+
+//! a unique file name for each test
+std::string logFileName(const std::string& test) { return "/tmp/BinaryLogTest_" + test + ".ctlog"; }
+template <typename ARRAY>
+void fillRandom(ARRAY& array, size_t n)
+{
+    array.resize(n);
+    for (size_t i = 0; i < n; i++)
+        array[i].setRandom();
+}
+
+TEST(BinaryLogTest, roundTripTest)
+{
+    const std::string fileName = logFileName("roundTrip");
+    const size_t N = 100;
+
+    TimeArray t(0.01, N + 1, 0.5);
+    StateVectorArray<STATE_DIM> x;
+    ControlVectorArray<CONTROL_DIM> u;
+    FeedbackArray<STATE_DIM, CONTROL_DIM> L;
+    StateVectorArray<STATE_DIM, float> x_float;
+    fillRandom(x, N + 1);
+    fillRandom(u, N);
+    fillRandom(L, N);
+    fillRandom(x_float, N + 1);
+    Eigen::VectorXd summary = Eigen::VectorXd::Random(13);
+    StateVectorArray<STATE_DIM> empty;
+
+    {
+        BinaryLogWriter writer(fileName);
+        ASSERT_TRUE(writer.log("t", t, 1.0));
+        ASSERT_TRUE(writer.log("x", x, 1.0));
+        ASSERT_TRUE(writer.log("u", u, 1.0));
+        ASSERT_TRUE(writer.log("L", L, 1.0));
+        ASSERT_TRUE(writer.log("x_float", x_float, 2.0));
+        ASSERT_TRUE(writer.log("summary", summary, 3.0));
+        ASSERT_TRUE(writer.log("a_very_long_channel_name_which_is_truncated", empty, 4.0));
+    }
+
+    BinaryLogReader reader(fileName);
+    ASSERT_EQ(reader.records().size(), 7u);
+    for (size_t i = 0; i < reader.records().size(); i++)
+        ASSERT_EQ(reader.records()[i].header.sequence, i);
+
+    TimeArray t_read;
+    StateVectorArray<STATE_DIM> x_read;
+    ControlVectorArray<CONTROL_DIM> u_read;
+    FeedbackArray<STATE_DIM, CONTROL_DIM> L_read;
+    StateVectorArray<STATE_DIM> x_float_read;
+    Eigen::VectorXd summary_read;
+    StateVectorArray<STATE_DIM> empty_read(5);
+
+    reader.read(reader.records("t").front(), t_read);
+    reader.read(reader.records("x").front(), x_read);
+    reader.read(reader.records("u").front(), u_read);
+    reader.read(reader.records("L").front(), L_read);
+    reader.read(reader.records("x_float").front(), x_float_read);
+    reader.read(reader.records("summary").front(), summary_read);
+    reader.read(reader.records().back(), empty_read);
+
+    ASSERT_TRUE(t_read.toImplementation() == t.toImplementation());
+    ASSERT_EQ(x_read.size(), x.size());
+    for (size_t i = 0; i < N; i++)
+    {
+        ASSERT_TRUE(x_read[i] == x[i]);
+        ASSERT_TRUE(u_read[i] == u[i]);
+        ASSERT_TRUE(L_read[i] == L[i]);
+        ASSERT_TRUE(x_float_read[i] == x_float[i].cast<double>());
+    }
+    ASSERT_TRUE(summary_read == summary);
+    ASSERT_EQ(empty_read.size(), 0u);
+
+    ASSERT_EQ(reader.records("summary").front().header.stamp, 3.0);
+    ASSERT_EQ(reader.records().back().channel(), std::string("a_very_long_channel_nam"));
+
+    // reading into the wrong type is rejected
+    ASSERT_ANY_THROW(reader.read(reader.records("u").front(), x_read));
+    ASSERT_ANY_THROW(reader.read(reader.records("t").front(), x_read));
+    ASSERT_ANY_THROW(reader.read(reader.records("x").front(), summary_read));
+
+    std::remove(fileName.c_str());
+}
+
+TEST(BinaryLogTest, liveReadTest)
+{
+    const std::string fileName = logFileName("liveRead");
+
+    StateVectorArray<STATE_DIM> x;
+    fillRandom(x, 10);
+
+    // small file chunks such that the file is grown a few times
+    BinaryLogWriter writer(fileName, 1 << 16, std::chrono::microseconds(100), 4096);
+    for (int i = 0; i < 10; i++)
+        ASSERT_TRUE(writer.log("x", x, i));
+    writer.flush();
+
+    BinaryLogReader reader(fileName);
+    ASSERT_EQ(reader.records().size(), 10u);
+
+    for (int i = 10; i < 100; i++)
+        ASSERT_TRUE(writer.log("x", x, i));
+    writer.flush();
+
+    ASSERT_EQ(reader.update(), 90u);
+    StateVectorArray<STATE_DIM> x_read;
+    for (size_t i = 0; i < reader.records().size(); i++)
+    {
+        ASSERT_EQ(reader.records()[i].header.stamp, double(i));
+        reader.read(reader.records()[i], x_read);
+        ASSERT_TRUE(x_read.toImplementation() == x.toImplementation());
+    }
+
+    std::remove(fileName.c_str());
+}
+
+TEST(BinaryLogTest, droppedRecordsTest)
+{
+    const std::string fileName = logFileName("droppedRecords");
+
+    StateVectorArray<STATE_DIM> x;
+    fillRandom(x, 100);
+
+    {
+        // the ring buffer holds only a few records and is not flushed during the test
+        BinaryLogWriter writer(fileName, 1 << 13, std::chrono::seconds(10));
+        size_t logged = 0;
+        for (int i = 0; i < 10; i++)
+            logged += writer.log("x", x, i);
+
+        ASSERT_GT(logged, 0u);
+        ASSERT_LT(logged, 10u);
+        ASSERT_EQ(writer.droppedRecords(), 10 - logged);
+    }
+
+    // the gap shows up in the sequence numbers
+    BinaryLogReader reader(fileName);
+    ASSERT_LT(reader.records().size(), 10u);
+    ASSERT_EQ(reader.records().back().header.sequence, reader.records().size() - 1);
+
+    std::remove(fileName.c_str());
+}
+
+TEST(BinaryLogTest, allocationTest)
+{
+    ASSERT_TRUE(AllocationTracker::enabled());
+
+    const std::string fileName = logFileName("allocation");
+
+    TimeArray t(0.01, 101, 0.0);
+    StateVectorArray<STATE_DIM> x;
+    FeedbackArray<STATE_DIM, CONTROL_DIM> L;
+    fillRandom(x, 101);
+    fillRandom(L, 100);
+    Eigen::Matrix<double, 13, 1> summary = Eigen::Matrix<double, 13, 1>::Random();
+
+    BinaryLogWriter writer(fileName);
+
+    AllocationTracker::Region region;
+    for (int i = 0; i < 100; i++)
+    {
+        writer.log("t", t, i);
+        writer.log("x", x, i);
+        writer.log("L", L, i);
+        writer.log("summary", summary, i);
+    }
+    ASSERT_EQ(region.count(), 0u);
+    ASSERT_EQ(writer.droppedRecords(), 0u);
+
+    std::remove(fileName.c_str());
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
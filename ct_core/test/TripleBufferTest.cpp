@@ -0,0 +1,81 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <ct/core/core.h>
+
+using namespace ct::core;
+
+//! a value which is inconsistent if it is read while being written
+struct Sample
+{
+    Sample() : counter(0), data(Eigen::VectorXd::Zero(100)) {}
+    int counter;
+    Eigen::VectorXd data;
+};
+
+TEST(TripleBufferTest, singleThreadTest)
+{
+    TripleBuffer<int> buffer;
+    ASSERT_FALSE(buffer.update());
+    ASSERT_FALSE(buffer.hasData());
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+
+    // only the latest value is received
+    ASSERT_TRUE(buffer.update());
+    ASSERT_TRUE(buffer.hasData());
+    ASSERT_EQ(buffer.front(), 2);
+    ASSERT_FALSE(buffer.update());
+    ASSERT_EQ(buffer.front(), 2);
+
+    buffer.back() = 3;
+    buffer.publish();
+    ASSERT_TRUE(buffer.update());
+    ASSERT_EQ(buffer.front(), 3);
+}
+
+TEST(TripleBufferTest, concurrencyTest)
+{
+    const int nSamples = 100000;
+    TripleBuffer<Sample> buffer;
+
+    std::thread writer([&]() {
+        for (int i = 1; i <= nSamples; i++)
+        {
+            buffer.back().counter = i;
+            buffer.back().data.setConstant(i);
+            buffer.publish();
+        }
+    });
+
+    int last = 0;
+    while (last < nSamples)
+    {
+        if (buffer.update())
+        {
+            const Sample& sample = buffer.front();
+
+            // values arrive in order and are never torn
+            ASSERT_GT(sample.counter, last);
+            ASSERT_TRUE((sample.data.array() == double(sample.counter)).all());
+            last = sample.counter;
+        }
+    }
+
+    writer.join();
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
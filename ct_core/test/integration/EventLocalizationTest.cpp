@@ -0,0 +1,159 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <gtest/gtest.h>
+#include <ct/core/core.h>
+
+using namespace ct::core;
+
+const double gravity = 9.81;
+const double height = 1.0;
+const double restitution = 0.8;
+
+//! a falling ball, the state is its height and vertical velocity
+class FallingBall : public System<2>
+{
+public:
+    FallingBall* clone() const override { return new FallingBall(*this); }
+    void computeDynamics(const StateVector<2>& state, const double& t, StateVector<2>& derivative) override
+    {
+        derivative(0) = state(1);
+        derivative(1) = -gravity;
+    }
+};
+
+//! the ball bounces when it hits the ground
+class GroundContact : public ZeroCrossingEventHandler<2>
+{
+public:
+    GroundContact(bool terminal = false) : ZeroCrossingEventHandler<2>(Direction::FALLING, terminal) {}
+    double eventFunction(const StateVector<2>& state, const double& t) override { return state(0); }
+    void handleEvent(const StateVector<2>& state, const double& t) override { eventTimes.push_back(t); }
+    void resetState(StateVector<2>& state, const double& t) override { state(1) = -restitution * state(1); }
+    void reset() override
+    {
+        ZeroCrossingEventHandler<2>::reset();
+        eventTimes.clear();
+    }
+
+    std::vector<double> eventTimes;
+};
+
+//! the analytic time of the n-th bounce
+double bounceTime(size_t n)
+{
+    const double impactVelocity = std::sqrt(2.0 * gravity * height);
+    double t = impactVelocity / gravity;
+    double v = impactVelocity;
+    for (size_t i = 0; i < n; i++)
+    {
+        v *= restitution;
+        t += 2.0 * v / gravity;
+    }
+    return t;
+}
+
+
+TEST(EventLocalizationTest, bouncingBallTest)
+{
+    std::shared_ptr<FallingBall> ball(new FallingBall);
+    std::shared_ptr<GroundContact> contact(new GroundContact);
+
+    // the trajectories are polynomials of second order, which are represented exactly by the dense output and the
+    // Hermite interpolation, such that the accuracy is limited by the event time tolerance only
+    for (IntegrationType type : {RK5VARIABLE, ODE45, RK4, RK4CT, RK78})
+    {
+        Integrator<2> integrator(ball, type, contact);
+
+        StateVector<2> state;
+        state << height, 0.0;
+        StateVectorArray<2> stateTrajectory;
+        TimeArray timeTrajectory;
+
+        // take steps which are large compared to the time between bounces
+        const double finalTime = 2.5;
+        double stopTime = integrator.integrate_events(state, 0.0, finalTime, stateTrajectory, timeTrajectory, 0.25);
+
+        ASSERT_EQ(stopTime, finalTime);
+        ASSERT_NEAR(timeTrajectory.back(), finalTime, 1e-12);
+        ASSERT_EQ(contact->eventTimes.size(), 4u) << "integration type " << type;
+
+        for (size_t i = 0; i < contact->eventTimes.size(); i++)
+            ASSERT_NEAR(contact->eventTimes[i], bounceTime(i), 1e-8) << "integration type " << type;
+
+        // the ball never falls through the ground
+        for (size_t i = 0; i < stateTrajectory.size(); i++)
+            ASSERT_GT(stateTrajectory[i](0), -1e-8);
+    }
+}
+
+
+TEST(EventLocalizationTest, terminalEventTest)
+{
+    std::shared_ptr<FallingBall> ball(new FallingBall);
+    std::shared_ptr<GroundContact> contact(new GroundContact(true));
+
+    for (IntegrationType type : {RK5VARIABLE, RK4, EULERCT})
+    {
+        Integrator<2> integrator(ball, type, contact);
+        integrator.setEventTimeTolerance(1e-12);
+
+        StateVector<2> state;
+        state << height, 0.0;
+        double stopTime = integrator.integrate_events(state, 0.0, 10.0, 0.1);
+
+        ASSERT_EQ(contact->eventTimes.size(), 1u);
+        ASSERT_EQ(stopTime, contact->eventTimes.front());
+        ASSERT_NEAR(state(0), 0.0, 1e-10);
+
+        // the Euler steps are not exact, yet the integration stops exactly at the zero crossing of its interpolation
+        if (type != EULERCT)
+        {
+            ASSERT_NEAR(stopTime, bounceTime(0), 1e-10);
+            ASSERT_NEAR(state(1), restitution * std::sqrt(2.0 * gravity * height), 1e-8);
+        }
+    }
+}
+
+
+TEST(EventLocalizationTest, eventDirectionTest)
+{
+    std::shared_ptr<FallingBall> ball(new FallingBall);
+
+    //! a handler which detects when the ball passes half of its initial height
+    class HalfHeight : public ZeroCrossingEventHandler<2>
+    {
+    public:
+        HalfHeight(Direction direction) : ZeroCrossingEventHandler<2>(direction), events(0) {}
+        double eventFunction(const StateVector<2>& state, const double& t) override { return state(0) - 0.5 * height; }
+        void handleEvent(const StateVector<2>& state, const double& t) override { events++; }
+        size_t events;
+    };
+
+    std::shared_ptr<HalfHeight> rising(new HalfHeight(HalfHeight::Direction::RISING));
+    std::shared_ptr<HalfHeight> falling(new HalfHeight(HalfHeight::Direction::FALLING));
+    std::shared_ptr<HalfHeight> both(new HalfHeight(HalfHeight::Direction::BOTH));
+    std::shared_ptr<GroundContact> contact(new GroundContact);
+
+    Integrator<2>::EventHandlerPtrVector eventHandlers = {rising, falling, both, contact};
+    Integrator<2> integrator(ball, RK5VARIABLE, eventHandlers);
+
+    // the ball falls through half height, bounces back above it and falls through it again before the next bounce
+    StateVector<2> state;
+    state << height, 0.0;
+    integrator.integrate_events(state, 0.0, bounceTime(1) - 0.1, 0.25);
+
+    ASSERT_EQ(contact->eventTimes.size(), 1u);
+    ASSERT_EQ(rising->events, 1u);
+    ASSERT_EQ(falling->events, 2u);
+    ASSERT_EQ(both->events, 3u);
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
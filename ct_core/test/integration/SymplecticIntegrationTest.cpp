@@ -16,6 +16,32 @@ const size_t p_dim = 1;
 const size_t v_dim = 1;
 const size_t control_dim = 1;
 
+//! a pendulum, the simplest nonlinear symplectic system
+class TestPendulum : public SymplecticSystem<p_dim, v_dim, control_dim>
+{
+public:
+    TestPendulum(double w_n) : w_n_(w_n) {}
+    TestPendulum* clone() const override { return new TestPendulum(*this); }
+    void computePdot(const StateVector<state_dim>& x,
+        const StateVector<v_dim>& v,
+        const ControlVector<control_dim>& control,
+        StateVector<p_dim>& pDot) override
+    {
+        pDot(0) = v(0);
+    }
+
+    void computeVdot(const StateVector<state_dim>& x,
+        const StateVector<p_dim>& p,
+        const ControlVector<control_dim>& control,
+        StateVector<v_dim>& vDot) override
+    {
+        vDot(0) = control(0) - w_n_ * w_n_ * std::sin(p(0));
+    }
+
+private:
+    double w_n_;
+};
+
 double uniformRandomNumber(double min, double max)
 {
     std::random_device rd;                             // obtain a random number from hardware
@@ -73,6 +99,203 @@ TEST(SymplecticIntegrationTest, simpleSymplecticTest)
 }
 
 
+//! integrate the undamped oscillator over one period and return the error w.r.t. the analytic solution
+template <typename INTEGRATOR>
+double integrationError(std::shared_ptr<TestSymplecticSystem> oscillator, double wn, double dt)
+{
+    INTEGRATOR integrator(oscillator);
+
+    const double T = 2 * M_PI / wn;
+    size_t nsteps = std::round(T / dt);
+
+    StateVector<state_dim> state;
+    state << 1.0, 0.0;
+    integrator.integrate_n_steps(state, 0.0, nsteps, T / nsteps);
+
+    StateVector<state_dim> exact;
+    exact << std::cos(wn * T), -wn * std::sin(wn * T);
+    return (state - exact).norm();
+}
+
+//! the empirical convergence order when halving the step size
+template <typename INTEGRATOR>
+double convergenceRate(std::shared_ptr<TestSymplecticSystem> oscillator, double wn, double dt)
+{
+    return std::log2(
+        integrationError<INTEGRATOR>(oscillator, wn, dt) / integrationError<INTEGRATOR>(oscillator, wn, dt / 2));
+}
+
+
+TEST(SymplecticIntegrationTest, convergenceOrderTest)
+{
+    const double wn = 1.0;
+    shared_ptr<ConstantController<state_dim, control_dim>> constController(
+        new ConstantController<state_dim, control_dim>());
+    shared_ptr<TestSymplecticSystem> oscillator(new TestSymplecticSystem(wn, constController));
+    constController->setControl(ct::core::ControlVector<control_dim>::Zero());
+
+    typedef IntegratorSymplecticVerlet<p_dim, v_dim, control_dim> Verlet;
+    typedef IntegratorSymplecticForestRuth<p_dim, v_dim, control_dim> ForestRuth;
+    typedef IntegratorSymplecticYoshida4<p_dim, v_dim, control_dim> Yoshida4;
+    typedef IntegratorSymplecticYoshida6<p_dim, v_dim, control_dim> Yoshida6;
+
+    // the error has to decrease with the order of the method when halving the step size
+    const double dt = 0.2;
+    EXPECT_NEAR(convergenceRate<Verlet>(oscillator, wn, dt), 2.0, 0.3);
+    EXPECT_NEAR(convergenceRate<ForestRuth>(oscillator, wn, dt), 4.0, 0.3);
+    EXPECT_NEAR(convergenceRate<Yoshida4>(oscillator, wn, dt), 4.0, 0.3);
+    EXPECT_NEAR(convergenceRate<Yoshida6>(oscillator, wn, dt), 6.0, 0.3);
+
+    // the optimized Forest-Ruth coefficients are more accurate than Yoshida's triple jump
+    EXPECT_LT(integrationError<ForestRuth>(oscillator, wn, dt), integrationError<Yoshida4>(oscillator, wn, dt));
+}
+
+
+TEST(SymplecticIntegrationTest, energyConservationTest)
+{
+    const double wn = 2.0;
+    shared_ptr<ConstantController<state_dim, control_dim>> constController(
+        new ConstantController<state_dim, control_dim>());
+    shared_ptr<TestSymplecticSystem> oscillator(new TestSymplecticSystem(wn, constController));
+    constController->setControl(ct::core::ControlVector<control_dim>::Zero());
+
+    IntegratorSymplecticYoshida6<p_dim, v_dim, control_dim> integrator(oscillator);
+
+    auto energy = [wn](const StateVector<state_dim>& x) { return 0.5 * (wn * wn * x(0) * x(0) + x(1) * x(1)); };
+
+    StateVector<state_dim> state;
+    state << 1.0, 0.0;
+    const double initialEnergy = energy(state);
+
+    // the energy error of a symplectic method stays bounded over long horizons
+    for (size_t i = 0; i < 100; i++)
+    {
+        integrator.integrate_n_steps(state, 0.0, 100, 0.05);
+        ASSERT_NEAR(energy(state), initialEnergy, 1e-8);
+    }
+}
+
+
+TEST(SymplecticIntegrationTest, symplecticSensitivityTest)
+{
+    const double dt = 0.1;
+    const double wn = uniformRandomNumber(0.1, 2.0);
+    shared_ptr<TestSymplecticSystem> oscillator(new TestSymplecticSystem(wn));
+    shared_ptr<SystemLinearizer<state_dim, control_dim>> linearizer(
+        new SystemLinearizer<state_dim, control_dim>(oscillator));
+
+    typedef SensitivityApproximationSettings::APPROXIMATION APPROXIMATION;
+    std::vector<std::pair<IntegrationType, APPROXIMATION>> methods = {
+        {EULER_SYM, APPROXIMATION::SYMPLECTIC_EULER}, {VERLET_SYM, APPROXIMATION::SYMPLECTIC_VERLET},
+        {FOREST_RUTH_SYM, APPROXIMATION::SYMPLECTIC_FOREST_RUTH}, {YOSHIDA4_SYM, APPROXIMATION::SYMPLECTIC_YOSHIDA4},
+        {YOSHIDA6_SYM, APPROXIMATION::SYMPLECTIC_YOSHIDA6}};
+
+    for (const auto& method : methods)
+    {
+        SystemDiscretizer<state_dim, control_dim, p_dim, v_dim> discretizer(oscillator, dt, method.first, 1);
+        discretizer.initialize();
+
+        SensitivityApproximation<state_dim, control_dim, p_dim, v_dim> sensitivity(dt, linearizer, method.second);
+
+        StateVector<state_dim> x = StateVector<state_dim>::Random();
+        ControlVector<control_dim> u = ControlVector<control_dim>::Random();
+        StateVector<state_dim> x_next;
+        discretizer.propagateControlledDynamics(x, 0, u, x_next);
+
+        StateMatrix<state_dim> A;
+        StateControlMatrix<state_dim, control_dim> B;
+        sensitivity.getAandB(x, u, x_next, 0, 1, A, B);
+
+        // the system is linear, hence finite differences of the discretized dynamics are exact up to round-off
+        const double eps = 1e-6;
+        StateMatrix<state_dim> A_fd;
+        StateControlMatrix<state_dim, control_dim> B_fd;
+        StateVector<state_dim> x_perturbed;
+        for (size_t i = 0; i < state_dim; i++)
+        {
+            StateVector<state_dim> dx = eps * StateVector<state_dim>::Unit(i);
+            discretizer.propagateControlledDynamics(x + dx, 0, u, x_perturbed);
+            A_fd.col(i) = (x_perturbed - x_next) / eps;
+        }
+        for (size_t i = 0; i < control_dim; i++)
+        {
+            ControlVector<control_dim> du = eps * ControlVector<control_dim>::Unit(i);
+            discretizer.propagateControlledDynamics(x, 0, u + du, x_perturbed);
+            B_fd.col(i) = (x_perturbed - x_next) / eps;
+        }
+
+        ASSERT_TRUE(A.isApprox(A_fd, 1e-6)) << "A:" << std::endl << A << std::endl << "A_fd:" << std::endl << A_fd;
+        ASSERT_TRUE(B.isApprox(B_fd, 1e-6)) << "B:" << std::endl << B << std::endl << "B_fd:" << std::endl << B_fd;
+
+        // the discrete-time dynamics of a symplectic method preserve the phase space volume
+        ASSERT_NEAR(A.determinant(), 1.0, 1e-10);
+    }
+}
+
+
+TEST(SymplecticIntegrationTest, symplecticSensitivityPendulumTest)
+{
+    const double dt = 0.2;
+    shared_ptr<TestPendulum> pendulum(new TestPendulum(2.0));
+    shared_ptr<SystemLinearizer<state_dim, control_dim>> linearizer(
+        new SystemLinearizer<state_dim, control_dim>(pendulum));
+
+    typedef SensitivityApproximationSettings::APPROXIMATION APPROXIMATION;
+    std::vector<std::pair<IntegrationType, APPROXIMATION>> methods = {{VERLET_SYM, APPROXIMATION::SYMPLECTIC_VERLET},
+        {FOREST_RUTH_SYM, APPROXIMATION::SYMPLECTIC_FOREST_RUTH}, {YOSHIDA4_SYM, APPROXIMATION::SYMPLECTIC_YOSHIDA4},
+        {YOSHIDA6_SYM, APPROXIMATION::SYMPLECTIC_YOSHIDA6}};
+
+    for (const auto& method : methods)
+    {
+        SystemDiscretizer<state_dim, control_dim, p_dim, v_dim> discretizer(pendulum, dt, method.first, 1);
+        discretizer.initialize();
+
+        SensitivityApproximation<state_dim, control_dim, p_dim, v_dim> sensitivity(dt, linearizer, method.second);
+        sensitivity.setControlledSystem(pendulum);
+
+        StateVector<state_dim> x;
+        x << 2.0, -1.0;
+        ControlVector<control_dim> u;
+        u << 0.5;
+        StateVector<state_dim> x_next;
+        discretizer.propagateControlledDynamics(x, 0, u, x_next);
+
+        StateMatrix<state_dim> A;
+        StateControlMatrix<state_dim, control_dim> B;
+        sensitivity.getAandB(x, u, x_next, 0, 1, A, B);
+
+        // central finite differences of the discretized dynamics
+        const double eps = 1e-5;
+        StateMatrix<state_dim> A_fd;
+        StateControlMatrix<state_dim, control_dim> B_fd;
+        StateVector<state_dim> x_plus, x_minus;
+        for (size_t i = 0; i < state_dim; i++)
+        {
+            StateVector<state_dim> dx = eps * StateVector<state_dim>::Unit(i);
+            discretizer.propagateControlledDynamics(x + dx, 0, u, x_plus);
+            discretizer.propagateControlledDynamics(x - dx, 0, u, x_minus);
+            A_fd.col(i) = (x_plus - x_minus) / (2.0 * eps);
+        }
+        for (size_t i = 0; i < control_dim; i++)
+        {
+            ControlVector<control_dim> du = eps * ControlVector<control_dim>::Unit(i);
+            discretizer.propagateControlledDynamics(x, 0, u + du, x_plus);
+            discretizer.propagateControlledDynamics(x, 0, u - du, x_minus);
+            B_fd.col(i) = (x_plus - x_minus) / (2.0 * eps);
+        }
+
+        ASSERT_TRUE(A.isApprox(A_fd, 1e-5)) << "A:" << std::endl << A << std::endl << "A_fd:" << std::endl << A_fd;
+        ASSERT_TRUE(B.isApprox(B_fd, 1e-5)) << "B:" << std::endl << B << std::endl << "B_fd:" << std::endl << B_fd;
+        ASSERT_NEAR(A.determinant(), 1.0, 1e-5);
+
+        // interpolating the stage states between x and x_next is only an approximation for nonlinear systems
+        sensitivity.setControlledSystem(nullptr);
+        sensitivity.getAandB(x, u, x_next, 0, 1, A, B);
+        ASSERT_FALSE(A.isApprox(A_fd, 1e-5));
+    }
+}
+
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,125 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <ct/core/core.h>
+
+// Bring in gtest
+#include <gtest/gtest.h>
+
+using namespace ct::core;
+
+const size_t STATE_DIM = 4;
+const size_t CONTROL_DIM = 2;
+
+
+TEST(MatrixExponentialTest, exponentialTest)
+{
+    // compare against the implementation of Eigen for a range of norms
+    for (double norm : {0.0, 1e-6, 0.3, 1.0, 10.0, 50.0})
+    {
+        for (size_t i = 0; i < 10; i++)
+        {
+            Eigen::Matrix<double, 6, 6> M = Eigen::Matrix<double, 6, 6>::Random();
+            M *= norm / M.norm();
+
+            Eigen::Matrix<double, 6, 6> expM = matrixExponential(M);
+            Eigen::Matrix<double, 6, 6> expMEigen = M.exp();
+            ASSERT_LT((expM - expMEigen).norm(), 1e-12 * expMEigen.norm());
+        }
+    }
+
+    // dynamic size
+    Eigen::MatrixXd M = Eigen::MatrixXd::Random(5, 5);
+    Eigen::MatrixXd expM = matrixExponential(M);
+    ASSERT_TRUE(expM.isApprox(M.exp(), 1e-12));
+
+    // rotation
+    Eigen::Matrix3d omega;
+    omega << 0, -1, 0, 1, 0, 0, 0, 0, 0;
+    Eigen::Matrix3d R = matrixExponential(Eigen::Matrix3d(M_PI / 3 * omega));
+    ASSERT_TRUE(R.isApprox(Eigen::AngleAxisd(M_PI / 3, Eigen::Vector3d::UnitZ()).toRotationMatrix(), 1e-14));
+}
+
+TEST(MatrixExponentialTest, zeroOrderHoldTest)
+{
+    const double dt = 0.1;
+
+    // invertible A, compare against the closed form
+    StateMatrix<STATE_DIM> A = StateMatrix<STATE_DIM>::Random();
+    StateControlMatrix<STATE_DIM, CONTROL_DIM> B = StateControlMatrix<STATE_DIM, CONTROL_DIM>::Random();
+
+    StateMatrix<STATE_DIM> A_discr;
+    StateControlMatrix<STATE_DIM, CONTROL_DIM> B_discr;
+    zeroOrderHoldDiscretization<STATE_DIM, CONTROL_DIM, double>(A, B, dt, A_discr, B_discr);
+
+    StateMatrix<STATE_DIM> Adt = dt * A;
+    ASSERT_TRUE(A_discr.isApprox(Adt.exp(), 1e-12));
+    ASSERT_TRUE(B_discr.isApprox(A.inverse() * (A_discr - StateMatrix<STATE_DIM>::Identity()) * B, 1e-10));
+
+    // singular A, double integrators
+    A.setZero();
+    A.topRightCorner<2, 2>().setIdentity();
+    B.setZero();
+    B.bottomRows<2>().setIdentity();
+    zeroOrderHoldDiscretization<STATE_DIM, CONTROL_DIM, double>(A, B, dt, A_discr, B_discr);
+
+    StateMatrix<STATE_DIM> A_expected = StateMatrix<STATE_DIM>::Identity();
+    A_expected.topRightCorner<2, 2>() = dt * Eigen::Matrix2d::Identity();
+    StateControlMatrix<STATE_DIM, CONTROL_DIM> B_expected;
+    B_expected << 0.5 * dt * dt * Eigen::Matrix2d::Identity(), dt * Eigen::Matrix2d::Identity();
+    ASSERT_TRUE(A_discr.isApprox(A_expected, 1e-14));
+    ASSERT_TRUE(B_discr.isApprox(B_expected, 1e-14));
+}
+
+TEST(MatrixExponentialTest, sensitivityTest)
+{
+    const double dt = 0.1;
+
+    // double integrators, A is singular
+    StateMatrix<STATE_DIM> A = StateMatrix<STATE_DIM>::Zero();
+    A.topRightCorner<2, 2>().setIdentity();
+    StateControlMatrix<STATE_DIM, CONTROL_DIM> B = StateControlMatrix<STATE_DIM, CONTROL_DIM>::Zero();
+    B.bottomRows<2>().setIdentity();
+    std::shared_ptr<LTISystem<STATE_DIM, CONTROL_DIM>> system(new LTISystem<STATE_DIM, CONTROL_DIM>(A, B));
+
+    SensitivityApproximation<STATE_DIM, CONTROL_DIM> sensitivity(
+        dt, system, SensitivityApproximationSettings::APPROXIMATION::MATRIX_EXPONENTIAL);
+
+    StateVector<STATE_DIM> x = StateVector<STATE_DIM>::Random();
+    ControlVector<CONTROL_DIM> u = ControlVector<CONTROL_DIM>::Random();
+    StateMatrix<STATE_DIM> A_discr;
+    StateControlMatrix<STATE_DIM, CONTROL_DIM> B_discr;
+
+    StateMatrix<STATE_DIM> A_expected;
+    StateControlMatrix<STATE_DIM, CONTROL_DIM> B_expected;
+    for (int n = 0; n < 5; n++)
+    {
+        sensitivity.getAandB(x, u, x, n, 1, A_discr, B_discr);
+        zeroOrderHoldDiscretization<STATE_DIM, CONTROL_DIM, double>(A, B, dt, A_expected, B_expected);
+        ASSERT_TRUE(A_discr.allFinite());
+        ASSERT_TRUE(A_discr == A_expected);
+        ASSERT_TRUE(B_discr == B_expected);
+    }
+
+    // the discretization follows changes of the system and the time step
+    system->A()(2, 0) = -1.0;
+    sensitivity.getAandB(x, u, x, 0, 1, A_discr, B_discr);
+    zeroOrderHoldDiscretization<STATE_DIM, CONTROL_DIM, double>(system->A(), B, dt, A_expected, B_expected);
+    ASSERT_TRUE(A_discr == A_expected);
+    ASSERT_TRUE(B_discr == B_expected);
+
+    sensitivity.setTimeDiscretization(0.5 * dt);
+    sensitivity.getAandB(x, u, x, 0, 1, A_discr, B_discr);
+    zeroOrderHoldDiscretization<STATE_DIM, CONTROL_DIM, double>(system->A(), B, 0.5 * dt, A_expected, B_expected);
+    ASSERT_TRUE(A_discr == A_expected);
+    ASSERT_TRUE(B_discr == B_expected);
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
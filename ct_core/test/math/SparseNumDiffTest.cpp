@@ -0,0 +1,203 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <atomic>
+#include <cmath>
+
+#include <ct/core/core.h>
+
+// Bring in gtest
+#include <gtest/gtest.h>
+
+using namespace ct::core;
+
+const size_t N = 12;               //!< number of masses in the chain
+const size_t STATE_DIM = 2 * N;    //!< positions and velocities
+const size_t CONTROL_DIM = N / 2;  //!< a force acts on every second mass
+
+typedef DynamicsLinearizerNumDiff<STATE_DIM, CONTROL_DIM, double, double> Linearizer;
+
+//! a chain of masses connected by nonlinear springs, each mass only interacts with its neighbors
+void chainDynamics(const StateVector<STATE_DIM>& x, const double& t, const ControlVector<CONTROL_DIM>& u,
+    StateVector<STATE_DIM>& dx)
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        double force = -0.1 * x(N + i) + std::sin(x(i));
+        if (i > 0)
+            force += std::pow(x(i - 1) - x(i), 3);
+        if (i < N - 1)
+            force += std::pow(x(i + 1) - x(i), 3);
+        if (i % 2 == 0)
+            force += u(i / 2) * (1.0 + x(i) * x(i));
+
+        dx(i) = x(N + i);
+        dx(N + i) = force;
+    }
+}
+
+TEST(SparseNumDiffTest, coloringTest)
+{
+    // tridiagonal matrix
+    Eigen::Matrix<bool, 10, 10> pattern;
+    pattern.setConstant(false);
+    for (int i = 0; i < 10; i++)
+        for (int j = std::max(0, i - 1); j < std::min(10, i + 2); j++)
+            pattern(i, j) = true;
+
+    JacobianColoring coloring(pattern);
+    ASSERT_TRUE(coloring.initialized());
+    ASSERT_EQ(coloring.numColors(), 3u);
+
+    // the columns of a color are structurally orthogonal
+    size_t nColumns = 0;
+    for (size_t c = 0; c < coloring.numColors(); c++)
+    {
+        Eigen::VectorXi rowCount = Eigen::VectorXi::Zero(10);
+        for (size_t j : coloring.columns(c))
+        {
+            ASSERT_EQ(coloring.color(j), c);
+            rowCount += pattern.col(j).cast<int>();
+            nColumns++;
+        }
+        ASSERT_LE(rowCount.maxCoeff(), 1);
+    }
+    ASSERT_EQ(nColumns, 10u);
+
+    // a dense column requires a color of its own
+    pattern.col(4).setConstant(true);
+    coloring.init(pattern);
+    ASSERT_EQ(coloring.columns(coloring.color(4)).size(), 1u);
+
+    coloring.clear();
+    ASSERT_FALSE(coloring.initialized());
+}
+
+TEST(SparseNumDiffTest, linearizerTest)
+{
+    size_t nEvaluations = 0;
+    auto dynamics = [&](const StateVector<STATE_DIM>& x, const double& t, const ControlVector<CONTROL_DIM>& u,
+        StateVector<STATE_DIM>& dx) {
+        nEvaluations++;
+        chainDynamics(x, t, u, dx);
+    };
+
+    StateVector<STATE_DIM> x = StateVector<STATE_DIM>::Random();
+    ControlVector<CONTROL_DIM> u = ControlVector<CONTROL_DIM>::Random();
+
+    for (bool doubleSided : {true, false})
+    {
+        Linearizer dense(dynamics, doubleSided);
+        StateMatrix<STATE_DIM> A = dense.getDerivativeState(x, u);
+        StateControlMatrix<STATE_DIM, CONTROL_DIM> B = dense.getDerivativeControl(x, u);
+
+        Linearizer sparse(dynamics, doubleSided);
+        sparse.detectSparsityPattern(x, u);
+
+        // the acceleration of a mass depends on three positions and a velocity, every column of B has a single entry
+        ASSERT_EQ(sparse.getColoringState().pattern().count(), N + N + (3 * N - 2));
+        ASSERT_EQ(sparse.getColoringState().numColors(), 4u);
+        ASSERT_EQ(sparse.getColoringControl().numColors(), 1u);
+
+        nEvaluations = 0;
+        const StateMatrix<STATE_DIM>& A_sparse = sparse.getDerivativeState(x, u);
+        const StateControlMatrix<STATE_DIM, CONTROL_DIM>& B_sparse = sparse.getDerivativeControl(x, u);
+        ASSERT_EQ(nEvaluations, (doubleSided ? 2 : 1) * (4 + 1) + (doubleSided ? 0 : 2));
+
+        ASSERT_LT((A - A_sparse).cwiseAbs().maxCoeff(), 1e-6);
+        ASSERT_LT((B - B_sparse).cwiseAbs().maxCoeff(), 1e-6);
+
+        // copies keep the pattern
+        Linearizer copy(sparse);
+        ASSERT_EQ(copy.getColoringState().numColors(), 4u);
+        ASSERT_TRUE(copy.getDerivativeState(x, u) == A_sparse);
+    }
+}
+
+TEST(SparseNumDiffTest, multiThreadingTest)
+{
+    std::atomic<size_t> nEvaluations(0);
+    auto dynamics = [&](const StateVector<STATE_DIM>& x, const double& t, const ControlVector<CONTROL_DIM>& u,
+        StateVector<STATE_DIM>& dx) {
+        nEvaluations++;
+        chainDynamics(x, t, u, dx);
+    };
+
+    StateVector<STATE_DIM> x = StateVector<STATE_DIM>::Random();
+    ControlVector<CONTROL_DIM> u = ControlVector<CONTROL_DIM>::Random();
+
+    Linearizer linearizer(dynamics);
+    StateMatrix<STATE_DIM> A = linearizer.getDerivativeState(x, u);
+    StateControlMatrix<STATE_DIM, CONTROL_DIM> B = linearizer.getDerivativeControl(x, u);
+
+    // the result does not depend on the number of threads, neither dense nor colored
+    for (bool colored : {false, true})
+    {
+        if (colored)
+            linearizer.detectSparsityPattern(x, u);
+
+        for (size_t nThreads : {2, 3, 8})
+        {
+            linearizer.setNumThreads(nThreads);
+            nEvaluations = 0;
+            ASSERT_TRUE(linearizer.getDerivativeState(x, u).isApprox(A, 1e-6));
+            ASSERT_TRUE(linearizer.getDerivativeControl(x, u).isApprox(B, 1e-6));
+            ASSERT_EQ(nEvaluations.load(), colored ? 2u * (4 + 1) : 2u * (STATE_DIM + CONTROL_DIM));
+        }
+        linearizer.setNumThreads(1);
+    }
+}
+
+TEST(SparseNumDiffTest, derivativesNumDiffTest)
+{
+    typedef DerivativesNumDiff<STATE_DIM, STATE_DIM> Derivatives;
+
+    ControlVector<CONTROL_DIM> u = ControlVector<CONTROL_DIM>::Random();
+    std::atomic<size_t> nEvaluations(0);
+    Derivatives::Function f = [&](const Derivatives::IN_TYPE& x) {
+        nEvaluations++;
+        StateVector<STATE_DIM> dx;
+        chainDynamics(x, 0.0, u, dx);
+        return Derivatives::OUT_TYPE(dx);
+    };
+
+    Eigen::VectorXd x = Eigen::VectorXd::Random(STATE_DIM);
+
+    for (bool doubleSided : {true, false})
+    {
+        Derivatives dense(f, doubleSided);
+        Derivatives::JAC_TYPE jac = dense.jacobian(x);
+
+        Derivatives sparse(f, doubleSided);
+        sparse.detectSparsityPattern(x);
+        ASSERT_EQ(sparse.getColoring().numColors(), 4u);
+
+        for (size_t nThreads : {1, 3})
+        {
+            sparse.setNumThreads(nThreads);
+            nEvaluations = 0;
+            ASSERT_LT((sparse.jacobian(x) - jac).cwiseAbs().maxCoeff(), 1e-6);
+            ASSERT_EQ(nEvaluations.load(), doubleSided ? 8u : 5u);
+        }
+
+        // a user defined pattern with a missing entry yields a zero entry
+        Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> pattern = sparse.getColoring().pattern();
+        pattern(N, 0) = false;
+        sparse.setSparsityPattern(pattern);
+        ASSERT_EQ(sparse.jacobian(x)(N, 0), 0.0);
+
+        sparse.clearSparsityPattern();
+        nEvaluations = 0;
+        ASSERT_TRUE(sparse.jacobian(x).isApprox(jac));
+        ASSERT_EQ(nEvaluations.load(), (doubleSided ? 2 : 1) * STATE_DIM + (doubleSided ? 0 : 1));
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,172 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+
+#include <ct/core/core.h>
+
+// Bring in gtest
+#include <gtest/gtest.h>
+
+using namespace ct::core;
+
+typedef SecondOrderSystem Oscillator;
+typedef EnsembleSimulator<Oscillator> Simulator;
+
+const double sigma = 0.1;
+
+std::shared_ptr<Oscillator> createSystem()
+{
+    FeedbackMatrix<2, 1> K;
+    K << -0.5, -0.1;
+    std::shared_ptr<ConstantStateFeedbackController<2, 1>> controller(
+        new ConstantStateFeedbackController<2, 1>(ControlVector<1>::Zero(), StateVector<2>::Zero(), K));
+    return std::shared_ptr<Oscillator>(new Oscillator(10.0, 0.1, 1.0, controller));
+}
+
+//! samples the initial state around the nominal one
+void sampleInitialState(size_t rollout, Simulator::Engine& engine, StateVector<2>& x0, Oscillator& system)
+{
+    std::normal_distribution<double> normal(0.0, sigma);
+    x0(0) += normal(engine);
+    x0(1) += normal(engine);
+}
+
+Simulator::Settings createSettings(size_t nThreads)
+{
+    Simulator::Settings settings;
+    settings.nThreads = nThreads;
+    settings.simDt = 0.001;
+    settings.controlDt = 0.01;
+    settings.duration = 1.0;
+    settings.seed = 42;
+    return settings;
+}
+
+
+TEST(EnsembleSimulatorTest, reproducibilityTest)
+{
+    StateVector<2> x0;
+    x0 << 1.0, 0.0;
+    const size_t nRollouts = 20;
+
+    Simulator::Result reference;
+    Simulator simulator(createSystem(), createSettings(1));
+    simulator.setInitializeFunction(sampleInitialState);
+    simulator.simulate(x0, nRollouts, reference);
+
+    ASSERT_EQ(reference.times.size(), 101u);
+    ASSERT_EQ(reference.finalStates.cols(), nRollouts);
+
+    // the rollouts do not depend on the number of threads
+    for (size_t nThreads : {2, 3, 8})
+    {
+        Simulator::Result result;
+        Simulator parallelSimulator(createSystem(), createSettings(nThreads));
+        parallelSimulator.setInitializeFunction(sampleInitialState);
+        parallelSimulator.simulate(x0, nRollouts, result);
+
+        ASSERT_TRUE(result.finalStates == reference.finalStates);
+        ASSERT_TRUE(result.mean.isApprox(reference.mean, 1e-12));
+        ASSERT_TRUE(result.standardDeviation.isApprox(reference.standardDeviation, 1e-12));
+
+        // repeated simulations give identical results
+        Simulator::Result repeated;
+        parallelSimulator.simulate(x0, nRollouts, repeated);
+        ASSERT_TRUE(repeated.finalStates == result.finalStates);
+        ASSERT_TRUE(repeated.mean == result.mean);
+    }
+}
+
+TEST(EnsembleSimulatorTest, trajectoryTest)
+{
+    StateVector<2> x0;
+    x0 << 1.0, 0.0;
+    Simulator::Settings settings = createSettings(4);
+    settings.recordTrajectories = true;
+
+    Simulator::Result result;
+    Simulator simulator(createSystem(), settings);
+    simulator.setInitializeFunction(sampleInitialState);
+    simulator.simulate(x0, 10, result);
+    ASSERT_EQ(result.trajectories.size(), 10u);
+
+    // every rollout can be reproduced from its random engine
+    std::shared_ptr<Oscillator> system = createSystem();
+    Integrator<2> integrator(system, settings.integrationType);
+    for (size_t r = 0; r < 10; r++)
+    {
+        Simulator::Engine engine = Simulator::rolloutEngine(settings.seed, r);
+        StateVector<2> x = x0;
+        sampleInitialState(r, engine, x, *system);
+        ASSERT_TRUE(result.trajectories[r].col(0) == x);
+
+        integrator.integrate_n_steps(x, 0.0, 1000, 0.001);
+        ASSERT_TRUE(x.isApprox(result.finalStates.col(r), 1e-12));
+        ASSERT_TRUE(result.trajectories[r].col(100) == result.finalStates.col(r));
+        ASSERT_FALSE(result.diverged[r]);
+    }
+}
+
+TEST(EnsembleSimulatorTest, statisticsTest)
+{
+    StateVector<2> x0;
+    x0 << 1.0, 0.0;
+    const size_t nRollouts = 400;
+
+    Simulator::Result result;
+    Simulator simulator(createSystem(), createSettings(0));
+    simulator.setInitializeFunction(sampleInitialState);
+    simulator.simulate(x0, nRollouts, result);
+
+    // the system is linear, hence the mean follows the nominal trajectory
+    std::shared_ptr<Oscillator> system = createSystem();
+    Integrator<2> integrator(system, RK4);
+    StateVector<2> x = x0;
+    for (size_t k = 0; k < 100; k++)
+    {
+        ASSERT_NEAR(result.mean(0, k), x(0), 5 * result.standardDeviation(0, k) / std::sqrt(nRollouts));
+        integrator.integrate_n_steps(x, k * 0.01, 10, 0.001);
+    }
+
+    ASSERT_NEAR(result.standardDeviation(0, 0), sigma, 0.2 * sigma);
+    ASSERT_NEAR(result.standardDeviation(1, 0), sigma, 0.2 * sigma);
+}
+
+TEST(EnsembleSimulatorTest, disturbanceTest)
+{
+    StateVector<2> x0;
+    x0 << 1.0, 0.0;
+
+    Simulator::Result result;
+    Simulator simulator(createSystem(), createSettings(3));
+
+    // noise on the velocity, rollout 3 diverges
+    simulator.setDisturbanceFunction(
+        [](size_t rollout, size_t step, const double& t, Simulator::Engine& engine, StateVector<2>& x) {
+            GaussianNoise noise(0.0, 0.01);
+            noise.seed(engine());
+            x(1) += noise();
+            if (rollout == 3 && step == 50)
+                x(1) = std::numeric_limits<double>::quiet_NaN();
+        });
+    simulator.simulate(x0, 20, result);
+
+    for (size_t r = 0; r < 20; r++)
+        ASSERT_EQ(result.diverged[r], r == 3);
+
+    ASSERT_TRUE(result.mean.allFinite());
+    ASSERT_GT(result.standardDeviation(1, 100), 0.0);
+
+    // the nominal rollout without disturbances
+    Simulator::Result nominal;
+    Simulator nominalSimulator(createSystem(), createSettings(3));
+    nominalSimulator.simulate(x0, 1, nominal);
+    ASSERT_FALSE(result.finalStates.col(0).isApprox(nominal.finalStates.col(0)));
+    ASSERT_TRUE(nominal.standardDeviation.isZero());
+}
@@ -27,6 +27,10 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #define CT_L0 fr_Link1
 #define CT_L1 fr_Link2
 
+// link names as in robcogen without frame prefix, required to access the link inertias by id
+#define CT_L0_NAME Link1
+#define CT_L1_NAME Link2
+
 // define single end effector (could also be multiple)
 #define CT_N_EE 1
 #define CT_EE0 fr_ee
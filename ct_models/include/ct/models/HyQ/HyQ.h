@@ -41,6 +41,21 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #define CT_L10 fr_RH_upperleg
 #define CT_L11 fr_RH_lowerleg
 
+// link names as in robcogen without frame prefix, required to access the link inertias by id
+#define CT_BASE_NAME trunk
+#define CT_L0_NAME LF_hipassembly
+#define CT_L1_NAME LF_upperleg
+#define CT_L2_NAME LF_lowerleg
+#define CT_L3_NAME RF_hipassembly
+#define CT_L4_NAME RF_upperleg
+#define CT_L5_NAME RF_lowerleg
+#define CT_L6_NAME LH_hipassembly
+#define CT_L7_NAME LH_upperleg
+#define CT_L8_NAME LH_lowerleg
+#define CT_L9_NAME RH_hipassembly
+#define CT_L10_NAME RH_upperleg
+#define CT_L11_NAME RH_lowerleg
+
 // number of endeffectors
 #define CT_N_EE 4
 
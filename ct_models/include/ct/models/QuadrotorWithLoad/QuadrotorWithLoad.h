@@ -24,8 +24,13 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 
 // define the links
 #define CT_BASE fr_body
-#define CT_L0 link1
-#define CT_L1 link2
+#define CT_L0 fr_link1
+#define CT_L1 fr_link2
+
+// link names as in robcogen without frame prefix, required to access the link inertias by id
+#define CT_BASE_NAME body
+#define CT_L0_NAME link1
+#define CT_L1_NAME link2
 
 // define first end effector, the endeffector frame
 #define CT_N_EE 1
@@ -0,0 +1,248 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ct {
+namespace models {
+
+/*!
+ * \brief Statistics of a benchmarked function
+ *
+ * All latencies are given in nanoseconds per call.
+ */
+struct BenchmarkResult
+{
+    std::string name;         //!< name of the benchmark, by convention <model>/<function>/<method>
+    size_t samples = 0;       //!< number of timed calls
+    double mean = 0.0;        //!< mean latency
+    double min = 0.0;         //!< minimum latency
+    double p50 = 0.0;         //!< median latency
+    double p90 = 0.0;         //!< 90th percentile of the latency
+    double p99 = 0.0;         //!< 99th percentile of the latency
+    double max = 0.0;         //!< maximum latency
+    double throughput = 0.0;  //!< calls per second on a single core
+    long rss = 0;             //!< resident set size after the benchmark [kB]
+    long peakIncrease = 0;    //!< increase of the peak resident set size during the benchmark [kB]
+};
+
+/*!
+ * \brief Runs and reports latency benchmarks
+ *
+ * Every call of the benchmarked function is timed individually, such that latency percentiles can be reported.
+ * Results are written as CSV with one line per benchmark, which can be read back as baseline to detect performance
+ * regressions, e.g. when upgrading a dependency or the compiler.
+ *
+ * \code{.cpp}
+ * ct::models::ModelBenchmark benchmark;
+ * benchmark.run("HyQ/ForwardDynamics/raw", [&](size_t i) { system->computeControlledDynamics(x[i], 0.0, u[i], xd); });
+ * ct::models::ModelBenchmark::writeCsv(std::cout, benchmark.results());
+ * \endcode
+ */
+class ModelBenchmark
+{
+public:
+    struct Settings
+    {
+        Settings() : samples(10000), warmup(100) {}
+        size_t samples;      //!< number of timed calls per benchmark
+        size_t warmup;       //!< number of untimed calls before timing starts
+        std::string filter;  //!< only benchmarks whose name contains the filter are run
+    };
+
+    ModelBenchmark(const Settings& settings = Settings()) : settings_(settings) {}
+    const Settings& settings() const { return settings_; }
+    const std::vector<BenchmarkResult>& results() const { return results_; }
+    //! true if a benchmark of this name is run with the current filter
+    bool enabled(const std::string& name) const { return name.find(settings_.filter) != std::string::npos; }
+    //! true if any of the benchmarks is run with the current filter
+    bool anyEnabled(const std::vector<std::string>& names) const
+    {
+        for (const std::string& name : names)
+            if (enabled(name))
+                return true;
+        return false;
+    }
+    /*!
+     * \brief Times call(i) for i = 0 ... samples-1
+     *
+     * The benchmark is skipped if its name does not match the filter. The caller is responsible for preparing the
+     * inputs of all samples beforehand, such that only the function itself is timed.
+     */
+    void run(const std::string& name, const std::function<void(size_t)>& call)
+    {
+        if (!enabled(name))
+            return;
+
+        for (size_t i = 0; i < std::min(settings_.warmup, settings_.samples); i++)
+            call(i);
+
+        const long peak = readStatus("VmHWM:");
+
+        std::vector<double> latencies(settings_.samples);
+        for (size_t i = 0; i < settings_.samples; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            call(i);
+            auto end = std::chrono::steady_clock::now();
+            latencies[i] = std::chrono::duration<double, std::nano>(end - start).count();
+        }
+
+        BenchmarkResult result = evaluate(name, latencies);
+        result.rss = readStatus("VmRSS:");
+        result.peakIncrease = readStatus("VmHWM:") - peak;
+        results_.push_back(result);
+
+        std::cerr << name << ": median " << result.p50 << " ns, p99 " << result.p99 << " ns" << std::endl;
+    }
+
+    //! computes the statistics of the measured latencies
+    static BenchmarkResult evaluate(const std::string& name, std::vector<double> latencies)
+    {
+        BenchmarkResult result;
+        result.name = name;
+        result.samples = latencies.size();
+        if (latencies.empty())
+            return result;
+
+        std::sort(latencies.begin(), latencies.end());
+
+        double sum = 0.0;
+        for (const double latency : latencies)
+            sum += latency;
+
+        result.mean = sum / latencies.size();
+        result.min = latencies.front();
+        result.p50 = percentile(latencies, 0.5);
+        result.p90 = percentile(latencies, 0.9);
+        result.p99 = percentile(latencies, 0.99);
+        result.max = latencies.back();
+        result.throughput = 1e9 / result.mean;
+        return result;
+    }
+
+    //! the p-th percentile (0 <= p <= 1) of sorted data, using linear interpolation
+    static double percentile(const std::vector<double>& sorted, double p)
+    {
+        const double index = p * (sorted.size() - 1);
+        const size_t lower = static_cast<size_t>(std::floor(index));
+        const size_t upper = std::min(lower + 1, sorted.size() - 1);
+        return sorted[lower] + (index - lower) * (sorted[upper] - sorted[lower]);
+    }
+
+    static void writeCsv(std::ostream& stream, const std::vector<BenchmarkResult>& results)
+    {
+        stream << "name,samples,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,max_ns,calls_per_s,rss_kb,peak_increase_kb"
+               << std::endl;
+        for (const BenchmarkResult& r : results)
+        {
+            stream << r.name << "," << r.samples << "," << r.mean << "," << r.min << "," << r.p50 << "," << r.p90
+                   << "," << r.p99 << "," << r.max << "," << r.throughput << "," << r.rss << "," << r.peakIncrease
+                   << std::endl;
+        }
+    }
+
+    //! reads results written by writeCsv()
+    static std::vector<BenchmarkResult> readCsv(std::istream& stream)
+    {
+        std::vector<BenchmarkResult> results;
+        std::string line;
+        std::getline(stream, line);  // header
+
+        while (std::getline(stream, line))
+        {
+            if (line.empty())
+                continue;
+
+            std::replace(line.begin(), line.end(), ',', ' ');
+            std::istringstream fields(line);
+            BenchmarkResult r;
+            if (!(fields >> r.name >> r.samples >> r.mean >> r.min >> r.p50 >> r.p90 >> r.p99 >> r.max >>
+                    r.throughput >> r.rss >> r.peakIncrease))
+                throw std::runtime_error("ModelBenchmark: invalid line in benchmark results: " + line);
+            results.push_back(r);
+        }
+        return results;
+    }
+
+    static std::vector<BenchmarkResult> readCsv(const std::string& file)
+    {
+        std::ifstream stream(file);
+        if (!stream.good())
+            throw std::runtime_error("ModelBenchmark: could not open " + file);
+        return readCsv(stream);
+    }
+
+    /*!
+     * \brief Compares results against a baseline
+     *
+     * The median latency is compared, since it is robust against outliers caused by other processes.
+     *
+     * @param results the current results
+     * @param baseline the baseline results, benchmarks missing in either set are ignored
+     * @param tolerance the allowed relative increase of the median latency
+     * @param stream the comparison of every benchmark is printed to this stream
+     * @return the number of benchmarks whose median latency increased by more than the tolerance
+     */
+    static size_t compare(const std::vector<BenchmarkResult>& results,
+        const std::vector<BenchmarkResult>& baseline,
+        double tolerance,
+        std::ostream& stream)
+    {
+        std::map<std::string, const BenchmarkResult*> reference;
+        for (const BenchmarkResult& r : baseline)
+            reference[r.name] = &r;
+
+        size_t regressions = 0;
+        stream << "name,baseline_p50_ns,p50_ns,change,status" << std::endl;
+        for (const BenchmarkResult& r : results)
+        {
+            auto it = reference.find(r.name);
+            if (it == reference.end() || it->second->p50 <= 0.0)
+                continue;
+
+            const double change = r.p50 / it->second->p50 - 1.0;
+            const bool regressed = change > tolerance;
+            if (regressed)
+                regressions++;
+
+            stream << r.name << "," << it->second->p50 << "," << r.p50 << "," << change << ","
+                   << (regressed ? "REGRESSION" : "ok") << std::endl;
+        }
+        return regressions;
+    }
+
+private:
+    //! reads a memory entry [kB] of /proc/self/status, returns 0 if not available
+    static long readStatus(const std::string& key)
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, key.size(), key) == 0)
+                return std::stol(line.substr(key.size()));
+        }
+        return 0;
+    }
+
+    Settings settings_;
+    std::vector<BenchmarkResult> results_;
+};
+
+}  // namespace models
+}  // namespace ct
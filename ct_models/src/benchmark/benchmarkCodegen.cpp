@@ -0,0 +1,13 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include "benchmarkModels.h"
+
+// generates the kernels of one benchmarked model, CMake defines the model and the name of the generated classes
+int main(int argc, char* argv[])
+{
+    ct::rbd::RBDCodegen<CT_MODELS_BENCHMARK_DYNAMICS> codegen(CT_MODELS_BENCHMARK_NAME, "models", "benchmark");
+    return codegen.run(argc, argv);
+}
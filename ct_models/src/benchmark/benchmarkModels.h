@@ -0,0 +1,38 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <ct/rbd/rbd.h>
+
+#include <ct/models/HyQ/HyQ.h>
+#include <ct/models/HyA/HyA.h>
+#include <ct/models/InvertedPendulum/InvertedPendulum.h>
+#include <ct/models/DoubleInvertedPendulum/DoubleInvertedPendulum.h>
+#include <ct/models/QuadrotorWithLoad/QuadrotorWithLoad.h>
+
+namespace ct {
+namespace models {
+namespace benchmark {
+
+// the RobCoGen dynamics of all benchmarked models, named <model>Dynamics
+template <typename SCALAR>
+using HyQDynamics = ct::rbd::HyQ::tpl::Dynamics<SCALAR>;
+
+template <typename SCALAR>
+using HyADynamics = ct::rbd::HyA::tpl::Dynamics<SCALAR>;
+
+template <typename SCALAR>
+using InvertedPendulumDynamics = ct::rbd::InvertedPendulum::tpl::Dynamics<SCALAR>;
+
+template <typename SCALAR>
+using DoubleInvertedPendulumDynamics = ct::rbd::DoubleInvertedPendulum::tpl::Dynamics<SCALAR>;
+
+template <typename SCALAR>
+using QuadrotorWithLoadDynamics = ct::rbd::quadrotor::tpl::Dynamics<SCALAR>;
+
+}  // namespace benchmark
+}  // namespace models
+}  // namespace ct
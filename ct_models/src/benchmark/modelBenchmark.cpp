@@ -0,0 +1,471 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+/*!
+ * Benchmarks the forward dynamics, inverse dynamics, forward kinematics and linearization of all models in ct_models.
+ *
+ * The RobCoGen models (HyQ, HyA, InvertedPendulum, DoubleInvertedPendulum, QuadrotorWithLoad) are benchmarked for
+ * all functions. The Quadrotor is a plain ODE without inverse dynamics or kinematics and only available in double,
+ * hence only its forward dynamics and linearization are benchmarked. For the Irb4600, ct_models only contains the
+ * IKFast kinematics, hence its forward and inverse kinematics are benchmarked.
+ *
+ * Every function is evaluated with all available methods:
+ *  - raw: the plain double implementation, numerical differentiation for derivatives
+ *  - rbd, analytical: the RbdLinearizer, numerical or analytical (fixed base only), the analytical Jacobians of the
+ *    Quadrotor
+ *  - ad-forward, ad-reverse: derivatives of a CppAD tape, forward or reverse mode (requires CPPAD)
+ *  - codegen-forward, codegen-reverse: code generated kernels, forward or reverse mode (requires CPPADCG)
+ *
+ * Benchmark names are <model>/<function>/<method>. The results are written as CSV, see ct::models::ModelBenchmark.
+ *
+ * usage: modelBenchmark [--samples N] [--warmup N] [--filter STRING] [--output FILE] [--baseline FILE]
+ *                       [--tolerance T]
+ *
+ * The results are written to modelBenchmark.csv unless specified otherwise. Progress is reported on stderr.
+ *
+ * With --baseline, the median latencies are compared to a previous run and the exit code is 1 if any benchmark is
+ * slower than the baseline by more than the tolerance (default 0.1, i.e. 10%).
+ */
+
+#include <cstdlib>
+#include <random>
+
+#include <ct/models/benchmark/ModelBenchmark.h>
+
+#include <ct/models/Irb4600/Irb4600InverseKinematics.h>
+#include <ct/models/Quadrotor/QuadrotorLinear.hpp>
+
+#include "benchmarkModels.h"
+
+#ifdef CT_MODELS_BENCHMARK_CODEGEN
+#include "HyQBenchmarkForwardZero.h"
+#include "HyQBenchmarkInverseDynJacForward.h"
+#include "HyQBenchmarkInverseDynJacReverse.h"
+#include "HyQBenchmarkForwardKinJacForward.h"
+#include "HyQBenchmarkForwardKinJacReverse.h"
+#include "HyQBenchmarkLinearizedForward.h"
+#include "HyQBenchmarkLinearizedReverse.h"
+#include "HyABenchmarkForwardZero.h"
+#include "HyABenchmarkInverseDynJacForward.h"
+#include "HyABenchmarkInverseDynJacReverse.h"
+#include "HyABenchmarkForwardKinJacForward.h"
+#include "HyABenchmarkForwardKinJacReverse.h"
+#include "HyABenchmarkLinearizedForward.h"
+#include "HyABenchmarkLinearizedReverse.h"
+#include "InvertedPendulumBenchmarkForwardZero.h"
+#include "InvertedPendulumBenchmarkInverseDynJacForward.h"
+#include "InvertedPendulumBenchmarkInverseDynJacReverse.h"
+#include "InvertedPendulumBenchmarkForwardKinJacForward.h"
+#include "InvertedPendulumBenchmarkForwardKinJacReverse.h"
+#include "InvertedPendulumBenchmarkLinearizedForward.h"
+#include "InvertedPendulumBenchmarkLinearizedReverse.h"
+#include "DoubleInvertedPendulumBenchmarkForwardZero.h"
+#include "DoubleInvertedPendulumBenchmarkInverseDynJacForward.h"
+#include "DoubleInvertedPendulumBenchmarkInverseDynJacReverse.h"
+#include "DoubleInvertedPendulumBenchmarkForwardKinJacForward.h"
+#include "DoubleInvertedPendulumBenchmarkForwardKinJacReverse.h"
+#include "DoubleInvertedPendulumBenchmarkLinearizedForward.h"
+#include "DoubleInvertedPendulumBenchmarkLinearizedReverse.h"
+#include "QuadrotorWithLoadBenchmarkForwardZero.h"
+#include "QuadrotorWithLoadBenchmarkInverseDynJacForward.h"
+#include "QuadrotorWithLoadBenchmarkInverseDynJacReverse.h"
+#include "QuadrotorWithLoadBenchmarkForwardKinJacForward.h"
+#include "QuadrotorWithLoadBenchmarkForwardKinJacReverse.h"
+#include "QuadrotorWithLoadBenchmarkLinearizedForward.h"
+#include "QuadrotorWithLoadBenchmarkLinearizedReverse.h"
+#endif
+
+using namespace ct::models;
+
+//! the code generated kernels of a model, methods whose kernel is not set are skipped
+template <class KERNELS>
+struct GeneratedKernels
+{
+    typedef ct::core::Derivatives<KERNELS::FD_IN_DIM, KERNELS::FD_OUT_DIM, double> ForwardDynamics;
+    typedef ct::core::Derivatives<KERNELS::ID_IN_DIM, KERNELS::ID_OUT_DIM, double> InverseDynamics;
+    typedef ct::core::Derivatives<KERNELS::FK_IN_DIM, KERNELS::FK_OUT_DIM, double> ForwardKinematics;
+    typedef ct::core::LinearSystem<KERNELS::STATE_DIM, KERNELS::CONTROL_DIM> Linearization;
+
+    std::shared_ptr<ForwardDynamics> forwardZero;
+    std::shared_ptr<InverseDynamics> inverseDynJacForward;
+    std::shared_ptr<InverseDynamics> inverseDynJacReverse;
+    std::shared_ptr<ForwardKinematics> forwardKinJacForward;
+    std::shared_ptr<ForwardKinematics> forwardKinJacReverse;
+    std::shared_ptr<Linearization> linearizedForward;
+    std::shared_ptr<Linearization> linearizedReverse;
+};
+
+#ifdef CT_MODELS_BENCHMARK_CODEGEN
+#define CT_MODELS_BENCHMARK_GENERATED_KERNELS(MODEL, kernels)                                            \
+    kernels.forwardZero.reset(new ct::models::benchmark::MODEL##BenchmarkForwardZero);                   \
+    kernels.inverseDynJacForward.reset(new ct::models::benchmark::MODEL##BenchmarkInverseDynJacForward); \
+    kernels.inverseDynJacReverse.reset(new ct::models::benchmark::MODEL##BenchmarkInverseDynJacReverse); \
+    kernels.forwardKinJacForward.reset(new ct::models::benchmark::MODEL##BenchmarkForwardKinJacForward); \
+    kernels.forwardKinJacReverse.reset(new ct::models::benchmark::MODEL##BenchmarkForwardKinJacReverse); \
+    kernels.linearizedForward.reset(new ct::models::benchmark::MODEL##BenchmarkLinearizedForward);       \
+    kernels.linearizedReverse.reset(new ct::models::benchmark::MODEL##BenchmarkLinearizedReverse)
+#else
+#define CT_MODELS_BENCHMARK_GENERATED_KERNELS(MODEL, kernels)
+#endif
+
+
+#ifdef CPPAD
+//! a function recorded on a CppAD tape, whose Jacobian is evaluated column-wise (forward) or row-wise (reverse)
+template <int IN_DIM, int OUT_DIM>
+class TapedFunction
+{
+public:
+    typedef Eigen::Matrix<ct::core::ADScalar, IN_DIM, 1> ADIn;
+    typedef Eigen::Matrix<ct::core::ADScalar, OUT_DIM, 1> ADOut;
+    typedef Eigen::Matrix<double, IN_DIM, 1> In;
+    typedef Eigen::Matrix<double, OUT_DIM, IN_DIM> Jacobian;
+
+    TapedFunction(const std::function<ADOut(const ADIn&)>& f)
+    {
+        // record at a generic point, the tape of the models does not depend on it
+        Eigen::Matrix<ct::core::ADScalar, Eigen::Dynamic, 1> x(IN_DIM);
+        for (int i = 0; i < IN_DIM; i++)
+            x(i) = 0.1 * (i + 1);
+        CppAD::Independent(x);
+
+        Eigen::Matrix<ct::core::ADScalar, Eigen::Dynamic, 1> y = f(ADIn(x));
+        fun_.Dependent(x, y);
+        fun_.optimize();
+    }
+
+    Eigen::VectorXd forwardZero(const In& x) { return fun_.Forward(0, Eigen::VectorXd(x)); }
+    //! Jacobian w.r.t. the first nCols inputs by forward sweeps
+    void jacobianForward(const In& x, Jacobian& jac, int nCols = IN_DIM)
+    {
+        fun_.Forward(0, Eigen::VectorXd(x));
+        Eigen::VectorXd dx = Eigen::VectorXd::Zero(IN_DIM);
+        for (int j = 0; j < nCols; j++)
+        {
+            dx(j) = 1.0;
+            jac.col(j) = fun_.Forward(1, dx);
+            dx(j) = 0.0;
+        }
+    }
+
+    //! Jacobian by reverse sweeps
+    void jacobianReverse(const In& x, Jacobian& jac)
+    {
+        fun_.Forward(0, Eigen::VectorXd(x));
+        Eigen::VectorXd w = Eigen::VectorXd::Zero(OUT_DIM);
+        for (int i = 0; i < OUT_DIM; i++)
+        {
+            w(i) = 1.0;
+            jac.row(i) = fun_.Reverse(1, w).transpose();
+            w(i) = 0.0;
+        }
+    }
+
+private:
+    CppAD::ADFun<double> fun_;
+};
+#endif
+
+
+template <typename VECTOR>
+std::vector<VECTOR, Eigen::aligned_allocator<VECTOR>> randomSamples(size_t n, std::mt19937& generator)
+{
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<VECTOR, Eigen::aligned_allocator<VECTOR>> samples(n);
+    for (VECTOR& sample : samples)
+        sample = VECTOR::NullaryExpr([&]() { return distribution(generator); });
+    return samples;
+}
+
+template <template <typename> class DYNAMICS>
+void benchmarkModel(const std::string& model,
+    ModelBenchmark& benchmark,
+    const GeneratedKernels<ct::rbd::RBDCodegenKernels<DYNAMICS>>& generated)
+{
+    typedef ct::rbd::RBDCodegenKernels<DYNAMICS> Kernels;
+    const size_t STATE_DIM = Kernels::STATE_DIM;
+    const size_t CONTROL_DIM = Kernels::CONTROL_DIM;
+    typedef Eigen::Matrix<double, Kernels::ID_IN_DIM, 1> IdIn;
+    typedef Eigen::Matrix<double, Kernels::FK_IN_DIM, 1> FkIn;
+    typedef Eigen::Matrix<double, Kernels::FD_IN_DIM, 1> FdIn;
+    typedef typename Kernels::template System<double> System;
+
+    Kernels kernels;
+    std::shared_ptr<System> system = kernels.template createSystem<double>();
+    DYNAMICS<double> dynamics;
+    typename DYNAMICS<double>::Kinematics_t& kinematics = dynamics.kinematics();
+
+    std::mt19937 generator(0);
+    const size_t N = benchmark.settings().samples;
+    const auto xId = randomSamples<IdIn>(N, generator);
+    const auto xFk = randomSamples<FkIn>(N, generator);
+    const auto xFd = randomSamples<FdIn>(N, generator);
+
+    // outputs of the benchmarked functions
+    Eigen::Matrix<double, Kernels::ID_OUT_DIM, 1> yId;
+    Eigen::Matrix<double, Kernels::FK_OUT_DIM, 1> yFk;
+    ct::core::StateVector<STATE_DIM> yFd;
+    Eigen::Matrix<double, Kernels::ID_OUT_DIM, Kernels::ID_IN_DIM> jacId;
+    Eigen::Matrix<double, Kernels::FK_OUT_DIM, Kernels::FK_IN_DIM> jacFk;
+    Eigen::Matrix<double, Kernels::FD_OUT_DIM, Kernels::FD_IN_DIM> jacFd;
+    ct::core::StateMatrix<STATE_DIM> A;
+    ct::core::StateControlMatrix<STATE_DIM, CONTROL_DIM> B;
+
+    auto x = [&](size_t i) -> ct::core::StateVector<STATE_DIM> { return xFd[i].template head<STATE_DIM>(); };
+    auto u = [&](size_t i) -> ct::core::ControlVector<CONTROL_DIM> {
+        return xFd[i].template segment<CONTROL_DIM>(STATE_DIM);
+    };
+
+    // raw
+    benchmark.run(model + "/ForwardDynamics/raw",
+        [&](size_t i) { system->computeControlledDynamics(x(i), 0.0, u(i), yFd); });
+    benchmark.run(model + "/InverseDynamics/raw",
+        [&](size_t i) { yId = Kernels::template inverseDynamics<double>(xId[i], dynamics); });
+    benchmark.run(model + "/ForwardKinematics/raw",
+        [&](size_t i) { yFk = Kernels::template forwardKinematics<double>(xFk[i], kinematics); });
+
+    typename ct::core::DerivativesNumDiff<Kernels::ID_IN_DIM, Kernels::ID_OUT_DIM>::Function id =
+        [&](const IdIn& in) { return Kernels::template inverseDynamics<double>(in, dynamics); };
+    ct::core::DerivativesNumDiff<Kernels::ID_IN_DIM, Kernels::ID_OUT_DIM> idNumDiff(id);
+    benchmark.run(model + "/InverseDynamicsJacobian/raw", [&](size_t i) { jacId = idNumDiff.jacobian(xId[i]); });
+
+    typename ct::core::DerivativesNumDiff<Kernels::FK_IN_DIM, Kernels::FK_OUT_DIM>::Function fk =
+        [&](const FkIn& in) { return Kernels::template forwardKinematics<double>(in, kinematics); };
+    ct::core::DerivativesNumDiff<Kernels::FK_IN_DIM, Kernels::FK_OUT_DIM> fkNumDiff(fk);
+    benchmark.run(model + "/ForwardKinematicsJacobian/raw", [&](size_t i) { jacFk = fkNumDiff.jacobian(xFk[i]); });
+
+    ct::core::SystemLinearizer<STATE_DIM, CONTROL_DIM> numDiffLinearizer(system);
+    benchmark.run(model + "/Linearization/raw", [&](size_t i) {
+        A = numDiffLinearizer.getDerivativeState(x(i), u(i), 0.0);
+        B = numDiffLinearizer.getDerivativeControl(x(i), u(i), 0.0);
+    });
+
+    ct::rbd::RbdLinearizer<System> rbdLinearizer(system);
+    benchmark.run(model + "/Linearization/rbd", [&](size_t i) {
+        A = rbdLinearizer.getDerivativeState(x(i), u(i), 0.0);
+        B = rbdLinearizer.getDerivativeControl(x(i), u(i), 0.0);
+    });
+
+    if (!Kernels::FB)
+    {
+        ct::rbd::RbdLinearizer<System> analyticalLinearizer(system, false, true);
+        benchmark.run(model + "/Linearization/analytical", [&](size_t i) {
+            A = analyticalLinearizer.getDerivativeState(x(i), u(i), 0.0);
+            B = analyticalLinearizer.getDerivativeControl(x(i), u(i), 0.0);
+        });
+    }
+
+#ifdef CPPAD
+    // recording the tapes is expensive, skip it if all benchmarks of a tape are filtered out
+    const std::vector<std::string> fdAd = {
+        model + "/ForwardDynamics/ad", model + "/Linearization/ad-forward", model + "/Linearization/ad-reverse"};
+    if (benchmark.anyEnabled(fdAd))
+    {
+        TapedFunction<Kernels::FD_IN_DIM, Kernels::FD_OUT_DIM> fdTape(
+            [&](const Eigen::Matrix<ct::core::ADScalar, Kernels::FD_IN_DIM, 1>& in) {
+                return kernels.template forwardDynamics<ct::core::ADScalar>(in);
+            });
+        benchmark.run(fdAd[0], [&](size_t i) { yFd = fdTape.forwardZero(xFd[i]); });
+        benchmark.run(fdAd[1], [&](size_t i) { fdTape.jacobianForward(xFd[i], jacFd, STATE_DIM + CONTROL_DIM); });
+        benchmark.run(fdAd[2], [&](size_t i) { fdTape.jacobianReverse(xFd[i], jacFd); });
+    }
+
+    const std::vector<std::string> idAd = {model + "/InverseDynamics/ad",
+        model + "/InverseDynamicsJacobian/ad-forward", model + "/InverseDynamicsJacobian/ad-reverse"};
+    if (benchmark.anyEnabled(idAd))
+    {
+        TapedFunction<Kernels::ID_IN_DIM, Kernels::ID_OUT_DIM> idTape(
+            [](const Eigen::Matrix<ct::core::ADScalar, Kernels::ID_IN_DIM, 1>& in) {
+                return Kernels::template inverseDynamics<ct::core::ADScalar>(in);
+            });
+        benchmark.run(idAd[0], [&](size_t i) { yId = idTape.forwardZero(xId[i]); });
+        benchmark.run(idAd[1], [&](size_t i) { idTape.jacobianForward(xId[i], jacId); });
+        benchmark.run(idAd[2], [&](size_t i) { idTape.jacobianReverse(xId[i], jacId); });
+    }
+
+    const std::vector<std::string> fkAd = {model + "/ForwardKinematics/ad",
+        model + "/ForwardKinematicsJacobian/ad-forward", model + "/ForwardKinematicsJacobian/ad-reverse"};
+    if (benchmark.anyEnabled(fkAd))
+    {
+        TapedFunction<Kernels::FK_IN_DIM, Kernels::FK_OUT_DIM> fkTape(
+            [](const Eigen::Matrix<ct::core::ADScalar, Kernels::FK_IN_DIM, 1>& in) {
+                return Kernels::template forwardKinematics<ct::core::ADScalar>(in);
+            });
+        benchmark.run(fkAd[0], [&](size_t i) { yFk = fkTape.forwardZero(xFk[i]); });
+        benchmark.run(fkAd[1], [&](size_t i) { fkTape.jacobianForward(xFk[i], jacFk); });
+        benchmark.run(fkAd[2], [&](size_t i) { fkTape.jacobianReverse(xFk[i], jacFk); });
+    }
+#endif
+
+    // code generated kernels
+    if (generated.forwardZero)
+        benchmark.run(
+            model + "/ForwardDynamics/codegen", [&](size_t i) { yFd = generated.forwardZero->forwardZero(xFd[i]); });
+    if (generated.inverseDynJacForward)
+        benchmark.run(model + "/InverseDynamicsJacobian/codegen-forward",
+            [&](size_t i) { jacId = generated.inverseDynJacForward->jacobian(xId[i]); });
+    if (generated.inverseDynJacReverse)
+        benchmark.run(model + "/InverseDynamicsJacobian/codegen-reverse",
+            [&](size_t i) { jacId = generated.inverseDynJacReverse->jacobian(xId[i]); });
+    if (generated.forwardKinJacForward)
+        benchmark.run(model + "/ForwardKinematicsJacobian/codegen-forward",
+            [&](size_t i) { jacFk = generated.forwardKinJacForward->jacobian(xFk[i]); });
+    if (generated.forwardKinJacReverse)
+        benchmark.run(model + "/ForwardKinematicsJacobian/codegen-reverse",
+            [&](size_t i) { jacFk = generated.forwardKinJacReverse->jacobian(xFk[i]); });
+    if (generated.linearizedForward)
+        benchmark.run(model + "/Linearization/codegen-forward", [&](size_t i) {
+            A = generated.linearizedForward->getDerivativeState(x(i), u(i), 0.0);
+            B = generated.linearizedForward->getDerivativeControl(x(i), u(i), 0.0);
+        });
+    if (generated.linearizedReverse)
+        benchmark.run(model + "/Linearization/codegen-reverse", [&](size_t i) {
+            A = generated.linearizedReverse->getDerivativeState(x(i), u(i), 0.0);
+            B = generated.linearizedReverse->getDerivativeControl(x(i), u(i), 0.0);
+        });
+}
+
+//! the Quadrotor is a double ODE with analytical Jacobians, it has no inverse dynamics and kinematics
+void benchmarkQuadrotor(ModelBenchmark& benchmark)
+{
+    const size_t STATE_DIM = ct::models::quadrotor::nStates;
+    const size_t CONTROL_DIM = ct::models::quadrotor::nControls;
+
+    std::shared_ptr<ct::models::Quadrotor> system(new ct::models::Quadrotor);
+    ct::models::QuadrotorLinear linearSystem;
+
+    std::mt19937 generator(0);
+    const size_t N = benchmark.settings().samples;
+    const auto x = randomSamples<ct::core::StateVector<STATE_DIM>>(N, generator);
+    const auto u = randomSamples<ct::core::ControlVector<CONTROL_DIM>>(N, generator);
+
+    ct::core::StateVector<STATE_DIM> dx;
+    ct::core::StateMatrix<STATE_DIM> A;
+    ct::core::StateControlMatrix<STATE_DIM, CONTROL_DIM> B;
+
+    benchmark.run("Quadrotor/ForwardDynamics/raw",
+        [&](size_t i) { system->computeControlledDynamics(x[i], 0.0, u[i], dx); });
+
+    ct::core::SystemLinearizer<STATE_DIM, CONTROL_DIM> numDiffLinearizer(system);
+    benchmark.run("Quadrotor/Linearization/raw", [&](size_t i) {
+        A = numDiffLinearizer.getDerivativeState(x[i], u[i], 0.0);
+        B = numDiffLinearizer.getDerivativeControl(x[i], u[i], 0.0);
+    });
+
+    benchmark.run("Quadrotor/Linearization/analytical", [&](size_t i) {
+        A = linearSystem.getDerivativeState(x[i], u[i], 0.0);
+        B = linearSystem.getDerivativeControl(x[i], u[i], 0.0);
+    });
+}
+
+//! ct_models only contains the IKFast kinematics of the Irb4600, there is no RobCoGen model for its dynamics
+void benchmarkIrb4600(ModelBenchmark& benchmark)
+{
+    typedef ct::rbd::Irb4600InverseKinematics<double> InverseKinematics;
+    typedef Eigen::Matrix<double, 6, 1> JointPosition;
+
+    std::mt19937 generator(0);
+    const size_t N = benchmark.settings().samples;
+    const auto q = randomSamples<JointPosition>(N, generator);
+
+    // the end-effector poses of the samples, such that the inverse kinematics has a solution
+    std::vector<ct::rbd::RigidBodyPose, Eigen::aligned_allocator<ct::rbd::RigidBodyPose>> poses(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        Eigen::Vector3d position;
+        Eigen::Matrix<double, 3, 3, Eigen::RowMajor> rotation;
+        irb4600_ik::ComputeFk(q[i].data(), position.data(), rotation.data());
+        poses[i].position().toImplementation() = position;
+        poses[i].setFromRotationMatrix(kindr::RotationMatrix<double>(rotation));
+    }
+
+    Eigen::Vector3d position;
+    Eigen::Matrix<double, 3, 3, Eigen::RowMajor> rotation;
+    benchmark.run("Irb4600/ForwardKinematics/raw",
+        [&](size_t i) { irb4600_ik::ComputeFk(q[i].data(), position.data(), rotation.data()); });
+
+    InverseKinematics inverseKinematics;
+    InverseKinematics::JointPositionsVector_t solutions;
+    benchmark.run("Irb4600/InverseKinematics/raw",
+        [&](size_t i) { inverseKinematics.computeInverseKinematics(solutions, poses[i]); });
+}
+
+
+int main(int argc, char* argv[])
+{
+    ModelBenchmark::Settings settings;
+    std::string output = "modelBenchmark.csv";
+    std::string baseline;
+    double tolerance = 0.1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "missing value of argument " << arg << std::endl;
+            return 2;
+        }
+
+        if (arg == "--samples")
+            settings.samples = std::stoul(argv[++i]);
+        else if (arg == "--warmup")
+            settings.warmup = std::stoul(argv[++i]);
+        else if (arg == "--filter")
+            settings.filter = argv[++i];
+        else if (arg == "--output")
+            output = argv[++i];
+        else if (arg == "--baseline")
+            baseline = argv[++i];
+        else if (arg == "--tolerance")
+            tolerance = std::stod(argv[++i]);
+        else
+        {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    ModelBenchmark benchmark(settings);
+
+    GeneratedKernels<ct::rbd::RBDCodegenKernels<ct::models::benchmark::HyQDynamics>> hyq;
+    CT_MODELS_BENCHMARK_GENERATED_KERNELS(HyQ, hyq);
+    benchmarkModel<ct::models::benchmark::HyQDynamics>("HyQ", benchmark, hyq);
+
+    GeneratedKernels<ct::rbd::RBDCodegenKernels<ct::models::benchmark::HyADynamics>> hya;
+    CT_MODELS_BENCHMARK_GENERATED_KERNELS(HyA, hya);
+    benchmarkModel<ct::models::benchmark::HyADynamics>("HyA", benchmark, hya);
+
+    GeneratedKernels<ct::rbd::RBDCodegenKernels<ct::models::benchmark::InvertedPendulumDynamics>> ip;
+    CT_MODELS_BENCHMARK_GENERATED_KERNELS(InvertedPendulum, ip);
+    benchmarkModel<ct::models::benchmark::InvertedPendulumDynamics>("InvertedPendulum", benchmark, ip);
+
+    GeneratedKernels<ct::rbd::RBDCodegenKernels<ct::models::benchmark::DoubleInvertedPendulumDynamics>> dip;
+    CT_MODELS_BENCHMARK_GENERATED_KERNELS(DoubleInvertedPendulum, dip);
+    benchmarkModel<ct::models::benchmark::DoubleInvertedPendulumDynamics>("DoubleInvertedPendulum", benchmark, dip);
+
+    GeneratedKernels<ct::rbd::RBDCodegenKernels<ct::models::benchmark::QuadrotorWithLoadDynamics>> qwl;
+    CT_MODELS_BENCHMARK_GENERATED_KERNELS(QuadrotorWithLoad, qwl);
+    benchmarkModel<ct::models::benchmark::QuadrotorWithLoadDynamics>("QuadrotorWithLoad", benchmark, qwl);
+
+    benchmarkQuadrotor(benchmark);
+    benchmarkIrb4600(benchmark);
+
+    std::ofstream stream(output);
+    ModelBenchmark::writeCsv(stream, benchmark.results());
+    std::cerr << "results written to " << output << std::endl;
+
+    if (!baseline.empty())
+    {
+        const size_t regressions =
+            ModelBenchmark::compare(benchmark.results(), ModelBenchmark::readCsv(baseline), tolerance, std::cerr);
+        if (regressions > 0)
+        {
+            std::cerr << regressions << " benchmarks are slower than the baseline" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <ct/models/benchmark/ModelBenchmark.h>
+
+using namespace ct::models;
+
+
+TEST(ModelBenchmarkTest, StatisticsTest)
+{
+    // latencies 1 ... 101 in random order
+    std::vector<double> latencies;
+    for (size_t i = 0; i < 101; i++)
+        latencies.push_back((i * 37) % 101 + 1);
+
+    BenchmarkResult result = ModelBenchmark::evaluate("test", latencies);
+    ASSERT_EQ(result.samples, 101u);
+    ASSERT_DOUBLE_EQ(result.min, 1.0);
+    ASSERT_DOUBLE_EQ(result.max, 101.0);
+    ASSERT_DOUBLE_EQ(result.mean, 51.0);
+    ASSERT_DOUBLE_EQ(result.p50, 51.0);
+    ASSERT_DOUBLE_EQ(result.p90, 91.0);
+    ASSERT_DOUBLE_EQ(result.p99, 100.0);
+    ASSERT_DOUBLE_EQ(result.throughput, 1e9 / 51.0);
+
+    // interpolation between samples
+    ASSERT_DOUBLE_EQ(ModelBenchmark::percentile({1.0, 2.0}, 0.5), 1.5);
+    ASSERT_DOUBLE_EQ(ModelBenchmark::percentile({3.0}, 0.99), 3.0);
+}
+
+TEST(ModelBenchmarkTest, RunTest)
+{
+    ModelBenchmark::Settings settings;
+    settings.samples = 100;
+    settings.warmup = 10;
+    settings.filter = "/raw";
+    ModelBenchmark benchmark(settings);
+
+    size_t calls = 0;
+    benchmark.run("model/function/raw", [&](size_t i) { calls++; });
+    benchmark.run("model/function/ad", [&](size_t i) { calls++; });
+
+    // warmup and samples of the first benchmark, the second one is filtered
+    ASSERT_EQ(calls, 110u);
+    ASSERT_EQ(benchmark.results().size(), 1u);
+    ASSERT_EQ(benchmark.results()[0].samples, 100u);
+    ASSERT_LE(benchmark.results()[0].min, benchmark.results()[0].p50);
+    ASSERT_LE(benchmark.results()[0].p99, benchmark.results()[0].max);
+
+    // a group of benchmarks is enabled if any of its concrete names matches, not only its common prefix
+    ModelBenchmark::Settings adSettings;
+    adSettings.filter = "ad-reverse";
+    ModelBenchmark adBenchmark(adSettings);
+    ASSERT_FALSE(adBenchmark.enabled("model/Linearization/ad"));
+    ASSERT_TRUE(adBenchmark.anyEnabled({"model/Linearization/ad-forward", "model/Linearization/ad-reverse"}));
+    ASSERT_FALSE(adBenchmark.anyEnabled({"model/ForwardDynamics/ad", "model/ForwardDynamics/raw"}));
+}
+
+TEST(ModelBenchmarkTest, BaselineTest)
+{
+    std::vector<BenchmarkResult> baseline(3);
+    baseline[0] = ModelBenchmark::evaluate("a", {100.0, 100.0});
+    baseline[1] = ModelBenchmark::evaluate("b", {100.0, 100.0});
+    baseline[2] = ModelBenchmark::evaluate("c", {100.0, 100.0});
+
+    // round trip through the CSV format
+    std::stringstream csv;
+    ModelBenchmark::writeCsv(csv, baseline);
+    std::vector<BenchmarkResult> read = ModelBenchmark::readCsv(csv);
+    ASSERT_EQ(read.size(), 3u);
+    ASSERT_EQ(read[1].name, "b");
+    ASSERT_DOUBLE_EQ(read[1].p50, 100.0);
+
+    // a is faster, b within the tolerance, c is slower, d is not in the baseline
+    std::vector<BenchmarkResult> results(4);
+    results[0] = ModelBenchmark::evaluate("a", {80.0});
+    results[1] = ModelBenchmark::evaluate("b", {105.0});
+    results[2] = ModelBenchmark::evaluate("c", {120.0});
+    results[3] = ModelBenchmark::evaluate("d", {1000.0});
+
+    std::stringstream comparison;
+    ASSERT_EQ(ModelBenchmark::compare(results, read, 0.1, comparison), 1u);
+    ASSERT_NE(comparison.str().find("c,100,120,0.2,REGRESSION"), std::string::npos);
+    ASSERT_EQ(ModelBenchmark::compare(results, read, 0.25, comparison), 0u);
+}
+
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -71,7 +71,8 @@ public:
           constraintsTerminalCount_(0),
           nonZeroJacCount_(0),
           nonZeroJacCountIntermediate_(0),
-          nonZeroJacCountTerminal_(0)
+          nonZeroJacCountTerminal_(0),
+          hasGeneralConstraints_(false)
     {
     }
 
@@ -102,6 +103,7 @@ public:
         std::shared_ptr<LinearConstraintContainer<STATE_DIM, CONTROL_DIM, SCALAR>> generalConstraints)
     {
         constraints_.push_back(generalConstraints);
+        hasGeneralConstraints_ = true;
         constraintsIntermediateCount_ += (N_ + 1) * generalConstraints->getIntermediateConstraintsCount();
         constraintsTerminalCount_ += generalConstraints->getTerminalConstraintsCount();
         constraintsCount_ = constraintsIntermediateCount_ + constraintsTerminalCount_;
@@ -331,6 +333,24 @@ public:
     }
 
     size_t getConstraintSize() override { return constraintsCount_; }
+    // box constraints are linear and do not contribute to the Hessian, general constraints are not supported
+    void genSparsityPatternHessian(Eigen::VectorXi& iRow_vec, Eigen::VectorXi& jCol_vec) override
+    {
+        if (hasGeneralConstraints_)
+            throw std::runtime_error(
+                "ConstraintDiscretizer: exact Hessians are not supported for general constraints. Use Hessian "
+                "approximation.");
+        iRow_vec.resize(0);
+        jCol_vec.resize(0);
+    }
+
+    void sparseHessianValues(const Eigen::VectorXd& optVec,
+        const Eigen::VectorXd& lambda,
+        Eigen::VectorXd& sparseHes) override
+    {
+        sparseHes.resize(0);
+    }
+
 private:
     std::shared_ptr<OptVectorDms<STATE_DIM, CONTROL_DIM, SCALAR>> w_;
     std::shared_ptr<SplinerBase<control_vector_t, SCALAR>> controlSpliner_;
@@ -354,6 +374,8 @@ private:
     size_t nonZeroJacCount_;
     size_t nonZeroJacCountIntermediate_;
     size_t nonZeroJacCountTerminal_;
+
+    bool hasGeneralConstraints_;
 };
 }
 }
@@ -75,6 +75,17 @@ public:
 
     void prepareJacobianEvaluation() override;
 
+#ifdef CPPADCG
+    void prepareHessianEvaluation(const Eigen::VectorXd& optVec, const Eigen::VectorXd& lambda) override;
+
+    /**
+	 * @brief      Enables the exact constraint Hessian by assigning a shot Hessian to every continuity constraint
+	 *
+	 * @param[in]  shotHessians  The shot Hessians, one per shot
+	 */
+    void setShotHessians(const std::vector<std::shared_ptr<ShotHessianDms<STATE_DIM, CONTROL_DIM>>>& shotHessians);
+#endif
+
     /**
 	 * @brief      Updates the initial constraint
 	 *
@@ -87,6 +98,7 @@ private:
 
     std::shared_ptr<InitStateConstraint<STATE_DIM, CONTROL_DIM, SCALAR>> c_init_;
     std::vector<std::shared_ptr<ShotContainer<STATE_DIM, CONTROL_DIM, SCALAR>>> shotContainers_;
+    std::vector<std::shared_ptr<ContinuityConstraint<STATE_DIM, CONTROL_DIM, SCALAR>>> continuityConstraints_;
 };
 
 #include "implementation/ConstraintsContainerDms-impl.h"
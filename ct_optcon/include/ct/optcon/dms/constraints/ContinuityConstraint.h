@@ -11,6 +11,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include <ct/optcon/dms/dms_core/OptVectorDms.h>
 #include <ct/optcon/dms/dms_core/DmsDimensions.h>
 #include <ct/optcon/dms/dms_core/ShotContainer.h>
+#include <ct/optcon/dms/dms_core/ShotHessianDms.h>
 
 namespace ct {
 namespace optcon {
@@ -213,6 +214,48 @@ public:
     VectorXs getLowerBound() override { return lb_; }
     VectorXs getUpperBound() override { return ub_; }
     size_t getConstraintSize() override { return STATE_DIM; }
+#ifdef CPPADCG
+    /**
+	 * @brief      Sets the exact second order sensitivities of the shot
+	 *
+	 * @param[in]  shotHessian  The shot Hessian, assigned to this shot
+	 */
+    void setShotHessian(std::shared_ptr<ShotHessianDms<STATE_DIM, CONTROL_DIM>> shotHessian)
+    {
+        shotHessian_ = shotHessian;
+    }
+
+    /**
+	 * @brief      Evaluates the constraint Hessian, gets called in parallel for all shots before the Hessian
+	 *             values are collected
+	 *
+	 * @param[in]  lambda  The multipliers of this constraint
+	 */
+    void evalHessian(const Eigen::VectorXd& lambda)
+    {
+        if (!shotHessian_)
+            throw std::runtime_error("ContinuityConstraint: no shot Hessian set. Use Hessian approximation.");
+
+        // the constraint is s_{i+1} - Phi(s_i, q_i, q_{i+1}), only the flow map contributes with negative sign
+        shotHessian_->evaluate(-lambda);
+    }
+
+    void genSparsityPatternHessian(Eigen::VectorXi& iRow_vec, Eigen::VectorXi& jCol_vec) override
+    {
+        if (!shotHessian_)
+            throw std::runtime_error("ContinuityConstraint: no shot Hessian set. Use Hessian approximation.");
+
+        shotHessian_->getSparsityPattern(iRow_vec, jCol_vec);
+    }
+
+    void sparseHessianValues(const Eigen::VectorXd& optVec,
+        const Eigen::VectorXd& lambda,
+        Eigen::VectorXd& sparseHes) override
+    {
+        sparseHes = shotHessian_->getValues();
+    }
+#endif
+
 private:
     /**
 	 * @brief      Evaluates the sparse jacobian with respect to the discretized
@@ -253,6 +296,10 @@ private:
 
     state_vector_t lb_;
     state_vector_t ub_;
+
+#ifdef CPPADCG
+    std::shared_ptr<ShotHessianDms<STATE_DIM, CONTROL_DIM>> shotHessian_;
+#endif
 };
 
 
@@ -62,6 +62,20 @@ public:
         indexNumber += BASE::genDiagonalIndices(w_->getStateIndex(0), STATE_DIM, iRow_vec, jCol_vec, indexNumber);
     }
 
+    // the initial state constraint is linear, its Hessian is zero
+    void genSparsityPatternHessian(Eigen::VectorXi& iRow_vec, Eigen::VectorXi& jCol_vec) override
+    {
+        iRow_vec.resize(0);
+        jCol_vec.resize(0);
+    }
+
+    void sparseHessianValues(const Eigen::VectorXd& optVec,
+        const Eigen::VectorXd& lambda,
+        Eigen::VectorXd& sparseHes) override
+    {
+        sparseHes.resize(0);
+    }
+
     VectorXs getLowerBound() override { return lb_; }
     VectorXs getUpperBound() override { return ub_; }
     size_t getConstraintSize() override { return STATE_DIM; }
@@ -25,6 +25,7 @@ ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>::ConstraintsContainerDms
                 new ContinuityConstraint<STATE_DIM, CONTROL_DIM, SCALAR>(shotContainers[shotNr], w, shotNr, settings));
 
         this->constraints_.push_back(c_i);
+        continuityConstraints_.push_back(c_i);
     }
 
     if (discretizedConstraints)
@@ -54,6 +55,31 @@ void ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>::prepareJacobianEva
     }
 }
 
+#ifdef CPPADCG
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR>
+void ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>::prepareHessianEvaluation(const Eigen::VectorXd& optVec,
+    const Eigen::VectorXd& lambda)
+{
+    // the multipliers of the initial state constraint come first, followed by one block per shot
+#pragma omp parallel for num_threads(settings_.nThreads_)
+    for (size_t shotNr = 0; shotNr < continuityConstraints_.size(); shotNr++)
+    {
+        continuityConstraints_[shotNr]->evalHessian(lambda.segment(STATE_DIM * (shotNr + 1), STATE_DIM));
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR>
+void ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>::setShotHessians(
+    const std::vector<std::shared_ptr<ShotHessianDms<STATE_DIM, CONTROL_DIM>>>& shotHessians)
+{
+    if (shotHessians.size() != continuityConstraints_.size())
+        throw std::runtime_error("ConstraintsContainerDms: number of shot Hessians does not match number of shots.");
+
+    for (size_t shotNr = 0; shotNr < continuityConstraints_.size(); shotNr++)
+        continuityConstraints_[shotNr]->setShotHessian(shotHessians[shotNr]);
+}
+#endif
+
 template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR>
 void ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>::changeInitialConstraint(const state_vector_t& x0)
 {
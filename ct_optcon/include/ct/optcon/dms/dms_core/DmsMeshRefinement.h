@@ -0,0 +1,416 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ct/optcon/dms/dms_core/DmsSolver.h>
+
+namespace ct {
+namespace optcon {
+
+/**
+ * @ingroup    DMS
+ *
+ * @brief      Settings of the DMS mesh refinement
+ */
+struct DmsMeshRefinementSettings
+{
+    DmsMeshRefinementSettings()
+        : maxIterations_(5),
+          errorTolerance_(1e-3),
+          mergeFraction_(0.01),
+          maxShots_(200),
+          h_max_(std::numeric_limits<double>::max()),
+          printSummary_(false)
+    {
+    }
+
+    size_t maxIterations_;   // maximum number of refinements
+    double errorTolerance_;  // shots with a larger error estimate get split
+    double mergeFraction_;   // neighbouring shots with errors below mergeFraction_ * errorTolerance_ get merged
+    size_t maxShots_;        // upper bound on the number of shots
+    double h_max_;           // maximum admissible length of a merged shot in [sec]
+    bool printSummary_;      // print the grid and error estimates after every iteration
+};
+
+
+/**
+ * @ingroup    DMS
+ *
+ * @brief      Adaptive time-grid refinement for direct multiple shooting
+ *
+ * Solves the DMS problem on a coarse grid and estimates the error of every shot from the integrated shot
+ * trajectories. Two error sources are considered:
+ *  - the local integration error, estimated by re-integrating the shot with half the step size (step doubling)
+ *  - the interpolation error, i.e. the maximum deviation of the integrated trajectory from the cubic Hermite
+ *    interpolant through the shot end points, which indicates how well the nodes resolve the trajectory
+ *
+ * Shots with an error above the tolerance are split in halves, neighbouring shots with a negligible error are
+ * merged. The refined problem is warm-started from the previous solution and re-solved, until the grid does not
+ * change anymore or the maximum number of iterations is reached.
+ * New grid nodes are snapped to multiples of the simulation time step DmsSettings::dt_sim_, shots are never shorter
+ * than DmsSettings::h_min_.
+ *
+ * @tparam     STATE_DIM    The state dimension
+ * @tparam     CONTROL_DIM  The control dimension
+ */
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR = double>
+class DmsMeshRefinement
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef DmsSolver<STATE_DIM, CONTROL_DIM, SCALAR> solver_t;
+    typedef DmsPolicy<STATE_DIM, CONTROL_DIM, SCALAR> Policy_t;
+    typedef ContinuousOptConProblem<STATE_DIM, CONTROL_DIM, SCALAR> OptConProblem_t;
+
+    typedef DmsDimensions<STATE_DIM, CONTROL_DIM, SCALAR> DIMENSIONS;
+    typedef typename DIMENSIONS::state_vector_t state_vector_t;
+    typedef typename DIMENSIONS::control_vector_t control_vector_t;
+    typedef typename DIMENSIONS::state_vector_array_t state_vector_array_t;
+    typedef typename DIMENSIONS::control_vector_array_t control_vector_array_t;
+    typedef typename DIMENSIONS::time_array_t time_array_t;
+    typedef Eigen::Matrix<SCALAR, Eigen::Dynamic, 1> VectorXs;
+
+    DmsMeshRefinement() = delete;
+
+    /**
+	 * @brief      Custom constructor, sets up the DMS solver on the initial uniform grid given by settings.N_
+	 *
+	 * @param[in]  problem             The optimal control problem
+	 * @param[in]  settings            The dms settings
+	 * @param[in]  refinementSettings  The refinement settings
+	 */
+    DmsMeshRefinement(const OptConProblem_t& problem,
+        const DmsSettings& settings,
+        const DmsMeshRefinementSettings& refinementSettings = DmsMeshRefinementSettings())
+        : problem_(problem), settings_(settings), refinementSettings_(refinementSettings), refinementCount_(0)
+    {
+        if (settings_.splineType_ != DmsSettings::ZERO_ORDER_HOLD &&
+            settings_.splineType_ != DmsSettings::PIECEWISE_LINEAR)
+            throw std::runtime_error("DmsMeshRefinement: unknown spline type");
+
+        if (settings_.integrationType_ == DmsSettings::RK5)
+            throw std::runtime_error("DmsMeshRefinement: adaptive integrators are not supported");
+
+        settings_.T_ = problem_.getTimeHorizon();
+        shotTimes_ = time_array_t(SCALAR(settings_.T_ / settings_.N_), settings_.N_ + 1);
+        shotTimes_.back() = settings_.T_;
+        solver_ = std::shared_ptr<solver_t>(new solver_t(problem_, settings_, shotTimes_));
+    }
+
+    /**
+	 * @brief      Sets the initial guess on the current grid
+	 *
+	 * @param[in]  initialGuess  The initial guess, needs to contain one entry per node of the current grid
+	 */
+    void setInitialGuess(const Policy_t& initialGuess)
+    {
+        solver_->setInitialGuess(initialGuess);
+        initializeIterate();
+    }
+
+    /**
+	 * @brief      Solves the problem and refines the grid until it does not change anymore
+	 *
+	 * @return     true if the last solve was successful
+	 */
+    bool solve()
+    {
+        for (size_t iteration = 0;; iteration++)
+        {
+            if (!solver_->solve())
+                return false;
+
+            estimateShotErrors();
+
+            if (refinementSettings_.printSummary_)
+                printSummary(iteration);
+
+            if (iteration >= refinementSettings_.maxIterations_ || !refineGrid())
+                return true;
+        }
+    }
+
+    /**
+	 * @brief      Estimates the error of every shot at the current iterate of the solver
+	 *
+	 * @return     The error estimates, one per shot
+	 */
+    const VectorXs& estimateShotErrors()
+    {
+        // make sure the control spline and the shot containers reflect the current iterate
+        const auto& dmsProblem = solver_->getDmsProblem();
+        dmsProblem->setOptimizationVariables(VectorXs(dmsProblem->getOptimizationVariables()));
+
+        const auto& shotContainers = dmsProblem->getShotContainers();
+        const Policy_t& policy = solver_->getSolution();
+        const int N = static_cast<int>(shotContainers.size());
+
+        shotErrors_.resize(N);
+        integrationErrors_.resize(N);
+        interpolationErrors_.resize(N);
+
+#pragma omp parallel num_threads(settings_.nThreads_)
+        {
+            // every thread evaluates the dynamics on its own clone of the system
+            std::shared_ptr<core::ControlledSystem<STATE_DIM, CONTROL_DIM, SCALAR>> system(
+                problem_.getNonlinearSystem()->clone());
+
+#pragma omp for schedule(dynamic)
+            for (int i = 0; i < N; i++)
+            {
+                shotContainers[i]->integrateShot();
+                const state_vector_array_t& xHistory = shotContainers[i]->getXHistory();
+                const time_array_t& tHistory = shotContainers[i]->getTHistory();
+
+                integrationErrors_(i) =
+                    computeIntegrationError(*system, policy, i, tHistory.size() - 1, xHistory.back());
+                interpolationErrors_(i) = computeInterpolationError(*system, policy, i, xHistory, tHistory);
+                shotErrors_(i) = std::max(integrationErrors_(i), interpolationErrors_(i));
+            }
+        }
+
+        return shotErrors_;
+    }
+
+    /**
+	 * @brief      Splits and merges shots based on the last error estimate, warm-starts a new solver on the refined
+	 *             grid from the current iterate
+	 *
+	 * @return     true if the grid changed
+	 */
+    bool refineGrid()
+    {
+        if (static_cast<size_t>(shotErrors_.size()) != shotTimes_.size() - 1)
+            throw std::runtime_error("DmsMeshRefinement: estimate the shot errors before refining the grid");
+
+        const size_t N = shotTimes_.size() - 1;
+        const SCALAR tol = refinementSettings_.errorTolerance_;
+        const SCALAR mergeTol = refinementSettings_.mergeFraction_ * tol;
+
+        time_array_t newTimes;
+        newTimes.push_back(SCALAR(0.0));
+
+        // a split and a merge in the same pass keep the number of shots, hence track the changes explicitly
+        bool changed = false;
+        size_t i = 0;
+        while (i < N)
+        {
+            const SCALAR t_start = shotTimes_[i];
+            const SCALAR t_end = shotTimes_[i + 1];
+
+            if (shotErrors_(i) > tol && newTimes.size() + (N - i) < refinementSettings_.maxShots_)
+            {
+                const SCALAR t_mid = snap(SCALAR(0.5) * (t_start + t_end));
+                if (t_mid - t_start >= settings_.h_min_ && t_end - t_mid >= settings_.h_min_)
+                {
+                    newTimes.push_back(t_mid);
+                    changed = true;
+                }
+                newTimes.push_back(t_end);
+                i++;
+            }
+            else if (i + 1 < N && shotErrors_(i) < mergeTol && shotErrors_(i + 1) < mergeTol &&
+                     shotTimes_[i + 2] - t_start <= refinementSettings_.h_max_)
+            {
+                newTimes.push_back(shotTimes_[i + 2]);
+                changed = true;
+                i += 2;
+            }
+            else
+            {
+                newTimes.push_back(t_end);
+                i++;
+            }
+        }
+
+        if (!changed)
+            return false;
+
+        // interpolate the current iterate at the new nodes
+        Policy_t warmStart;
+        for (size_t k = 0; k < newTimes.size(); k++)
+        {
+            state_vector_t x;
+            control_vector_t u;
+            evaluateIterate(newTimes[k], x, u);
+            warmStart.xSolution_.push_back(x);
+            warmStart.uSolution_.push_back(u);
+        }
+        warmStart.tSolution_ = newTimes;
+
+        shotTimes_ = newTimes;
+        settings_.N_ = shotTimes_.size() - 1;
+        solver_ = std::shared_ptr<solver_t>(new solver_t(problem_, settings_, shotTimes_));
+        setInitialGuess(warmStart);
+        refinementCount_++;
+
+        return true;
+    }
+
+    //! returns the solution on the current grid
+    const Policy_t& getSolution() { return solver_->getSolution(); }
+    //! returns the current grid
+    const time_array_t& getShotTimes() const { return shotTimes_; }
+    //! returns the solver of the current grid
+    const std::shared_ptr<solver_t>& getSolver() const { return solver_; }
+    //! returns the error estimates of the last call to estimateShotErrors()
+    const VectorXs& getShotErrors() const { return shotErrors_; }
+    const VectorXs& getIntegrationErrors() const { return integrationErrors_; }
+    const VectorXs& getInterpolationErrors() const { return interpolationErrors_; }
+    //! returns the number of grid refinements carried out so far
+    size_t getRefinementCount() const { return refinementCount_; }
+    //! returns the dms settings of the current grid
+    const DmsSettings& getSettings() const { return settings_; }
+private:
+    //! the initial guess becomes the current iterate until the solver is run
+    void initializeIterate()
+    {
+        const auto& dmsProblem = solver_->getDmsProblem();
+        VectorXs w(dmsProblem->getVarCount());
+        typename tpl::Nlp<SCALAR>::MapVecXs wMap(w.data(), w.size());
+        dmsProblem->getInitialGuess(w.size(), wMap);
+        dmsProblem->setOptimizationVariables(w);
+    }
+
+    //! the control spline of shot i at time t, see ZeroOrderHoldSpliner and LinearSpliner
+    control_vector_t evalSpline(const Policy_t& policy, size_t i, SCALAR t) const
+    {
+        if (settings_.splineType_ == DmsSettings::ZERO_ORDER_HOLD)
+            return policy.uSolution_[i];
+
+        const SCALAR h = shotTimes_[i + 1] - shotTimes_[i];
+        return policy.uSolution_[i] * (shotTimes_[i + 1] - t) / h + policy.uSolution_[i + 1] * (t - shotTimes_[i]) / h;
+    }
+
+    //! the local integration error of shot i by step doubling
+    SCALAR computeIntegrationError(core::ControlledSystem<STATE_DIM, CONTROL_DIM, SCALAR>& system,
+        const Policy_t& policy,
+        size_t i,
+        size_t nSteps,
+        const state_vector_t& x_end) const
+    {
+        const SCALAR dt = SCALAR(0.5 * settings_.dt_sim_);
+        state_vector_t x = policy.xSolution_[i];
+        SCALAR t = shotTimes_[i];
+
+        auto f = [&](const state_vector_t& x_k, const SCALAR t_k) {
+            state_vector_t dxdt;
+            system.computeControlledDynamics(x_k, t_k, evalSpline(policy, i, t_k), dxdt);
+            return dxdt;
+        };
+
+        for (size_t k = 0; k < 2 * nSteps; k++)
+        {
+            if (settings_.integrationType_ == DmsSettings::EULER)
+                x += dt * f(x, t);
+            else
+            {
+                const state_vector_t k1 = f(x, t);
+                const state_vector_t k2 = f(x + SCALAR(0.5) * dt * k1, t + SCALAR(0.5) * dt);
+                const state_vector_t k3 = f(x + SCALAR(0.5) * dt * k2, t + SCALAR(0.5) * dt);
+                const state_vector_t k4 = f(x + dt * k3, t + dt);
+                x += dt / SCALAR(6.0) * (k1 + SCALAR(2.0) * k2 + SCALAR(2.0) * k3 + k4);
+            }
+            t += dt;
+        }
+
+        // Richardson extrapolation, the global error of a method of order p decreases by 2^p
+        const SCALAR order = (settings_.integrationType_ == DmsSettings::EULER) ? SCALAR(1.0) : SCALAR(4.0);
+        return (x - x_end).template lpNorm<Eigen::Infinity>() / (std::pow(SCALAR(2.0), order) - SCALAR(1.0));
+    }
+
+    //! the maximum deviation of the integrated trajectory of shot i from the cubic Hermite interpolant
+    SCALAR computeInterpolationError(core::ControlledSystem<STATE_DIM, CONTROL_DIM, SCALAR>& system,
+        const Policy_t& policy,
+        size_t i,
+        const state_vector_array_t& xHistory,
+        const time_array_t& tHistory) const
+    {
+        const SCALAR t0 = tHistory.front();
+        const SCALAR t1 = tHistory.back();
+        const SCALAR h = t1 - t0;
+
+        state_vector_t dx0, dx1;
+        system.computeControlledDynamics(xHistory.front(), t0, evalSpline(policy, i, t0), dx0);
+        system.computeControlledDynamics(xHistory.back(), t1, evalSpline(policy, i, t1), dx1);
+
+        SCALAR error = SCALAR(0.0);
+        for (size_t k = 1; k + 1 < xHistory.size(); k++)
+        {
+            const SCALAR s = (tHistory[k] - t0) / h;
+            const SCALAR h00 = (SCALAR(1.0) + SCALAR(2.0) * s) * (SCALAR(1.0) - s) * (SCALAR(1.0) - s);
+            const SCALAR h10 = s * (SCALAR(1.0) - s) * (SCALAR(1.0) - s);
+            const SCALAR h01 = s * s * (SCALAR(3.0) - SCALAR(2.0) * s);
+            const SCALAR h11 = s * s * (s - SCALAR(1.0));
+            const state_vector_t x_interp =
+                h00 * xHistory.front() + h10 * h * dx0 + h01 * xHistory.back() + h11 * h * dx1;
+            error = std::max(error, (xHistory[k] - x_interp).template lpNorm<Eigen::Infinity>());
+        }
+        return error;
+    }
+
+    //! evaluates the integrated state and the control spline of the current iterate at time t
+    void evaluateIterate(const SCALAR t, state_vector_t& x, control_vector_t& u)
+    {
+        const Policy_t& policy = solver_->getSolution();
+        const size_t N = shotTimes_.size() - 1;
+
+        if (t >= shotTimes_.back())
+        {
+            x = policy.xSolution_.back();
+            u = policy.uSolution_.back();
+            return;
+        }
+
+        const size_t i = std::min(
+            size_t(std::upper_bound(shotTimes_.begin(), shotTimes_.end(), t) - shotTimes_.begin()) - 1, N - 1);
+        u = evalSpline(policy, i, t);
+
+        const auto& shotContainer = solver_->getDmsProblem()->getShotContainers()[i];
+        const state_vector_array_t& xHistory = shotContainer->getXHistory();
+        const time_array_t& tHistory = shotContainer->getTHistory();
+
+        size_t k = std::upper_bound(tHistory.begin(), tHistory.end(), t) - tHistory.begin();
+        if (k == 0)
+            x = xHistory.front();
+        else if (k >= tHistory.size())
+            x = xHistory.back();
+        else
+        {
+            const SCALAR w = (t - tHistory[k - 1]) / (tHistory[k] - tHistory[k - 1]);
+            x = (SCALAR(1.0) - w) * xHistory[k - 1] + w * xHistory[k];
+        }
+    }
+
+    //! rounds a time to the closest multiple of the simulation time step
+    SCALAR snap(const SCALAR t) const { return std::round(t / settings_.dt_sim_) * settings_.dt_sim_; }
+    void printSummary(size_t iteration) const
+    {
+        std::cout << "DmsMeshRefinement iteration " << iteration << ": " << shotTimes_.size() - 1
+                  << " shots, max. integration error " << integrationErrors_.maxCoeff()
+                  << ", max. interpolation error " << interpolationErrors_.maxCoeff() << std::endl;
+    }
+
+    OptConProblem_t problem_;
+    DmsSettings settings_;
+    DmsMeshRefinementSettings refinementSettings_;
+
+    time_array_t shotTimes_;
+    std::shared_ptr<solver_t> solver_;
+
+    VectorXs shotErrors_;
+    VectorXs integrationErrors_;
+    VectorXs interpolationErrors_;
+    size_t refinementCount_;
+};
+
+}  // namespace optcon
+}  // namespace ct
@@ -17,6 +17,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include <ct/optcon/dms/dms_core/cost_evaluator/CostEvaluatorSimple.h>
 #include <ct/optcon/dms/dms_core/cost_evaluator/CostEvaluatorFull.h>
 #include <ct/optcon/dms/dms_core/DmsSettings.h>
+#include <ct/optcon/dms/dms_core/ShotHessianDms.h>
 
 #include <ct/optcon/nlp/Nlp.h>
 
@@ -58,6 +59,7 @@ public:
      * @param[in]  stateBoxConstraints      The state box constraints
 	 * @param[in]  generaConstraints        The general constraints
 	 * @param[in]  x0                       The initial state
+	 * @param[in]  shotTimes                The shot times of a non-uniform grid (optional, N+1 entries)
 	 */
     DmsProblem(DmsSettings settings,
         std::vector<typename OptConProblem_t::DynamicsPtr_t> systemPtrs,
@@ -66,7 +68,8 @@ public:
         std::vector<typename OptConProblem_t::ConstraintPtr_t> inputBoxConstraints,
         std::vector<typename OptConProblem_t::ConstraintPtr_t> stateBoxConstraints,
         std::vector<typename OptConProblem_t::ConstraintPtr_t> generalConstraints,
-        const state_vector_t& x0)
+        const state_vector_t& x0,
+        const time_array_t& shotTimes = time_array_t())
         : settings_(settings)
     {
         assert(systemPtrs.size() == settings_.N_);
@@ -74,7 +77,12 @@ public:
         assert(costPtrs.size() == settings_.N_);
         settings_.parametersOk();
 
-        timeGrid_ = std::shared_ptr<tpl::TimeGrid<SCALAR>>(new tpl::TimeGrid<SCALAR>(settings.N_, settings.T_));
+        if (shotTimes.size() == 0)
+            timeGrid_ = std::shared_ptr<tpl::TimeGrid<SCALAR>>(new tpl::TimeGrid<SCALAR>(settings.N_, settings.T_));
+        else if (shotTimes.size() == settings_.N_ + 1)
+            timeGrid_ = std::shared_ptr<tpl::TimeGrid<SCALAR>>(new tpl::TimeGrid<SCALAR>(shotTimes));
+        else
+            throw std::runtime_error("DmsProblem: the number of shot times does not match the number of shots");
 
         switch (settings_.splineType_)
         {
@@ -161,10 +169,12 @@ public:
                 throw(std::runtime_error("Unknown cost evaluation type"));
         }
 
-        this->constraints_ = std::shared_ptr<ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>>(
+        constraintsDms_ = std::shared_ptr<ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>>(
             new ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>(
                 optVariablesDms_, timeGrid_, shotContainers_, discretizedConstraints_, x0, settings_));
 
+        this->constraints_ = constraintsDms_;
+
         this->optVariables_->resizeConstraintVars(this->getConstraintsCount());
     }
 
@@ -256,7 +266,7 @@ public:
 	 */
     void changeInitialState(const state_vector_t& x0)
     {
-        // constraints_->changeInitialConstraint(x0);
+        constraintsDms_->changeInitialConstraint(x0);
         optVariablesDms_->changeInitialState(x0);
     }
 
@@ -265,10 +275,88 @@ public:
 	 */
     void printSolution() { optVariablesDms_->printoutSolution(); }
 
+    /**
+	 * @brief      Returns the current optimization variables
+	 */
+    const Eigen::Matrix<SCALAR, Eigen::Dynamic, 1>& getOptimizationVariables() const
+    {
+        return optVariablesDms_->getOptimizationVars();
+    }
+
+    /**
+	 * @brief      Sets the optimization variables and updates the control spline, such that the shot containers
+	 *             integrate the shots of the given iterate
+	 *
+	 * @param[in]  w     The optimization variables
+	 */
+    void setOptimizationVariables(const Eigen::Matrix<SCALAR, Eigen::Dynamic, 1>& w)
+    {
+        typename tpl::Nlp<SCALAR>::MapConstVecXs wMap(w.data(), w.size());
+        this->extractOptimizationVars(wMap, true);
+    }
+
+    /**
+	 * @brief      Returns the optimization vector, which defines the stage structure of the problem
+	 */
+    const std::shared_ptr<OptVectorDms<STATE_DIM, CONTROL_DIM, SCALAR>>& getOptVectorDms() const
+    {
+        return optVariablesDms_;
+    }
+
+    /**
+	 * @brief      Returns the shot containers, e.g. to inspect the integrated trajectories of the shots
+	 *
+	 * @return     The shot containers
+	 */
+    const std::vector<std::shared_ptr<ShotContainer<STATE_DIM, CONTROL_DIM, SCALAR>>>& getShotContainers() const
+    {
+        return shotContainers_;
+    }
+
+#ifdef CPPADCG
+    /**
+	 * @brief      Enables the exact Hessian of the Lagrangian
+	 *
+	 * Generates code for the second order sensitivities of every shot. Shots with the same number of integration
+	 * steps share one compiled library. Requires the SIMPLE cost evaluation, no general constraints and the NLP solver
+	 * to be configured for exact Hessians (hessian_approximation_ = "exact").
+	 *
+	 * @param[in]  systemCG    The system dynamics in auto-diff codegen scalar
+	 * @param[in]  cgSettings  The code generation settings
+	 */
+    void setExactHessianSystem(std::shared_ptr<core::ControlledSystem<STATE_DIM, CONTROL_DIM, core::ADCGScalar>> systemCG,
+        const core::DerivativesCppadSettings& cgSettings = core::DerivativesCppadSettings())
+    {
+        if (settings_.costEvaluationType_ != DmsSettings::SIMPLE)
+            throw std::runtime_error("DmsProblem: exact Hessians require the SIMPLE cost evaluation type.");
+
+        std::map<size_t, std::shared_ptr<ShotHessianDms<STATE_DIM, CONTROL_DIM>>> compiled;
+        std::vector<std::shared_ptr<ShotHessianDms<STATE_DIM, CONTROL_DIM>>> shotHessians;
+
+        for (size_t shotIdx = 0; shotIdx < settings_.N_; shotIdx++)
+        {
+            size_t nIntegrationSteps =
+                (timeGrid_->getShotEndTime(shotIdx) - timeGrid_->getShotStartTime(shotIdx)) / settings_.dt_sim_ + 0.5;
+
+            if (compiled.find(nIntegrationSteps) == compiled.end())
+                compiled[nIntegrationSteps] = std::shared_ptr<ShotHessianDms<STATE_DIM, CONTROL_DIM>>(
+                    new ShotHessianDms<STATE_DIM, CONTROL_DIM>(systemCG, settings_, nIntegrationSteps, cgSettings));
+
+            // every shot gets its own instance such that the shots can be evaluated in parallel
+            shotHessians.push_back(std::shared_ptr<ShotHessianDms<STATE_DIM, CONTROL_DIM>>(
+                new ShotHessianDms<STATE_DIM, CONTROL_DIM>(*compiled[nIntegrationSteps])));
+            shotHessians.back()->setShot(optVariablesDms_, timeGrid_, shotIdx);
+        }
+
+        constraintsDms_->setShotHessians(shotHessians);
+    }
+#endif
+
 private:
     DmsSettings settings_;
 
     std::shared_ptr<ConstraintDiscretizer<STATE_DIM, CONTROL_DIM, SCALAR>> discretizedConstraints_;
+    std::shared_ptr<ConstraintsContainerDms<STATE_DIM, CONTROL_DIM, SCALAR>> constraintsDms_;
 
     std::vector<std::shared_ptr<ShotContainer<STATE_DIM, CONTROL_DIM, SCALAR>>> shotContainers_;
     std::shared_ptr<OptVectorDms<STATE_DIM, CONTROL_DIM, SCALAR>> optVariablesDms_;
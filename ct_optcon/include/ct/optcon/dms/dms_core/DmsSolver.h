@@ -12,6 +12,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include <ct/optcon/dms/dms_core/DmsSettings.h>
 
 #include <ct/optcon/nlp/Nlp>
+#include <ct/optcon/nlp/solver/SqpSolver.h>
 
 #include <memory>
 
@@ -91,6 +92,20 @@ public:
 	 * @param[in]  settingsDms  The dms settings
 	 */
     DmsSolver(const ContinuousOptConProblem<STATE_DIM, CONTROL_DIM, SCALAR> problem, DmsSettings settingsDms)
+        : DmsSolver(problem, settingsDms, time_array_t())  // delegating constructor, uniform time grid
+    {
+    }
+
+    /**
+	 * @brief      Custom constructor for a non-uniform time grid
+	 *
+	 * @param[in]  problem      The optimal control problem
+	 * @param[in]  settingsDms  The dms settings, settingsDms.N_ needs to match the shot times
+	 * @param[in]  shotTimes    The start times of all shots followed by the time horizon, empty for a uniform grid
+	 */
+    DmsSolver(const ContinuousOptConProblem<STATE_DIM, CONTROL_DIM, SCALAR> problem,
+        DmsSettings settingsDms,
+        const time_array_t& shotTimes)
         : nlpSolver_(nullptr), settings_(settingsDms)
     {
         // Create system, linearsystem and costfunction instances
@@ -99,13 +114,16 @@ public:
         dmsProblem_ =
             std::shared_ptr<DmsProblem<STATE_DIM, CONTROL_DIM, SCALAR>>(new DmsProblem<STATE_DIM, CONTROL_DIM, SCALAR>(
                 settingsDms, this->systems_, this->linearSystems_, this->costFunctions_, this->inputBoxConstraints_,
-                this->stateBoxConstraints_, this->generalConstraints_, x0_));
+                this->stateBoxConstraints_, this->generalConstraints_, x0_, shotTimes));
 
         // SNOPT only works for the double type
         if (settingsDms.solverSettings_.solverType_ == NlpSolverType::SNOPT)
             nlpSolver_ = std::shared_ptr<SnoptSolver>(new SnoptSolver(dmsProblem_, settingsDms.solverSettings_));
         else if (settingsDms.solverSettings_.solverType_ == NlpSolverType::IPOPT)
             nlpSolver_ = std::shared_ptr<IpoptSolver>(new IpoptSolver(dmsProblem_, settingsDms.solverSettings_));
+        else if (settingsDms.solverSettings_.solverType_ == NlpSolverType::SQP)
+            nlpSolver_ = std::shared_ptr<SqpSolver<STATE_DIM, CONTROL_DIM>>(new SqpSolver<STATE_DIM, CONTROL_DIM>(
+                dmsProblem_, dmsProblem_->getOptVectorDms(), settingsDms.solverSettings_));
         else
             std::cout << "Unknown solver type... Exiting" << std::endl;
 
@@ -220,6 +238,60 @@ public:
 	 * @brief      Prints out the solution trajectories of the DMS problem
 	 */
     void printSolution() { dmsProblem_->printSolution(); }
+
+    /**
+	 * @brief      Starts the next solve from the current solution, e.g. in an MPC loop
+	 *
+	 * @param[in]  maxIterations  The maximum number of nlp iterations of the next solve
+	 */
+    void prepareWarmStart(size_t maxIterations)
+    {
+        if (!nlpSolver_->isInitialized())
+            nlpSolver_->configure(settings_.solverSettings_);
+
+        nlpSolver_->prepareWarmStart(maxIterations);
+    }
+
+    /**
+	 * @brief      Shifts the current solution by a number of shots and starts the next solve from it, e.g. in an MPC
+	 *             loop with a sampling time equal to the shot duration. The last node is repeated. Requires a solver
+	 *             which supports shifting, such as NlpSolverType::SQP
+	 *
+	 * @param[in]  nShots         The number of shots to shift
+	 * @param[in]  maxIterations  The maximum number of nlp iterations of the next solve
+	 */
+    void shiftWarmStart(size_t nShots, size_t maxIterations)
+    {
+        if (!nlpSolver_->isInitialized())
+            nlpSolver_->configure(settings_.solverSettings_);
+
+        nlpSolver_->shiftIterate(nShots);
+        nlpSolver_->prepareWarmStart(maxIterations);
+    }
+
+    /**
+	 * @brief      Returns the underlying DMS problem
+	 */
+    const std::shared_ptr<DmsProblem<STATE_DIM, CONTROL_DIM, SCALAR>>& getDmsProblem() const { return dmsProblem_; }
+
+#ifdef CPPADCG
+    /**
+	 * @brief      Enables the exact Hessian of the Lagrangian, see DmsProblem::setExactHessianSystem(). The SqpSolver
+	 *             switches to it, IPOPT needs to be configured for exact Hessians.
+	 */
+    void setExactHessianSystem(std::shared_ptr<core::ControlledSystem<STATE_DIM, CONTROL_DIM, core::ADCGScalar>> systemCG,
+        const core::DerivativesCppadSettings& cgSettings = core::DerivativesCppadSettings())
+    {
+        dmsProblem_->setExactHessianSystem(systemCG, cgSettings);
+
+        if (settings_.solverSettings_.solverType_ == NlpSolverType::SQP)
+        {
+            settings_.solverSettings_.sqpSettings_.hessianApproximation_ = SqpSettings::EXACT;
+            nlpSolver_->configure(settings_.solverSettings_);
+        }
+    }
+#endif
+
     std::vector<typename OptConProblem_t::DynamicsPtr_t>& getNonlinearSystemsInstances() override { return systems_; }
     const std::vector<typename OptConProblem_t::DynamicsPtr_t>& getNonlinearSystemsInstances() const override
     {
@@ -0,0 +1,221 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#ifdef CPPADCG
+
+#include <ct/optcon/dms/dms_core/DmsDimensions.h>
+#include <ct/optcon/dms/dms_core/OptVectorDms.h>
+#include <ct/optcon/dms/dms_core/DmsSettings.h>
+#include <ct/optcon/dms/dms_core/TimeGrid.h>
+
+namespace ct {
+namespace optcon {
+
+/**
+ * @ingroup    DMS
+ *
+ * @brief      Exact second order sensitivities of a single DMS shot
+ *
+ * Records the discrete flow map of a shot,
+ * \f[
+ *  x_{i+1} = \Phi(s_i, q_i, q_{i+1}; t_i, h_i)
+ * \f]
+ * using the same integrator and control spline as the ShotContainer, and generates code for the sparse Hessian
+ * of \f$ \lambda^T \Phi \f$ using DerivativesCppadJIT. The shot start time \f$ t_i \f$ and duration \f$ h_i \f$
+ * enter the recording as parameters, such that one compiled library can be shared among all shots with the
+ * same number of integration steps. Use the copy constructor to obtain an instance per shot, as the compiled
+ * library can not be evaluated concurrently.
+ *
+ * @tparam     STATE_DIM    The state dimension
+ * @tparam     CONTROL_DIM  The control dimension
+ */
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+class ShotHessianDms
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    static const int IN_DIM = STATE_DIM + 2 * CONTROL_DIM + 2;  // s_i, q_i, q_{i+1}, t_i, h_i
+
+    typedef core::ADCGScalar CGScalar;
+    typedef core::ControlledSystem<STATE_DIM, CONTROL_DIM, CGScalar> SystemCG_t;
+    typedef core::DerivativesCppadJIT<IN_DIM, STATE_DIM> derivatives_t;
+
+    typedef core::StateVector<STATE_DIM, CGScalar> state_vector_cg_t;
+    typedef core::ControlVector<CONTROL_DIM, CGScalar> control_vector_cg_t;
+
+    ShotHessianDms() = delete;
+
+    /**
+     * @brief      Records and compiles the flow map of a shot
+     *
+     * @param[in]  systemCG    The system dynamics in auto-diff codegen scalar
+     * @param[in]  settings    The dms settings
+     * @param[in]  nSteps      The number of integration steps of the shot
+     * @param[in]  cgSettings  The code generation settings
+     */
+    ShotHessianDms(std::shared_ptr<SystemCG_t> systemCG,
+        const DmsSettings& settings,
+        size_t nSteps,
+        core::DerivativesCppadSettings cgSettings = core::DerivativesCppadSettings())
+        : settings_(settings), nSteps_(nSteps), shotIndex_(0)
+    {
+        std::shared_ptr<SystemCG_t> system(systemCG->clone());
+        const DmsSettings dmsSettings = settings;
+
+        typename derivatives_t::FUN_TYPE_CG flowMap = [system, dmsSettings, nSteps](
+            const typename derivatives_t::IN_TYPE_CG& z) {
+            const control_vector_cg_t q_i = z.template segment<CONTROL_DIM>(STATE_DIM);
+            const control_vector_cg_t q_ip1 = z.template segment<CONTROL_DIM>(STATE_DIM + CONTROL_DIM);
+            const CGScalar t_i = z(STATE_DIM + 2 * CONTROL_DIM);
+            const CGScalar h_i = z(STATE_DIM + 2 * CONTROL_DIM + 1);
+
+            // the control spline of the shot, see ZeroOrderHoldSpliner and LinearSpliner
+            auto rhs = [&](const state_vector_cg_t& x, state_vector_cg_t& dxdt, const CGScalar t) {
+                control_vector_cg_t u = q_i;
+                if (dmsSettings.splineType_ == DmsSettings::PIECEWISE_LINEAR)
+                    u = q_i * (t_i + h_i - t) / h_i + q_ip1 * (t - t_i) / h_i;
+                system->computeControlledDynamics(x, t, u, dxdt);
+            };
+
+            std::shared_ptr<core::internal::StepperCTBase<state_vector_cg_t, CGScalar>> stepper;
+            if (dmsSettings.integrationType_ == DmsSettings::EULER)
+                stepper.reset(new core::internal::StepperEulerCT<state_vector_cg_t, CGScalar>());
+            else if (dmsSettings.integrationType_ == DmsSettings::RK4)
+                stepper.reset(new core::internal::StepperRK4CT<state_vector_cg_t, CGScalar>());
+            else
+                throw std::runtime_error("ShotHessianDms: exact Hessians are only supported for EULER and RK4.");
+
+            state_vector_cg_t x = z.template head<STATE_DIM>();
+            CGScalar t = t_i;
+            const CGScalar dt = CGScalar(dmsSettings.dt_sim_);
+            for (size_t k = 0; k < nSteps; k++)
+            {
+                stepper->do_step(rhs, x, t, dt);
+                t += dt;
+            }
+            return typename derivatives_t::OUT_TYPE_CG(x);
+        };
+
+        derivatives_ = std::shared_ptr<derivatives_t>(new derivatives_t(flowMap));
+
+        cgSettings.createSparseHessian_ = true;
+        derivatives_->compileJIT(cgSettings, "dmsShotHessian");
+    }
+
+    /**
+     * @brief      Copy constructor, loads an own instance of the compiled library
+     */
+    ShotHessianDms(const ShotHessianDms& arg)
+        : settings_(arg.settings_),
+          nSteps_(arg.nSteps_),
+          derivatives_(arg.derivatives_->clone()),
+          w_(arg.w_),
+          timeGrid_(arg.timeGrid_),
+          shotIndex_(arg.shotIndex_)
+    {
+    }
+
+    /**
+     * @brief      Assigns this Hessian to a shot and computes its sparsity pattern in the NLP
+     *
+     * @param[in]  w          The optimization variables
+     * @param[in]  timeGrid   The time grid
+     * @param[in]  shotIndex  The shot number
+     */
+    void setShot(std::shared_ptr<OptVectorDms<STATE_DIM, CONTROL_DIM, double>> w,
+        std::shared_ptr<tpl::TimeGrid<double>> timeGrid,
+        size_t shotIndex)
+    {
+        w_ = w;
+        timeGrid_ = timeGrid;
+        shotIndex_ = shotIndex;
+
+        Eigen::VectorXi iRowLocal, jColLocal;
+        derivatives_->getSparsityPatternHessian(iRowLocal, jColLocal);
+
+        // keep only entries w.r.t. optimization variables, drop the entries w.r.t. the time parameters
+        std::vector<int> iRow, jCol;
+        localIndices_.clear();
+        for (int k = 0; k < iRowLocal.rows(); k++)
+        {
+            int row = toGlobalIndex(iRowLocal(k));
+            int col = toGlobalIndex(jColLocal(k));
+            if (row >= 0 && col >= 0)
+            {
+                iRow.push_back(row);
+                jCol.push_back(col);
+                localIndices_.push_back(k);
+            }
+        }
+        iRow_ = Eigen::Map<Eigen::VectorXi>(iRow.data(), iRow.size());
+        jCol_ = Eigen::Map<Eigen::VectorXi>(jCol.data(), jCol.size());
+        values_.setZero(iRow.size());
+    }
+
+    //! number of integration steps this Hessian was recorded for
+    size_t getNumberOfSteps() const { return nSteps_; }
+    //! the sparsity pattern of the Hessian in NLP indices
+    void getSparsityPattern(Eigen::VectorXi& iRow, Eigen::VectorXi& jCol) const
+    {
+        iRow = iRow_;
+        jCol = jCol_;
+    }
+
+    /**
+     * @brief      Evaluates the Hessian of lambda^T * Phi at the current optimization variables
+     *
+     * @param[in]  lambda  The weights of the flow map components
+     */
+    void evaluate(const Eigen::VectorXd& lambda)
+    {
+        Eigen::VectorXd z(IN_DIM);
+        z.template head<STATE_DIM>() = w_->getOptimizedState(shotIndex_);
+        z.template segment<CONTROL_DIM>(STATE_DIM) = w_->getOptimizedControl(shotIndex_);
+        z.template segment<CONTROL_DIM>(STATE_DIM + CONTROL_DIM) = w_->getOptimizedControl(shotIndex_ + 1);
+        z(STATE_DIM + 2 * CONTROL_DIM) = timeGrid_->getShotStartTime(shotIndex_);
+        z(STATE_DIM + 2 * CONTROL_DIM + 1) = timeGrid_->getShotDuration(shotIndex_);
+
+        Eigen::VectorXd localValues = derivatives_->sparseHessianValues(z, lambda);
+        for (size_t k = 0; k < localIndices_.size(); k++)
+            values_(k) = localValues(localIndices_[k]);
+    }
+
+    //! the Hessian values computed in the last call to evaluate()
+    const Eigen::VectorXd& getValues() const { return values_; }
+
+private:
+    //! maps an index of the recorded input to the NLP, returns -1 for the time parameters
+    int toGlobalIndex(int local) const
+    {
+        if (local < static_cast<int>(STATE_DIM))
+            return w_->getStateIndex(shotIndex_) + local;
+        if (local < static_cast<int>(STATE_DIM + CONTROL_DIM))
+            return w_->getControlIndex(shotIndex_) + local - STATE_DIM;
+        if (local < static_cast<int>(STATE_DIM + 2 * CONTROL_DIM))
+            return w_->getControlIndex(shotIndex_ + 1) + local - STATE_DIM - CONTROL_DIM;
+        return -1;
+    }
+
+    DmsSettings settings_;
+    size_t nSteps_;
+    std::shared_ptr<derivatives_t> derivatives_;
+
+    std::shared_ptr<OptVectorDms<STATE_DIM, CONTROL_DIM, double>> w_;
+    std::shared_ptr<tpl::TimeGrid<double>> timeGrid_;
+    size_t shotIndex_;
+
+    std::vector<int> localIndices_;
+    Eigen::VectorXi iRow_;
+    Eigen::VectorXi jCol_;
+    Eigen::VectorXd values_;
+};
+
+}  // namespace optcon
+}  // namespace ct
+
+#endif  // CPPADCG
@@ -38,11 +38,27 @@ public:
 	 * @param[in]  timeHorizon    The dms time horizon
 	 */
     TimeGrid(const size_t numberOfShots, const SCALAR timeHorizon)
-        : numberOfShots_(numberOfShots), timeHorizon_(timeHorizon), t_(numberOfShots + 1, SCALAR(0.0))
+        : numberOfShots_(numberOfShots), timeHorizon_(timeHorizon), t_(numberOfShots + 1, SCALAR(0.0)), uniform_(true)
     {
         makeUniformGrid();
     }
 
+    /**
+	 * @brief      Custom constructor for a non-uniform grid
+	 *
+	 * @param[in]  shotTimes  The start times of all shots followed by the time horizon, starting at 0.0
+	 */
+    TimeGrid(const ct::core::tpl::TimeArray<SCALAR>& shotTimes)
+        : numberOfShots_(shotTimes.size() - 1), timeHorizon_(shotTimes.back()), t_(shotTimes), uniform_(false)
+    {
+        if (shotTimes.size() < 2 || shotTimes.front() != SCALAR(0.0))
+            throw std::runtime_error("TimeGrid: a grid needs at least two nodes and has to start at t = 0.0");
+
+        for (size_t i = 1; i < shotTimes.size(); i++)
+            if (!(shotTimes[i] > shotTimes[i - 1]))
+                throw std::runtime_error("TimeGrid: the shot times need to be strictly increasing");
+    }
+
     /**
 	 * @brief      Updates the timegrid when the number of shots changes
 	 *
@@ -63,8 +79,18 @@ public:
 	 */
     void changeTimeHorizon(const SCALAR timeHorizon)
     {
+        if (uniform_)
+        {
+            timeHorizon_ = timeHorizon;
+            makeUniformGrid();
+            return;
+        }
+
+        // a non-uniform grid keeps its relative shot lengths
+        const SCALAR scaling = timeHorizon / t_.back();
+        for (size_t i = 0; i < t_.size(); i++)
+            t_[i] *= scaling;
         timeHorizon_ = timeHorizon;
-        makeUniformGrid();
     }
 
 
@@ -145,12 +171,20 @@ public:
 	 * @return     The optimized timehorizon
 	 */
     const SCALAR getOptimizedTimeHorizon() const { return t_.back(); }
+    /**
+	 * @brief      Checks whether the grid is uniform
+	 *
+	 * @return     false if the grid was constructed from individual shot times
+	 */
+    bool isUniform() const { return uniform_; }
 private:
     const size_t numberOfShots_;
     SCALAR timeHorizon_;
 
     // the individual times of each pair from i=0,..., N
     ct::core::tpl::TimeArray<SCALAR> t_;
+
+    bool uniform_;
 };
 }
 
@@ -66,6 +66,14 @@ public:
 
     void evalGradient(size_t grad_length, Eigen::Map<Eigen::Matrix<SCALAR, Eigen::Dynamic, 1>>& grad) override;
 
+    /**
+   * @brief      The cost Hessian consists of a dense block w.r.t. (s_i, q_i) for every node and the terminal cost
+   *             block w.r.t. s_N
+   */
+    void getSparsityPatternHessian(Eigen::VectorXi& iRow, Eigen::VectorXi& jCol) override;
+
+    void sparseHessianValues(const Eigen::VectorXd& optVec, const Eigen::VectorXd& lambda, Eigen::VectorXd& hes) override;
+
 private:
     /**
    * @brief      Updates the weights for the cost interpolation
@@ -121,6 +129,77 @@ void CostEvaluatorSimple<STATE_DIM, CONTROL_DIM, SCALAR>::evalGradient(size_t gr
 }
 
 
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR>
+void CostEvaluatorSimple<STATE_DIM, CONTROL_DIM, SCALAR>::getSparsityPatternHessian(Eigen::VectorXi& iRow,
+    Eigen::VectorXi& jCol)
+{
+    const size_t blockSize = STATE_DIM + CONTROL_DIM;
+    iRow.resize((settings_.N_ + 1) * blockSize * blockSize + STATE_DIM * STATE_DIM);
+    jCol.resize(iRow.rows());
+
+    // indices of the node variables, states and controls are not necessarily contiguous
+    Eigen::VectorXi indices(blockSize);
+    size_t count = 0;
+    for (size_t i = 0; i < settings_.N_ + 1; ++i)
+    {
+        for (size_t k = 0; k < STATE_DIM; k++)
+            indices(k) = w_->getStateIndex(i) + k;
+        for (size_t k = 0; k < CONTROL_DIM; k++)
+            indices(STATE_DIM + k) = w_->getControlIndex(i) + k;
+
+        for (size_t col = 0; col < blockSize; col++)
+            for (size_t row = 0; row < blockSize; row++)
+            {
+                iRow(count) = indices(row);
+                jCol(count) = indices(col);
+                count++;
+            }
+    }
+
+    /* terminal cost */
+    for (size_t col = 0; col < STATE_DIM; col++)
+        for (size_t row = 0; row < STATE_DIM; row++)
+        {
+            iRow(count) = w_->getStateIndex(settings_.N_) + row;
+            jCol(count) = w_->getStateIndex(settings_.N_) + col;
+            count++;
+        }
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR>
+void CostEvaluatorSimple<STATE_DIM, CONTROL_DIM, SCALAR>::sparseHessianValues(const Eigen::VectorXd& optVec,
+    const Eigen::VectorXd& lambda,
+    Eigen::VectorXd& hes)
+{
+    const size_t blockSize = STATE_DIM + CONTROL_DIM;
+    hes.resize((settings_.N_ + 1) * blockSize * blockSize + STATE_DIM * STATE_DIM);
+
+    Eigen::Matrix<SCALAR, STATE_DIM + CONTROL_DIM, STATE_DIM + CONTROL_DIM> block;
+    size_t count = 0;
+    for (size_t i = 0; i < settings_.N_ + 1; ++i)
+    {
+        costFct_->setCurrentStateAndControl(
+            w_->getOptimizedState(i), w_->getOptimizedControl(i), timeGrid_->getShotStartTime(i));
+        block.template topLeftCorner<STATE_DIM, STATE_DIM>() = costFct_->stateSecondDerivativeIntermediate();
+        block.template bottomRightCorner<CONTROL_DIM, CONTROL_DIM>() = costFct_->controlSecondDerivativeIntermediate();
+        block.template bottomLeftCorner<CONTROL_DIM, STATE_DIM>() = costFct_->stateControlDerivativeIntermediate();
+        block.template topRightCorner<STATE_DIM, CONTROL_DIM>() =
+            block.template bottomLeftCorner<CONTROL_DIM, STATE_DIM>().transpose();
+
+        hes.segment(count, blockSize * blockSize) =
+            lambda(0) * phi_(i) * Eigen::Map<Eigen::Matrix<SCALAR, Eigen::Dynamic, 1>>(block.data(), blockSize * blockSize);
+        count += blockSize * blockSize;
+    }
+
+    /* Hessian of terminal cost */
+    costFct_->setCurrentStateAndControl(w_->getOptimizedState(settings_.N_), control_vector_t::Zero());
+    Eigen::Matrix<SCALAR, STATE_DIM, STATE_DIM> terminal = costFct_->stateSecondDerivativeTerminal();
+    hes.segment(count, STATE_DIM * STATE_DIM) =
+        lambda(0) * Eigen::Map<Eigen::Matrix<SCALAR, Eigen::Dynamic, 1>>(terminal.data(), STATE_DIM * STATE_DIM);
+}
+
+
 template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR>
 void CostEvaluatorSimple<STATE_DIM, CONTROL_DIM, SCALAR>::updatePhi()
 {
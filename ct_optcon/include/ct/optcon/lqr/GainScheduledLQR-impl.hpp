@@ -0,0 +1,270 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+
+namespace ct {
+namespace optcon {
+
+namespace internal {
+//! identifier and version of the binary gain table format
+static const uint32_t GAIN_TABLE_MAGIC = 0x53475443;  // "CTGS"
+static const uint32_t GAIN_TABLE_VERSION = 1;
+}  // namespace internal
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::GainScheduledLQR()
+{
+    strides_.fill(0);
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::GainScheduledLQR(const grid_axes_t& axes)
+{
+    setGrid(axes);
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+void GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::setGrid(const grid_axes_t& axes)
+{
+    size_t nNodes = 1;
+    for (int i = SCHEDULE_DIM - 1; i >= 0; i--)
+    {
+        if (axes[i].empty())
+            throw std::runtime_error("GainScheduledLQR: grid axis " + std::to_string(i) + " is empty.");
+
+        for (size_t j = 1; j < axes[i].size(); j++)
+            if (axes[i][j] <= axes[i][j - 1])
+                throw std::runtime_error(
+                    "GainScheduledLQR: grid axis " + std::to_string(i) + " is not strictly increasing.");
+
+        // row-major ordering, the last scheduling dimension is contiguous
+        strides_[i] = nNodes;
+        nNodes *= axes[i].size();
+    }
+
+    axes_ = axes;
+    gains_.assign(nNodes, control_feedback_t::Zero());
+    x_op_.assign(nNodes, state_vector_t::Zero());
+    u_op_.assign(nNodes, control_vector_t::Zero());
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+bool GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::design(const std::shared_ptr<linear_system_t>& linearizer,
+    const operating_point_map_t& operatingPoints,
+    const state_matrix_t& Q,
+    const control_matrix_t& R,
+    size_t nThreads,
+    bool RisDiagonal,
+    bool solveRiccatiIteratively)
+{
+    if (gains_.empty())
+        throw std::runtime_error("GainScheduledLQR: set the grid before designing the gain table.");
+
+    const int nNodes = static_cast<int>(gains_.size());
+    bool success = true;
+
+#pragma omp parallel num_threads(nThreads)
+    {
+        // every thread gets its own linearizer and Riccati solver
+        std::shared_ptr<linear_system_t> threadLinearizer(linearizer->clone());
+        lqr_t lqr;
+        typename linear_system_t::state_matrix_t A;
+        typename linear_system_t::state_control_matrix_t B;
+
+#pragma omp for schedule(dynamic) reduction(&& : success)
+        for (int n = 0; n < nNodes; n++)
+        {
+            operatingPoints(getNode(n), x_op_[n], u_op_[n]);
+            threadLinearizer->getDerivatives(A, B, x_op_[n], u_op_[n]);
+            success = lqr.compute(Q, R, A, B, gains_[n], RisDiagonal, solveRiccatiIteratively) && success;
+        }
+    }
+
+    return success;
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+void GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::getGain(const schedule_vector_t& s,
+    control_feedback_t& K) const
+{
+    std::array<size_t, SCHEDULE_DIM> lower;
+    schedule_vector_t w;
+    locate(s, lower, w);
+
+    K.setZero();
+    for (size_t corner = 0; corner < (size_t(1) << SCHEDULE_DIM); corner++)
+    {
+        double weight = 1.0;
+        size_t index = 0;
+        for (size_t i = 0; i < SCHEDULE_DIM; i++)
+        {
+            const bool upper = (corner >> i) & 1;
+            weight *= upper ? w(i) : 1.0 - w(i);
+            index += (lower[i] + upper) * strides_[i];
+        }
+        if (weight > 0.0)
+            K += weight * gains_[index];
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+void GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::interpolate(const schedule_vector_t& s,
+    control_feedback_t& K,
+    state_vector_t& x_op,
+    control_vector_t& u_op) const
+{
+    std::array<size_t, SCHEDULE_DIM> lower;
+    schedule_vector_t w;
+    locate(s, lower, w);
+
+    K.setZero();
+    x_op.setZero();
+    u_op.setZero();
+    for (size_t corner = 0; corner < (size_t(1) << SCHEDULE_DIM); corner++)
+    {
+        double weight = 1.0;
+        size_t index = 0;
+        for (size_t i = 0; i < SCHEDULE_DIM; i++)
+        {
+            const bool upper = (corner >> i) & 1;
+            weight *= upper ? w(i) : 1.0 - w(i);
+            index += (lower[i] + upper) * strides_[i];
+        }
+        if (weight > 0.0)
+        {
+            K += weight * gains_[index];
+            x_op += weight * x_op_[index];
+            u_op += weight * u_op_[index];
+        }
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+void GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::computeControl(const schedule_vector_t& s,
+    const state_vector_t& x,
+    control_vector_t& u) const
+{
+    control_feedback_t K;
+    state_vector_t x_op;
+    interpolate(s, K, x_op, u);
+    u -= K * (x - x_op);
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+bool GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::saveToFile(const std::string& fileName) const
+{
+    std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    const uint32_t header[5] = {internal::GAIN_TABLE_MAGIC, internal::GAIN_TABLE_VERSION,
+        static_cast<uint32_t>(STATE_DIM), static_cast<uint32_t>(CONTROL_DIM), static_cast<uint32_t>(SCHEDULE_DIM)};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    for (size_t i = 0; i < SCHEDULE_DIM; i++)
+    {
+        const uint64_t n = axes_[i].size();
+        file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        file.write(reinterpret_cast<const char*>(axes_[i].data()), n * sizeof(double));
+    }
+
+    for (size_t n = 0; n < gains_.size(); n++)
+    {
+        file.write(reinterpret_cast<const char*>(gains_[n].data()), sizeof(double) * CONTROL_DIM * STATE_DIM);
+        file.write(reinterpret_cast<const char*>(x_op_[n].data()), sizeof(double) * STATE_DIM);
+        file.write(reinterpret_cast<const char*>(u_op_[n].data()), sizeof(double) * CONTROL_DIM);
+    }
+
+    return file.good();
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+bool GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::loadFromFile(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    uint32_t header[5];
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file.good() || header[0] != internal::GAIN_TABLE_MAGIC || header[1] != internal::GAIN_TABLE_VERSION ||
+        header[2] != STATE_DIM || header[3] != CONTROL_DIM || header[4] != SCHEDULE_DIM)
+    {
+        std::cout << "GainScheduledLQR: " << fileName << " is not a compatible gain table." << std::endl;
+        return false;
+    }
+
+    grid_axes_t axes;
+    for (size_t i = 0; i < SCHEDULE_DIM; i++)
+    {
+        uint64_t n = 0;
+        file.read(reinterpret_cast<char*>(&n), sizeof(n));
+        if (!file.good())
+            return false;
+        axes[i].resize(n);
+        file.read(reinterpret_cast<char*>(axes[i].data()), n * sizeof(double));
+    }
+    if (!file.good())
+        return false;
+
+    setGrid(axes);
+
+    for (size_t n = 0; n < gains_.size(); n++)
+    {
+        file.read(reinterpret_cast<char*>(gains_[n].data()), sizeof(double) * CONTROL_DIM * STATE_DIM);
+        file.read(reinterpret_cast<char*>(x_op_[n].data()), sizeof(double) * STATE_DIM);
+        file.read(reinterpret_cast<char*>(u_op_[n].data()), sizeof(double) * CONTROL_DIM);
+    }
+
+    return file.good();
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+typename GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::schedule_vector_t
+GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::getNode(size_t index) const
+{
+    schedule_vector_t s;
+    for (size_t i = 0; i < SCHEDULE_DIM; i++)
+    {
+        s(i) = axes_[i][index / strides_[i]];
+        index %= strides_[i];
+    }
+    return s;
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+void GainScheduledLQR<STATE_DIM, CONTROL_DIM, SCHEDULE_DIM>::locate(const schedule_vector_t& s,
+    std::array<size_t, SCHEDULE_DIM>& lower,
+    schedule_vector_t& w) const
+{
+    for (size_t i = 0; i < SCHEDULE_DIM; i++)
+    {
+        const std::vector<double>& axis = axes_[i];
+
+        if (axis.size() == 1 || s(i) <= axis.front())
+        {
+            lower[i] = 0;
+            w(i) = 0.0;
+        }
+        else if (s(i) >= axis.back())
+        {
+            lower[i] = axis.size() - 2;
+            w(i) = 1.0;
+        }
+        else
+        {
+            // binary search for the cell containing s(i)
+            lower[i] = std::upper_bound(axis.begin(), axis.end(), s(i)) - axis.begin() - 1;
+            w(i) = (s(i) - axis[lower[i]]) / (axis[lower[i] + 1] - axis[lower[i]]);
+        }
+    }
+}
+
+}  // namespace optcon
+}  // namespace ct
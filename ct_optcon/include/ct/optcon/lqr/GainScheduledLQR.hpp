@@ -0,0 +1,147 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "LQR.hpp"
+
+namespace ct {
+namespace optcon {
+
+/*!
+ * \ingroup LQR
+ *
+ * \brief gain-scheduled continuous-time infinite-horizon LQR
+ *
+ * Designs a table of infinite-horizon LQR controllers on a rectilinear grid of scheduling variables
+ * (e.g. joint angles, forward velocity) and interpolates them multi-linearly at runtime.
+ * Each grid node is mapped to an operating point \f$ (x_{op}, u_{op}) \f$ by a user-provided function,
+ * the system is linearized about that point (e.g. using ct::core::SystemLinearizer or ct::rbd::RbdLinearizer)
+ * and the corresponding CARE is solved. The grid nodes are designed in parallel.
+ *
+ * The resulting feedback law takes the form
+ * \f[
+ * u = u_{op}(s) - K(s) \cdot (x - x_{op}(s))
+ * \f]
+ * where \f$ s \f$ is the scheduling vector.
+ *
+ * The lookup is \f$ O(\sum_i \log n_i) \f$ in the number of grid points along each axis, followed by a
+ * \f$ 2^{SCHEDULE\_DIM} \f$-point blend, and does not allocate memory. The table can be saved to and loaded from
+ * a compact binary file, such that the design can be carried out offline.
+ *
+ * @tparam STATE_DIM system state dimension
+ * @tparam CONTROL_DIM system control input dimension
+ * @tparam SCHEDULE_DIM dimension of the scheduling vector
+ */
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t SCHEDULE_DIM>
+class GainScheduledLQR
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef LQR<STATE_DIM, CONTROL_DIM> lqr_t;
+    typedef typename lqr_t::state_matrix_t state_matrix_t;
+    typedef typename lqr_t::control_matrix_t control_matrix_t;
+    typedef typename lqr_t::control_gain_matrix_t control_gain_matrix_t;
+    typedef typename lqr_t::control_feedback_t control_feedback_t;
+
+    typedef core::StateVector<STATE_DIM, double> state_vector_t;
+    typedef core::ControlVector<CONTROL_DIM, double> control_vector_t;
+    typedef Eigen::Matrix<double, SCHEDULE_DIM, 1> schedule_vector_t;
+
+    typedef core::LinearSystem<STATE_DIM, CONTROL_DIM, double> linear_system_t;
+
+    //! the grid coordinates, one strictly increasing vector per scheduling variable
+    typedef std::array<std::vector<double>, SCHEDULE_DIM> grid_axes_t;
+
+    //! maps a point of the scheduling grid to the operating point (x_op, u_op) about which the system is linearized
+    typedef std::function<void(const schedule_vector_t&, state_vector_t&, control_vector_t&)> operating_point_map_t;
+
+    //! default constructor, creates an empty table
+    GainScheduledLQR();
+
+    //! constructor
+    /*!
+     * @param axes grid coordinates along each scheduling dimension
+     */
+    GainScheduledLQR(const grid_axes_t& axes);
+
+    //! set the scheduling grid. Invalidates any previously designed table.
+    void setGrid(const grid_axes_t& axes);
+
+    //! design the gain table
+    /*!
+     * Linearizes the system about the operating point of every grid node and solves the corresponding CARE.
+     * Every thread works on its own clone of the linearizer.
+     *
+     * @param linearizer the linearized system, e.g. a ct::core::SystemLinearizer or ct::rbd::RbdLinearizer
+     * @param operatingPoints maps a grid node to its operating point
+     * @param Q state-weighting matrix
+     * @param R control input weighting matrix
+     * @param nThreads number of threads used for the design
+     * @param RisDiagonal set to true if R is a diagonal matrix (efficiency boost)
+     * @param solveRiccatiIteratively use the iterative CARE solver
+     * @return true if the CARE could be solved for all grid nodes
+     */
+    bool design(const std::shared_ptr<linear_system_t>& linearizer,
+        const operating_point_map_t& operatingPoints,
+        const state_matrix_t& Q,
+        const control_matrix_t& R,
+        size_t nThreads = 1,
+        bool RisDiagonal = false,
+        bool solveRiccatiIteratively = false);
+
+    //! interpolate the feedback gain at a scheduling point (allocation-free)
+    /*!
+     * Scheduling values outside the grid are clamped to the grid boundaries.
+     * @param s scheduling vector
+     * @param K interpolated feedback gain
+     */
+    void getGain(const schedule_vector_t& s, control_feedback_t& K) const;
+
+    //! interpolate feedback gain and operating point at a scheduling point (allocation-free)
+    void interpolate(const schedule_vector_t& s, control_feedback_t& K, state_vector_t& x_op, control_vector_t& u_op)
+        const;
+
+    //! compute the scheduled control action u = u_op(s) - K(s) * (x - x_op(s))
+    void computeControl(const schedule_vector_t& s, const state_vector_t& x, control_vector_t& u) const;
+
+    //! save the gain table to a binary file
+    bool saveToFile(const std::string& fileName) const;
+
+    //! load a gain table from a binary file written by saveToFile()
+    bool loadFromFile(const std::string& fileName);
+
+    //! the grid coordinates
+    const grid_axes_t& getGrid() const { return axes_; }
+    //! total number of grid nodes
+    size_t getNumberOfNodes() const { return gains_.size(); }
+    //! returns the scheduling vector of the grid node with given linear index
+    schedule_vector_t getNode(size_t index) const;
+
+    //! access the table entries of the grid node with given linear index
+    const control_feedback_t& getNodeGain(size_t index) const { return gains_[index]; }
+    const state_vector_t& getNodeState(size_t index) const { return x_op_[index]; }
+    const control_vector_t& getNodeControl(size_t index) const { return u_op_[index]; }
+
+private:
+    //! find the interpolation cell and the local coordinates of a scheduling point
+    void locate(const schedule_vector_t& s, std::array<size_t, SCHEDULE_DIM>& lower, schedule_vector_t& w) const;
+
+    grid_axes_t axes_;
+    std::array<size_t, SCHEDULE_DIM> strides_;
+
+    std::vector<control_feedback_t, Eigen::aligned_allocator<control_feedback_t>> gains_;
+    std::vector<state_vector_t, Eigen::aligned_allocator<state_vector_t>> x_op_;
+    std::vector<control_vector_t, Eigen::aligned_allocator<control_vector_t>> u_op_;
+};
+
+}  // namespace optcon
+}  // namespace ct
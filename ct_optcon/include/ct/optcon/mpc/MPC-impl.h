@@ -22,7 +22,8 @@ MPC<OPTCON_SOLVER>::MPC(const OptConProblem_t& problem,
       forwardIntegrator_(dynamics_, mpcsettings.stateForwardIntegratorType_),
       firstRun_(true),
       runCallCounter_(0),
-      policyHandler_(new PolicyHandler<Policy_t, STATE_DIM, CONTROL_DIM, Scalar_t>())
+      policyHandler_(new PolicyHandler<Policy_t, STATE_DIM, CONTROL_DIM, Scalar_t>()),
+      forwardIntegrationPolicy_(new Policy_t())
 {
     checkSettings(mpcsettings);
 
@@ -127,8 +128,8 @@ void MPC<OPTCON_SOLVER>::doForwardIntegration(const Scalar_t& t_forward_start,
         else
         {
             // ... or with the controller obtained from the solver (solution of last mpc-run).
-            std::shared_ptr<Policy_t> prevController(new Policy_t(currentPolicy_));
-            integrateForward(t_forward_start, t_forward_stop, x_start, prevController);
+            *forwardIntegrationPolicy_ = currentPolicy_;
+            integrateForward(t_forward_start, t_forward_stop, x_start, forwardIntegrationPolicy_);
         }
     }
 }
@@ -159,6 +160,9 @@ void MPC<OPTCON_SOLVER>::prepareIteration(const Scalar_t& extTime)
     // Calculate new initial guess / warm-starting policy
     policyHandler_->designWarmStartingPolicy(t_forward_stop_, newTimeHorizon, currentPolicy_);
 
+    // shift the iterate of the LQ solver accordingly
+    solver_.shiftWarmStart(t_forward_stop_);
+
     // todo: remove this after through testing
     if (t_forward_stop_ < t_forward_start_)
         throw std::runtime_error("ERROR: t_forward_stop < t_forward_start is impossible.");
@@ -321,6 +325,13 @@ void MPC<OPTCON_SOLVER>::printMpcSummary()
 }
 
 
+template <typename OPTCON_SOLVER>
+const tpl::MpcTimeKeeper<typename MPC<OPTCON_SOLVER>::Scalar_t>& MPC<OPTCON_SOLVER>::getTimeKeeper() const
+{
+    return timeKeeper_;
+}
+
+
 template <typename OPTCON_SOLVER>
 void MPC<OPTCON_SOLVER>::integrateForward(const Scalar_t startTime,
     const Scalar_t stopTime,
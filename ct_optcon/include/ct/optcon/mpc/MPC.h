@@ -192,6 +192,9 @@ public:
     //! printout simple statistical data
     void printMpcSummary();
 
+    //! the time keeper, which holds the delay statistics
+    const tpl::MpcTimeKeeper<Scalar_t>& getTimeKeeper() const;
+
 
 private:
     //! state forward propagation (for delay compensation)
@@ -242,6 +245,9 @@ private:
     //! currently optimal policy, initial guess respectively
     Policy_t currentPolicy_;
 
+    //! copy of the previous policy for forward integration, allocated once
+    std::shared_ptr<Policy_t> forwardIntegrationPolicy_;
+
     //! time horizon strategy, e.g. receding horizon optimal control
     std::shared_ptr<tpl::MpcTimeHorizon<Scalar_t>> timeHorizonStrategy_;
 
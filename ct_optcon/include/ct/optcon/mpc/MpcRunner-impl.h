@@ -0,0 +1,195 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ct {
+namespace optcon {
+
+template <typename OPTCON_SOLVER>
+MpcRunner<OPTCON_SOLVER>::MpcRunner(std::shared_ptr<MPC<OPTCON_SOLVER>> mpc, const MpcRunnerSettings& settings)
+    : mpc_(mpc), settings_(settings), running_(false)
+{
+    if (!mpc_)
+        throw std::runtime_error("MpcRunner: MPC object is a nullptr");
+}
+
+
+template <typename OPTCON_SOLVER>
+MpcRunner<OPTCON_SOLVER>::~MpcRunner()
+{
+    stop();
+}
+
+
+template <typename OPTCON_SOLVER>
+void MpcRunner<OPTCON_SOLVER>::start()
+{
+    if (running_)
+        throw std::runtime_error("MpcRunner: solver thread is already running");
+
+    // the thread may have stopped by itself
+    if (thread_.joinable())
+        thread_.join();
+
+    running_ = true;
+    thread_ = std::thread(&MpcRunner::run, this);
+}
+
+
+template <typename OPTCON_SOLVER>
+void MpcRunner<OPTCON_SOLVER>::stop()
+{
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+}
+
+
+template <typename OPTCON_SOLVER>
+bool MpcRunner<OPTCON_SOLVER>::isRunning() const
+{
+    return running_;
+}
+
+
+template <typename OPTCON_SOLVER>
+void MpcRunner<OPTCON_SOLVER>::setState(const StateVector& x, const Scalar_t& t)
+{
+    measurements_.back().x = x;
+    measurements_.back().t = t;
+    measurements_.publish();
+}
+
+
+template <typename OPTCON_SOLVER>
+bool MpcRunner<OPTCON_SOLVER>::getControl(const StateVector& x, const Scalar_t& t, ControlVector& u)
+{
+    policies_.update();
+    if (!policies_.hasData())
+        return false;
+
+    TimedPolicy& current = policies_.front();
+    current.policy.computeControl(x, t - current.ts, u);
+    return true;
+}
+
+
+template <typename OPTCON_SOLVER>
+auto MpcRunner<OPTCON_SOLVER>::getPolicy(Scalar_t& policyTs) -> const Policy_t&
+{
+    policies_.update();
+    policyTs = policies_.front().ts;
+    return policies_.front().policy;
+}
+
+
+template <typename OPTCON_SOLVER>
+auto MpcRunner<OPTCON_SOLVER>::getStatistics() -> const Statistics_t&
+{
+    statistics_.update();
+    return statistics_.front();
+}
+
+
+template <typename OPTCON_SOLVER>
+void MpcRunner<OPTCON_SOLVER>::run()
+{
+    configureThread();
+
+    // wait for the first state measurement
+    while (running_ && !measurements_.update())
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+    if (running_)
+        mpc_->prepareIteration(measurements_.front().t);
+
+    while (running_)
+    {
+        auto cycleStart = std::chrono::steady_clock::now();
+
+        // solve for the latest state
+        measurements_.update();
+        TimedPolicy& newPolicy = policies_.back();
+        bool solveSuccessful =
+            mpc_->finishIteration(measurements_.front().x, measurements_.front().t, newPolicy.policy, newPolicy.ts);
+
+        // in case of a failure, the control thread keeps the previous policy
+        const Scalar_t policyTs = newPolicy.ts;
+        if (solveSuccessful)
+            policies_.publish();
+        publishStatistics(solveSuccessful, policyTs);
+
+        if (mpc_->timeHorizonReached())
+            break;
+
+        measurements_.update();
+        mpc_->prepareIteration(measurements_.front().t);
+
+        if (settings_.minCyclePeriodUs > 0)
+            std::this_thread::sleep_until(cycleStart + std::chrono::microseconds(settings_.minCyclePeriodUs));
+    }
+
+    running_ = false;
+}
+
+
+template <typename OPTCON_SOLVER>
+void MpcRunner<OPTCON_SOLVER>::configureThread()
+{
+#ifdef __linux__
+    if (settings_.cpuCore >= 0)
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(settings_.cpuCore, &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) != 0)
+            std::cerr << "MpcRunner: could not pin the solver thread to CPU core " << settings_.cpuCore << std::endl;
+    }
+
+    if (settings_.realtimePriority > 0)
+    {
+        sched_param parameters;
+        parameters.sched_priority = settings_.realtimePriority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters) != 0)
+            std::cerr << "MpcRunner: could not set real-time priority " << settings_.realtimePriority
+                      << " for the solver thread, missing permissions?" << std::endl;
+    }
+#else
+    if (settings_.cpuCore >= 0 || settings_.realtimePriority > 0)
+        std::cerr << "MpcRunner: CPU pinning and real-time priorities are only supported on Linux" << std::endl;
+#endif
+}
+
+
+template <typename OPTCON_SOLVER>
+void MpcRunner<OPTCON_SOLVER>::publishStatistics(bool solveSuccessful, const Scalar_t& policyTs)
+{
+    const tpl::MpcTimeKeeper<Scalar_t>& timeKeeper = mpc_->getTimeKeeper();
+
+    currentStatistics_.iterations++;
+    if (solveSuccessful)
+        currentStatistics_.policyTs = policyTs;
+    else
+        currentStatistics_.failedIterations++;
+
+    currentStatistics_.lastDelay = timeKeeper.getMeasuredDelay();
+    currentStatistics_.minDelay = timeKeeper.getMinMeasuredDelay();
+    currentStatistics_.maxDelay = timeKeeper.getMaxMeasuredDelay();
+    currentStatistics_.meanDelay = timeKeeper.getSummedDelay() / currentStatistics_.iterations;
+
+    statistics_.back() = currentStatistics_;
+    statistics_.publish();
+}
+
+}  // namespace optcon
+}  // namespace ct
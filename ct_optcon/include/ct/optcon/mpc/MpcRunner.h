@@ -0,0 +1,192 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "MPC.h"
+
+namespace ct {
+namespace optcon {
+
+//! settings for the solver thread of the MpcRunner
+struct MpcRunnerSettings
+{
+    MpcRunnerSettings() : cpuCore(-1), realtimePriority(0), minCyclePeriodUs(0) {}
+    //! pin the solver thread to this CPU core, -1 disables pinning
+    int cpuCore;
+    //! run the solver thread with this SCHED_FIFO priority (1-99), 0 keeps the default scheduling
+    int realtimePriority;
+    //! minimum duration of a solver cycle in microseconds, e.g. to limit the CPU load, 0 runs as fast as possible
+    int minCyclePeriodUs;
+};
+
+
+//! timing statistics of the MpcRunner, based on the MpcTimeKeeper
+template <typename SCALAR>
+struct MpcRunnerStatistics
+{
+    MpcRunnerStatistics()
+        : iterations(0),
+          failedIterations(0),
+          lastDelay(0.0),
+          minDelay(0.0),
+          maxDelay(0.0),
+          meanDelay(0.0),
+          policyTs(0.0)
+    {
+    }
+    //! number of finished MPC iterations
+    size_t iterations;
+    //! number of MPC iterations in which the solver failed, the previous policy remains active in this case
+    size_t failedIterations;
+    //! solver delay of the last iteration, only measured if mpc_settings::measureDelay_ is set
+    SCALAR lastDelay;
+    //! smallest solver delay
+    SCALAR minDelay;
+    //! largest solver delay
+    SCALAR maxDelay;
+    //! average solver delay
+    SCALAR meanDelay;
+    //! time stamp of the start of the currently published policy
+    SCALAR policyTs;
+};
+
+
+/**
+ * \ingroup MPC
+ *
+ * \brief Runs MPC asynchronously in a dedicated solver thread
+ *
+ * The runner owns the solver thread, which continuously calls MPC::finishIteration() and MPC::prepareIteration() on the
+ * latest state measurement. Each new policy is published through a wait-free triple buffer, such that a high rate
+ * control loop can evaluate it without locks and without being blocked by the solver.
+ *
+ * setState(), getControl() and getStatistics() are wait-free and need to be called from the same (control) thread.
+ * The MPC object must not be accessed by the user while the runner is running.
+ *
+ * Usage:
+ * \code
+ * MpcRunner<NLOptConSolver<STATE_DIM, CONTROL_DIM>> runner(mpc);
+ * runner.start();
+ * while (controlLoopActive)
+ * {
+ *     runner.setState(x, t);
+ *     if (runner.getControl(x, t, u))
+ *         applyControl(u);
+ * }
+ * runner.stop();
+ * \endcode
+ */
+template <typename OPTCON_SOLVER>
+class MpcRunner
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    static const size_t STATE_DIM = MPC<OPTCON_SOLVER>::STATE_DIM;
+    static const size_t CONTROL_DIM = MPC<OPTCON_SOLVER>::CONTROL_DIM;
+
+    using Scalar_t = typename MPC<OPTCON_SOLVER>::Scalar_t;
+    using Policy_t = typename MPC<OPTCON_SOLVER>::Policy_t;
+    using StateVector = core::StateVector<STATE_DIM, Scalar_t>;
+    using ControlVector = core::ControlVector<CONTROL_DIM, Scalar_t>;
+    using Statistics_t = MpcRunnerStatistics<Scalar_t>;
+
+    //! constructor
+    /*!
+     * @param mpc the MPC object, including the initial guess
+     * @param settings settings for the solver thread
+     */
+    MpcRunner(std::shared_ptr<MPC<OPTCON_SOLVER>> mpc, const MpcRunnerSettings& settings = MpcRunnerSettings());
+
+    //! destructor, stops the solver thread
+    ~MpcRunner();
+
+    MpcRunner(const MpcRunner&) = delete;
+    MpcRunner& operator=(const MpcRunner&) = delete;
+
+    //! start the solver thread, which waits for the first state measurement
+    void start();
+
+    //! stop the solver thread after its current iteration
+    void stop();
+
+    //! true while the solver thread is running, it also stops by itself once the MPC time horizon is reached
+    bool isRunning() const;
+
+    //! hand over a new state measurement to the solver thread (wait-free)
+    /*!
+     * @param x the measured state
+     * @param t time stamp of the measurement, in the time of the MPC (external time if useExternalTiming_ is set)
+     */
+    void setState(const StateVector& x, const Scalar_t& t);
+
+    //! evaluate the latest policy (wait-free)
+    /*!
+     * @param x the current state
+     * @param t the current time
+     * @param u the resulting control
+     * @return false if no policy has been published yet, u is not set in this case
+     */
+    bool getControl(const StateVector& x, const Scalar_t& t, ControlVector& u);
+
+    //! the latest policy and its start time stamp (wait-free)
+    /*!
+     * @param policyTs the time stamp at which the policy starts
+     * @return the policy, only valid if a policy has been published already
+     */
+    const Policy_t& getPolicy(Scalar_t& policyTs);
+
+    //! the latest statistics of the solver thread (wait-free)
+    const Statistics_t& getStatistics();
+
+private:
+    //! a state measurement
+    struct Measurement
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+        StateVector x;
+        Scalar_t t;
+    };
+
+    //! a policy and the time at which it starts
+    struct TimedPolicy
+    {
+        Policy_t policy;
+        Scalar_t ts;
+    };
+
+    //! the solver thread
+    void run();
+
+    //! set the CPU affinity and scheduling policy of the calling thread
+    void configureThread();
+
+    //! publish the statistics of the time keeper
+    void publishStatistics(bool solveSuccessful, const Scalar_t& policyTs);
+
+    std::shared_ptr<MPC<OPTCON_SOLVER>> mpc_;
+    MpcRunnerSettings settings_;
+
+    //! state measurements, from the control thread to the solver thread
+    core::TripleBuffer<Measurement> measurements_;
+    //! policies, from the solver thread to the control thread
+    core::TripleBuffer<TimedPolicy> policies_;
+    //! statistics, from the solver thread to the control thread
+    core::TripleBuffer<Statistics_t> statistics_;
+
+    //! statistics owned by the solver thread
+    Statistics_t currentStatistics_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+}  // namespace optcon
+}  // namespace ct
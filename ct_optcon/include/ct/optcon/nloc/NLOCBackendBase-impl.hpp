@@ -39,16 +39,17 @@ NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::NLOCB
       K_(0),
       substepsX_(new StateSubsteps),
       substepsU_(new ControlSubsteps),
+      lineSearchBuffers_(settings.nThreads + 1),
       d_norm_(0.0),
       e_box_norm_(0.0),
       e_gen_norm_(0.0),
       lx_norm_(0.0),
       lu_norm_(0.0),
-      intermediateCostBest_(std::numeric_limits<SCALAR>::infinity()),
-      finalCostBest_(std::numeric_limits<SCALAR>::infinity()),
-      lowestCost_(std::numeric_limits<SCALAR>::infinity()),
-      intermediateCostPrevious_(std::numeric_limits<SCALAR>::infinity()),
-      finalCostPrevious_(std::numeric_limits<SCALAR>::infinity()),
+      intermediateCostBest_(std::numeric_limits<merit_t>::infinity()),
+      finalCostBest_(std::numeric_limits<merit_t>::infinity()),
+      lowestCost_(std::numeric_limits<merit_t>::infinity()),
+      intermediateCostPrevious_(std::numeric_limits<merit_t>::infinity()),
+      finalCostPrevious_(std::numeric_limits<merit_t>::infinity()),
       alphaBest_(-1),
       lqocProblem_(new LQOCProblem<STATE_DIM, CONTROL_DIM, SCALAR>()),
       systemInterface_(systemInterface),
@@ -59,6 +60,12 @@ NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::NLOCB
 {
     Eigen::initParallel();
 
+    for (LineSearchBuffer& buffer : lineSearchBuffers_)
+    {
+        buffer.substepsX = StateSubstepsPtr(new StateSubsteps);
+        buffer.substepsU = ControlSubstepsPtr(new ControlSubsteps);
+    }
+
     systemInterface_->initialize();
 
     configure(settings);
@@ -176,7 +183,9 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 
     initialized_ = true;
 
-    t_ = TimeArray(settings_.dt, x_.size(), 0.0);
+    // fill the time array in place, it keeps its storage when the horizon does not change
+    const SCALAR dt = settings_.dt;
+    core::linspace(t_, SCALAR(0.0), SCALAR(0.0) + (x_.size() - 1) * dt, x_.size());
 
     reset();
 
@@ -215,6 +224,17 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
     substepsX_->resize(K_ + 1);
     substepsU_->resize(K_ + 1);
 
+    for (LineSearchBuffer& buffer : lineSearchBuffers_)
+    {
+        buffer.x.resize(K_ + 1);
+        buffer.xShot.resize(K_ + 1);
+        buffer.d.resize(K_ + 1);
+        buffer.u.resize(K_);
+        buffer.xRefLqr.resize(K_ + 1);
+        buffer.substepsX->resize(K_ + 1);
+        buffer.substepsU->resize(K_ + 1);
+    }
+
     resetDefects();
 
     systemInterface_->changeNumStages(K_);
@@ -234,6 +254,14 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
     changeTimeHorizon(settings_.computeK(tf));
 }
 
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
+void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::shiftLQWarmStart(const SCALAR& t_shift)
+{
+    const int nStages = static_cast<int>(std::lround(t_shift / settings_.dt));
+    if (nStages > 0)
+        lqocSolver_->shiftWarmStart(nStages);
+}
+
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::changeInitialState(
     const core::StateVector<STATE_DIM, SCALAR>& x0)
@@ -399,8 +427,13 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
     // select the linear quadratic solver based on settings file
     if (settings.lqocp_solver == NLOptConSettings::LQOCP_SOLVER::GNRICCATI_SOLVER)
     {
-        lqocSolver_ = std::shared_ptr<GNRiccatiSolver<STATE_DIM, CONTROL_DIM, SCALAR>>(
-            new GNRiccatiSolver<STATE_DIM, CONTROL_DIM, SCALAR>());
+        // in reduced precision, the Riccati recursion can optionally be carried out in double
+        if (settings.doublePrecisionLQSolver && !std::is_same<SCALAR, double>::value)
+            lqocSolver_ = std::shared_ptr<MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, double>>(
+                new MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, double>());
+        else
+            lqocSolver_ = std::shared_ptr<GNRiccatiSolver<STATE_DIM, CONTROL_DIM, SCALAR>>(
+                new GNRiccatiSolver<STATE_DIM, CONTROL_DIM, SCALAR>());
     }
     else if (settings.lqocp_solver == NLOptConSettings::LQOCP_SOLVER::HPIPM_SOLVER)
     {
@@ -427,6 +460,9 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 
     settings_ = settings;
 
+    // the summary logs at most one entry per iteration, avoid growing it while solving
+    summaryAllIterations_.reserve(settings_.max_iterations + 1);
+
     reset();
 
     configured_ = true;
@@ -573,10 +609,11 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
     size_t threadId,
     const ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_local,
     const ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>& u_local,
-    scalar_t& intermediateCost,
-    scalar_t& finalCost) const
+    merit_t& intermediateCost,
+    merit_t& finalCost) const
 {
-    intermediateCost = 0;
+    // accumulate in double, the merit of long horizons is sensitive to rounding if SCALAR is float
+    merit_t intermediateCostSum = 0.0;
 
     for (size_t k = 0; k < (size_t)K_; k++)
     {
@@ -584,9 +621,9 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
         costFunctions_[threadId]->setCurrentStateAndControl(x_local[k], u_local[k], settings_.dt * k);
 
         // derivative of cost with respect to state
-        intermediateCost += costFunctions_[threadId]->evaluateIntermediate();
+        intermediateCostSum += costFunctions_[threadId]->evaluateIntermediate();
     }
-    intermediateCost *= settings_.dt;
+    intermediateCost = intermediateCostSum * settings_.dt;
 
     costFunctions_[threadId]->setCurrentStateAndControl(x_local[K_], control_vector_t::Zero(), settings_.dt * K_);
     finalCost = costFunctions_[threadId]->evaluateTerminal();
@@ -597,7 +634,7 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
     size_t threadId,
     const ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_local,
     const ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>& u_local,
-    scalar_t& e_tot) const
+    merit_t& e_tot) const
 {
     e_tot = 0;
 
@@ -647,7 +684,7 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
     computeGeneralConstraintErrorOfTrajectory(size_t threadId,
         const ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_local,
         const ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>& u_local,
-        scalar_t& e_tot) const
+        merit_t& e_tot) const
 {
     e_tot = 0;
 
@@ -849,14 +886,14 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::printSummary()
 {
-    SCALAR d_norm_l1 = computeDefectsNorm<1>(d_);
-    SCALAR d_norm_l2 = computeDefectsNorm<2>(d_);
-    SCALAR totalCost = intermediateCostBest_ + finalCostBest_;
+    merit_t d_norm_l1 = computeDefectsNorm<1>(d_);
+    merit_t d_norm_l2 = computeDefectsNorm<2>(d_);
+    merit_t totalCost = intermediateCostBest_ + finalCostBest_;
 
     computeBoxConstraintErrorOfTrajectory(settings_.nThreads, x_, u_ff_, e_box_norm_);
     computeGeneralConstraintErrorOfTrajectory(settings_.nThreads, x_, u_ff_, e_gen_norm_);
 
-    SCALAR totalMerit = intermediateCostBest_ + finalCostBest_ + settings_.meritFunctionRho * d_norm_l1 +
+    merit_t totalMerit = intermediateCostBest_ + finalCostBest_ + settings_.meritFunctionRho * d_norm_l1 +
                         settings_.meritFunctionRhoConstraints * (e_box_norm_ + e_gen_norm_);
 
     SCALAR smallestEigenvalue = 0.0;
@@ -942,6 +979,21 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 }
 
 
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
+void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::logToBinary()
+{
+    if (!binaryLog_)
+        return;
+
+    const double stamp = static_cast<double>(iteration_);
+    binaryLog_->log("nloc/t", t_, stamp);
+    binaryLog_->log("nloc/x", x_, stamp);
+    binaryLog_->log("nloc/u_ff", u_ff_, stamp);
+    binaryLog_->log("nloc/L", L_, stamp);
+    summaryAllIterations_.logLastIterationToBinary(*binaryLog_, "nloc/summary", stamp);
+}
+
+
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::logInitToMatlab()
 {
@@ -1002,7 +1054,7 @@ NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::getSt
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 SCALAR NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::getCost() const
 {
-    return intermediateCostBest_ + finalCostBest_;
+    return static_cast<SCALAR>(intermediateCostBest_ + finalCostBest_);
 }
 
 
@@ -1010,7 +1062,7 @@ template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, type
 bool NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::lineSearch()
 {
     // lowest cost
-    scalar_t lowestCostPrevious;
+    merit_t lowestCostPrevious;
 
     // backup controller that led to current trajectory
     u_ff_prev_ = u_ff_;
@@ -1062,6 +1114,8 @@ bool NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
             std::cout << "[LineSearch]: Merit of last rollout:\t" << lowestCost_ << std::endl;
         }
 
+        allocateLineSearchBuffers();
+
         alphaBest_ = performLineSearch();
 
         if (settings_.lineSearchSettings.debugPrint)
@@ -1110,32 +1164,38 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
     ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_shot_alpha,
     ct::core::StateVectorArray<STATE_DIM, SCALAR>& defects_recorded,
     ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>& u_alpha,
-    scalar_t& intermediateCost,
-    scalar_t& finalCost,
-    scalar_t& defectNorm,
-    scalar_t& e_box_norm,
-    scalar_t& e_gen_norm,
+    ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_ref_lqr,
+    merit_t& intermediateCost,
+    merit_t& finalCost,
+    merit_t& defectNorm,
+    merit_t& e_box_norm,
+    merit_t& e_gen_norm,
     StateSubsteps& substepsX,
     ControlSubsteps& substepsU,
     std::atomic_bool* terminationFlag) const
 {
-    intermediateCost = std::numeric_limits<scalar_t>::max();
-    finalCost = std::numeric_limits<scalar_t>::max();
-    defectNorm = std::numeric_limits<scalar_t>::max();
+    intermediateCost = std::numeric_limits<merit_t>::max();
+    finalCost = std::numeric_limits<merit_t>::max();
+    defectNorm = std::numeric_limits<merit_t>::max();
     e_box_norm = 0.0;
     e_gen_norm = 0.0;
 
     if (terminationFlag && *terminationFlag)
         return;
 
-    // update feedforward with weighting alpha
-    u_alpha = delta_u_ff_ * alpha + u_ff_prev_;
+    // update feedforward with weighting alpha (element-wise, such that no temporary arrays are allocated)
+    u_alpha.resize(K_);
+    for (int k = 0; k < K_; k++)
+        u_alpha[k] = delta_u_ff_[k] * alpha + u_ff_prev_[k];
 
-    // update state decision variables with weighting alpha
-    x_alpha = delta_x_ * alpha + x_prev_;
-
-    // update x_lqr reference
-    ct::core::StateVectorArray<STATE_DIM, SCALAR> x_ref_lqr = delta_x_ref_lqr_ * alpha + x_prev_;
+    // update state decision variables and x_lqr reference with weighting alpha
+    x_alpha.resize(K_ + 1);
+    x_ref_lqr.resize(K_ + 1);
+    for (int k = 0; k < K_ + 1; k++)
+    {
+        x_alpha[k] = delta_x_[k] * alpha + x_prev_[k];
+        x_ref_lqr[k] = delta_x_ref_lqr_[k] * alpha + x_prev_[k];
+    }
 
     if (terminationFlag && *terminationFlag)
         return;
@@ -1183,15 +1243,32 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 }
 
 
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
+void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::allocateLineSearchBuffers()
+{
+    // the substeps of a trial have the same size as the current ones, hence all buffers are allocated at once instead
+    // of whenever a thread happens to run its first trial
+    for (LineSearchBuffer& buffer : lineSearchBuffers_)
+    {
+        for (size_t k = 0; k < substepsX_->size(); k++)
+        {
+            if (!(*buffer.substepsX)[k] && (*substepsX_)[k])
+                (*buffer.substepsX)[k] = StateVectorArrayPtr(new StateVectorArray(*(*substepsX_)[k]));
+            if (!(*buffer.substepsU)[k] && (*substepsU_)[k])
+                (*buffer.substepsU)[k] = ControlVectorArrayPtr(new ControlVectorArray(*(*substepsU_)[k]));
+        }
+    }
+}
+
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 bool NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::acceptStep(const SCALAR alpha,
-    const SCALAR intermediateCost,
-    const SCALAR finalCost,
-    const SCALAR defectNorm,
-    const SCALAR e_box_norm,
-    const SCALAR e_gen_norm,
-    const SCALAR lowestMeritPrevious,
-    SCALAR& new_merit)
+    const merit_t intermediateCost,
+    const merit_t finalCost,
+    const merit_t defectNorm,
+    const merit_t e_box_norm,
+    const merit_t e_gen_norm,
+    const merit_t lowestMeritPrevious,
+    merit_t& new_merit)
 {
     switch (settings_.lineSearchSettings.type)
     {
@@ -1217,8 +1294,8 @@ bool NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 
             const ControlVectorArray& lv = lqocSolver_->get_lv();
 
-            SCALAR Delta1 = 0;
-            SCALAR Delta2 = 0;
+            merit_t Delta1 = 0;
+            merit_t Delta2 = 0;
             for (int i = 0; i < K_; i++)
             {
                 // the expected decrease can sometimes become negative and allow an overall increase of cost - account for that below
@@ -1226,7 +1303,7 @@ bool NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
                 Delta2 += (lv[i].transpose() * lqocProblem_->R_[i] * lv[i])(0);
             }
 
-            SCALAR expCostDecr = alpha * (Delta1 + alpha * 0.5 * Delta2);
+            merit_t expCostDecr = alpha * (Delta1 + alpha * 0.5 * Delta2);
 
             if ((lowestMeritPrevious - new_merit) >= (settings_.lineSearchSettings.armijo_parameter * expCostDecr) &&
                 ((lowestMeritPrevious - new_merit) >= 0.0))
@@ -1248,8 +1325,8 @@ bool NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 
             const ControlVectorArray& lv = lqocSolver_->get_lv();
 
-            SCALAR Delta1 = 0;
-            SCALAR Delta2 = 0;
+            merit_t Delta1 = 0;
+            merit_t Delta2 = 0;
             for (int i = 0; i < K_; i++)
             {
                 // the expected decrease can sometimes become negative and allow an overall increase of cost - account for that below
@@ -1257,7 +1334,7 @@ bool NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
                 Delta2 += (lv[i].transpose() * lqocProblem_->R_[i] * lv[i])(0);
             }
 
-            SCALAR expCostDecr = alpha * (Delta1 + alpha * 0.5 * Delta2);
+            merit_t expCostDecr = alpha * (Delta1 + alpha * 0.5 * Delta2);
 
             if (((lowestMeritPrevious - new_merit) >= (settings_.lineSearchSettings.armijo_parameter * expCostDecr)) &&
                 ((lowestMeritPrevious - new_merit) <=
@@ -1366,13 +1443,14 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 {
     firstRollout_ = true;
     iteration_ = 0;
-    d_norm_ = std::numeric_limits<scalar_t>::infinity();
-    lx_norm_ = std::numeric_limits<scalar_t>::infinity();
-    lu_norm_ = std::numeric_limits<scalar_t>::infinity();
-    intermediateCostBest_ = std::numeric_limits<scalar_t>::infinity();
-    finalCostBest_ = std::numeric_limits<scalar_t>::infinity();
-    intermediateCostPrevious_ = std::numeric_limits<scalar_t>::infinity();
-    finalCostPrevious_ = std::numeric_limits<scalar_t>::infinity();
+    d_norm_ = std::numeric_limits<merit_t>::infinity();
+    lx_norm_ = std::numeric_limits<merit_t>::infinity();
+    lu_norm_ = std::numeric_limits<merit_t>::infinity();
+    intermediateCostBest_ = std::numeric_limits<merit_t>::infinity();
+    finalCostBest_ = std::numeric_limits<merit_t>::infinity();
+    intermediateCostPrevious_ = std::numeric_limits<merit_t>::infinity();
+    finalCostPrevious_ = std::numeric_limits<merit_t>::infinity();
+    summaryAllIterations_.clear();
     resetDefects();
 }
 
@@ -1460,6 +1538,13 @@ void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
     summaryAllIterations_.logToMatlab(fileName);
 }
 
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
+void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::setBinaryLog(
+    std::shared_ptr<ct::core::BinaryLogWriter> binaryLog)
+{
+    binaryLog_ = binaryLog;
+}
+
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 const SummaryAllIterations<SCALAR>&
@@ -1468,6 +1553,13 @@ NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::getSu
     return summaryAllIterations_;
 }
 
+template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
+const std::shared_ptr<LQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR>>&
+NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::getLQOCSolver() const
+{
+    return lqocSolver_;
+}
+
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 void NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::resetDefects()
 {
@@ -1525,7 +1617,7 @@ bool NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 SCALAR NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::getTotalDefect() const
 {
-    return d_norm_;
+    return static_cast<SCALAR>(d_norm_);
 }
 
 
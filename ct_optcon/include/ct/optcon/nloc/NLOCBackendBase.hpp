@@ -13,6 +13,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include <ct/optcon/problem/LQOCProblem.hpp>
 
 #include <ct/optcon/solver/lqp/GNRiccatiSolver.hpp>
+#include <ct/optcon/solver/lqp/MixedPrecisionLQOCSolver.hpp>
 #include <ct/optcon/solver/lqp/HPIPMInterface.hpp>
 
 #include <ct/optcon/solver/NLOptConSettings.hpp>
@@ -76,6 +77,18 @@ public:
     typedef std::vector<ControlVectorArrayPtr, Eigen::aligned_allocator<ControlVectorArrayPtr>> ControlSubsteps;
     typedef std::shared_ptr<ControlSubsteps> ControlSubstepsPtr;
 
+    //! trajectories recorded during a single line search trial, swapped with the iterate if the step is accepted
+    struct LineSearchBuffer
+    {
+        StateVectorArray x;
+        StateVectorArray xShot;
+        StateVectorArray d;
+        ControlVectorArray u;
+        StateVectorArray xRefLqr;
+        StateSubstepsPtr substepsX;
+        ControlSubstepsPtr substepsU;
+    };
+
     typedef OptconSystemInterface<STATE_DIM, CONTROL_DIM, OptConProblem_t, SCALAR> systemInterface_t;
     typedef std::shared_ptr<systemInterface_t> systemInterfacePtr_t;
 
@@ -96,6 +109,9 @@ public:
     using feedback_matrix_t = core::FeedbackMatrix<STATE_DIM, CONTROL_DIM, SCALAR>;
 
     using scalar_t = SCALAR;
+
+    //! costs, constraint violations and merits are accumulated in double, also if SCALAR is float
+    using merit_t = double;
     using scalar_array_t = std::vector<SCALAR, Eigen::aligned_allocator<SCALAR>>;
 
     NLOCBackendBase(const OptConProblem_t& optConProblem, const Settings_t& settings);
@@ -158,6 +174,12 @@ public:
      */
     void changeInitialState(const core::StateVector<STATE_DIM, SCALAR>& x0);
 
+    /*!
+     * \brief Shift the warm start of the LQOC solver, e.g. by the time elapsed between two MPC cycles
+     * @param t_shift shift time, rounded to the nearest number of stages
+     */
+    void shiftLQWarmStart(const SCALAR& t_shift);
+
     /*!
      * \brief Change the cost function
      */
@@ -275,12 +297,26 @@ public:
     //! log the initial guess to Matlab
     void logInitToMatlab();
 
+    //! log the trajectories and the summary of the current iteration to the binary log, if one is set
+    /*!
+     * Logs the channels "nloc/t", "nloc/x", "nloc/u_ff", "nloc/L" and "nloc/summary", stamped with the iteration.
+     * Unlike logToMatlab(), this does not require a compile time switch and does not allocate memory, hence it can be
+     * left enabled in MPC.
+     */
+    void logToBinary();
+
     //! return the cost of the solution of the current iteration
     SCALAR getCost() const;
 
     //! return the sum of the L2-norm of the defects along the solution candidate
     SCALAR getTotalDefect() const;
 
+    /*!
+     * @brief restart the iterations, e.g. after a change of the initial state or the horizon
+     *
+     * This also clears the summary of all iterations, which therefore only covers the iterations since the last
+     * reset. In MPC, where every cycle resets the solver, this bounds the summary to a single cycle.
+     */
     void reset();
 
     const core::StateTrajectory<STATE_DIM, SCALAR> getStateTrajectory() const;
@@ -380,8 +416,15 @@ public:
 
     void logSummaryToMatlab(const std::string& fileName);
 
+    //! set a binary log which records every iteration, nullptr disables logging
+    void setBinaryLog(std::shared_ptr<ct::core::BinaryLogWriter> binaryLog);
+
+    //! the summary of all iterations since the last reset()
     const SummaryAllIterations<SCALAR>& getSummary() const;
 
+    //! get the solver of the LQ sub-problems
+    const std::shared_ptr<LQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR>>& getLQOCSolver() const;
+
 protected:
     //! integrate the individual shots
     bool rolloutSingleShot(const size_t threadId,
@@ -468,8 +511,8 @@ protected:
     void computeCostsOfTrajectory(size_t threadId,
         const core::StateVectorArray<STATE_DIM, SCALAR>& x_local,
         const core::ControlVectorArray<CONTROL_DIM, SCALAR>& u_local,
-        scalar_t& intermediateCost,
-        scalar_t& finalCost) const;
+        merit_t& intermediateCost,
+        merit_t& finalCost) const;
 
     /*!
      * @brief Compute box constraint violations for a given set of state and input trajectory
@@ -482,7 +525,7 @@ protected:
     void computeBoxConstraintErrorOfTrajectory(size_t threadId,
         const ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_local,
         const ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>& u_local,
-        scalar_t& e_tot) const;
+        merit_t& e_tot) const;
 
     /*!
      * @brief Compute general constraint violations for a given set of state and input trajectory
@@ -495,7 +538,7 @@ protected:
     void computeGeneralConstraintErrorOfTrajectory(size_t threadId,
         const ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_local,
         const ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>& u_local,
-        scalar_t& e_tot) const;
+        merit_t& e_tot) const;
 
     //! Check if controller with particular alpha is better
     void executeLineSearch(const size_t threadId,
@@ -504,26 +547,30 @@ protected:
         ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_shot_recorded,
         ct::core::StateVectorArray<STATE_DIM, SCALAR>& defects_recorded,
         ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>& u_recorded,
-        scalar_t& intermediateCost,
-        scalar_t& finalCost,
-        scalar_t& defectNorm,
-        scalar_t& e_box_norm,
-        scalar_t& e_gen_norm,
+        ct::core::StateVectorArray<STATE_DIM, SCALAR>& x_ref_lqr,
+        merit_t& intermediateCost,
+        merit_t& finalCost,
+        merit_t& defectNorm,
+        merit_t& e_box_norm,
+        merit_t& e_gen_norm,
         StateSubsteps& substepsX,
         ControlSubsteps& substepsU,
         std::atomic_bool* terminationFlag = nullptr) const;
 
 
+    //! allocate the substep storage of all line search buffers, such that the line search itself does not allocate
+    void allocateLineSearchBuffers();
+
     //! in case of line-search compute new merit and check if to accept step. Returns true if accept step
     bool acceptStep(
         const SCALAR alpha,
-        const SCALAR intermediateCost,
-        const SCALAR finalCost,
-        const SCALAR defectNorm,
-        const SCALAR e_box_norm,
-        const SCALAR e_gen_norm,
-        const SCALAR lowestMeritPrevious,
-        SCALAR& new_merit);
+        const merit_t intermediateCost,
+        const merit_t finalCost,
+        const merit_t defectNorm,
+        const merit_t e_box_norm,
+        const merit_t e_gen_norm,
+        const merit_t lowestMeritPrevious,
+        merit_t& new_merit);
 
     //! Update feedforward controller
     /*!
@@ -535,11 +582,11 @@ protected:
 
     //! compute norm of a discrete array (todo move to core)
     template <typename ARRAY_TYPE, size_t ORDER = 1>
-    SCALAR computeDiscreteArrayNorm(const ARRAY_TYPE& d) const;
+    merit_t computeDiscreteArrayNorm(const ARRAY_TYPE& d) const;
 
     //! compute norm of difference between two discrete arrays (todo move to core)
     template <typename ARRAY_TYPE, size_t ORDER = 1>
-    SCALAR computeDiscreteArrayNorm(const ARRAY_TYPE& a, const ARRAY_TYPE& b) const;
+    merit_t computeDiscreteArrayNorm(const ARRAY_TYPE& a, const ARRAY_TYPE& b) const;
 
     //! compute the norm of the defects trajectory
     /*!
@@ -547,7 +594,7 @@ protected:
      * According to Nocedal and Wright, the l1-norm is "exact" (p.435),  the l2-norm is smooth.
      */
     template <size_t ORDER = 1>
-    SCALAR computeDefectsNorm(const StateVectorArray& d) const;
+    merit_t computeDefectsNorm(const StateVectorArray& d) const;
 
     bool initialized_;
     bool configured_;
@@ -577,19 +624,22 @@ protected:
     StateSubstepsPtr substepsX_;    //! state substeps recorded by integrator during rollouts
     ControlSubstepsPtr substepsU_;  //! control substeps recorded by integrator during rollouts
 
-    SCALAR d_norm_;      //! sum of the norms of all defects (internal constraint)
-    SCALAR e_box_norm_;  //! sum of the norms of all box constraint violations
-    SCALAR e_gen_norm_;  //! sum of the norms of all general constraint violations
-    SCALAR lx_norm_;     //! sum of the norms of state update
-    SCALAR lu_norm_;     //! sum of the norms of control update
+    //! preallocated line search trajectories, one per thread, such that a line search does not allocate memory
+    std::vector<LineSearchBuffer> lineSearchBuffers_;
 
-    scalar_t intermediateCostBest_;
-    scalar_t finalCostBest_;
-    scalar_t lowestCost_;
+    merit_t d_norm_;      //! sum of the norms of all defects (internal constraint)
+    merit_t e_box_norm_;  //! sum of the norms of all box constraint violations
+    merit_t e_gen_norm_;  //! sum of the norms of all general constraint violations
+    merit_t lx_norm_;     //! sum of the norms of state update
+    merit_t lu_norm_;     //! sum of the norms of control update
+
+    merit_t intermediateCostBest_;
+    merit_t finalCostBest_;
+    merit_t lowestCost_;
 
     //! costs of the previous iteration, required to determine convergence
-    scalar_t intermediateCostPrevious_;
-    scalar_t finalCostPrevious_;
+    merit_t intermediateCostPrevious_;
+    merit_t finalCostPrevious_;
 
     scalar_t alphaBest_;
 
@@ -619,6 +669,9 @@ protected:
 
     SummaryAllIterations<SCALAR> summaryAllIterations_;
 
+    //! the binary log, if set
+    std::shared_ptr<ct::core::BinaryLogWriter> binaryLog_;
+
     //! if building with MATLAB support, include matfile
 #ifdef MATLAB
     matlab::MatFile matFile_;
@@ -628,10 +681,11 @@ protected:
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 template <typename ARRAY_TYPE, size_t ORDER>
-SCALAR NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::computeDiscreteArrayNorm(
+typename NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::merit_t
+NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::computeDiscreteArrayNorm(
     const ARRAY_TYPE& d) const
 {
-    SCALAR norm = 0.0;
+    merit_t norm = 0.0;
 
     for (size_t k = 0; k < d.size(); k++)
     {
@@ -643,13 +697,14 @@ SCALAR NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 template <typename ARRAY_TYPE, size_t ORDER>
-SCALAR NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::computeDiscreteArrayNorm(
+typename NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::merit_t
+NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::computeDiscreteArrayNorm(
     const ARRAY_TYPE& a,
     const ARRAY_TYPE& b) const
 {
     assert(a.size() == b.size());
 
-    SCALAR norm = 0.0;
+    merit_t norm = 0.0;
 
     for (size_t k = 0; k < a.size(); k++)
     {
@@ -660,7 +715,8 @@ SCALAR NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR, bool CONTINUOUS>
 template <size_t ORDER>
-SCALAR NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::computeDefectsNorm(
+typename NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::merit_t
+NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::computeDefectsNorm(
     const StateVectorArray& d) const
 {
     return computeDiscreteArrayNorm<StateVectorArray, ORDER>(d);
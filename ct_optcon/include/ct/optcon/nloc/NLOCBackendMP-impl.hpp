@@ -482,24 +482,17 @@ void NLOCBackendMP<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::li
             this->settings_.lineSearchSettings.alpha_0 * std::pow(this->settings_.lineSearchSettings.n_alpha, alphaExp);
 
         //! local variables
-        SCALAR cost = std::numeric_limits<SCALAR>::max();
-        SCALAR intermediateCost = std::numeric_limits<SCALAR>::max();
-        SCALAR finalCost = std::numeric_limits<SCALAR>::max();
-        SCALAR defectNorm = std::numeric_limits<SCALAR>::max();
-        SCALAR e_box_norm = std::numeric_limits<SCALAR>::max();
-        SCALAR e_gen_norm = std::numeric_limits<SCALAR>::max();
-        ct::core::StateVectorArray<STATE_DIM, SCALAR> x_search(this->K_ + 1);
-        ct::core::StateVectorArray<STATE_DIM, SCALAR> x_shot_search(this->K_ + 1);
-        ct::core::StateVectorArray<STATE_DIM, SCALAR> defects_recorded(
-            this->K_ + 1, ct::core::StateVector<STATE_DIM, SCALAR>::Zero());
-        ct::core::ControlVectorArray<CONTROL_DIM, SCALAR> u_recorded(this->K_);
-        typename Base::StateSubstepsPtr substepsX =
-            typename Base::StateSubstepsPtr(new typename Base::StateSubsteps(this->K_ + 1));
-        typename Base::ControlSubstepsPtr substepsU =
-            typename Base::ControlSubstepsPtr(new typename Base::ControlSubsteps(this->K_ + 1));
-
-        this->executeLineSearch(threadId, alpha, x_search, x_shot_search, defects_recorded, u_recorded,
-            intermediateCost, finalCost, defectNorm, e_box_norm, e_gen_norm, *substepsX, *substepsU, &alphaBestFound_);
+        merit_t cost = std::numeric_limits<merit_t>::max();
+        merit_t intermediateCost = std::numeric_limits<merit_t>::max();
+        merit_t finalCost = std::numeric_limits<merit_t>::max();
+        merit_t defectNorm = std::numeric_limits<merit_t>::max();
+        merit_t e_box_norm = std::numeric_limits<merit_t>::max();
+        merit_t e_gen_norm = std::numeric_limits<merit_t>::max();
+        typename Base::LineSearchBuffer& search = this->lineSearchBuffers_[threadId];
+
+        this->executeLineSearch(threadId, alpha, search.x, search.xShot, search.d, search.u, search.xRefLqr,
+            intermediateCost, finalCost, defectNorm, e_box_norm, e_gen_norm, *search.substepsX, *search.substepsU,
+            &alphaBestFound_);
 
         lineSearchResultMutex_.lock();
         
@@ -534,12 +527,12 @@ void NLOCBackendMP<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::li
             this->e_box_norm_ = e_box_norm;
             this->e_gen_norm_ = e_gen_norm;
             this->lowestCost_ = cost;
-            this->x_.swap(x_search);
-            this->xShot_.swap(x_shot_search);
-            this->u_ff_.swap(u_recorded);
-            this->d_.swap(defects_recorded);
-            this->substepsX_ = substepsX;
-            this->substepsU_ = substepsU;
+            this->x_.swap(search.x);
+            this->xShot_.swap(search.xShot);
+            this->u_ff_.swap(search.u);
+            this->d_.swap(search.d);
+            this->substepsX_.swap(search.substepsX);
+            this->substepsU_.swap(search.substepsU);
         }
         else
         {
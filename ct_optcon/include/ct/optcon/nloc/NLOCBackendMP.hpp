@@ -35,6 +35,7 @@ public:
 
     typedef NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS> Base;
     typedef typename Base::OptConProblem_t OptConProblem_t;
+    typedef typename Base::merit_t merit_t;
 
     NLOCBackendMP(const OptConProblem_t& optConProblem, const NLOptConSettings& settings);
 
@@ -136,7 +137,7 @@ private:
     size_t KMax_;
     size_t KMin_;
 
-    SCALAR lowestCostPrevious_;
+    merit_t lowestCostPrevious_;
 };
 
 
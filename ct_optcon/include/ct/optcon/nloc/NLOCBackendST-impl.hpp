@@ -86,27 +86,18 @@ SCALAR NLOCBackendST<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
 
         iterations++;
 
-        SCALAR cost = std::numeric_limits<SCALAR>::max();
-        SCALAR intermediateCost = std::numeric_limits<SCALAR>::max();
-        SCALAR finalCost = std::numeric_limits<SCALAR>::max();
-        SCALAR defectNorm = std::numeric_limits<SCALAR>::max();
-        SCALAR e_box_norm = std::numeric_limits<SCALAR>::max();
-        SCALAR e_gen_norm = std::numeric_limits<SCALAR>::max();
+        merit_t cost = std::numeric_limits<merit_t>::max();
+        merit_t intermediateCost = std::numeric_limits<merit_t>::max();
+        merit_t finalCost = std::numeric_limits<merit_t>::max();
+        merit_t defectNorm = std::numeric_limits<merit_t>::max();
+        merit_t e_box_norm = std::numeric_limits<merit_t>::max();
+        merit_t e_gen_norm = std::numeric_limits<merit_t>::max();
 
-        ct::core::StateVectorArray<STATE_DIM, SCALAR> x_search(this->K_ + 1);
-        ct::core::StateVectorArray<STATE_DIM, SCALAR> x_shot_search(this->K_ + 1);
-        ct::core::StateVectorArray<STATE_DIM, SCALAR> defects_recorded(
-            this->K_ + 1, ct::core::StateVector<STATE_DIM, SCALAR>::Zero());
-        ct::core::ControlVectorArray<CONTROL_DIM, SCALAR> u_recorded(this->K_);
+        typename Base::LineSearchBuffer& search = this->lineSearchBuffers_[this->settings_.nThreads];
 
-        typename Base::StateSubstepsPtr substepsX =
-            typename Base::StateSubstepsPtr(new typename Base::StateSubsteps(this->K_ + 1));
-        typename Base::ControlSubstepsPtr substepsU =
-            typename Base::ControlSubstepsPtr(new typename Base::ControlSubsteps(this->K_ + 1));
-
-
-        this->executeLineSearch(this->settings_.nThreads, alpha, x_search, x_shot_search, defects_recorded, u_recorded,
-            intermediateCost, finalCost, defectNorm, e_box_norm, e_gen_norm, *substepsX, *substepsU);
+        this->executeLineSearch(this->settings_.nThreads, alpha, search.x, search.xShot, search.d, search.u,
+            search.xRefLqr, intermediateCost, finalCost, defectNorm, e_box_norm, e_gen_norm, *search.substepsX,
+            *search.substepsU);
 
         // compute new merit and check for step acceptance
         bool stepAccepted =
@@ -145,9 +136,9 @@ SCALAR NLOCBackendST<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
             // compute update norms separately, as they are typically different from pure lqoc solver updates
             this->lu_norm_ =
                 this->template computeDiscreteArrayNorm<ct::core::ControlVectorArray<CONTROL_DIM, SCALAR>, 2>(
-                    u_recorded, this->u_ff_prev_);
+                    search.u, this->u_ff_prev_);
             this->lx_norm_ = this->template computeDiscreteArrayNorm<ct::core::StateVectorArray<STATE_DIM, SCALAR>, 2>(
-                x_search, this->x_prev_);
+                search.x, this->x_prev_);
 
             alphaBest = alpha;
             this->intermediateCostBest_ = intermediateCost;
@@ -155,14 +146,14 @@ SCALAR NLOCBackendST<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>::
             this->d_norm_ = defectNorm;
             this->e_box_norm_ = e_box_norm;
             this->e_gen_norm_ = e_gen_norm;
-            this->x_prev_ = x_search;
+            this->x_prev_ = search.x;
             this->lowestCost_ = cost;
-            this->x_.swap(x_search);
-            this->xShot_.swap(x_shot_search);
-            this->u_ff_.swap(u_recorded);
-            this->d_.swap(defects_recorded);
-            this->substepsX_ = substepsX;
-            this->substepsU_ = substepsU;
+            this->x_.swap(search.x);
+            this->xShot_.swap(search.xShot);
+            this->u_ff_.swap(search.u);
+            this->d_.swap(search.d);
+            this->substepsX_.swap(search.substepsX);
+            this->substepsU_.swap(search.substepsU);
             break;
         }
     }  // end while
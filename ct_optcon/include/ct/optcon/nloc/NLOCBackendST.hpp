@@ -29,6 +29,7 @@ public:
 
     typedef NLOCBackendBase<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS> Base;
     typedef typename Base::OptConProblem_t OptConProblem_t;
+    typedef typename Base::merit_t merit_t;
 
     NLOCBackendST(const OptConProblem_t& optConProblem, const NLOptConSettings& settings);
 
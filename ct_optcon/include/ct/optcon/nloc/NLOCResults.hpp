@@ -42,6 +42,42 @@ struct SummaryAllIterations
     //! smallest eigenvalues
     std::vector<SCALAR> smallestEigenvalues;
 
+    //! reserve memory for a number of iterations
+    void reserve(size_t nIterations)
+    {
+        iterations.reserve(nIterations);
+        defect_l1_norms.reserve(nIterations);
+        defect_l2_norms.reserve(nIterations);
+        e_box_norms.reserve(nIterations);
+        e_gen_norms.reserve(nIterations);
+        lx_norms.reserve(nIterations);
+        lu_norms.reserve(nIterations);
+        intermediateCosts.reserve(nIterations);
+        finalCosts.reserve(nIterations);
+        totalCosts.reserve(nIterations);
+        merits.reserve(nIterations);
+        stepSizes.reserve(nIterations);
+        smallestEigenvalues.reserve(nIterations);
+    }
+
+    //! erase the log, keeping the reserved memory
+    void clear()
+    {
+        iterations.clear();
+        defect_l1_norms.clear();
+        defect_l2_norms.clear();
+        e_box_norms.clear();
+        e_gen_norms.clear();
+        lx_norms.clear();
+        lu_norms.clear();
+        intermediateCosts.clear();
+        finalCosts.clear();
+        totalCosts.clear();
+        merits.clear();
+        stepSizes.clear();
+        smallestEigenvalues.clear();
+    }
+
     //! print summary of the last iteration with desired numeric precision
     template <int NUM_PRECISION = 12>
     void printSummaryLastIteration()
@@ -88,6 +124,23 @@ struct SummaryAllIterations
 #endif
     }
 
+    //! log the last iteration as a single vector to a binary log
+    /*!
+     * The entries are: iteration, defect L1 norm, defect L2 norm, box constraint error, general constraint error,
+     * lx norm, lu norm, intermediate cost, final cost, total cost, merit, step size and smallest eigenvalue.
+     */
+    void logLastIterationToBinary(ct::core::BinaryLogWriter& log, const char* channel, double stamp)
+    {
+        if (iterations.empty())
+            return;
+
+        Eigen::Matrix<SCALAR, 13, 1> summary;
+        summary << static_cast<SCALAR>(iterations.back()), defect_l1_norms.back(), defect_l2_norms.back(),
+            e_box_norms.back(), e_gen_norms.back(), lx_norms.back(), lu_norms.back(), intermediateCosts.back(),
+            finalCosts.back(), totalCosts.back(), merits.back(), stepSizes.back(), smallestEigenvalues.back();
+        log.log(channel, summary, stamp);
+    }
+
 //! if building with MATLAB support, include matfile
 #ifdef MATLAB
     matlab::MatFile matFile_;
@@ -148,6 +148,7 @@ bool MultipleShooting<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>:
 
 
     this->backend_->printSummary();
+    this->backend_->logToBinary();
 
 #ifdef MATLAB_FULL_LOG
     this->backend_->logToMatlab(this->backend_->iteration());
@@ -273,6 +274,7 @@ bool MultipleShooting<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALAR, CONTINUOUS>:
     }
 
     this->backend_->printSummary();
+    this->backend_->logToBinary();
 
 #ifdef MATLAB_FULL_LOG
     this->backend_->logToMatlab(this->backend_->iteration());
@@ -52,6 +52,15 @@ public:
      */
     virtual void prepareJacobianEvaluation() = 0;
 
+    /**
+     * @brief      Gets called before the constraint Hessian evaluation. Can be
+     *             overloaded to evaluate the constraint Hessians in parallel
+     *
+     * @param[in]  optVec  The optimization variables
+     * @param[in]  lambda  The constraint multipliers
+     */
+    virtual void prepareHessianEvaluation(const Eigen::VectorXd& optVec, const Eigen::VectorXd& lambda) {}
+
 
     /**
      * @brief      Writes the constraint evaluations into the large constraint
@@ -232,6 +241,8 @@ public:
     {
 #if EIGEN_VERSION_AT_LEAST(3, 3, 0)
 
+        prepareHessianEvaluation(optVec, lambda);
+
         std::vector<Eigen::Triplet<SCALAR>, Eigen::aligned_allocator<Eigen::Triplet<SCALAR>>> triplets;
 
         size_t count = 0;
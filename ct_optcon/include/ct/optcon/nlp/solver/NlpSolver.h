@@ -82,6 +82,17 @@ public:
 	 */
     virtual void prepareWarmStart(const size_t maxIterations) = 0;
 
+    /**
+	 * @brief      Shifts the current iterate by a number of stages, e.g. to warm start the next MPC cycle. Only
+	 *             supported by solvers which know the stage structure of the nlp
+	 *
+	 * @param[in]  nStages  The number of stages to shift
+	 */
+    virtual void shiftIterate(const size_t nStages)
+    {
+        throw std::runtime_error("NlpSolver: shifting the iterate is not supported by this solver.");
+    }
+
     bool isInitialized() { return isInitialized_; }
 protected:
     std::shared_ptr<Nlp<SCALAR>> nlp_; /*!< The non linear program*/
@@ -9,6 +9,8 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/info_parser.hpp>
 
+#include <ct/optcon/solver/NLOptConSettings.hpp>
+
 namespace ct {
 namespace optcon {
 
@@ -20,6 +22,7 @@ enum class NlpSolverType : uint8_t
 {
     IPOPT = 0,
     SNOPT = 1,
+    SQP = 2,
     num_types_solver
 };
 
@@ -253,6 +256,114 @@ public:
     }
 };
 
+/**
+ * @ingroup    NLP
+ *
+ * @brief      SqpSolver settings
+ */
+class SqpSettings
+{
+public:
+    //! the approximation of the stage blocks of the Lagrangian Hessian
+    enum HESSIAN_APPROXIMATION
+    {
+        EXACT = 0,               //! second order sensitivities, requires DmsProblem::setExactHessianSystem()
+        BFGS = 1,                //! damped BFGS update per stage from the gradients and Jacobians of the iterations
+        FINITE_DIFFERENCES = 2   //! finite differences of the gradient of the Lagrangian in every iteration
+    };
+
+    /**
+	 * @brief      Default constructor, sets the parameters to default values
+	 */
+    SqpSettings()
+        : maxIterations_(100),
+          stepTolerance_(1e-6),
+          constraintTolerance_(1e-6),
+          lqocSolver_(NLOptConSettings::GNRICCATI_SOLVER),
+          hessianRegularization_(1e-6),
+          hessianPerturbation_(1e-6),
+          maxLineSearchSteps_(20),
+          armijoParameter_(1e-4),
+          contractionRate_(0.5),
+          lagrangianHessian_(true),
+          hessianApproximation_(BFGS),
+          printLevel_(0)
+    {
+    }
+
+    int maxIterations_;                           //! maximum number of SQP iterations
+    double stepTolerance_;                        //! convergence threshold on the infinity norm of the step
+    double constraintTolerance_;                  //! convergence threshold on the l1 constraint violation
+    NLOptConSettings::LQOCP_SOLVER lqocSolver_;   //! the solver for the stage-wise QP subproblems
+    double hessianRegularization_;                //! lower bound on the eigenvalues of the stage Hessians
+    double hessianPerturbation_;                  //! relative perturbation for the finite-difference Hessians
+    int maxLineSearchSteps_;                      //! maximum number of backtracking steps
+    double armijoParameter_;                      //! sufficient decrease parameter of the merit function
+    double contractionRate_;                      //! step size contraction per backtracking step
+    bool lagrangianHessian_;                      //! add the curvature of the continuity constraints to the Hessian
+    HESSIAN_APPROXIMATION hessianApproximation_;  //! how the stage Hessians are obtained
+    int printLevel_;                              //! 0: silent, 1: summary, 2: every iteration
+
+    /**
+	 * @brief      Prints out information about the settings
+	 */
+    void print()
+    {
+        std::cout << "SQP SETTINGS: " << std::endl;
+        std::cout << "MaxIterations: " << maxIterations_ << std::endl;
+        std::cout << "LQOC solver: " << (lqocSolver_ == NLOptConSettings::HPIPM_SOLVER ? "HPIPM" : "GNRICCATI")
+                  << std::endl;
+        std::cout << "Hessian: " << (lagrangianHessian_ ? "Lagrangian" : "cost only (Gauss-Newton)") << std::endl;
+        const std::string approximations[] = {"exact", "BFGS", "finite differences"};
+        std::cout << "Hessian approximation: " << approximations[hessianApproximation_] << std::endl;
+    }
+
+    /**
+     * @brief      Checks whether to settings are filled with meaningful values
+     *
+     * @return     Returns true of the parameters are ok
+     */
+    bool parametersOk() const
+    {
+        return (maxIterations_ > 0) && (stepTolerance_ > 0.0) && (constraintTolerance_ > 0.0) &&
+               (hessianRegularization_ > 0.0) && (hessianPerturbation_ > 0.0) && (armijoParameter_ > 0.0) &&
+               (armijoParameter_ < 0.5) && (contractionRate_ > 0.0) && (contractionRate_ < 1.0) &&
+               (hessianApproximation_ >= EXACT) && (hessianApproximation_ <= FINITE_DIFFERENCES);
+    }
+
+    /**
+     * @brief      Loads the settings from a .info file
+     *
+     * @param[in]  filename  The filename
+     * @param[in]  verbose   True if parameters to be printed out
+     * @param[in]  ns        The namespace in the .info file
+     */
+    void load(const std::string& filename, bool verbose = true, const std::string& ns = "dms.solver.sqp")
+    {
+        boost::property_tree::ptree pt;
+        boost::property_tree::read_info(filename, pt);
+
+        maxIterations_ = pt.get<int>(ns + ".MaxIterations");
+        IpoptSettings::setParameterIfExists(pt, stepTolerance_, "StepTolerance", ns);
+        IpoptSettings::setParameterIfExists(pt, constraintTolerance_, "ConstraintTolerance", ns);
+        IpoptSettings::setParameterIfExists(pt, hessianRegularization_, "HessianRegularization", ns);
+        IpoptSettings::setParameterIfExists(pt, hessianPerturbation_, "HessianPerturbation", ns);
+        IpoptSettings::setParameterIfExists(pt, maxLineSearchSteps_, "MaxLineSearchSteps", ns);
+        IpoptSettings::setParameterIfExists(pt, armijoParameter_, "ArmijoParameter", ns);
+        IpoptSettings::setParameterIfExists(pt, contractionRate_, "ContractionRate", ns);
+        IpoptSettings::setParameterIfExists(pt, lagrangianHessian_, "LagrangianHessian", ns);
+        IpoptSettings::setParameterIfExists(pt, printLevel_, "Verbosity", ns);
+
+        int lqocSolver = static_cast<int>(lqocSolver_);
+        IpoptSettings::setParameterIfExists(pt, lqocSolver, "LqocSolver", ns);
+        lqocSolver_ = static_cast<NLOptConSettings::LQOCP_SOLVER>(lqocSolver);
+
+        int hessianApproximation = static_cast<int>(hessianApproximation_);
+        IpoptSettings::setParameterIfExists(pt, hessianApproximation, "HessianApproximation", ns);
+        hessianApproximation_ = static_cast<HESSIAN_APPROXIMATION>(hessianApproximation);
+    }
+};
+
 /**
  * @ingroup    NLP
  *
@@ -274,6 +385,7 @@ public:
     bool useGeneratedConstraintJacobian_;
     SnoptSettings snoptSettings_;
     IpoptSettings ipoptSettings_;
+    SqpSettings sqpSettings_;
 
     /**
      * @brief      Prints out settings
@@ -298,6 +410,8 @@ public:
             ipoptSettings_.print();
         else if (solverType_ == NlpSolverType::SNOPT)
             snoptSettings_.print();
+        else if (solverType_ == NlpSolverType::SQP)
+            sqpSettings_.print();
     }
 
     /**
@@ -311,6 +425,8 @@ public:
             return ipoptSettings_.parametersOk();
         else if (solverType_ == NlpSolverType::SNOPT)
             return snoptSettings_.parametersOk();
+        else if (solverType_ == NlpSolverType::SQP)
+            return sqpSettings_.parametersOk();
         else
             return false;
     }
@@ -335,6 +451,8 @@ public:
             ipoptSettings_.load(filename, verbose, ns + ".ipopt");
         else if (solverType_ == NlpSolverType::SNOPT)
             snoptSettings_.load(filename, verbose, ns + ".snopt");
+        else if (solverType_ == NlpSolverType::SQP)
+            sqpSettings_.load(filename, verbose, ns + ".sqp");
 
         if (verbose)
         {
@@ -345,7 +463,7 @@ public:
 
 private:
     std::map<NlpSolverType, std::string> solverToString = {
-        {NlpSolverType::IPOPT, "IPOPT"}, {NlpSolverType::SNOPT, "SNOPT"}};
+        {NlpSolverType::IPOPT, "IPOPT"}, {NlpSolverType::SNOPT, "SNOPT"}, {NlpSolverType::SQP, "SQP"}};
 };
 
 
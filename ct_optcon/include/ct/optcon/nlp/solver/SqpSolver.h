@@ -0,0 +1,244 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <ct/optcon/nlp/Nlp.h>
+#include <ct/optcon/dms/dms_core/OptVectorDms.h>
+#include <ct/optcon/problem/LQOCProblem.hpp>
+#include <ct/optcon/solver/lqp/GNRiccatiSolver.hpp>
+#include <ct/optcon/solver/lqp/HPIPMInterface.hpp>
+
+#include "NlpSolver.h"
+
+namespace ct {
+namespace optcon {
+
+/**
+ * @ingroup    NLP
+ *
+ * @brief      A structure-exploiting SQP solver for NLPs with the stage-wise layout of OptVectorDms
+ *
+ * The optimization vector is interpreted as the sequence of node pairs \f$ (s_i, q_i), i = 0, \ldots, N \f$ and
+ * the constraints are expected in the order of ConstraintsContainerDms, i.e. the initial state constraint, followed
+ * by the continuity constraints of every shot and arbitrary constraints which only depend on the variables of a
+ * single node. Each QP subproblem is therefore a linear-quadratic optimal control problem which is solved in
+ * \f$ O(N) \f$ by one of the LQOCSolvers (GNRiccatiSolver for equality constrained problems, HPIPMInterface
+ * if inequality constraints or variable bounds are present). The last control \f$ q_N \f$ is handled by
+ * appending a stage with identity dynamics.
+ *
+ * The Hessian of the QP is the Hessian of the Lagrangian \f$ f + \lambda^T c \f$ w.r.t. the continuity
+ * constraints. As neither the cost nor the continuity constraints couple the nodes nonlinearly, it is block diagonal
+ * with one block per stage, which is obtained according to SqpSettings::hessianApproximation_
+ * - EXACT: from the second order sensitivities of the shots, see DmsProblem::setExactHessianSystem()
+ * - BFGS: by a damped BFGS update of every block from the change of the gradient of the Lagrangian between two
+ *   iterations. It reuses the gradients and Jacobians of the linearizations, the blocks are initialized with the
+ *   finite-difference Hessian of the cost.
+ * - FINITE_DIFFERENCES: by finite differences of the gradient of the Lagrangian, which costs \f$ n_x + n_u \f$
+ *   additional constraint Jacobian evaluations per iteration
+ *
+ * The multipliers are recovered from the stationarity conditions of the QP w.r.t. the next states by a backward
+ * recursion over the shots. Every stage block is projected onto the positive definite matrices. Globalization uses a
+ * backtracking line search on the \f$ \ell_1 \f$ merit function.
+ *
+ * @note       Only continuity constraints based on zero-order-hold control splines are supported.
+ * @note       The curvature of the stage-wise inequality constraints is not included, as the LQOCSolvers do not
+ *             return their multipliers. If inequality constraints or bounds depend on the states, the continuity
+ *             multipliers can not be recovered either, and the Hessian falls back to the cost Hessian
+ *             (Gauss-Newton). The same applies if SqpSettings::lagrangianHessian_ is disabled.
+ *
+ * @tparam     STATE_DIM    The state dimension
+ * @tparam     CONTROL_DIM  The control dimension
+ */
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+class SqpSolver : public NlpSolver
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    static const size_t STAGE_DIM = STATE_DIM + CONTROL_DIM;
+
+    using BASE = NlpSolver;
+    using Nlp_t = tpl::Nlp<double>;
+    using VectorXs = Eigen::VectorXd;
+    using VectorXi = Eigen::VectorXi;
+    using MapVecXs = typename Nlp_t::MapVecXs;
+    using MapVecXi = typename Nlp_t::MapVecXi;
+    using MapConstVecXs = typename Nlp_t::MapConstVecXs;
+
+    typedef OptVectorDms<STATE_DIM, CONTROL_DIM, double> OptVectorDms_t;
+    typedef LQOCProblem<STATE_DIM, CONTROL_DIM> LQOCProblem_t;
+    typedef LQOCSolver<STATE_DIM, CONTROL_DIM> LQOCSolver_t;
+
+    typedef Eigen::Matrix<double, STAGE_DIM, STAGE_DIM> stage_matrix_t;
+    typedef std::vector<stage_matrix_t, Eigen::aligned_allocator<stage_matrix_t>> stage_matrix_array_t;
+    typedef Eigen::Matrix<double, STATE_DIM, STAGE_DIM> stage_jacobian_t;
+    typedef std::vector<stage_jacobian_t, Eigen::aligned_allocator<stage_jacobian_t>> stage_jacobian_array_t;
+
+    /**
+	 * @brief      Custom constructor
+	 *
+	 * @param[in]  nlp       The nlp
+	 * @param[in]  w         The optimization variables of the nlp, defining the stage structure
+	 * @param[in]  settings  The nlp settings
+	 */
+    SqpSolver(std::shared_ptr<Nlp_t> nlp, std::shared_ptr<OptVectorDms_t> w, const NlpSolverSettings& settings);
+
+    /**
+	 * @brief      Destructor
+	 */
+    ~SqpSolver() override = default;
+
+    void configureDerived(const NlpSolverSettings& settings) override;
+
+    bool solve() override;
+
+    /**
+	 * @brief      Starts the next solve from the last iterate instead of the initial guess
+	 *
+	 * @param[in]  maxIterations  The maximum number of SQP iterations of the next solve
+	 */
+    void prepareWarmStart(size_t maxIterations) override;
+
+    /**
+	 * @brief      Shifts the current iterate by a number of nodes for MPC warm starts. The last node is repeated.
+	 *             Call prepareWarmStart() afterwards to start the next solve from the shifted iterate.
+	 *
+	 * @param[in]  nNodes  The number of nodes to shift
+	 */
+    void shiftIterate(const size_t nNodes) override;
+
+    //! the number of SQP iterations of the last solve
+    size_t getIterationCount() const { return iterations_; }
+    //! the l1 norm of the constraint violation at the last iterate
+    double getConstraintViolation() const { return violation_; }
+    //! the multiplier estimates of the continuity constraints at the last iterate, zero for all other constraints
+    const VectorXs& getMultipliers() const { return lambda_; }
+    //! true if the Hessian contains the curvature of the continuity constraints
+    bool usesLagrangianHessian() const { return useMultipliers_; }
+
+private:
+    /**
+	 * @brief      Analyzes the Jacobian sparsity pattern and assigns every constraint row to its stage
+	 */
+    void setupStructure();
+
+    /**
+	 * @brief      Sets the iterate in the nlp
+	 */
+    void setIterate(const VectorXs& x);
+
+    /**
+	 * @brief      Evaluates the cost and the l1 constraint violation at the iterate set in the nlp
+	 */
+    double evaluateCost(double& violation);
+
+    /**
+	 * @brief      Evaluates the gradient of the Lagrangian w.r.t. the continuity constraints at the iterate set in the
+	 *             nlp, or the cost gradient only if withMultipliers is false
+	 */
+    void evaluateLagrangianGradient(VectorXs& gradient, bool withMultipliers);
+
+    /**
+	 * @brief      Computes the stage blocks of the Lagrangian Hessian at x by finite differences of its gradient
+	 */
+    void computeStageHessians(const VectorXs& x, bool withMultipliers);
+
+    /**
+	 * @brief      Scatters the exact Hessian of the Lagrangian at the iterate set in the nlp into the stage blocks
+	 */
+    void computeExactHessians();
+
+    /**
+	 * @brief      Updates the stage blocks by the damped BFGS formula with the step from the last linearization to x
+	 */
+    void updateBfgsHessians(const VectorXs& x);
+
+    /**
+	 * @brief      Symmetrizes the stage blocks and projects them onto the positive definite matrices
+	 */
+    void projectHessians();
+
+    /**
+	 * @brief      Recovers the multipliers of the continuity constraints from the solution of the QP
+	 */
+    void computeMultipliers(const VectorXs& step);
+
+    /**
+	 * @brief      Fills the LQOCProblem with the linearization at the iterate set in the nlp
+	 */
+    void linearize(const VectorXs& x);
+
+    /**
+	 * @brief      Solves the QP subproblem and assembles the step
+	 */
+    void solveQP(VectorXs& step);
+
+    //! index of the component of the stacked stage vector (s_i, q_i) in the optimization vector
+    size_t nlpIndex(size_t stage, size_t offset) const
+    {
+        return offset < STATE_DIM ? w_->getStateIndex(stage) + offset
+                                  : w_->getControlIndex(stage) + offset - STATE_DIM;
+    }
+
+    //! true if the bound is not infinite
+    static bool isFinite(double bound) { return std::abs(bound) < 1e19; }
+
+    std::shared_ptr<OptVectorDms_t> w_;
+    SqpSettings sqpSettings_;
+    NLOptConSettings lqocSettings_;
+
+    std::shared_ptr<LQOCProblem_t> lqocProblem_;
+    std::shared_ptr<LQOCSolver_t> lqocSolver_;
+
+    size_t N_;  //! number of shots
+    size_t n_;  //! number of variables
+    size_t m_;  //! number of constraints
+
+    std::vector<int> colStage_;   //! stage of every variable
+    std::vector<int> colOffset_;  //! position of every variable in the stacked stage vector (s_i, q_i)
+    VectorXi iRow_;
+    VectorXi jCol_;
+    VectorXi iRowHessian_;  //! the lower triangular sparsity pattern of the exact Hessian
+    VectorXi jColHessian_;
+
+    std::vector<std::vector<int>> stageRows_;       //! the inequality constraint rows of every stage
+    std::vector<int> rowStage_;                     //! stage of every inequality row, -1 otherwise
+    std::vector<int> rowIndex_;                     //! index of an inequality row within its stage
+    std::vector<std::vector<int>> stageBoundCols_;  //! the bounded variables of every stage
+    bool useMultipliers_;                           //! add the curvature of the continuity constraints
+
+    VectorXs x_;
+    VectorXs g_;
+    VectorXs gradient_;
+    VectorXs jacobian_;
+    VectorXs gLb_;
+    VectorXs gUb_;
+    VectorXs xLb_;
+    VectorXs xUb_;
+    VectorXs lambda_;    //! the multiplier estimates at the current iterate
+    VectorXs lambdaQP_;  //! the multipliers of the last QP
+    VectorXs hessianValues_;
+
+    bool bfgsInitialized_;  //! the BFGS blocks have been initialized in the current solve
+    VectorXs xPrevious_;    //! the iterate of the last linearization
+    VectorXs gradientPrevious_;
+    VectorXs jacobianPrevious_;
+
+    stage_matrix_array_t hessians_;
+    stage_jacobian_array_t continuityJacobians_;  //! [d c_i / d s_i, d c_i / d q_i]
+    std::vector<core::StateVector<STATE_DIM>, Eigen::aligned_allocator<core::StateVector<STATE_DIM>>> diagonals_;
+
+    double mu_;
+    bool warmStart_;
+    int maxIterations_;
+    size_t iterations_;
+    double violation_;
+};
+
+}  // namespace optcon
+}  // namespace ct
+
+#include "implementation/SqpSolver-impl.h"
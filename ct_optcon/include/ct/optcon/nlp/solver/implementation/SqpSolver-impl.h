@@ -0,0 +1,681 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+namespace ct {
+namespace optcon {
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+SqpSolver<STATE_DIM, CONTROL_DIM>::SqpSolver(std::shared_ptr<Nlp_t> nlp,
+    std::shared_ptr<OptVectorDms_t> w,
+    const NlpSolverSettings& settings)
+    : BASE(nlp, settings),
+      w_(w),
+      lqocProblem_(new LQOCProblem_t()),
+      N_(0),
+      n_(0),
+      m_(0),
+      useMultipliers_(false),
+      bfgsInitialized_(false),
+      mu_(1.0),
+      warmStart_(false),
+      maxIterations_(settings.sqpSettings_.maxIterations_),
+      iterations_(0),
+      violation_(0.0)
+{
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::configureDerived(const NlpSolverSettings& settings)
+{
+    if (!settings.sqpSettings_.parametersOk())
+        throw std::runtime_error("SqpSolver: invalid settings.");
+
+    sqpSettings_ = settings.sqpSettings_;
+
+    lqocSettings_.lqocp_solver = sqpSettings_.lqocSolver_;
+    lqocSettings_.epsilon = sqpSettings_.hessianRegularization_;
+
+    if (sqpSettings_.lqocSolver_ == NLOptConSettings::GNRICCATI_SOLVER)
+    {
+        lqocSolver_ = std::shared_ptr<LQOCSolver_t>(new GNRiccatiSolver<STATE_DIM, CONTROL_DIM>());
+    }
+    else if (sqpSettings_.lqocSolver_ == NLOptConSettings::HPIPM_SOLVER)
+    {
+#ifdef HPIPM
+        lqocSolver_ = std::shared_ptr<LQOCSolver_t>(new HPIPMInterface<STATE_DIM, CONTROL_DIM>());
+#else
+        throw std::runtime_error("HPIPM selected but not built.");
+#endif
+    }
+    else
+        throw std::runtime_error("SqpSolver: solver for the QP subproblems wrongly specified.");
+
+    lqocSolver_->configure(lqocSettings_);
+
+    this->isInitialized_ = true;
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+bool SqpSolver<STATE_DIM, CONTROL_DIM>::solve()
+{
+    if (!this->isInitialized_)
+        configureDerived(this->settings_);
+
+    setupStructure();
+
+    const int maxIterations = warmStart_ ? maxIterations_ : sqpSettings_.maxIterations_;
+    if (warmStart_)
+        x_ = w_->getOptimizationVars();
+    else
+    {
+        x_.resize(n_);
+        MapVecXs xMap(x_.data(), n_);
+        this->nlp_->getInitialGuess(n_, xMap);
+    }
+    if (!warmStart_ || static_cast<size_t>(lambda_.rows()) != m_)
+        lambda_.setZero(m_);
+    warmStart_ = false;
+    bfgsInitialized_ = false;
+
+    // satisfy the initial state constraint s_0 - x_0 = 0 exactly, such that all QPs have a fixed initial state
+    setIterate(x_);
+    MapVecXs gMap(g_.data(), m_);
+    this->nlp_->evaluateConstraints(gMap);
+    x_.segment(w_->getStateIndex(0), STATE_DIM) -= g_.head(STATE_DIM);
+    setIterate(x_);
+
+    double violation;
+    double cost = evaluateCost(violation);
+
+    VectorXs step(n_);
+    VectorXs xTrial(n_);
+    bool converged = false;
+    iterations_ = 0;
+
+    while (static_cast<int>(iterations_) < maxIterations)
+    {
+        linearize(x_);
+        solveQP(step);
+        computeMultipliers(step);
+        iterations_++;
+
+        if (step.template lpNorm<Eigen::Infinity>() < sqpSettings_.stepTolerance_ &&
+            violation < sqpSettings_.constraintTolerance_)
+        {
+            converged = true;
+            break;
+        }
+
+        // update the penalty parameter such that the step is a descent direction of the merit function
+        const double gradientStep = gradient_.dot(step);
+        double curvature = 0.0;
+        for (size_t i = 0; i < N_ + 1; i++)
+        {
+            Eigen::Matrix<double, STAGE_DIM, 1> z;
+            for (size_t j = 0; j < STAGE_DIM; j++)
+                z(j) = step(nlpIndex(i, j));
+            curvature += z.dot(hessians_[i] * z);
+        }
+
+        if (violation > sqpSettings_.constraintTolerance_)
+        {
+            const double rho = 0.1;
+            const double muMin = (gradientStep + 0.5 * curvature) / ((1.0 - rho) * violation);
+            if (mu_ < muMin)
+                mu_ = 1.1 * muMin;
+        }
+
+        // backtracking line search on the l1 merit function
+        const double merit = cost + mu_ * violation;
+        const double directionalDerivative = gradientStep - mu_ * violation;
+        double alpha = 1.0;
+        double costTrial = cost;
+        double violationTrial = violation;
+        bool accepted = false;
+
+        for (int k = 0; k < sqpSettings_.maxLineSearchSteps_; k++)
+        {
+            xTrial = x_ + alpha * step;
+            setIterate(xTrial);
+            costTrial = evaluateCost(violationTrial);
+
+            if (costTrial + mu_ * violationTrial <= merit + sqpSettings_.armijoParameter_ * alpha * directionalDerivative)
+            {
+                accepted = true;
+                break;
+            }
+            alpha *= sqpSettings_.contractionRate_;
+        }
+
+        if (!accepted)
+        {
+            setIterate(x_);
+            if (sqpSettings_.printLevel_ > 0)
+                std::cout << "SqpSolver: line search failed in iteration " << iterations_ << std::endl;
+            break;
+        }
+
+        x_ = xTrial;
+        cost = costTrial;
+        violation = violationTrial;
+        lambda_ += alpha * (lambdaQP_ - lambda_);
+
+        if (sqpSettings_.printLevel_ > 1)
+            std::cout << "SQP iteration " << iterations_ << ": cost " << cost << ", constraint violation " << violation
+                      << ", step " << alpha * step.template lpNorm<Eigen::Infinity>() << ", alpha " << alpha
+                      << std::endl;
+
+        if (alpha * step.template lpNorm<Eigen::Infinity>() < sqpSettings_.stepTolerance_ &&
+            violation < sqpSettings_.constraintTolerance_)
+        {
+            converged = true;
+            break;
+        }
+    }
+
+    violation_ = violation;
+
+    if (sqpSettings_.printLevel_ > 0)
+        std::cout << "SqpSolver " << (converged ? "converged" : "did not converge") << " after " << iterations_
+                  << " iterations, cost " << cost << ", constraint violation " << violation << std::endl;
+
+    return converged;
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::prepareWarmStart(size_t maxIterations)
+{
+    warmStart_ = true;
+    maxIterations_ = static_cast<int>(maxIterations);
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::shiftIterate(const size_t nNodes)
+{
+    const size_t N = w_->numPairs() - 1;
+    const VectorXs x = w_->getOptimizationVars();
+    VectorXs shifted = x;
+
+    for (size_t i = 0; i < N + 1; i++)
+    {
+        const size_t source = std::min(i + nNodes, N);
+        for (size_t j = 0; j < STAGE_DIM; j++)
+            shifted(nlpIndex(i, j)) = x(nlpIndex(source, j));
+    }
+
+    setIterate(shifted);
+
+    // the multipliers of the continuity constraints move along with the shots
+    if (static_cast<size_t>(lambda_.rows()) >= (N + 1) * STATE_DIM && N > 0)
+    {
+        const VectorXs lambda = lambda_;
+        for (size_t i = 0; i < N; i++)
+            lambda_.template segment<STATE_DIM>(STATE_DIM * (i + 1)) =
+                lambda.template segment<STATE_DIM>(STATE_DIM * (std::min(i + nNodes, N - 1) + 1));
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::setupStructure()
+{
+    N_ = w_->numPairs() - 1;
+    n_ = this->nlp_->getVarCount();
+    m_ = this->nlp_->getConstraintsCount();
+
+    if (n_ != (N_ + 1) * STAGE_DIM)
+        throw std::runtime_error("SqpSolver: the optimization vector does not match the stage structure.");
+    if (m_ < (N_ + 1) * STATE_DIM)
+        throw std::runtime_error("SqpSolver: the nlp does not contain initial state and continuity constraints.");
+
+    colStage_.assign(n_, -1);
+    colOffset_.assign(n_, -1);
+    for (size_t i = 0; i < N_ + 1; i++)
+        for (size_t j = 0; j < STAGE_DIM; j++)
+        {
+            colStage_[nlpIndex(i, j)] = i;
+            colOffset_[nlpIndex(i, j)] = j;
+        }
+
+    const size_t nnz = this->nlp_->getNonZeroJacobianCount();
+    iRow_.resize(nnz);
+    jCol_.resize(nnz);
+    MapVecXi iRowMap(iRow_.data(), nnz);
+    MapVecXi jColMap(jCol_.data(), nnz);
+    this->nlp_->getSparsityPatternJacobian(nnz, iRowMap, jColMap);
+
+    gLb_.resize(m_);
+    gUb_.resize(m_);
+    MapVecXs gLbMap(gLb_.data(), m_);
+    MapVecXs gUbMap(gUb_.data(), m_);
+    this->nlp_->getConstraintBounds(gLbMap, gUbMap, m_);
+
+    xLb_.resize(n_);
+    xUb_.resize(n_);
+    MapVecXs xLbMap(xLb_.data(), n_);
+    MapVecXs xUbMap(xUb_.data(), n_);
+    this->nlp_->getVariableBounds(xLbMap, xUbMap, n_);
+
+    // assign every constraint row to its stage
+    const size_t nEq = (N_ + 1) * STATE_DIM;
+    rowStage_.assign(m_, -1);
+    for (size_t k = 0; k < nnz; k++)
+    {
+        const size_t row = iRow_(k);
+        const int stage = colStage_[jCol_(k)];
+        const int offset = colOffset_[jCol_(k)];
+
+        if (row < STATE_DIM)
+        {
+            if (stage != 0 || offset != static_cast<int>(row))
+                throw std::runtime_error("SqpSolver: the initial state constraint must only depend on s_0.");
+        }
+        else if (row < nEq)
+        {
+            const int shot = row / STATE_DIM - 1;
+            if (!(stage == shot || (stage == shot + 1 && offset == static_cast<int>(row % STATE_DIM))))
+                throw std::runtime_error(
+                    "SqpSolver: the continuity constraint of shot i may only depend on s_i, q_i and s_i+1. Piecewise "
+                    "linear control splines are not supported.");
+        }
+        else
+        {
+            if (rowStage_[row] >= 0 && rowStage_[row] != stage)
+                throw std::runtime_error("SqpSolver: constraint " + std::to_string(row) + " couples several nodes.");
+            rowStage_[row] = stage;
+        }
+    }
+
+    stageRows_.assign(N_ + 1, std::vector<int>());
+    rowIndex_.assign(m_, -1);
+    for (size_t row = nEq; row < m_; row++)
+    {
+        if (rowStage_[row] < 0 || (!isFinite(gLb_(row)) && !isFinite(gUb_(row))))
+            continue;
+        rowIndex_[row] = stageRows_[rowStage_[row]].size();
+        stageRows_[rowStage_[row]].push_back(row);
+    }
+
+    stageBoundCols_.assign(N_ + 1, std::vector<int>());
+    for (size_t col = 0; col < n_; col++)
+        if (isFinite(xLb_(col)) || isFinite(xUb_(col)))
+            stageBoundCols_[colStage_[col]].push_back(col);
+
+    // the continuity multipliers follow from the stationarity w.r.t. the states, which is only known if no inequality
+    // constraint with an unknown multiplier depends on the states
+    bool stateInequalities = false;
+    for (size_t k = 0; k < nnz; k++)
+        if (rowIndex_[iRow_(k)] >= 0 && colOffset_[jCol_(k)] < static_cast<int>(STATE_DIM))
+            stateInequalities = true;
+    for (size_t col = 0; col < n_; col++)
+        if ((isFinite(xLb_(col)) || isFinite(xUb_(col))) && colOffset_[col] < static_cast<int>(STATE_DIM))
+            stateInequalities = true;
+    useMultipliers_ = sqpSettings_.lagrangianHessian_ && !stateInequalities;
+
+    // the stage N carries the last control, followed by a terminal stage with identity dynamics
+    lqocProblem_->changeNumStages(N_ + 1);
+    lqocProblem_->setZero();
+
+    bool constrained = false;
+    for (size_t i = 0; i < N_ + 1; i++)
+    {
+        const int ng = stageRows_[i].size() + stageBoundCols_[i].size();
+        lqocProblem_->ng_[i] = ng;
+        lqocProblem_->C_[i].setZero(ng, STATE_DIM);
+        lqocProblem_->D_[i].setZero(ng, CONTROL_DIM);
+        lqocProblem_->d_lb_[i].setZero(ng, 1);
+        lqocProblem_->d_ub_[i].setZero(ng, 1);
+        constrained = constrained || (ng > 0);
+    }
+
+    if (constrained && sqpSettings_.lqocSolver_ != NLOptConSettings::HPIPM_SOLVER)
+        throw std::runtime_error(
+            "SqpSolver: the nlp contains inequality constraints or variable bounds, which require the HPIPM solver.");
+
+    if (sqpSettings_.hessianApproximation_ == SqpSettings::EXACT)
+    {
+        const size_t nnzHessian = this->nlp_->getNonZeroHessianCount();
+        iRowHessian_.resize(nnzHessian);
+        jColHessian_.resize(nnzHessian);
+        hessianValues_.resize(nnzHessian);
+        MapVecXi iRowHessianMap(iRowHessian_.data(), nnzHessian);
+        MapVecXi jColHessianMap(jColHessian_.data(), nnzHessian);
+        this->nlp_->getSparsityPatternHessian(nnzHessian, iRowHessianMap, jColHessianMap);
+
+        for (size_t k = 0; k < nnzHessian; k++)
+            if (colStage_[iRowHessian_(k)] != colStage_[jColHessian_(k)])
+                throw std::runtime_error("SqpSolver: the exact Hessian couples several nodes.");
+    }
+
+    g_.resize(m_);
+    lambdaQP_.setZero(m_);
+    gradient_.resize(n_);
+    jacobian_.resize(nnz);
+    hessians_.resize(N_ + 1);
+    continuityJacobians_.resize(N_);
+    diagonals_.resize(N_);
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::setIterate(const VectorXs& x)
+{
+    MapConstVecXs xMap(x.data(), x.rows());
+    this->nlp_->extractOptimizationVars(xMap, true);
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+double SqpSolver<STATE_DIM, CONTROL_DIM>::evaluateCost(double& violation)
+{
+    const double cost = this->nlp_->evaluateCostFun();
+
+    MapVecXs gMap(g_.data(), m_);
+    this->nlp_->evaluateConstraints(gMap);
+
+    violation = (gLb_ - g_).cwiseMax(0.0).sum() + (g_ - gUb_).cwiseMax(0.0).sum();
+    for (size_t i = 0; i < N_ + 1; i++)
+        for (const int col : stageBoundCols_[i])
+        {
+            const double x = w_->getOptimizationVars()(col);
+            violation += std::max(xLb_(col) - x, 0.0) + std::max(x - xUb_(col), 0.0);
+        }
+
+    return cost;
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::evaluateLagrangianGradient(VectorXs& gradient, bool withMultipliers)
+{
+    MapVecXs gradientMap(gradient.data(), n_);
+    this->nlp_->evaluateCostGradient(n_, gradientMap);
+
+    if (!withMultipliers || lambda_.isZero(0.0))
+        return;
+
+    MapVecXs jacobianMap(jacobian_.data(), jacobian_.rows());
+    this->nlp_->evaluateConstraintJacobian(jacobian_.rows(), jacobianMap);
+
+    const size_t nEq = (N_ + 1) * STATE_DIM;
+    for (int k = 0; k < jacobian_.rows(); k++)
+        if (iRow_(k) >= static_cast<int>(STATE_DIM) && iRow_(k) < static_cast<int>(nEq))
+            gradient(jCol_(k)) += jacobian_(k) * lambda_(iRow_(k));
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::computeStageHessians(const VectorXs& x, bool withMultipliers)
+{
+    setIterate(x);
+    evaluateLagrangianGradient(gradient_, withMultipliers);
+    const VectorXs gradientNominal = gradient_;
+
+    // neither the cost nor the continuity constraints couple the nodes nonlinearly, the next state s_i+1 enters the
+    // continuity constraint of shot i linearly. Perturb the same component of all nodes at once.
+    VectorXs xPerturbed(n_);
+    VectorXs h(N_ + 1);
+    for (size_t j = 0; j < STAGE_DIM; j++)
+    {
+        xPerturbed = x;
+        for (size_t i = 0; i < N_ + 1; i++)
+        {
+            const size_t col = nlpIndex(i, j);
+            h(i) = sqpSettings_.hessianPerturbation_ * std::max(1.0, std::abs(x(col)));
+            xPerturbed(col) += h(i);
+        }
+
+        setIterate(xPerturbed);
+        evaluateLagrangianGradient(gradient_, withMultipliers);
+
+        for (size_t i = 0; i < N_ + 1; i++)
+            for (size_t l = 0; l < STAGE_DIM; l++)
+                hessians_[i](l, j) = (gradient_(nlpIndex(i, l)) - gradientNominal(nlpIndex(i, l))) / h(i);
+    }
+
+    setIterate(x);
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::computeExactHessians()
+{
+    const VectorXs lambda = useMultipliers_ ? lambda_ : VectorXs::Zero(m_);
+    MapConstVecXs lambdaMap(lambda.data(), m_);
+    MapVecXs hessianMap(hessianValues_.data(), hessianValues_.rows());
+    this->nlp_->evaluateHessian(hessianValues_.rows(), hessianMap, 1.0, lambdaMap);
+
+    for (size_t i = 0; i < N_ + 1; i++)
+        hessians_[i].setZero();
+
+    // the nlp returns the lower triangle
+    for (int k = 0; k < hessianValues_.rows(); k++)
+    {
+        const int stage = colStage_[iRowHessian_(k)];
+        const int row = colOffset_[iRowHessian_(k)];
+        const int col = colOffset_[jColHessian_(k)];
+        hessians_[stage](row, col) += hessianValues_(k);
+        if (iRowHessian_(k) != jColHessian_(k))
+            hessians_[stage](col, row) += hessianValues_(k);
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::updateBfgsHessians(const VectorXs& x)
+{
+    // the change of the gradient of the Lagrangian with the current multipliers
+    VectorXs y = gradient_ - gradientPrevious_;
+    if (useMultipliers_)
+    {
+        const size_t nEq = (N_ + 1) * STATE_DIM;
+        for (int k = 0; k < jacobian_.rows(); k++)
+            if (iRow_(k) >= static_cast<int>(STATE_DIM) && iRow_(k) < static_cast<int>(nEq))
+                y(jCol_(k)) += (jacobian_(k) - jacobianPrevious_(k)) * lambda_(iRow_(k));
+    }
+
+    Eigen::Matrix<double, STAGE_DIM, 1> sStage;
+    Eigen::Matrix<double, STAGE_DIM, 1> yStage;
+    for (size_t i = 0; i < N_ + 1; i++)
+    {
+        for (size_t j = 0; j < STAGE_DIM; j++)
+        {
+            sStage(j) = x(nlpIndex(i, j)) - xPrevious_(nlpIndex(i, j));
+            yStage(j) = y(nlpIndex(i, j));
+        }
+
+        const Eigen::Matrix<double, STAGE_DIM, 1> Bs = hessians_[i] * sStage;
+        const double sBs = sStage.dot(Bs);
+        if (sBs < 1e-14)
+            continue;
+
+        // Powell's damping keeps the update positive definite if the curvature along the step is negative
+        const double sy = sStage.dot(yStage);
+        Eigen::Matrix<double, STAGE_DIM, 1> r = yStage;
+        if (sy < 0.2 * sBs)
+        {
+            const double theta = 0.8 * sBs / (sBs - sy);
+            r = theta * yStage + (1.0 - theta) * Bs;
+        }
+
+        hessians_[i] += r * r.transpose() / sStage.dot(r) - Bs * Bs.transpose() / sBs;
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::projectHessians()
+{
+    for (size_t i = 0; i < N_ + 1; i++)
+    {
+        const stage_matrix_t H = 0.5 * (hessians_[i] + hessians_[i].transpose());
+        Eigen::SelfAdjointEigenSolver<stage_matrix_t> eigenSolver(H);
+        const Eigen::Matrix<double, STAGE_DIM, 1> lambda =
+            eigenSolver.eigenvalues().cwiseMax(sqpSettings_.hessianRegularization_);
+        hessians_[i] = eigenSolver.eigenvectors() * lambda.asDiagonal() * eigenSolver.eigenvectors().transpose();
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::linearize(const VectorXs& x)
+{
+    // finite differences leave the nlp at x, otherwise it is expected to be set already
+    if (sqpSettings_.hessianApproximation_ == SqpSettings::FINITE_DIFFERENCES)
+        computeStageHessians(x, useMultipliers_);
+    else if (sqpSettings_.hessianApproximation_ == SqpSettings::BFGS && !bfgsInitialized_)
+        computeStageHessians(x, false);
+
+    MapVecXs gMap(g_.data(), m_);
+    this->nlp_->evaluateConstraints(gMap);
+    MapVecXs gradientMap(gradient_.data(), n_);
+    this->nlp_->evaluateCostGradient(n_, gradientMap);
+    MapVecXs jacobianMap(jacobian_.data(), jacobian_.rows());
+    this->nlp_->evaluateConstraintJacobian(jacobian_.rows(), jacobianMap);
+
+    if (sqpSettings_.hessianApproximation_ == SqpSettings::EXACT)
+        computeExactHessians();
+    else if (sqpSettings_.hessianApproximation_ == SqpSettings::BFGS)
+    {
+        if (bfgsInitialized_)
+            updateBfgsHessians(x);
+        bfgsInitialized_ = true;
+        xPrevious_ = x;
+        gradientPrevious_ = gradient_;
+        jacobianPrevious_ = jacobian_;
+    }
+
+    projectHessians();
+
+    LQOCProblem_t& p = *lqocProblem_;
+
+    for (size_t i = 0; i < N_; i++)
+    {
+        continuityJacobians_[i].setZero();
+        diagonals_[i].setZero();
+    }
+    for (size_t i = 0; i < N_ + 1; i++)
+    {
+        p.C_[i].setZero();
+        p.D_[i].setZero();
+    }
+
+    // scatter the Jacobian into the stage blocks
+    const size_t nEq = (N_ + 1) * STATE_DIM;
+    for (int k = 0; k < jacobian_.rows(); k++)
+    {
+        const size_t row = iRow_(k);
+        const int stage = colStage_[jCol_(k)];
+        const int offset = colOffset_[jCol_(k)];
+
+        if (row < STATE_DIM)
+            continue;
+        else if (row < nEq)
+        {
+            const int shot = row / STATE_DIM - 1;
+            if (stage == shot)
+                continuityJacobians_[shot](row % STATE_DIM, offset) += jacobian_(k);
+            else
+                diagonals_[shot](row % STATE_DIM) += jacobian_(k);
+        }
+        else if (rowIndex_[row] >= 0)
+        {
+            if (offset < static_cast<int>(STATE_DIM))
+                p.C_[stage](rowIndex_[row], offset) += jacobian_(k);
+            else
+                p.D_[stage](rowIndex_[row], offset - STATE_DIM) += jacobian_(k);
+        }
+    }
+
+    // continuity constraints c_i + J_i * [ds_i; dq_i] + diag(d_i) * ds_i+1 = 0
+    for (size_t i = 0; i < N_; i++)
+    {
+        if (diagonals_[i].cwiseAbs().minCoeff() < 1e-12)
+            throw std::runtime_error("SqpSolver: continuity constraint of shot " + std::to_string(i) +
+                                     " does not determine the next state.");
+
+        const core::StateVector<STATE_DIM> dInv = diagonals_[i].cwiseInverse();
+        p.A_[i] = -(dInv.asDiagonal() * continuityJacobians_[i].template leftCols<STATE_DIM>());
+        p.B_[i] = -(dInv.asDiagonal() * continuityJacobians_[i].template rightCols<CONTROL_DIM>());
+        p.b_[i] = -dInv.cwiseProduct(g_.template segment<STATE_DIM>(STATE_DIM * (i + 1)));
+    }
+    p.A_[N_].setIdentity();
+    p.B_[N_].setZero();
+    p.b_[N_].setZero();
+
+    // cost
+    for (size_t i = 0; i < N_ + 1; i++)
+    {
+        p.Q_[i] = hessians_[i].template topLeftCorner<STATE_DIM, STATE_DIM>();
+        p.R_[i] = hessians_[i].template bottomRightCorner<CONTROL_DIM, CONTROL_DIM>();
+        p.P_[i] = hessians_[i].template bottomLeftCorner<CONTROL_DIM, STATE_DIM>();
+        p.qv_[i] = gradient_.template segment<STATE_DIM>(w_->getStateIndex(i));
+        p.rv_[i] = gradient_.template segment<CONTROL_DIM>(w_->getControlIndex(i));
+        p.q_[i] = 0.0;
+    }
+    p.Q_[N_ + 1].setZero();
+    p.qv_[N_ + 1].setZero();
+    p.q_[N_ + 1] = 0.0;
+
+    // inequality constraints and variable bounds
+    for (size_t i = 0; i < N_ + 1; i++)
+    {
+        const size_t nRows = stageRows_[i].size();
+        for (size_t r = 0; r < nRows; r++)
+        {
+            const int row = stageRows_[i][r];
+            p.d_lb_[i](r) = gLb_(row) - g_(row);
+            p.d_ub_[i](r) = gUb_(row) - g_(row);
+        }
+        for (size_t c = 0; c < stageBoundCols_[i].size(); c++)
+        {
+            const int col = stageBoundCols_[i][c];
+            const int offset = colOffset_[col];
+            if (offset < static_cast<int>(STATE_DIM))
+                p.C_[i](nRows + c, offset) = 1.0;
+            else
+                p.D_[i](nRows + c, offset - STATE_DIM) = 1.0;
+            p.d_lb_[i](nRows + c) = xLb_(col) - x(col);
+            p.d_ub_[i](nRows + c) = xUb_(col) - x(col);
+        }
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::computeMultipliers(const VectorXs& step)
+{
+    if (!useMultipliers_)
+        return;
+
+    // stationarity of the QP Lagrangian w.r.t. ds_i+1, which appears in the cost of stage i+1, in the continuity
+    // constraint of shot i+1 and with the diagonal d_i in the continuity constraint of shot i
+    Eigen::Matrix<double, STAGE_DIM, 1> z;
+    for (int i = static_cast<int>(N_) - 1; i >= 0; i--)
+    {
+        for (size_t j = 0; j < STAGE_DIM; j++)
+            z(j) = step(nlpIndex(i + 1, j));
+
+        core::StateVector<STATE_DIM> r = (hessians_[i + 1] * z).template head<STATE_DIM>() +
+                                         gradient_.template segment<STATE_DIM>(w_->getStateIndex(i + 1));
+        if (i + 1 < static_cast<int>(N_))
+            r += continuityJacobians_[i + 1].template leftCols<STATE_DIM>().transpose() *
+                 lambdaQP_.template segment<STATE_DIM>(STATE_DIM * (i + 2));
+
+        lambdaQP_.template segment<STATE_DIM>(STATE_DIM * (i + 1)) = -r.cwiseQuotient(diagonals_[i]);
+    }
+}
+
+template <size_t STATE_DIM, size_t CONTROL_DIM>
+void SqpSolver<STATE_DIM, CONTROL_DIM>::solveQP(VectorXs& step)
+{
+    lqocSolver_->setProblem(lqocProblem_);
+    lqocSolver_->solve();
+    lqocSolver_->computeStatesAndControls();
+
+    const core::StateVectorArray<STATE_DIM>& dx = lqocSolver_->getSolutionState();
+    const core::ControlVectorArray<CONTROL_DIM>& du = lqocSolver_->getSolutionControl();
+
+    for (size_t i = 0; i < N_ + 1; i++)
+    {
+        step.template segment<STATE_DIM>(w_->getStateIndex(i)) = dx[i];
+        step.template segment<CONTROL_DIM>(w_->getControlIndex(i)) = du[i];
+    }
+}
+
+}  // namespace optcon
+}  // namespace ct
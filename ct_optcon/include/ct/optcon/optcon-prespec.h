@@ -34,6 +34,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include "solver/OptConSolver.h"
 #include "solver/lqp/HPIPMInterface.hpp"
 #include "solver/lqp/GNRiccatiSolver.hpp"
+#include "solver/lqp/MixedPrecisionLQOCSolver.hpp"
 #include "solver/NLOptConSolver.hpp"
 #include "solver/NLOptConSettings.hpp"
 
@@ -41,11 +42,13 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include "lqr/riccati/DARE.hpp"
 #include "lqr/FHDTLQR.hpp"
 #include "lqr/LQR.hpp"
+#include "lqr/GainScheduledLQR.hpp"
 
 #include "dms/dms.h"
 
 #include "mpc/MpcSettings.h"
 #include "mpc/MPC.h"
+#include "mpc/MpcRunner.h"
 #include "mpc/timehorizon/MpcTimeHorizon.h"
 #include "mpc/policyhandler/PolicyHandler.h"
 #include "mpc/policyhandler/default/StateFeedbackPolicyHandler.h"
@@ -31,17 +31,20 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include "solver/OptConSolver.h"
 #include "solver/lqp/HPIPMInterface.hpp"
 #include "solver/lqp/GNRiccatiSolver.hpp"
+#include "solver/lqp/MixedPrecisionLQOCSolver.hpp"
 #include "solver/NLOptConSolver.hpp"
 
 #include "lqr/riccati/CARE.hpp"
 #include "lqr/riccati/DARE.hpp"
 #include "lqr/FHDTLQR.hpp"
 #include "lqr/LQR.hpp"
+#include "lqr/GainScheduledLQR.hpp"
 
 #include "dms/dms.h"
 
 #include "mpc/MpcSettings.h"
 #include "mpc/MPC.h"
+#include "mpc/MpcRunner.h"
 #include "mpc/timehorizon/MpcTimeHorizon.h"
 #include "mpc/policyhandler/PolicyHandler.h"
 #include "mpc/policyhandler/default/StateFeedbackPolicyHandler.h"
@@ -60,6 +63,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include "problem/LQOCProblem-impl.hpp"
 
 #include "solver/lqp/GNRiccatiSolver-impl.hpp"
+#include "solver/lqp/MixedPrecisionLQOCSolver-impl.hpp"
 #include "solver/lqp/HPIPMInterface-impl.hpp"
 #include "solver/NLOptConSolver-impl.hpp"
 
@@ -67,6 +71,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include "lqr/riccati/DARE-impl.hpp"
 #include "lqr/FHDTLQR-impl.hpp"
 #include "lqr/LQR-impl.hpp"
+#include "lqr/GainScheduledLQR-impl.hpp"
 
 #include "nloc/NLOCBackendBase-impl.hpp"
 #include "nloc/NLOCBackendST-impl.hpp"
@@ -75,12 +80,18 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include "nloc/algorithms/SingleShooting-impl.hpp"
 
 #include "mpc/MPC-impl.h"
+#include "mpc/MpcRunner-impl.h"
 #include "mpc/timehorizon/MpcTimeHorizon-impl.h"
 #include "mpc/policyhandler/PolicyHandler-impl.h"
 #include "mpc/policyhandler/default/StateFeedbackPolicyHandler-impl.h"
 
 #include "filter/filter-impl.h"
 
+// explicit instantiation declarations of the prespec libraries, generated by cmake
+#ifdef CT_OPTCON_EXTERN_TEMPLATES
+#include <ct/optcon/optcon-extern-templates.h>
+#endif
+
 // keep standard header guard (easy debugging)
 // header guard is identical to the one in optcon-prespec.h
 #endif /* INCLUDE_CT_OPTCON_OPTCON_H_ */
@@ -154,16 +154,82 @@ struct LineSearchSettings
 struct LQOCSolverSettings
 {
 public:
-    LQOCSolverSettings() : lqoc_debug_print(false), num_lqoc_iterations(10) {}
+    //! warm start strategies of interior-point LQOC solvers, see HPIPM's ipm_arg
+    enum WARM_START
+    {
+        COLD = 0,     //! always start from scratch
+        PRIMAL,       //! start from the previous primal solution
+        PRIMAL_DUAL,  //! start from the previous primal solution, multipliers and slacks
+        NUM_WARM_START_TYPES
+    };
+
+    //! interior-point modes, in the order of HPIPM's hpipm_mode
+    enum IPM_MODE
+    {
+        SPEED_ABS = 0,
+        SPEED,
+        BALANCED,
+        ROBUST,
+        NUM_IPM_MODES
+    };
+
+    LQOCSolverSettings()
+        : lqoc_debug_print(false),
+          num_lqoc_iterations(10),
+          ipm_mode(SPEED),
+          warm_start(COLD),
+          num_lqoc_iterations_warm_start(5),
+          mu0_warm_start(1e-2),
+          tol_stat(-1.0),
+          tol_eq(-1.0),
+          tol_ineq(-1.0),
+          tol_comp(-1.0)
+    {
+    }
 
     bool lqoc_debug_print;
     int num_lqoc_iterations;  //! number of allowed sub-iterations of LQOC solver per NLOC main iteration
 
+    IPM_MODE ipm_mode;                   //! interior-point mode, sets the defaults of all other ipm parameters
+    WARM_START warm_start;               //! warm start strategy across NLOC iterations and MPC cycles
+    int num_lqoc_iterations_warm_start;  //! number of allowed sub-iterations if the LQOC solver is warm started
+    double mu0_warm_start;               //! initial barrier parameter if warm started
+
+    //! convergence tolerances on stationarity, equalities, inequalities and complementarity, negative for default
+    double tol_stat;
+    double tol_eq;
+    double tol_ineq;
+    double tol_comp;
+
+    std::map<WARM_START, std::string> warmStartToString = {
+        {COLD, "COLD"}, {PRIMAL, "PRIMAL"}, {PRIMAL_DUAL, "PRIMAL_DUAL"}};
+    std::map<std::string, WARM_START> stringToWarmStart = {
+        {"COLD", COLD}, {"PRIMAL", PRIMAL}, {"PRIMAL_DUAL", PRIMAL_DUAL}};
+
+    std::map<IPM_MODE, std::string> ipmModeToString = {
+        {SPEED_ABS, "SPEED_ABS"}, {SPEED, "SPEED"}, {BALANCED, "BALANCED"}, {ROBUST, "ROBUST"}};
+    std::map<std::string, IPM_MODE> stringToIpmMode = {
+        {"SPEED_ABS", SPEED_ABS}, {"SPEED", SPEED}, {"BALANCED", BALANCED}, {"ROBUST", ROBUST}};
+
     void print() const
     {
         std::cout << "======================= LQOCSolverSettings =====================" << std::endl;
         std::cout << "num_lqoc_iterations: \t" << num_lqoc_iterations << std::endl;
         std::cout << "lqoc_debug_print: \t" << lqoc_debug_print << std::endl;
+        std::cout << "ipm_mode: \t" << ipmModeToString.at(ipm_mode) << std::endl;
+        std::cout << "warm_start: \t" << warmStartToString.at(warm_start) << std::endl;
+        std::cout << "num_lqoc_iterations_warm_start: \t" << num_lqoc_iterations_warm_start << std::endl;
+        std::cout << "mu0_warm_start: \t" << mu0_warm_start << std::endl;
+        std::cout << "tol_stat: \t" << tol_stat << std::endl;
+        std::cout << "tol_eq: \t" << tol_eq << std::endl;
+        std::cout << "tol_ineq: \t" << tol_ineq << std::endl;
+        std::cout << "tol_comp: \t" << tol_comp << std::endl;
+    }
+
+    //! check if the currently set parameters are meaningful
+    bool parametersOk() const
+    {
+        return (num_lqoc_iterations > 0) && (num_lqoc_iterations_warm_start > 0) && (mu0_warm_start > 0.0);
     }
 
     void load(const std::string& filename, bool verbose = true, const std::string& ns = "lqoc_solver_settings")
@@ -186,6 +252,54 @@ public:
         } catch (...)
         {
         }
+        try
+        {
+            ipm_mode = stringToIpmMode.at(pt.get<std::string>(ns + ".ipm_mode"));
+        } catch (...)
+        {
+        }
+        try
+        {
+            warm_start = stringToWarmStart.at(pt.get<std::string>(ns + ".warm_start"));
+        } catch (...)
+        {
+        }
+        try
+        {
+            num_lqoc_iterations_warm_start = pt.get<int>(ns + ".num_lqoc_iterations_warm_start");
+        } catch (...)
+        {
+        }
+        try
+        {
+            mu0_warm_start = pt.get<double>(ns + ".mu0_warm_start");
+        } catch (...)
+        {
+        }
+        try
+        {
+            tol_stat = pt.get<double>(ns + ".tol_stat");
+        } catch (...)
+        {
+        }
+        try
+        {
+            tol_eq = pt.get<double>(ns + ".tol_eq");
+        } catch (...)
+        {
+        }
+        try
+        {
+            tol_ineq = pt.get<double>(ns + ".tol_ineq");
+        } catch (...)
+        {
+        }
+        try
+        {
+            tol_comp = pt.get<double>(ns + ".tol_comp");
+        } catch (...)
+        {
+        }
     }
 };
 
@@ -248,6 +362,7 @@ public:
           debugPrint(false),
           printSummary(true),
           useSensitivityIntegrator(false),
+          doublePrecisionLQSolver(false),
           logToMatlab(false)
     {
     }
@@ -277,7 +392,8 @@ public:
     bool debugPrint;
     bool printSummary;
     bool useSensitivityIntegrator;
-    bool logToMatlab;  //! log to matlab (true/false)
+    bool doublePrecisionLQSolver;  //! solve the LQ subproblems in double precision if the solver runs in float
+    bool logToMatlab;              //! log to matlab (true/false)
 
 
     //! compute the number of discrete time steps for an arbitrary input time interval
@@ -332,6 +448,7 @@ public:
         std::cout << "debugPrint:\t" << debugPrint << std::endl;
         std::cout << "printSummary:\t" << printSummary << std::endl;
         std::cout << "useSensitivityIntegrator:\t" << useSensitivityIntegrator << std::endl;
+        std::cout << "doublePrecisionLQSolver:\t" << doublePrecisionLQSolver << std::endl;
         std::cout << "logToMatlab:\t" << logToMatlab << std::endl;
         std::cout << std::endl;
 
@@ -382,7 +499,7 @@ public:
             std::cout << "Number of threads should not exceed 100." << std::endl;
             return false;
         }
-        return (lineSearchSettings.parametersOk());
+        return (lineSearchSettings.parametersOk() && lqoc_solver_settings.parametersOk());
     }
 
 
@@ -474,6 +591,12 @@ public:
         {
         }
         try
+        {
+            doublePrecisionLQSolver = pt.get<bool>(ns + ".doublePrecisionLQSolver");
+        } catch (...)
+        {
+        }
+        try
         {
             logToMatlab = pt.get<bool>(ns + ".logToMatlab");
         } catch (...)
@@ -640,24 +763,40 @@ private:
         {ct::core::IntegrationType::EULERCT, "Euler (CT)"},
         {ct::core::IntegrationType::RK4CT, "Runge-Kutta 4th Order (CT"},
         {ct::core::IntegrationType::EULER_SYM, "Symplectic Euler"},
-        {ct::core::IntegrationType::RK_SYM, "Symplectic Runge Kutta"}};
+        {ct::core::IntegrationType::RK_SYM, "Symplectic Runge Kutta"},
+        {ct::core::IntegrationType::VERLET_SYM, "Symplectic Stoermer-Verlet"},
+        {ct::core::IntegrationType::FOREST_RUTH_SYM, "Symplectic Forest-Ruth (PEFRL)"},
+        {ct::core::IntegrationType::YOSHIDA4_SYM, "Symplectic Yoshida 4th Order"},
+        {ct::core::IntegrationType::YOSHIDA6_SYM, "Symplectic Yoshida 6th Order"}};
 
     std::map<std::string, ct::core::IntegrationType> stringToIntegrator = {{"Euler", ct::core::IntegrationType::EULER},
         {"RK4", ct::core::IntegrationType::RK4}, {"MODIFIED_MIDPOINT", ct::core::IntegrationType::MODIFIED_MIDPOINT},
         {"ODE45", ct::core::IntegrationType::ODE45}, {"RK5VARIABLE", ct::core::IntegrationType::RK5VARIABLE},
         {"RK78", ct::core::IntegrationType::RK78}, {"BULIRSCHSTOER", ct::core::IntegrationType::BULIRSCHSTOER},
         {"EulerCT", ct::core::IntegrationType::EULERCT}, {"RK4CT", ct::core::IntegrationType::RK4CT},
-        {"Euler_Sym", ct::core::IntegrationType::EULER_SYM}, {"Rk_Sym", ct::core::IntegrationType::RK_SYM}};
+        {"Euler_Sym", ct::core::IntegrationType::EULER_SYM}, {"Rk_Sym", ct::core::IntegrationType::RK_SYM},
+        {"Verlet_Sym", ct::core::IntegrationType::VERLET_SYM},
+        {"Forest_Ruth_Sym", ct::core::IntegrationType::FOREST_RUTH_SYM},
+        {"Yoshida4_Sym", ct::core::IntegrationType::YOSHIDA4_SYM},
+        {"Yoshida6_Sym", ct::core::IntegrationType::YOSHIDA6_SYM}};
 
 
     //! mappings for discretization types
     std::map<APPROXIMATION, std::string> discretizationToString = {{APPROXIMATION::FORWARD_EULER, "Forward_euler"},
         {APPROXIMATION::BACKWARD_EULER, "Backward_euler"}, {APPROXIMATION::SYMPLECTIC_EULER, "Symplectic_euler"},
-        {APPROXIMATION::TUSTIN, "Tustin"}, {APPROXIMATION::MATRIX_EXPONENTIAL, "Matrix_exponential"}};
+        {APPROXIMATION::TUSTIN, "Tustin"}, {APPROXIMATION::MATRIX_EXPONENTIAL, "Matrix_exponential"},
+        {APPROXIMATION::SYMPLECTIC_VERLET, "Symplectic_verlet"},
+        {APPROXIMATION::SYMPLECTIC_FOREST_RUTH, "Symplectic_forest_ruth"},
+        {APPROXIMATION::SYMPLECTIC_YOSHIDA4, "Symplectic_yoshida4"},
+        {APPROXIMATION::SYMPLECTIC_YOSHIDA6, "Symplectic_yoshida6"}};
 
     std::map<std::string, APPROXIMATION> stringToDiscretization = {{"Forward_euler", APPROXIMATION::FORWARD_EULER},
         {"Backward_euler", APPROXIMATION::BACKWARD_EULER}, {"Symplectic_euler", APPROXIMATION::SYMPLECTIC_EULER},
-        {"Tustin", APPROXIMATION::TUSTIN}, {"Matrix_exponential", APPROXIMATION::MATRIX_EXPONENTIAL}};
+        {"Tustin", APPROXIMATION::TUSTIN}, {"Matrix_exponential", APPROXIMATION::MATRIX_EXPONENTIAL},
+        {"Symplectic_verlet", APPROXIMATION::SYMPLECTIC_VERLET},
+        {"Symplectic_forest_ruth", APPROXIMATION::SYMPLECTIC_FOREST_RUTH},
+        {"Symplectic_yoshida4", APPROXIMATION::SYMPLECTIC_YOSHIDA4},
+        {"Symplectic_yoshida6", APPROXIMATION::SYMPLECTIC_YOSHIDA6}};
 
 
     //! mappings for algorithm types
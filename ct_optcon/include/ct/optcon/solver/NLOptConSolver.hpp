@@ -109,6 +109,12 @@ public:
 	 */
     virtual bool finishMPCIteration();
 
+    /*!
+	 * shift the warm start of the LQ sub-problem solver by the time elapsed between two MPC iterations
+	 * @param t_shift the shift time
+	 */
+    void shiftWarmStart(const SCALAR& t_shift);
+
     /**
 	 * run a single iteration of the solver
 	 * @return true if a better solution was found
@@ -242,6 +248,9 @@ public:
     //! logging a short summary to matlab
     void logSummaryToMatlab(const std::string& fileName);
 
+    //! log the trajectories and the summary of every iteration to a binary log, nullptr disables logging
+    void setBinaryLog(std::shared_ptr<ct::core::BinaryLogWriter> binaryLog);
+
 protected:
     //! the backend holding all the math operations
     std::shared_ptr<Backend_t> nlocBackend_;
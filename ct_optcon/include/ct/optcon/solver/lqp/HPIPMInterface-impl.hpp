@@ -11,7 +11,8 @@ namespace ct {
 namespace optcon {
 
 template <int STATE_DIM, int CONTROL_DIM>
-HPIPMInterface<STATE_DIM, CONTROL_DIM>::HPIPMInterface() : N_(-1), settings_(NLOptConSettings())
+HPIPMInterface<STATE_DIM, CONTROL_DIM>::HPIPMInterface()
+    : N_(-1), settings_(NLOptConSettings()), ipmArgCreated_(false), warmStartAvailable_(false), defaultMu0_(0.0)
 {
     hb0_.setZero();
     hr0_.setZero();
@@ -63,15 +64,17 @@ void HPIPMInterface<STATE_DIM, CONTROL_DIM>::initializeAndAllocate()
     int ipm_arg_size = ::d_ocp_qp_ipm_arg_memsize(&dim_);
     ipm_arg_mem_ = malloc(ipm_arg_size);
     ::d_ocp_qp_ipm_arg_create(&dim_, &arg_, ipm_arg_mem_);
-
-    ::d_ocp_qp_ipm_arg_set_default(mode_, &arg_);
-    ::d_ocp_qp_ipm_arg_set_iter_max(&settings_.lqoc_solver_settings.num_lqoc_iterations, &arg_);
+    ipmArgCreated_ = true;
+    setIpmArguments();
 
     // create workspace
     int ipm_size = ::d_ocp_qp_ipm_ws_memsize(&dim_, &arg_);
     ipm_mem_ = malloc(ipm_size);
     ::d_ocp_qp_ipm_ws_create(&dim_, &arg_, &workspace_, ipm_mem_);
 
+    // the new solution struct does not hold a meaningful iterate yet
+    warmStartAvailable_ = false;
+
 
     if (settings_.lqoc_solver_settings.lqoc_debug_print)
     {
@@ -87,7 +90,52 @@ template <int STATE_DIM, int CONTROL_DIM>
 void HPIPMInterface<STATE_DIM, CONTROL_DIM>::configure(const NLOptConSettings& settings)
 {
     settings_ = settings;
-    ::d_ocp_qp_ipm_arg_set_iter_max(&settings_.lqoc_solver_settings.num_lqoc_iterations, &arg_);
+
+    if (ipmArgCreated_)
+        setIpmArguments();
+
+    if (settings_.lqoc_solver_settings.warm_start == LQOCSolverSettings::COLD)
+        warmStartAvailable_ = false;
+}
+
+
+template <int STATE_DIM, int CONTROL_DIM>
+void HPIPMInterface<STATE_DIM, CONTROL_DIM>::setIpmArguments()
+{
+    LQOCSolverSettings& lqocSettings = settings_.lqoc_solver_settings;
+
+    // the mode sets the defaults for all ipm parameters, apply it first
+    ::d_ocp_qp_ipm_arg_set_default(static_cast<::hpipm_mode>(lqocSettings.ipm_mode), &arg_);
+    defaultMu0_ = arg_.mu0;
+
+    ::d_ocp_qp_ipm_arg_set_iter_max(&lqocSettings.num_lqoc_iterations, &arg_);
+
+    if (lqocSettings.tol_stat > 0.0)
+        ::d_ocp_qp_ipm_arg_set_tol_stat(&lqocSettings.tol_stat, &arg_);
+    if (lqocSettings.tol_eq > 0.0)
+        ::d_ocp_qp_ipm_arg_set_tol_eq(&lqocSettings.tol_eq, &arg_);
+    if (lqocSettings.tol_ineq > 0.0)
+        ::d_ocp_qp_ipm_arg_set_tol_ineq(&lqocSettings.tol_ineq, &arg_);
+    if (lqocSettings.tol_comp > 0.0)
+        ::d_ocp_qp_ipm_arg_set_tol_comp(&lqocSettings.tol_comp, &arg_);
+}
+
+
+template <int STATE_DIM, int CONTROL_DIM>
+void HPIPMInterface<STATE_DIM, CONTROL_DIM>::solveIpm(int warmStart)
+{
+    LQOCSolverSettings& lqocSettings = settings_.lqoc_solver_settings;
+
+    // a warm started solve is expected to converge in few iterations and starts closer to the central path
+    int iterMax = warmStart ? lqocSettings.num_lqoc_iterations_warm_start : lqocSettings.num_lqoc_iterations;
+    double mu0 = warmStart ? lqocSettings.mu0_warm_start : defaultMu0_;
+
+    ::d_ocp_qp_ipm_arg_set_warm_start(&warmStart, &arg_);
+    ::d_ocp_qp_ipm_arg_set_iter_max(&iterMax, &arg_);
+    ::d_ocp_qp_ipm_arg_set_mu0(&mu0, &arg_);
+
+    ::d_ocp_qp_ipm_solve(&qp_, &qp_sol_, &arg_, &workspace_);
+    ::d_ocp_qp_ipm_get_status(&workspace_, &hpipm_status_);
 }
 
 
@@ -154,9 +202,20 @@ void HPIPMInterface<STATE_DIM, CONTROL_DIM>::solve()
 #endif  // HPIPM_PRINT_MATRICES
 
 
-    // solve optimal control problem
-    ::d_ocp_qp_ipm_solve(&qp_, &qp_sol_, &arg_, &workspace_);
-    ::d_ocp_qp_ipm_get_status(&workspace_, &hpipm_status_);
+    // solve optimal control problem, warm started from the previous iterate if available
+    const int warmStart = warmStartAvailable_ ? settings_.lqoc_solver_settings.warm_start : LQOCSolverSettings::COLD;
+    solveIpm(warmStart);
+
+    // if the warm started solve did not converge within its reduced iteration budget, fall back to a cold start
+    if (hpipm_status_ != 0 && warmStart != LQOCSolverSettings::COLD)
+    {
+        if (settings_.lqoc_solver_settings.lqoc_debug_print)
+            printf("\nHPIPM warm start failed with flag %i, re-solving from cold start.\n", hpipm_status_);
+        solveIpm(LQOCSolverSettings::COLD);
+    }
+
+    warmStartAvailable_ =
+        (hpipm_status_ == 0) && (settings_.lqoc_solver_settings.warm_start != LQOCSolverSettings::COLD);
 
     isLrInvComputed_ = false;
 
@@ -636,6 +695,59 @@ void HPIPMInterface<STATE_DIM, CONTROL_DIM>::d_print_e_tran_mat(int row, int col
 }
 
 
+template <int STATE_DIM, int CONTROL_DIM>
+void HPIPMInterface<STATE_DIM, CONTROL_DIM>::shiftWarmStart(int nStages)
+{
+    if (!warmStartAvailable_ || nStages <= 0)
+        return;
+
+    if (nStages >= N_)
+    {
+        warmStartAvailable_ = false;
+        return;
+    }
+
+    // the primal variables of each stage are stored as ux = [u; x], the multipliers and slacks of the inequalities
+    // as [lb; lg; ub; ug]. Copy in ascending order, such that the source stages are not yet overwritten.
+    for (int i = 0; i + nStages <= N_; i++)
+    {
+        const int j = i + nStages;
+
+        if (nu_[i] == nu_[j])
+            ::blasfeo_dveccp(nu_[i], &qp_sol_.ux[j], 0, &qp_sol_.ux[i], 0);
+
+        // the initial state is not a decision variable
+        if (nx_[i] == nx_[j])
+            ::blasfeo_dveccp(nx_[i], &qp_sol_.ux[j], nu_[j], &qp_sol_.ux[i], nu_[i]);
+
+        // multipliers of the dynamics between stage i and i+1
+        if (j < N_)
+            ::blasfeo_dveccp(nx_[i + 1], &qp_sol_.pi[j], 0, &qp_sol_.pi[i], 0);
+
+        if (nbu_[i] == nbu_[j] && nbx_[i] == nbx_[j] && ng_[i] == ng_[j])
+        {
+            const int nc = 2 * (nbu_[i] + nbx_[i] + ng_[i]);
+            ::blasfeo_dveccp(nc, &qp_sol_.lam[j], 0, &qp_sol_.lam[i], 0);
+            ::blasfeo_dveccp(nc, &qp_sol_.t[j], 0, &qp_sol_.t[i], 0);
+        }
+    }
+}
+
+
+template <int STATE_DIM, int CONTROL_DIM>
+void HPIPMInterface<STATE_DIM, CONTROL_DIM>::resetWarmStart()
+{
+    warmStartAvailable_ = false;
+}
+
+
+template <int STATE_DIM, int CONTROL_DIM>
+int HPIPMInterface<STATE_DIM, CONTROL_DIM>::getNumIterations() const
+{
+    return workspace_.iter;
+}
+
+
 template <int STATE_DIM, int CONTROL_DIM>
 const ct::core::ControlVectorArray<CONTROL_DIM>& HPIPMInterface<STATE_DIM, CONTROL_DIM>::get_lv()
 {
@@ -106,9 +106,28 @@ public:
     //! override this method to catch corner case with lv being incompatible with constraints
     virtual const ct::core::ControlVectorArray<CONTROL_DIM>& get_lv() override;
 
+    /*!
+     * @brief shift the stored primal and dual iterate by a number of stages for warm starting the next MPC cycle
+     *
+     * The stages at the end of the horizon, for which no shifted data is available, keep their previous values.
+     * Stages whose dimensions or constraint configuration do not match the shifted stage are left untouched.
+     */
+    virtual void shiftWarmStart(int nStages) override;
+
+    virtual void resetWarmStart() override;
+
+    //! number of interior-point iterations of the last solve
+    int getNumIterations() const;
+
 private:
     void setSolverDimensions(const int N, const int nbu = 0, const int nbx = 0, const int ng = 0);
 
+    //! apply mode, tolerances and iteration limits from the settings to the ipm arguments
+    void setIpmArguments();
+
+    //! run the interior-point solver with the given warm start strategy
+    void solveIpm(int warmStart);
+
     /*!
      * @brief set problem implementation for HPIPM
      * \warning This method is called in the control loop. As little memory as possible
@@ -243,8 +262,9 @@ private:
     struct d_ocp_qp_ipm_ws workspace_;
     int hpipm_status_;  // status code after solving
 
-    // todo make this a setting
-    ::hpipm_mode mode_ = ::hpipm_mode::SPEED;  // ROBUST/BALANCED; see also hpipm_common.h
+    bool ipmArgCreated_;       //! true once the ipm arguments have been allocated
+    bool warmStartAvailable_;  //! true if the solution struct holds the iterate of a successful previous solve
+    double defaultMu0_;        //! initial barrier parameter of the selected ipm mode
 };
 
 }  // namespace optcon
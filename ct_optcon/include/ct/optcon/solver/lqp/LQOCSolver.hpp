@@ -78,6 +78,15 @@ public:
         throw std::runtime_error("solveSingleStage not available for this solver.");
     }
 
+    /*!
+     * @brief shift the iterate stored for warm starting by a number of stages, e.g. between MPC cycles
+     * \note solvers without warm start capabilities (e.g. direct Riccati solvers) ignore this call
+     */
+    virtual void shiftWarmStart(int nStages) {}
+
+    //! discard the iterate stored for warm starting, the next solve starts cold
+    virtual void resetWarmStart() {}
+
     //! extract the solution (can be overriden if additional extraction steps required in specific solver)
     virtual void computeStatesAndControls() = 0;
     //! return solution for state
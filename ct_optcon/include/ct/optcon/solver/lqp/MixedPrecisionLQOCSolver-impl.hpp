@@ -0,0 +1,184 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+ **********************************************************************************************************************/
+
+#pragma once
+
+namespace ct {
+namespace optcon {
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::MixedPrecisionLQOCSolver(
+    std::shared_ptr<SolverLQOCSolver_t> solver)
+    : solver_(solver), solverProblem_(new SolverLQOCProblem_t())
+{
+    if (!solver_)
+        solver_ = std::shared_ptr<SolverLQOCSolver_t>(new GNRiccatiSolver<STATE_DIM, CONTROL_DIM, SOLVER_SCALAR>());
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::solve()
+{
+    for (int k = 0; k < this->lqocProblem_->getNumberOfStages(); k++)
+        convertStage(k);
+    convertTerminalStage();
+
+    solver_->solve();
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::initializeAndAllocate()
+{
+    solver_->initializeAndAllocate();
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::solveSingleStage(int N)
+{
+    // stages are solved backwards, the first call also requires the terminal stage
+    if (N == this->lqocProblem_->getNumberOfStages() - 1)
+        convertTerminalStage();
+    convertStage(N);
+
+    solver_->solveSingleStage(N);
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::configure(
+    const NLOptConSettings& settings)
+{
+    solver_->configure(settings);
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::shiftWarmStart(int nStages)
+{
+    solver_->shiftWarmStart(nStages);
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::resetWarmStart()
+{
+    solver_->resetWarmStart();
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::computeStatesAndControls()
+{
+    solver_->computeStatesAndControls();
+
+    const ct::core::StateVectorArray<STATE_DIM, SOLVER_SCALAR>& x = solver_->getSolutionState();
+    const ct::core::ControlVectorArray<CONTROL_DIM, SOLVER_SCALAR>& u = solver_->getSolutionControl();
+
+    this->x_sol_.resize(x.size());
+    this->u_sol_.resize(u.size());
+    for (size_t k = 0; k < x.size(); k++)
+        this->x_sol_[k] = x[k].template cast<SCALAR>();
+    for (size_t k = 0; k < u.size(); k++)
+        this->u_sol_[k] = u[k].template cast<SCALAR>();
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::computeFeedbackMatrices()
+{
+    solver_->computeFeedbackMatrices();
+
+    const ct::core::FeedbackArray<STATE_DIM, CONTROL_DIM, SOLVER_SCALAR>& L = solver_->getSolutionFeedback();
+
+    this->L_.resize(L.size());
+    for (size_t k = 0; k < L.size(); k++)
+        this->L_[k] = L[k].template cast<SCALAR>();
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::compute_lv()
+{
+    solver_->compute_lv();
+
+    const ct::core::ControlVectorArray<CONTROL_DIM, SOLVER_SCALAR>& lv = solver_->get_lv();
+
+    this->lv_.resize(lv.size());
+    for (size_t k = 0; k < lv.size(); k++)
+        this->lv_[k] = lv[k].template cast<SCALAR>();
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+SCALAR MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::getSmallestEigenvalue()
+{
+    return static_cast<SCALAR>(solver_->getSmallestEigenvalue());
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+auto MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::getSolverProblem() const
+    -> const SolverLQOCProblem_t&
+{
+    return *solverProblem_;
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::setProblemImpl(
+    std::shared_ptr<LQOCProblem_t> lqocProblem)
+{
+    if (lqocProblem->isConstrained())
+    {
+        throw std::runtime_error(
+            "Selected wrong solver - MixedPrecisionLQOCSolver cannot handle constrained problems. Use a different "
+            "solver");
+    }
+
+    const int N = lqocProblem->getNumberOfStages();
+    if (solverProblem_->getNumberOfStages() != N)
+        solverProblem_->changeNumStages(N);
+
+    solver_->setProblem(solverProblem_);
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::convertStage(int k)
+{
+    const LQOCProblem_t& p = *this->lqocProblem_;
+    SolverLQOCProblem_t& q = *solverProblem_;
+
+    q.A_[k] = p.A_[k].template cast<SOLVER_SCALAR>();
+    q.B_[k] = p.B_[k].template cast<SOLVER_SCALAR>();
+    q.b_[k] = p.b_[k].template cast<SOLVER_SCALAR>();
+
+    q.q_[k] = static_cast<SOLVER_SCALAR>(p.q_[k]);
+    q.qv_[k] = p.qv_[k].template cast<SOLVER_SCALAR>();
+    q.Q_[k] = p.Q_[k].template cast<SOLVER_SCALAR>();
+    q.rv_[k] = p.rv_[k].template cast<SOLVER_SCALAR>();
+    q.R_[k] = p.R_[k].template cast<SOLVER_SCALAR>();
+    q.P_[k] = p.P_[k].template cast<SOLVER_SCALAR>();
+}
+
+
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR, typename SOLVER_SCALAR>
+void MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR, SOLVER_SCALAR>::convertTerminalStage()
+{
+    const LQOCProblem_t& p = *this->lqocProblem_;
+    SolverLQOCProblem_t& q = *solverProblem_;
+    const int N = this->lqocProblem_->getNumberOfStages();
+
+    q.q_[N] = static_cast<SOLVER_SCALAR>(p.q_[N]);
+    q.qv_[N] = p.qv_[N].template cast<SOLVER_SCALAR>();
+    q.Q_[N] = p.Q_[N].template cast<SOLVER_SCALAR>();
+}
+
+
+}  // namespace optcon
+}  // namespace ct
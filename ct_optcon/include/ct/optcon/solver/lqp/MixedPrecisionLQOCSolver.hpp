@@ -0,0 +1,77 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include "GNRiccatiSolver.hpp"
+
+namespace ct {
+namespace optcon {
+
+/*!
+ * \brief Solves an LQOCProblem in a higher precision than the one it is formulated in
+ *
+ * Rollouts, cost evaluations and linearizations of a nonlinear solver can run in single precision, while the Riccati
+ * recursion accumulates rounding errors over the horizon and suffers from ill-conditioned Hessians. This class converts
+ * the problem to SOLVER_SCALAR at the LQOCProblem boundary, hands it to an LQOCSolver running in SOLVER_SCALAR (by
+ * default the GNRiccatiSolver) and casts the solution back to SCALAR.
+ *
+ * \note only unconstrained problems are supported
+ */
+template <size_t STATE_DIM, size_t CONTROL_DIM, typename SCALAR = float, typename SOLVER_SCALAR = double>
+class MixedPrecisionLQOCSolver : public LQOCSolver<STATE_DIM, CONTROL_DIM, SCALAR>
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef LQOCProblem<STATE_DIM, CONTROL_DIM, SCALAR> LQOCProblem_t;
+    typedef LQOCProblem<STATE_DIM, CONTROL_DIM, SOLVER_SCALAR> SolverLQOCProblem_t;
+    typedef LQOCSolver<STATE_DIM, CONTROL_DIM, SOLVER_SCALAR> SolverLQOCSolver_t;
+
+    /*!
+	 * Constructor
+	 * @param solver the solver working in SOLVER_SCALAR, a GNRiccatiSolver is created if none is given
+	 */
+    MixedPrecisionLQOCSolver(std::shared_ptr<SolverLQOCSolver_t> solver = nullptr);
+
+    virtual void solve() override;
+
+    virtual void initializeAndAllocate() override;
+
+    virtual void solveSingleStage(int N) override;
+
+    virtual void configure(const NLOptConSettings& settings) override;
+
+    virtual void shiftWarmStart(int nStages) override;
+
+    virtual void resetWarmStart() override;
+
+    virtual void computeStatesAndControls() override;
+
+    virtual void computeFeedbackMatrices() override;
+
+    virtual void compute_lv() override;
+
+    virtual SCALAR getSmallestEigenvalue() override;
+
+    //! the problem in solver precision, as seen by the underlying solver
+    const SolverLQOCProblem_t& getSolverProblem() const;
+
+protected:
+    virtual void setProblemImpl(std::shared_ptr<LQOCProblem_t> lqocProblem) override;
+
+    //! convert a stage of the problem to solver precision
+    void convertStage(int k);
+
+    //! convert the terminal stage of the problem to solver precision
+    void convertTerminalStage();
+
+    std::shared_ptr<SolverLQOCSolver_t> solver_;          //! the solver working in SOLVER_SCALAR
+    std::shared_ptr<SolverLQOCProblem_t> solverProblem_;  //! the problem converted to SOLVER_SCALAR
+};
+
+
+}  // namespace optcon
+}  // namespace ct
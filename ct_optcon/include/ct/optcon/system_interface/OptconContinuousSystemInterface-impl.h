@@ -36,6 +36,11 @@ void OptconContinuousSystemInterface<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALA
         discretizers_.at(i) = system_discretizer_ptr_t(new discretizer_t(
             this->systems_.at(i), this->settings_.dt, this->settings_.integrator, this->settings_.K_sim));
         discretizers_.at(i)->initialize();
+
+        if (this->systems_.at(i)->isSymplectic())
+            sensitivity_.at(i)->setControlledSystem(this->systems_.at(i));
+        else
+            sensitivity_.at(i)->setControlledSystem(nullptr);
     }
 }
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR>
@@ -94,6 +99,10 @@ void OptconContinuousSystemInterface<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALA
                 new ct::core::SensitivityApproximation<STATE_DIM, CONTROL_DIM, STATE_DIM / 2, STATE_DIM / 2, SCALAR>(
                     this->settings_.dt, this->linearSystems_.at(i), this->settings_.discretization));
         }
+
+        // the symplectic splitting methods propagate their stage states with the nonlinear system
+        if (this->systems_.at(i)->isSymplectic())
+            sensitivity_.at(i)->setControlledSystem(this->systems_.at(i));
     }
 }
 
@@ -146,7 +155,12 @@ void OptconContinuousSystemInterface<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALA
     StateVectorArrayPtr& subStepsX,
     const size_t threadId)
 {
-    subStepsX = discretizers_[threadId]->getSubstates();
+    // the recorder reuses its containers, hence copy into the existing storage of this stage
+    const StateVectorArrayPtr& substates = discretizers_[threadId]->getSubstates();
+    if (!subStepsX || subStepsX == substates)
+        subStepsX = StateVectorArrayPtr(new StateVectorArray(*substates));
+    else
+        *subStepsX = *substates;
 }
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR>
@@ -154,7 +168,11 @@ void OptconContinuousSystemInterface<STATE_DIM, CONTROL_DIM, P_DIM, V_DIM, SCALA
     ControlVectorArrayPtr& subStepsU,
     const size_t threadId)
 {
-    subStepsU = discretizers_[threadId]->getSubcontrols();
+    const ControlVectorArrayPtr& subcontrols = discretizers_[threadId]->getSubcontrols();
+    if (!subStepsU || subStepsU == subcontrols)
+        subStepsU = ControlVectorArrayPtr(new ControlVectorArray(*subcontrols));
+    else
+        *subStepsU = *subcontrols;
 }
 
 template <size_t STATE_DIM, size_t CONTROL_DIM, size_t P_DIM, size_t V_DIM, typename SCALAR>
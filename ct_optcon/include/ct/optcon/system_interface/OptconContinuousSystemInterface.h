@@ -50,8 +50,10 @@ public:
     typedef ct::core::Sensitivity<STATE_DIM, CONTROL_DIM, SCALAR> Sensitivity_t;
     typedef std::shared_ptr<Sensitivity_t> SensitivityPtr;
 
+    typedef typename Base::StateVectorArray StateVectorArray;
     typedef typename Base::StateVectorArrayPtr StateVectorArrayPtr;
     typedef typename Base::StateSubstepsPtr StateSubstepsPtr;
+    typedef typename Base::ControlVectorArray ControlVectorArray;
     typedef typename Base::ControlVectorArrayPtr ControlVectorArrayPtr;
     typedef typename Base::ControlSubstepsPtr ControlSubstepsPtr;
 
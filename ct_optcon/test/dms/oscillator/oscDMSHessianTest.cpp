@@ -0,0 +1,276 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+/*!
+ * This unit test compares the exact DMS Lagrangian Hessian, generated with CppADCG, against finite differences of the
+ * Lagrangian gradient, and the SQP solutions obtained with both.
+ */
+
+#include <ct/optcon/optcon.h>
+#include <gtest/gtest.h>
+
+namespace ct {
+namespace optcon {
+namespace example {
+
+//! a damped pendulum, such that the continuity constraints have curvature
+template <typename SCALAR>
+class DampedPendulum : public core::ControlledSystem<2, 1, SCALAR>
+{
+public:
+    typedef typename ct::core::tpl::TraitSelector<SCALAR>::Trait Trait;
+
+    DampedPendulum(SCALAR w_n, SCALAR zeta) : w_n_(w_n), zeta_(zeta) {}
+    DampedPendulum* clone() const override { return new DampedPendulum(*this); }
+    void computeControlledDynamics(const core::StateVector<2, SCALAR>& state,
+        const SCALAR& t,
+        const core::ControlVector<1, SCALAR>& control,
+        core::StateVector<2, SCALAR>& derivative) override
+    {
+        derivative(0) = state(1);
+        derivative(1) = -w_n_ * w_n_ * Trait::sin(state(0)) - SCALAR(2.0) * zeta_ * w_n_ * state(1) + control(0);
+    }
+
+private:
+    SCALAR w_n_;
+    SCALAR zeta_;
+};
+
+
+class OscDmsHessian
+{
+public:
+    typedef DmsDimensions<2, 1> OscDimensions;
+    typedef DmsProblem<2, 1> Problem_t;
+    typedef tpl::Nlp<double> Nlp_t;
+
+    OscDmsHessian()
+    {
+        settings_.N_ = 5;
+        settings_.T_ = 1.0;
+        settings_.nThreads_ = 2;
+        settings_.splineType_ = DmsSettings::PIECEWISE_LINEAR;
+        settings_.costEvaluationType_ = DmsSettings::SIMPLE;
+        settings_.objectiveType_ = DmsSettings::KEEP_TIME_AND_GRID;
+        settings_.integrationType_ = DmsSettings::RK4;
+        settings_.dt_sim_ = 0.01;
+        settings_.solverSettings_.solverType_ = NlpSolverType::SQP;
+
+        OscDimensions::state_matrix_t Q, Q_final;
+        Q << 1.0, 0.2, 0.2, 10.0;
+        Q_final << 5.0, 0.0, 0.0, 1.0;
+        OscDimensions::control_matrix_t R;
+        R << 0.1;
+        OscDimensions::state_vector_t x_final;
+        x_final << 2.0, -1.0;
+
+        costFunction_ = std::shared_ptr<CostFunctionQuadratic<2, 1>>(new CostFunctionQuadraticSimple<2, 1>(
+            Q, R, x_final, OscDimensions::control_vector_t::Zero(), x_final, Q_final));
+
+        x_0_ << 0.5, 0.0;
+    }
+
+    /**
+     * @brief      Compares the exact Hessian of the Lagrangian against finite differences of its gradient at a random
+     *             iterate and random multipliers
+     *
+     * @param[in]  system    The system dynamics
+     * @param[in]  systemCG  The same dynamics in auto-diff codegen scalar
+     */
+    void compareHessian(std::shared_ptr<core::ControlledSystem<2, 1>> system,
+        std::shared_ptr<core::ControlledSystem<2, 1, core::ADCGScalar>> systemCG)
+    {
+        ContinuousOptConProblem<2, 1> optProblem(system, costFunction_);
+        optProblem.setInitialState(x_0_);
+        optProblem.setTimeHorizon(settings_.T_);
+
+        DmsSolver<2, 1> dmsSolver(optProblem, settings_);
+        dmsSolver.setExactHessianSystem(systemCG);
+        std::shared_ptr<Problem_t> problem = dmsSolver.getDmsProblem();
+
+        const size_t n = problem->getVarCount();
+        const size_t m = problem->getConstraintsCount();
+
+        std::srand(42);
+        Eigen::VectorXd w = Eigen::VectorXd::Random(n);
+        Eigen::VectorXd lambda = Eigen::VectorXd::Random(m);
+
+        // the exact Hessian, only its lower triangular part is returned
+        const int nele_hes = problem->getNonZeroHessianCount();
+        Eigen::VectorXd hesValues(nele_hes);
+        Eigen::VectorXi iRow(nele_hes), jCol(nele_hes);
+        Nlp_t::MapVecXs hesMap(hesValues.data(), nele_hes);
+        Nlp_t::MapVecXi iRowMap(iRow.data(), nele_hes);
+        Nlp_t::MapVecXi jColMap(jCol.data(), nele_hes);
+        Nlp_t::MapConstVecXs lambdaMap(lambda.data(), m);
+
+        problem->getSparsityPatternHessian(nele_hes, iRowMap, jColMap);
+        problem->setOptimizationVariables(w);
+        problem->evaluateHessian(nele_hes, hesMap, 1.0, lambdaMap);
+
+        Eigen::MatrixXd hessian = Eigen::MatrixXd::Zero(n, n);
+        for (int k = 0; k < nele_hes; k++)
+        {
+            ASSERT_GE(iRow(k), jCol(k));
+            hessian(iRow(k), jCol(k)) = hesValues(k);
+            hessian(jCol(k), iRow(k)) = hesValues(k);
+        }
+
+        // central differences of the Lagrangian gradient
+        const double eps = 1e-6;
+        Eigen::MatrixXd hessianNumDiff(n, n);
+        for (size_t i = 0; i < n; i++)
+        {
+            Eigen::VectorXd wPerturbed = w;
+            wPerturbed(i) += eps;
+            Eigen::VectorXd gradPlus = lagrangianGradient(*problem, wPerturbed, lambda);
+            wPerturbed(i) = w(i) - eps;
+            Eigen::VectorXd gradMinus = lagrangianGradient(*problem, wPerturbed, lambda);
+            hessianNumDiff.col(i) = (gradPlus - gradMinus) / (2.0 * eps);
+        }
+
+        ASSERT_LT((hessian - hessianNumDiff).cwiseAbs().maxCoeff(), 1e-5 * std::max(1.0, hessian.norm()));
+
+        // the continuity constraints contribute, this is not the cost Hessian only
+        lambda.setZero();
+        problem->setOptimizationVariables(w);
+        problem->evaluateHessian(nele_hes, hesMap, 1.0, lambdaMap);
+        Eigen::MatrixXd costHessian = Eigen::MatrixXd::Zero(n, n);
+        for (int k = 0; k < nele_hes; k++)
+        {
+            costHessian(iRow(k), jCol(k)) = hesValues(k);
+            costHessian(jCol(k), iRow(k)) = hesValues(k);
+        }
+        constraintCurvature_ = (hessian - costHessian).norm();
+    }
+
+    /**
+     * @brief      Solves the problem with the SqpSolver, once with the exact Hessian and once with finite differences
+     *
+     * @param[in]  system    The system dynamics
+     * @param[in]  systemCG  The same dynamics in auto-diff codegen scalar
+     */
+    void compareSqpSolutions(std::shared_ptr<core::ControlledSystem<2, 1>> system,
+        std::shared_ptr<core::ControlledSystem<2, 1, core::ADCGScalar>> systemCG)
+    {
+        ContinuousOptConProblem<2, 1> optProblem(system, costFunction_);
+        optProblem.setInitialState(x_0_);
+        optProblem.setTimeHorizon(settings_.T_);
+
+        settings_.splineType_ = DmsSettings::ZERO_ORDER_HOLD;
+        settings_.solverSettings_.sqpSettings_.hessianApproximation_ = SqpSettings::FINITE_DIFFERENCES;
+        DmsPolicy<2, 1> initialGuess;
+        initialGuess.xSolution_.resize(settings_.N_ + 1, x_0_);
+        initialGuess.uSolution_.resize(settings_.N_ + 1, OscDimensions::control_vector_t::Zero());
+
+        DmsSolver<2, 1> dmsSolver(optProblem, settings_);
+        dmsSolver.setInitialGuess(initialGuess);
+        ASSERT_TRUE(dmsSolver.solve());
+        const DmsPolicy<2, 1> solutionFiniteDifferences = dmsSolver.getSolution();
+
+        DmsSolver<2, 1> dmsSolverExact(optProblem, settings_);
+        dmsSolverExact.setExactHessianSystem(systemCG);
+        dmsSolverExact.setInitialGuess(initialGuess);
+        ASSERT_TRUE(dmsSolverExact.solve());
+        const DmsPolicy<2, 1>& solutionExact = dmsSolverExact.getSolution();
+
+        for (size_t i = 0; i < settings_.N_ + 1; i++)
+        {
+            ASSERT_LT((solutionExact.xSolution_[i] - solutionFiniteDifferences.xSolution_[i]).norm(), 1e-4);
+            ASSERT_LT((solutionExact.uSolution_[i] - solutionFiniteDifferences.uSolution_[i]).norm(), 1e-4);
+        }
+    }
+
+    std::shared_ptr<core::ControlledSystem<2, 1>> getOscillator() const
+    {
+        return std::shared_ptr<core::ControlledSystem<2, 1>>(new core::SecondOrderSystem(w_n_, zeta_));
+    }
+
+    std::shared_ptr<core::ControlledSystem<2, 1, core::ADCGScalar>> getOscillatorCG() const
+    {
+        return std::shared_ptr<core::ControlledSystem<2, 1, core::ADCGScalar>>(
+            new core::tpl::SecondOrderSystem<core::ADCGScalar>(core::ADCGScalar(w_n_), core::ADCGScalar(zeta_)));
+    }
+
+    DmsSettings settings_;
+    double constraintCurvature_ = 0.0;
+    const double w_n_ = 0.5;
+    const double zeta_ = 0.01;
+
+private:
+    //! the gradient of the Lagrangian, grad f(w) + J(w)^T lambda
+    Eigen::VectorXd lagrangianGradient(Problem_t& problem, const Eigen::VectorXd& w, const Eigen::VectorXd& lambda)
+    {
+        problem.setOptimizationVariables(w);
+
+        const size_t n = problem.getVarCount();
+        Eigen::VectorXd grad(n);
+        Nlp_t::MapVecXs gradMap(grad.data(), n);
+        problem.evaluateCostGradient(n, gradMap);
+
+        const int nele_jac = problem.getNonZeroJacobianCount();
+        Eigen::VectorXd jac(nele_jac);
+        Eigen::VectorXi iRow(nele_jac), jCol(nele_jac);
+        Nlp_t::MapVecXs jacMap(jac.data(), nele_jac);
+        Nlp_t::MapVecXi iRowMap(iRow.data(), nele_jac);
+        Nlp_t::MapVecXi jColMap(jCol.data(), nele_jac);
+        problem.getSparsityPatternJacobian(nele_jac, iRowMap, jColMap);
+        problem.evaluateConstraintJacobian(nele_jac, jacMap);
+
+        for (int k = 0; k < nele_jac; k++)
+            grad(jCol(k)) += jac(k) * lambda(iRow(k));
+
+        return grad;
+    }
+
+    std::shared_ptr<CostFunctionQuadratic<2, 1>> costFunction_;
+    OscDimensions::state_vector_t x_0_;
+};
+
+
+TEST(DmsHessianTest, OscillatorHessianTest)
+{
+    OscDmsHessian test;
+    test.compareHessian(test.getOscillator(), test.getOscillatorCG());
+
+    // the flow map of the linear oscillator is linear in the optimization variables
+    ASSERT_LT(test.constraintCurvature_, 1e-10);
+}
+
+TEST(DmsHessianTest, PendulumHessianTest)
+{
+    OscDmsHessian test;
+    std::shared_ptr<core::ControlledSystem<2, 1>> pendulum(new DampedPendulum<double>(test.w_n_, test.zeta_));
+    std::shared_ptr<core::ControlledSystem<2, 1, core::ADCGScalar>> pendulumCG(
+        new DampedPendulum<core::ADCGScalar>(core::ADCGScalar(test.w_n_), core::ADCGScalar(test.zeta_)));
+
+    for (auto splineType : {DmsSettings::ZERO_ORDER_HOLD, DmsSettings::PIECEWISE_LINEAR})
+    {
+        test.settings_.splineType_ = splineType;
+        test.compareHessian(pendulum, pendulumCG);
+        ASSERT_GT(test.constraintCurvature_, 1e-3);
+    }
+}
+
+TEST(DmsHessianTest, PendulumSqpTest)
+{
+    OscDmsHessian test;
+    std::shared_ptr<core::ControlledSystem<2, 1>> pendulum(new DampedPendulum<double>(test.w_n_, test.zeta_));
+    std::shared_ptr<core::ControlledSystem<2, 1, core::ADCGScalar>> pendulumCG(
+        new DampedPendulum<core::ADCGScalar>(core::ADCGScalar(test.w_n_), core::ADCGScalar(test.zeta_)));
+
+    test.compareSqpSolutions(pendulum, pendulumCG);
+}
+
+}  // namespace example
+}  // namespace optcon
+}  // namespace ct
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
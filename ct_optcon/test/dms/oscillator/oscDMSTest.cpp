@@ -9,6 +9,8 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
  * \example oscDMSTest.cpp
  */
 
+#include <atomic>
+
 #include <ct/optcon/optcon.h>
 #include <gtest/gtest.h>
 
@@ -23,6 +25,31 @@ namespace ct {
 namespace optcon {
 namespace example {
 
+//! a damped pendulum, the nonlinear counterpart of the oscillator. Counts its evaluations across all clones.
+class Pendulum : public ct::core::ControlledSystem<2, 1>
+{
+public:
+    Pendulum(double w_n, double zeta) : w_n_(w_n), zeta_(zeta), evaluations_(new std::atomic<size_t>(0)) {}
+    Pendulum* clone() const override { return new Pendulum(*this); }
+    void computeControlledDynamics(const ct::core::StateVector<2>& state,
+        const double& t,
+        const ct::core::ControlVector<1>& control,
+        ct::core::StateVector<2>& derivative) override
+    {
+        (*evaluations_)++;
+        derivative(0) = state(1);
+        derivative(1) = -w_n_ * w_n_ * std::sin(state(0)) - 2.0 * zeta_ * w_n_ * state(1) + control(0);
+    }
+
+    size_t getEvaluations() const { return *evaluations_; }
+    void resetEvaluations() { *evaluations_ = 0; }
+
+private:
+    double w_n_;
+    double zeta_;
+    std::shared_ptr<std::atomic<size_t>> evaluations_;
+};
+
 class OscDms
 {
 public:
@@ -168,6 +195,264 @@ public:
 #endif
     }
 
+    void testMeshRefinement()
+    {
+        settings_.solverSettings_.solverType_ = NlpSolverType::SQP;
+        settings_.N_ = 5;
+
+        ContinuousOptConProblem<2, 1> optProblem(oscillator_, costFunction_);
+        optProblem.setInitialState(x_0_);
+        optProblem.setTimeHorizon(settings_.T_);
+
+        // a free oscillation on every shot
+        OscDimensions::state_vector_t x_guess;
+        x_guess << 1.0, 0.0;
+        DmsPolicy<2, 1> guess;
+        guess.xSolution_.resize(settings_.N_ + 1, x_guess);
+        guess.uSolution_.resize(settings_.N_ + 1, OscDimensions::control_vector_t::Zero());
+
+        DmsMeshRefinementSettings refinementSettings;
+        refinementSettings.errorTolerance_ = 1e-5;
+
+        DmsMeshRefinement<2, 1> splitting(optProblem, settings_, refinementSettings);
+        splitting.setInitialGuess(guess);
+        splitting.estimateShotErrors();
+
+        // the interpolation error dominates the integration error of RK4
+        ASSERT_TRUE(splitting.getIntegrationErrors().maxCoeff() < 1e-10);
+        ASSERT_TRUE(splitting.getInterpolationErrors().minCoeff() > refinementSettings.errorTolerance_);
+
+        ASSERT_TRUE(splitting.refineGrid());
+        ASSERT_EQ(splitting.getShotTimes().size(), 2 * settings_.N_ + 1);
+        ASSERT_EQ(splitting.getSettings().N_, 2 * settings_.N_);
+        for (size_t i = 0; i < splitting.getShotTimes().size(); i++)
+            ASSERT_NEAR(splitting.getShotTimes()[i], 0.5 * i, 1e-12);
+
+        // the refined problem is warm-started from the integrated shots
+        const DmsPolicy<2, 1>& warmStart = splitting.getSolution();
+        for (size_t i = 0; i < warmStart.xSolution_.size(); i += 2)
+            ASSERT_TRUE(warmStart.xSolution_[i].isApprox(guess.xSolution_[i / 2]));
+        ASSERT_NEAR(warmStart.xSolution_[1](0), std::cos(0.5 * w_n_), 1e-3);
+
+        // neighbouring shots with negligible errors get merged, up to the maximum shot length
+        refinementSettings.errorTolerance_ = 1.0;
+        refinementSettings.h_max_ = 2.0;
+        DmsMeshRefinement<2, 1> merging(optProblem, settings_, refinementSettings);
+        merging.setInitialGuess(guess);
+        merging.estimateShotErrors();
+        ASSERT_TRUE(merging.refineGrid());
+        ASSERT_EQ(merging.getShotTimes().size(), 4);
+        ASSERT_NEAR(merging.getShotTimes()[1], 2.0, 1e-12);
+        ASSERT_NEAR(merging.getShotTimes()[3], settings_.T_, 1e-12);
+
+        merging.estimateShotErrors();
+        ASSERT_FALSE(merging.refineGrid());
+
+        // a merge and a split in the same pass keep the number of shots, but change the grid. The first shots rest,
+        // the last one oscillates
+        settings_.N_ = 4;
+        DmsPolicy<2, 1> restingGuess;
+        restingGuess.xSolution_.resize(settings_.N_ + 1, OscDimensions::state_vector_t::Zero());
+        restingGuess.xSolution_[settings_.N_ - 1] = x_guess;
+        restingGuess.xSolution_[settings_.N_] = x_guess;
+        restingGuess.uSolution_.resize(settings_.N_ + 1, OscDimensions::control_vector_t::Zero());
+
+        refinementSettings.errorTolerance_ = 1e-5;
+        refinementSettings.h_max_ = 2.5;
+        DmsMeshRefinement<2, 1> splitAndMerge(optProblem, settings_, refinementSettings);
+        splitAndMerge.setInitialGuess(restingGuess);
+        splitAndMerge.estimateShotErrors();
+        ASSERT_TRUE(splitAndMerge.refineGrid());
+        ASSERT_EQ(splitAndMerge.getShotTimes().size(), settings_.N_ + 1);
+        ASSERT_NEAR(splitAndMerge.getShotTimes()[1], 2.5, 1e-12);
+        ASSERT_NEAR(splitAndMerge.getShotTimes()[2], 3.75, 1e-12);
+        ASSERT_GT(splitAndMerge.getShotTimes()[3], 3.75);
+    }
+
+    void testMeshRefinementSolve()
+    {
+        settings_.solverSettings_.solverType_ = NlpSolverType::SQP;
+        settings_.splineType_ = DmsSettings::ZERO_ORDER_HOLD;
+        settings_.N_ = 5;
+
+        ContinuousOptConProblem<2, 1> optProblem(oscillator_, costFunction_);
+        optProblem.setInitialState(x_0_);
+        optProblem.setTimeHorizon(settings_.T_);
+
+        DmsMeshRefinementSettings refinementSettings;
+        refinementSettings.errorTolerance_ = 1e-4;
+        refinementSettings.maxIterations_ = 10;
+
+        DmsMeshRefinement<2, 1> refinement(optProblem, settings_, refinementSettings);
+        calcInitGuess();
+        refinement.setInitialGuess(initialPolicy_);
+        ASSERT_TRUE(refinement.solve());
+
+        // the grid got refined until all shots meet the tolerance
+        ASSERT_GT(refinement.getRefinementCount(), 0u);
+        ASSERT_GT(refinement.getSettings().N_, settings_.N_);
+        ASSERT_LT(refinement.getShotErrors().maxCoeff(), refinementSettings.errorTolerance_);
+
+        const OscDimensions::time_array_t& shotTimes = refinement.getShotTimes();
+        ASSERT_EQ(shotTimes.size(), refinement.getSettings().N_ + 1);
+        ASSERT_NEAR(shotTimes.front(), 0.0, 1e-12);
+        ASSERT_NEAR(shotTimes.back(), settings_.T_, 1e-12);
+        for (size_t i = 0; i + 1 < shotTimes.size(); i++)
+        {
+            // every node lies on the simulation grid and no shot is shorter than allowed
+            ASSERT_NEAR(shotTimes[i] / settings_.dt_sim_, std::round(shotTimes[i] / settings_.dt_sim_), 1e-8);
+            ASSERT_GE(shotTimes[i + 1] - shotTimes[i], settings_.h_min_ - 1e-12);
+        }
+
+        // the solution on the refined grid is feasible
+        const DmsPolicy<2, 1>& solution = refinement.getSolution();
+        ASSERT_EQ(solution.xSolution_.size(), shotTimes.size());
+        ASSERT_LT((solution.xSolution_.front() - x_0_).norm(), 1e-10);
+        auto shotContainers = refinement.getSolver()->getDmsProblem()->getShotContainers();
+        for (size_t i = 0; i < shotContainers.size(); i++)
+        {
+            shotContainers[i]->integrateShot();
+            ASSERT_LT((shotContainers[i]->getStateIntegrated() - solution.xSolution_[i + 1]).norm(), 1e-6);
+        }
+    }
+
+    void testSqp()
+    {
+        settings_.solverSettings_.solverType_ = NlpSolverType::SQP;
+        settings_.N_ = 10;
+
+        ContinuousOptConProblem<2, 1> optProblem(oscillator_, costFunction_);
+        optProblem.setInitialState(x_0_);
+        optProblem.setTimeHorizon(settings_.T_);
+
+        // the continuity constraints of piecewise linear splines couple neighbouring controls
+        dmsPlanner_ = std::shared_ptr<DmsSolver<2, 1>>(new DmsSolver<2, 1>(optProblem, settings_));
+        calcInitGuess();
+        dmsPlanner_->setInitialGuess(initialPolicy_);
+        ASSERT_THROW(dmsPlanner_->solve(), std::runtime_error);
+
+        settings_.splineType_ = DmsSettings::ZERO_ORDER_HOLD;
+        dmsPlanner_ = std::shared_ptr<DmsSolver<2, 1>>(new DmsSolver<2, 1>(optProblem, settings_));
+        dmsPlanner_->setInitialGuess(initialPolicy_);
+        ASSERT_TRUE(dmsPlanner_->solve());
+        solutionPolicy_ = dmsPlanner_->getSolution();
+
+        // the solution is feasible
+        ASSERT_LT((solutionPolicy_.xSolution_.front() - x_0_).norm(), 1e-10);
+        auto shotContainers = dmsPlanner_->getDmsProblem()->getShotContainers();
+        for (size_t i = 0; i < settings_.N_; i++)
+        {
+            shotContainers[i]->integrateShot();
+            ASSERT_LT((shotContainers[i]->getStateIntegrated() - solutionPolicy_.xSolution_[i + 1]).norm(), 1e-6);
+        }
+
+        // the problem is linear-quadratic, any initial guess leads to the same solution
+        DmsPolicy<2, 1> zeroGuess;
+        zeroGuess.xSolution_.resize(settings_.N_ + 1, OscDimensions::state_vector_t::Zero());
+        zeroGuess.uSolution_.resize(settings_.N_ + 1, OscDimensions::control_vector_t::Zero());
+        dmsPlanner_->setInitialGuess(zeroGuess);
+        ASSERT_TRUE(dmsPlanner_->solve());
+        for (size_t i = 0; i < settings_.N_ + 1; i++)
+        {
+            ASSERT_LT((dmsPlanner_->getSolution().xSolution_[i] - solutionPolicy_.xSolution_[i]).norm(), 1e-4);
+            ASSERT_LT((dmsPlanner_->getSolution().uSolution_[i] - solutionPolicy_.uSolution_[i]).norm(), 1e-4);
+        }
+
+        // a warm start from a new initial state, as in an MPC loop
+        OscDimensions::state_vector_t x_start;
+        x_start << 0.1, -0.1;
+        dmsPlanner_->changeInitialState(x_start);
+        dmsPlanner_->prepareWarmStart(10);
+        ASSERT_TRUE(dmsPlanner_->solve());
+        ASSERT_LT((dmsPlanner_->getSolution().xSolution_.front() - x_start).norm(), 1e-10);
+
+        // the next MPC cycle starts one shot later from the shifted solution
+        const DmsPolicy<2, 1> previous = dmsPlanner_->getSolution();
+        dmsPlanner_->changeInitialState(previous.xSolution_[1]);
+        dmsPlanner_->shiftWarmStart(1, 10);
+        const DmsPolicy<2, 1>& shifted = dmsPlanner_->getSolution();
+        for (size_t i = 0; i < settings_.N_ + 1; i++)
+        {
+            const size_t source = std::min(i + 1, settings_.N_);
+            ASSERT_TRUE(shifted.xSolution_[i].isApprox(previous.xSolution_[source]));
+            ASSERT_TRUE(shifted.uSolution_[i].isApprox(previous.uSolution_[source]));
+        }
+        ASSERT_TRUE(dmsPlanner_->solve());
+        ASSERT_LT((dmsPlanner_->getSolution().xSolution_.front() - previous.xSolution_[1]).norm(), 1e-10);
+    }
+
+    void testSqpLagrangianHessian()
+    {
+        settings_.solverSettings_.solverType_ = NlpSolverType::SQP;
+        settings_.splineType_ = DmsSettings::ZERO_ORDER_HOLD;
+        settings_.N_ = 10;
+
+        // a fast pendulum swinging to the target, the continuity constraints are nonlinear
+        std::shared_ptr<Pendulum> pendulum(new Pendulum(3.0, zeta_));
+        ContinuousOptConProblem<2, 1> optProblem(pendulum, costFunction_);
+        optProblem.setInitialState(x_0_);
+        optProblem.setTimeHorizon(settings_.T_);
+
+        dmsPlanner_ = std::shared_ptr<DmsSolver<2, 1>>(new DmsSolver<2, 1>(optProblem, settings_));
+        calcInitGuess();
+        std::shared_ptr<DmsProblem<2, 1>> problem = dmsPlanner_->getDmsProblem();
+
+        // the linearized systems of the problem are numerical derivatives of the pendulum, such that its evaluations
+        // measure the effort of the sensitivity integrations
+        std::vector<size_t> iterations;
+        std::vector<size_t> evaluations;
+        std::vector<Eigen::VectorXd> solutions;
+        for (auto approximation : {SqpSettings::FINITE_DIFFERENCES, SqpSettings::BFGS})
+        {
+            for (bool lagrangianHessian : {true, false})
+            {
+                settings_.solverSettings_.sqpSettings_.hessianApproximation_ = approximation;
+                settings_.solverSettings_.sqpSettings_.lagrangianHessian_ = lagrangianHessian;
+                SqpSolver<2, 1> sqp(problem, problem->getOptVectorDms(), settings_.solverSettings_);
+                dmsPlanner_->setInitialGuess(initialPolicy_);
+                pendulum->resetEvaluations();
+                ASSERT_TRUE(sqp.solve());
+                ASSERT_EQ(sqp.usesLagrangianHessian(), lagrangianHessian);
+                iterations.push_back(sqp.getIterationCount());
+                evaluations.push_back(pendulum->getEvaluations());
+                solutions.push_back(problem->getOptimizationVariables());
+
+                if (lagrangianHessian)
+                {
+                    // the multipliers satisfy the stationarity of the Lagrangian w.r.t. all variables but s_0
+                    const size_t n = problem->getVarCount();
+                    Eigen::VectorXd gradient(n);
+                    tpl::Nlp<double>::MapVecXs gradientMap(gradient.data(), n);
+                    problem->evaluateCostGradient(n, gradientMap);
+
+                    const size_t nnz = problem->getNonZeroJacobianCount();
+                    Eigen::VectorXd jacobian(nnz);
+                    Eigen::VectorXi iRow(nnz), jCol(nnz);
+                    tpl::Nlp<double>::MapVecXs jacobianMap(jacobian.data(), nnz);
+                    tpl::Nlp<double>::MapVecXi iRowMap(iRow.data(), nnz);
+                    tpl::Nlp<double>::MapVecXi jColMap(jCol.data(), nnz);
+                    problem->getSparsityPatternJacobian(nnz, iRowMap, jColMap);
+                    problem->evaluateConstraintJacobian(nnz, jacobianMap);
+                    for (size_t k = 0; k < nnz; k++)
+                        gradient(jCol(k)) += jacobian(k) * sqp.getMultipliers()(iRow(k));
+
+                    gradient.segment<2>(problem->getOptVectorDms()->getStateIndex(0)).setZero();
+                    ASSERT_LT(gradient.lpNorm<Eigen::Infinity>(), 1e-4);
+                }
+            }
+        }
+
+        // all variants lead to the same local solution, the curvature of the dynamics speeds up the convergence
+        for (size_t i = 1; i < solutions.size(); i++)
+            ASSERT_LT((solutions[0] - solutions[i]).lpNorm<Eigen::Infinity>(), 1e-4);
+        ASSERT_LT(iterations[0], iterations[1]);
+        ASSERT_LT(iterations[2], iterations[3]);
+
+        // BFGS needs more iterations, but no additional sensitivity integrations per iteration
+        ASSERT_LT(evaluations[2], evaluations[0]);
+        ASSERT_LT(evaluations[3], evaluations[1]);
+    }
+
     void compareSnoptSolutions()
     {
 #ifdef MATLAB
@@ -259,6 +544,34 @@ TEST(DmsTest, OscDmsTest)
 #endif  // BUILD_WITH_IPOPT_SUPPORT
 }
 
+TEST(DmsTest, OscDmsMeshRefinementTest)
+{
+    OscDms oscDms;
+    oscDms.initialize();
+    oscDms.testMeshRefinement();
+}
+
+TEST(DmsTest, OscDmsMeshRefinementSolveTest)
+{
+    OscDms oscDms;
+    oscDms.initialize();
+    oscDms.testMeshRefinementSolve();
+}
+
+
+TEST(DmsTest, OscDmsSqpTest)
+{
+    OscDms oscDms;
+    oscDms.initialize();
+    oscDms.testSqp();
+}
+
+TEST(DmsTest, OscDmsSqpLagrangianHessianTest)
+{
+    OscDms oscDms;
+    oscDms.initialize();
+    oscDms.testSqpLagrangianHessian();
+}
 
 }  // namespace example
 }  // namespace optcon
@@ -124,6 +124,99 @@ TEST(LQRTest, quadTest)
               << std::endl;
 }
 
+//! a pendulum-like system whose stiffness depends on the first state, linearized analytically
+class ScheduledOscillatorLinear : public ct::core::LinearSystem<2, 1>
+{
+public:
+    ScheduledOscillatorLinear() { B_ << 0.0, 1.0; }
+    ScheduledOscillatorLinear* clone() const override { return new ScheduledOscillatorLinear(*this); }
+    const state_matrix_t& getDerivativeState(const state_vector_t& x,
+        const control_vector_t& u,
+        const double t = 0.0) override
+    {
+        A_ << 0.0, 1.0, -1.0 - 3.0 * x(0) * x(0), -0.1;
+        return A_;
+    }
+    const state_control_matrix_t& getDerivativeControl(const state_vector_t& x,
+        const control_vector_t& u,
+        const double t = 0.0) override
+    {
+        return B_;
+    }
+
+private:
+    state_matrix_t A_;
+    state_control_matrix_t B_;
+};
+
+TEST(LQRTest, gainScheduledLQRTest)
+{
+    typedef ct::optcon::GainScheduledLQR<2, 1, 1> GainScheduledLQR_t;
+
+    std::shared_ptr<ScheduledOscillatorLinear> linearizer(new ScheduledOscillatorLinear);
+
+    Eigen::Matrix2d Q = Eigen::Matrix2d::Identity();
+    Eigen::Matrix<double, 1, 1> R;
+    R << 1.0;
+
+    GainScheduledLQR_t::grid_axes_t axes;
+    axes[0] = {-1.0, -0.5, 0.0, 0.5, 1.0};
+
+    // the operating point is the shifted equilibrium x = (s, 0) with the input compensating the spring force
+    auto operatingPoints = [](const GainScheduledLQR_t::schedule_vector_t& s, ct::core::StateVector<2>& x,
+                               ct::core::ControlVector<1>& u) {
+        x << s(0), 0.0;
+        u << s(0) + s(0) * s(0) * s(0);
+    };
+
+    GainScheduledLQR_t gsLqr(axes);
+    ASSERT_TRUE(gsLqr.design(linearizer, operatingPoints, Q, R, 2, true, true));
+    ASSERT_EQ(gsLqr.getNumberOfNodes(), 5);
+
+    // at the grid nodes the table has to reproduce the LQR gains
+    ct::optcon::LQR<2, 1> lqr;
+    ct::core::ControlVector<1> u_op;
+    ct::core::StateVector<2> x_op;
+    GainScheduledLQR_t::control_feedback_t K_node, K_table, K_lqr;
+    for (size_t n = 0; n < gsLqr.getNumberOfNodes(); n++)
+    {
+        GainScheduledLQR_t::schedule_vector_t s = gsLqr.getNode(n);
+        operatingPoints(s, x_op, u_op);
+        ASSERT_TRUE(lqr.compute(Q, R, linearizer->getDerivativeState(x_op, u_op),
+            linearizer->getDerivativeControl(x_op, u_op), K_lqr, true, true));
+        gsLqr.getGain(s, K_table);
+        ASSERT_LT((K_table - K_lqr).array().abs().maxCoeff(), 1e-10);
+    }
+
+    // between the nodes, gains are interpolated linearly and clamped outside the grid
+    GainScheduledLQR_t::schedule_vector_t s;
+    s << 0.25;
+    gsLqr.getGain(s, K_table);
+    ASSERT_LT((K_table - 0.5 * (gsLqr.getNodeGain(2) + gsLqr.getNodeGain(3))).array().abs().maxCoeff(), 1e-12);
+    s << 5.0;
+    gsLqr.getGain(s, K_table);
+    ASSERT_LT((K_table - gsLqr.getNodeGain(4)).array().abs().maxCoeff(), 1e-12);
+
+    // save and reload the table
+    const std::string fileName = "gainScheduledLqrTest.bin";
+    ASSERT_TRUE(gsLqr.saveToFile(fileName));
+    GainScheduledLQR_t gsLqrLoaded;
+    ASSERT_TRUE(gsLqrLoaded.loadFromFile(fileName));
+    std::remove(fileName.c_str());
+
+    ASSERT_EQ(gsLqrLoaded.getNumberOfNodes(), gsLqr.getNumberOfNodes());
+    ct::core::StateVector<2> x;
+    x << 0.3, -0.2;
+    ct::core::ControlVector<1> u, uLoaded;
+    for (double si = -1.2; si < 1.2; si += 0.1)
+    {
+        s << si;
+        gsLqr.computeControl(s, x, u);
+        gsLqrLoaded.computeControl(s, x, uLoaded);
+        ASSERT_EQ(u, uLoaded);
+    }
+}
+
 #ifdef MATLAB
 TEST(LQRTest, matlabTest)
 {
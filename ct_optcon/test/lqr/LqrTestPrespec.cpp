@@ -4,6 +4,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 **********************************************************************************************************************/
 
 #include <ct/optcon/optcon-prespec.h>
+#include <ct/optcon/lqr/GainScheduledLQR-impl.hpp>  // the schedule dimension is not prespecified
 #include "LqrTest.h"
 
 
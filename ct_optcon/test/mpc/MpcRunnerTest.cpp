@@ -0,0 +1,153 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+/*!
+ * This unit test runs MPC asynchronously in the MpcRunner and closes the loop with a simulated control thread.
+ */
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <ct/optcon/optcon.h>
+
+#include "../testSystems/LinearOscillator.h"
+
+using namespace ct::core;
+using namespace ct::optcon;
+using namespace ct::optcon::example;
+
+typedef NLOptConSolver<state_dim, control_dim> Solver;
+
+//! an MPC controller for the linear oscillator, which measures its solver delay
+std::shared_ptr<MPC<Solver>> createMpc(const StateVector<state_dim>& x0, MPC_MODE mode)
+{
+    Eigen::Vector2d x_final;
+    x_final << 20, 0;
+
+    std::shared_ptr<ControlledSystem<state_dim, control_dim>> system(new example::tpl::LinearOscillator<double>());
+    std::shared_ptr<LinearSystem<state_dim, control_dim>> linearSystem(
+        new example::tpl::LinearOscillatorLinear<double>());
+    std::shared_ptr<CostFunctionQuadratic<state_dim, control_dim>> costFunction =
+        example::tpl::createCostFunctionLinearOscillator<double>(x_final);
+    ContinuousOptConProblem<state_dim, control_dim> problem(1.0, x0, system, costFunction, linearSystem);
+
+    NLOptConSettings settings;
+    settings.nlocp_algorithm = NLOptConSettings::NLOCP_ALGORITHM::GNMS;
+    settings.dt = 0.01;
+    settings.max_iterations = 1;
+    settings.nThreads = 1;
+    settings.printSummary = false;
+
+    mpc_settings mpcSettings;
+    mpcSettings.stateForwardIntegration_ = true;
+    mpcSettings.stateForwardIntegratorType_ = ct::core::IntegrationType::RK4;
+    mpcSettings.stateForwardIntegration_dt_ = settings.dt;
+    mpcSettings.postTruncation_ = false;
+    mpcSettings.measureDelay_ = true;
+    mpcSettings.delayMeasurementMultiplier_ = 1.0;
+    mpcSettings.mpc_mode = mode;
+    mpcSettings.coldStart_ = false;
+    mpcSettings.useExternalTiming_ = false;
+
+    std::shared_ptr<MPC<Solver>> mpc(new MPC<Solver>(problem, settings, mpcSettings));
+
+    size_t K = settings.computeK(1.0);
+    mpc->setInitialGuess(Solver::Policy_t(StateVectorArray<state_dim>(K + 1, x0),
+        ControlVectorArray<control_dim>(K, ControlVector<control_dim>::Zero()),
+        FeedbackArray<state_dim, control_dim>(K, FeedbackMatrix<state_dim, control_dim>::Zero()), settings.dt));
+
+    return mpc;
+}
+
+//! the time since a start time in seconds
+double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST(MpcRunnerTest, closedLoopTest)
+{
+    StateVector<state_dim> x;
+    x << 1.0, 0.5;
+
+    MpcRunner<Solver> runner(createMpc(x, MPC_MODE::CONSTANT_RECEDING_HORIZON));
+
+    ControlVector<control_dim> u;
+    ASSERT_FALSE(runner.getControl(x, 0.0, u));
+
+    runner.start();
+    ASSERT_TRUE(runner.isRunning());
+
+    // a 1 kHz control loop, simulated with explicit Euler steps
+    example::tpl::LinearOscillator<double> system;
+    const double dt = 0.001;
+    size_t controlledSteps = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++)
+    {
+        const double t = elapsed(start);
+        runner.setState(x, t);
+
+        if (runner.getControl(x, t, u))
+            controlledSteps++;
+        else
+            u.setZero();
+
+        StateVector<state_dim> dx;
+        system.computeControlledDynamics(x, t, u, dx);
+        x += dt * dx;
+
+        std::this_thread::sleep_for(std::chrono::microseconds(1000));
+    }
+
+    runner.stop();
+    ASSERT_FALSE(runner.isRunning());
+
+    const MpcRunner<Solver>::Statistics_t& statistics = runner.getStatistics();
+    ASSERT_GT(controlledSteps, 0u);
+    ASSERT_GT(statistics.iterations, 1u);
+    ASSERT_EQ(statistics.failedIterations, 0u);
+    ASSERT_GT(statistics.maxDelay, 0.0);
+    ASSERT_LE(statistics.minDelay, statistics.maxDelay);
+    ASSERT_LE(statistics.meanDelay, statistics.maxDelay);
+    ASSERT_TRUE(u.allFinite());
+
+    // the published policy matches the statistics
+    double policyTs;
+    runner.getPolicy(policyTs);
+    ASSERT_EQ(policyTs, statistics.policyTs);
+}
+
+TEST(MpcRunnerTest, timeHorizonTest)
+{
+    StateVector<state_dim> x;
+    x << 1.0, 0.5;
+
+    MpcRunnerSettings settings;
+    settings.minCyclePeriodUs = 100;
+    MpcRunner<Solver> runner(createMpc(x, MPC_MODE::FIXED_FINAL_TIME), settings);
+    runner.start();
+
+    // the solver thread stops by itself once the final time is reached
+    auto start = std::chrono::steady_clock::now();
+    while (runner.isRunning() && elapsed(start) < 10.0)
+    {
+        runner.setState(x, elapsed(start));
+        std::this_thread::sleep_for(std::chrono::microseconds(1000));
+    }
+
+    ASSERT_FALSE(runner.isRunning());
+    ASSERT_GT(runner.getStatistics().iterations, 0u);
+
+    // stopping a runner which has finished by itself is harmless
+    runner.stop();
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,200 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+/*!
+ * This unit test checks that NLOC and MPC iterations do not allocate heap memory once they are warmed up.
+ */
+
+#include <gtest/gtest.h>
+#include <ct/optcon/optcon.h>
+#include <ct/core/common/AllocationTrackerHooks.h>
+
+#include "../testSystems/LinearOscillator.h"
+
+using namespace ct::core;
+using namespace ct::optcon;
+using namespace ct::optcon::example;
+
+//! the linear oscillator problem with a non-trivial final state
+ContinuousOptConProblem<state_dim, control_dim> createProblem(const StateVector<state_dim>& x0)
+{
+    Eigen::Vector2d x_final;
+    x_final << 20, 0;
+
+    std::shared_ptr<ControlledSystem<state_dim, control_dim>> system(new example::tpl::LinearOscillator<double>());
+    std::shared_ptr<LinearSystem<state_dim, control_dim>> linearSystem(
+        new example::tpl::LinearOscillatorLinear<double>());
+    std::shared_ptr<CostFunctionQuadratic<state_dim, control_dim>> costFunction =
+        example::tpl::createCostFunctionLinearOscillator<double>(x_final);
+
+    return ContinuousOptConProblem<state_dim, control_dim>(1.0, x0, system, costFunction, linearSystem);
+}
+
+NLOptConSolver<state_dim, control_dim>::Policy_t createInitialGuess(const NLOptConSettings& settings,
+    const StateVector<state_dim>& x0)
+{
+    size_t K = settings.computeK(1.0);
+    return NLOptConSolver<state_dim, control_dim>::Policy_t(StateVectorArray<state_dim>(K + 1, x0),
+        ControlVectorArray<control_dim>(K, ControlVector<control_dim>::Zero()),
+        FeedbackArray<state_dim, control_dim>(K, FeedbackMatrix<state_dim, control_dim>::Zero()), settings.dt);
+}
+
+NLOptConSettings createSettings(NLOptConSettings::NLOCP_ALGORITHM algorithm,
+    LineSearchSettings::TYPE lineSearch,
+    int nThreads)
+{
+    NLOptConSettings settings;
+    settings.nlocp_algorithm = algorithm;
+    settings.lineSearchSettings.type = lineSearch;
+    settings.lineSearchSettings.maxIterations = 10;
+    settings.dt = 0.01;
+    settings.integrator = ct::core::IntegrationType::RK4;
+    settings.discretization = NLOptConSettings::APPROXIMATION::FORWARD_EULER;
+    settings.nThreads = nThreads;
+    settings.nThreadsEigen = 1;
+    settings.printSummary = false;
+    return settings;
+}
+
+TEST(AllocationTest, trackerTest)
+{
+    ASSERT_TRUE(AllocationTracker::enabled());
+
+    AllocationTracker::Region region;
+    std::unique_ptr<std::vector<double>> v(new std::vector<double>(100, 1.0));
+    ASSERT_GE(region.count(), 2u);
+
+    region.reset();
+    ASSERT_EQ(region.count(), 0u);
+}
+
+TEST(AllocationTest, nlocIterationTest)
+{
+    StateVector<state_dim> x0;
+    x0 << 1.0, 0.5;
+
+    for (int algorithm = 0; algorithm < NLOptConSettings::NLOCP_ALGORITHM::NUM_TYPES; algorithm++)
+        for (auto lineSearch : {LineSearchSettings::TYPE::NONE, LineSearchSettings::TYPE::SIMPLE})
+            for (int nThreads : {1, 2})
+            {
+                NLOptConSettings settings =
+                    createSettings(static_cast<NLOptConSettings::NLOCP_ALGORITHM>(algorithm), lineSearch, nThreads);
+
+                NLOptConSolver<state_dim, control_dim> solver(createProblem(x0), settings);
+                solver.setInitialGuess(createInitialGuess(settings, x0));
+
+                // the first iteration allocates the substep storage
+                solver.runIteration();
+
+                AllocationTracker::Region region;
+                for (int i = 0; i < 3; i++)
+                    solver.runIteration();
+                const size_t allocations = region.count();
+
+                ASSERT_EQ(allocations, 0u) << "algorithm " << algorithm << ", line search "
+                                           << static_cast<int>(lineSearch) << ", threads " << nThreads;
+            }
+}
+
+TEST(AllocationTest, mpcIterationTest)
+{
+    StateVector<state_dim> x0;
+    x0 << 1.0, 0.5;
+
+    NLOptConSettings settings =
+        createSettings(NLOptConSettings::NLOCP_ALGORITHM::GNMS, LineSearchSettings::TYPE::NONE, 1);
+    settings.max_iterations = 1;
+
+    mpc_settings mpcSettings;
+    mpcSettings.stateForwardIntegration_ = true;
+    mpcSettings.stateForwardIntegratorType_ = ct::core::IntegrationType::RK4;
+    mpcSettings.stateForwardIntegration_dt_ = settings.dt;
+    mpcSettings.postTruncation_ = false;
+    mpcSettings.measureDelay_ = false;
+    mpcSettings.fixedDelayUs_ = 20000;
+    mpcSettings.mpc_mode = MPC_MODE::CONSTANT_RECEDING_HORIZON;
+    mpcSettings.coldStart_ = false;
+    mpcSettings.useExternalTiming_ = true;
+
+    MPC<NLOptConSolver<state_dim, control_dim>> mpc(createProblem(x0), settings, mpcSettings);
+    mpc.setInitialGuess(createInitialGuess(settings, x0));
+
+    NLOptConSolver<state_dim, control_dim>::Policy_t newPolicy;
+    double newPolicyTs;
+
+    mpc.prepareIteration(0.0);
+
+    for (int i = 0; i < 10; i++)
+    {
+        const double t = 0.02 * i;
+
+        // warm up during the first cycles, the feedback storage is only allocated once
+        AllocationTracker::Region region;
+        mpc.finishIteration(x0, t, newPolicy, newPolicyTs);
+        mpc.prepareIteration(t);
+        const size_t allocations = region.count();
+
+        if (i >= 3)
+        {
+            ASSERT_EQ(allocations, 0u) << "MPC cycle " << i;
+        }
+
+        x0 = newPolicy.getReferenceStateTrajectory().front();
+    }
+}
+
+TEST(AllocationTest, binaryLogTest)
+{
+    StateVector<state_dim> x0;
+    x0 << 1.0, 0.5;
+
+    const std::string fileName = "/tmp/AllocationTest_binaryLog.ctlog";
+
+    NLOptConSettings settings =
+        createSettings(NLOptConSettings::NLOCP_ALGORITHM::GNMS, LineSearchSettings::TYPE::SIMPLE, 1);
+
+    {
+        std::shared_ptr<BinaryLogWriter> log(new BinaryLogWriter(fileName));
+
+        NLOptConSolver<state_dim, control_dim> solver(createProblem(x0), settings);
+        solver.setInitialGuess(createInitialGuess(settings, x0));
+        solver.setBinaryLog(log);
+        solver.runIteration();
+
+        // logging every iteration does not allocate memory
+        AllocationTracker::Region region;
+        for (int i = 0; i < 3; i++)
+            solver.runIteration();
+        ASSERT_EQ(region.count(), 0u);
+        ASSERT_EQ(log->droppedRecords(), 0u);
+    }
+
+    BinaryLogReader reader(fileName);
+    ASSERT_EQ(reader.records().size(), 4u * 5u);
+
+    std::vector<BinaryLogReader::Record> summaries = reader.records("nloc/summary");
+    ASSERT_EQ(summaries.size(), 4u);
+    for (size_t i = 0; i < summaries.size(); i++)
+    {
+        Eigen::VectorXd summary;
+        reader.read(summaries[i], summary);
+        ASSERT_EQ(summary.size(), 13);
+        ASSERT_EQ(summary(0), double(i));
+        ASSERT_EQ(summaries[i].header.stamp, double(i));
+    }
+
+    StateVectorArray<state_dim> x;
+    reader.read(reader.records("nloc/x").back(), x);
+    ASSERT_EQ(x.size(), settings.computeK(1.0) + 1);
+    ASSERT_TRUE(x.front().isApprox(x0));
+
+    std::remove(fileName.c_str());
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
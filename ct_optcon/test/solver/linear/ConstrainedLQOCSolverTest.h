@@ -753,3 +753,212 @@ TEST(ConstrainedLQOCSolverTest, BoxConstraintUsingConstraintToolbox)
     if (verbose)
         printSolution<state_dim, control_dim>(xSol_hpipm, uSol_hpipm, KSol_hpipm);
 }
+
+
+TEST(ConstrainedLQOCSolverTest, WarmStartTest)
+{
+    const size_t state_dim = 8;
+    const size_t control_dim = 3;
+    const size_t N = 10;
+    const double dt = 0.5;
+
+    ct::core::ControlVector<control_dim> u0;
+    u0.setConstant(0.1);
+    ct::core::StateVector<state_dim> x0;
+    x0.setZero();
+    ct::core::StateVector<state_dim> xf;
+    xf.setConstant(1.0);
+
+    // input box constraints which become active
+    int nb_u = control_dim;
+    Eigen::VectorXd u_lb(nb_u);
+    Eigen::VectorXd u_ub(nb_u);
+    u_lb.setConstant(-0.3);
+    u_ub.setConstant(0.3);
+    Eigen::VectorXi u_box_sparsity(nb_u);
+    u_box_sparsity << 0, 1, 2;
+
+    std::shared_ptr<HPIPMInterface<state_dim, control_dim>> hpipmSolver(new HPIPMInterface<state_dim, control_dim>);
+
+    NLOptConSettings nloc_settings;
+    nloc_settings.lqoc_solver_settings.num_lqoc_iterations = 50;
+    nloc_settings.lqoc_solver_settings.warm_start = LQOCSolverSettings::PRIMAL_DUAL;
+    nloc_settings.lqoc_solver_settings.num_lqoc_iterations_warm_start = 20;
+    nloc_settings.lqoc_solver_settings.lqoc_debug_print = verbose;
+    hpipmSolver->configure(nloc_settings);
+
+    std::shared_ptr<LQOCProblem<state_dim, control_dim>> lqocProblem(new LQOCProblem<state_dim, control_dim>(N));
+
+    std::shared_ptr<core::LinearSystem<state_dim, control_dim>> exampleSystem(new LinkedMasses());
+    core::SensitivityApproximation<state_dim, control_dim> discreteExampleSystem(
+        dt, exampleSystem, core::SensitivityApproximationSettings::APPROXIMATION::MATRIX_EXPONENTIAL);
+
+    StateMatrix<state_dim> Q;
+    Q.setIdentity();
+    ControlMatrix<control_dim> R;
+    R.setIdentity();
+    std::shared_ptr<CostFunctionQuadratic<state_dim, control_dim>> costFunction(
+        new CostFunctionQuadraticSimple<state_dim, control_dim>(Q, R, xf, u0, xf, 10.0 * Q));
+
+    ct::core::ControlVectorArray<control_dim> u_nom(N, u0);
+
+    lqocProblem->setFromTimeInvariantLinearQuadraticProblem(discreteExampleSystem, *costFunction, x0, dt);
+    lqocProblem->setInputBoxConstraints(nb_u, u_lb, u_ub, u_box_sparsity, u_nom);
+
+    hpipmSolver->configureInputBoxConstraints(lqocProblem);
+    hpipmSolver->setProblem(lqocProblem);
+    hpipmSolver->initializeAndAllocate();
+
+    // the first solve starts cold
+    hpipmSolver->solve();
+    hpipmSolver->computeStatesAndControls();
+    const int coldIterations = hpipmSolver->getNumIterations();
+    ct::core::ControlVectorArray<control_dim> uCold = hpipmSolver->getSolutionControl();
+    assertControlBounds<state_dim, control_dim>(uCold, u_box_sparsity, u_lb, u_ub);
+
+    // re-solving the same problem from the previous iterate converges faster to the same solution
+    hpipmSolver->setProblem(lqocProblem);
+    hpipmSolver->solve();
+    hpipmSolver->computeStatesAndControls();
+    ASSERT_LT(hpipmSolver->getNumIterations(), coldIterations);
+    for (size_t i = 0; i < N; i++)
+        ASSERT_LT((hpipmSolver->getSolutionControl()[i] - uCold[i]).norm(), 1e-6);
+
+    // a shifted warm start still yields the same solution
+    hpipmSolver->shiftWarmStart(1);
+    hpipmSolver->setProblem(lqocProblem);
+    hpipmSolver->solve();
+    hpipmSolver->computeStatesAndControls();
+    for (size_t i = 0; i < N; i++)
+        ASSERT_LT((hpipmSolver->getSolutionControl()[i] - uCold[i]).norm(), 1e-6);
+}
+
+
+/*!
+ * solve two consecutive NLOC problems with input box constraints, which differ in the initial state only, as it
+ * happens between two MPC cycles. Returns the solution of the second problem and the number of HPIPM iterations
+ * spent on it.
+ */
+int solveConsecutiveNLOCProblems(const LQOCSolverSettings::WARM_START warmStart,
+    ct::core::StateVectorArray<8>& xSol,
+    ct::core::ControlVectorArray<3>& uSol)
+{
+    const size_t state_dim = 8;
+    const size_t control_dim = 3;
+    const double timeHorizon = 5.0;
+
+    ct::core::StateVector<state_dim> x0;
+    x0.setZero();
+    ct::core::StateVector<state_dim> xf;
+    xf.setConstant(1.0);
+
+    std::shared_ptr<core::LinearSystem<state_dim, control_dim>> system(new LinkedMasses());
+
+    StateMatrix<state_dim> Q;
+    Q.setIdentity();
+    ControlMatrix<control_dim> R;
+    R.setIdentity();
+    std::shared_ptr<CostFunctionQuadratic<state_dim, control_dim>> costFunction(
+        new CostFunctionQuadraticSimple<state_dim, control_dim>(
+            Q, R, xf, ControlVector<control_dim>::Zero(), xf, 10.0 * Q));
+
+    // input box constraints which become active
+    Eigen::VectorXd u_lb(control_dim);
+    Eigen::VectorXd u_ub(control_dim);
+    u_lb.setConstant(-0.3);
+    u_ub.setConstant(0.3);
+    Eigen::VectorXi u_box_sparsity(control_dim);
+    u_box_sparsity << 1, 1, 1;
+
+    std::shared_ptr<ConstraintContainerAnalytical<state_dim, control_dim>> boxConstraints(
+        new ConstraintContainerAnalytical<state_dim, control_dim>());
+    std::shared_ptr<ControlInputConstraint<state_dim, control_dim>> controlConstraint(
+        new ControlInputConstraint<state_dim, control_dim>(u_lb, u_ub, u_box_sparsity));
+    boxConstraints->addIntermediateConstraint(controlConstraint, verbose);
+    boxConstraints->initialize();
+
+    ContinuousOptConProblem<state_dim, control_dim> optConProblem(timeHorizon, x0, system, costFunction, system);
+    optConProblem.setInputBoxConstraints(boxConstraints);
+
+    NLOptConSettings nloc_settings;
+    nloc_settings.dt = 0.1;
+    nloc_settings.integrator = ct::core::IntegrationType::RK4;
+    nloc_settings.discretization = NLOptConSettings::APPROXIMATION::MATRIX_EXPONENTIAL;
+    nloc_settings.nlocp_algorithm = NLOptConSettings::NLOCP_ALGORITHM::GNMS;
+    nloc_settings.lqocp_solver = NLOptConSettings::LQOCP_SOLVER::HPIPM_SOLVER;
+    nloc_settings.max_iterations = 1;  // one LQ solve per problem, as in real-time iteration MPC
+    nloc_settings.nThreads = 1;
+    nloc_settings.printSummary = false;
+    nloc_settings.lineSearchSettings.type = LineSearchSettings::TYPE::NONE;
+    nloc_settings.lqoc_solver_settings.num_lqoc_iterations = 100;
+    nloc_settings.lqoc_solver_settings.warm_start = warmStart;
+    // allow a warm-started solve as many iterations as a cold one, such that it never falls back to a cold start
+    nloc_settings.lqoc_solver_settings.num_lqoc_iterations_warm_start = 100;
+    nloc_settings.lqoc_solver_settings.tol_stat = 1e-10;
+    nloc_settings.lqoc_solver_settings.tol_eq = 1e-10;
+    nloc_settings.lqoc_solver_settings.tol_ineq = 1e-10;
+    nloc_settings.lqoc_solver_settings.tol_comp = 1e-10;
+
+    size_t K = nloc_settings.computeK(timeHorizon);
+    NLOptConSolver<state_dim, control_dim>::Policy_t initController(StateVectorArray<state_dim>(K + 1, x0),
+        ControlVectorArray<control_dim>(K, ControlVector<control_dim>::Zero()),
+        FeedbackArray<state_dim, control_dim>(K, FeedbackMatrix<state_dim, control_dim>::Zero()), nloc_settings.dt);
+
+    NLOptConSolver<state_dim, control_dim> nloc(optConProblem, nloc_settings);
+    std::shared_ptr<HPIPMInterface<state_dim, control_dim>> hpipm =
+        std::dynamic_pointer_cast<HPIPMInterface<state_dim, control_dim>>(nloc.getBackend()->getLQOCSolver());
+    if (!hpipm)
+        throw std::runtime_error("NLOC does not use HPIPM");
+
+    nloc.setInitialGuess(initController);
+    nloc.solve();
+
+    // the second problem starts from a slightly perturbed initial state
+    ct::core::StateVector<state_dim> x0_perturbed = x0;
+    x0_perturbed(0) = 0.05;
+    nloc.changeInitialState(x0_perturbed);
+    nloc.setInitialGuess(initController);
+    nloc.solve();
+
+    xSol = nloc.getSolution().x_ref();
+    uSol = nloc.getSolution().uff();
+
+    return hpipm->getNumIterations();
+}
+
+
+TEST(ConstrainedLQOCSolverTest, NLOCWarmStartTest)
+{
+    ct::core::StateVectorArray<8> xCold;
+    ct::core::ControlVectorArray<3> uCold;
+    const int coldIterations = solveConsecutiveNLOCProblems(LQOCSolverSettings::COLD, xCold, uCold);
+
+    Eigen::VectorXi u_box_sparsity(3);
+    u_box_sparsity << 0, 1, 2;
+    assertControlBounds<8, 3>(
+        uCold, u_box_sparsity, Eigen::VectorXd::Constant(3, -0.3), Eigen::VectorXd::Constant(3, 0.3));
+
+    for (auto warmStart : {LQOCSolverSettings::PRIMAL, LQOCSolverSettings::PRIMAL_DUAL})
+    {
+        ct::core::StateVectorArray<8> xWarm;
+        ct::core::ControlVectorArray<3> uWarm;
+        const int warmIterations = solveConsecutiveNLOCProblems(warmStart, xWarm, uWarm);
+
+        if (verbose)
+            std::cout << "HPIPM iterations cold: " << coldIterations << ", warm: " << warmIterations << std::endl;
+
+        // warm starting changes the path of the interior-point solver, but not the solution
+        ASSERT_EQ(xCold.size(), xWarm.size());
+        ASSERT_EQ(uCold.size(), uWarm.size());
+        for (size_t i = 0; i < uCold.size(); i++)
+            ASSERT_LT((uWarm[i] - uCold[i]).norm(), 1e-6);
+        for (size_t i = 0; i < xCold.size(); i++)
+            ASSERT_LT((xWarm[i] - xCold[i]).norm(), 1e-6);
+
+        // starting from the primal-dual iterate of the previous problem saves interior-point iterations
+        if (warmStart == LQOCSolverSettings::PRIMAL_DUAL)
+        {
+            ASSERT_LT(warmIterations, coldIterations);
+        }
+    }
+}
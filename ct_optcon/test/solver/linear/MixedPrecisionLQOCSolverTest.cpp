@@ -0,0 +1,275 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <gtest/gtest.h>
+#include <ct/optcon/optcon.h>
+
+#include "../../testSystems/LinearOscillator.h"
+
+using namespace ct::core;
+using namespace ct::optcon;
+
+const size_t STATE_DIM = 4;
+const size_t CONTROL_DIM = 2;
+
+//! a random, unconstrained LQ problem with a long horizon in single precision
+void createProblem(LQOCProblem<STATE_DIM, CONTROL_DIM, float>& problem, int N)
+{
+    problem.changeNumStages(N);
+    problem.setZero();
+
+    for (int k = 0; k < N; k++)
+    {
+        problem.A_[k] = StateMatrix<STATE_DIM, float>::Identity() + 0.01f * StateMatrix<STATE_DIM, float>::Random();
+        problem.B_[k] = 0.01f * StateControlMatrix<STATE_DIM, CONTROL_DIM, float>::Random();
+        problem.b_[k] = 0.01f * StateVector<STATE_DIM, float>::Random();
+        problem.Q_[k] = 0.01f * StateMatrix<STATE_DIM, float>::Identity();
+        problem.qv_[k] = 0.01f * StateVector<STATE_DIM, float>::Random();
+        problem.R_[k] = 0.01f * ControlMatrix<CONTROL_DIM, float>::Identity();
+        problem.rv_[k] = 0.01f * ControlVector<CONTROL_DIM, float>::Random();
+    }
+    problem.Q_[N] = 100.0f * StateMatrix<STATE_DIM, float>::Identity();
+    problem.qv_[N] = StateVector<STATE_DIM, float>::Random();
+}
+
+//! the exact double precision representation of a single precision problem
+void convertProblem(const LQOCProblem<STATE_DIM, CONTROL_DIM, float>& problem,
+    LQOCProblem<STATE_DIM, CONTROL_DIM>& problemDouble,
+    int N)
+{
+    problemDouble.changeNumStages(N);
+    problemDouble.setZero();
+
+    for (int k = 0; k < N; k++)
+    {
+        problemDouble.A_[k] = problem.A_[k].cast<double>();
+        problemDouble.B_[k] = problem.B_[k].cast<double>();
+        problemDouble.b_[k] = problem.b_[k].cast<double>();
+        problemDouble.Q_[k] = problem.Q_[k].cast<double>();
+        problemDouble.qv_[k] = problem.qv_[k].cast<double>();
+        problemDouble.R_[k] = problem.R_[k].cast<double>();
+        problemDouble.rv_[k] = problem.rv_[k].cast<double>();
+    }
+    problemDouble.Q_[N] = problem.Q_[N].cast<double>();
+    problemDouble.qv_[N] = problem.qv_[N].cast<double>();
+}
+
+//! maximum relative difference between two control trajectories
+template <typename SCALAR>
+double relativeError(const ControlVectorArray<CONTROL_DIM, SCALAR>& u, const ControlVectorArray<CONTROL_DIM>& u_ref)
+{
+    double error = 0.0;
+    for (size_t k = 0; k < u_ref.size(); k++)
+        error = std::max(error, (u[k].template cast<double>() - u_ref[k]).norm() / u_ref[k].norm());
+    return error;
+}
+
+TEST(MixedPrecisionLQOCSolverTest, compareToDoublePrecision)
+{
+    const int N = 500;
+
+    // the problem in single precision, and its exact counterpart in double precision
+    std::shared_ptr<LQOCProblem<STATE_DIM, CONTROL_DIM, float>> problem(new LQOCProblem<STATE_DIM, CONTROL_DIM, float>);
+    createProblem(*problem, N);
+    std::shared_ptr<LQOCProblem<STATE_DIM, CONTROL_DIM>> problemDouble(new LQOCProblem<STATE_DIM, CONTROL_DIM>);
+    convertProblem(*problem, *problemDouble, N);
+
+    MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, float, double> mixedSolver;
+    mixedSolver.setProblem(problem);
+
+    NLOptConSettings settings;
+    settings.epsilon = 0.0;
+
+    GNRiccatiSolver<STATE_DIM, CONTROL_DIM, double> doubleSolver;
+    doubleSolver.setProblem(problemDouble);
+    doubleSolver.configure(settings);
+    doubleSolver.solve();
+    doubleSolver.computeStatesAndControls();
+
+    // the converted problem is exact, the solutions only differ by the final cast
+    mixedSolver.configure(settings);
+    mixedSolver.solve();
+    mixedSolver.computeStatesAndControls();
+    mixedSolver.computeFeedbackMatrices();
+    mixedSolver.compute_lv();
+
+    ASSERT_TRUE(mixedSolver.getSolverProblem().Q_[N] == problemDouble->Q_[N]);
+    ASSERT_EQ(mixedSolver.getSolutionState().size(), size_t(N + 1));
+    ASSERT_EQ(mixedSolver.getSolutionFeedback().size(), size_t(N));
+    ASSERT_LT(relativeError(mixedSolver.getSolutionControl(), doubleSolver.getSolutionControl()), 1e-6);
+    for (int k = 0; k < N; k++)
+    {
+        ASSERT_TRUE(mixedSolver.getSolutionFeedback()[k].isApprox(
+            doubleSolver.getSolutionFeedback()[k].cast<float>(), 1e-6f));
+        ASSERT_TRUE(mixedSolver.get_lv()[k].isApprox(doubleSolver.get_lv()[k].cast<float>(), 1e-6f));
+    }
+
+    // solving stage by stage gives the same result
+    MixedPrecisionLQOCSolver<STATE_DIM, CONTROL_DIM, float, double> stageSolver;
+    stageSolver.setProblem(problem);
+    stageSolver.configure(settings);
+    for (int k = N - 1; k >= 0; k--)
+        stageSolver.solveSingleStage(k);
+    stageSolver.computeStatesAndControls();
+    ASSERT_EQ(relativeError(stageSolver.getSolutionControl(), doubleSolver.getSolutionControl()),
+        relativeError(mixedSolver.getSolutionControl(), doubleSolver.getSolutionControl()));
+
+    // a constrained problem is rejected
+    ControlVectorArray<CONTROL_DIM, float> u_nom(N, ControlVector<CONTROL_DIM, float>::Zero());
+    problem->setInputBoxConstraints(
+        1, Eigen::VectorXf::Constant(1, -1.0f), Eigen::VectorXf::Constant(1, 1.0f), Eigen::VectorXi::Zero(1), u_nom);
+    ASSERT_ANY_THROW(stageSolver.setProblem(problem));
+}
+
+//! solves the linear oscillator problem with GNMS and returns the state trajectory
+template <typename S>
+StateVectorArray<example::state_dim, S> solveOscillator(bool doublePrecisionLQSolver)
+{
+    using namespace ct::optcon::example;
+    typedef NLOptConSolver<state_dim, control_dim, state_dim / 2, state_dim / 2, S> Solver;
+
+    StateVector<state_dim, S> x0 = StateVector<state_dim, S>::Zero();
+    StateVector<state_dim, S> xf;
+    xf << 20, 0;
+    Eigen::Matrix<S, state_dim, state_dim> Q;
+    Q << 0, 0, 0, 1;
+    Eigen::Matrix<S, control_dim, control_dim> R;
+    R << 100;
+    Eigen::Matrix<S, state_dim, state_dim> Qf;
+    Qf << 1000, 0, 0, 1000;
+
+    std::shared_ptr<TermQuadratic<state_dim, control_dim, S>> intermediateCost(
+        new TermQuadratic<state_dim, control_dim, S>(
+            Q, R, StateVector<state_dim, S>::Zero(), ControlVector<control_dim, S>::Zero()));
+    std::shared_ptr<TermQuadratic<state_dim, control_dim, S>> finalCost(
+        new TermQuadratic<state_dim, control_dim, S>(Qf, R, xf, ControlVector<control_dim, S>::Zero()));
+    std::shared_ptr<CostFunctionAnalytical<state_dim, control_dim, S>> costFunction(
+        new CostFunctionAnalytical<state_dim, control_dim, S>);
+    costFunction->addIntermediateTerm(intermediateCost);
+    costFunction->addFinalTerm(finalCost);
+
+    std::shared_ptr<ControlledSystem<state_dim, control_dim, S>> system(new example::tpl::LinearOscillator<S>());
+    std::shared_ptr<LinearSystem<state_dim, control_dim, S>> linearSystem(
+        new example::tpl::LinearOscillatorLinear<S>());
+    ContinuousOptConProblem<state_dim, control_dim, S> problem(S(1.0), x0, system, costFunction, linearSystem);
+
+    NLOptConSettings settings;
+    settings.dt = 0.01;
+    settings.nThreads = 1;
+    settings.printSummary = false;
+    settings.doublePrecisionLQSolver = doublePrecisionLQSolver;
+
+    Solver solver(problem, settings);
+
+    size_t K = settings.computeK(1.0);
+    typename Solver::Policy_t initGuess(StateVectorArray<state_dim, S>(K + 1, x0),
+        ControlVectorArray<control_dim, S>(K, ControlVector<control_dim, S>::Zero()),
+        FeedbackArray<state_dim, control_dim, S>(K, FeedbackMatrix<state_dim, control_dim, S>::Zero()), S(settings.dt));
+    solver.setInitialGuess(initGuess);
+
+    for (int i = 0; i < 3; i++)
+        solver.runIteration();
+
+    return solver.getSolution().getReferenceStateTrajectory().getDataArray();
+}
+
+TEST(MixedPrecisionLQOCSolverTest, nlocTest)
+{
+    using namespace ct::optcon::example;
+
+    // float rollouts combined with a double precision Riccati solver
+    StateVectorArray<state_dim, float> x_mixed = solveOscillator<float>(true);
+    StateVectorArray<state_dim> x_ref = solveOscillator<double>(false);
+
+    ASSERT_EQ(x_mixed.size(), x_ref.size());
+    for (size_t k = 0; k < x_ref.size(); k++)
+        ASSERT_LT((x_mixed[k].cast<double>() - x_ref[k]).norm(), 1e-3 * (1.0 + x_ref[k].norm()));
+}
+
+//! exposes the cost and merit computations of the backend
+template <typename S>
+class MeritBackend : public NLOCBackendBase<example::state_dim, example::control_dim, 1, 1, S, true>
+{
+public:
+    typedef NLOCBackendBase<example::state_dim, example::control_dim, 1, 1, S, true> Base;
+
+    MeritBackend(const typename Base::OptConProblem_t& problem, const NLOptConSettings& settings)
+        : Base(problem, settings)
+    {
+    }
+
+    void computeLQApproximation(size_t firstIndex, size_t lastIndex) override {}
+    void rolloutShots(size_t firstIndex, size_t lastIndex) override {}
+    S performLineSearch() override { return S(0.0); }
+    using Base::computeCostsOfTrajectory;
+    using Base::acceptStep;
+};
+
+TEST(MixedPrecisionLQOCSolverTest, meritInDoubleTest)
+{
+    using namespace ct::optcon::example;
+    typedef MeritBackend<float> Backend;
+    static_assert(std::is_same<Backend::merit_t, double>::value, "the merit of float problems is carried in double");
+
+    std::shared_ptr<TermQuadratic<state_dim, control_dim, float>> term(new TermQuadratic<state_dim, control_dim, float>(
+        Eigen::Matrix2f::Identity(), Eigen::Matrix<float, 1, 1>::Identity(), StateVector<state_dim, float>::Zero(),
+        ControlVector<control_dim, float>::Zero()));
+    std::shared_ptr<CostFunctionAnalytical<state_dim, control_dim, float>> costFunction(
+        new CostFunctionAnalytical<state_dim, control_dim, float>);
+    costFunction->addIntermediateTerm(term);
+    costFunction->addFinalTerm(term);
+
+    std::shared_ptr<ControlledSystem<state_dim, control_dim, float>> system(
+        new example::tpl::LinearOscillator<float>());
+    std::shared_ptr<LinearSystem<state_dim, control_dim, float>> linearSystem(
+        new example::tpl::LinearOscillatorLinear<float>());
+
+    // a long horizon, such that a float sum of the stage costs accumulates a noticeable rounding error
+    const float T = 100.0f;
+    ContinuousOptConProblem<state_dim, control_dim, float> problem(T, StateVector<state_dim, float>::Zero(), system,
+        costFunction, linearSystem);
+
+    NLOptConSettings settings;
+    settings.dt = 0.01;
+    settings.nThreads = 1;
+    settings.printSummary = false;
+    settings.lineSearchSettings.type = LineSearchSettings::TYPE::SIMPLE;
+    Backend backend(problem, settings);
+
+    const size_t K = settings.computeK(T);
+    StateVectorArray<state_dim, float> x(K + 1);
+    ControlVectorArray<control_dim, float> u(K);
+    double reference = 0.0;
+    float floatSum = 0.0f;
+    for (size_t k = 0; k < K; k++)
+    {
+        x[k].setRandom();
+        u[k].setRandom();
+        costFunction->setCurrentStateAndControl(x[k], u[k], settings.dt * k);
+        reference += costFunction->evaluateIntermediate();
+        floatSum += costFunction->evaluateIntermediate();
+    }
+    x[K].setRandom();
+    reference *= settings.dt;
+
+    double intermediateCost, finalCost;
+    backend.computeCostsOfTrajectory(settings.nThreads, x, u, intermediateCost, finalCost);
+    ASSERT_NEAR(intermediateCost, reference, 1e-12 * reference);
+    ASSERT_GT(std::abs(floatSum * settings.dt - reference), 1e-9 * reference);
+
+    // an improvement below the float resolution of the merit is accepted
+    const double previousMerit = 1e6 + 1.0;
+    double merit;
+    ASSERT_EQ(float(1e6 + 0.999), float(previousMerit));
+    ASSERT_TRUE(backend.acceptStep(1.0f, 0.999, 1e6, 0.0, 0.0, 0.0, previousMerit, merit));
+    ASSERT_EQ(merit, 1e6 + 0.999);
+    ASSERT_FALSE(backend.acceptStep(1.0f, 1.001, 1e6, 0.0, 0.0, 0.0, previousMerit, merit));
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,52 @@
+# Generates and compiles the code-generated kernels of a RobCoGen robot, see ct/rbd/robot/codegen/RBDCodegen.h
+#
+# ct_rbd_add_codegen(<robot>
+#     GENERATOR <source>            source of the generator executable, which calls RBDCodegen::run()
+#     OUTPUT_DIR <dir>              directory the kernels are generated to
+#     KERNELS <kernel> [...]        kernels to generate, e.g. ForwardZero LinearizedForward
+#     [INCLUDE_DIRS <dir> [...]]    additional include directories of the generator
+#     [LINK_LIBRARIES <lib> [...]]  additional libraries of the generator)
+#
+# Creates the generator executable <robot>Codegen and the library <robot>Kernels, which contains the generated
+# kernels and whose name is returned in <robot>_CODEGEN_LIBRARY. The generator runs whenever it was rebuilt, but only
+# regenerates kernels if the fingerprint of the robot model changed. Remove the stamp file <robot>Codegen.stamp in
+# the binary directory to force a run, e.g. after deleting kernels.
+include(CMakeParseArguments)
+
+function(ct_rbd_add_codegen ROBOT)
+    cmake_parse_arguments(CODEGEN "" "GENERATOR;OUTPUT_DIR" "KERNELS;INCLUDE_DIRS;LINK_LIBRARIES" ${ARGN})
+
+    if(NOT CODEGEN_GENERATOR OR NOT CODEGEN_OUTPUT_DIR OR NOT CODEGEN_KERNELS)
+        message(FATAL_ERROR "ct_rbd_add_codegen: GENERATOR, OUTPUT_DIR and KERNELS are required.")
+    endif()
+
+    add_executable(${ROBOT}Codegen ${CODEGEN_GENERATOR})
+    target_include_directories(${ROBOT}Codegen PUBLIC ${CODEGEN_INCLUDE_DIRS})
+    target_link_libraries(${ROBOT}Codegen ct_rbd ${CODEGEN_LINK_LIBRARIES})
+
+    set(_sources "")
+    set(_headers "")
+    foreach(_kernel ${CODEGEN_KERNELS})
+        list(APPEND _sources ${CODEGEN_OUTPUT_DIR}/${ROBOT}${_kernel}.cpp)
+        list(APPEND _headers ${CODEGEN_OUTPUT_DIR}/${ROBOT}${_kernel}.h)
+    endforeach()
+
+    # the kernels are only rewritten if they are outdated, hence the stamp is the output which tracks when the
+    # generator last ran and the kernels are byproducts, such that the command does not rerun on every build
+    set(_stamp ${CMAKE_CURRENT_BINARY_DIR}/${ROBOT}Codegen.stamp)
+    add_custom_command(
+        OUTPUT ${_stamp}
+        BYPRODUCTS ${_sources} ${_headers}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${CODEGEN_OUTPUT_DIR}
+        COMMAND ${ROBOT}Codegen ${CODEGEN_OUTPUT_DIR} ${CODEGEN_KERNELS}
+        COMMAND ${CMAKE_COMMAND} -E touch ${_stamp}
+        DEPENDS ${ROBOT}Codegen
+        COMMENT "Generating kernels of ${ROBOT}"
+        VERBATIM)
+
+    add_library(${ROBOT}Kernels ${_sources} ${_headers} ${_stamp})
+    target_include_directories(${ROBOT}Kernels PUBLIC $<BUILD_INTERFACE:${CODEGEN_OUTPUT_DIR}>)
+    target_link_libraries(${ROBOT}Kernels ct_rbd)
+
+    set(${ROBOT}_CODEGEN_LIBRARY ${ROBOT}Kernels PARENT_SCOPE)
+endfunction()
@@ -4,6 +4,9 @@ find_package(ct_optcon REQUIRED)
 
 include(${CMAKE_CURRENT_LIST_DIR}/ct_rbd_export.cmake)
 
+# function for generating the kernels of RobCoGen robots
+include(${CMAKE_CURRENT_LIST_DIR}/ct_rbdCodegen.cmake)
+
 #define includes in legacy mode
 get_target_property(ct_rbd_INCLUDE_DIRS ct_rbd INTERFACE_INCLUDE_DIRECTORIES)
 
@@ -6,6 +6,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #pragma once
 
 #include <ct/rbd/state/RBDState.h>
+#include <ct/rbd/physics/TerrainHeightMap.h>
 
 #pragma GCC diagnostic push  // include IIT headers and disable warnings
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -27,15 +28,19 @@ namespace rbd {
  *
  * \f[ {}_W \lambda = f(q, \dot{q}) \f]
  *
- * The contact model assumes a plane with fixed orientation located at the origin (0, 0, 0). The contact dynamics
- * are a combination of a spring-damper perpendicular and a damper in parallel to the surface. The force expressed
- * in world coordinates without velocity smoothing or normal force smoothing is defined as
+ * By default, the contact model assumes a plane with fixed orientation located at the origin (0, 0, 0). The contact
+ * dynamics are a combination of a spring-damper perpendicular and a damper in parallel to the surface. The force
+ * expressed in world coordinates without velocity smoothing or normal force smoothing is defined as
  *
  * \f[ {}_W \lambda = f(q, \dot{q}) = - k ({}_W x_z - z_{offset}) - d {}_W \dot{x}  \f]
  *
  * where \f$ {}_W x_z \f$ is the ground penetration with respect to an offset \f$ z_{offset} \f$ expressed in world
  * coordinates and \f$ \dot{x} \f$ is the velocity of the endeffector.
  *
+ * Uneven terrain can be modelled by setting a TerrainHeightMap (see setTerrain()). The penetration \f$ {}_W x_z \f$
+ * is then replaced by the distance to the terrain along its normal \f$ n \f$, i.e.
+ * \f$ ({}_W x_z - h({}_W x_x, {}_W x_y)) n_z \f$, and the normal spring acts along \f$ n \f$.
+ *
  * In case normal force smoothing is activated, the first term becomes
  *
  * \f[ {}_W \lambda_n =  k e^{-\alpha_n {}_W x_z} \f]
@@ -76,6 +81,8 @@ public:
     typedef kindr::Position<SCALAR, 3> Position3S;
     typedef kindr::Velocity<SCALAR, 3> Velocity3S;
 
+    typedef TerrainHeightMap Terrain;
+
 
     /*!
 	 * \brief the type of velcity smoothing
@@ -129,7 +136,8 @@ public:
           alpha_(other.alpha_),
           alpha_n_(other.alpha_n_),
           zOffset_(other.zOffset_),
-          EEactive_(other.EEactive_)
+          EEactive_(other.EEactive_),
+          terrain_(other.terrain_)
     {
     }
 
@@ -139,6 +147,13 @@ public:
 	 * @param activeMap flags of active end-effectors
 	 */
     void setActiveEE(const ActiveMap& activeMap) { EEactive_ = activeMap; }
+
+    /**
+	 * \brief Sets the terrain the end-effectors are in contact with. Flat ground at height zero if not set.
+	 * @param terrain the terrain height map, shared between copies of the contact model
+	 */
+    void setTerrain(const std::shared_ptr<const Terrain>& terrain) { terrain_ = terrain; }
+    const std::shared_ptr<const Terrain>& getTerrain() const { return terrain_; }
     /**
 	 * \brief Computes the contact forces given a state of the robot. Returns forces expressed in the world frame
 	 * @param state The state of the robot
@@ -152,12 +167,13 @@ public:
         {
             if (EEactive_[i])
             {
-                Vector3s eePenetration = computePenetration(i, state.basePose(), state.jointPositions());
+                Vector3s normal;
+                SCALAR eePenetration = computePenetration(i, state.basePose(), state.jointPositions(), normal);
 
                 if (eeInContact(eePenetration))
                 {
                     Velocity3S eeVelocity = kinematics_->getEEVelocityInWorld(i, state);
-                    eeForces[i] = computeEEForce(eePenetration, eeVelocity);
+                    eeForces[i] = computeEEForce(eePenetration, normal, eeVelocity);
                 }
                 else
                 {
@@ -178,13 +194,13 @@ public:
 
 private:
     /**
-	 * \brief Checks if end-effector is in contact. Currently assumes this is the case for negative z
-	 * @param eePenetration The surface penetration of the end-effector
+	 * \brief Checks if end-effector is in contact. Currently assumes this is the case for negative penetration
+	 * @param eePenetration The surface penetration of the end-effector along the surface normal
 	 * @return flag if the end-effector is in contact
 	 */
-    bool eeInContact(const Vector3s& eePenetration)
+    bool eeInContact(const SCALAR& eePenetration)
     {
-        if (smoothing_ == NONE && eePenetration(2) > 0.0)
+        if (smoothing_ == NONE && eePenetration > 0.0)
             return false;
         else
             return true;
@@ -192,32 +208,41 @@ private:
 
 
     /**
-	 * \brief Computes the surface penetration. Currently assumes the surface is at height z = 0.
+	 * \brief Computes the surface penetration. Assumes the surface is at height z = 0 if no terrain is set.
 	 * @param eeId ID of the end-effector
 	 * @param basePose Position of the robot base
 	 * @param jointPosition Joint position of the robot
-	 * @return Penetration in world coordinates
+	 * @param normal Surface normal in world coordinates
+	 * @return Signed distance to the surface along the normal, negative if penetrating
 	 */
-    Vector3s computePenetration(const size_t& eeId,
+    SCALAR computePenetration(const size_t& eeId,
         const tpl::RigidBodyPose<SCALAR>& basePose,
-        const typename JointState<NJOINTS, SCALAR>::Position& jointPosition)
+        const typename JointState<NJOINTS, SCALAR>::Position& jointPosition,
+        Vector3s& normal)
     {
         Position3S pos = kinematics_->getEEPositionInWorld(eeId, basePose, jointPosition);
 
-        // we currently assume flat ground at height zero penetration is only z height
-        Vector3s penetration;
-        penetration << SCALAR(0.0), SCALAR(0.0), pos.z();
+        if (!terrain_)
+        {
+            normal = Vector3s::UnitZ();
+            return pos.z();
+        }
+
+        SCALAR dhdx, dhdy;
+        const SCALAR height = terrain_->getHeight(pos.x(), pos.y(), dhdx, dhdy);
+        normal = Terrain::normalFromGradient(dhdx, dhdy);
 
-        return penetration;
+        return (pos.z() - height) * normal(2);
     }
 
     /*!
 	 * \brief Compute the endeffector force based on penetration and velocity
-	 * @param eePenetration end-effector penetration
+	 * @param eePenetration end-effector penetration along the surface normal
+	 * @param normal surface normal
 	 * @param eeVelocity end-effector velocity
 	 * @return resulting force vecttor
 	 */
-    EEForceLinear computeEEForce(const Vector3s& eePenetration, const Velocity3S& eeVelocity)
+    EEForceLinear computeEEForce(const SCALAR& eePenetration, const Vector3s& normal, const Velocity3S& eeVelocity)
     {
         EEForceLinear eeForce;
 
@@ -225,7 +250,7 @@ private:
 
         smoothEEForce(eeForce, eePenetration);
 
-        computeNormalSpring(eeForce, eePenetration(2) - zOffset_, eeVelocity.toImplementation()(2));
+        computeNormalSpring(eeForce, eePenetration - zOffset_, normal);
 
         return eeForce;
     }
@@ -233,23 +258,23 @@ private:
     /*!
 	 * \brief Smoothes out the endeffector forces
 	 * @param eeForce endeffector force to modify
-	 * @param eePenetration penetration of the surface
+	 * @param eePenetration penetration of the surface along its normal
 	 */
-    void smoothEEForce(EEForceLinear& eeForce, const Vector3s& eePenetration)
+    void smoothEEForce(EEForceLinear& eeForce, const SCALAR& eePenetration)
     {
         switch (smoothing_)
         {
             case NONE:
                 return;
             case SIGMOID:
-                eeForce *= 1. / (1. + TRAIT::exp(eePenetration(2) * alpha_));
+                eeForce *= 1. / (1. + TRAIT::exp(eePenetration * alpha_));
                 return;
             case TANH:
                 // same as sigmoid, maybe cheaper / more expensive to compute?
-                eeForce *= 0.5 * TRAIT::tanh(-0.5 * eePenetration(2) * alpha_) + 0.5;
+                eeForce *= 0.5 * TRAIT::tanh(-0.5 * eePenetration * alpha_) + 0.5;
                 return;
             case ABS:
-                eeForce *= 0.5 * -eePenetration(2) * alpha_ / (1. + TRAIT::fabs(-eePenetration(2) * alpha_)) + 0.5;
+                eeForce *= 0.5 * -eePenetration * alpha_ / (1. + TRAIT::fabs(-eePenetration * alpha_)) + 0.5;
                 return;
             default:
                 throw std::runtime_error("undefined smoothing function");
@@ -262,20 +287,26 @@ private:
 	 * @param eePenetration endeffector penetration of the surface
 	 * @param eeVelocity endeffector velocity
 	 */
-    void computeDamperForce(EEForceLinear& force, const Vector3s& eePenetration, const Velocity3S& eeVelocity)
+    void computeDamperForce(EEForceLinear& force, const SCALAR& eePenetration, const Velocity3S& eeVelocity)
     {
         force = -d_ * eeVelocity.toImplementation();
     }
 
-    void computeNormalSpring(EEForceLinear& force, const SCALAR& p_N, const SCALAR& p_dot_N)
+    /*!
+	 * \brief computes the normal spring force along the surface normal
+	 * @param force force to be computed
+	 * @param p_N penetration along the surface normal
+	 * @param normal surface normal
+	 */
+    void computeNormalSpring(EEForceLinear& force, const SCALAR& p_N, const Vector3s& normal)
     {
         if (alpha_n_ > SCALAR(0))
         {
-            force(2) += k_ * TRAIT::exp(-alpha_n_ * p_N);
+            force += k_ * TRAIT::exp(-alpha_n_ * p_N) * normal;
         }
         else if (p_N <= SCALAR(0))
         {
-            force(2) -= k_ * p_N;
+            force -= k_ * p_N * normal;
         }
     }
 
@@ -293,6 +324,8 @@ private:
     SCALAR zOffset_;  //!< vertical offset of the contact pane
 
     ActiveMap EEactive_;  //!< stores which endeffectors are active, i.e. can make contact
+
+    std::shared_ptr<const Terrain> terrain_;  //!< terrain height map, flat ground if not set
 };
 }  // namespace rbd
 }  // namespace ct
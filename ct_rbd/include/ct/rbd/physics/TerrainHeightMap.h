@@ -0,0 +1,484 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Eigen/Core>
+
+#include <ct/core/types/AutoDiff.h>
+
+namespace ct {
+namespace rbd {
+
+/*!
+ * \brief A 2.5D terrain given as a regular grid of heights
+ *
+ * The terrain height \f$ h(x, y) \f$ is the bilinear interpolation of the grid heights. Its gradient is computed
+ * analytically from the same interpolation, such that the terrain normal
+ *
+ * \f[ n = \frac{1}{\sqrt{1 + h_x^2 + h_y^2}} (-h_x, -h_y, 1)^T \f]
+ *
+ * is consistent with the height and the resulting contact forces remain differentiable inside every cell.
+ * Outside of the grid, the heights at the border are continued constantly.
+ *
+ * A lookup only requires the cell index and four grid values and is therefore cheap enough to be evaluated in
+ * every integration step. Large maps can be memory mapped from a binary file (see loadFromFile()), such that
+ * only the accessed pages are loaded and several height maps or processes share the same data.
+ *
+ * The grid is stored row major, the row index corresponds to y and the column index to x.
+ * The height at row r and column c is located at \f$ (x_0 + c \cdot res, y_0 + r \cdot res) \f$.
+ *
+ * For auto-diff and code generation scalars, the cell cannot be selected from the value of the query while
+ * recording. The cell is therefore looked up by a CppAD atomic function (see CellAtomic), which returns the grid
+ * index and the four heights of the cell. These are piecewise constant in the position, hence the atomic function
+ * has zero derivatives and only the bilinear interpolation within the cell is recorded. The tape is valid for every
+ * position and a lookup records a constant number of operations, independent of the size of the grid. Recorded
+ * functions call back into the height map, which therefore has to outlive them. Code generated from a lookup calls
+ * the atomic function (see getCellAtomic()), which has to be registered with the compiled model, e.g. via
+ * CppAD::cg::GenericModel::addAtomicFunction().
+ */
+class TerrainHeightMap
+{
+public:
+    /*!
+     * \brief Constructs a height map from a matrix of heights
+     * @param heights grid heights, rows correspond to y and columns to x
+     * @param originX x coordinate of the first column
+     * @param originY y coordinate of the first row
+     * @param resolution grid spacing in x and y
+     */
+    TerrainHeightMap(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>& heights,
+        double originX,
+        double originY,
+        double resolution)
+        : rows_(heights.rows()), cols_(heights.cols()), originX_(originX), originY_(originY), resolution_(resolution)
+    {
+        std::shared_ptr<std::vector<double>> data(
+            new std::vector<double>(heights.data(), heights.data() + heights.size()));
+        data_ = std::shared_ptr<const double>(data, data->data());
+        check();
+        createAtomics();
+    }
+
+    //! copy constructor, the copy shares the grid heights and the atomic cell lookup
+    TerrainHeightMap(const TerrainHeightMap& other) = default;
+
+    /*!
+     * \brief Memory maps a height map from a binary file written with writeToFile()
+     *
+     * The file consists of a header with the number of rows and columns (two uint64), followed by the origin and
+     * resolution (three doubles) and the row major heights (doubles).
+     *
+     * @param filename the file to map
+     * @return the height map, which keeps the mapping alive as long as it or a copy of it exists
+     */
+    static std::shared_ptr<TerrainHeightMap> loadFromFile(const std::string& filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("TerrainHeightMap: could not open file " + filename);
+
+        struct stat fileStat;
+        if (::fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < HEADER_SIZE)
+        {
+            ::close(fd);
+            throw std::runtime_error("TerrainHeightMap: invalid file " + filename);
+        }
+
+        const size_t fileSize = fileStat.st_size;
+        void* mapped = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+            throw std::runtime_error("TerrainHeightMap: could not map file " + filename);
+
+        std::shared_ptr<const char> mapping(
+            static_cast<const char*>(mapped), [fileSize](const char* p) { ::munmap(const_cast<char*>(p), fileSize); });
+
+        const uint64_t* dims = reinterpret_cast<const uint64_t*>(mapping.get());
+        const double* params = reinterpret_cast<const double*>(mapping.get() + 2 * sizeof(uint64_t));
+
+        if (fileSize != HEADER_SIZE + dims[0] * dims[1] * sizeof(double))
+            throw std::runtime_error("TerrainHeightMap: file size does not match the grid size in " + filename);
+
+        std::shared_ptr<const double> data(mapping, reinterpret_cast<const double*>(mapping.get() + HEADER_SIZE));
+        return std::shared_ptr<TerrainHeightMap>(
+            new TerrainHeightMap(data, dims[0], dims[1], params[0], params[1], params[2]));
+    }
+
+    /*!
+     * \brief Writes a height map to a binary file which can be loaded with loadFromFile()
+     */
+    static void writeToFile(const std::string& filename,
+        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>& heights,
+        double originX,
+        double originY,
+        double resolution)
+    {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.good())
+            throw std::runtime_error("TerrainHeightMap: could not open file " + filename);
+
+        const uint64_t dims[2] = {static_cast<uint64_t>(heights.rows()), static_cast<uint64_t>(heights.cols())};
+        const double params[3] = {originX, originY, resolution};
+        file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+        file.write(reinterpret_cast<const char*>(params), sizeof(params));
+        file.write(reinterpret_cast<const char*>(heights.data()), heights.size() * sizeof(double));
+    }
+
+    /*!
+     * \brief Computes the terrain height and its gradient at a position
+     * @param x x coordinate
+     * @param y y coordinate
+     * @param dhdx derivative of the height w.r.t. x
+     * @param dhdy derivative of the height w.r.t. y
+     * @return the terrain height
+     */
+    template <typename SCALAR>
+    SCALAR getHeight(const SCALAR& x, const SCALAR& y, SCALAR& dhdx, SCALAR& dhdy) const
+    {
+        return getHeight(x, y, dhdx, dhdy, typename std::is_floating_point<SCALAR>::type());
+    }
+
+    //! computes the terrain height at a position
+    template <typename SCALAR>
+    SCALAR getHeight(const SCALAR& x, const SCALAR& y) const
+    {
+        SCALAR dhdx, dhdy;
+        return getHeight(x, y, dhdx, dhdy);
+    }
+
+    //! computes the (unit) terrain normal at a position
+    template <typename SCALAR>
+    Eigen::Matrix<SCALAR, 3, 1> getNormal(const SCALAR& x, const SCALAR& y) const
+    {
+        SCALAR dhdx, dhdy;
+        getHeight(x, y, dhdx, dhdy);
+        return normalFromGradient(dhdx, dhdy);
+    }
+
+    //! computes the unit normal of a surface given the gradient of its height
+    template <typename SCALAR>
+    static Eigen::Matrix<SCALAR, 3, 1> normalFromGradient(const SCALAR& dhdx, const SCALAR& dhdy)
+    {
+        using std::sqrt;
+        Eigen::Matrix<SCALAR, 3, 1> normal;
+        normal << -dhdx, -dhdy, SCALAR(1.0);
+        return normal / sqrt(SCALAR(1.0) + dhdx * dhdx + dhdy * dhdy);
+    }
+
+    //! the grid height at row r and column c
+    double height(size_t r, size_t c) const { return data_.get()[r * cols_ + c]; }
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    double originX() const { return originX_; }
+    double originY() const { return originY_; }
+    double resolution() const { return resolution_; }
+
+#if defined(CPPAD) || defined(CPPADCG)
+    class CellAtomic;
+
+    //! the atomic function looking up the grid cell of auto-diff and code generation scalars
+    CellAtomic& getCellAtomic() const { return *cellAtomic_; }
+#endif
+
+private:
+    static const size_t HEADER_SIZE = 2 * sizeof(uint64_t) + 3 * sizeof(double);
+
+    //! number of outputs of the cell lookup: grid indices, cell heights and inside flags
+    static const size_t CELL_SIZE = 8;
+
+    TerrainHeightMap(const std::shared_ptr<const double>& data,
+        size_t rows,
+        size_t cols,
+        double originX,
+        double originY,
+        double resolution)
+        : data_(data), rows_(rows), cols_(cols), originX_(originX), originY_(originY), resolution_(resolution)
+    {
+        check();
+        createAtomics();
+    }
+
+    void check() const
+    {
+        if (rows_ < 2 || cols_ < 2)
+            throw std::runtime_error("TerrainHeightMap: the grid requires at least 2x2 heights.");
+        if (!(resolution_ > 0.0))
+            throw std::runtime_error("TerrainHeightMap: the resolution needs to be positive.");
+    }
+
+    //! the lookup for floating point types, interpolating the four heights of the cell of the query
+    template <typename SCALAR>
+    SCALAR getHeight(const SCALAR& x, const SCALAR& y, SCALAR& dhdx, SCALAR& dhdy, std::true_type) const
+    {
+        size_t c, r;
+        bool insideX, insideY;
+        const SCALAR tx = localCoordinate(x, originX_, cols_, c, insideX);
+        const SCALAR ty = localCoordinate(y, originY_, rows_, r, insideY);
+
+        const double h00 = height(r, c);
+        const double h01 = height(r, c + 1);
+        const double h10 = height(r + 1, c);
+        const double h11 = height(r + 1, c + 1);
+
+        dhdx = insideX ? SCALAR(((SCALAR(1.0) - ty) * (h01 - h00) + ty * (h11 - h10)) / resolution_) : SCALAR(0.0);
+        dhdy = insideY ? SCALAR(((SCALAR(1.0) - tx) * (h10 - h00) + tx * (h11 - h01)) / resolution_) : SCALAR(0.0);
+
+        return (SCALAR(1.0) - ty) * ((SCALAR(1.0) - tx) * h00 + tx * h01) + ty * ((SCALAR(1.0) - tx) * h10 + tx * h11);
+    }
+
+    /*!
+     * \brief the lookup for auto-diff and code generation types, which does not branch on the value of the query
+     *
+     * The cell is selected by the atomic function, the interpolation is the same as for floating point types.
+     */
+    template <typename SCALAR>
+    SCALAR getHeight(const SCALAR& x, const SCALAR& y, SCALAR& dhdx, SCALAR& dhdy, std::false_type) const
+    {
+        std::vector<SCALAR> xy(2), cell(CELL_SIZE);
+        xy[0] = x;
+        xy[1] = y;
+        lookupCell(xy, cell);
+
+        const SCALAR tx = clampUnit((x - SCALAR(originX_)) / SCALAR(resolution_) - cell[0]);
+        const SCALAR ty = clampUnit((y - SCALAR(originY_)) / SCALAR(resolution_) - cell[1]);
+        const SCALAR& h00 = cell[2];
+        const SCALAR& h01 = cell[3];
+        const SCALAR& h10 = cell[4];
+        const SCALAR& h11 = cell[5];
+
+        dhdx = cell[6] * ((SCALAR(1.0) - ty) * (h01 - h00) + ty * (h11 - h10)) / SCALAR(resolution_);
+        dhdy = cell[7] * ((SCALAR(1.0) - tx) * (h10 - h00) + tx * (h11 - h01)) / SCALAR(resolution_);
+
+        return (SCALAR(1.0) - ty) * ((SCALAR(1.0) - tx) * h00 + tx * h01) + ty * ((SCALAR(1.0) - tx) * h10 + tx * h11);
+    }
+
+    //! clamps a coordinate to [0, 1] with conditional expressions
+    template <typename SCALAR>
+    static SCALAR clampUnit(const SCALAR& t)
+    {
+        // CondExp* are found by argument dependent lookup, such that this header does not require CppAD
+        const SCALAR zero(0.0), one(1.0);
+        return CondExpLt(t, zero, zero, CondExpGt(t, one, one, t));
+    }
+
+    /*!
+     * \brief Looks up the cell of a position
+     *
+     * The output is the column and row index of the cell, its heights h00, h01, h10, h11 and the
+     * flags whether x and y are inside of the grid (1 or 0), see evaluateCell().
+     */
+#ifdef CPPAD
+    void lookupCell(const std::vector<CppAD::AD<double>>& xy, std::vector<CppAD::AD<double>>& cell) const;
+#endif
+#ifdef CPPADCG
+    void lookupCell(const std::vector<ct::core::ADCGScalar>& xy, std::vector<ct::core::ADCGScalar>& cell) const;
+#endif
+
+    //! evaluates the cell lookup of the atomic function
+    void evaluateCell(double x, double y, double* out) const
+    {
+        size_t c, r;
+        bool insideX, insideY;
+        localCoordinate(x, originX_, cols_, c, insideX);
+        localCoordinate(y, originY_, rows_, r, insideY);
+
+        out[0] = double(c);
+        out[1] = double(r);
+        out[2] = height(r, c);
+        out[3] = height(r, c + 1);
+        out[4] = height(r + 1, c);
+        out[5] = height(r + 1, c + 1);
+        out[6] = insideX ? 1.0 : 0.0;
+        out[7] = insideY ? 1.0 : 0.0;
+    }
+
+    //! creates the atomic functions of the cell lookup
+    void createAtomics();
+
+    /*!
+     * \brief Computes the cell index and the normalized coordinate within the cell along one grid axis
+     * @param p the coordinate
+     * @param origin the coordinate of the first grid point
+     * @param n the number of grid points
+     * @param idx the index of the cell
+     * @param inside false if the coordinate is clamped to the border of the grid
+     * @return the coordinate within the cell in [0, 1]
+     */
+    template <typename SCALAR>
+    SCALAR localCoordinate(const SCALAR& p, double origin, size_t n, size_t& idx, bool& inside) const
+    {
+        const double s = (p - origin) / resolution_;
+        inside = (s >= 0.0 && s <= double(n - 1));
+
+        if (s < 0.0)
+        {
+            idx = 0;
+            return SCALAR(0.0);
+        }
+        if (s >= double(n - 1))
+        {
+            idx = n - 2;
+            return SCALAR(1.0);
+        }
+
+        idx = std::min(static_cast<size_t>(s), n - 2);
+        return (p - SCALAR(origin + idx * resolution_)) / SCALAR(resolution_);
+    }
+
+
+    std::shared_ptr<const double> data_;  //!< row major grid heights, either owned or memory mapped
+#if defined(CPPAD) || defined(CPPADCG)
+    std::shared_ptr<CellAtomic> cellAtomic_;  //!< the cell lookup for CppAD::AD<double>
+#endif
+#ifdef CPPADCG
+    std::shared_ptr<CppAD::cg::CGAtomicFun<double>> cellAtomicCG_;  //!< the cell lookup for code generation
+#endif
+
+    size_t rows_;
+    size_t cols_;
+    double originX_;
+    double originY_;
+    double resolution_;
+};
+
+#if defined(CPPAD) || defined(CPPADCG)
+/*!
+ * \brief The atomic function looking up the grid cell of a position (x, y)
+ *
+ * The outputs are piecewise constant in the position, hence all derivatives and sparsity patterns are zero.
+ */
+class TerrainHeightMap::CellAtomic : public CppAD::atomic_base<double>
+{
+public:
+    //! the atomic function keeps a copy of the height map, which shares the grid heights
+    CellAtomic(const TerrainHeightMap& terrain)
+        : CppAD::atomic_base<double>("TerrainHeightMapCell", CppAD::atomic_base<double>::set_sparsity_enum),
+          terrain_(terrain)
+    {
+    }
+
+    bool forward(size_t p,
+        size_t q,
+        const CppAD::vector<bool>& vx,
+        CppAD::vector<bool>& vy,
+        const CppAD::vector<double>& tx,
+        CppAD::vector<double>& ty) override
+    {
+        // the outputs depend on the position, hence they are variables if the position is
+        if (vx.size() > 0)
+            for (size_t j = 0; j < CELL_SIZE; j++)
+                vy[j] = vx[0] || vx[1];
+
+        double out[CELL_SIZE];
+        if (p == 0)
+            terrain_.evaluateCell(tx[0], tx[q + 1], out);
+
+        for (size_t j = 0; j < CELL_SIZE; j++)
+            for (size_t k = p; k <= q; k++)
+                ty[j * (q + 1) + k] = (k == 0) ? out[j] : 0.0;
+        return true;
+    }
+
+    bool reverse(size_t q,
+        const CppAD::vector<double>& tx,
+        const CppAD::vector<double>& ty,
+        CppAD::vector<double>& px,
+        const CppAD::vector<double>& py) override
+    {
+        for (size_t i = 0; i < px.size(); i++)
+            px[i] = 0.0;
+        return true;
+    }
+
+    bool for_sparse_jac(size_t q, const CppAD::vector<std::set<size_t>>& r, CppAD::vector<std::set<size_t>>& s) override
+    {
+        for (size_t j = 0; j < s.size(); j++)
+            s[j].clear();
+        return true;
+    }
+
+    bool rev_sparse_jac(size_t q,
+        const CppAD::vector<std::set<size_t>>& rt,
+        CppAD::vector<std::set<size_t>>& st) override
+    {
+        for (size_t i = 0; i < st.size(); i++)
+            st[i].clear();
+        return true;
+    }
+
+    bool rev_sparse_hes(const CppAD::vector<bool>& vx,
+        const CppAD::vector<bool>& s,
+        CppAD::vector<bool>& t,
+        size_t q,
+        const CppAD::vector<std::set<size_t>>& r,
+        const CppAD::vector<std::set<size_t>>& u,
+        CppAD::vector<std::set<size_t>>& v) override
+    {
+        for (size_t i = 0; i < t.size(); i++)
+            t[i] = false;
+        for (size_t i = 0; i < v.size(); i++)
+            v[i].clear();
+        return true;
+    }
+
+    bool for_sparse_hes(const CppAD::vector<bool>& vx,
+        const CppAD::vector<bool>& r,
+        const CppAD::vector<bool>& s,
+        CppAD::vector<std::set<size_t>>& h) override
+    {
+        for (size_t i = 0; i < h.size(); i++)
+            h[i].clear();
+        return true;
+    }
+
+private:
+    TerrainHeightMap terrain_;
+};
+
+inline void TerrainHeightMap::createAtomics()
+{
+    cellAtomic_.reset(new CellAtomic(*this));
+#ifdef CPPADCG
+    cellAtomicCG_.reset(new CppAD::cg::CGAtomicFun<double>(*cellAtomic_, std::vector<double>(2, 0.0)));
+#endif
+}
+
+#ifdef CPPAD
+inline void TerrainHeightMap::lookupCell(const std::vector<CppAD::AD<double>>& xy,
+    std::vector<CppAD::AD<double>>& cell) const
+{
+    (*cellAtomic_)(xy, cell);
+}
+#endif
+
+#ifdef CPPADCG
+inline void TerrainHeightMap::lookupCell(const std::vector<ct::core::ADCGScalar>& xy,
+    std::vector<ct::core::ADCGScalar>& cell) const
+{
+    (*cellAtomicCG_)(xy, cell);
+}
+#endif
+#else
+inline void TerrainHeightMap::createAtomics() {}
+#endif
+
+}  // namespace rbd
+}  // namespace ct
@@ -0,0 +1,530 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <array>
+
+#include <ct/iit/rbd/rbd.h>
+
+namespace ct {
+namespace rbd {
+
+/**
+ * @brief Analytical derivatives of the inverse and forward dynamics of a RobCoGen rigid body system
+ *
+ * The derivatives are obtained by differentiating the recursive Newton-Euler algorithm (RNEA), following the
+ * RNEA derivatives of Carpentier and Mansard ("Analytical Derivatives of Rigid Body Dynamics Algorithms",
+ * RSS 2018). All spatial quantities are expressed in the base frame. In this frame, the derivative of a
+ * quantity attached to the subtree of a joint w.r.t. the joint position is the spatial cross product with the
+ * joint motion subspace, such that no transforms have to be differentiated. After one RNEA pass, a backward pass
+ * over the parent array accumulates the composite inertias of the subtrees and their derivatives w.r.t. the
+ * subtree velocity. Every nonzero entry of the derivatives then follows in constant time from the pair of a joint
+ * and one of its ancestors, i.e. the derivatives cost \f$ O(n d) \f$ for a tree of depth \f$ d \f$.
+ *
+ * The derivatives of the forward dynamics follow from the ones of the inverse dynamics as
+ * \f$ \partial \dot{v} / \partial x = - M^{-1} \partial ID / \partial x \f$, where \f$ M \f$ is the joint space
+ * inertia matrix of RobCoGen. \f$ M \f$ is factorized as \f$ L^T D L \f$ exploiting the branch induced sparsity
+ * (Featherstone, "Rigid Body Dynamics Algorithms", Sec. 6.5) at \f$ O(n d^2) \f$, and every solve costs
+ * \f$ O(n d) \f$ per column. As the derivatives of the forward dynamics are dense, their \f$ O(n) \f$ columns
+ * make forwardDynamicsDerivatives() cost \f$ O(n^2 d) \f$ overall.
+ *
+ * The generalized velocities are ordered as in RobCoGen, i.e. for floating base systems the base twist
+ * (angular, linear) in base coordinates followed by the joint velocities. The inverse dynamics accordingly return
+ * the base wrench followed by the joint forces.
+ *
+ * RobCoGen does not export the kinematic tree, hence the parent array and the joint types are recovered from the
+ * RobCoGen transforms at construction, see extractModel(). The link inertias are obtained through the robot Utils,
+ * which requires the link names (CT_L0_NAME, ...) to be defined in the robot header, see robcogenHelpers.h.
+ *
+ * @tparam RBD the RobCoGen container of the robot
+ */
+template <class RBD>
+class DynamicsDerivatives
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef typename RBD::SCALAR SCALAR;
+
+    static const bool FB = RBD::TRAIT::floating_base;
+    static const size_t NJOINTS = RBD::NJOINTS;
+    static const size_t NLINKS = RBD::NLINKS;
+    //! number of degrees of freedom, including the base for floating base systems
+    static const size_t NDOF = NJOINTS + 6 * FB;
+
+    static_assert(NLINKS == NJOINTS + 1, "DynamicsDerivatives requires one joint per link.");
+
+    typedef typename RBD::LinkForceMap ExtLinkForces_t;
+
+    typedef Eigen::Matrix<SCALAR, 3, 1> Vector3_t;
+    typedef Eigen::Matrix<SCALAR, 3, 3> Matrix3_t;
+    typedef Eigen::Matrix<SCALAR, 6, 1> Vector6_t;
+    typedef Eigen::Matrix<SCALAR, 6, 6> Matrix6_t;
+
+    typedef Eigen::Matrix<SCALAR, NJOINTS, 1> joint_vector_t;
+    typedef Eigen::Matrix<SCALAR, NDOF, 1> dof_vector_t;
+    typedef Eigen::Matrix<SCALAR, NDOF, NDOF> dof_matrix_t;
+    typedef Eigen::Matrix<SCALAR, NDOF, NJOINTS> dof_joint_matrix_t;
+    typedef Eigen::Matrix<SCALAR, NDOF, 6> dof_force_matrix_t;
+
+    DynamicsDerivatives() : rbdContainer_(new RBD()) { extractModel(); }
+    DynamicsDerivatives(const DynamicsDerivatives& other) : DynamicsDerivatives() {}
+    ~DynamicsDerivatives() = default;
+
+    //! the gravity vector expressed in the base, as used by RobCoGen for fixed base systems
+    static Vector6_t defaultGravity()
+    {
+        Vector6_t gravity = Vector6_t::Zero();
+        gravity(iit::rbd::LZ) = -SCALAR(iit::rbd::g);
+        return gravity;
+    }
+
+    /**
+     * @brief Computes the inverse dynamics and its derivatives w.r.t. the joint positions and the velocities
+     *
+     * The derivative w.r.t. the accelerations is the joint space inertia matrix.
+     *
+     * @param[in]  q        joint positions
+     * @param[in]  v        generalized velocities
+     * @param[in]  vd       generalized accelerations
+     * @param[in]  fext     external forces on the links, expressed in the link frames
+     * @param[out] tau      generalized forces (base wrench and joint forces)
+     * @param[out] dtau_dq  derivative of the generalized forces w.r.t. the joint positions
+     * @param[out] dtau_dv  derivative of the generalized forces w.r.t. the generalized velocities
+     * @param[in]  gravity  gravity expressed in the base frame
+     */
+    void inverseDynamicsDerivatives(const joint_vector_t& q,
+        const dof_vector_t& v,
+        const dof_vector_t& vd,
+        const ExtLinkForces_t& fext,
+        dof_vector_t& tau,
+        dof_joint_matrix_t& dtau_dq,
+        dof_matrix_t& dtau_dv,
+        const Vector6_t& gravity = defaultGravity())
+    {
+        updateKinematics(q);
+        rnea(v, vd, fext, gravity, tau);
+        rneaDerivatives(dtau_dq, dtau_dv);
+    }
+
+    /**
+     * @brief Computes the forward dynamics and its derivatives w.r.t. the joint positions, velocities and forces
+     *
+     * For floating base systems, the derivative of the accelerations w.r.t. the gravity vector is the identity for
+     * the base and zero for the joints, as gravity only offsets the base acceleration.
+     *
+     * @param[in]  q         joint positions
+     * @param[in]  v         generalized velocities
+     * @param[in]  jForces   joint forces
+     * @param[in]  fext      external forces on the links, expressed in the link frames
+     * @param[out] vd        generalized accelerations
+     * @param[out] dvd_dq    derivative of the accelerations w.r.t. the joint positions
+     * @param[out] dvd_dv    derivative of the accelerations w.r.t. the generalized velocities
+     * @param[out] dvd_dtau  derivative of the accelerations w.r.t. the joint forces
+     * @param[in]  gravity   gravity expressed in the base frame
+     */
+    void forwardDynamicsDerivatives(const joint_vector_t& q,
+        const dof_vector_t& v,
+        const joint_vector_t& jForces,
+        const ExtLinkForces_t& fext,
+        dof_vector_t& vd,
+        dof_joint_matrix_t& dvd_dq,
+        dof_matrix_t& dvd_dv,
+        dof_joint_matrix_t& dvd_dtau,
+        const Vector6_t& gravity = defaultGravity())
+    {
+        updateKinematics(q);
+
+        M_ = rbdContainer_->jSim().update(q);
+        factorizeInertiaMatrix();
+
+        // bias forces, then the accelerations which the inverse dynamics map to the joint forces
+        dof_vector_t tau;
+        vd.setZero();
+        rnea(v, vd, fext, gravity, tau);
+
+        tau = -tau;
+        tau.template tail<NJOINTS>() += jForces;
+        vd = tau;
+        solveInertiaMatrix(vd);
+
+        rnea(v, vd, fext, gravity, tau);
+        rneaDerivatives(dvd_dq, dvd_dv);
+
+        dvd_dq = -dvd_dq;
+        solveInertiaMatrix(dvd_dq);
+        dvd_dv = -dvd_dv;
+        solveInertiaMatrix(dvd_dv);
+        dvd_dtau = dof_matrix_t::Identity().template rightCols<NJOINTS>();
+        solveInertiaMatrix(dvd_dtau);
+    }
+
+    /**
+     * @brief Derivative of the accelerations w.r.t. an external force on a link, expressed in the link frame
+     *
+     * Requires a prior call to forwardDynamicsDerivatives() at the point of interest.
+     *
+     * @param[in]  linkId  the link id
+     * @param[out] dvd_df  derivative of the generalized accelerations w.r.t. the link force
+     */
+    void externalForceDerivative(size_t linkId, dof_force_matrix_t& dvd_df) const
+    {
+        const Matrix6_t X = forceTransformBaseLink(linkId);
+
+        // the external force enters the inverse dynamics of the base and all supporting joints with a negative sign
+        dvd_df.setZero();
+        if (FB)
+            dvd_df.topRows(6) = X;
+        for (size_t l = linkId; l > 0; l = parent_[l - 1])
+            dvd_df.row(6 * FB + l - 1) = S_[l - 1].transpose() * X;
+
+        solveInertiaMatrix(dvd_df);
+    }
+
+    //! the joint space inertia matrix of the last call to forwardDynamicsDerivatives()
+    const dof_matrix_t& getJointSpaceInertiaMatrix() const { return M_; }
+    //! the parent link of a joint
+    size_t getParentLink(size_t jointId) const { return parent_[jointId]; }
+    //! true if the joint is revolute, false if it is prismatic
+    bool isRevolute(size_t jointId) const { return revolute_[jointId]; }
+private:
+    /**
+     * @brief Extracts the kinematic tree, the joint types and the link inertias from the RobCoGen container
+     *
+     * Link i is the child of joint i-1 in RobCoGen. A joint supports a link if moving the joint changes the
+     * transform of the link, which holds for any revolute or prismatic joint on the path from the base to the link.
+     * RobCoGen numbers parents before their children, hence the parent of a joint is the child of the supporting
+     * joint with the highest id. The probed supports are checked against the parent array, such that a model
+     * violating these assumptions is rejected instead of producing wrong derivatives.
+     */
+    void extractModel()
+    {
+        const SCALAR tol = SCALAR(1e-8);
+
+        joint_vector_t q0 = joint_vector_t::LinSpaced(NJOINTS, SCALAR(0.1), SCALAR(0.9));
+        std::array<Eigen::Matrix<SCALAR, 4, 4>, NLINKS> T0;
+        for (size_t l = 1; l < NLINKS; l++)
+            T0[l] = RBD::UTILS::getTransformBaseLinkById(rbdContainer_->homogeneousTransforms(), l, q0);
+
+        std::array<std::array<bool, NJOINTS>, NLINKS> supports;
+        for (size_t l = 0; l < NLINKS; l++)
+            supports[l].fill(false);
+
+        for (size_t j = 0; j < NJOINTS; j++)
+        {
+            joint_vector_t q = q0;
+            q(j) += SCALAR(0.5);
+            for (size_t l = 1; l < NLINKS; l++)
+            {
+                Eigen::Matrix<SCALAR, 4, 4> T =
+                    RBD::UTILS::getTransformBaseLinkById(rbdContainer_->homogeneousTransforms(), l, q);
+                supports[l][j] = (T - T0[l]).array().abs().maxCoeff() > tol;
+
+                if (l == j + 1)
+                {
+                    if (!supports[l][j])
+                        throw std::runtime_error("DynamicsDerivatives: joint does not move its child link.");
+                    revolute_[j] = (T - T0[l]).template topLeftCorner<3, 3>().array().abs().maxCoeff() > tol;
+                }
+            }
+        }
+
+        for (size_t j = 0; j < NJOINTS; j++)
+        {
+            parent_[j] = 0;
+            for (size_t k = 0; k < j; k++)
+                if (supports[j + 1][k])
+                    parent_[j] = k + 1;
+        }
+
+        for (size_t l = 1; l < NLINKS; l++)
+        {
+            std::array<bool, NJOINTS> path;
+            path.fill(false);
+            for (size_t k = l; k > 0; k = parent_[k - 1])
+                path[k - 1] = true;
+            if (path != supports[l])
+                throw std::runtime_error("DynamicsDerivatives: could not extract the kinematic tree.");
+        }
+
+        // parent of every degree of freedom in the joint space inertia matrix, -1 for the root
+        for (size_t i = 0; i < NDOF; i++)
+        {
+            if (i < 6 * FB)
+                lambda_[i] = static_cast<int>(i) - 1;
+            else
+            {
+                const size_t p = parent_[i - 6 * FB];
+                lambda_[i] = p > 0 ? static_cast<int>(6 * FB + p - 1) : static_cast<int>(6 * FB) - 1;
+            }
+        }
+
+        for (size_t l = 0; l < NLINKS; l++)
+        {
+            if (l == 0 && !FB)
+                localInertia_[l].setZero();
+            else
+                localInertia_[l] = RBD::UTILS::getInertiaById(rbdContainer_->inertiaProperties(), l);
+        }
+
+        E_[0].setIdentity();
+        p_[0].setZero();
+        I_[0] = localInertia_[0];
+    }
+
+    //! computes the link poses, joint motion subspaces and inertias in the base frame
+    void updateKinematics(const joint_vector_t& q)
+    {
+        for (size_t l = 1; l < NLINKS; l++)
+        {
+            const Eigen::Matrix<SCALAR, 4, 4> T =
+                RBD::UTILS::getTransformBaseLinkById(rbdContainer_->homogeneousTransforms(), l, q);
+            E_[l] = T.template topLeftCorner<3, 3>();
+            p_[l] = T.template topRightCorner<3, 1>();
+
+            const Matrix6_t X = forceTransformBaseLink(l);
+            I_[l] = X * localInertia_[l] * X.transpose();
+        }
+
+        // RobCoGen joints act along the z-axis of their child link frame
+        for (size_t j = 0; j < NJOINTS; j++)
+        {
+            const Vector3_t axis = E_[j + 1].col(2);
+            if (revolute_[j])
+                S_[j] << axis, p_[j + 1].cross(axis);
+            else
+                S_[j] << Vector3_t::Zero(), axis;
+        }
+    }
+
+    //! recursive Newton-Euler algorithm in the base frame, caches velocities, accelerations and forces
+    void rnea(const dof_vector_t& v,
+        const dof_vector_t& vd,
+        const ExtLinkForces_t& fext,
+        const Vector6_t& gravity,
+        dof_vector_t& tau)
+    {
+        v_[0].setZero();
+        a_[0] = -gravity;
+        if (FB)
+        {
+            v_[0] = v.head(6);
+            a_[0] += vd.head(6);
+        }
+
+        for (size_t j = 0; j < NJOINTS; j++)
+        {
+            const size_t c = j + 1;
+            const SCALAR& qd = v(6 * FB + j);
+            v_[c] = v_[parent_[j]] + S_[j] * qd;
+            a_[c] = a_[parent_[j]] + S_[j] * vd(6 * FB + j) + crossMotion(v_[c], S_[j]) * qd;
+        }
+
+        for (size_t l = 0; l < NLINKS; l++)
+        {
+            h_[l] = I_[l] * v_[l];
+            f_[l] = I_[l] * a_[l] + crossForce(v_[l], h_[l]);
+            if (FB || l > 0)
+                f_[l] -= forceTransformBaseLink(l) * fext[static_cast<typename RBD::LinkIdentifiers>(l)];
+            F_[l] = f_[l];
+        }
+
+        for (int j = NJOINTS - 1; j >= 0; j--)
+            F_[parent_[j]] += F_[j + 1];
+
+        if (FB)
+            tau.head(6) = F_[0];
+        for (size_t j = 0; j < NJOINTS; j++)
+            tau(6 * FB + j) = S_[j].dot(F_[j + 1]);
+    }
+
+    /**
+     * @brief derivatives of the cached RNEA w.r.t. the joint positions and the generalized velocities
+     *
+     * Moving joint k moves its subtree rigidly, except for the velocity and acceleration of the parent. The subtree
+     * force derivatives are hence linear in the composite inertia Ic and the composite velocity derivative Bc of the
+     * subtree of the joint whose torque is differentiated, which is the subtree of k for k itself and its ancestors.
+     * For a descendant j of k, the rotation of the motion subspace of j cancels the rotation of its subtree forces.
+     */
+    void rneaDerivatives(dof_joint_matrix_t& dtau_dq, dof_matrix_t& dtau_dv)
+    {
+        for (size_t l = 0; l < NLINKS; l++)
+        {
+            Ic_[l] = I_[l];
+            Bc_[l] = momentumCrossMatrix(h_[l]) - I_[l] * motionCrossMatrix(v_[l]) -
+                     motionCrossMatrix(v_[l]).transpose() * I_[l];
+        }
+        for (int j = NJOINTS - 1; j >= 0; j--)
+        {
+            Ic_[parent_[j]] += Ic_[j + 1];
+            Bc_[parent_[j]] += Bc_[j + 1];
+        }
+
+        dtau_dq.setZero();
+        dtau_dv.setZero();
+
+        for (size_t k = 0; k < NJOINTS; k++)
+        {
+            const size_t c = k + 1;
+            const Vector6_t& s = S_[k];
+            const Vector6_t& vp = v_[parent_[k]];
+
+            // derivatives of the parent velocity and acceleration, as seen from the moving subtree
+            w_[k] = crossMotion(vp, s);
+            uq_[k] = crossMotion(w_[k], vp) + crossMotion(s, a_[parent_[k]]);
+            uv_[k] = 2 * crossMotion(s, vp);
+
+            const Vector6_t dFq = crossForce(s, F_[c]) + Bc_[c] * w_[k] - Ic_[c] * uq_[k];
+            const Vector6_t dFv = Bc_[c] * s - Ic_[c] * uv_[k];
+
+            for (size_t l = c; l > 0; l = parent_[l - 1])
+            {
+                dtau_dq(6 * FB + l - 1, k) = S_[l - 1].dot(dFq);
+                dtau_dv(6 * FB + l - 1, 6 * FB + k) = S_[l - 1].dot(dFv);
+            }
+            if (FB)
+            {
+                dtau_dq.col(k).template head<6>() = dFq;
+                dtau_dv.col(6 * FB + k).template head<6>() = dFv;
+            }
+        }
+
+        for (size_t j = 0; j < NJOINTS; j++)
+        {
+            const Vector6_t BcS = Bc_[j + 1].transpose() * S_[j];
+            const Vector6_t IcS = Ic_[j + 1] * S_[j];
+
+            for (size_t l = parent_[j]; l > 0; l = parent_[l - 1])
+            {
+                const size_t k = l - 1;
+                dtau_dq(6 * FB + j, k) = BcS.dot(w_[k]) - IcS.dot(uq_[k]);
+                dtau_dv(6 * FB + j, 6 * FB + k) = BcS.dot(S_[k]) - IcS.dot(uv_[k]);
+            }
+
+            // base twist
+            if (FB)
+                dtau_dv.row(6 * FB + j).template head<6>() =
+                    BcS.transpose() + IcS.transpose() * motionCrossMatrix(v_[0]);
+        }
+
+        if (FB)
+            dtau_dv.template topLeftCorner<6, 6>() = Bc_[0] + Ic_[0] * motionCrossMatrix(v_[0]);
+    }
+
+    /**
+     * @brief factorizes the joint space inertia matrix as L^T D L, exploiting the branch induced sparsity
+     *
+     * The unit lower triangular L and the diagonal D overwrite the lower triangle of a copy of the inertia matrix.
+     */
+    void factorizeInertiaMatrix()
+    {
+        LTDL_ = M_;
+        for (int k = NDOF - 1; k >= 0; k--)
+        {
+            for (int i = lambda_[k]; i >= 0; i = lambda_[i])
+            {
+                const SCALAR a = LTDL_(k, i) / LTDL_(k, k);
+                for (int j = i; j >= 0; j = lambda_[j])
+                    LTDL_(i, j) -= LTDL_(k, j) * a;
+                LTDL_(k, i) = a;
+            }
+        }
+    }
+
+    //! solves the factorized joint space inertia matrix in place for all columns of the right hand side
+    template <typename Derived>
+    void solveInertiaMatrix(Eigen::MatrixBase<Derived>& x) const
+    {
+        for (int i = NDOF - 1; i >= 0; i--)
+            for (int j = lambda_[i]; j >= 0; j = lambda_[j])
+                x.row(j) -= LTDL_(i, j) * x.row(i);
+
+        for (size_t i = 0; i < NDOF; i++)
+            x.row(i) /= LTDL_(i, i);
+
+        for (size_t i = 0; i < NDOF; i++)
+            for (int j = lambda_[i]; j >= 0; j = lambda_[j])
+                x.row(i) -= LTDL_(i, j) * x.row(j);
+    }
+
+    //! force transform from a link to the base frame
+    Matrix6_t forceTransformBaseLink(size_t l) const
+    {
+        Matrix6_t X;
+        X << E_[l], skew(p_[l]) * E_[l], Matrix3_t::Zero(), E_[l];
+        return X;
+    }
+
+    //! cross product matrix of a 3d vector
+    static Matrix3_t skew(const Vector3_t& p)
+    {
+        Matrix3_t px;
+        px << 0, -p(2), p(1), p(2), 0, -p(0), -p(1), p(0), 0;
+        return px;
+    }
+
+    //! matrix of the spatial cross product of motion vectors, such that crossMotion(v, m) = X(v) * m
+    static Matrix6_t motionCrossMatrix(const Vector6_t& v)
+    {
+        Matrix6_t X;
+        X << skew(v.template head<3>()), Matrix3_t::Zero(), skew(v.template tail<3>()), skew(v.template head<3>());
+        return X;
+    }
+
+    //! matrix of the spatial cross product with a force vector in the first argument, i.e. crossForce(m, f) = H(f) * m
+    static Matrix6_t momentumCrossMatrix(const Vector6_t& f)
+    {
+        Matrix6_t H;
+        H << -skew(f.template head<3>()), -skew(f.template tail<3>()), -skew(f.template tail<3>()), Matrix3_t::Zero();
+        return H;
+    }
+
+    //! spatial cross product of motion vectors
+    static Vector6_t crossMotion(const Vector6_t& v, const Vector6_t& m)
+    {
+        Vector6_t res;
+        res << v.template head<3>().cross(m.template head<3>()),
+            v.template head<3>().cross(m.template tail<3>()) + v.template tail<3>().cross(m.template head<3>());
+        return res;
+    }
+
+    //! spatial cross product of a motion and a force vector
+    static Vector6_t crossForce(const Vector6_t& v, const Vector6_t& f)
+    {
+        Vector6_t res;
+        res << v.template head<3>().cross(f.template head<3>()) + v.template tail<3>().cross(f.template tail<3>()),
+            v.template head<3>().cross(f.template tail<3>());
+        return res;
+    }
+
+    std::shared_ptr<RBD> rbdContainer_;
+
+    std::array<size_t, NJOINTS> parent_;          //! parent link of every joint
+    std::array<bool, NJOINTS> revolute_;          //! joint types
+    std::array<int, NDOF> lambda_;                //! parent of every degree of freedom, -1 for the root
+    std::array<Matrix6_t, NLINKS> localInertia_;  //! link inertias in the link frames
+
+    std::array<Matrix3_t, NLINKS> E_;  //! link orientations in the base
+    std::array<Vector3_t, NLINKS> p_;  //! link positions in the base
+    std::array<Vector6_t, NJOINTS> S_;
+    std::array<Matrix6_t, NLINKS> I_;
+    std::array<Vector6_t, NLINKS> v_;
+    std::array<Vector6_t, NLINKS> a_;
+    std::array<Vector6_t, NLINKS> h_;   //! link momenta
+    std::array<Vector6_t, NLINKS> f_;   //! link forces
+    std::array<Vector6_t, NLINKS> F_;   //! subtree forces
+    std::array<Matrix6_t, NLINKS> Ic_;  //! composite inertias of the subtrees
+    std::array<Matrix6_t, NLINKS> Bc_;  //! derivatives of the subtree forces w.r.t. a common velocity change
+    std::array<Vector6_t, NJOINTS> w_;   //! derivative of the parent velocity w.r.t. the joint position
+    std::array<Vector6_t, NJOINTS> uq_;  //! derivative of the parent acceleration w.r.t. the joint position
+    std::array<Vector6_t, NJOINTS> uv_;  //! derivative of the parent acceleration w.r.t. the joint velocity
+
+    dof_matrix_t M_;
+    dof_matrix_t LTDL_;  //! L^T D L factorization of M_
+};
+
+}  // namespace rbd
+}  // namespace ct
@@ -13,6 +13,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #include "kinematics/EndEffector.h"
 #include "kinematics/FloatingBaseTransforms.h"
 #include "kinematics/InverseKinematicsBase.h"
+#include "kinematics/KinematicsCache.h"
 
 namespace ct {
 namespace rbd {
@@ -21,7 +22,9 @@ namespace rbd {
  * \brief A general class for computing Kinematic properties
  *
  * This class implements useful Kinematic quantities. It wraps RobCoGen to
- * have access to efficient transforms and jacobians.
+ * have access to efficient transforms and jacobians. End-effector transforms, Jacobians and link force
+ * transforms are read from a KinematicsCache. All instances of the same robot share the default cache of the
+ * robot, hence a modified robot model needs its own cache (see setKinematicsCache()).
  */
 template <class RBD, size_t N_EE>
 class Kinematics
@@ -30,13 +33,17 @@ public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
     Kinematics(std::shared_ptr<RBD> rbdContainer = std::shared_ptr<RBD>(new RBD()))
-        : rbdContainer_(rbdContainer), floatingBaseTransforms_(rbdContainer_)
+        : rbdContainer_(rbdContainer), floatingBaseTransforms_(rbdContainer_), cache_(Cache_t::getDefault())
     {
         initEndeffectors(endEffectors_);
     }
 
+    //! copy constructor, the copy shares the kinematics cache of the original
     Kinematics(const Kinematics<RBD, N_EE>& other)
-        : rbdContainer_(new RBD()), endEffectors_(other.endEffectors_), floatingBaseTransforms_(rbdContainer_)
+        : rbdContainer_(new RBD()),
+          endEffectors_(other.endEffectors_),
+          floatingBaseTransforms_(rbdContainer_),
+          cache_(other.cache_)
     {
     }
 
@@ -66,6 +73,7 @@ public:
     using EEForce = SpatialForceVector<SCALAR>;
     using EEForceLinear = Vector3Tpl;
     using JointState_t = JointState<NJOINTS, SCALAR>;
+    using Cache_t = KinematicsCache<RBD, N_EE>;
 
     void initEndeffectors(std::array<EndEffector<NJOINTS, SCALAR>, NUM_EE>& endeffectors)
     {
@@ -88,9 +96,42 @@ public:
      */
     void setEndEffector(size_t id, const EndEffector<NJOINTS, SCALAR>& ee){};
 
+    /**
+     * \brief Sets the kinematics cache of this instance, e.g. a separate cache for a modified robot model
+     * @param cache the kinematics cache
+     */
+    void setKinematicsCache(const std::shared_ptr<Cache_t>& cache) { cache_ = cache; }
+    const std::shared_ptr<Cache_t>& getKinematicsCache() const { return cache_; }
     Jacobian getJacobianBaseEEbyId(size_t eeId, const RBDState<NJOINTS, SCALAR>& rbdState)
     {
-        return robcogen().getJacobianBaseEEbyId(eeId, rbdState.jointPositions());
+        return getJacobianBaseEEbyId(eeId, rbdState.jointPositions());
+    }
+
+    //! get the end-effector Jacobian expressed in the base frame
+    const Jacobian& getJacobianBaseEEbyId(size_t eeId, const typename JointState_t::Position& jointPosition)
+    {
+        return cache_->getJacobianBaseEE(robcogen(), eeId, jointPosition);
+    }
+
+    //! get the homogeneous transform from end-effector to base coordinates
+    const HomogeneousTransform& getHomogeneousTransformBaseEEById(size_t eeId,
+        const typename JointState_t::Position& jointPosition)
+    {
+        return cache_->getHomogeneousTransformBaseEE(robcogen(), eeId, jointPosition);
+    }
+
+    //! get the homogeneous transform from link to base coordinates
+    const HomogeneousTransform& getHomogeneousTransformBaseLinkById(size_t linkId,
+        const typename JointState_t::Position& jointPosition)
+    {
+        return cache_->getHomogeneousTransformBaseLink(robcogen(), linkId, jointPosition);
+    }
+
+    //! get the force transform from base to link coordinates
+    const ForceTransform& getForceTransformLinkBaseById(size_t linkId,
+        const typename JointState_t::Position& jointPosition)
+    {
+        return cache_->getForceTransformLinkBase(robcogen(), linkId, jointPosition);
     }
 
     FloatingBaseTransforms<RBD>& floatingBaseTransforms()
@@ -113,7 +154,7 @@ public:
     {
         Velocity3Tpl eeVelocityBase;
         eeVelocityBase.toImplementation() =
-            (robcogen().getJacobianBaseEEbyId(eeId, rbdState.jointPositions()) * rbdState.jointVelocities())
+            (getJacobianBaseEEbyId(eeId, rbdState.jointPositions()) * rbdState.jointVelocities())
                 .template bottomRows<3>();
 
         // add translational velocity induced by linear base motion
@@ -144,7 +185,7 @@ public:
      */
     Position3Tpl getEEPositionInBase(size_t eeID, const typename JointState_t::Position& jointPosition)
     {
-        return robcogen().getEEPositionInBase(eeID, jointPosition);
+        return Position3Tpl(getHomogeneousTransformBaseEEById(eeID, jointPosition).template topRightCorner<3, 1>());
     }
 
     /*!
@@ -156,7 +197,7 @@ public:
      */
     RigidBodyPoseTpl getEEPoseInBase(size_t eeID, const typename JointState_t::Position& jointPosition)
     {
-        return robcogen().getEEPoseInBase(eeID, jointPosition);
+        return RigidBodyPoseTpl(getHomogeneousTransformBaseEEById(eeID, jointPosition), RigidBodyPoseTpl::EULER);
     }
 
     /*!
@@ -164,7 +205,7 @@ public:
      */
     Matrix3Tpl getEERotInBase(size_t eeID, const typename JointState_t::Position& jointPosition)
     {
-        return robcogen().getEERotInBase(eeID, jointPosition);
+        return getHomogeneousTransformBaseEEById(eeID, jointPosition).template topLeftCorner<3, 3>();
     }
 
     /*!
@@ -310,7 +351,7 @@ public:
                            basePose.template rotateInertiaToBase<Vector3Tpl>(W_force.torque());
 
         // transform force to link on which endeffector sits on
-        return EEForce(robcogen().getForceTransformLinkBaseById(linkId, jointPosition) * B_force);
+        return EEForce(getForceTransformLinkBaseById(linkId, jointPosition) * B_force);
     }
 
     /**
@@ -354,7 +395,7 @@ public:
             B_x_EE.cross(B_force.force()) + T_B_EE.template rotateBaseToInertia<Vector3Tpl>(EE_force.torque());
 
         // transform force to link on which endeffector sits on
-        return EEForce(robcogen().getForceTransformLinkBaseById(linkId, jointPosition) * B_force);
+        return EEForce(getForceTransformLinkBaseById(linkId, jointPosition) * B_force);
     };
 
     RBD& robcogen() { return *rbdContainer_; }
@@ -364,6 +405,8 @@ private:
     FloatingBaseTransforms<RBD> floatingBaseTransforms_;
 
     std::unordered_map<size_t, std::shared_ptr<InverseKinematicsBase<NJOINTS, SCALAR>>> ikSolvers_;
+
+    std::shared_ptr<Cache_t> cache_;
 };
 
 } /* namespace rbd */
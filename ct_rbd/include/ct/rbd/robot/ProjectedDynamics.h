@@ -5,6 +5,11 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 
 #pragma once
 
+#include <stdexcept>
+#include <type_traits>
+
+#include <Eigen/Dense>
+
 #include <ct/rbd/robot/jacobian/ConstraintJacobian.h>
 #include <ct/rbd/robot/kinematics/RBDDataMap.h>
 #include <ct/rbd/robot/Kinematics.h>
@@ -50,6 +55,24 @@ public:
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> MatrixXs;
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> VectorXs;
 
+    //! contact quantities of the end-effectors in contact, sized at runtime but allocated on the stack
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, NDOF, Eigen::ColMajor, MAX_JAC_SIZE, NDOF> contact_jacobian_t;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1, Eigen::ColMajor, NDOF + MAX_JAC_SIZE, 1> qdd_lambda_vector_t;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1, Eigen::ColMajor, MAX_JAC_SIZE, 1> contact_vector_t;
+    typedef Eigen::Matrix<Scalar, NDOF, Eigen::Dynamic, Eigen::ColMajor, NDOF, MAX_JAC_SIZE> contact_jacobian_transposed_t;
+    typedef Eigen::Matrix<Scalar, NDOF, Eigen::Dynamic, Eigen::ColMajor, NDOF, NDOF> nullspace_basis_t;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, CONTROL_DIM, Eigen::ColMajor, NDOF, CONTROL_DIM>
+        projected_selection_t;
+
+    //! the null-space projection of the inverse dynamics is only cached for floating point types
+    static const bool CACHE_PROJECTION = std::is_floating_point<Scalar>::value;
+
+    /**
+     * selects the solution path: Eigen's decompositions branch on scalar values, hence auto-diff and code generation
+     * scalars use the comparison-free core::LDLTsolve instead
+     */
+    typedef std::integral_constant<bool, std::is_floating_point<Scalar>::value> floating_point_t;
+
     /**
 	 * @brief The Constructor
 	 * @param[in]	kyn     Robot Kinematics
@@ -69,6 +92,7 @@ public:
         ee_in_contact_ = eeinc;
         ResetJacobianStructure();
         setSizes();
+        projectionValid_ = false;
     }
 
     /**
@@ -135,6 +159,76 @@ public:
     }
 
 private:
+    /**
+     * @brief Solves for the contact forces with a range-space method
+     *
+     * Given the factorization M = L L^T and the unconstrained accelerations M^-1 (f - h), the contact forces follow
+     * from the small Schur complement
+     *      Jc M^-1 Jc^T lambda = -(dJcdt*qd + omega x v) - Jc M^-1 (f - h)
+     * and the accelerations from qdd = M^-1 (f - h + Jc^T lambda).
+     * The number of contacts NC is a template parameter, such that the Schur complement is a fixed size matrix.
+     */
+    template <size_t NC>
+    void solveContactForces(const RBDState_t& x, std::true_type);
+
+    //! the range-space method for non-floating point scalars, M^-1 Jc^T and the Schur complement are solved by LDLT
+    template <size_t NC>
+    void solveContactForces(const RBDState_t& x, std::false_type);
+
+    //! computes the unconstrained accelerations M^-1 (f - h), factorizing M for floating point scalars
+    void solveUnconstrained(std::true_type);
+    void solveUnconstrained(std::false_type);
+
+    //! dispatches the runtime number of end-effectors in contact to solveContactForces<NC>()
+    template <size_t NC>
+    typename std::enable_if<(NC <= NEE), void>::type dispatchContactForces(const RBDState_t& x)
+    {
+        if (neec_ == NC)
+            solveContactForces<NC>(x, floating_point_t());
+        else
+            dispatchContactForces<NC + 1>(x);
+    }
+
+    template <size_t NC>
+    typename std::enable_if<(NC > NEE), void>::type dispatchContactForces(const RBDState_t& x)
+    {
+        throw std::runtime_error("ProjectedDynamics: invalid number of end-effectors in contact.");
+    }
+
+    //! stacks the Jacobians of the end-effectors in contact into Jc_reduced_
+    void updateContactJacobian(const RBDState_t& x);
+
+    //! computes an orthonormal basis of the motions consistent with the contact constraints
+    void updateProjection(const RBDState_t& x);
+
+    //! solves N^T St tau = N^T (M*qdd + h) with the cached null-space basis N
+    void solveProjectedTorques(const RBDState_t& x,
+        const g_coordinate_vector_t& Mqddh,
+        control_vector_t& u,
+        std::true_type);
+
+    /**
+     * @brief solves the projected inverse dynamics without pivoting decompositions, for non-floating point scalars
+     *
+     * Uses the projector P = I - Jc^T (Jc Jc^T)^+ Jc and the minimum norm least-squares solution
+     * tau = (S P St)^+ S P (M*qdd + h). Both pseudo-inverses are applied by solveRangeSpace(), as S P St is singular
+     * for two or more point contacts of a floating base, e.g. since the base can rotate about the line through two
+     * feet.
+     */
+    void solveProjectedTorques(const RBDState_t& x,
+        const g_coordinate_vector_t& Mqddh,
+        control_vector_t& u,
+        std::false_type);
+
+    /**
+     * @brief minimum norm solution X = A^+ B for a symmetric positive semi-definite A and B in the range of A
+     *
+     * Iterated Tikhonov regularization X_k+1 = X_k + (A + eps I)^-1 (B - A X_k), with eps relative to the mean diagonal
+     * of A. The regularized matrix is positive definite, hence the LDLT decomposition needs no pivoting and no value
+     * comparisons, and the iterations remove the bias of the regularization in the range of A.
+     */
+    static MatrixXs solveRangeSpace(const MatrixXs& A, const MatrixXs& B);
+
     /// @brief Update M h & f terms of the dynamics equation
     void updateDynamicsTerms(const RBDState_t& x, const control_vector_t& u);
 
@@ -146,6 +240,9 @@ private:
      *      P (M*qdd + h) = P*St*tau
      *      with P Jc^T = 0
      *      The user is responsible for providing a constraint consistent acceleration
+     *
+     * The projector is represented by an orthonormal basis N of the null-space of Jc, i.e. P = N N^T, obtained from
+     * a QR decomposition of Jc^T. The torques are the minimum norm solution of N^T St tau = N^T (M*qdd + h).
      */
     void ProjectedInverseDynamicsCommon(const RBDState_t& x, const RBDAcceleration_t& qdd, control_vector_t& u);
 
@@ -171,17 +268,21 @@ private:
     g_coordinate_vector_t f_; /*!< The input force*/
     g_coordinate_vector_t h_; /*!< the c and g-forces */
 
-    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> MJTJ0_;
-    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> qddlambda_, b_;
-    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Jc_reduced_;
-    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> dJcdt_reduced_;
-    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> feet_crossproduct_;
+    qdd_lambda_vector_t qddlambda_;    /*!< The accelerations followed by the contact forces */
+    contact_jacobian_t Jc_reduced_;    /*!< The Jacobian of the end-effectors in contact */
+    contact_jacobian_t dJcdt_reduced_; /*!< The time derivative of Jc_reduced_ */
+    contact_vector_t feet_crossproduct_;
 
     tpl::ConstraintJacobian<Kinematics<RBD, NEE>, MAX_JAC_SIZE, NJOINTS, Scalar>
         Jc_; /*!< The Jacobian of the constraint */
 
-    inertia_matrix_t P_; /*!< The Projector */
-    Eigen::JacobiSVD<MatrixXs> svd_;
+    Eigen::LLT<inertia_matrix_t> M_llt_; /*!< The Cholesky factorization of the inertia matrix */
+
+    Eigen::ColPivHouseholderQR<contact_jacobian_transposed_t> JcT_qr_; /*!< The QR decomposition of Jc^T */
+    nullspace_basis_t N_; /*!< Orthonormal basis of the null-space of Jc */
+    Eigen::CompleteOrthogonalDecomposition<projected_selection_t> NtSt_cod_; /*!< The decomposition of N^T St */
+    bool projectionValid_ = false; /*!< true if the projection belongs to jointPositionsProjection_ */
+    typename JointState_t::Position jointPositionsProjection_;
 };
 
 template <class RBD, size_t NEE>
@@ -189,6 +290,7 @@ ProjectedDynamics<RBD, NEE>::ProjectedDynamics(const std::shared_ptr<Kinematics<
     const EE_in_contact_t ee_inc /*= EE_in_Contact_t(false)*/)
     : kinematics_(kyn), ee_in_contact_(ee_inc)
 {
+    Jc_.kinematics().setKinematicsCache(kinematics_->getKinematicsCache());
     setContactConfiguration(ee_inc);
 }
 
@@ -221,27 +323,105 @@ void ProjectedDynamics<RBD, NEE>::updateDynamicsTerms(const RBDState_t& x, const
     h_.template segment<NJOINTS>(6) += jForces_gravity;
 }
 
+template <class RBD, size_t NEE>
+void ProjectedDynamics<RBD, NEE>::updateContactJacobian(const RBDState_t& x)
+{
+    Jc_.updateState(x);
+    for (size_t i = 0; i < neec_; i++)
+        Jc_reduced_.template block<3, NDOF>(3 * i, 0) = Jc_.J().template block<3, NDOF>(3 * Jc_.ee_indices_[i], 0);
+}
+
+template <class RBD, size_t NEE>
+void ProjectedDynamics<RBD, NEE>::updateProjection(const RBDState_t& x)
+{
+    // the contact Jacobian in base coordinates only depends on the joint positions
+    if (CACHE_PROJECTION && projectionValid_ && x.joints().getPositions() == jointPositionsProjection_)
+        return;
+
+    updateContactJacobian(x);
+
+    // the trailing columns of Q span the orthogonal complement of the range of Jc^T
+    JcT_qr_.compute(Jc_reduced_.transpose());
+    inertia_matrix_t Q = JcT_qr_.householderQ();
+    N_ = Q.rightCols(NDOF - JcT_qr_.rank());
+
+    NtSt_cod_.compute(N_.transpose() * S_.transpose());
+
+    jointPositionsProjection_ = x.joints().getPositions();
+    projectionValid_ = true;
+}
+
 template <class RBD, size_t NEE>
 void ProjectedDynamics<RBD, NEE>::ProjectedInverseDynamicsCommon(const RBDState_t& x,
     const RBDAcceleration_t& qdd,
     control_vector_t& u)
 {
-    Jc_.updateState(x);
-    P_ = Jc_.P();
+    g_coordinate_vector_t Mqddh = M_ * qdd.toCoordinateAcceleration() + h_;
 
-    Eigen::Matrix<Scalar, NDOF, CONTROL_DIM> PSt = P_ * S_.transpose();
+    if (neec_ == 0)
+    {
+        // without contacts the projector is the identity and only the joint equations can be satisfied
+        u = S_ * Mqddh;
+        return;
+    }
 
-    svd_.compute(PSt, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    solveProjectedTorques(x, Mqddh, u, floating_point_t());
+}
 
-    VectorXs sing_values(svd_.matrixV().cols(), 1);  // size of E has same size as columns of V
-    sing_values = (svd_.singularValues().array() > 1e-9).select(svd_.singularValues().array().inverse(), 0);
-    selection_matrix_t Pstinv = svd_.matrixV() * sing_values.asDiagonal() * svd_.matrixU().transpose();
+template <class RBD, size_t NEE>
+void ProjectedDynamics<RBD, NEE>::solveProjectedTorques(const RBDState_t& x,
+    const g_coordinate_vector_t& Mqddh,
+    control_vector_t& u,
+    std::true_type)
+{
+    updateProjection(x);
+    u = NtSt_cod_.solve(N_.transpose() * Mqddh);
+}
 
-    selection_matrix_t PStP = Pstinv * P_;
+template <class RBD, size_t NEE>
+void ProjectedDynamics<RBD, NEE>::solveProjectedTorques(const RBDState_t& x,
+    const g_coordinate_vector_t& Mqddh,
+    control_vector_t& u,
+    std::false_type)
+{
+    updateContactJacobian(x);
 
-    g_coordinate_vector_t Mqdd = M_ * qdd.toCoordinateAcceleration();
+    MatrixXs JcJcT = Jc_reduced_ * Jc_reduced_.transpose();
+    MatrixXs JcJcTinvJc = solveRangeSpace(JcJcT, Jc_reduced_);
+    inertia_matrix_t P = inertia_matrix_t::Identity() - Jc_reduced_.transpose() * JcJcTinvJc;
 
-    u = PStP * (Mqdd + h_);
+    Eigen::Matrix<Scalar, CONTROL_DIM, NDOF> SP = S_ * P;
+    MatrixXs SPSt = SP * S_.transpose();
+    MatrixXs SPMqddh = SP * Mqddh;
+    u = solveRangeSpace(SPSt, SPMqddh);
+}
+
+template <class RBD, size_t NEE>
+typename ProjectedDynamics<RBD, NEE>::MatrixXs ProjectedDynamics<RBD, NEE>::solveRangeSpace(const MatrixXs& A,
+    const MatrixXs& B)
+{
+    const double relativeRegularization = 1e-4;
+    const size_t iterations = 8;
+
+    const int n = A.rows();
+    const Scalar epsilon = Scalar(relativeRegularization) * A.trace() / Scalar(double(n));
+    const MatrixXs Aregularized = A + epsilon * MatrixXs::Identity(n, n);
+
+    MatrixXs L(n, n);
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> d(n);
+    core::inverseHelperfunctions::ldlt<Scalar>(Aregularized, L, d);
+
+    MatrixXs X(n, B.cols());
+    MatrixXs dX(n, B.cols());
+    core::inverseHelperfunctions::solveLDLT<Scalar>(L, d, B, X);
+    for (size_t k = 1; k < iterations; k++)
+    {
+        const MatrixXs residual = B - A * X;
+        core::inverseHelperfunctions::solveLDLT<Scalar>(L, d, residual, dX);
+        X += dX;
+    }
+
+    return X;
 }
 
 template <class RBD, size_t NEE>
@@ -265,14 +445,73 @@ void ProjectedDynamics<RBD, NEE>::ProjectedForwardDynamicsCommon(const RBDState_
 
     // Set Dynamics
     updateDynamicsTerms(x, u);
-    MJTJ0_.template block<NDOF, NDOF>(0, 0) = M_;
-    MJTJ0_.template block(NDOF, 0, 3 * neec_, NDOF) = -Jc_reduced_;
-    MJTJ0_.template block(0, NDOF, NDOF, 3 * neec_) = -Jc_reduced_.transpose();
+    solveUnconstrained(floating_point_t());
+
+    if (neec_ > 0)
+        dispatchContactForces<1>(x);
+}
+
+template <class RBD, size_t NEE>
+void ProjectedDynamics<RBD, NEE>::solveUnconstrained(std::true_type)
+{
+    M_llt_.compute(M_);
+    qddlambda_.template head<NDOF>() = M_llt_.solve(f_ - h_);
+}
+
+template <class RBD, size_t NEE>
+void ProjectedDynamics<RBD, NEE>::solveUnconstrained(std::false_type)
+{
+    MatrixXs M = M_;
+    MatrixXs fh = f_ - h_;
+    qddlambda_.template head<NDOF>() = core::LDLTsolve<Scalar>(M, fh);
+}
+
+template <class RBD, size_t NEE>
+template <size_t NC>
+void ProjectedDynamics<RBD, NEE>::solveContactForces(const RBDState_t& x, std::true_type)
+{
+    static const size_t NC3 = 3 * NC;
+    typedef Eigen::Matrix<Scalar, NC3, NDOF> Jacobian_t;
+    typedef Eigen::Matrix<Scalar, NC3, 1> Vector_t;
+
+    Eigen::Map<const Jacobian_t> Jc(Jc_reduced_.data());
+    Eigen::Map<const Jacobian_t> dJcdt(dJcdt_reduced_.data());
+    Eigen::Map<const Vector_t> feet_crossproduct(feet_crossproduct_.data());
 
-    b_.template segment<NDOF>(0) = f_ - h_;
-    b_.template segment(NDOF, 3 * neec_) = dJcdt_reduced_ * x.toCoordinateVelocity() + feet_crossproduct_;
+    // Y = L^-1 Jc^T, such that the Schur complement is Jc M^-1 Jc^T = Y^T Y
+    Eigen::Matrix<Scalar, NDOF, NC3> Y = M_llt_.matrixL().solve(Jc.transpose());
+    Eigen::Matrix<Scalar, NC3, NC3> schur = Y.transpose() * Y;
 
-    qddlambda_ = core::LDLTsolve<Scalar>(MJTJ0_, b_);
+    Vector_t rhs = -(dJcdt * x.toCoordinateVelocity() + feet_crossproduct) - Jc * qddlambda_.template head<NDOF>();
+    Vector_t lambda = schur.llt().solve(rhs);
+
+    // M^-1 Jc^T lambda = L^-T Y lambda
+    qddlambda_.template head<NDOF>() += M_llt_.matrixU().solve(Y * lambda);
+    qddlambda_.template segment<NC3>(NDOF) = lambda;
+}
+
+template <class RBD, size_t NEE>
+template <size_t NC>
+void ProjectedDynamics<RBD, NEE>::solveContactForces(const RBDState_t& x, std::false_type)
+{
+    static const size_t NC3 = 3 * NC;
+    typedef Eigen::Matrix<Scalar, NC3, NDOF> Jacobian_t;
+    typedef Eigen::Matrix<Scalar, NC3, 1> Vector_t;
+
+    Eigen::Map<const Jacobian_t> Jc(Jc_reduced_.data());
+    Eigen::Map<const Jacobian_t> dJcdt(dJcdt_reduced_.data());
+    Eigen::Map<const Vector_t> feet_crossproduct(feet_crossproduct_.data());
+
+    MatrixXs M = M_;
+    MatrixXs JcT = Jc.transpose();
+    Eigen::Matrix<Scalar, NDOF, NC3> MinvJcT = core::LDLTsolve<Scalar>(M, JcT);
+    MatrixXs schur = Jc * MinvJcT;
+
+    MatrixXs rhs = -(dJcdt * x.toCoordinateVelocity() + feet_crossproduct) - Jc * qddlambda_.template head<NDOF>();
+    Vector_t lambda = core::LDLTsolve<Scalar>(schur, rhs);
+
+    qddlambda_.template head<NDOF>() += MinvJcT * lambda;
+    qddlambda_.template segment<NC3>(NDOF) = lambda;
 }
 
 template <class RBD, size_t NEE>
@@ -284,13 +523,12 @@ void ProjectedDynamics<RBD, NEE>::ResetJacobianStructure()
 
     for (size_t eeinc = 0; eeinc < NEE; eeinc++)
     {
+        Jc_.eeInContact_[eeinc] = ee_in_contact_[eeinc];
         if (ee_in_contact_[eeinc])
         {
             neec_++;
             Jc_.c_size_ += 3;
             Jc_.ee_indices_.push_back(eeinc);
-
-            Jc_.eeInContact_[eeinc] = ee_in_contact_[eeinc];
         }
     }
 }
@@ -302,9 +540,6 @@ void ProjectedDynamics<RBD, NEE>::setSizes()
     dJcdt_reduced_.resize(3 * neec_, NDOF);
     feet_crossproduct_.resize(3 * neec_);
 
-    MJTJ0_.resize(NDOF + 3 * neec_, NDOF + 3 * neec_);
-    MJTJ0_.setZero();
-    b_.resize(NDOF + 3 * neec_);
     qddlambda_.resize(NDOF + 3 * neec_);
 
     S_.template block<CONTROL_DIM, 6>(0, 0).setZero();
@@ -0,0 +1,260 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#ifdef CPPADCG
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ct/core/core.h>
+
+#include "RBDCodegenKernels.h"
+
+namespace ct {
+namespace rbd {
+
+/*!
+ * \brief Generates the source code of the standard kernels of a RobCoGen robot
+ *
+ * The following kernels are available (see RBDCodegenKernels for the underlying functions):
+ *
+ * | kernel               | generated class                                     |
+ * |----------------------|-----------------------------------------------------|
+ * | ForwardZero          | forward dynamics including the contact model        |
+ * | InverseDynJacForward | Jacobian of the inverse dynamics, forward mode AD   |
+ * | InverseDynJacReverse | Jacobian of the inverse dynamics, reverse mode AD   |
+ * | ForwardKinJacForward | Jacobian of the forward kinematics, forward mode AD |
+ * | ForwardKinJacReverse | Jacobian of the forward kinematics, reverse mode AD |
+ * | LinearizedForward    | linearization of the forward dynamics, forward mode |
+ * | LinearizedReverse    | linearization of the forward dynamics, reverse mode |
+ *
+ * The class of kernel K is named <name>K and written to <outputDir>/<name>K.h and <outputDir>/<name>K.cpp.
+ *
+ * Generation is incremental: the fingerprint of the model and the code templates is stored for every kernel in
+ * <outputDir>/<name>Codegen.hash and kernels are only regenerated if their fingerprint changed or their files are
+ * missing.
+ *
+ * A generator executable typically consists of
+ *
+ * \code{.cpp}
+ * int main(int argc, char* argv[])
+ * {
+ *     ct::rbd::RBDCodegen<ct::rbd::MyRobot::tpl::Dynamics> codegen("MyRobot");
+ *     codegen.contactModelSettings().k = 3000.0;
+ *     return codegen.run(argc, argv);
+ * }
+ * \endcode
+ *
+ * and is built and executed by the CMake function ct_rbd_add_codegen(), which also compiles the generated kernels
+ * into a library.
+ *
+ * \tparam DYNAMICS the robot dynamics templated on the scalar type, e.g. ct::rbd::HyQ::tpl::Dynamics
+ */
+template <template <typename> class DYNAMICS>
+class RBDCodegen : public RBDCodegenKernels<DYNAMICS>
+{
+public:
+    typedef RBDCodegenKernels<DYNAMICS> Kernels;
+    typedef CppAD::AD<CppAD::cg::CG<double>> ADCGScalar;
+
+    /*!
+     * \brief Constructor
+     * @param name prefix of the generated classes and files
+     * @param ns1 first namespace layer of the generated classes
+     * @param ns2 second namespace layer of the generated classes, defaults to name
+     * @param templateDir directory of the code templates
+     */
+    RBDCodegen(const std::string& name,
+        const std::string& ns1 = "models",
+        const std::string& ns2 = "",
+        const std::string& templateDir = ct::core::CODEGEN_TEMPLATE_DIR)
+        : name_(name), ns1_(ns1), ns2_(ns2.empty() ? name : ns2), templateDir_(templateDir)
+    {
+    }
+
+    //! the names of all available kernels
+    static std::vector<std::string> kernelNames()
+    {
+        return {"ForwardZero", "InverseDynJacForward", "InverseDynJacReverse", "ForwardKinJacForward",
+            "ForwardKinJacReverse", "LinearizedForward", "LinearizedReverse"};
+    }
+
+    /*!
+     * \brief Generates the source code of the kernels which are not up to date
+     * @param outputDir the directory the code is written to
+     * @param kernels the kernels to generate, all kernels if empty
+     * @param force regenerate all kernels, even if they are up to date
+     * @return the number of generated kernels
+     */
+    size_t generate(const std::string& outputDir,
+        const std::vector<std::string>& kernels = std::vector<std::string>(),
+        bool force = false)
+    {
+        const std::vector<std::string> requested = kernels.empty() ? kernelNames() : kernels;
+        const std::string hashFile = outputDir + "/" + name_ + "Codegen.hash";
+        const std::string fingerprint = toHex(codeFingerprint());
+
+        std::map<std::string, std::string> hashes = readHashes(hashFile);
+
+        size_t generated = 0;
+        for (const std::string& kernel : requested)
+        {
+            const std::string className = name_ + kernel;
+            const auto hash = hashes.find(kernel);
+            if (!force && hash != hashes.end() && hash->second == fingerprint &&
+                exists(outputDir + "/" + className + ".h") && exists(outputDir + "/" + className + ".cpp"))
+            {
+                std::cout << className << " is up to date" << std::endl;
+                continue;
+            }
+
+            std::cout << "Generating " << className << "..." << std::endl;
+            generateKernel(kernel, className, outputDir);
+            hashes[kernel] = fingerprint;
+            writeHashes(hashFile, hashes);
+            generated++;
+        }
+
+        return generated;
+    }
+
+    /*!
+     * \brief Entry point for generator executables
+     *
+     * Usage: <generator> <outputDir> [--force] [kernel ...]
+     *
+     * @return 0 on success, 1 on failure
+     */
+    int run(int argc, char* argv[])
+    {
+        if (argc < 2)
+        {
+            std::cerr << "usage: " << argv[0] << " <outputDir> [--force] [kernel ...]" << std::endl;
+            return 1;
+        }
+
+        bool force = false;
+        std::vector<std::string> kernels;
+        for (int i = 2; i < argc; i++)
+        {
+            if (std::string(argv[i]) == "--force")
+                force = true;
+            else
+                kernels.push_back(argv[i]);
+        }
+
+        try
+        {
+            generate(argv[1], kernels, force);
+        } catch (const std::exception& e)
+        {
+            std::cerr << name_ << " code generation failed: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    //! the fingerprint of the model, the kernel settings and the code templates
+    uint64_t codeFingerprint() const
+    {
+        uint64_t h = Kernels::hash(ns1_ + "::" + ns2_, this->fingerprint());
+        for (const std::string& tpl : {"/ForwardZero.tpl.h", "/ForwardZero.tpl.cpp", "/Jacobian.tpl.h",
+                 "/Jacobian.tpl.cpp", "/LinearSystem.tpl.h", "/LinearSystem.tpl.cpp"})
+        {
+            h = Kernels::hash(core::internal::CGHelpers::parseFile(templateDir_ + tpl), h);
+        }
+        return h;
+    }
+
+private:
+    typedef core::DerivativesCppadCG<Kernels::ID_IN_DIM, Kernels::ID_OUT_DIM> InverseDynamicsCG;
+    typedef core::DerivativesCppadCG<Kernels::FK_IN_DIM, Kernels::FK_OUT_DIM> ForwardKinematicsCG;
+    typedef core::DerivativesCppadCG<Kernels::FD_IN_DIM, Kernels::FD_OUT_DIM> ForwardDynamicsCG;
+
+    void generateKernel(const std::string& kernel, const std::string& className, const std::string& outputDir)
+    {
+        const bool useReverse = (kernel.size() > 7 && kernel.compare(kernel.size() - 7, 7, "Reverse") == 0);
+
+        if (kernel == "ForwardZero")
+        {
+            typename ForwardDynamicsCG::FUN_TYPE_CG f = [this](const typename ForwardDynamicsCG::IN_TYPE_CG& x) {
+                return this->template forwardDynamics<ADCGScalar>(x);
+            };
+            ForwardDynamicsCG derivatives(f);
+            derivatives.generateForwardZeroSource(className, outputDir, templateDir_, ns1_, ns2_, false);
+        }
+        else if (kernel == "InverseDynJacForward" || kernel == "InverseDynJacReverse")
+        {
+            typename InverseDynamicsCG::FUN_TYPE_CG f = [](const typename InverseDynamicsCG::IN_TYPE_CG& x) {
+                return Kernels::template inverseDynamics<ADCGScalar>(x);
+            };
+            InverseDynamicsCG derivatives(f);
+            derivatives.generateJacobianSource(className, outputDir, templateDir_, ns1_, ns2_,
+                InverseDynamicsCG::Sparsity::Ones(), useReverse);
+        }
+        else if (kernel == "ForwardKinJacForward" || kernel == "ForwardKinJacReverse")
+        {
+            typename ForwardKinematicsCG::FUN_TYPE_CG f = [](const typename ForwardKinematicsCG::IN_TYPE_CG& x) {
+                return Kernels::template forwardKinematics<ADCGScalar>(x);
+            };
+            ForwardKinematicsCG derivatives(f);
+            derivatives.generateJacobianSource(className, outputDir, templateDir_, ns1_, ns2_,
+                ForwardKinematicsCG::Sparsity::Ones(), useReverse);
+        }
+        else if (kernel == "LinearizedForward" || kernel == "LinearizedReverse")
+        {
+            core::ADCodegenLinearizer<Kernels::STATE_DIM, Kernels::CONTROL_DIM> linearizer(
+                this->template createSystem<ADCGScalar>());
+            linearizer.generateCode(className, outputDir, templateDir_, ns1_, ns2_, useReverse);
+        }
+        else
+            throw std::runtime_error("RBDCodegen: unknown kernel " + kernel);
+    }
+
+    static bool exists(const std::string& file) { return std::ifstream(file).good(); }
+    static std::string toHex(uint64_t value)
+    {
+        std::ostringstream stream;
+        stream << std::hex << value;
+        return stream.str();
+    }
+
+    //! reads the kernel fingerprints, one "<kernel> <fingerprint>" pair per line
+    static std::map<std::string, std::string> readHashes(const std::string& file)
+    {
+        std::map<std::string, std::string> hashes;
+        std::ifstream stream(file);
+        std::string kernel, fingerprint;
+        while (stream >> kernel >> fingerprint)
+            hashes[kernel] = fingerprint;
+        return hashes;
+    }
+
+    static void writeHashes(const std::string& file, const std::map<std::string, std::string>& hashes)
+    {
+        std::ofstream stream(file);
+        if (!stream.good())
+            throw std::runtime_error("RBDCodegen: could not write " + file);
+        for (const auto& entry : hashes)
+            stream << entry.first << " " << entry.second << std::endl;
+    }
+
+    std::string name_;
+    std::string ns1_;
+    std::string ns2_;
+    std::string templateDir_;
+};
+
+}  // namespace rbd
+}  // namespace ct
+
+#endif
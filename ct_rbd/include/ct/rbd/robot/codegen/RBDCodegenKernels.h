@@ -0,0 +1,276 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include <ct/rbd/physics/EEContactModel.h>
+#include <ct/rbd/state/JointAcceleration.h>
+#include <ct/rbd/state/JointState.h>
+#include <ct/rbd/state/RBDState.h>
+#include <ct/rbd/state/RigidBodyAcceleration.h>
+#include <ct/rbd/systems/FixBaseFDSystem.h>
+#include <ct/rbd/systems/FloatingBaseFDSystem.h>
+
+namespace ct {
+namespace rbd {
+
+/*!
+ * \brief The functions of a RobCoGen robot which are typically code generated
+ *
+ * All kernels map a single input vector to a single output vector and are templated on the scalar type, such that
+ * they can be taped by CppAD. They are defined for fixed and floating base robots:
+ *
+ * - inverseDynamics(): input [state, generalized accelerations], output generalized forces. For floating base robots
+ *   the generalized forces consist of the base wrench followed by the joint torques.
+ * - forwardKinematics(): input state, output position and velocity of all end-effectors in the world frame.
+ * - forwardDynamics(): input [state, control, time], output state derivative including the contact model.
+ *
+ * Floating base states are parametrized with Euler angles (see RBDState::toStateVectorEulerXyz()).
+ *
+ * \tparam DYNAMICS the robot dynamics templated on the scalar type, e.g. ct::rbd::HyQ::tpl::Dynamics
+ */
+template <template <typename> class DYNAMICS>
+class RBDCodegenKernels
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef DYNAMICS<double> Dynamics_t;
+
+    static const bool FB = Dynamics_t::FB;
+    static const size_t NJOINTS = Dynamics_t::NJOINTS;
+    static const size_t NEE = Dynamics_t::N_EE;
+    static const size_t NDOF = NJOINTS + 6 * FB;
+
+    //! the forward dynamic system of the robot
+    template <typename SCALAR>
+    using System = typename std::conditional<FB,
+        FloatingBaseFDSystem<DYNAMICS<SCALAR>, false>,
+        FixBaseFDSystem<DYNAMICS<SCALAR>>>::type;
+
+    template <typename SCALAR>
+    using ContactModel = EEContactModel<typename DYNAMICS<SCALAR>::Kinematics_t>;
+
+    static const size_t STATE_DIM = System<double>::STATE_DIM;
+    static const size_t CONTROL_DIM = System<double>::CONTROL_DIM;
+
+    static const size_t ID_IN_DIM = STATE_DIM + NDOF;
+    static const size_t ID_OUT_DIM = NDOF;
+    static const size_t FK_IN_DIM = STATE_DIM;
+    static const size_t FK_OUT_DIM = 6 * NEE;
+    static const size_t FD_IN_DIM = STATE_DIM + CONTROL_DIM + 1;
+    static const size_t FD_OUT_DIM = STATE_DIM;
+
+    //! parameters of the contact model used in the forward dynamics of floating base robots
+    struct ContactModelSettings
+    {
+        bool enabled = true;  //!< if false, the forward dynamics do not include contacts
+        double k = 5000.0;
+        double d = 1000.0;
+        double alpha = 100.0;
+        double alpha_n = 100.0;
+        double zOffset = -0.02;
+        typename ContactModel<double>::VELOCITY_SMOOTHING smoothing = ContactModel<double>::SIGMOID;
+    };
+
+    //! the contact model settings, only used for floating base robots
+    ContactModelSettings& contactModelSettings() { return contactModelSettings_; }
+    const ContactModelSettings& contactModelSettings() const { return contactModelSettings_; }
+
+    //! inverse dynamics, maps [state, generalized accelerations] to the generalized forces
+    template <typename SCALAR>
+    static Eigen::Matrix<SCALAR, ID_OUT_DIM, 1> inverseDynamics(const Eigen::Matrix<SCALAR, ID_IN_DIM, 1>& x)
+    {
+        DYNAMICS<SCALAR> dynamics;
+        return inverseDynamics<SCALAR>(x, dynamics);
+    }
+
+    //! inverse dynamics evaluated with an existing dynamics instance, which avoids its construction
+    template <typename SCALAR>
+    static Eigen::Matrix<SCALAR, ID_OUT_DIM, 1> inverseDynamics(const Eigen::Matrix<SCALAR, ID_IN_DIM, 1>& x,
+        DYNAMICS<SCALAR>& dynamics)
+    {
+        return inverseDynamics<SCALAR>(x, dynamics, std::integral_constant<bool, FB>());
+    }
+
+    //! forward kinematics, maps the state to the positions and velocities of all end-effectors
+    template <typename SCALAR>
+    static Eigen::Matrix<SCALAR, FK_OUT_DIM, 1> forwardKinematics(const Eigen::Matrix<SCALAR, FK_IN_DIM, 1>& x)
+    {
+        typename DYNAMICS<SCALAR>::Kinematics_t kinematics;
+        return forwardKinematics<SCALAR>(x, kinematics);
+    }
+
+    //! forward kinematics evaluated with an existing kinematics instance, which avoids its construction
+    template <typename SCALAR>
+    static Eigen::Matrix<SCALAR, FK_OUT_DIM, 1> forwardKinematics(const Eigen::Matrix<SCALAR, FK_IN_DIM, 1>& x,
+        typename DYNAMICS<SCALAR>::Kinematics_t& kinematics)
+    {
+        RBDState<NJOINTS, SCALAR> state =
+            toRBDState<SCALAR>(x.template head<STATE_DIM>(), std::integral_constant<bool, FB>());
+
+        Eigen::Matrix<SCALAR, FK_OUT_DIM, 1> y;
+        for (size_t i = 0; i < NEE; i++)
+        {
+            y.template segment<3>(6 * i) =
+                kinematics.getEEPositionInWorld(i, state.basePose(), state.jointPositions()).toImplementation();
+            y.template segment<3>(6 * i + 3) = kinematics.getEEVelocityInWorld(i, state).toImplementation();
+        }
+        return y;
+    }
+
+    //! forward dynamics, maps [state, control, time] to the state derivative
+    template <typename SCALAR>
+    Eigen::Matrix<SCALAR, FD_OUT_DIM, 1> forwardDynamics(const Eigen::Matrix<SCALAR, FD_IN_DIM, 1>& x) const
+    {
+        std::shared_ptr<System<SCALAR>> system = createSystem<SCALAR>();
+
+        ct::core::StateVector<STATE_DIM, SCALAR> y;
+        system->computeControlledDynamics(
+            x.template head<STATE_DIM>(), x(FD_IN_DIM - 1), x.template segment<CONTROL_DIM>(STATE_DIM), y);
+        return y;
+    }
+
+    //! creates the forward dynamic system, including the contact model for floating base robots
+    template <typename SCALAR>
+    std::shared_ptr<System<SCALAR>> createSystem() const
+    {
+        std::shared_ptr<System<SCALAR>> system(new System<SCALAR>);
+        addContactModel<SCALAR>(*system, std::integral_constant<bool, FB>());
+        return system;
+    }
+
+    /*!
+     * \brief A fingerprint of the robot model and the kernel settings
+     *
+     * RobCoGen models do not expose their parameters, hence the fingerprint is computed from the kernel outputs at a
+     * fixed set of inputs. Any change to the kinematic or inertial parameters, the end-effectors or the contact model
+     * changes the fingerprint, such that generated code can be identified as outdated. Outputs are rounded to ten
+     * significant digits to be insensitive to different compiler optimizations.
+     */
+    uint64_t fingerprint() const
+    {
+        std::ostringstream stream;
+        stream << std::setprecision(10) << FB << " " << NJOINTS << " " << NEE << " " << STATE_DIM << " "
+               << CONTROL_DIM << " ";
+        if (FB)
+        {
+            const ContactModelSettings& s = contactModelSettings_;
+            stream << s.enabled << " " << s.k << " " << s.d << " " << s.alpha << " " << s.alpha_n << " " << s.zOffset
+                   << " " << s.smoothing << " ";
+        }
+
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        auto random = [&](double) { return distribution(generator); };
+
+        for (size_t n = 0; n < 3; n++)
+        {
+            Eigen::Matrix<double, ID_IN_DIM, 1> xId = Eigen::Matrix<double, ID_IN_DIM, 1>::Zero().unaryExpr(random);
+            Eigen::Matrix<double, FK_IN_DIM, 1> xFk = Eigen::Matrix<double, FK_IN_DIM, 1>::Zero().unaryExpr(random);
+            Eigen::Matrix<double, FD_IN_DIM, 1> xFd = Eigen::Matrix<double, FD_IN_DIM, 1>::Zero().unaryExpr(random);
+
+            stream << inverseDynamics(xId).transpose() << " " << forwardKinematics(xFk).transpose() << " "
+                   << forwardDynamics(xFd).transpose() << " ";
+        }
+
+        return hash(stream.str());
+    }
+
+    //! 64 bit FNV-1a hash of a string
+    static uint64_t hash(const std::string& data, uint64_t h = 14695981039346656037ull)
+    {
+        for (const char c : data)
+        {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+private:
+    template <typename SCALAR>
+    static Eigen::Matrix<SCALAR, ID_OUT_DIM, 1> inverseDynamics(const Eigen::Matrix<SCALAR, ID_IN_DIM, 1>& x,
+        DYNAMICS<SCALAR>& dynamics,
+        std::true_type)
+    {
+        RBDState<NJOINTS, SCALAR> state = toRBDState<SCALAR>(x.template head<STATE_DIM>(), std::true_type());
+        tpl::RigidBodyAcceleration<SCALAR> base_a(x.template segment<6>(STATE_DIM));
+        JointAcceleration<NJOINTS, SCALAR> qdd(x.template tail<NJOINTS>());
+        typename DYNAMICS<SCALAR>::ExtLinkForces_t fext(Eigen::Matrix<SCALAR, 6, 1>::Zero());
+
+        typename DYNAMICS<SCALAR>::ForceVector_t base_w;
+        typename DYNAMICS<SCALAR>::control_vector_t u;
+        dynamics.FloatingBaseFullyActuatedID(state, base_a, qdd, fext, base_w, u);
+
+        Eigen::Matrix<SCALAR, ID_OUT_DIM, 1> y;
+        y << base_w, u;
+        return y;
+    }
+
+    template <typename SCALAR>
+    static Eigen::Matrix<SCALAR, ID_OUT_DIM, 1> inverseDynamics(const Eigen::Matrix<SCALAR, ID_IN_DIM, 1>& x,
+        DYNAMICS<SCALAR>& dynamics,
+        std::false_type)
+    {
+        JointState<NJOINTS, SCALAR> state(x.template head<STATE_DIM>());
+        JointAcceleration<NJOINTS, SCALAR> qdd(x.template tail<NJOINTS>());
+        typename DYNAMICS<SCALAR>::ExtLinkForces_t fext(Eigen::Matrix<SCALAR, 6, 1>::Zero());
+
+        typename DYNAMICS<SCALAR>::control_vector_t u;
+        dynamics.FixBaseID(state, qdd, fext, u);
+        return u;
+    }
+
+    template <typename SCALAR>
+    static RBDState<NJOINTS, SCALAR> toRBDState(const Eigen::Matrix<SCALAR, STATE_DIM, 1>& x, std::true_type)
+    {
+        RBDState<NJOINTS, SCALAR> state;
+        state.fromStateVectorEulerXyz(x);
+        return state;
+    }
+
+    template <typename SCALAR>
+    static RBDState<NJOINTS, SCALAR> toRBDState(const Eigen::Matrix<SCALAR, STATE_DIM, 1>& x, std::false_type)
+    {
+        RBDState<NJOINTS, SCALAR> state;
+        state.setZero();
+        state.joints() = JointState<NJOINTS, SCALAR>(x);
+        return state;
+    }
+
+    template <typename SCALAR>
+    void addContactModel(System<SCALAR>& system, std::true_type) const
+    {
+        if (!contactModelSettings_.enabled)
+            return;
+
+        // share the kinematics of the system, which allows the code generator to reuse common subexpressions
+        const ContactModelSettings& s = contactModelSettings_;
+        std::shared_ptr<ContactModel<SCALAR>> contactModel(new ContactModel<SCALAR>(SCALAR(s.k), SCALAR(s.d),
+            SCALAR(s.alpha), SCALAR(s.alpha_n), SCALAR(s.zOffset),
+            static_cast<typename ContactModel<SCALAR>::VELOCITY_SMOOTHING>(s.smoothing),
+            system.dynamics().kinematicsPtr()));
+        system.setContactModel(contactModel);
+    }
+
+    template <typename SCALAR>
+    void addContactModel(System<SCALAR>& system, std::false_type) const
+    {
+    }
+
+    ContactModelSettings contactModelSettings_;
+};
+
+}  // namespace rbd
+}  // namespace ct
@@ -109,7 +109,7 @@ public:
     TermTaskspaceGeometricJacobian(const TermTaskspaceGeometricJacobian& arg)
         : BASE(arg),
           eeInd_(arg.eeInd_),
-          kinematics_(KINEMATICS()),
+          kinematics_(arg.kinematics_),
           Q_pos_(arg.Q_pos_),
           Q_rot_(arg.Q_rot_),
           x_ref_(arg.x_ref_),
@@ -126,6 +126,12 @@ public:
         return new TermTaskspaceGeometricJacobian(*this);
     }
 
+    //! use a different kinematics cache than the default cache of the robot, clones of this term keep it
+    void setKinematicsCache(const std::shared_ptr<typename KINEMATICS::Cache_t>& cache)
+    {
+        kinematics_.setKinematicsCache(cache);
+    }
+
     //! evaluate
     virtual double evaluate(const Eigen::Matrix<double, STATE_DIM, 1>& x,
         const Eigen::Matrix<double, CONTROL_DIM, 1>& u,
@@ -104,7 +104,7 @@ public:
     TermTaskspacePose(const TermTaskspacePose& arg)
         : BASE(arg),
           eeInd_(arg.eeInd_),
-          kinematics_(KINEMATICS()),
+          kinematics_(arg.kinematics_),
           Q_pos_(arg.Q_pos_),
           Q_rot_(arg.Q_rot_),
           w_p_ref_(arg.w_p_ref_),
@@ -120,6 +120,12 @@ public:
         return new TermTaskspacePose(*this);
     }
 
+    //! use a different kinematics cache than the default cache of the robot, clones of this term keep it
+    void setKinematicsCache(const std::shared_ptr<typename KINEMATICS::Cache_t>& cache)
+    {
+        kinematics_.setKinematicsCache(cache);
+    }
+
     //! evaluate
     virtual SCALAR evaluate(const Eigen::Matrix<SCALAR, STATE_DIM, 1>& x,
         const Eigen::Matrix<SCALAR, CONTROL_DIM, 1>& u,
@@ -143,7 +143,7 @@ public:
     TermTaskspacePoseCG(const TermTaskspacePoseCG& arg)
         : BASE(arg),
           eeInd_(arg.eeInd_),
-          kinematics_(KINEMATICS()),
+          kinematics_(arg.kinematics_),
           Q_pos_(arg.Q_pos_),
           Q_rot_(arg.Q_rot_),
           costFun_(arg.costFun_),
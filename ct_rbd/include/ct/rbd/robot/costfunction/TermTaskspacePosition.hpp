@@ -68,7 +68,7 @@ public:
 
     //! copy constructor
     TermTaskspacePosition(const TermTaskspacePosition& arg)
-        : eeInd_(arg.eeInd_), kinematics_(KINEMATICS()), QTaskSpace_(arg.QTaskSpace_), pos_ref_(arg.pos_ref_)
+        : eeInd_(arg.eeInd_), kinematics_(arg.kinematics_), QTaskSpace_(arg.QTaskSpace_), pos_ref_(arg.pos_ref_)
     {
     }
 
@@ -79,6 +79,13 @@ public:
     {
         return new TermTaskspacePosition(*this);
     }
+
+    //! use a different kinematics cache than the default cache of the robot, clones of this term keep it
+    void setKinematicsCache(const std::shared_ptr<typename KINEMATICS::Cache_t>& cache)
+    {
+        kinematics_.setKinematicsCache(cache);
+    }
+
     virtual SCALAR evaluate(const Eigen::Matrix<SCALAR, STATE_DIM, 1>& x,
         const Eigen::Matrix<SCALAR, CONTROL_DIM, 1>& u,
         const SCALAR& t) override
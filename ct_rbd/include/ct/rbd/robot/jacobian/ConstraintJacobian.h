@@ -91,8 +91,7 @@ public:
             if (eeInContact_[ee_indices_[ee]])
             {
                 // Collect current contact Jacobians
-                Jc_geometric =
-                    kinematics_.robcogen().getJacobianBaseEEbyId(ee_indices_[ee], state.joints().getPositions());
+                Jc_geometric = kinematics_.getJacobianBaseEEbyId(ee_indices_[ee], state.joints().getPositions());
                 Jc_Rotational = Jc_geometric.template topRows<3>();
                 Jc_Translational = Jc_geometric.template bottomRows<3>();
 
@@ -143,8 +142,7 @@ public:
                 kindr::Position<SCALAR, 3> eePosition =
                     kinematics_.getEEPositionInBase(ee_indices_[ee], state.joints().getPositions());
                 Eigen::Matrix<SCALAR, 3, NJOINTS> J_single =
-                    kinematics_.robcogen()
-                        .getJacobianBaseEEbyId(ee_indices_[ee], state.joints().getPositions())
+                    kinematics_.getJacobianBaseEEbyId(ee_indices_[ee], state.joints().getPositions())
                         .template bottomRows<3>();
                 FrameJacobian<NJOINTS, SCALAR>::FromBaseJacToInertiaJacTranslation(
                     Matrix3s::Identity(), eePosition.toImplementation(), J_single, J_eeId);
@@ -153,6 +151,8 @@ public:
         }
     }
 
+    //! the kinematics used to compute the Jacobians, e.g. to share a kinematics cache
+    Kinematics& kinematics() { return kinematics_; }
 
 private:
     Kinematics kinematics_;
@@ -0,0 +1,265 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ct {
+namespace rbd {
+
+/**
+ * \brief End-effector poses and Jacobians of a batch of joint configurations
+ *
+ * The results are stored in a structure-of-arrays layout: every row holds one component (e.g. the x-coordinate of
+ * an end-effector position) for all configurations of the batch. Hence, downstream computations over all
+ * configurations, e.g. sampling-based planners or collision checks, can operate on contiguous rows.
+ *
+ * Rotation matrices and Jacobians are flattened in column-major order, i.e. the entry (r, c) of the rotation matrix
+ * is stored in row 3 * c + r and the entry (r, c) of the Jacobian in row 6 * c + r.
+ */
+template <size_t NJOINTS, size_t N_EE, typename SCALAR = double>
+struct BatchKinematicsResult
+{
+    using Positions = Eigen::Matrix<SCALAR, 3, Eigen::Dynamic, Eigen::RowMajor>;
+    using Rotations = Eigen::Matrix<SCALAR, 9, Eigen::Dynamic, Eigen::RowMajor>;
+    using Jacobians = Eigen::Matrix<SCALAR, 6 * NJOINTS, Eigen::Dynamic, Eigen::RowMajor>;
+
+    //! resizes all entries to the number of configurations
+    void resize(size_t n, bool withJacobians)
+    {
+        for (size_t i = 0; i < N_EE; i++)
+        {
+            positions[i].resize(3, n);
+            rotations[i].resize(9, n);
+            jacobians[i].resize(6 * NJOINTS, withJacobians ? n : 0);
+        }
+    }
+
+    //! number of configurations in the batch
+    size_t size() const { return N_EE > 0 ? positions[0].cols() : 0; }
+    //! the position of an end-effector in base coordinates for configuration k
+    Eigen::Matrix<SCALAR, 3, 1> position(size_t eeId, size_t k) const { return positions[eeId].col(k); }
+    //! the rotation from end-effector to base coordinates for configuration k
+    Eigen::Matrix<SCALAR, 3, 3> rotation(size_t eeId, size_t k) const
+    {
+        Eigen::Matrix<SCALAR, 9, 1> column = rotations[eeId].col(k);
+        return Eigen::Map<const Eigen::Matrix<SCALAR, 3, 3>>(column.data());
+    }
+
+    //! the geometric Jacobian of an end-effector in base coordinates for configuration k
+    Eigen::Matrix<SCALAR, 6, NJOINTS> jacobian(size_t eeId, size_t k) const
+    {
+        Eigen::Matrix<SCALAR, 6 * NJOINTS, 1> column = jacobians[eeId].col(k);
+        return Eigen::Map<const Eigen::Matrix<SCALAR, 6, NJOINTS>>(column.data());
+    }
+
+    std::array<Positions, N_EE> positions;  //!< end-effector positions in base coordinates
+    std::array<Rotations, N_EE> rotations;  //!< end-effector rotations to base coordinates
+    std::array<Jacobians, N_EE> jacobians;  //!< geometric end-effector Jacobians, empty if not computed
+};
+
+/**
+ * \brief Evaluates the forward kinematics and Jacobians for many joint configurations at once
+ *
+ * Kinematics evaluates a single joint configuration per call, which dominates the runtime of sampling-based
+ * planners, workspace analysis or multi-start inverse kinematics. This class evaluates a whole batch of
+ * configurations given as columns of a matrix and writes the results in a structure-of-arrays layout (see
+ * BatchKinematicsResult). The configurations are evaluated one by one with the scalar RobCoGen transforms.
+ *
+ * Large batches are split into contiguous chunks which are evaluated in parallel by a pool of worker threads, which
+ * are started once in the constructor and reused for every batch. Since the RobCoGen containers store intermediate
+ * results, every thread uses its own copy of the kinematics. Small batches are evaluated on the calling thread only.
+ *
+ * \note compute() must not be called concurrently on the same instance
+ *
+ * \code{.cpp}
+ * using Batch = ct::rbd::BatchKinematics<TestHyQ::Kinematics>;
+ * Batch batch;
+ * Batch::JointPositions q = Batch::JointPositions::Random(TestHyQ::Kinematics::NJOINTS, 10000);
+ * Batch::Result result;
+ * batch.compute(q, result);
+ * \endcode
+ *
+ * \tparam KINEMATICS the kinematics of the robot, e.g. ct::rbd::Kinematics
+ */
+template <class KINEMATICS>
+class BatchKinematics
+{
+public:
+    static const size_t NJOINTS = KINEMATICS::NJOINTS;
+    static const size_t NUM_EE = KINEMATICS::NUM_EE;
+
+    using SCALAR = typename KINEMATICS::SCALAR;
+    using JointPositions = Eigen::Matrix<SCALAR, NJOINTS, Eigen::Dynamic>;
+    using Result = BatchKinematicsResult<NJOINTS, NUM_EE, SCALAR>;
+
+    /**
+     * \brief Constructor
+     * @param kinematics the kinematics which is copied for every thread
+     * @param nThreads maximum number of threads, 0 uses the number of hardware threads
+     * @param minChunkSize minimum number of configurations evaluated by one thread
+     */
+    BatchKinematics(const KINEMATICS& kinematics = KINEMATICS(), size_t nThreads = 0, size_t minChunkSize = 256)
+        : minChunkSize_(std::max<size_t>(minChunkSize, 1)), generation_(0), pending_(0), shutdown_(false)
+    {
+        if (nThreads == 0)
+            nThreads = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+
+        for (size_t i = 0; i < nThreads; i++)
+            kinematics_.push_back(std::shared_ptr<KINEMATICS>(kinematics.clone()));
+
+        // the calling thread evaluates the first chunk, hence one worker less than threads
+        for (size_t i = 1; i < nThreads; i++)
+            workers_.emplace_back(&BatchKinematics::work, this, i);
+    }
+
+    BatchKinematics(const BatchKinematics&) = delete;
+    BatchKinematics& operator=(const BatchKinematics&) = delete;
+
+    ~BatchKinematics()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        wakeUp_.notify_all();
+
+        for (std::thread& worker : workers_)
+            worker.join();
+    }
+
+    //! maximum number of threads used for a batch
+    size_t nThreads() const { return kinematics_.size(); }
+    /**
+     * \brief Computes the end-effector poses and optionally the Jacobians of all configurations
+     * @param jointPositions the joint configurations, one per column
+     * @param result the poses and Jacobians, resized to the batch if required
+     * @param computeJacobians if false, only the poses are computed
+     */
+    void compute(const JointPositions& jointPositions, Result& result, bool computeJacobians = true)
+    {
+        const size_t n = jointPositions.cols();
+        result.resize(n, computeJacobians);
+
+        const size_t nChunks = std::min(nThreads(), (n + minChunkSize_ - 1) / minChunkSize_);
+        if (nChunks <= 1)
+        {
+            computeChunk(*kinematics_[0], jointPositions, result, computeJacobians, 0, n);
+            return;
+        }
+
+        const size_t chunkSize = (n + nChunks - 1) / nChunks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = Job{&jointPositions, &result, computeJacobians, chunkSize, nChunks};
+            pending_ = nChunks - 1;
+            generation_++;
+        }
+        wakeUp_.notify_all();
+
+        // the calling thread evaluates the first chunk
+        computeChunk(*kinematics_[0], jointPositions, result, computeJacobians, 0, std::min(chunkSize, n));
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return pending_ == 0; });
+    }
+
+private:
+    //! a batch to be evaluated by the workers
+    struct Job
+    {
+        const JointPositions* jointPositions;
+        Result* result;
+        bool computeJacobians;
+        size_t chunkSize;
+        size_t nChunks;
+    };
+
+    //! main loop of a worker, evaluates the chunk with the id of the worker for every new batch
+    void work(size_t id)
+    {
+        size_t generation = 0;
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wakeUp_.wait(lock, [this, generation]() { return shutdown_ || generation_ != generation; });
+                if (shutdown_)
+                    return;
+
+                generation = generation_;
+                job = job_;
+            }
+
+            // small batches do not use all workers
+            if (id >= job.nChunks)
+                continue;
+
+            const size_t n = job.jointPositions->cols();
+            const size_t begin = std::min(id * job.chunkSize, n);
+            const size_t end = std::min(begin + job.chunkSize, n);
+            computeChunk(*kinematics_[id], *job.jointPositions, *job.result, job.computeJacobians, begin, end);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0)
+                done_.notify_one();
+        }
+    }
+
+    //! evaluates the configurations [begin, end), chunks write to disjoint columns of the result
+    static void computeChunk(KINEMATICS& kinematics,
+        const JointPositions& jointPositions,
+        Result& result,
+        bool computeJacobians,
+        size_t begin,
+        size_t end)
+    {
+        typename KINEMATICS::JointState_t::Position q;
+        for (size_t k = begin; k < end; k++)
+        {
+            q = jointPositions.col(k);
+            for (size_t i = 0; i < NUM_EE; i++)
+            {
+                // the cache is bypassed, since every configuration is evaluated only once
+                const typename KINEMATICS::HomogeneousTransform& T =
+                    kinematics.robcogen().getHomogeneousTransformBaseEEById(i, q);
+                result.positions[i].col(k) = T.template topRightCorner<3, 1>();
+                for (size_t c = 0; c < 3; c++)
+                    result.rotations[i].template block<3, 1>(3 * c, k) = T.template block<3, 1>(0, c);
+
+                if (computeJacobians)
+                {
+                    const typename KINEMATICS::Jacobian& J = kinematics.robcogen().getJacobianBaseEEbyId(i, q);
+                    for (size_t c = 0; c < NJOINTS; c++)
+                        result.jacobians[i].template block<6, 1>(6 * c, k) = J.col(c);
+                }
+            }
+        }
+    }
+
+    size_t minChunkSize_;
+    std::vector<std::shared_ptr<KINEMATICS>> kinematics_;
+
+    // the worker pool
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;  //!< notifies the workers of a new batch or the shutdown
+    std::condition_variable done_;    //!< notifies the calling thread that all chunks are evaluated
+    Job job_;                         //!< the current batch
+    size_t generation_;               //!< incremented for every batch evaluated by the workers
+    size_t pending_;                  //!< number of chunks of the current batch not yet evaluated by the workers
+    bool shutdown_;                   //!< stops the workers
+};
+
+}  // namespace rbd
+}  // namespace ct
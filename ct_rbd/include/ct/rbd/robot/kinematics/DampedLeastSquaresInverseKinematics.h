@@ -0,0 +1,263 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <random>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Geometry>
+
+#include "InverseKinematicsBase.h"
+
+namespace ct {
+namespace rbd {
+
+//! settings of the damped least-squares inverse kinematics
+struct DampedLeastSquaresIKSettings
+{
+    DampedLeastSquaresIKSettings()
+        : maxIterations(100),
+          tolerance(1e-10),
+          initialDamping(1e-2),
+          minDamping(1e-8),
+          maxDamping(1e4),
+          dampingDecrease(0.1),
+          dampingIncrease(10.0),
+          maxStepSize(0.5),
+          jointLimitGain(0.1)
+    {
+    }
+
+    size_t maxIterations;    //!< maximum number of iterations per trial
+    double tolerance;        //!< convergence threshold on the norm of the pose error
+    double initialDamping;   //!< damping at the start of each trial
+    double minDamping;       //!< lower bound of the damping
+    double maxDamping;       //!< the trial is aborted once the damping exceeds this value
+    double dampingDecrease;  //!< factor applied to the damping after a successful step
+    double dampingIncrease;  //!< factor applied to the damping after a rejected step
+    double maxStepSize;      //!< maximum norm of a joint step
+    double jointLimitGain;   //!< gain of the joint limit avoidance in the null-space, 0 disables it
+};
+
+/*!
+ * \brief Inverse kinematics by damped least-squares iterations on the geometric end-effector Jacobian
+ *
+ * Each iteration computes the joint step
+ * \f[
+ *  \Delta q = J^T (J J^T + \lambda^2 I)^{-1} e + (I - J^\# J) z
+ * \f]
+ * where \f$ e \f$ is the pose error in base coordinates (orientation error as rotation vector, stacked on top of the
+ * position error as the rows of the Jacobian), \f$ J^\# \f$ is the damped pseudo-inverse and \f$ z \f$ is the
+ * negative gradient of a joint limit cost, which pushes the joints towards the middle of their range without
+ * affecting the end-effector motion. The damping is adapted in Levenberg-Marquardt fashion: it is decreased after a
+ * step reduces the error and increased otherwise, such that the solver behaves like Gauss-Newton far from
+ * singularities and remains stable close to them. The joints are clamped to their limits after every step.
+ *
+ * All iterations use fixed-size matrices and do not allocate memory, hence the solver is suited for sub-millisecond
+ * inverse kinematics, e.g. within control loops. It does not require an NLP solver and can replace IKNLPSolverIpopt
+ * where the pose is the only objective.
+ *
+ * The first trial starts from the query joint positions (computeInverseKinematicsCloseTo()) or the initial guess,
+ * further trials up to InverseKinematicsSettings::maxNumTrials_ start from random joint positions within the
+ * limits if InverseKinematicsSettings::randomizeInitialGuess_ is set. A solution is accepted if its end-effector pose
+ * is near the target within InverseKinematicsSettings::validationTol_. The free joints are ignored.
+ *
+ * \tparam KINEMATICS the kinematics of the robot, e.g. ct::rbd::Kinematics
+ */
+template <class KINEMATICS>
+class DampedLeastSquaresInverseKinematics
+    : public InverseKinematicsBase<KINEMATICS::NJOINTS, typename KINEMATICS::SCALAR>
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    static const size_t NJOINTS = KINEMATICS::NJOINTS;
+
+    using SCALAR = typename KINEMATICS::SCALAR;
+    using BASE = InverseKinematicsBase<NJOINTS, SCALAR>;
+    using JointPosition_t = typename BASE::JointPosition_t;
+    using JointPositionsVector_t = typename BASE::JointPositionsVector_t;
+    using RigidBodyPoseTpl = typename BASE::RigidBodyPoseTpl;
+    using PoseError = Eigen::Matrix<SCALAR, 6, 1>;
+    using Matrix3s = Eigen::Matrix<SCALAR, 3, 3>;
+    using Vector3s = Eigen::Matrix<SCALAR, 3, 1>;
+
+    /*!
+     * @brief constructor
+     * @param jointLowerLimit lower joint limits
+     * @param jointUpperLimit upper joint limits
+     * @param eeId the end-effector the inverse kinematics is solved for
+     * @param ikSettings number of trials and validation tolerance
+     * @param settings settings of the iterations
+     */
+    DampedLeastSquaresInverseKinematics(const JointPosition_t& jointLowerLimit,
+        const JointPosition_t& jointUpperLimit,
+        size_t eeId = 0,
+        const InverseKinematicsSettings& ikSettings = InverseKinematicsSettings(),
+        const DampedLeastSquaresIKSettings& settings = DampedLeastSquaresIKSettings())
+        : BASE(ikSettings),
+          jointLowerLimit_(jointLowerLimit),
+          jointUpperLimit_(jointUpperLimit),
+          initialGuess_(0.5 * (jointLowerLimit + jointUpperLimit)),
+          eeId_(eeId),
+          settings_(settings),
+          iterations_(0)
+    {
+    }
+
+    ~DampedLeastSquaresInverseKinematics() override = default;
+
+    //! the initial guess of the first trial of computeInverseKinematics(), by default the middle of the joint range
+    void setInitialGuess(const JointPosition_t& initialGuess) { initialGuess_ = initialGuess; }
+    const DampedLeastSquaresIKSettings& getDampedLeastSquaresSettings() const { return settings_; }
+    void updateDampedLeastSquaresSettings(const DampedLeastSquaresIKSettings& settings) { settings_ = settings; }
+    //! total number of iterations of the last call over all trials
+    size_t getNumIterations() const { return iterations_; }
+    bool computeInverseKinematics(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeBasePose,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        ikSolutions.clear();
+
+        JointPosition_t solution;
+        if (!solve(solution, eeBasePose, initialGuess_))
+            return false;
+
+        ikSolutions.push_back(solution);
+        return true;
+    }
+
+    bool computeInverseKinematics(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        return computeInverseKinematics(ikSolutions, eeWorldPose.inReferenceFrame(baseWorldPose), freeJoints);
+    }
+
+    using BASE::computeInverseKinematicsCloseTo;
+
+    //! starts the iterations from the query joint positions
+    bool computeInverseKinematicsCloseTo(JointPosition_t& ikSolution,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const JointPosition_t& queryJointPositions,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        return solve(ikSolution, eeWorldPose.inReferenceFrame(baseWorldPose), queryJointPositions);
+    }
+
+private:
+    bool solve(JointPosition_t& solution, const RigidBodyPoseTpl& eeBasePose, const JointPosition_t& initialGuess)
+    {
+        iterations_ = 0;
+
+        const Matrix3s targetRotation = eeBasePose.getRotationMatrix().toImplementation();
+        const Vector3s targetPosition = eeBasePose.position().toImplementation();
+
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        for (size_t trial = 0; trial < std::max<size_t>(this->getSettings().maxNumTrials_, 1); trial++)
+        {
+            if (trial == 0)
+                solution = initialGuess;
+            else if (this->getSettings().randomizeInitialGuess_)
+                for (size_t i = 0; i < NJOINTS; i++)
+                    solution(i) = jointLowerLimit_(i) + (jointUpperLimit_(i) - jointLowerLimit_(i)) * uniform(random_);
+            else
+                break;
+
+            solution = solution.cwiseMax(jointLowerLimit_).cwiseMin(jointUpperLimit_);
+
+            if (iterate(solution, targetRotation, targetPosition) &&
+                kinematics_.getEEPoseInBase(eeId_, solution).isNear(eeBasePose, this->getSettings().validationTol_))
+                return true;
+        }
+        return false;
+    }
+
+    //! damped least-squares iterations of a single trial, returns true if converged
+    bool iterate(JointPosition_t& q, const Matrix3s& targetRotation, const Vector3s& targetPosition)
+    {
+        SCALAR damping = settings_.initialDamping;
+        PoseError error = poseError(q, targetRotation, targetPosition);
+        SCALAR errorNorm = error.norm();
+
+        for (size_t k = 0; k < settings_.maxIterations; k++)
+        {
+            if (errorNorm < settings_.tolerance)
+                return true;
+
+            iterations_++;
+
+            const typename KINEMATICS::Jacobian& J = kinematics_.getJacobianBaseEEbyId(eeId_, q);
+            Eigen::Matrix<SCALAR, 6, 6> JJt = J * J.transpose();
+            JJt.diagonal().array() += damping * damping;
+            Eigen::LDLT<Eigen::Matrix<SCALAR, 6, 6>> ldlt(JJt);
+
+            JointPosition_t dq = J.transpose() * ldlt.solve(error);
+
+            // joint limit avoidance projected into the null-space of the damped pseudo-inverse
+            if (settings_.jointLimitGain > 0.0)
+            {
+                const JointPosition_t range = jointUpperLimit_ - jointLowerLimit_;
+                const JointPosition_t z = -settings_.jointLimitGain *
+                                          (q - 0.5 * (jointLowerLimit_ + jointUpperLimit_)).cwiseQuotient(range);
+                dq += z - J.transpose() * ldlt.solve(J * z);
+            }
+
+            const SCALAR stepNorm = dq.norm();
+            if (stepNorm > settings_.maxStepSize)
+                dq *= settings_.maxStepSize / stepNorm;
+
+            JointPosition_t qNew = (q + dq).cwiseMax(jointLowerLimit_).cwiseMin(jointUpperLimit_);
+            PoseError errorNew = poseError(qNew, targetRotation, targetPosition);
+            const SCALAR errorNormNew = errorNew.norm();
+
+            if (errorNormNew < errorNorm)
+            {
+                q = qNew;
+                error = errorNew;
+                errorNorm = errorNormNew;
+                damping = std::max<SCALAR>(damping * settings_.dampingDecrease, settings_.minDamping);
+            }
+            else
+            {
+                damping *= settings_.dampingIncrease;
+                if (damping > settings_.maxDamping)
+                    return false;  // stuck, e.g. in a local minimum or at a joint limit
+            }
+        }
+        return errorNorm < settings_.tolerance;
+    }
+
+    //! orientation error as rotation vector stacked on top of the position error, both in base coordinates
+    PoseError poseError(const JointPosition_t& q, const Matrix3s& targetRotation, const Vector3s& targetPosition)
+    {
+        const typename KINEMATICS::HomogeneousTransform& T = kinematics_.getHomogeneousTransformBaseEEById(eeId_, q);
+
+        Eigen::AngleAxis<SCALAR> rotationError(targetRotation * T.template topLeftCorner<3, 3>().transpose());
+
+        PoseError error;
+        error.template head<3>() = rotationError.angle() * rotationError.axis();
+        error.template tail<3>() = targetPosition - T.template topRightCorner<3, 1>();
+        return error;
+    }
+
+    KINEMATICS kinematics_;
+
+    JointPosition_t jointLowerLimit_;
+    JointPosition_t jointUpperLimit_;
+    JointPosition_t initialGuess_;
+    size_t eeId_;
+
+    DampedLeastSquaresIKSettings settings_;
+    size_t iterations_;
+    std::mt19937 random_;
+};
+
+}  // namespace rbd
+}  // namespace ct
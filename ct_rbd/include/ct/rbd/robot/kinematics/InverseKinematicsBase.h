@@ -5,6 +5,8 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 
 #pragma once
 
+#include <atomic>
+
 #include <ct/rbd/state/JointState.h>
 #include <ct/rbd/state/RigidBodyPose.h>
 
@@ -85,18 +87,8 @@ public:
         if (!hasSolution)
             return false;  // no IK solution was found
 
-        // loop through all solution candidates and return the one which is closest to the "queryJointPositions"
-        ikSolution = solutions[0];
-        double minNorm = (ikSolution - queryJointPositions).norm();
-
-        for (size_t i = 1; i < solutions.size(); ++i)
-        {
-            if ((solutions[i] - queryJointPositions).norm() < minNorm)
-            {
-                minNorm = (solutions[i] - queryJointPositions).norm();
-                ikSolution = solutions[i];
-            }
-        }
+        // return the solution candidate which is closest to the "queryJointPositions"
+        ikSolution = closestSolution(solutions, queryJointPositions);
         return true;
     }
 
@@ -121,8 +113,34 @@ public:
 
     const InverseKinematicsSettings& getSettings() const { return settings_; }
     void updateSettings(const InverseKinematicsSettings& settings) { settings_ = settings; }
+    /*!
+     * @brief set a flag which cancels running solves once it is true, e.g. set by ParallelInverseKinematics
+     * @param cancel the flag, it has to outlive all solves, nullptr removes it
+     */
+    void setCancelFlag(const std::atomic<bool>* cancel) { cancel_ = cancel; }
+    //! true if the solve should stop as soon as possible
+    bool cancelled() const { return cancel_ && *cancel_; }
 protected:
+    //! the solution candidate which is closest to the query joint positions, the candidates must not be empty
+    static const JointPosition_t& closestSolution(const JointPositionsVector_t& solutions,
+        const JointPosition_t& queryJointPositions)
+    {
+        size_t closest = 0;
+        double minNorm = (solutions[0] - queryJointPositions).norm();
+
+        for (size_t i = 1; i < solutions.size(); ++i)
+        {
+            if ((solutions[i] - queryJointPositions).norm() < minNorm)
+            {
+                minNorm = (solutions[i] - queryJointPositions).norm();
+                closest = i;
+            }
+        }
+        return solutions[closest];
+    }
+
     InverseKinematicsSettings settings_;
+    const std::atomic<bool>* cancel_ = nullptr;  //!< running solves stop once this flag is set
 };
 
 } /* namespace rbd */
@@ -0,0 +1,214 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+#include <ct/rbd/state/JointState.h>
+
+namespace ct {
+namespace rbd {
+
+/**
+ * \brief Caches the forward kinematics of a robot for the current joint configuration
+ *
+ * The cache stores the end-effector transforms and Jacobians as well as the link transforms. All quantities are
+ * computed lazily on first access and reused as long as the joint positions do not change. The cache is keyed on
+ * the joint positions and an evaluation epoch: every change of the joint positions starts a new epoch, which
+ * invalidates all entries at once. The epoch can also be advanced manually via invalidate(), e.g. if the robot
+ * model was modified.
+ *
+ * A cache is shared between several Kinematics instances, such that cost terms, the contact model and constraints
+ * evaluating the same state compute the kinematics only once. By default, all Kinematics instances of the same
+ * robot share the cache returned by getDefault(), copies keep the cache of the original (see
+ * Kinematics::setKinematicsCache() to use a different one). The cache is thread-safe: every thread keeps its own
+ * joint configuration, epoch and entries, hence clones evaluated by different threads, e.g. the per-thread cost
+ * functions of NLOC, share the cache without interfering with each other.
+ *
+ * Caching is only active for floating point types. For auto-diff types, two different variables can have the
+ * same value, hence all quantities are recomputed on every access.
+ *
+ * \tparam RBD the RobCoGen container of the robot
+ * \tparam N_EE the number of end-effectors
+ */
+template <class RBD, size_t N_EE>
+class KinematicsCache
+{
+public:
+    static const size_t NJOINTS = RBD::NJOINTS;
+    static const size_t NLINKS = RBD::NLINKS;
+
+    using SCALAR = typename RBD::SCALAR;
+    using HomogeneousTransform = typename RBD::HomogeneousTransform;
+    using ForceTransform = typename RBD::ForceTransform;
+    using Jacobian = typename RBD::Jacobian;
+    using JointPosition = typename JointState<NJOINTS, SCALAR>::Position;
+
+    //! true if quantities are cached for the scalar type
+    static const bool ENABLED = std::is_floating_point<SCALAR>::value;
+
+    KinematicsCache() : id_(nextId()), generation_(0), hits_(0), misses_(0) {}
+    KinematicsCache(const KinematicsCache&) = delete;
+    KinematicsCache& operator=(const KinematicsCache&) = delete;
+
+    //! the cache shared by all Kinematics instances of the robot unless they are given a different one
+    static const std::shared_ptr<KinematicsCache>& getDefault()
+    {
+        static const std::shared_ptr<KinematicsCache> cache(new KinematicsCache());
+        return cache;
+    }
+
+    //! starts a new epoch of the calling thread if the joint positions differ from the cached ones
+    void update(const JointPosition& jointPosition) { update(entries(), jointPosition); }
+    //! invalidates all cached quantities of all threads
+    void invalidate() { generation_++; }
+    //! the current evaluation epoch of the calling thread
+    size_t epoch() { return entries().epoch; }
+    //! number of accesses which were served from the cache, summed over all threads
+    size_t hits() const { return hits_; }
+    //! number of accesses which required a computation, summed over all threads
+    size_t misses() const { return misses_; }
+    //! the homogeneous transform from end-effector to base coordinates
+    const HomogeneousTransform& getHomogeneousTransformBaseEE(RBD& rbd, size_t eeId, const JointPosition& jointPosition)
+    {
+        Entries& e = entries();
+        if (isOutdated(e, e.eeTransformEpoch[eeId], jointPosition))
+            e.eeTransform[eeId] = rbd.getHomogeneousTransformBaseEEById(eeId, jointPosition);
+        return e.eeTransform[eeId];
+    }
+
+    //! the end-effector Jacobian expressed in the base frame
+    const Jacobian& getJacobianBaseEE(RBD& rbd, size_t eeId, const JointPosition& jointPosition)
+    {
+        Entries& e = entries();
+        if (isOutdated(e, e.eeJacobianEpoch[eeId], jointPosition))
+            e.eeJacobian[eeId] = rbd.getJacobianBaseEEbyId(eeId, jointPosition);
+        return e.eeJacobian[eeId];
+    }
+
+    //! the homogeneous transform from link to base coordinates
+    const HomogeneousTransform& getHomogeneousTransformBaseLink(RBD& rbd,
+        size_t linkId,
+        const JointPosition& jointPosition)
+    {
+        Entries& e = entries();
+        if (isOutdated(e, e.linkTransformEpoch[linkId], jointPosition))
+            e.linkTransform[linkId] = rbd.getHomogeneousTransformBaseLinkById(linkId, jointPosition);
+        return e.linkTransform[linkId];
+    }
+
+    //! the force transform from base to link coordinates
+    const ForceTransform& getForceTransformLinkBase(RBD& rbd, size_t linkId, const JointPosition& jointPosition)
+    {
+        Entries& e = entries();
+        if (isOutdated(e, e.linkForceTransformEpoch[linkId], jointPosition))
+            e.linkForceTransform[linkId] = rbd.getForceTransformLinkBaseById(linkId, jointPosition);
+        return e.linkForceTransform[linkId];
+    }
+
+private:
+    //! the cached quantities of one thread
+    struct Entries
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+        Entries() : epoch(1), generation(0), initialized(false)
+        {
+            eeTransformEpoch.fill(0);
+            eeJacobianEpoch.fill(0);
+            linkTransformEpoch.fill(0);
+            linkForceTransformEpoch.fill(0);
+        }
+
+        JointPosition jointPosition;
+        size_t epoch;
+        size_t generation;
+        bool initialized;
+
+        std::array<HomogeneousTransform, N_EE> eeTransform;
+        std::array<Jacobian, N_EE> eeJacobian;
+        std::array<HomogeneousTransform, NLINKS> linkTransform;
+        std::array<ForceTransform, NLINKS> linkForceTransform;
+
+        std::array<size_t, N_EE> eeTransformEpoch;
+        std::array<size_t, N_EE> eeJacobianEpoch;
+        std::array<size_t, NLINKS> linkTransformEpoch;
+        std::array<size_t, NLINKS> linkForceTransformEpoch;
+    };
+
+    //! unique id of a cache, unlike its address it is never reused
+    static size_t nextId()
+    {
+        static std::atomic<size_t> counter(0);
+        return ++counter;
+    }
+
+    //! the entries of the calling thread, the last lookup of every thread is memorized to avoid locking
+    Entries& entries()
+    {
+        thread_local size_t lastId = 0;
+        thread_local Entries* lastEntries = nullptr;
+        if (lastId == id_)
+            return *lastEntries;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unique_ptr<Entries>& e = entries_[std::this_thread::get_id()];
+        if (!e)
+            e.reset(new Entries());
+        lastId = id_;
+        lastEntries = e.get();
+        return *e;
+    }
+
+    //! starts a new epoch if the joint positions changed or the cache was invalidated
+    void update(Entries& e, const JointPosition& jointPosition)
+    {
+        const size_t generation = generation_;
+        if (!e.initialized || e.generation != generation || jointPosition != e.jointPosition)
+        {
+            e.jointPosition = jointPosition;
+            e.initialized = true;
+            e.generation = generation;
+            e.epoch++;
+        }
+    }
+
+    //! checks if an entry needs to be recomputed and marks it as up to date
+    bool isOutdated(Entries& e, size_t& entryEpoch, const JointPosition& jointPosition)
+    {
+        if (!ENABLED)
+            return true;
+
+        update(e, jointPosition);
+        if (entryEpoch == e.epoch)
+        {
+            hits_++;
+            return false;
+        }
+
+        entryEpoch = e.epoch;
+        misses_++;
+        return true;
+    }
+
+    const size_t id_;
+    std::atomic<size_t> generation_;
+
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+
+    std::mutex mutex_;
+    std::unordered_map<std::thread::id, std::unique_ptr<Entries>> entries_;
+};
+
+}  // namespace rbd
+}  // namespace ct
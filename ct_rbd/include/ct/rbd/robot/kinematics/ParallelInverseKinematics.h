@@ -0,0 +1,226 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "InverseKinematicsBase.h"
+
+namespace ct {
+namespace rbd {
+
+/*!
+ * \brief Solves inverse kinematics from several seeds in parallel and stops at the first valid solution
+ *
+ * Local inverse kinematics solvers, e.g. IKNLPSolverIpopt, converge to a solution close to their initial guess and
+ * may fail for a bad one. This front end distributes a set of seeds over several local solvers, each running on its
+ * own thread, and accepts a solution once its end-effector pose is within the validation tolerance
+ * (InverseKinematicsSettings::validationTol_) and it satisfies the joint limits, e.g. the bounds of the
+ * JointLimitConstraints of an IKNLP. Once a valid solution is found, no further seeds are started and the solves
+ * which are already running are cancelled via the cancel flag of the local solvers, see
+ * InverseKinematicsBase::setCancelFlag(). IKNLPSolverIpopt aborts IPOPT at its next iteration, solvers which do not
+ * check the flag run to completion. Valid solutions of cancelled solves are kept, such that
+ * computeInverseKinematics() may return more than one solution and computeInverseKinematicsCloseTo() returns the one
+ * closest to the query.
+ *
+ * The seeds are tried in the following order:
+ *  - the query joint positions, if called via computeInverseKinematicsCloseTo()
+ *  - all solutions of the seed solver, e.g. all IKFast branches, which are refined by the local solvers
+ *  - the seeds set with setSeeds()
+ *  - uniformly sampled joint positions within the joint limits, if InverseKinematicsSettings::randomizeInitialGuess_
+ *    is set, until InverseKinematicsSettings::maxNumTrials_ seeds are reached
+ *
+ * The local solvers are called via computeInverseKinematicsCloseTo() with the seed as query joint positions. Since
+ * the solvers are not thread-safe, one solver instance is required per thread.
+ *
+ * \tparam KINEMATICS the kinematics used to validate the solutions
+ */
+template <class KINEMATICS>
+class ParallelInverseKinematics : public InverseKinematicsBase<KINEMATICS::NJOINTS, typename KINEMATICS::SCALAR>
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    using SCALAR = typename KINEMATICS::SCALAR;
+    using BASE = InverseKinematicsBase<KINEMATICS::NJOINTS, SCALAR>;
+    using JointPosition_t = typename BASE::JointPosition_t;
+    using JointPositionsVector_t = typename BASE::JointPositionsVector_t;
+    using RigidBodyPoseTpl = typename BASE::RigidBodyPoseTpl;
+
+    /*!
+     * @brief constructor
+     * @param solvers the local solvers, one per thread
+     * @param jointLowerLimit lower joint limits
+     * @param jointUpperLimit upper joint limits
+     * @param eeId the end-effector the inverse kinematics is solved for
+     * @param settings the number of seeds and the validation tolerance
+     * @param randomSeed seed of the random number generator for the sampled seeds
+     */
+    ParallelInverseKinematics(const std::vector<std::shared_ptr<BASE>>& solvers,
+        const JointPosition_t& jointLowerLimit,
+        const JointPosition_t& jointUpperLimit,
+        size_t eeId = 0,
+        const InverseKinematicsSettings& settings = InverseKinematicsSettings(),
+        unsigned int randomSeed = 0)
+        : BASE(settings),
+          solvers_(solvers),
+          kinematics_(solvers.size()),
+          jointLowerLimit_(jointLowerLimit),
+          jointUpperLimit_(jointUpperLimit),
+          eeId_(eeId),
+          randomEngine_(randomSeed),
+          numSolves_(0)
+    {
+        if (solvers_.empty())
+            throw std::runtime_error("ParallelInverseKinematics: at least one solver is required.");
+        for (const auto& solver : solvers_)
+            if (!solver)
+                throw std::runtime_error("ParallelInverseKinematics: solvers must not be null.");
+    }
+
+    ~ParallelInverseKinematics() override = default;
+
+    //! the solutions of this solver, e.g. all IKFast branches, are used as seeds for the local solvers
+    void setSeedSolver(const std::shared_ptr<BASE>& seedSolver) { seedSolver_ = seedSolver; }
+    //! fixed seeds, which are tried before the sampled seeds
+    void setSeeds(const JointPositionsVector_t& seeds) { seeds_ = seeds; }
+    //! number of local solves of the last call, including solves started before a solution was found
+    size_t getNumSolves() const { return numSolves_; }
+    //! true if the joint positions are within the limits and reach the end-effector pose
+    bool isValid(const JointPosition_t& jointPosition, const RigidBodyPoseTpl& eeBasePose, KINEMATICS& kinematics)
+    {
+        if ((jointPosition.array() < jointLowerLimit_.array()).any() ||
+            (jointPosition.array() > jointUpperLimit_.array()).any())
+            return false;
+
+        return kinematics.getEEPoseInBase(eeId_, jointPosition).isNear(eeBasePose, this->getSettings().validationTol_);
+    }
+
+    bool computeInverseKinematics(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeBasePose,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        return solve(ikSolutions, eeBasePose, JointPositionsVector_t(), freeJoints);
+    }
+
+    bool computeInverseKinematics(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        return computeInverseKinematics(ikSolutions, eeWorldPose.inReferenceFrame(baseWorldPose), freeJoints);
+    }
+
+    using BASE::computeInverseKinematicsCloseTo;
+
+    //! uses the query joint positions as first seed and returns the valid solution closest to them
+    bool computeInverseKinematicsCloseTo(JointPosition_t& ikSolution,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const JointPosition_t& queryJointPositions,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        JointPositionsVector_t solutions;
+        if (!solve(solutions, eeWorldPose.inReferenceFrame(baseWorldPose),
+                JointPositionsVector_t(1, queryJointPositions), freeJoints))
+            return false;
+
+        ikSolution = this->closestSolution(solutions, queryJointPositions);
+        return true;
+    }
+
+private:
+    bool solve(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeBasePose,
+        const JointPositionsVector_t& initialSeeds,
+        const std::vector<size_t>& freeJoints)
+    {
+        ikSolutions.clear();
+
+        JointPositionsVector_t seeds = initialSeeds;
+        if (seedSolver_)
+        {
+            JointPositionsVector_t branches;
+            seedSolver_->computeInverseKinematics(branches, eeBasePose, freeJoints);
+            seeds.insert(seeds.end(), branches.begin(), branches.end());
+        }
+        seeds.insert(seeds.end(), seeds_.begin(), seeds_.end());
+
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        while (this->getSettings().randomizeInitialGuess_ && seeds.size() < this->getSettings().maxNumTrials_)
+        {
+            JointPosition_t seed;
+            for (int i = 0; i < seed.size(); i++)
+                seed(i) = jointLowerLimit_(i) + (jointUpperLimit_(i) - jointLowerLimit_(i)) * uniform(randomEngine_);
+            seeds.push_back(seed);
+        }
+
+        std::atomic<size_t> nextSeed(0);
+        std::atomic<bool> solved(false);
+        std::mutex solutionMutex;
+
+        auto worker = [&](size_t solverId) {
+            while (!solved)
+            {
+                const size_t seedId = nextSeed++;
+                if (seedId >= seeds.size())
+                    return;
+
+                JointPosition_t solution;
+                if (!solvers_[solverId]->computeInverseKinematicsCloseTo(
+                        solution, eeBasePose, seeds[seedId], freeJoints) ||
+                    !isValid(solution, eeBasePose, kinematics_[solverId]))
+                    continue;
+
+                std::lock_guard<std::mutex> lock(solutionMutex);
+                ikSolutions.push_back(solution);
+                solved = true;
+            }
+        };
+
+        // running solves are cancelled once a solution is found
+        for (const auto& solver : solvers_)
+            solver->setCancelFlag(&solved);
+
+        const size_t nThreads = std::min(solvers_.size(), seeds.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < nThreads; i++)
+            threads.emplace_back(worker, i);
+
+        // the calling thread runs the first solver
+        worker(0);
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (const auto& solver : solvers_)
+            solver->setCancelFlag(nullptr);
+
+        numSolves_ = std::min<size_t>(nextSeed, seeds.size());
+        return solved;
+    }
+
+    std::vector<std::shared_ptr<BASE>> solvers_;
+    std::vector<KINEMATICS, Eigen::aligned_allocator<KINEMATICS>> kinematics_;  //!< one per solver, for validation
+    std::shared_ptr<BASE> seedSolver_;
+    JointPositionsVector_t seeds_;
+
+    JointPosition_t jointLowerLimit_;
+    JointPosition_t jointUpperLimit_;
+    size_t eeId_;
+
+    std::mt19937 randomEngine_;
+    size_t numSolves_;
+};
+
+}  // namespace rbd
+}  // namespace ct
@@ -60,6 +60,13 @@ public:
     }
 
     void setInitialGuess(const JointPosition_t& q_init) { this->optVariables_->setInitialGuess(q_init); }
+    JointPosition_t getInitialGuess() const
+    {
+        JointPosition_t q_init;
+        typename ct::optcon::tpl::OptVector<SCALAR>::MapVecXs q_initMap(q_init.data(), KINEMATICS::NJOINTS);
+        this->optVariables_->getInitialGuess(KINEMATICS::NJOINTS, q_initMap);
+        return q_init;
+    }
     std::shared_ptr<ct::rbd::IKCostEvaluator<KINEMATICS, SCALAR>> getIKCostEvaluator()
     {
         return std::static_pointer_cast<ct::rbd::IKCostEvaluator<KINEMATICS, SCALAR>>(this->costEvaluator_);
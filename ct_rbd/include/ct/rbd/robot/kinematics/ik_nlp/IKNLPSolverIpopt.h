@@ -85,7 +85,7 @@ public:
 
         bool solutionFound = false;
 
-        while (count < this->getSettings().maxNumTrials_ && !solutionFound)
+        while (count < this->getSettings().maxNumTrials_ && !solutionFound && !this->cancelled())
         {
             // set randomized initial guess if applicable
             if (this->getSettings().randomizeInitialGuess_ && count != 0)
@@ -129,6 +129,47 @@ public:
         return computeInverseKinematics(ikSolutions, eeWorldPose.inReferenceFrame(baseWorldPose), freeJoints);
     }
 
+    using InverseKinematicsBase::computeInverseKinematicsCloseTo;
+
+    //! uses the query joint positions as initial guess of the first trial, the previous initial guess is restored
+    bool computeInverseKinematicsCloseTo(JointPosition_t& ikSolution,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const JointPosition_t& queryJointPositions,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        const JointPosition_t initialGuess = iknlp_->getInitialGuess();
+        setInitialGuess(queryJointPositions);
+
+        JointPositionsVector_t solutions;
+        const bool solutionFound = computeInverseKinematics(solutions, eeWorldPose, baseWorldPose, freeJoints);
+        setInitialGuess(initialGuess);
+
+        if (!solutionFound)
+            return false;
+
+        ikSolution = this->closestSolution(solutions, queryJointPositions);
+        return true;
+    }
+
+    //! aborts IPOPT once the cancel flag is set, see InverseKinematicsBase::setCancelFlag()
+    bool intermediate_callback(Ipopt::AlgorithmMode mode,
+        Ipopt::Index iter,
+        Ipopt::Number obj_value,
+        Ipopt::Number inf_pr,
+        Ipopt::Number inf_du,
+        Ipopt::Number mu,
+        Ipopt::Number d_norm,
+        Ipopt::Number regularization_size,
+        Ipopt::Number alpha_du,
+        Ipopt::Number alpha_pr,
+        Ipopt::Index ls_trials,
+        const Ipopt::IpoptData* ip_data,
+        Ipopt::IpoptCalculatedQuantities* ip_cq) override
+    {
+        return !this->cancelled();
+    }
+
 private:
     std::shared_ptr<IKNLP> iknlp_;
 
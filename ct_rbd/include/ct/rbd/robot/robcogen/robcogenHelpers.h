@@ -65,6 +65,14 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
         ) ;                          \
     break;
 
+#define CT_RBD_INERTIA_BY_NAME(LINK_NAME) inertias.getTensor_##LINK_NAME()
+
+// This is just a helper Macro that generates a case-statement for each link to shorten the macro below.
+#define CT_RBD_CASE_HELPER_INERTIA_ID(LINK_NAME, INDEX) \
+    case INDEX:                                         \
+        return CT_RBD_INERTIA_BY_NAME(LINK_NAME);       \
+        break;
+
 
 namespace ct {
 namespace rbd {
@@ -757,6 +765,96 @@ public:
         return jacobian;
     }
 
+#ifdef CT_L0_NAME
+    /*!
+     * This defines a function to get the spatial inertia of a link by ID, expressed in the link frame.
+     * Requires the RobCoGen link names (CT_L0_NAME, ... and CT_BASE_NAME for floating base robots) to be defined.
+     */
+    template <class INERTIA>
+    static const typename INERTIA::IMatrix& getInertiaById(const INERTIA& inertias, size_t link_id)
+    {
+        switch (link_id)
+        {
+#ifdef CT_BASE_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_BASE_NAME, 0)
+#endif
+#ifdef CT_L0_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L0_NAME, 0 + 1)
+#endif
+#ifdef CT_L1_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L1_NAME, 1 + 1)
+#endif
+#ifdef CT_L2_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L2_NAME, 2 + 1)
+#endif
+#ifdef CT_L3_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L3_NAME, 3 + 1)
+#endif
+#ifdef CT_L4_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L4_NAME, 4 + 1)
+#endif
+#ifdef CT_L5_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L5_NAME, 5 + 1)
+#endif
+#ifdef CT_L6_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L6_NAME, 6 + 1)
+#endif
+#ifdef CT_L7_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L7_NAME, 7 + 1)
+#endif
+#ifdef CT_L8_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L8_NAME, 8 + 1)
+#endif
+#ifdef CT_L9_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L9_NAME, 9 + 1)
+#endif
+#ifdef CT_L10_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L10_NAME, 10 + 1)
+#endif
+#ifdef CT_L11_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L11_NAME, 11 + 1)
+#endif
+#ifdef CT_L12_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L12_NAME, 12 + 1)
+#endif
+#ifdef CT_L13_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L13_NAME, 13 + 1)
+#endif
+#ifdef CT_L14_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L14_NAME, 14 + 1)
+#endif
+#ifdef CT_L15_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L15_NAME, 15 + 1)
+#endif
+#ifdef CT_L16_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L16_NAME, 16 + 1)
+#endif
+#ifdef CT_L17_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L17_NAME, 17 + 1)
+#endif
+#ifdef CT_L18_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L18_NAME, 18 + 1)
+#endif
+#ifdef CT_L19_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L19_NAME, 19 + 1)
+#endif
+#ifdef CT_L20_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L20_NAME, 20 + 1)
+#endif
+#ifdef CT_L21_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L21_NAME, 21 + 1)
+#endif
+#ifdef CT_L22_NAME
+            CT_RBD_CASE_HELPER_INERTIA_ID(CT_L22_NAME, 22 + 1)
+#endif
+
+            default:
+                throw std::runtime_error("getInertiaById: requested link does not exist");
+                break;
+        }
+    }
+#endif
+
 };  // class Utils
 
 
@@ -819,6 +917,31 @@ typedef Dynamics<RobCoGenContainer, Kinematics::NUM_EE> Dynamics;
 #undef CT_L21
 #undef CT_L22
 
+#undef CT_BASE_NAME
+#undef CT_L0_NAME
+#undef CT_L1_NAME
+#undef CT_L2_NAME
+#undef CT_L3_NAME
+#undef CT_L4_NAME
+#undef CT_L5_NAME
+#undef CT_L6_NAME
+#undef CT_L7_NAME
+#undef CT_L8_NAME
+#undef CT_L9_NAME
+#undef CT_L10_NAME
+#undef CT_L11_NAME
+#undef CT_L12_NAME
+#undef CT_L13_NAME
+#undef CT_L14_NAME
+#undef CT_L15_NAME
+#undef CT_L16_NAME
+#undef CT_L17_NAME
+#undef CT_L18_NAME
+#undef CT_L19_NAME
+#undef CT_L20_NAME
+#undef CT_L21_NAME
+#undef CT_L22_NAME
+
 #undef CT_EE0
 #undef CT_EE1
 #undef CT_EE2
@@ -927,3 +1050,5 @@ typedef Dynamics<RobCoGenContainer, Kinematics::NUM_EE> Dynamics;
 #undef CT_RBD_CASE_HELPER_ID_BASE
 #undef CT_RBD_CASE_HELPER_JOINT_BEGIN_ID_BASE
 #undef CT_RBD_CASE_HELPER_JOINT_END
+#undef CT_RBD_INERTIA_BY_NAME
+#undef CT_RBD_CASE_HELPER_INERTIA_ID
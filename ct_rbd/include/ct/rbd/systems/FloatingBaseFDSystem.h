@@ -7,6 +7,7 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 
 #include <ct/rbd/state/RigidBodyPose.h>
 #include <ct/rbd/physics/EEContactModel.h>
+#include <ct/rbd/robot/DynamicsDerivatives.h>
 
 #include "RBDSystem.h"
 
@@ -16,6 +17,9 @@ namespace rbd {
 /**
  * \brief A floating base rigid body system that uses forward dynamics. The input vector
  * is assumed to consist of joint torques and end-effector forces expressed in the world.
+ *
+ * \note the analytical derivatives, see computeDynamicsDerivatives(), are only available for Euler angle
+ * integration (QUAT_INTEGRATION = false) and differentiate the contact forces w.r.t. the state numerically.
  */
 template <class RBDDynamics, bool QUAT_INTEGRATION = false, bool EE_ARE_CONTROL_INPUTS = false>
 class FloatingBaseFDSystem : public RBDSystem<RBDDynamics, QUAT_INTEGRATION>,
@@ -47,7 +51,9 @@ public:
 
     FloatingBaseFDSystem() : Base(), dynamics_(), eeContactModel_(nullptr) {}
     FloatingBaseFDSystem(const FloatingBaseFDSystem<RBDDynamics, QUAT_INTEGRATION, EE_ARE_CONTROL_INPUTS>& other)
-        : Base(other), dynamics_(other.dynamics_), eeContactModel_(other.eeContactModel_->clone())
+        : Base(other),
+          dynamics_(other.dynamics_),
+          eeContactModel_(other.eeContactModel_ ? other.eeContactModel_->clone() : nullptr)
     {
     }
 
@@ -88,23 +94,129 @@ public:
         typename RBDDynamics::RBDState_t rbdCached = RBDStateFromVector(xLocal);
         typename RBDDynamics::ExtLinkForces_t linkForces(Eigen::Matrix<SCALAR, 6, 1>::Zero());
 
+        computeLinkForces(rbdCached, control, linkForces);
+
+        typename RBDDynamics::RBDAcceleration_t xd;
+
+        dynamics_.FloatingBaseForwardDynamics(rbdCached, control.template head<RBDDynamics::NJOINTS>(), linkForces, xd);
+
+        vDot = toStateDerivative<QUAT_INTEGRATION>(xd, rbdCached).tail(RBDDynamics::NSTATE / 2);
+    }
+
+    /**
+     * \brief Computes the derivatives of the velocity part of the dynamics analytically
+     *
+     * The rigid body dynamics are differentiated analytically using DynamicsDerivatives. The base orientation
+     * enters through the gravity vector in the base frame. The forces of the contact model are differentiated
+     * w.r.t. the state by one-sided finite differences, which only requires kinematics, and propagated through
+     * the dynamics analytically. Only available for Euler angle integration.
+     *
+     * @param x state
+     * @param control control input
+     * @param dVdx derivative of the velocity part of the dynamics w.r.t. the state
+     * @param dVdu derivative of the velocity part of the dynamics w.r.t. the control input
+     */
+    void computeDynamicsDerivatives(const StateVector& x,
+        const ControlVector& control,
+        Eigen::Matrix<SCALAR, RBDDynamics::NSTATE / 2, STATE_DIM>& dVdx,
+        Eigen::Matrix<SCALAR, RBDDynamics::NSTATE / 2, CONTROL_DIM>& dVdu)
+    {
+        static_assert(!QUAT_INTEGRATION, "Analytical derivatives are only available for Euler angle integration.");
+
+        const size_t NJOINTS = RBDDynamics::NJOINTS;
+        typedef DynamicsDerivatives<typename RBDDynamics::ROBCOGEN> Derivatives_t;
+
+        if (!derivatives_)
+            derivatives_ = std::shared_ptr<Derivatives_t>(new Derivatives_t());
+
+        typename RBDDynamics::RBDState_t rbdState = RBDStateFromVector(x);
+        typename RBDDynamics::ExtLinkForces_t linkForces(Eigen::Matrix<SCALAR, 6, 1>::Zero());
+        computeLinkForces(rbdState, control, linkForces);
+
+        typename Derivatives_t::dof_vector_t vd;
+        typename Derivatives_t::dof_joint_matrix_t dvd_dq;
+        typename Derivatives_t::dof_matrix_t dvd_dv;
+        typename Derivatives_t::dof_joint_matrix_t dvd_dtau;
+
+        derivatives_->forwardDynamicsDerivatives(rbdState.jointPositions(), x.template tail<RBDDynamics::NSTATE / 2>(),
+            control.template head<NJOINTS>(), linkForces, vd, dvd_dq, dvd_dv, dvd_dtau,
+            rbdState.basePose().computeGravityB6D());
+
+        dVdx.setZero();
+        dVdx.template block<3, 3>(3, 0) = gravityBDerivative(rbdState.basePose().getEulerAnglesXyz().toImplementation(),
+            tpl::RigidBodyPose<SCALAR>::gravity3DW());
+        dVdx.template block<RBDDynamics::NSTATE / 2, NJOINTS>(0, 6) = dvd_dq;
+        dVdx.template rightCols<RBDDynamics::NSTATE / 2>() = dvd_dv;
+
+        dVdu.setZero();
+        dVdu.template leftCols<NJOINTS>() = dvd_dtau;
+
+        if (!eeContactModel_ && !EE_ARE_CONTROL_INPUTS)
+            return;
+
+        std::array<typename Derivatives_t::dof_force_matrix_t, N_EE> dvd_df;
+        for (size_t i = 0; i < N_EE; i++)
+            derivatives_->externalForceDerivative(dynamics_.kinematics().getEndEffector(i).getLinkId(), dvd_df[i]);
+
+        // the end-effector forces are linear in the control inputs
+        if (EE_ARE_CONTROL_INPUTS)
+        {
+            for (size_t i = 0; i < N_EE; i++)
+                for (size_t m = 0; m < 3; m++)
+                    dVdu.col(NJOINTS + 3 * i + m) =
+                        dvd_df[i] * dynamics_.kinematics().mapForceFromWorldToLink3d(
+                                        Kinematics::EEForceLinear::Unit(m), rbdState.basePose(),
+                                        rbdState.jointPositions(), i);
+        }
+
+        // the state dependency of the contact forces and of their mapping to the links is differentiated numerically
+        const SCALAR eps = std::sqrt(Eigen::NumTraits<SCALAR>::epsilon());
+        typename RBDDynamics::ExtLinkForces_t linkForcesPerturbed(Eigen::Matrix<SCALAR, 6, 1>::Zero());
+
+        for (size_t k = 0; k < STATE_DIM; k++)
+        {
+            StateVector xPerturbed = x;
+            const SCALAR h = eps * std::max(std::abs(x(k)), SCALAR(1.0));
+            xPerturbed(k) += h;
+
+            computeLinkForces(RBDStateFromVector(xPerturbed), control, linkForcesPerturbed);
+
+            std::array<bool, RBDDynamics::NLINKS> visited;
+            visited.fill(false);
+            for (size_t i = 0; i < N_EE; i++)
+            {
+                const size_t linkId = dynamics_.kinematics().getEndEffector(i).getLinkId();
+                if (visited[linkId])
+                    continue;
+                visited[linkId] = true;
+
+                const auto link = static_cast<typename RBDDynamics::ROBCOGEN::LinkIdentifiers>(linkId);
+                dVdx.col(k) += dvd_df[i] * (linkForcesPerturbed[link] - linkForces[link]) / h;
+            }
+        }
+    }
+
+    /**
+     * Computes the external link forces resulting from the contact model and the end-effector forces in the control
+     * @param state robot state
+     * @param control control input
+     * @param linkForces forces acting on the links expressed in the link frames
+     */
+    void computeLinkForces(const typename RBDDynamics::RBDState_t& state,
+        const ControlVector& control,
+        typename RBDDynamics::ExtLinkForces_t& linkForces)
+    {
         std::array<typename Kinematics::EEForceLinear, N_EE> eeForcesW;
         eeForcesW.fill(Kinematics::EEForceLinear::Zero());
 
         if (eeContactModel_)
-            eeForcesW = eeContactModel_->computeContactForces(rbdCached);
+            eeForcesW = eeContactModel_->computeContactForces(state);
 
         if (EE_ARE_CONTROL_INPUTS)
             for (size_t i = 0; i < N_EE; i++)
                 eeForcesW[i] += control.template segment<3>(RBDDynamics::NJOINTS + i * 3);
 
-        mapEndeffectorForcesToLinkForces(rbdCached, eeForcesW, linkForces);
-
-        typename RBDDynamics::RBDAcceleration_t xd;
-
-        dynamics_.FloatingBaseForwardDynamics(rbdCached, control.template head<RBDDynamics::NJOINTS>(), linkForces, xd);
-
-        vDot = toStateDerivative<QUAT_INTEGRATION>(xd, rbdCached).tail(RBDDynamics::NSTATE / 2);
+        mapEndeffectorForcesToLinkForces(state, eeForcesW, linkForces);
     }
 
     /**
@@ -182,8 +294,30 @@ public:
     }
 
 private:
+    /**
+     * derivative of the gravity vector in the base frame, \f$ R^T g \f$, w.r.t. the Euler angles xyz
+     * with \f$ R = R_x R_y R_z \f$
+     */
+    static Eigen::Matrix<SCALAR, 3, 3> gravityBDerivative(const Eigen::Matrix<SCALAR, 3, 1>& eulerXyz,
+        const Eigen::Matrix<SCALAR, 3, 1>& gravityW)
+    {
+        typedef Eigen::Matrix<SCALAR, 3, 1> Vector3;
+        const Eigen::Matrix<SCALAR, 3, 3> Rx(Eigen::AngleAxis<SCALAR>(eulerXyz(0), Vector3::UnitX()));
+        const Eigen::Matrix<SCALAR, 3, 3> Ry(Eigen::AngleAxis<SCALAR>(eulerXyz(1), Vector3::UnitY()));
+        const Eigen::Matrix<SCALAR, 3, 3> Rz(Eigen::AngleAxis<SCALAR>(eulerXyz(2), Vector3::UnitZ()));
+        const Eigen::Matrix<SCALAR, 3, 3> RyRz = Ry * Rz;
+        const Eigen::Matrix<SCALAR, 3, 3> R = Rx * RyRz;
+
+        Eigen::Matrix<SCALAR, 3, 3> dgdEuler;
+        dgdEuler.col(0) = -R.transpose() * Vector3::UnitX().cross(gravityW);
+        dgdEuler.col(1) = -RyRz.transpose() * Vector3::UnitY().cross(Rx.transpose() * gravityW);
+        dgdEuler.col(2) = -Vector3::UnitZ().cross(R.transpose() * gravityW);
+        return dgdEuler;
+    }
+
     RBDDynamics dynamics_;
     std::shared_ptr<ContactModel> eeContactModel_;
+    std::shared_ptr<DynamicsDerivatives<typename RBDDynamics::ROBCOGEN>> derivatives_;
 };
 
 }  // namespace rbd
@@ -0,0 +1,95 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include "LieGroupIntegrator.h"
+
+namespace ct {
+namespace rbd {
+
+/**
+ * \brief Discretizes a floating base system with the LieGroupStepper
+ *
+ * A ct::core::SystemDiscretizer for systems whose state is ordered as the RBDState vector, e.g. FloatingBaseFDSystem.
+ * In every call to propagateControlledDynamics(), the continuous-time system is integrated over the interval dt with
+ * K_sim steps of the LieGroupStepper and a constant control input, such that the base orientation remains on the
+ * manifold for any step size.
+ *
+ * NLOC uses it via a DiscreteOptConProblem, linearized e.g. by a ct::core::DiscreteSystemLinearizer:
+ * \code
+ * std::shared_ptr<LieGroupDiscretizer<NJOINTS, CONTROL_DIM>> discretizer(
+ *     new LieGroupDiscretizer<NJOINTS, CONTROL_DIM>(system, dt, RKMK4));
+ * std::shared_ptr<ct::core::DiscreteSystemLinearizer<STATE_DIM, CONTROL_DIM>> linearizer(
+ *     new ct::core::DiscreteSystemLinearizer<STATE_DIM, CONTROL_DIM>(discretizer));
+ * ct::optcon::DiscreteOptConProblem<STATE_DIM, CONTROL_DIM> problem(N, x0, discretizer, costFunction, linearizer);
+ * ct::optcon::NLOptConSolver<STATE_DIM, CONTROL_DIM, STATE_DIM / 2, STATE_DIM / 2, double, false> solver(problem, s);
+ * \endcode
+ *
+ * @tparam NJOINTS number of joints
+ * @tparam CONTROL_DIM control dimension
+ * @tparam QUAT_INTEGRATION true if the base orientation is represented as quaternion in the state vector
+ * @tparam SCALAR the scalar type
+ */
+template <size_t NJOINTS, size_t CONTROL_DIM, bool QUAT_INTEGRATION = false, typename SCALAR = double>
+class LieGroupDiscretizer
+    : public core::SystemDiscretizer<LieGroupStepper<NJOINTS, QUAT_INTEGRATION, SCALAR>::STATE_DIM,
+          CONTROL_DIM,
+          LieGroupStepper<NJOINTS, QUAT_INTEGRATION, SCALAR>::STATE_DIM / 2,
+          LieGroupStepper<NJOINTS, QUAT_INTEGRATION, SCALAR>::STATE_DIM / 2,
+          SCALAR>
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef LieGroupStepper<NJOINTS, QUAT_INTEGRATION, SCALAR> Stepper_t;
+    static const size_t STATE_DIM = Stepper_t::STATE_DIM;
+
+    typedef core::SystemDiscretizer<STATE_DIM, CONTROL_DIM, STATE_DIM / 2, STATE_DIM / 2, SCALAR> Base;
+    typedef typename Base::ContinuousSystemPtr ContinuousSystemPtr;
+    typedef typename Base::StepperPtr StepperPtr;
+
+    /**
+     * @brief      The constructor
+     *
+     * @param[in]  system  The continuous-time system, its state is ordered as the RBDState vector
+     * @param[in]  dt      The discretization time interval
+     * @param[in]  type    The integration scheme
+     * @param[in]  K_sim   The number of integration steps per interval
+     */
+    LieGroupDiscretizer(ContinuousSystemPtr system,
+        const SCALAR& dt,
+        const LieGroupIntegrationType& type = RKMK4,
+        const int& K_sim = 1)
+        : Base(dt, core::IntegrationType::RK4, K_sim), type_(type)
+    {
+        this->setStepper(StepperPtr(new Stepper_t(type_)));
+        this->changeContinuousTimeSystem(system);
+    }
+
+    //! copy constructor, clones the continuous-time system
+    LieGroupDiscretizer(const LieGroupDiscretizer& arg) : Base(arg), type_(arg.type_)
+    {
+        this->setStepper(StepperPtr(new Stepper_t(type_)));
+        this->initialize();
+    }
+
+    ~LieGroupDiscretizer() override = default;
+
+    LieGroupDiscretizer* clone() const override { return new LieGroupDiscretizer(*this); }
+    //! update the integration scheme
+    void setIntegrationType(const LieGroupIntegrationType& type)
+    {
+        type_ = type;
+        this->setStepper(StepperPtr(new Stepper_t(type_)));
+        this->initialize();
+    }
+
+private:
+    LieGroupIntegrationType type_;
+};
+
+}  // namespace rbd
+}  // namespace ct
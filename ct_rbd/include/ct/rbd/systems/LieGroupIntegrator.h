@@ -0,0 +1,365 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <ct/rbd/state/RBDState.h>
+
+namespace ct {
+namespace rbd {
+
+/**
+ * @brief      The available Lie group integration types
+ */
+enum LieGroupIntegrationType
+{
+    LIE_EULER_SYM,  //!< symplectic Lie-Euler, first order
+    RKMK4           //!< Runge-Kutta-Munthe-Kaas based on the classical Runge-Kutta scheme, fourth order
+};
+
+/**
+ * \brief A stepper on the manifold SE(3) x R^n for floating base systems
+ *
+ * The base pose is updated with the exponential map of SE(3), driven by the base twist in base coordinates, and the
+ * joint positions and all velocities as vectors. The state is ordered as the RBDState vector, with either Euler angle
+ * (QUAT_INTEGRATION = false) or quaternion (QUAT_INTEGRATION = true) representation of the base orientation.
+ *
+ * Two schemes are available:
+ *  - LIE_EULER_SYM: the velocities are updated first, the configuration is then moved along the new twist
+ *  - RKMK4: the classical fourth order Runge-Kutta scheme in the Lie algebra, using the inverse of the derivative of
+ *    the exponential map truncated after the second order commutator
+ *
+ * @tparam NJOINTS number of joints
+ * @tparam QUAT_INTEGRATION true if the base orientation is represented as quaternion in the state vector
+ * @tparam SCALAR the scalar type
+ */
+template <size_t NJOINTS, bool QUAT_INTEGRATION = false, typename SCALAR = double>
+class LieGroupStepper
+    : public core::internal::StepperCTBase<Eigen::Matrix<SCALAR, 2 * (6 + NJOINTS) + QUAT_INTEGRATION, 1>, SCALAR>
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    static const size_t NV = 6 + NJOINTS;
+    static const size_t STATE_DIM = 2 * NV + QUAT_INTEGRATION;
+
+    typedef Eigen::Matrix<SCALAR, STATE_DIM, 1> StateVector;
+    typedef Eigen::Matrix<SCALAR, NV, 1> Velocity;
+    typedef Eigen::Matrix<SCALAR, 3, 3> Matrix3;
+    typedef Eigen::Matrix<SCALAR, 3, 1> Vector3;
+    typedef std::function<void(const StateVector&, StateVector&, SCALAR)> Rhs;
+
+    //! the configuration of the floating base system, i.e. an element of SE(3) x R^n
+    struct Configuration
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+        Matrix3 R;                                 //!< rotation from base to world coordinates
+        Vector3 p;                                 //!< base position in world coordinates
+        Eigen::Matrix<SCALAR, NJOINTS, 1> joints;  //!< joint positions
+    };
+
+    LieGroupStepper(const LieGroupIntegrationType& type = RKMK4) : type_(type) {}
+    //! performs numSteps integration steps, the initial state is observed as well
+    void integrate_n_steps(std::function<void(const StateVector& x, const SCALAR& t)> observe,
+        const Rhs& rhs,
+        StateVector& state,
+        const SCALAR& startTime,
+        size_t numSteps,
+        SCALAR dt) override
+    {
+        SCALAR time = startTime;
+        observe(state, time);
+
+        for (size_t i = 0; i < numSteps; ++i)
+        {
+            do_step(rhs, state, time, dt);
+            time += dt;
+            observe(state, time);
+        }
+    }
+
+    /**
+     * @brief the configuration moved along the Lie algebra element, g * exp(xi)
+     *
+     * @param g the configuration
+     * @param xi base rotation and translation in base coordinates followed by the joint displacements
+     */
+    static Configuration exp(const Configuration& g, const Velocity& xi)
+    {
+        const Vector3 phi = xi.template head<3>();
+        const Matrix3 Phi = skew(phi);
+
+        // Rodrigues' formula and the left Jacobian of SO(3)
+        SCALAR a, b, c;
+        expCoefficients(phi.squaredNorm(), a, b, c);
+
+        const Matrix3 expPhi = Matrix3::Identity() + a * Phi + b * Phi * Phi;
+        const Matrix3 V = Matrix3::Identity() + b * Phi + c * Phi * Phi;
+
+        Configuration result;
+        result.R = g.R * expPhi;
+        result.p = g.p + g.R * V * xi.template segment<3>(3);
+        result.joints = g.joints + xi.template tail<NJOINTS>();
+        return result;
+    }
+
+    /**
+     * @brief the inverse of the derivative of the exponential map, truncated after the second order commutator
+     *
+     * Maps the velocity at g0 * exp(theta) to the time derivative of theta. The joint part is commutative.
+     */
+    static Velocity dexpInv(const Velocity& theta, const Velocity& xi)
+    {
+        const Velocity thetaXi = bracket(theta, xi);
+        return xi + SCALAR(0.5) * thetaXi + SCALAR(1.0 / 12.0) * bracket(theta, thetaXi);
+    }
+
+    //! the commutator of se(3) x R^n for twists ordered as (angular, linear, joints)
+    static Velocity bracket(const Velocity& x, const Velocity& y)
+    {
+        Velocity result = Velocity::Zero();
+        result.template head<3>() = x.template head<3>().cross(y.template head<3>());
+        result.template segment<3>(3) =
+            x.template head<3>().cross(y.template segment<3>(3)) - y.template head<3>().cross(x.template segment<3>(3));
+        return result;
+    }
+
+private:
+    //! performs a single integration step
+    void do_step(const Rhs& rhs, StateVector& state, const SCALAR time, const SCALAR dt) override
+    {
+        Configuration g0;
+        Velocity w0;
+        fromStateVector(state, g0, w0);
+
+        if (type_ == LIE_EULER_SYM)
+        {
+            const Velocity w1 = w0 + dt * velocityDerivative(rhs, g0, w0, time);
+            state = toStateVector(exp(g0, dt * w1), w1);
+            return;
+        }
+
+        // Runge-Kutta-Munthe-Kaas, the stages are parameterized by the Lie algebra element theta, g = g0 * exp(theta)
+        const SCALAR halfStep = SCALAR(0.5) * dt;
+
+        const Velocity k1 = w0;
+        const Velocity a1 = velocityDerivative(rhs, g0, w0, time);
+
+        Velocity theta = halfStep * k1;
+        Velocity w = w0 + halfStep * a1;
+        const Velocity k2 = dexpInv(theta, w);
+        const Velocity a2 = velocityDerivative(rhs, exp(g0, theta), w, time + halfStep);
+
+        theta = halfStep * k2;
+        w = w0 + halfStep * a2;
+        const Velocity k3 = dexpInv(theta, w);
+        const Velocity a3 = velocityDerivative(rhs, exp(g0, theta), w, time + halfStep);
+
+        theta = dt * k3;
+        w = w0 + dt * a3;
+        const Velocity k4 = dexpInv(theta, w);
+        const Velocity a4 = velocityDerivative(rhs, exp(g0, theta), w, time + dt);
+
+        const SCALAR sixthStep = dt / SCALAR(6.0);
+        theta = sixthStep * (k1 + SCALAR(2.0) * k2 + SCALAR(2.0) * k3 + k4);
+        w = w0 + sixthStep * (a1 + SCALAR(2.0) * a2 + SCALAR(2.0) * a3 + a4);
+        state = toStateVector(exp(g0, theta), w);
+    }
+
+    //! the coefficients of exp(), switches to Taylor expansions for small angles
+    template <typename S = SCALAR>
+    static typename std::enable_if<std::is_floating_point<S>::value, void>::type expCoefficients(const S& angle2,
+        S& a,
+        S& b,
+        S& c)
+    {
+        if (angle2 < S(SMALL_ANGLE2))
+            expCoefficientsTaylor(angle2, a, b, c);
+        else
+            expCoefficientsExact(angle2, a, b, c);
+    }
+
+    //! the coefficients of exp() for auto-diff types, both branches are recorded and selected by the angle
+    template <typename S = SCALAR>
+    static typename std::enable_if<!std::is_floating_point<S>::value, void>::type expCoefficients(const S& angle2,
+        S& a,
+        S& b,
+        S& c)
+    {
+        // CondExp* are found by argument dependent lookup. The exact branch is evaluated at a safe angle if it is not
+        // selected, such that it does not divide by zero.
+        const S smallAngle2(SMALL_ANGLE2);
+        S aTaylor, bTaylor, cTaylor;
+        expCoefficientsTaylor(angle2, aTaylor, bTaylor, cTaylor);
+        expCoefficientsExact(CondExpLt(angle2, smallAngle2, S(1.0), angle2), a, b, c);
+
+        a = CondExpLt(angle2, smallAngle2, aTaylor, a);
+        b = CondExpLt(angle2, smallAngle2, bTaylor, b);
+        c = CondExpLt(angle2, smallAngle2, cTaylor, c);
+    }
+
+    static void expCoefficientsTaylor(const SCALAR& angle2, SCALAR& a, SCALAR& b, SCALAR& c)
+    {
+        a = SCALAR(1.0) - angle2 / SCALAR(6.0) * (SCALAR(1.0) - angle2 / SCALAR(20.0));
+        b = SCALAR(0.5) - angle2 / SCALAR(24.0) * (SCALAR(1.0) - angle2 / SCALAR(30.0));
+        c = SCALAR(1.0 / 6.0) - angle2 / SCALAR(120.0) * (SCALAR(1.0) - angle2 / SCALAR(42.0));
+    }
+
+    static void expCoefficientsExact(const SCALAR& angle2, SCALAR& a, SCALAR& b, SCALAR& c)
+    {
+        typedef typename core::tpl::TraitSelector<SCALAR>::Trait Trait;
+
+        const SCALAR angle = Trait::sqrt(angle2);
+        const SCALAR sinAngle = Trait::sin(angle);
+        a = sinAngle / angle;
+        b = (SCALAR(1.0) - Trait::cos(angle)) / angle2;
+        c = (angle - sinAngle) / (angle2 * angle);
+    }
+
+    static Matrix3 skew(const Vector3& v)
+    {
+        Matrix3 S;
+        S << SCALAR(0.0), -v(2), v(1), v(2), SCALAR(0.0), -v(0), -v(1), v(0), SCALAR(0.0);
+        return S;
+    }
+
+    //! the derivative of the velocities from the system dynamics
+    Velocity velocityDerivative(const Rhs& rhs, const Configuration& g, const Velocity& w, const SCALAR& time)
+    {
+        StateVector derivative;
+        rhs(toStateVector(g, w), derivative, time);
+        return derivative.template tail<NV>();
+    }
+
+    void fromStateVector(const StateVector& state, Configuration& g, Velocity& w) const
+    {
+        RBDState<NJOINTS, SCALAR> rbdState(
+            QUAT_INTEGRATION ? tpl::RigidBodyPose<SCALAR>::QUAT : tpl::RigidBodyPose<SCALAR>::EULER);
+        fromStateVectorImpl<QUAT_INTEGRATION>(state, rbdState);
+
+        g.R = rbdState.basePose().getRotationMatrix().toImplementation();
+        g.p = rbdState.basePose().position().toImplementation();
+        g.joints = rbdState.jointPositions();
+        w = state.template tail<NV>();
+    }
+
+    StateVector toStateVector(const Configuration& g, const Velocity& w) const
+    {
+        RBDState<NJOINTS, SCALAR> rbdState(
+            QUAT_INTEGRATION ? tpl::RigidBodyPose<SCALAR>::QUAT : tpl::RigidBodyPose<SCALAR>::EULER);
+        rbdState.basePose().setFromRotationMatrix(kindr::RotationMatrix<SCALAR>(g.R));
+        rbdState.basePose().position().toImplementation() = g.p;
+        rbdState.jointPositions() = g.joints;
+
+        StateVector state = toStateVectorImpl<QUAT_INTEGRATION>(rbdState);
+        state.template tail<NV>() = w;
+        return state;
+    }
+
+    template <bool T>
+    static void fromStateVectorImpl(const StateVector& state,
+        RBDState<NJOINTS, SCALAR>& rbdState,
+        typename std::enable_if<T, bool>::type = true)
+    {
+        rbdState.fromStateVectorQuaternion(state);
+    }
+
+    template <bool T>
+    static void fromStateVectorImpl(const StateVector& state,
+        RBDState<NJOINTS, SCALAR>& rbdState,
+        typename std::enable_if<!T, bool>::type = true)
+    {
+        rbdState.fromStateVectorEulerXyz(state);
+    }
+
+    template <bool T>
+    static StateVector toStateVectorImpl(const RBDState<NJOINTS, SCALAR>& rbdState,
+        typename std::enable_if<T, bool>::type = true)
+    {
+        return rbdState.toStateVectorQuaternion();
+    }
+
+    template <bool T>
+    static StateVector toStateVectorImpl(const RBDState<NJOINTS, SCALAR>& rbdState,
+        typename std::enable_if<!T, bool>::type = true)
+    {
+        return rbdState.toStateVectorEulerXyz();
+    }
+
+    //! squared rotation angle below which the Taylor expansions of the exp() coefficients are used
+    static constexpr double SMALL_ANGLE2 = 1e-6;
+
+    LieGroupIntegrationType type_;
+};
+
+template <size_t NJOINTS, bool QUAT_INTEGRATION, typename SCALAR>
+constexpr double LieGroupStepper<NJOINTS, QUAT_INTEGRATION, SCALAR>::SMALL_ANGLE2;
+
+
+/**
+ * \brief Integrates floating base systems on the manifold SE(3) x R^n
+ *
+ * The vector space integrators of ct::core treat the base orientation as a vector of Euler angles or quaternion
+ * coefficients, which requires small steps close to the singularities of the Euler angles or a renormalization of
+ * the quaternion. This integrator takes its steps with the LieGroupStepper, such that the base orientation remains
+ * exactly on the manifold independent of the step size and the Euler angles are only used to represent the state.
+ *
+ * The system can be any system whose state is ordered as the RBDState vector, e.g. FloatingBaseFDSystem. The
+ * integrator is a ct::core::Integrator with a custom stepper, hence it offers the same integration and event handling
+ * methods. Use LieGroupDiscretizer to discretize a system with it.
+ *
+ * @tparam NJOINTS number of joints
+ * @tparam QUAT_INTEGRATION true if the base orientation is represented as quaternion in the state vector
+ * @tparam SCALAR the scalar type
+ */
+template <size_t NJOINTS, bool QUAT_INTEGRATION = false, typename SCALAR = double>
+class LieGroupIntegrator
+    : public core::Integrator<LieGroupStepper<NJOINTS, QUAT_INTEGRATION, SCALAR>::STATE_DIM, SCALAR>
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef LieGroupStepper<NJOINTS, QUAT_INTEGRATION, SCALAR> Stepper_t;
+    static const size_t NV = Stepper_t::NV;
+    static const size_t STATE_DIM = Stepper_t::STATE_DIM;
+
+    typedef core::Integrator<STATE_DIM, SCALAR> Base;
+    typedef typename Base::StepperPtr StepperPtr;
+    typedef typename Base::EventHandlerPtrVector EventHandlerPtrVector;
+    typedef typename Stepper_t::Configuration Configuration;
+    typedef typename Stepper_t::Velocity Velocity;
+
+    /**
+     * @brief      The constructor
+     *
+     * @param[in]  system         The system, its state is ordered as the RBDState vector
+     * @param[in]  type           The integration scheme
+     * @param[in]  eventHandlers  The event handlers
+     */
+    LieGroupIntegrator(const std::shared_ptr<core::System<STATE_DIM, SCALAR>>& system,
+        const LieGroupIntegrationType& type = RKMK4,
+        const EventHandlerPtrVector& eventHandlers = EventHandlerPtrVector(0))
+        : Base(system, StepperPtr(new Stepper_t(type)), eventHandlers)
+    {
+    }
+
+    using Base::changeIntegrationType;
+
+    //! changes the Lie group integration scheme
+    void changeIntegrationType(const LieGroupIntegrationType& type)
+    {
+        this->changeStepper(StepperPtr(new Stepper_t(type)));
+    }
+
+    //! see LieGroupStepper::exp()
+    static Configuration exp(const Configuration& g, const Velocity& xi) { return Stepper_t::exp(g, xi); }
+    //! see LieGroupStepper::dexpInv()
+    static Velocity dexpInv(const Velocity& theta, const Velocity& xi) { return Stepper_t::dexpInv(theta, xi); }
+    //! see LieGroupStepper::bracket()
+    static Velocity bracket(const Velocity& x, const Velocity& y) { return Stepper_t::bracket(x, y); }
+};
+
+}  // namespace rbd
+}  // namespace ct
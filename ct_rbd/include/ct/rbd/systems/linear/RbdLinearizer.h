@@ -11,12 +11,24 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
  *  systems. If the system is fixed-base, the standard ct_core linearizer
  *  is called.
  *
+ *  Optionally, the derivatives of the dynamics are computed analytically by differentiating
+ *  the recursive Newton-Euler algorithm, see DynamicsDerivatives. The control input is mapped
+ *  to the joint torques through the selection matrix of the dynamics. For floating-base systems,
+ *  this requires the system to provide computeDynamicsDerivatives(), see FloatingBaseFDSystem,
+ *  which supports Euler angle integration only and differentiates the contact forces numerically.
+ *
+ *  Fixed-base systems whose state or control input is not the pure rigid body state and the
+ *  joint torques, e.g. systems with actuator dynamics or end-effector forces as control inputs,
+ *  are linearized by numerical differentiation.
+ *
  */
 
 #pragma once
 
 #include <memory>
 
+#include <ct/rbd/robot/DynamicsDerivatives.h>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #pragma GCC diagnostic ignored "-Wunused-value"
@@ -46,11 +58,14 @@ public:
     static const size_t STATE_DIM = SYSTEM::STATE_DIM;
     static const size_t CONTROL_DIM = SYSTEM::CONTROL_DIM;
     static const size_t NJOINTS = SYSTEM::Dynamics::NJOINTS;
+    static const size_t NDOF = NJOINTS + FLOATING_BASE * 6;
 
-    static_assert(SYSTEM::STATE_DIM == 2 * (SYSTEM::Dynamics::NJOINTS + FLOATING_BASE * 6),
-        "STATE DIMENSION MISMATCH. RBD LINEARIZER ONLY WORKS FOR PURE RIGID BODY DYNAMICS.");
-    static_assert(SYSTEM::CONTROL_DIM == SYSTEM::Dynamics::NJOINTS,
-        "CONTROL DIMENSION MISMATCH. RBD LINEARIZER ONLY WORKS FOR FULL JOINT CONTROLLED SYSTEMS.");
+    //! true if the state is the rigid body state and the control input are the joint torques
+    static const bool JOINT_TORQUE_CONTROLLED = (STATE_DIM == 2 * NDOF) && (CONTROL_DIM == NJOINTS);
+
+    static_assert(JOINT_TORQUE_CONTROLLED || !FLOATING_BASE,
+        "DIMENSION MISMATCH. RBD LINEARIZER ONLY WORKS FOR FLOATING BASE SYSTEMS WITH PURE RIGID BODY DYNAMICS AND "
+        "FULL JOINT CONTROL.");
 
 
     typedef ct::core::SystemLinearizer<STATE_DIM, CONTROL_DIM, SCALAR> Base;
@@ -62,11 +77,30 @@ public:
     typedef ct::core::StateControlMatrix<STATE_DIM, CONTROL_DIM, SCALAR> state_control_matrix_t;
 
 
-    RbdLinearizer(std::shared_ptr<SYSTEM> RBDSystem, bool doubleSidedDerivative = false)
-        : Base(RBDSystem, doubleSidedDerivative), RBDSystem_(RBDSystem)
+    /*!
+     * @param RBDSystem the rigid body system
+     * @param doubleSidedDerivative use central differences for the numerical derivatives
+     * @param analyticalDerivatives compute the derivatives w.r.t. the state analytically instead of numerically
+     */
+    RbdLinearizer(std::shared_ptr<SYSTEM> RBDSystem,
+        bool doubleSidedDerivative = false,
+        bool analyticalDerivatives = false)
+        : Base(RBDSystem, doubleSidedDerivative),
+          RBDSystem_(RBDSystem),
+          analyticalDerivatives_(analyticalDerivatives && JOINT_TORQUE_CONTROLLED),
+          analyticalDerivativesValid_(false)
     {
+        if (analyticalDerivatives && !JOINT_TORQUE_CONTROLLED)
+        {
+            std::cout << "RbdLinearizer.h: Warning, analytical derivatives require a rigid body system controlled by "
+                      << "its joint torques. Falling back to numerical differentiation." << std::endl;
+        }
+
+        if (analyticalDerivatives_ && !FLOATING_BASE)
+            derivatives_ = std::shared_ptr<Derivatives_t>(new Derivatives_t());
+
         // check if a non-floating base system is a second order system
-        if (!FLOATING_BASE && (this->getType() != ct::core::SYSTEM_TYPE::SECOND_ORDER))
+        if (!FLOATING_BASE && JOINT_TORQUE_CONTROLLED && (this->getType() != ct::core::SYSTEM_TYPE::SECOND_ORDER))
         {
             std::cout
                 << "RbdLinearizer.h: Warning, fixed base system not declared as second order system. "
@@ -82,7 +116,15 @@ public:
         this->dFdu_.template topRows<STATE_DIM / 2>().setZero();
     }
 
-    RbdLinearizer(const RbdLinearizer& arg) : Base(arg), RBDSystem_(std::shared_ptr<SYSTEM>(arg.RBDSystem_->clone())) {}
+    RbdLinearizer(const RbdLinearizer& arg)
+        : Base(arg),
+          RBDSystem_(std::shared_ptr<SYSTEM>(arg.RBDSystem_->clone())),
+          analyticalDerivatives_(arg.analyticalDerivatives_),
+          analyticalDerivativesValid_(false)
+    {
+        if (arg.derivatives_)
+            derivatives_ = std::shared_ptr<Derivatives_t>(new Derivatives_t());
+    }
     virtual ~RbdLinearizer() override {}
     RbdLinearizer<SYSTEM>* clone() const override { return new RbdLinearizer<SYSTEM>(*this); }
     const state_matrix_t& getDerivativeState(const state_vector_t& x,
@@ -91,12 +133,29 @@ public:
     {
         if (!FLOATING_BASE)
         {
-            // call standard ct_core linearizer
-            return Base::getDerivativeState(x, u, t);
+            if (!analyticalDerivatives_)
+            {
+                // call standard ct_core linearizer
+                return Base::getDerivativeState(x, u, t);
+            }
+
+            computeAnalyticalDynamicsDerivatives(x, u);
+            this->dFdx_.template block<NDOF, STATE_DIM>(NDOF, 0) = dVdx_;
+
+            return this->dFdx_;
         }
         else
         {
-            Base::getDerivativeState(x, u, t);
+            if (analyticalDerivatives_)
+            {
+                computeAnalyticalDynamicsDerivatives(x, u);
+
+                this->dFdx_.template block<NDOF, STATE_DIM>(NDOF, 0) = dVdx_;
+                this->dFdx_.template topRows<STATE_DIM / 2>().setZero();
+                this->dFdx_.template topRightCorner<STATE_DIM / 2, STATE_DIM / 2>().setIdentity();
+            }
+            else
+                Base::getDerivativeState(x, u, t);
 
             // since we express base pose in world but base twist in body coordinates, we have to modify the top part
             kindr::EulerAnglesXyz<SCALAR> eulerXyz(x.template topRows<3>());
@@ -132,6 +191,18 @@ public:
         const control_vector_t& u,
         const SCALAR t = 0.0) override
     {
+        if (!JOINT_TORQUE_CONTROLLED)
+            return Base::getDerivativeControl(x, u, t);
+
+        if (analyticalDerivatives_)
+        {
+            // usually a by-product of the derivatives w.r.t. the state at the same point
+            computeAnalyticalDynamicsDerivatives(x, u);
+            this->dFdu_.template block<NDOF, CONTROL_DIM>(NDOF, 0) = dVdu_;
+
+            return this->dFdu_;
+        }
+
         const jsim_t& M = RBDSystem_->dynamics().kinematics().robcogen().jSim().update(
             x.template segment<NJOINTS>(FLOATING_BASE * 6));
 
@@ -160,7 +231,7 @@ public:
 
         auto& S = RBDSystem_->dynamics().S();
 
-        this->dFdu_.template block<STATE_DIM / 2, CONTROL_DIM>(STATE_DIM / 2, 0) = M_inv * S.transpose();
+        this->dFdu_.template block<NDOF, NJOINTS>(NDOF, 0) = M_inv * S.transpose();
 
         return this->dFdu_;
     }
@@ -168,12 +239,76 @@ public:
 
 protected:
     typedef typename SYSTEM::Dynamics::ROBCOGEN::JSIM jsim_t;
+    typedef DynamicsDerivatives<typename SYSTEM::Dynamics::ROBCOGEN> Derivatives_t;
 
     std::shared_ptr<SYSTEM> RBDSystem_;
 
+    bool analyticalDerivatives_;
+    std::shared_ptr<Derivatives_t> derivatives_;
+    Eigen::Matrix<SCALAR, NDOF, STATE_DIM> dVdx_;
+    Eigen::Matrix<SCALAR, NDOF, CONTROL_DIM> dVdu_;
+
+    //! the point at which dVdx_ and dVdu_ were computed
+    bool analyticalDerivativesValid_;
+    state_vector_t xAnalytical_;
+    control_vector_t uAnalytical_;
+
     Eigen::LLT<typename jsim_t::MatrixType> llt_;
 
 private:
+    //! computes dVdx_ and dVdu_, unless they are available for the same point already
+    void computeAnalyticalDynamicsDerivatives(const state_vector_t& x, const control_vector_t& u)
+    {
+        if (analyticalDerivativesValid_ && x == xAnalytical_ && u == uAnalytical_)
+            return;
+
+        computeAnalyticalDynamicsDerivativesImpl(x, u);
+
+        xAnalytical_ = x;
+        uAnalytical_ = u;
+        analyticalDerivativesValid_ = true;
+    }
+
+    //! analytical derivatives of the velocity part of the dynamics, provided by the floating base system
+    template <bool FB = FLOATING_BASE>
+    typename std::enable_if<FB, void>::type computeAnalyticalDynamicsDerivativesImpl(const state_vector_t& x,
+        const control_vector_t& u)
+    {
+        RBDSystem_->computeDynamicsDerivatives(x, u, dVdx_, dVdu_);
+    }
+
+    //! analytical derivatives of the joint accelerations of a joint torque controlled fixed base system
+    template <bool FB = FLOATING_BASE>
+    typename std::enable_if<!FB && JOINT_TORQUE_CONTROLLED, void>::type computeAnalyticalDynamicsDerivativesImpl(
+        const state_vector_t& x,
+        const control_vector_t& u)
+    {
+        typename Derivatives_t::dof_vector_t qdd;
+        typename Derivatives_t::dof_joint_matrix_t dqdd_dq;
+        typename Derivatives_t::dof_matrix_t dqdd_dqd;
+        typename Derivatives_t::dof_joint_matrix_t dqdd_dtau;
+        typename Derivatives_t::ExtLinkForces_t fext(Eigen::Matrix<SCALAR, 6, 1>::Zero());
+
+        // the control input enters the dynamics through the selection matrix
+        const Eigen::Matrix<SCALAR, NJOINTS, CONTROL_DIM> dtau_du =
+            RBDSystem_->dynamics().S().transpose().template bottomRows<NJOINTS>();
+
+        derivatives_->forwardDynamicsDerivatives(x.template head<NJOINTS>(), x.template tail<NJOINTS>(),
+            dtau_du * u, fext, qdd, dqdd_dq, dqdd_dqd, dqdd_dtau);
+
+        dVdx_ << dqdd_dq, dqdd_dqd;
+        dVdu_ = dqdd_dtau * dtau_du;
+    }
+
+    //! never called, the derivatives of other fixed base systems are computed numerically
+    template <bool FB = FLOATING_BASE>
+    typename std::enable_if<!FB && !JOINT_TORQUE_CONTROLLED, void>::type computeAnalyticalDynamicsDerivativesImpl(
+        const state_vector_t& x,
+        const control_vector_t& u)
+    {
+        throw std::runtime_error("RbdLinearizer: analytical derivatives require a joint torque controlled system.");
+    }
+
     // auto generated code
     Eigen::Matrix<SCALAR, 3, 3> JacobianOfRotationMultiplyVector(const Eigen::Matrix<SCALAR, 3, 1>& theta,
         const Eigen::Matrix<SCALAR, 3, 1>& vector)
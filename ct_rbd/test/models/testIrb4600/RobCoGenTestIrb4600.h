@@ -33,6 +33,14 @@ Licensed under the BSD-2 license (see LICENSE file in main directory)
 #define CT_L4 fr_link5
 #define CT_L5 fr_link6
 
+// link names as in robcogen without frame prefix, required to access the link inertias by id
+#define CT_L0_NAME link1
+#define CT_L1_NAME link2
+#define CT_L2_NAME link3
+#define CT_L3_NAME link4
+#define CT_L4_NAME link5
+#define CT_L5_NAME link6
+
 // define single end effector (could also be multiple)
 #define CT_N_EE 1
 #define CT_EE0 fr_ee
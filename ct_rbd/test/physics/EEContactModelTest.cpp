@@ -43,6 +43,50 @@ TEST(EEContactModelTest, basicTest)
 }
 
 
+TEST(EEContactModelTest, terrainTest)
+{
+    typedef TestHyQ::Kinematics HyqKinematics;
+    typedef EEContactModel<HyqKinematics> ContactModel;
+    typedef typename ContactModel::EEForcesLinear EEForcesLinear;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> HeightGrid;
+
+    ContactModel flatGround(5000.0, 500.0, 100.0, -1.0, 0.0, ContactModel::SIGMOID);
+    ContactModel flatTerrain(flatGround);
+    ContactModel slopedTerrain(flatGround);
+
+    // a flat height map at zero height is equivalent to no terrain
+    flatTerrain.setTerrain(std::shared_ptr<TerrainHeightMap>(new TerrainHeightMap(HeightGrid::Zero(5, 5), -5, -5, 2.5)));
+
+    // a slope with gradient (0.5, 0) which covers the workspace of the robot
+    const double slope = 0.5;
+    HeightGrid heights(2, 2);
+    heights << -5.0 * slope, 5.0 * slope, -5.0 * slope, 5.0 * slope;
+    slopedTerrain.setTerrain(std::shared_ptr<TerrainHeightMap>(new TerrainHeightMap(heights, -5, -5, 10)));
+
+    const Eigen::Vector3d normal = Eigen::Vector3d(-slope, 0.0, 1.0).normalized();
+
+    RBDState<HyqKinematics::NJOINTS> state;
+    for (size_t n = 0; n < 20; n++)
+    {
+        state.setRandom();
+
+        EEForcesLinear forcesFlat = flatGround.computeContactForces(state);
+        EEForcesLinear forcesFlatTerrain = flatTerrain.computeContactForces(state);
+
+        for (size_t i = 0; i < forcesFlat.size(); i++)
+            ASSERT_TRUE(forcesFlat[i].isApprox(forcesFlatTerrain[i], 1e-12));
+
+        // without damping, the force of the sloped terrain acts along its normal
+        state.setZero();
+        state.basePose().position().toImplementation() = Eigen::Vector3d::Random();
+        slopedTerrain.d() = 0.0;
+        EEForcesLinear forcesSloped = slopedTerrain.computeContactForces(state);
+        for (size_t i = 0; i < forcesSloped.size(); i++)
+            ASSERT_LT((forcesSloped[i] - forcesSloped[i].dot(normal) * normal).norm(), 1e-9);
+    }
+}
+
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
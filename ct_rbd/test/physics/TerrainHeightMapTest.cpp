@@ -0,0 +1,213 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <ct/rbd/rbd.h>
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <ct/rbd/physics/TerrainHeightMap.h>
+
+using namespace ct::rbd;
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> HeightGrid;
+
+
+TEST(TerrainHeightMapTest, interpolationTest)
+{
+    const double resolution = 0.1;
+    const double originX = -1.0;
+    const double originY = -0.5;
+
+    // a plane is reproduced exactly by the bilinear interpolation
+    const double a = 0.3, b = -0.2, c = 0.1;
+    HeightGrid heights(11, 21);
+    for (int r = 0; r < heights.rows(); r++)
+        for (int col = 0; col < heights.cols(); col++)
+            heights(r, col) = a * (originX + col * resolution) + b * (originY + r * resolution) + c;
+
+    TerrainHeightMap terrain(heights, originX, originY, resolution);
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        Eigen::Vector2d p = Eigen::Vector2d::Random();
+        p(0) = originX + 1.0 + p(0) * 0.99;
+        p(1) = originY + 0.5 + p(1) * 0.49;
+
+        double dhdx, dhdy;
+        double h = terrain.getHeight(p(0), p(1), dhdx, dhdy);
+
+        ASSERT_NEAR(h, a * p(0) + b * p(1) + c, 1e-12);
+        ASSERT_NEAR(dhdx, a, 1e-12);
+        ASSERT_NEAR(dhdy, b, 1e-12);
+
+        Eigen::Vector3d normal = terrain.getNormal(p(0), p(1));
+        ASSERT_NEAR(normal.norm(), 1.0, 1e-12);
+        ASSERT_NEAR(normal.dot(Eigen::Vector3d(1.0, 0.0, a)), 0.0, 1e-12);
+        ASSERT_NEAR(normal.dot(Eigen::Vector3d(0.0, 1.0, b)), 0.0, 1e-12);
+    }
+
+    // outside of the grid the border height is continued
+    double dhdx, dhdy;
+    ASSERT_NEAR(terrain.getHeight(-5.0, -5.0, dhdx, dhdy), heights(0, 0), 1e-12);
+    ASSERT_EQ(dhdx, 0.0);
+    ASSERT_EQ(dhdy, 0.0);
+    ASSERT_NEAR(terrain.getHeight(5.0, 5.0), heights(10, 20), 1e-12);
+}
+
+TEST(TerrainHeightMapTest, gradientTest)
+{
+    HeightGrid heights = HeightGrid::Random(20, 30);
+    TerrainHeightMap terrain(heights, 0.5, 1.0, 0.05);
+
+    const double eps = 1e-7;
+    for (size_t i = 0; i < 100; i++)
+    {
+        const double x = 0.5 + Eigen::internal::random<double>(0.0, 29 * 0.05);
+        const double y = 1.0 + Eigen::internal::random<double>(0.0, 19 * 0.05);
+
+        double dhdx, dhdy;
+        terrain.getHeight(x, y, dhdx, dhdy);
+
+        // skip points too close to the cell borders, where the gradient is discontinuous
+        const double sx = (x - 0.5) / 0.05, sy = (y - 1.0) / 0.05;
+        if (std::abs(sx - std::round(sx)) < 1e-4 || std::abs(sy - std::round(sy)) < 1e-4)
+            continue;
+
+        ASSERT_NEAR(dhdx, (terrain.getHeight(x + eps, y) - terrain.getHeight(x - eps, y)) / (2 * eps), 1e-5);
+        ASSERT_NEAR(dhdy, (terrain.getHeight(x, y + eps) - terrain.getHeight(x, y - eps)) / (2 * eps), 1e-5);
+    }
+}
+
+#ifdef CPPAD
+//! records the height and its gradient at a position
+void recordHeight(const TerrainHeightMap& terrain, CppAD::ADFun<double>& fun)
+{
+    typedef CppAD::AD<double> AD_Scalar;
+
+    std::vector<AD_Scalar> xy(2, AD_Scalar(0.0));
+    xy[0] = 0.13;
+    xy[1] = 0.27;
+    CppAD::Independent(xy);
+    std::vector<AD_Scalar> out(3);
+    out[0] = terrain.getHeight(xy[0], xy[1], out[1], out[2]);
+    fun.Dependent(xy, out);
+}
+
+TEST(TerrainHeightMapTest, autodiffTest)
+{
+    HeightGrid heights = HeightGrid::Random(6, 8);
+    TerrainHeightMap terrain(heights, -0.2, 0.1, 0.1);
+
+    // record the tape in one cell
+    CppAD::ADFun<double> fun;
+    recordHeight(terrain, fun);
+
+    // the tape is valid in all cells and outside of the grid
+    for (size_t i = 0; i < 100; i++)
+    {
+        std::vector<double> p(2);
+        p[0] = Eigen::internal::random<double>(-0.4, 0.7);
+        p[1] = Eigen::internal::random<double>(-0.1, 0.8);
+
+        double dhdx, dhdy;
+        const double h = terrain.getHeight(p[0], p[1], dhdx, dhdy);
+
+        std::vector<double> value = fun.Forward(0, p);
+        ASSERT_NEAR(value[0], h, 1e-12);
+        ASSERT_NEAR(value[1], dhdx, 1e-12);
+        ASSERT_NEAR(value[2], dhdy, 1e-12);
+
+        // the derivatives of the height recorded on the tape agree with the analytical gradient
+        std::vector<double> jac = fun.Jacobian(p);
+        ASSERT_NEAR(jac[0], dhdx, 1e-12);
+        ASSERT_NEAR(jac[1], dhdy, 1e-12);
+    }
+
+    // the cell is looked up by the atomic function, the size of the tape does not depend on the size of the grid
+    TerrainHeightMap largeTerrain(HeightGrid::Random(600, 800), -0.2, 0.1, 0.001);
+    CppAD::ADFun<double> largeFun;
+    recordHeight(largeTerrain, largeFun);
+    ASSERT_EQ(largeFun.size_var(), fun.size_var());
+    ASSERT_EQ(largeFun.size_op(), fun.size_op());
+}
+#endif
+
+#ifdef CPPADCG
+//! generates the code of the height and its gradient
+std::string generateHeightCode(const TerrainHeightMap& terrain)
+{
+    typedef ct::core::ADCGScalar ADCGScalar;
+    typedef ct::core::ADCGValueType CGScalar;
+
+    // no numerical values are available while generating code
+    std::vector<ADCGScalar> xy(2);
+    CppAD::Independent(xy);
+    std::vector<ADCGScalar> out(3);
+    out[0] = terrain.getHeight(xy[0], xy[1], out[1], out[2]);
+    CppAD::ADFun<CGScalar> fun(xy, out);
+
+    CppAD::cg::CodeHandler<double> handler;
+    std::vector<CGScalar> indVars(2);
+    handler.makeVariables(indVars);
+    std::vector<CGScalar> dep = fun.Forward(0, indVars);
+
+    CppAD::cg::LanguageC<double> langC("double");
+    CppAD::cg::LangCDefaultVariableNameGenerator<double> nameGen;
+    std::ostringstream code;
+    handler.generateCode(code, langC, dep, nameGen);
+    return code.str();
+}
+
+TEST(TerrainHeightMapTest, codegenTest)
+{
+    TerrainHeightMap terrain(HeightGrid::Random(4, 5), 0.0, 0.0, 0.2);
+    std::string code;
+    ASSERT_NO_THROW(code = generateHeightCode(terrain));
+    ASSERT_FALSE(code.empty());
+
+    // the grid heights are read by the atomic function at runtime, the code does not depend on the grid
+    TerrainHeightMap largeTerrain(HeightGrid::Random(400, 500), 0.0, 0.0, 0.2);
+    ASSERT_EQ(generateHeightCode(largeTerrain), code);
+}
+#endif
+
+TEST(TerrainHeightMapTest, fileTest)
+{
+    HeightGrid heights = HeightGrid::Random(15, 12);
+    const std::string filename = "terrainHeightMapTest.bin";
+
+    TerrainHeightMap::writeToFile(filename, heights, -0.3, 0.2, 0.02);
+    std::shared_ptr<TerrainHeightMap> terrain = TerrainHeightMap::loadFromFile(filename);
+
+    ASSERT_EQ(terrain->rows(), 15u);
+    ASSERT_EQ(terrain->cols(), 12u);
+    ASSERT_EQ(terrain->originX(), -0.3);
+    ASSERT_EQ(terrain->originY(), 0.2);
+    ASSERT_EQ(terrain->resolution(), 0.02);
+
+    for (int r = 0; r < heights.rows(); r++)
+        for (int c = 0; c < heights.cols(); c++)
+            ASSERT_EQ(terrain->height(r, c), heights(r, c));
+
+    // the mapping is kept alive by copies
+    TerrainHeightMap copy(*terrain);
+    terrain.reset();
+    ASSERT_EQ(copy.height(3, 4), heights(3, 4));
+
+    std::remove(filename.c_str());
+
+    ASSERT_ANY_THROW(TerrainHeightMap::loadFromFile(filename));
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
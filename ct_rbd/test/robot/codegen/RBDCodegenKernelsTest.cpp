@@ -0,0 +1,149 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <ct/rbd/rbd.h>
+
+#include "../../models/testIrb4600/RobCoGenTestIrb4600.h"
+#include "../../models/testhyq/RobCoGenTestHyQ.h"
+
+using namespace ct::rbd;
+
+typedef RBDCodegenKernels<TestHyQ::tpl::Dynamics> HyQKernels;
+typedef RBDCodegenKernels<TestIrb4600::tpl::Dynamics> Irb4600Kernels;
+
+
+TEST(RBDCodegenKernelsTest, floatingBaseTest)
+{
+    static_assert(HyQKernels::STATE_DIM == 36, "wrong dimension");
+    static_assert(HyQKernels::CONTROL_DIM == 12, "wrong dimension");
+    static_assert(HyQKernels::ID_OUT_DIM == 18, "wrong dimension");
+    static_assert(HyQKernels::FK_OUT_DIM == 24, "wrong dimension");
+
+    HyQKernels kernels;
+    TestHyQ::Dynamics dynamics;
+    TestHyQ::Kinematics& kinematics = dynamics.kinematics();
+
+    // the system used as reference
+    std::shared_ptr<HyQKernels::ContactModel<double>> contactModel(new HyQKernels::ContactModel<double>(
+        5000.0, 1000.0, 100.0, 100.0, -0.02, HyQKernels::ContactModel<double>::SIGMOID));
+    FloatingBaseFDSystem<TestHyQ::Dynamics, false> system;
+    system.setContactModel(contactModel);
+
+    for (size_t n = 0; n < 10; n++)
+    {
+        RBDState<12> state;
+        state.setRandom();
+        const ct::core::StateVector<36> x = state.toStateVectorEulerXyz();
+        // use the state parametrized with the Euler angles
+        state.fromStateVectorEulerXyz(x);
+
+        // inverse dynamics
+        Eigen::Matrix<double, 18, 1> qdd = Eigen::Matrix<double, 18, 1>::Random();
+        Eigen::Matrix<double, 54, 1> xId;
+        xId << x, qdd;
+
+        TestHyQ::Dynamics::ForceVector_t base_w;
+        TestHyQ::Dynamics::control_vector_t u;
+        TestHyQ::Dynamics::ExtLinkForces_t fext(Eigen::Matrix<double, 6, 1>::Zero());
+        dynamics.FloatingBaseFullyActuatedID(state, RigidBodyAcceleration(qdd.head<6>()),
+            JointAcceleration<12>(qdd.tail<12>()), fext, base_w, u);
+
+        Eigen::Matrix<double, 18, 1> tau = HyQKernels::inverseDynamics(xId);
+        ASSERT_TRUE(tau.head<6>().isApprox(base_w));
+        ASSERT_TRUE(tau.tail<12>().isApprox(u));
+
+        // forward kinematics
+        Eigen::Matrix<double, 24, 1> fk = HyQKernels::forwardKinematics(Eigen::Matrix<double, 36, 1>(x));
+        for (size_t i = 0; i < 4; i++)
+        {
+            ASSERT_TRUE(fk.segment<3>(6 * i).isApprox(
+                kinematics.getEEPositionInWorld(i, state.basePose(), state.jointPositions()).toImplementation()));
+            ASSERT_TRUE(
+                fk.segment<3>(6 * i + 3).isApprox(kinematics.getEEVelocityInWorld(i, state).toImplementation()));
+        }
+
+        // forward dynamics including the contact model
+        u.setRandom();
+        Eigen::Matrix<double, 49, 1> xFd;
+        xFd << x, u, 0.0;
+        ct::core::StateVector<36> xd;
+        system.computeControlledDynamics(x, 0.0, u, xd);
+        ASSERT_TRUE(kernels.forwardDynamics(xFd).isApprox(xd));
+    }
+
+    // without contact model
+    kernels.contactModelSettings().enabled = false;
+    FloatingBaseFDSystem<TestHyQ::Dynamics, false> bareSystem;
+    RBDState<12> state;
+    state.setRandom();
+    TestHyQ::Dynamics::control_vector_t u = TestHyQ::Dynamics::control_vector_t::Random();
+    Eigen::Matrix<double, 49, 1> xFd;
+    xFd << state.toStateVectorEulerXyz(), u, 0.0;
+    ct::core::StateVector<36> xd;
+    bareSystem.computeControlledDynamics(state.toStateVectorEulerXyz(), 0.0, u, xd);
+    ASSERT_TRUE(kernels.forwardDynamics(xFd).isApprox(xd));
+}
+
+TEST(RBDCodegenKernelsTest, fixedBaseTest)
+{
+    static_assert(Irb4600Kernels::STATE_DIM == 12, "wrong dimension");
+    static_assert(Irb4600Kernels::ID_IN_DIM == 18, "wrong dimension");
+    static_assert(Irb4600Kernels::ID_OUT_DIM == 6, "wrong dimension");
+
+    Irb4600Kernels kernels;
+    TestIrb4600::Dynamics dynamics;
+    FixBaseFDSystem<TestIrb4600::Dynamics> system;
+
+    for (size_t n = 0; n < 10; n++)
+    {
+        JointState<6> state;
+        state.setRandom();
+        JointAcceleration<6> qdd(Eigen::Matrix<double, 6, 1>::Random());
+
+        Eigen::Matrix<double, 18, 1> xId;
+        xId << state.toImplementation(), qdd.getAcceleration();
+        TestIrb4600::Dynamics::control_vector_t u;
+        dynamics.FixBaseID(state, qdd, u);
+        ASSERT_TRUE(Irb4600Kernels::inverseDynamics(xId).isApprox(u));
+
+        Eigen::Matrix<double, 19, 1> xFd;
+        xFd << state.toImplementation(), u, 0.0;
+        ct::core::StateVector<12> xd;
+        system.computeControlledDynamics(state.toImplementation(), 0.0, u, xd);
+        ASSERT_TRUE(kernels.forwardDynamics(xFd).isApprox(xd));
+
+        // the inverse dynamics torques reproduce the accelerations
+        ASSERT_TRUE(xd.tail<6>().isApprox(qdd.getAcceleration(), 1e-8));
+    }
+}
+
+TEST(RBDCodegenKernelsTest, fingerprintTest)
+{
+    HyQKernels kernels, otherKernels;
+    const uint64_t fingerprint = kernels.fingerprint();
+
+    // reproducible
+    ASSERT_EQ(fingerprint, otherKernels.fingerprint());
+    ASSERT_EQ(fingerprint, kernels.fingerprint());
+
+    // contact model parameters change the generated code
+    otherKernels.contactModelSettings().k = 4000.0;
+    ASSERT_NE(fingerprint, otherKernels.fingerprint());
+
+    // a different robot
+    Irb4600Kernels irb4600Kernels;
+    ASSERT_NE(fingerprint, irb4600Kernels.fingerprint());
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
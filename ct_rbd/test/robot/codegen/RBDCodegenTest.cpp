@@ -0,0 +1,86 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <ct/rbd/rbd.h>
+
+#include "../../models/testhyq/RobCoGenTestHyQ.h"
+
+// kernels generated by ct_rbd_add_codegen() at build time
+#include "TestHyQForwardZero.h"
+#include "TestHyQLinearizedForward.h"
+
+using namespace ct::rbd;
+
+typedef RBDCodegenKernels<TestHyQ::tpl::Dynamics> HyQKernels;
+typedef HyQKernels::System<double> HyQSystem;
+
+
+//! a random state, parametrized with Euler angles
+ct::core::StateVector<36> randomState()
+{
+    RBDState<12> state;
+    state.setRandom();
+    return state.toStateVectorEulerXyz();
+}
+
+
+TEST(RBDCodegenTest, forwardZeroTest)
+{
+    ct::models::TestHyQ::TestHyQForwardZero forwardZero;
+    HyQKernels kernels;
+
+    // the templated system the kernels were generated from
+    std::shared_ptr<HyQSystem> system = kernels.createSystem<double>();
+
+    for (size_t n = 0; n < 100; n++)
+    {
+        const ct::core::StateVector<36> x = randomState();
+        const ct::core::ControlVector<12> u = ct::core::ControlVector<12>::Random();
+
+        Eigen::VectorXd xFd(HyQKernels::FD_IN_DIM);
+        xFd << x, u, 0.0;
+
+        ct::core::StateVector<36> xd;
+        system->computeControlledDynamics(x, 0.0, u, xd);
+
+        const Eigen::VectorXd xdGenerated = forwardZero.forwardZero(xFd);
+        ASSERT_TRUE(xdGenerated.isApprox(xd, 1e-10));
+        ASSERT_TRUE(xdGenerated.isApprox(kernels.forwardDynamics<double>(xFd), 1e-10));
+    }
+}
+
+TEST(RBDCodegenTest, linearizedForwardTest)
+{
+    ct::models::TestHyQ::TestHyQLinearizedForward linearizedForward;
+    HyQKernels kernels;
+    ct::core::SystemLinearizer<36, 12> numDiffLinearizer(kernels.createSystem<double>(), true);
+
+    for (size_t n = 0; n < 100; n++)
+    {
+        const ct::core::StateVector<36> x = randomState();
+        const ct::core::ControlVector<12> u = ct::core::ControlVector<12>::Random();
+
+        const ct::core::StateMatrix<36> A = linearizedForward.getDerivativeState(x, u, 0.0);
+        const ct::core::StateControlMatrix<36, 12> B = linearizedForward.getDerivativeControl(x, u, 0.0);
+
+        const ct::core::StateMatrix<36> A_numDiff = numDiffLinearizer.getDerivativeState(x, u, 0.0);
+        const ct::core::StateControlMatrix<36, 12> B_numDiff = numDiffLinearizer.getDerivativeControl(x, u, 0.0);
+
+        // relative tolerance, as the contact forces grow exponentially with the penetration
+        ASSERT_LT((A - A_numDiff).array().abs().maxCoeff(), 1e-4 * (1.0 + A_numDiff.array().abs().maxCoeff()));
+        ASSERT_LT((B - B_numDiff).array().abs().maxCoeff(), 1e-4 * (1.0 + B_numDiff.array().abs().maxCoeff()));
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
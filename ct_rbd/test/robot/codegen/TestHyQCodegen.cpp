@@ -0,0 +1,15 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <ct/rbd/rbd.h>
+
+#include "../../models/testhyq/RobCoGenTestHyQ.h"
+
+// generates the kernels of the HyQ test model with the default contact model, see RBDCodegenTest
+int main(int argc, char* argv[])
+{
+    ct::rbd::RBDCodegen<ct::rbd::TestHyQ::tpl::Dynamics> codegen("TestHyQ");
+    return codegen.run(argc, argv);
+}
@@ -0,0 +1,226 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <memory>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include <ct/rbd/rbd.h>
+
+#include "../../models/testIrb4600/RobCoGenTestIrb4600.h"
+#include "../../models/testhyq/RobCoGenTestHyQ.h"
+
+using namespace ct::rbd;
+
+/*!
+ * Wraps the RobCoGen inverse and forward dynamics of fixed and floating base systems in generalized coordinates
+ */
+template <class RBD>
+struct RobCoGenDynamics
+{
+    typedef DynamicsDerivatives<RBD> Derivatives;
+    typedef typename Derivatives::joint_vector_t joint_vector_t;
+    typedef typename Derivatives::dof_vector_t dof_vector_t;
+    typedef typename Derivatives::Vector6_t Vector6_t;
+    typedef typename Derivatives::ExtLinkForces_t ExtLinkForces_t;
+
+    template <bool FB = RBD::TRAIT::floating_base>
+    typename std::enable_if<FB, dof_vector_t>::type id(const joint_vector_t& q,
+        const dof_vector_t& v,
+        const dof_vector_t& vd,
+        const ExtLinkForces_t& fext,
+        const Vector6_t& g)
+    {
+        dof_vector_t tau;
+        Vector6_t baseWrench;
+        joint_vector_t jForces;
+        rbd.inverseDynamics().id_fully_actuated(baseWrench, jForces, g, v.template head<6>(), vd.template head<6>(), q,
+            v.template tail<RBD::NJOINTS>(), vd.template tail<RBD::NJOINTS>(), fext);
+        tau << baseWrench, jForces;
+        return tau;
+    }
+
+    template <bool FB = RBD::TRAIT::floating_base>
+    typename std::enable_if<!FB, dof_vector_t>::type id(const joint_vector_t& q,
+        const dof_vector_t& v,
+        const dof_vector_t& vd,
+        const ExtLinkForces_t& fext,
+        const Vector6_t& g)
+    {
+        dof_vector_t tau;
+        rbd.inverseDynamics().id(tau, q, v, vd, fext);
+        return tau;
+    }
+
+    template <bool FB = RBD::TRAIT::floating_base>
+    typename std::enable_if<FB, dof_vector_t>::type fd(const joint_vector_t& q,
+        const dof_vector_t& v,
+        const joint_vector_t& jForces,
+        const ExtLinkForces_t& fext,
+        const Vector6_t& g)
+    {
+        Vector6_t baseAcc;
+        joint_vector_t qdd;
+        rbd.forwardDynamics().fd(qdd, baseAcc, v.template head<6>(), g, q, v.template tail<RBD::NJOINTS>(), jForces, fext);
+        dof_vector_t vd;
+        vd << baseAcc, qdd;
+        return vd;
+    }
+
+    template <bool FB = RBD::TRAIT::floating_base>
+    typename std::enable_if<!FB, dof_vector_t>::type fd(const joint_vector_t& q,
+        const dof_vector_t& v,
+        const joint_vector_t& jForces,
+        const ExtLinkForces_t& fext,
+        const Vector6_t& g)
+    {
+        dof_vector_t vd;
+        rbd.forwardDynamics().fd(vd, q, v, jForces, fext);
+        return vd;
+    }
+
+    RBD rbd;
+};
+
+template <class RBD>
+void testDerivatives(bool useExternalForces)
+{
+    typedef RobCoGenDynamics<RBD> Dynamics_t;
+    typedef typename Dynamics_t::Derivatives Derivatives_t;
+    const size_t NJOINTS = Derivatives_t::NJOINTS;
+    const size_t NLINKS = Derivatives_t::NLINKS;
+    const size_t NDOF = Derivatives_t::NDOF;
+    const bool FB = Derivatives_t::FB;
+
+    Dynamics_t robcogen;
+    Derivatives_t derivatives;
+
+    typename Derivatives_t::joint_vector_t q, tau;
+    typename Derivatives_t::dof_vector_t v, vd, vdAnalytical, genForces;
+    typename Derivatives_t::dof_joint_matrix_t dtau_dq, dvd_dq, dvd_dtau;
+    typename Derivatives_t::dof_matrix_t dtau_dv, dvd_dv;
+    typename Derivatives_t::dof_force_matrix_t dvd_df;
+    typename Derivatives_t::ExtLinkForces_t fext(Eigen::Matrix<double, 6, 1>::Zero());
+
+    const double h = 1e-6;
+    const double tol = 1e-5;
+
+    for (size_t n = 0; n < 20; n++)
+    {
+        q.setRandom();
+        v.setRandom();
+        vd.setRandom();
+        tau.setRandom();
+        typename Derivatives_t::Vector6_t g = Derivatives_t::defaultGravity();
+        if (FB)
+            g.template tail<3>() = 9.81 * Eigen::Vector3d::Random().normalized();
+
+        for (size_t l = 0; l < NLINKS; l++)
+            fext[static_cast<typename RBD::LinkIdentifiers>(l)] =
+                (useExternalForces && (FB || l > 0)) ? Eigen::Matrix<double, 6, 1>::Random().eval()
+                                                     : Eigen::Matrix<double, 6, 1>::Zero().eval();
+
+        // inverse dynamics
+        derivatives.inverseDynamicsDerivatives(q, v, vd, fext, genForces, dtau_dq, dtau_dv, g);
+        ASSERT_LT((genForces - robcogen.id(q, v, vd, fext, g)).array().abs().maxCoeff(), 1e-8);
+
+        for (size_t k = 0; k < NJOINTS; k++)
+        {
+            typename Derivatives_t::joint_vector_t qp = q, qm = q;
+            qp(k) += h;
+            qm(k) -= h;
+            typename Derivatives_t::dof_vector_t fdiff =
+                (robcogen.id(qp, v, vd, fext, g) - robcogen.id(qm, v, vd, fext, g)) / (2 * h);
+            ASSERT_LT((dtau_dq.col(k) - fdiff).array().abs().maxCoeff(), tol * (1.0 + fdiff.norm()));
+        }
+        for (size_t k = 0; k < NDOF; k++)
+        {
+            typename Derivatives_t::dof_vector_t vp = v, vm = v;
+            vp(k) += h;
+            vm(k) -= h;
+            typename Derivatives_t::dof_vector_t fdiff =
+                (robcogen.id(q, vp, vd, fext, g) - robcogen.id(q, vm, vd, fext, g)) / (2 * h);
+            ASSERT_LT((dtau_dv.col(k) - fdiff).array().abs().maxCoeff(), tol * (1.0 + fdiff.norm()));
+        }
+
+        // forward dynamics
+        derivatives.forwardDynamicsDerivatives(q, v, tau, fext, vdAnalytical, dvd_dq, dvd_dv, dvd_dtau, g);
+        ASSERT_LT((vdAnalytical - robcogen.fd(q, v, tau, fext, g)).array().abs().maxCoeff(), 1e-8);
+
+        for (size_t k = 0; k < NJOINTS; k++)
+        {
+            typename Derivatives_t::joint_vector_t qp = q, qm = q, taup = tau, taum = tau;
+            qp(k) += h;
+            qm(k) -= h;
+            typename Derivatives_t::dof_vector_t fdiff =
+                (robcogen.fd(qp, v, tau, fext, g) - robcogen.fd(qm, v, tau, fext, g)) / (2 * h);
+            ASSERT_LT((dvd_dq.col(k) - fdiff).array().abs().maxCoeff(), tol * (1.0 + fdiff.norm()));
+
+            taup(k) += h;
+            taum(k) -= h;
+            fdiff = (robcogen.fd(q, v, taup, fext, g) - robcogen.fd(q, v, taum, fext, g)) / (2 * h);
+            ASSERT_LT((dvd_dtau.col(k) - fdiff).array().abs().maxCoeff(), tol * (1.0 + fdiff.norm()));
+        }
+        for (size_t k = 0; k < NDOF; k++)
+        {
+            typename Derivatives_t::dof_vector_t vp = v, vm = v;
+            vp(k) += h;
+            vm(k) -= h;
+            typename Derivatives_t::dof_vector_t fdiff =
+                (robcogen.fd(q, vp, tau, fext, g) - robcogen.fd(q, vm, tau, fext, g)) / (2 * h);
+            ASSERT_LT((dvd_dv.col(k) - fdiff).array().abs().maxCoeff(), tol * (1.0 + fdiff.norm()));
+        }
+
+        // external forces on the last link
+        const auto lastLink = static_cast<typename RBD::LinkIdentifiers>(NLINKS - 1);
+        derivatives.externalForceDerivative(NLINKS - 1, dvd_df);
+        for (size_t k = 0; k < 6; k++)
+        {
+            typename Derivatives_t::ExtLinkForces_t fp = fext, fm = fext;
+            fp[lastLink](k) += h;
+            fm[lastLink](k) -= h;
+            typename Derivatives_t::dof_vector_t fdiff =
+                (robcogen.fd(q, v, tau, fp, g) - robcogen.fd(q, v, tau, fm, g)) / (2 * h);
+            ASSERT_LT((dvd_df.col(k) - fdiff).array().abs().maxCoeff(), tol * (1.0 + fdiff.norm()));
+        }
+    }
+}
+
+TEST(DynamicsDerivativesTest, TopologyTest)
+{
+    DynamicsDerivatives<TestHyQ::RobCoGenContainer> hyq;
+    for (size_t leg = 0; leg < 4; leg++)
+    {
+        ASSERT_EQ(hyq.getParentLink(3 * leg), 0);
+        ASSERT_EQ(hyq.getParentLink(3 * leg + 1), 3 * leg + 1);
+        ASSERT_EQ(hyq.getParentLink(3 * leg + 2), 3 * leg + 2);
+    }
+
+    DynamicsDerivatives<TestIrb4600::RobCoGenContainer> irb;
+    for (size_t j = 0; j < 6; j++)
+    {
+        ASSERT_EQ(irb.getParentLink(j), j);
+        ASSERT_TRUE(irb.isRevolute(j));
+    }
+}
+
+TEST(DynamicsDerivativesTest, FixedBaseTest)
+{
+    testDerivatives<TestIrb4600::RobCoGenContainer>(false);
+    testDerivatives<TestIrb4600::RobCoGenContainer>(true);
+}
+
+TEST(DynamicsDerivativesTest, FloatingBaseTest)
+{
+    testDerivatives<TestHyQ::RobCoGenContainer>(false);
+    testDerivatives<TestHyQ::RobCoGenContainer>(true);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
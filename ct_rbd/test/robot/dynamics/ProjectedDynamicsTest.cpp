@@ -0,0 +1,240 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <memory>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include <ct/rbd/rbd.h>
+
+#include "../../models/testhyq/RobCoGenTestHyQ.h"
+
+using namespace ct::rbd;
+
+typedef ProjectedDynamics<TestHyQ::RobCoGenContainer, 4> ProjectedDynamics_t;
+typedef tpl::ConstraintJacobian<TestHyQ::Kinematics, 12, 12, double> ConstraintJacobian_t;
+
+const size_t NDOF = ProjectedDynamics_t::NDOF;
+
+/*!
+ * Reference implementation assembling the full KKT system and the SVD based null-space projector
+ */
+struct DenseProjectedDynamics
+{
+    DenseProjectedDynamics(const ProjectedDynamics_t::EE_in_contact_t& eeInContact)
+    {
+        for (size_t i = 0; i < 4; i++)
+        {
+            Jc.eeInContact_[i] = eeInContact[i];
+            if (eeInContact[i])
+            {
+                Jc.ee_indices_.push_back(i);
+                Jc.c_size_ += 3;
+            }
+        }
+    }
+
+    void update(const ProjectedDynamics_t::RBDState_t& x, const ProjectedDynamics_t::control_vector_t& u)
+    {
+        Eigen::Matrix<double, 6, 1> base_w, base_w_gravity;
+        Eigen::Matrix<double, 12, 1> jForces, jForces_gravity;
+        robcogen.inverseDynamics().C_terms_fully_actuated(
+            base_w, jForces, x.baseVelocities().getVector(), x.joints().getPositions(), x.joints().getVelocities());
+        robcogen.inverseDynamics().G_terms_fully_actuated(
+            base_w_gravity, jForces_gravity, x.basePose().computeGravityB6D(), x.joints().getPositions());
+
+        M = robcogen.jSim().update(x.joints().getPositions());
+        h << base_w + base_w_gravity, jForces + jForces_gravity;
+        f << Eigen::Matrix<double, 6, 1>::Zero(), u;
+
+        const size_t nc = Jc.ee_indices_.size();
+        Jc.updateState(x);
+        J.resize(3 * nc, NDOF);
+        dJdt.resize(3 * nc, NDOF);
+        cross.resize(3 * nc);
+        for (size_t i = 0; i < nc; i++)
+        {
+            const size_t ee = Jc.ee_indices_[i];
+            J.block<3, NDOF>(3 * i, 0) = Jc.J().block<3, NDOF>(3 * ee, 0);
+            dJdt.block<3, NDOF>(3 * i, 0) = Jc.dJdt().block<3, NDOF>(3 * ee, 0);
+            cross.segment<3>(3 * i) = x.baseLocalAngularVelocity().toImplementation().cross(
+                kinematics.getEEVelocityInBase(ee, x).toImplementation());
+        }
+    }
+
+    Eigen::VectorXd forwardDynamics(const ProjectedDynamics_t::RBDState_t& x)
+    {
+        const size_t nc = J.rows();
+        Eigen::MatrixXd MJTJ0 = Eigen::MatrixXd::Zero(NDOF + nc, NDOF + nc);
+        MJTJ0.topLeftCorner(NDOF, NDOF) = M;
+        MJTJ0.bottomLeftCorner(nc, NDOF) = -J;
+        MJTJ0.topRightCorner(NDOF, nc) = -J.transpose();
+
+        Eigen::VectorXd b(NDOF + nc);
+        b << f - h, dJdt * x.toCoordinateVelocity() + cross;
+        return MJTJ0.fullPivLu().solve(b);
+    }
+
+    Eigen::VectorXd inverseDynamics(const Eigen::Matrix<double, NDOF, 1>& qdd)
+    {
+        Eigen::Matrix<double, NDOF, NDOF> P = Eigen::Matrix<double, NDOF, NDOF>::Identity();
+        if (J.rows() > 0)
+            P -= J.completeOrthogonalDecomposition().pseudoInverse() * J;
+
+        Eigen::Matrix<double, 12, NDOF> S;
+        S << Eigen::Matrix<double, 12, 6>::Zero(), Eigen::Matrix<double, 12, 12>::Identity();
+        Eigen::MatrixXd PSt = P * S.transpose();
+
+        Eigen::JacobiSVD<Eigen::MatrixXd> svd(PSt, Eigen::ComputeThinU | Eigen::ComputeThinV);
+        Eigen::VectorXd sing_values =
+            (svd.singularValues().array() > 1e-9).select(svd.singularValues().array().inverse(), 0);
+        Eigen::MatrixXd PStinv = svd.matrixV() * sing_values.asDiagonal() * svd.matrixU().transpose();
+
+        return PStinv * P * (M * qdd + h);
+    }
+
+    TestHyQ::Kinematics kinematics;
+    TestHyQ::RobCoGenContainer robcogen;
+    ConstraintJacobian_t Jc;
+
+    Eigen::Matrix<double, NDOF, NDOF> M;
+    Eigen::Matrix<double, NDOF, 1> h, f;
+    Eigen::MatrixXd J, dJdt;
+    Eigen::VectorXd cross;
+};
+
+TEST(ProjectedDynamicsTest, referenceTest)
+{
+    std::shared_ptr<TestHyQ::Kinematics> kinematics(new TestHyQ::Kinematics);
+    ProjectedDynamics_t projectedDynamics(kinematics);
+
+    ProjectedDynamics_t::RBDState_t state;
+    ProjectedDynamics_t::control_vector_t u, uId;
+    ProjectedDynamics_t::RBDAcceleration_t qdd;
+    ProjectedDynamics_t::EE_contact_forces_t lambda;
+    ProjectedDynamics_t::EE_in_contact_t eeInContact;
+
+    for (size_t n = 0; n < 10; n++)
+    {
+        state.setRandom();
+        u.setRandom();
+
+        // all contact configurations for the same state, which also exercises the projection cache
+        for (size_t config = 0; config < 16; config++)
+        {
+            size_t nc = 0;
+            for (size_t i = 0; i < 4; i++)
+            {
+                eeInContact[i] = (config >> i) & 1;
+                nc += eeInContact[i];
+            }
+            projectedDynamics.setContactConfiguration(eeInContact);
+
+            DenseProjectedDynamics reference(eeInContact);
+            reference.update(state, u);
+
+            // forward dynamics
+            Eigen::VectorXd qddlambdaRef = reference.forwardDynamics(state);
+            projectedDynamics.ProjectedForwardDynamics(state, u, qdd);
+            projectedDynamics.getContactForcesInBase(lambda);
+
+            ASSERT_TRUE(qdd.toCoordinateAcceleration().isApprox(qddlambdaRef.head<NDOF>(), 1e-8));
+            size_t row = NDOF;
+            for (size_t i = 0; i < 4; i++)
+            {
+                if (eeInContact[i])
+                {
+                    ASSERT_TRUE(lambda[i].isApprox(qddlambdaRef.segment<3>(row), 1e-8));
+                    row += 3;
+                }
+                else
+                {
+                    ASSERT_TRUE(lambda[i].isZero());
+                }
+            }
+
+            // inverse dynamics
+            // for an arbitrary acceleration, the torques are the least squares solution
+            Eigen::Matrix<double, NDOF, 1> qddRandom = Eigen::Matrix<double, NDOF, 1>::Random();
+            ProjectedDynamics_t::RBDAcceleration_t qddArbitrary;
+            qddArbitrary.base().fromVector6d(qddRandom.head<6>());
+            qddArbitrary.joints().setAcceleration(qddRandom.tail<12>());
+
+            for (size_t k = 0; k < 2; k++)
+            {
+                projectedDynamics.ProjectedInverseDynamics(state, qdd, uId);
+                ASSERT_TRUE(uId.isApprox(reference.inverseDynamics(qdd.toCoordinateAcceleration()), 1e-8));
+
+                // with at most one foot in contact, the torques are unique
+                if (nc <= 1)
+                {
+                    ASSERT_TRUE(uId.isApprox(u, 1e-8));
+                }
+
+                projectedDynamics.ProjectedInverseDynamics(state, qddArbitrary, uId);
+                ASSERT_TRUE(uId.isApprox(reference.inverseDynamics(qddRandom), 1e-8));
+            }
+        }
+    }
+}
+
+#ifdef CPPAD
+TEST(ProjectedDynamicsTest, autodiffScalarTest)
+{
+    // non-floating point scalars take the comparison-free path, which has to agree with the floating point path
+    typedef CppAD::AD<double> AD_Scalar;
+    typedef ProjectedDynamics<TestHyQ::tpl::RobCoGenContainer<AD_Scalar>, 4> ProjectedDynamicsAD_t;
+
+    std::shared_ptr<TestHyQ::Kinematics> kinematics(new TestHyQ::Kinematics);
+    std::shared_ptr<TestHyQ::tpl::Kinematics<AD_Scalar>> kinematicsAD(new TestHyQ::tpl::Kinematics<AD_Scalar>);
+    ProjectedDynamics_t projectedDynamics(kinematics);
+    ProjectedDynamicsAD_t projectedDynamicsAD(kinematicsAD);
+
+    ProjectedDynamics_t::RBDState_t state;
+    ProjectedDynamicsAD_t::RBDState_t stateAD;
+    ProjectedDynamics_t::control_vector_t u, uId;
+    ProjectedDynamicsAD_t::control_vector_t uIdAD;
+    ProjectedDynamics_t::RBDAcceleration_t qdd;
+    ProjectedDynamicsAD_t::RBDAcceleration_t qddAD;
+    ProjectedDynamics_t::EE_in_contact_t eeInContact;
+
+    for (size_t n = 0; n < 5; n++)
+    {
+        state.setRandom();
+        stateAD.fromStateVectorEulerXyz(state.toStateVectorEulerXyz().cast<AD_Scalar>());
+        u.setRandom();
+
+        for (size_t config = 0; config < 16; config++)
+        {
+            for (size_t i = 0; i < 4; i++)
+                eeInContact[i] = (config >> i) & 1;
+            projectedDynamics.setContactConfiguration(eeInContact);
+            projectedDynamicsAD.setContactConfiguration(eeInContact);
+
+            projectedDynamics.ProjectedForwardDynamics(state, u, qdd);
+            projectedDynamicsAD.ProjectedForwardDynamics(stateAD, u.cast<AD_Scalar>(), qddAD);
+
+            Eigen::Matrix<double, NDOF, 1> qddValue;
+            for (size_t i = 0; i < NDOF; i++)
+                qddValue(i) = CppAD::Value(qddAD.toCoordinateAcceleration()(i));
+            ASSERT_TRUE(qddValue.isApprox(qdd.toCoordinateAcceleration(), 1e-8));
+
+            // for two or more feet in contact, the base can rotate about the line through the feet and the torques are
+            // the minimum norm solution
+            projectedDynamics.ProjectedInverseDynamics(state, qdd, uId);
+            projectedDynamicsAD.ProjectedInverseDynamics(stateAD, qddAD, uIdAD);
+            for (size_t i = 0; i < uId.size(); i++)
+                ASSERT_NEAR(CppAD::Value(uIdAD(i)), uId(i), 1e-6);
+        }
+    }
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,101 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <ct/rbd/rbd.h>
+
+#include <gtest/gtest.h>
+
+#include "../../models/testhyq/RobCoGenTestHyQ.h"
+
+using namespace ct;
+using namespace rbd;
+
+typedef BatchKinematics<TestHyQ::Kinematics> Batch;
+
+
+//! compares all entries of a batch against the single-configuration kinematics
+void checkBatch(const Batch::JointPositions& q, const Batch::Result& result, bool withJacobians)
+{
+    TestHyQ::Kinematics kinematics;
+    ASSERT_EQ(result.size(), static_cast<size_t>(q.cols()));
+
+    for (size_t k = 0; k < result.size(); k++)
+    {
+        JointState<TestHyQ::Kinematics::NJOINTS>::Position jointPosition = q.col(k);
+        for (size_t i = 0; i < TestHyQ::Kinematics::NUM_EE; i++)
+        {
+            ASSERT_TRUE(result.position(i, k).isApprox(
+                kinematics.getEEPositionInBase(i, jointPosition).toImplementation()));
+            ASSERT_TRUE(result.rotation(i, k).isApprox(kinematics.getEERotInBase(i, jointPosition)));
+            if (withJacobians)
+            {
+                ASSERT_TRUE(result.jacobian(i, k).isApprox(kinematics.getJacobianBaseEEbyId(i, jointPosition)));
+            }
+        }
+    }
+}
+
+TEST(BatchKinematicsTest, consistencyTest)
+{
+    Batch batch(TestHyQ::Kinematics(), 1);
+    Batch::JointPositions q = Batch::JointPositions::Random(TestHyQ::Kinematics::NJOINTS, 50);
+
+    Batch::Result result;
+    batch.compute(q, result);
+    checkBatch(q, result, true);
+
+    // poses only
+    batch.compute(q, result, false);
+    ASSERT_EQ(result.jacobians[0].cols(), 0);
+    checkBatch(q, result, false);
+}
+
+TEST(BatchKinematicsTest, layoutTest)
+{
+    Batch batch(TestHyQ::Kinematics(), 1);
+    Batch::JointPositions q = Batch::JointPositions::Random(TestHyQ::Kinematics::NJOINTS, 7);
+
+    Batch::Result result;
+    batch.compute(q, result);
+
+    // every component is contiguous over the configurations
+    for (size_t k = 0; k < 7; k++)
+    {
+        ASSERT_EQ(result.positions[1].data()[7 + k], result.position(1, k)(1));
+        ASSERT_EQ(result.rotations[2].data()[5 * 7 + k], result.rotation(2, k)(2, 1));
+        ASSERT_EQ(result.jacobians[3].data()[(6 * 4 + 3) * 7 + k], result.jacobian(3, k)(3, 4));
+    }
+}
+
+TEST(BatchKinematicsTest, multiThreadingTest)
+{
+    // small chunks to exercise the threading with an uneven split of the batch
+    Batch batch(TestHyQ::Kinematics(), 4, 10);
+    ASSERT_EQ(batch.nThreads(), 4u);
+
+    for (const size_t n : {0, 1, 9, 35, 101})
+    {
+        Batch::JointPositions q = Batch::JointPositions::Random(TestHyQ::Kinematics::NJOINTS, n);
+        Batch::Result result;
+        batch.compute(q, result);
+        checkBatch(q, result, true);
+    }
+
+    // the workers are reused for every batch
+    Batch::JointPositions q = Batch::JointPositions::Random(TestHyQ::Kinematics::NJOINTS, 35);
+    for (size_t i = 0; i < 100; i++)
+    {
+        Batch::Result result;
+        batch.compute(q, result, i % 2 == 0);
+        checkBatch(q, result, i % 2 == 0);
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <ct/rbd/rbd.h>
+#include "../../models/testIrb4600/RobCoGenTestIrb4600.h"
+
+#include <gtest/gtest.h>
+
+using namespace ct::rbd;
+
+using Kinematics_t = TestIrb4600::tpl::Kinematics<double>;
+using IKSolver = DampedLeastSquaresInverseKinematics<Kinematics_t>;
+using JointPosition_t = IKSolver::JointPosition_t;
+
+
+//! random joint positions within the inner part of the joint range
+JointPosition_t randomJointPositions()
+{
+    JointPosition_t mid = 0.5 * (TestIrb4600::jointLowerLimit() + TestIrb4600::jointUpperLimit());
+    JointPosition_t range = TestIrb4600::jointUpperLimit() - TestIrb4600::jointLowerLimit();
+    return mid + 0.35 * range.cwiseProduct(JointPosition_t::Random());
+}
+
+TEST(DampedLeastSquaresIKTest, closeToTest)
+{
+    Kinematics_t kinematics;
+
+    InverseKinematicsSettings ikSettings;
+    ikSettings.validationTol_ = 1e-6;
+    IKSolver solver(TestIrb4600::jointLowerLimit(), TestIrb4600::jointUpperLimit(), 0, ikSettings);
+
+    for (size_t n = 0; n < 20; n++)
+    {
+        JointPosition_t q = randomJointPositions();
+        RigidBodyPose target = kinematics.getEEPoseInBase(0, q);
+
+        // start close to the known solution
+        JointPosition_t query = q + 0.2 * JointPosition_t::Random();
+        JointPosition_t solution;
+        ASSERT_TRUE(solver.computeInverseKinematicsCloseTo(solution, target, query));
+        ASSERT_TRUE(kinematics.getEEPoseInBase(0, solution).isNear(target, 1e-6));
+        ASSERT_GT(solver.getNumIterations(), 0u);
+        ASSERT_LT(solver.getNumIterations(), solver.getDampedLeastSquaresSettings().maxIterations);
+    }
+}
+
+TEST(DampedLeastSquaresIKTest, randomRestartTest)
+{
+    Kinematics_t kinematics;
+
+    InverseKinematicsSettings ikSettings;
+    ikSettings.validationTol_ = 1e-6;
+    ikSettings.maxNumTrials_ = 50;
+    ikSettings.randomizeInitialGuess_ = true;
+    IKSolver solver(TestIrb4600::jointLowerLimit(), TestIrb4600::jointUpperLimit(), 0, ikSettings);
+
+    for (size_t n = 0; n < 10; n++)
+    {
+        RigidBodyPose target = kinematics.getEEPoseInBase(0, randomJointPositions());
+
+        IKSolver::JointPositionsVector_t solutions;
+        ASSERT_TRUE(solver.computeInverseKinematics(solutions, target));
+        ASSERT_EQ(solutions.size(), 1u);
+        ASSERT_TRUE(kinematics.getEEPoseInBase(0, solutions[0]).isNear(target, 1e-6));
+
+        // the joint limits are respected
+        ASSERT_TRUE((solutions[0].array() >= TestIrb4600::jointLowerLimit().array()).all());
+        ASSERT_TRUE((solutions[0].array() <= TestIrb4600::jointUpperLimit().array()).all());
+    }
+}
+
+TEST(DampedLeastSquaresIKTest, unreachableTest)
+{
+    InverseKinematicsSettings ikSettings;
+    ikSettings.maxNumTrials_ = 3;
+    IKSolver solver(TestIrb4600::jointLowerLimit(), TestIrb4600::jointUpperLimit(), 0, ikSettings);
+
+    // far outside of the workspace
+    RigidBodyPose target;
+    target.setIdentity();
+    target.position()(0) = 100.0;
+
+    IKSolver::JointPositionsVector_t solutions;
+    ASSERT_FALSE(solver.computeInverseKinematics(solutions, target));
+    ASSERT_TRUE(solutions.empty());
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
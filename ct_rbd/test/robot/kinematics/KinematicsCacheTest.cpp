@@ -0,0 +1,217 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <ct/rbd/rbd.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../models/testIrb4600/RobCoGenTestIrb4600.h"
+#include "../../models/testhyq/RobCoGenTestHyQ.h"
+
+using namespace ct;
+using namespace rbd;
+
+
+TEST(KinematicsCacheTest, consistencyTest)
+{
+    TestHyQ::Kinematics kinematics;
+    TestHyQ::RobCoGenContainer robcogen;
+
+    RBDState<TestHyQ::Kinematics::NJOINTS> state;
+
+    for (size_t n = 0; n < 10; n++)
+    {
+        state.setRandom();
+
+        // query twice, the second time from the cache
+        for (size_t k = 0; k < 2; k++)
+        {
+            for (size_t i = 0; i < TestHyQ::Kinematics::NUM_EE; i++)
+            {
+                ASSERT_TRUE(kinematics.getJacobianBaseEEbyId(i, state).isApprox(
+                    robcogen.getJacobianBaseEEbyId(i, state.jointPositions())));
+                ASSERT_TRUE(kinematics.getEEPositionInBase(i, state.jointPositions())
+                                .toImplementation()
+                                .isApprox(robcogen.getEEPositionInBase(i, state.jointPositions()).toImplementation()));
+                ASSERT_TRUE(kinematics.getEERotInBase(i, state.jointPositions())
+                                .isApprox(robcogen.getEERotInBase(i, state.jointPositions())));
+
+                const size_t linkId = kinematics.getEndEffector(i).getLinkId();
+                ASSERT_TRUE(kinematics.getForceTransformLinkBaseById(linkId, state.jointPositions())
+                                .isApprox(robcogen.getForceTransformLinkBaseById(linkId, state.jointPositions())));
+                ASSERT_TRUE(kinematics.getHomogeneousTransformBaseLinkById(linkId, state.jointPositions())
+                                .isApprox(robcogen.getHomogeneousTransformBaseLinkById(linkId, state.jointPositions())));
+            }
+        }
+    }
+}
+
+TEST(KinematicsCacheTest, sharingTest)
+{
+    typedef TestHyQ::Kinematics::Cache_t Cache_t;
+    const size_t NUM_EE = TestHyQ::Kinematics::NUM_EE;
+
+    // instances share the default cache of the robot, use a fresh one to count the accesses of this test
+    std::shared_ptr<TestHyQ::Kinematics> kinematics(new TestHyQ::Kinematics);
+    TestHyQ::Kinematics otherKinematics;
+    ASSERT_EQ(kinematics->getKinematicsCache(), Cache_t::getDefault());
+    ASSERT_EQ(otherKinematics.getKinematicsCache(), Cache_t::getDefault());
+    kinematics->setKinematicsCache(std::shared_ptr<Cache_t>(new Cache_t));
+    otherKinematics.setKinematicsCache(kinematics->getKinematicsCache());
+
+    // a contact model using the same kinematics
+    EEContactModel<TestHyQ::Kinematics> contactModel(5000.0, 500.0, 100.0, -1.0, 0.0,
+        EEContactModel<TestHyQ::Kinematics>::SIGMOID, kinematics);
+
+    const std::shared_ptr<Cache_t>& cache = kinematics->getKinematicsCache();
+
+    RBDState<TestHyQ::Kinematics::NJOINTS> state;
+    state.setRandom();
+
+    // the contact model computes the positions and Jacobians of all end-effectors once
+    contactModel.computeContactForces(state);
+    ASSERT_EQ(cache->misses(), 2 * NUM_EE);
+
+    // another consumer of the same joint configuration only reads from the cache
+    const size_t epoch = cache->epoch();
+    for (size_t i = 0; i < NUM_EE; i++)
+    {
+        otherKinematics.getEEPositionInWorld(i, state.basePose(), state.jointPositions());
+        otherKinematics.getEEVelocityInWorld(i, state);
+    }
+    ASSERT_EQ(cache->misses(), 2 * NUM_EE);
+    ASSERT_EQ(cache->epoch(), epoch);
+
+    // a different joint configuration starts a new epoch, the base state does not matter
+    state.basePose().setRandom();
+    otherKinematics.getEEPositionInBase(0, state.jointPositions());
+    ASSERT_EQ(cache->epoch(), epoch);
+
+    state.jointPositions()(0) += 0.1;
+    otherKinematics.getEEPositionInBase(0, state.jointPositions());
+    ASSERT_EQ(cache->epoch(), epoch + 1);
+    ASSERT_EQ(cache->misses(), 2 * NUM_EE + 1);
+
+    // manual invalidation
+    cache->invalidate();
+    otherKinematics.getEEPositionInBase(0, state.jointPositions());
+    ASSERT_EQ(cache->misses(), 2 * NUM_EE + 2);
+
+    // copies share the cache
+    TestHyQ::Kinematics copy(*kinematics);
+    ASSERT_EQ(copy.getKinematicsCache(), cache);
+}
+
+TEST(KinematicsCacheTest, threadingTest)
+{
+    const size_t nThreads = 4;
+    std::shared_ptr<TestHyQ::Kinematics::Cache_t> cache(new TestHyQ::Kinematics::Cache_t);
+    std::atomic<size_t> failures(0);
+
+    // every thread evaluates its own configurations through a copy sharing the same cache
+    std::vector<std::thread> threads;
+    for (size_t n = 0; n < nThreads; n++)
+    {
+        threads.push_back(std::thread([&cache, &failures]() {
+            TestHyQ::Kinematics kinematics;
+            kinematics.setKinematicsCache(cache);
+            TestHyQ::Kinematics copy(kinematics);
+            TestHyQ::RobCoGenContainer robcogen;
+
+            RBDState<TestHyQ::Kinematics::NJOINTS> state;
+            for (size_t k = 0; k < 100; k++)
+            {
+                state.setRandom();
+                for (size_t i = 0; i < TestHyQ::Kinematics::NUM_EE; i++)
+                {
+                    const auto& jointPositions = state.jointPositions();
+                    if (!kinematics.getJacobianBaseEEbyId(i, jointPositions)
+                             .isApprox(robcogen.getJacobianBaseEEbyId(i, jointPositions)) ||
+                        !copy.getJacobianBaseEEbyId(i, jointPositions)
+                             .isApprox(robcogen.getJacobianBaseEEbyId(i, jointPositions)) ||
+                        !copy.getHomogeneousTransformBaseEEById(i, jointPositions)
+                             .isApprox(robcogen.getHomogeneousTransformBaseEEById(i, jointPositions)))
+                        failures++;
+                }
+            }
+        }));
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    ASSERT_EQ(failures.load(), 0u);
+
+    // per configuration and end-effector, the Jacobian is computed once and read once from the cache
+    const size_t nQueries = nThreads * 100 * TestHyQ::Kinematics::NUM_EE;
+    ASSERT_EQ(cache->misses(), 2 * nQueries);
+    ASSERT_EQ(cache->hits(), nQueries);
+}
+
+TEST(KinematicsCacheTest, nlocTest)
+{
+    using Kinematics_t = TestIrb4600::Kinematics;
+    using System_t = FixBaseFDSystem<TestIrb4600::Dynamics>;
+    const size_t STATE_DIM = System_t::STATE_DIM;
+    const size_t CONTROL_DIM = System_t::CONTROL_DIM;
+    using Term_t = TermTaskspaceGeometricJacobian<Kinematics_t, STATE_DIM, CONTROL_DIM>;
+
+    std::shared_ptr<core::ControlledSystem<STATE_DIM, CONTROL_DIM>> system(new System_t);
+    std::shared_ptr<core::SystemLinearizer<STATE_DIM, CONTROL_DIM>> linearizer(
+        new core::SystemLinearizer<STATE_DIM, CONTROL_DIM>(system));
+
+    // a task space cost, whose clones evaluate the kinematics in the NLOC worker threads
+    std::shared_ptr<Kinematics_t::Cache_t> cache(new Kinematics_t::Cache_t);
+    std::shared_ptr<Term_t> taskSpaceTerm(new Term_t(0, Eigen::Matrix3d::Identity(), 0.1 * Eigen::Matrix3d::Identity(),
+        core::StateVector<3>(1.0, 0.5, 1.0), Eigen::Quaterniond::Identity()));
+    taskSpaceTerm->setKinematicsCache(cache);
+
+    std::shared_ptr<optcon::CostFunctionAnalytical<STATE_DIM, CONTROL_DIM>> costFunction(
+        new optcon::CostFunctionAnalytical<STATE_DIM, CONTROL_DIM>());
+    costFunction->addIntermediateTerm(std::shared_ptr<optcon::TermQuadratic<STATE_DIM, CONTROL_DIM>>(
+        new optcon::TermQuadratic<STATE_DIM, CONTROL_DIM>(1e-3 * core::StateMatrix<STATE_DIM>::Identity(),
+            1e-4 * core::ControlMatrix<CONTROL_DIM>::Identity())));
+    costFunction->addIntermediateTerm(taskSpaceTerm);
+    costFunction->addFinalTerm(taskSpaceTerm);
+
+    const double tf = 0.5;
+    core::StateVector<STATE_DIM> x0 = core::StateVector<STATE_DIM>::Zero();
+    optcon::ContinuousOptConProblem<STATE_DIM, CONTROL_DIM> problem(tf, x0, system, costFunction, linearizer);
+
+    optcon::NLOptConSettings settings;
+    settings.nlocp_algorithm = optcon::NLOptConSettings::NLOCP_ALGORITHM::ILQR;
+    settings.lineSearchSettings.type = optcon::LineSearchSettings::TYPE::SIMPLE;
+    settings.dt = 0.05;
+    settings.nThreads = 4;
+    settings.printSummary = false;
+
+    typedef optcon::NLOptConSolver<STATE_DIM, CONTROL_DIM, STATE_DIM / 2, STATE_DIM / 2> Solver;
+    Solver solver(problem, settings);
+    const size_t K = settings.computeK(tf);
+    solver.setInitialGuess(Solver::Policy_t(core::StateVectorArray<STATE_DIM>(K + 1, x0),
+        core::ControlVectorArray<CONTROL_DIM>(K, core::ControlVector<CONTROL_DIM>::Zero()),
+        core::FeedbackArray<STATE_DIM, CONTROL_DIM>(K, core::FeedbackMatrix<STATE_DIM, CONTROL_DIM>::Zero()),
+        settings.dt));
+
+    solver.runIteration();
+    const double cost = solver.getCost();
+    solver.runIteration();
+    ASSERT_LT(solver.getCost(), cost);
+
+    // the cloned terms use the cache of the original: the derivatives reuse the kinematics of the cost evaluation
+    ASSERT_GT(cache->misses(), 0u);
+    ASSERT_GT(cache->hits(), cache->misses());
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,289 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <ct/rbd/rbd.h>
+#include "../../models/testIrb4600/RobCoGenTestIrb4600.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace ct::rbd;
+
+using Kinematics_t = TestIrb4600::tpl::Kinematics<double>;
+using ParallelIK = ParallelInverseKinematics<Kinematics_t>;
+using JointPosition_t = ParallelIK::JointPosition_t;
+using JointPositionsVector_t = ParallelIK::JointPositionsVector_t;
+using IKBase = ParallelIK::BASE;
+
+
+/*!
+ * \brief A local solver which converges to a fixed solution if the first joint of the seed is close enough to it
+ * and otherwise returns the seed
+ */
+class LocalSolverMock : public IKBase
+{
+public:
+    LocalSolverMock(const JointPosition_t& solution, std::atomic<size_t>& calls) : solution_(solution), calls_(calls)
+    {
+    }
+
+    bool computeInverseKinematics(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeBasePose,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        return false;
+    }
+
+    bool computeInverseKinematics(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const std::vector<size_t>& freeJoints) override
+    {
+        return false;
+    }
+
+    bool computeInverseKinematicsCloseTo(JointPosition_t& ikSolution,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const JointPosition_t& queryJointPositions,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        calls_++;
+        ikSolution = std::abs(queryJointPositions(0) - solution_(0)) < 0.5 ? solution_ : queryJointPositions;
+        return true;
+    }
+
+protected:
+    JointPosition_t solution_;
+    std::atomic<size_t>& calls_;
+};
+
+/*!
+ * \brief A local solver which returns its solution once all solvers are running and, if it is slow, only once it is
+ * cancelled, such that a solve is still running when the first solution is found
+ */
+class CancellableSolverMock : public LocalSolverMock
+{
+public:
+    CancellableSolverMock(const JointPosition_t& solution,
+        std::atomic<size_t>& calls,
+        std::atomic<size_t>& running,
+        size_t nSolvers,
+        bool slow)
+        : LocalSolverMock(solution, calls), running_(running), nSolvers_(nSolvers), slow_(slow), timedOut(false)
+    {
+    }
+
+    bool computeInverseKinematicsCloseTo(JointPosition_t& ikSolution,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const JointPosition_t& queryJointPositions,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        calls_++;
+        running_++;
+        if (!waitFor([&]() { return running_ == nSolvers_; }) || (slow_ && !waitFor([&]() { return cancelled(); })))
+            timedOut = true;
+
+        ikSolution = solution_;
+        return true;
+    }
+
+private:
+    //! waits until the condition holds, false after a timeout
+    static bool waitFor(const std::function<bool()>& condition)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10))
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    std::atomic<size_t>& running_;
+    size_t nSolvers_;
+    bool slow_;
+
+public:
+    bool timedOut;
+};
+
+//! returns fixed solutions, e.g. IKFast branches
+class SeedSolverMock : public IKBase
+{
+public:
+    SeedSolverMock(const JointPositionsVector_t& branches) : branches_(branches) {}
+    bool computeInverseKinematics(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeBasePose,
+        const std::vector<size_t>& freeJoints = std::vector<size_t>()) override
+    {
+        ikSolutions = branches_;
+        return true;
+    }
+
+    bool computeInverseKinematics(JointPositionsVector_t& ikSolutions,
+        const RigidBodyPoseTpl& eeWorldPose,
+        const RigidBodyPoseTpl& baseWorldPose,
+        const std::vector<size_t>& freeJoints) override
+    {
+        return computeInverseKinematics(ikSolutions, eeWorldPose, freeJoints);
+    }
+
+private:
+    JointPositionsVector_t branches_;
+};
+
+class ParallelInverseKinematicsTest : public ::testing::Test
+{
+protected:
+    ParallelInverseKinematicsTest() : calls(0)
+    {
+        solution << 0.5, 0.3, -0.4, 1.0, 0.5, -1.0;
+        targetPose = kinematics.getEEPoseInBase(0, solution);
+
+        farSeed << -2.5, 0.0, 0.0, 0.0, 0.0, 0.0;
+        nearSeed = farSeed;
+        nearSeed(0) = solution(0) + 0.2;
+
+        settings.randomizeInitialGuess_ = false;
+    }
+
+    std::vector<std::shared_ptr<IKBase>> createSolvers(size_t n, const JointPosition_t& localSolution)
+    {
+        std::vector<std::shared_ptr<IKBase>> solvers;
+        for (size_t i = 0; i < n; i++)
+            solvers.push_back(std::shared_ptr<IKBase>(new LocalSolverMock(localSolution, calls)));
+        return solvers;
+    }
+
+    Kinematics_t kinematics;
+    JointPosition_t solution;
+    JointPosition_t farSeed;
+    JointPosition_t nearSeed;
+    RigidBodyPose targetPose;
+    InverseKinematicsSettings settings;
+    std::atomic<size_t> calls;
+};
+
+
+TEST_F(ParallelInverseKinematicsTest, earlyTerminationTest)
+{
+    ParallelIK ik(createSolvers(1, solution), TestIrb4600::jointLowerLimit(), TestIrb4600::jointUpperLimit(), 0,
+        settings);
+    ik.setSeeds({farSeed, farSeed, nearSeed, nearSeed, farSeed});
+
+    JointPositionsVector_t solutions;
+    ASSERT_TRUE(ik.computeInverseKinematics(solutions, targetPose));
+    ASSERT_EQ(solutions.size(), 1u);
+    ASSERT_TRUE(solutions[0].isApprox(solution));
+
+    // the remaining seeds are not started after the first valid solution
+    ASSERT_EQ(ik.getNumSolves(), 3u);
+    ASSERT_EQ(calls, 3u);
+
+    // the query is the first seed
+    JointPosition_t closeSolution;
+    ASSERT_TRUE(ik.computeInverseKinematicsCloseTo(closeSolution, targetPose, nearSeed));
+    ASSERT_TRUE(closeSolution.isApprox(solution));
+    ASSERT_EQ(ik.getNumSolves(), 1u);
+}
+
+TEST_F(ParallelInverseKinematicsTest, jointLimitTest)
+{
+    // the same pose, but the first joint violates its limits
+    JointPosition_t outsideLimits = solution;
+    outsideLimits(0) += 2 * M_PI;
+    ASSERT_TRUE(kinematics.getEEPoseInBase(0, outsideLimits).isNear(targetPose, 1e-6));
+
+    ParallelIK ik(createSolvers(2, outsideLimits), TestIrb4600::jointLowerLimit(), TestIrb4600::jointUpperLimit(),
+        0, settings);
+    ik.setSeeds({farSeed, outsideLimits, farSeed});
+
+    JointPositionsVector_t solutions;
+    ASSERT_FALSE(ik.computeInverseKinematics(solutions, targetPose));
+    ASSERT_TRUE(solutions.empty());
+    ASSERT_EQ(ik.getNumSolves(), 3u);
+}
+
+TEST_F(ParallelInverseKinematicsTest, randomSeedsTest)
+{
+    settings.randomizeInitialGuess_ = true;
+    settings.maxNumTrials_ = 500;
+
+    ParallelIK ik(createSolvers(4, solution), TestIrb4600::jointLowerLimit(), TestIrb4600::jointUpperLimit(), 0,
+        settings);
+
+    for (size_t i = 0; i < 10; i++)
+    {
+        // solves running in parallel may find the solution as well
+        JointPositionsVector_t solutions;
+        ASSERT_TRUE(ik.computeInverseKinematics(solutions, targetPose));
+        ASSERT_GE(solutions.size(), 1u);
+        for (const JointPosition_t& ikSolution : solutions)
+            ASSERT_TRUE(ikSolution.isApprox(solution));
+        ASSERT_LT(ik.getNumSolves(), settings.maxNumTrials_);
+    }
+}
+
+TEST_F(ParallelInverseKinematicsTest, seedSolverTest)
+{
+    ParallelIK ik(createSolvers(1, solution), TestIrb4600::jointLowerLimit(), TestIrb4600::jointUpperLimit(), 0,
+        settings);
+    ik.setSeedSolver(std::shared_ptr<IKBase>(new SeedSolverMock({farSeed, nearSeed})));
+
+    // the query is tried first, then the branches of the seed solver are refined
+    JointPosition_t ikSolution;
+    ASSERT_TRUE(ik.computeInverseKinematicsCloseTo(ikSolution, targetPose, farSeed));
+    ASSERT_TRUE(ikSolution.isApprox(solution));
+    ASSERT_EQ(ik.getNumSolves(), 3u);
+}
+
+TEST_F(ParallelInverseKinematicsTest, cancelTest)
+{
+    // the same pose, with the last joint turned by a full revolution
+    JointPosition_t otherSolution = solution;
+    otherSolution(5) += 2 * M_PI;
+
+    std::atomic<size_t> running(0);
+    std::shared_ptr<CancellableSolverMock> fastSolver(new CancellableSolverMock(solution, calls, running, 2, false));
+    std::shared_ptr<CancellableSolverMock> slowSolver(
+        new CancellableSolverMock(otherSolution, calls, running, 2, true));
+
+    ParallelIK ik({fastSolver, slowSolver}, TestIrb4600::jointLowerLimit(), TestIrb4600::jointUpperLimit(), 0,
+        settings);
+    ik.setSeeds({farSeed});
+
+    for (const JointPosition_t& query : {otherSolution, solution})
+    {
+        running = 0;
+
+        // the slow solve is cancelled once the fast one found its solution, both are valid
+        JointPosition_t ikSolution;
+        ASSERT_TRUE(ik.computeInverseKinematicsCloseTo(ikSolution, targetPose, query));
+        ASSERT_FALSE(fastSolver->timedOut);
+        ASSERT_FALSE(slowSolver->timedOut);
+        ASSERT_EQ(ik.getNumSolves(), 2u);
+
+        // the solution closest to the query is returned
+        ASSERT_TRUE(ikSolution.isApprox(query));
+    }
+
+    // the cancel flag is removed after the solve
+    ASSERT_FALSE(slowSolver->cancelled());
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -52,6 +52,38 @@ TEST(FloatingBaseFDSystemTest, forward_dynamics_test)
     ASSERT_TRUE(finalQuat.isApprox(finalEuler, 1e-6));
 }
 
+TEST(FloatingBaseFDSystemTest, dynamics_derivatives_test)
+{
+    typedef FloatingBaseFDSystem<TestHyQ::Dynamics, false, true> HyQSystem;
+
+    const size_t STATE_DIM = HyQSystem::STATE_DIM;
+    const size_t CONTROL_DIM = HyQSystem::CONTROL_DIM;
+
+    std::shared_ptr<HyQSystem> hyqSystem(new HyQSystem);
+    std::shared_ptr<HyQSystem> hyqSystem2(new HyQSystem);
+    core::SystemLinearizer<STATE_DIM, CONTROL_DIM> systemLinearizer(hyqSystem2, true);
+
+    Eigen::Matrix<double, STATE_DIM / 2, STATE_DIM> dVdx;
+    Eigen::Matrix<double, STATE_DIM / 2, CONTROL_DIM> dVdu;
+
+    core::StateVector<STATE_DIM> x;
+    core::ControlVector<CONTROL_DIM> u;
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        x.setRandom();
+        u.setRandom();
+
+        hyqSystem->computeDynamicsDerivatives(x, u, dVdx, dVdu);
+
+        auto A = systemLinearizer.getDerivativeState(x, u, 0.0);
+        auto B = systemLinearizer.getDerivativeControl(x, u, 0.0);
+
+        ASSERT_LT((dVdx - A.bottomRows(STATE_DIM / 2)).array().abs().maxCoeff(), 1e-5);
+        ASSERT_LT((dVdu - B.bottomRows(STATE_DIM / 2)).array().abs().maxCoeff(), 1e-5);
+    }
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
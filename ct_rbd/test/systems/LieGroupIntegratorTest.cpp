@@ -0,0 +1,340 @@
+/**********************************************************************************************************************
+This file is part of the Control Toolbox (https://github.com/ethz-adrl/control-toolbox), copyright by ETH Zurich.
+Licensed under the BSD-2 license (see LICENSE file in main directory)
+**********************************************************************************************************************/
+
+#include <ct/rbd/rbd.h>
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "../models/testhyq/RobCoGenTestHyQ.h"
+
+using namespace ct;
+using namespace ct::rbd;
+
+const size_t NJOINTS = TestHyQ::Dynamics::NJOINTS;
+typedef FloatingBaseFDSystem<TestHyQ::Dynamics, true> SystemQuat;
+typedef FloatingBaseFDSystem<TestHyQ::Dynamics, false> SystemEuler;
+typedef LieGroupIntegrator<NJOINTS, true> IntegratorQuat;
+typedef LieGroupIntegrator<NJOINTS, false> IntegratorEuler;
+
+
+//! distance between two states, the base orientations are compared as rotation matrices
+double distance(const RBDState<NJOINTS>& a, const RBDState<NJOINTS>& b)
+{
+    const double rotation = (a.basePose().getRotationMatrix().toImplementation() -
+                                b.basePose().getRotationMatrix().toImplementation())
+                                .norm();
+    return rotation + (a.toStateVectorEulerXyz() - b.toStateVectorEulerXyz()).tail(2 * NJOINTS + 9).norm();
+}
+
+RBDState<NJOINTS> fromQuaternion(const core::StateVector<SystemQuat::STATE_DIM>& x)
+{
+    RBDState<NJOINTS> state(RigidBodyPose::QUAT);
+    state.fromStateVectorQuaternion(x);
+    return state;
+}
+
+//! integrates with the vector space RK4 integrator and a very small step as reference
+RBDState<NJOINTS> reference(const RBDState<NJOINTS>& initial, double duration)
+{
+    std::shared_ptr<SystemQuat> system(new SystemQuat);
+    core::Integrator<SystemQuat::STATE_DIM> integrator(system, core::RK4);
+
+    core::StateVector<SystemQuat::STATE_DIM> x = initial.toStateVectorQuaternion();
+    const size_t steps = 1000;
+    integrator.integrate_n_steps(x, 0.0, steps, duration / steps);
+    return fromQuaternion(x);
+}
+
+RBDState<NJOINTS> integrateLie(const RBDState<NJOINTS>& initial, double duration, size_t steps,
+    LieGroupIntegrationType type)
+{
+    std::shared_ptr<SystemQuat> system(new SystemQuat);
+    IntegratorQuat integrator(system, type);
+
+    core::StateVector<SystemQuat::STATE_DIM> x = initial.toStateVectorQuaternion();
+    integrator.integrate_n_steps(x, 0.0, steps, duration / steps);
+    return fromQuaternion(x);
+}
+
+
+TEST(LieGroupIntegratorTest, exponentialMapTest)
+{
+    // a pure rotation about the z-axis followed by a screw motion
+    IntegratorQuat::Configuration g;
+    g.R.setIdentity();
+    g.p.setZero();
+    g.joints.setZero();
+
+    IntegratorQuat::Velocity xi = IntegratorQuat::Velocity::Zero();
+    xi(2) = M_PI / 2;
+    xi(3) = 1.0;
+    xi(6) = 0.3;
+
+    IntegratorQuat::Configuration result = IntegratorQuat::exp(g, xi);
+    ASSERT_TRUE(result.R.isApprox(Eigen::Matrix3d(Eigen::AngleAxisd(M_PI / 2, Eigen::Vector3d::UnitZ()))));
+    ASSERT_TRUE(result.p.isApprox(Eigen::Vector3d(2.0 / M_PI, 2.0 / M_PI, 0.0)));
+    ASSERT_DOUBLE_EQ(result.joints(0), 0.3);
+
+    // the exponential map of a twist is the flow of a constant twist, hence half steps compose exactly
+    xi = IntegratorQuat::Velocity::Random();
+    IntegratorQuat::Configuration half = IntegratorQuat::exp(IntegratorQuat::exp(g, 0.5 * xi), 0.5 * xi);
+    result = IntegratorQuat::exp(g, xi);
+    ASSERT_TRUE(half.R.isApprox(result.R, 1e-12));
+    ASSERT_TRUE(half.p.isApprox(result.p, 1e-12));
+
+    // small angle expansion
+    xi = 1e-8 * IntegratorQuat::Velocity::Random();
+    result = IntegratorQuat::exp(g, xi);
+    ASSERT_NEAR((result.R.transpose() * result.R - Eigen::Matrix3d::Identity()).norm(), 0.0, 1e-14);
+}
+
+#ifdef CPPAD
+TEST(LieGroupIntegratorTest, autodiffExponentialMapTest)
+{
+    typedef CppAD::AD<double> AD_Scalar;
+    typedef LieGroupStepper<NJOINTS, true, AD_Scalar> StepperAD;
+    typedef LieGroupStepper<NJOINTS, true> Stepper;
+    const size_t NV = Stepper::NV;
+
+    // record the base pose of the exponential map at a large angle
+    std::vector<AD_Scalar> xiAd(NV, AD_Scalar(0.5));
+    CppAD::Independent(xiAd);
+
+    StepperAD::Configuration gAd;
+    gAd.R.setIdentity();
+    gAd.p.setZero();
+    gAd.joints.setZero();
+    const StepperAD::Configuration resultAd = StepperAD::exp(gAd, Eigen::Map<StepperAD::Velocity>(xiAd.data()));
+
+    std::vector<AD_Scalar> poseAd(12);
+    Eigen::Map<Eigen::Matrix<AD_Scalar, 3, 3>>(poseAd.data()) = resultAd.R;
+    Eigen::Map<Eigen::Matrix<AD_Scalar, 3, 1>>(poseAd.data() + 9) = resultAd.p;
+    CppAD::ADFun<double> fun(xiAd, poseAd);
+
+    Stepper::Configuration g;
+    g.R.setIdentity();
+    g.p.setZero();
+    g.joints.setZero();
+
+    // the tape switches to the Taylor expansions for small angles, including zero
+    for (double scale : {1.0, 1e-2, 1e-4, 1e-9, 0.0})
+    {
+        const Stepper::Velocity xi = scale * Stepper::Velocity::Random();
+        std::vector<double> xiVector(xi.data(), xi.data() + NV);
+
+        const Stepper::Configuration result = Stepper::exp(g, xi);
+        const std::vector<double> pose = fun.Forward(0, xiVector);
+        ASSERT_TRUE(Eigen::Map<const Eigen::Matrix3d>(pose.data()).isApprox(result.R, 1e-12));
+        ASSERT_NEAR((Eigen::Map<const Eigen::Vector3d>(pose.data() + 9) - result.p).norm(), 0.0, 1e-12);
+
+        // the derivatives are finite and agree with central differences
+        const std::vector<double> jacobian = fun.Jacobian(xiVector);
+        const double eps = 1e-6;
+        for (size_t i = 0; i < 6; i++)
+        {
+            const Stepper::Configuration plus = Stepper::exp(g, xi + eps * Stepper::Velocity::Unit(i));
+            const Stepper::Configuration minus = Stepper::exp(g, xi - eps * Stepper::Velocity::Unit(i));
+            Eigen::Matrix<double, 12, 1> derivative;
+            derivative << Eigen::Map<const Eigen::Matrix<double, 9, 1>>((plus.R - minus.R).data()), plus.p - minus.p;
+            derivative /= 2.0 * eps;
+
+            for (size_t j = 0; j < 12; j++)
+            {
+                ASSERT_TRUE(std::isfinite(jacobian[j * NV + i]));
+                ASSERT_NEAR(jacobian[j * NV + i], derivative(j), 1e-8);
+            }
+        }
+    }
+}
+#endif
+
+TEST(LieGroupIntegratorTest, accuracyTest)
+{
+    RBDState<NJOINTS> initial(RigidBodyPose::QUAT);
+    initial.setRandom();
+
+    const double duration = 0.1;
+    RBDState<NJOINTS> ref = reference(initial, duration);
+
+    // fourth order convergence of RKMK4
+    const double errorRk1 = distance(integrateLie(initial, duration, 10, RKMK4), ref);
+    const double errorRk2 = distance(integrateLie(initial, duration, 20, RKMK4), ref);
+    std::cout << "RKMK4 errors: " << errorRk1 << ", " << errorRk2 << std::endl;
+    ASSERT_LT(errorRk2, 1e-5);
+    ASSERT_GT(errorRk1 / errorRk2, 10.0);
+
+    // first order convergence of the symplectic Lie-Euler scheme
+    const double errorEuler1 = distance(integrateLie(initial, duration, 100, LIE_EULER_SYM), ref);
+    const double errorEuler2 = distance(integrateLie(initial, duration, 200, LIE_EULER_SYM), ref);
+    std::cout << "Lie-Euler errors: " << errorEuler1 << ", " << errorEuler2 << std::endl;
+    ASSERT_GT(errorEuler1 / errorEuler2, 1.5);
+    ASSERT_LT(errorEuler1 / errorEuler2, 3.0);
+}
+
+TEST(LieGroupIntegratorTest, eulerSingularityTest)
+{
+    // pitch close to the singularity of the xyz Euler angles, spinning about the pitch axis
+    RBDState<NJOINTS> initial(RigidBodyPose::EULER);
+    initial.setZero();
+    initial.basePose().setFromEulerAnglesXyz(Eigen::Vector3d(0.2, M_PI / 2 - 1e-3, -0.3));
+    initial.base().velocities().getRotationalVelocity().toImplementation() << 0.5, 2.0, -1.0;
+
+    const double duration = 0.2;
+    RBDState<NJOINTS> ref = reference(initial, duration);
+
+    // the state is represented by Euler angles, but the step is taken on the manifold
+    std::shared_ptr<SystemEuler> system(new SystemEuler);
+    IntegratorEuler integrator(system, RKMK4);
+    core::StateVector<SystemEuler::STATE_DIM> x = initial.toStateVectorEulerXyz();
+
+    core::StateVectorArray<SystemEuler::STATE_DIM> stateTrajectory;
+    core::TimeArray timeTrajectory;
+    integrator.integrate_n_steps(x, 0.0, 20, duration / 20, stateTrajectory, timeTrajectory);
+    ASSERT_EQ(stateTrajectory.size(), 21u);
+    ASSERT_NEAR(timeTrajectory.back(), duration, 1e-12);
+
+    RBDState<NJOINTS> result(RigidBodyPose::EULER);
+    result.fromStateVectorEulerXyz(x);
+    ASSERT_LT(distance(result, ref), 1e-4);
+
+    // the vector space integrator with the same step size suffers from the singularity
+    core::Integrator<SystemEuler::STATE_DIM> vectorSpaceIntegrator(system, core::RK4);
+    core::StateVector<SystemEuler::STATE_DIM> xVectorSpace = initial.toStateVectorEulerXyz();
+    vectorSpaceIntegrator.integrate_n_steps(xVectorSpace, 0.0, 20, duration / 20);
+    RBDState<NJOINTS> resultVectorSpace(RigidBodyPose::EULER);
+    resultVectorSpace.fromStateVectorEulerXyz(xVectorSpace);
+    std::cout << "error Lie group: " << distance(result, ref)
+              << ", error vector space: " << distance(resultVectorSpace, ref) << std::endl;
+    ASSERT_LT(distance(result, ref), distance(resultVectorSpace, ref));
+}
+
+TEST(LieGroupIntegratorTest, coreIntegratorTest)
+{
+    RBDState<NJOINTS> initial(RigidBodyPose::QUAT);
+    initial.setRandom();
+
+    // the Lie group integrator is a regular ct::core::Integrator
+    std::shared_ptr<SystemQuat> system(new SystemQuat);
+    std::shared_ptr<core::Integrator<SystemQuat::STATE_DIM>> integrator(new IntegratorQuat(system, RKMK4));
+
+    core::StateVector<SystemQuat::STATE_DIM> x = initial.toStateVectorQuaternion();
+    integrator->integrate_n_steps(x, 0.0, 10, 0.01);
+    ASSERT_LT(distance(fromQuaternion(x), reference(initial, 0.1)), 1e-5);
+    ASSERT_NEAR(x.head<4>().norm(), 1.0, 1e-12);
+
+    // switching to a vector space integration type and back
+    integrator->changeIntegrationType(core::RK4);
+    x = initial.toStateVectorQuaternion();
+    integrator->integrate_n_steps(x, 0.0, 10, 0.01);
+    ASSERT_LT(distance(fromQuaternion(x), reference(initial, 0.1)), 1e-5);
+
+    std::static_pointer_cast<IntegratorQuat>(integrator)->changeIntegrationType(LIE_EULER_SYM);
+    x = initial.toStateVectorQuaternion();
+    integrator->integrate_n_steps(x, 0.0, 10, 0.01);
+    ASSERT_LT(distance(fromQuaternion(x), integrateLie(initial, 0.1, 10, LIE_EULER_SYM)), 1e-12);
+}
+
+TEST(LieGroupIntegratorTest, manifoldTest)
+{
+    RBDState<NJOINTS> initial(RigidBodyPose::QUAT);
+    initial.setRandom();
+    initial.joints().getVelocities().setZero();
+    initial.base().velocities().getRotationalVelocity().toImplementation() << 3.0, -4.0, 5.0;
+
+    // large steps keep the quaternion normalized
+    std::shared_ptr<SystemQuat> system(new SystemQuat);
+    for (LieGroupIntegrationType type : {LIE_EULER_SYM, RKMK4})
+    {
+        IntegratorQuat integrator(system, type);
+        core::StateVector<SystemQuat::STATE_DIM> x = initial.toStateVectorQuaternion();
+        integrator.integrate_n_steps(x, 0.0, 10, 0.02);
+        ASSERT_NEAR(x.head<4>().norm(), 1.0, 1e-12);
+    }
+}
+
+TEST(LieGroupIntegratorTest, discretizerTest)
+{
+    const size_t STATE_DIM = SystemQuat::STATE_DIM;
+    const size_t CONTROL_DIM = SystemQuat::CONTROL_DIM;
+    typedef LieGroupDiscretizer<NJOINTS, CONTROL_DIM, true> Discretizer;
+
+    const double dt = 0.01;
+    std::shared_ptr<SystemQuat> system(new SystemQuat);
+    std::shared_ptr<Discretizer> discretizer(new Discretizer(system, dt, RKMK4, 2));
+
+    RBDState<NJOINTS> initial(RigidBodyPose::QUAT);
+    initial.setRandom();
+    const core::StateVector<STATE_DIM> x0 = initial.toStateVectorQuaternion();
+    core::ControlVector<CONTROL_DIM> u = core::ControlVector<CONTROL_DIM>::Random();
+
+    // a discrete step integrates the system with constant control, starting at the time of the step
+    core::StateVector<STATE_DIM> xNext;
+    discretizer->propagateControlledDynamics(x0, 3, u, xNext);
+
+    std::shared_ptr<SystemQuat> controlledSystem(new SystemQuat);
+    controlledSystem->setController(std::shared_ptr<core::ConstantController<STATE_DIM, CONTROL_DIM>>(
+        new core::ConstantController<STATE_DIM, CONTROL_DIM>(u)));
+    IntegratorQuat integrator(controlledSystem, RKMK4);
+    core::StateVector<STATE_DIM> x = x0;
+    integrator.integrate_n_steps(x, 3 * dt, 2, dt / 2);
+    ASSERT_TRUE(xNext.isApprox(x, 1e-12));
+
+    // clones are independent
+    std::shared_ptr<Discretizer> clone(discretizer->clone());
+    clone->setIntegrationType(LIE_EULER_SYM);
+    core::StateVector<STATE_DIM> xClone;
+    discretizer->propagateControlledDynamics(x0, 3, u, xClone);
+    ASSERT_TRUE(xClone.isApprox(xNext, 1e-12));
+
+    // NLOC on the discretized system, linearized numerically
+    std::shared_ptr<core::DiscreteSystemLinearizer<STATE_DIM, CONTROL_DIM>> linearizer(
+        new core::DiscreteSystemLinearizer<STATE_DIM, CONTROL_DIM>(discretizer));
+
+    core::StateVector<STATE_DIM> xFinal = x0;
+    xFinal.tail<STATE_DIM / 2>().setZero();
+    std::shared_ptr<optcon::CostFunctionQuadratic<STATE_DIM, CONTROL_DIM>> costFunction(
+        new optcon::CostFunctionQuadraticSimple<STATE_DIM, CONTROL_DIM>(core::StateMatrix<STATE_DIM>::Identity(),
+            1e-3 * core::ControlMatrix<CONTROL_DIM>::Identity(), xFinal, core::ControlVector<CONTROL_DIM>::Zero(),
+            xFinal, 10.0 * core::StateMatrix<STATE_DIM>::Identity()));
+
+    const int N = 10;
+    optcon::DiscreteOptConProblem<STATE_DIM, CONTROL_DIM> problem(N, x0, discretizer, costFunction, linearizer);
+
+    optcon::NLOptConSettings settings;
+    settings.nlocp_algorithm = optcon::NLOptConSettings::NLOCP_ALGORITHM::ILQR;
+    settings.lineSearchSettings.type = optcon::LineSearchSettings::TYPE::SIMPLE;
+    settings.dt = dt;
+    settings.nThreads = 1;
+    settings.printSummary = false;
+
+    typedef optcon::NLOptConSolver<STATE_DIM, CONTROL_DIM, STATE_DIM / 2, STATE_DIM / 2, double, false> Solver;
+    Solver solver(problem, settings);
+    solver.setInitialGuess(Solver::Policy_t(core::StateVectorArray<STATE_DIM>(N + 1, x0),
+        core::ControlVectorArray<CONTROL_DIM>(N, core::ControlVector<CONTROL_DIM>::Zero()),
+        core::FeedbackArray<STATE_DIM, CONTROL_DIM>(N, core::FeedbackMatrix<STATE_DIM, CONTROL_DIM>::Zero()), dt));
+
+    solver.runIteration();
+    const double cost = solver.getCost();
+    solver.runIteration();
+    ASSERT_LT(solver.getCost(), cost);
+
+    // the solution is a rollout of the discretizer, its base orientation remains normalized
+    const Solver::Policy_t& solution = solver.getSolution();
+    for (int k = 0; k < N; k++)
+    {
+        discretizer->propagateControlledDynamics(solution.x_ref()[k], k, solution.uff()[k], xNext);
+        ASSERT_TRUE(xNext.isApprox(solution.x_ref()[k + 1], 1e-10));
+        ASSERT_NEAR(solution.x_ref()[k + 1].head<4>().norm(), 1.0, 1e-12);
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
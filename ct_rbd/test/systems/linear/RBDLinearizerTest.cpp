@@ -112,6 +112,128 @@ TEST(RBDLinearizerTest, NumDiffComparisonFloatingBase)
     }
 }
 
+/*!
+ * compares the analytical derivatives of the RbdLinearizer to its numerical ones
+ */
+template <class SYSTEM>
+void compareAnalyticalToNumerical(std::shared_ptr<SYSTEM> system, std::shared_ptr<SYSTEM> system2, double tol)
+{
+    const size_t STATE_DIM = SYSTEM::STATE_DIM;
+    const size_t CONTROL_DIM = SYSTEM::CONTROL_DIM;
+
+    RbdLinearizer<SYSTEM> analyticalLinearizer(system, false, true);
+    RbdLinearizer<SYSTEM> numericalLinearizer(system2, true);
+
+    core::StateVector<STATE_DIM> x;
+    core::ControlVector<CONTROL_DIM> u;
+
+    size_t nTests = 100;
+    for (size_t i = 0; i < nTests; i++)
+    {
+        x.setRandom();
+        u.setRandom();
+
+        auto A_analytical = analyticalLinearizer.getDerivativeState(x, u, 0.0);
+        auto B_analytical = analyticalLinearizer.getDerivativeControl(x, u, 0.0);
+
+        auto A_numerical = numericalLinearizer.getDerivativeState(x, u, 0.0);
+        auto B_numerical = numericalLinearizer.getDerivativeControl(x, u, 0.0);
+
+        // relative tolerance, as the contact forces grow exponentially with the penetration
+        ASSERT_LT((A_analytical - A_numerical).array().abs().maxCoeff(),
+            tol * (1.0 + A_numerical.array().abs().maxCoeff()));
+        ASSERT_LT((B_analytical - B_numerical).array().abs().maxCoeff(),
+            tol * (1.0 + B_numerical.array().abs().maxCoeff()));
+    }
+}
+
+TEST(RBDLinearizerTest, AnalyticalDerivativesFixedBase)
+{
+    typedef FixBaseFDSystem<TestIrb4600::Dynamics> IrbSystem;
+    compareAnalyticalToNumerical<IrbSystem>(
+        std::shared_ptr<IrbSystem>(new IrbSystem), std::shared_ptr<IrbSystem>(new IrbSystem), 1e-5);
+}
+
+TEST(RBDLinearizerTest, AnalyticalDerivativesFloatingBase)
+{
+    typedef FloatingBaseFDSystem<TestHyQ::Dynamics, false, false> HyQSystem;
+    compareAnalyticalToNumerical<HyQSystem>(
+        std::shared_ptr<HyQSystem>(new HyQSystem), std::shared_ptr<HyQSystem>(new HyQSystem), 1e-5);
+}
+
+TEST(RBDLinearizerTest, AnalyticalDerivativesFloatingBaseContact)
+{
+    typedef FloatingBaseFDSystem<TestHyQ::Dynamics, false, false> HyQSystem;
+
+    std::shared_ptr<HyQSystem> hyqSystem(new HyQSystem);
+    std::shared_ptr<HyQSystem> hyqSystem2(new HyQSystem);
+
+    hyqSystem->setContactModel(std::shared_ptr<HyQSystem::ContactModel>(new HyQSystem::ContactModel(5000.0, 1000.0,
+        100.0, 100.0, -0.02, HyQSystem::ContactModel::VELOCITY_SMOOTHING::SIGMOID,
+        hyqSystem->dynamics().kinematicsPtr())));
+    hyqSystem2->setContactModel(std::shared_ptr<HyQSystem::ContactModel>(new HyQSystem::ContactModel(5000.0, 1000.0,
+        100.0, 100.0, -0.02, HyQSystem::ContactModel::VELOCITY_SMOOTHING::SIGMOID,
+        hyqSystem2->dynamics().kinematicsPtr())));
+
+    compareAnalyticalToNumerical<HyQSystem>(hyqSystem, hyqSystem2, 1e-3);
+}
+
+/*!
+ * compares the RbdLinearizer with analytical derivatives enabled to the ct_core numerical linearizer, for systems whose
+ * derivatives are computed numerically
+ */
+template <class SYSTEM>
+void compareToSystemLinearizer(std::shared_ptr<SYSTEM> system, std::shared_ptr<SYSTEM> system2)
+{
+    const size_t STATE_DIM = SYSTEM::STATE_DIM;
+    const size_t CONTROL_DIM = SYSTEM::CONTROL_DIM;
+
+    RbdLinearizer<SYSTEM> rbdLinearizer(system, true, true);
+    core::SystemLinearizer<STATE_DIM, CONTROL_DIM> systemLinearizer(system2, true);
+
+    core::StateVector<STATE_DIM> x;
+    core::ControlVector<CONTROL_DIM> u;
+
+    size_t nTests = 100;
+    for (size_t i = 0; i < nTests; i++)
+    {
+        x.setRandom();
+        u.setRandom();
+
+        auto A_rbd = rbdLinearizer.getDerivativeState(x, u, 0.0);
+        auto B_rbd = rbdLinearizer.getDerivativeControl(x, u, 0.0);
+
+        auto A_system = systemLinearizer.getDerivativeState(x, u, 0.0);
+        auto B_system = systemLinearizer.getDerivativeControl(x, u, 0.0);
+
+        ASSERT_LT((A_rbd - A_system).array().abs().maxCoeff(), 1e-8);
+        ASSERT_LT((B_rbd - B_system).array().abs().maxCoeff(), 1e-8);
+    }
+}
+
+TEST(RBDLinearizerTest, EndEffectorForceInputsFixedBase)
+{
+    typedef FixBaseFDSystem<TestIrb4600::Dynamics, 0, true> IrbSystem;
+    static_assert(IrbSystem::CONTROL_DIM != TestIrb4600::Dynamics::NJOINTS, "the control input is not the torques");
+
+    compareToSystemLinearizer<IrbSystem>(
+        std::shared_ptr<IrbSystem>(new IrbSystem), std::shared_ptr<IrbSystem>(new IrbSystem));
+}
+
+TEST(RBDLinearizerTest, ActuatorDynamicsFixedBase)
+{
+    const size_t njoints = TestIrb4600::Dynamics::NJOINTS;
+    typedef SecondOrderActuatorDynamics<njoints> ActuatorDynamics;
+    typedef FixBaseFDSystem<TestIrb4600::Dynamics, 2 * njoints> IrbSystem;
+
+    std::shared_ptr<IrbSystem> irbSystem(
+        new IrbSystem(std::shared_ptr<ActuatorDynamics>(new ActuatorDynamics(10.0, 0.5))));
+    std::shared_ptr<IrbSystem> irbSystem2(
+        new IrbSystem(std::shared_ptr<ActuatorDynamics>(new ActuatorDynamics(10.0, 0.5))));
+
+    compareToSystemLinearizer<IrbSystem>(irbSystem, irbSystem2);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);